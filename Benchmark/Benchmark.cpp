@@ -0,0 +1,336 @@
+// Benchmark.cpp : Times the algorithms of the library against std:: and writes the results as JSON.
+//
+// Benchmark [--sizes 1e3,1e6] [--max-size 1e9] [--threads 1,4] [--reps 15] [--budget 2000]
+//           [--types int,double,string] [--categories forward,bidirectional,random_access] [--filter sort] [--json out.json]
+//           [--scaling strong|weak|both] [--micro]
+//
+// The sizes default to the powers of ten from 1e2 to --max-size, which is 1e7 unless set, the buffers of 1e9
+// elements take tens of gigabytes. A size that can't be allocated is skipped. The thread counts default to the
+// powers of two up to the hardware threads, and the hardware threads. A parallel run is par.with(max_threads(n)).
+//
+// A measurement is a warm up call and --reps samples, or as many as fit in --budget milliseconds, three at least.
+// A sample of a call that doesn't change its input times a batch of calls, enough for the clock to resolve them.
+// The baseline is measured once for all the thread counts. The progress goes to stderr, the JSON to --json or stdout.
+//
+// The string elements are records of 48 characters, they run the cases that only compare, move and copy their
+// elements, see run_string_cases. Their sorts and merges time the moves of values that own storage.
+//
+// --scaling runs the scaling curves of scaling.cpp instead, --micro the microbenchmarks of micro.cpp.
+
+#include "stdafx.h"
+
+#include <thread>
+#include "benchmark.h"
+
+struct result
+{
+	const char *algorithm;
+	const char *element;
+	const char *category;
+	size_t size;
+	unsigned int threads;
+	bool std_baseline;
+	stats baseline;
+	stats parallel;
+};
+
+// Runs the cases on the elements T through iterators of category Cat
+template<typename T, typename Cat>
+struct runner
+{
+	typedef typename std::conditional<std::is_same<Cat, random_access>::value,
+		typename std::vector<T>::iterator,
+		utils::test_iterator<Cat, typename std::vector<T>::iterator>>::type iterator;
+
+	runner(const settings& s, bench_buffers<T>& buffers, std::vector<result>& results, const char *element, const char *category)
+		: s(s), buffers(buffers), results(results), element(element), category(category)
+	{
+	}
+
+	template<typename Case>
+	void run()
+	{
+		if (!s.filter.empty() && std::string(Case::name()).find(s.filter) == std::string::npos)
+			return;
+
+		run_with<Case>(std::is_base_of<typename Case::category, Cat>());
+	}
+
+private:
+	runner& operator=(const runner&);
+
+	// the algorithm needs stronger iterators
+	template<typename Case>
+	void run_with(std::false_type)
+	{
+	}
+
+	template<typename Case>
+	void run_with(std::true_type)
+	{
+		auto d = buffers.template data<iterator>();
+
+		try
+		{
+			const stats baseline = measure(s, buffers, Case::mutates, [&d] { Case::baseline(d); });
+			for (auto n : s.threads)
+			{
+				const auto policy = pstl::par.with(pstl::max_threads(n));
+				const stats parallel = measure(s, buffers, Case::mutates, [&d, &policy] { Case::parallel(policy, d); });
+
+				result r = { Case::name(), element, category, d.size, n, Case::std_baseline, baseline, parallel };
+				results.push_back(r);
+
+				fprintf(stderr, "%-26s %-6s %-13s %10llu %3u threads %14.0f ns median %14.0f ns p99 %7.2fx\n",
+					r.algorithm, r.element, r.category, static_cast<unsigned long long>(r.size), r.threads,
+					r.parallel.median_ns, r.parallel.p99_ns, r.baseline.median_ns / r.parallel.median_ns);
+			}
+		}
+		catch (const std::bad_alloc&)
+		{
+			fprintf(stderr, "%-26s %-6s %-13s %10llu skipped, out of memory\n",
+				Case::name(), element, category, static_cast<unsigned long long>(d.size));
+		}
+	}
+
+	const settings& s;
+	bench_buffers<T>& buffers;
+	std::vector<result>& results;
+	const char *element;
+	const char *category;
+};
+
+template<typename F, typename T>
+void run_element_cases(F& f, const T *)
+{
+	run_cases(f);
+}
+
+template<typename F>
+void run_element_cases(F& f, const std::string *)
+{
+	run_string_cases(f);
+}
+
+template<typename T, typename Cat>
+void run_category(const settings& s, bench_buffers<T>& buffers, std::vector<result>& results, const char *element, const char *category)
+{
+	runner<T, Cat> r(s, buffers, results, element, category);
+	run_element_cases(r, static_cast<const T *>(nullptr));
+}
+
+template<typename T>
+void run_element(const settings& s, std::vector<result>& results, const char *element)
+{
+	for (auto size : s.sizes)
+	{
+		std::unique_ptr<bench_buffers<T>> buffers;
+		try
+		{
+			buffers.reset(new bench_buffers<T>(size));
+		}
+		catch (const std::bad_alloc&)
+		{
+			fprintf(stderr, "%s at %llu elements skipped, out of memory\n", element, static_cast<unsigned long long>(size));
+			continue;
+		}
+
+		for (auto& category : s.categories)
+		{
+			if (category == "forward")
+				run_category<T, forward>(s, *buffers, results, element, "forward");
+			else if (category == "bidirectional")
+				run_category<T, bidirectional>(s, *buffers, results, element, "bidirectional");
+			else if (category == "random_access")
+				run_category<T, random_access>(s, *buffers, results, element, "random_access");
+		}
+	}
+}
+
+void write_stats(FILE *out, const char *prefix, const stats& s)
+{
+	fprintf(out, "\"%smedian_ns\": %.1f, \"%sp99_ns\": %.1f, \"%ssamples\": %llu",
+		prefix, s.median_ns, prefix, s.p99_ns, prefix, static_cast<unsigned long long>(s.samples));
+}
+
+void write_json(FILE *out, const settings& s, const std::vector<result>& results)
+{
+	fprintf(out, "{\n  \"hardware_threads\": %u,\n  \"pointer_bits\": %u,\n  \"max_reps\": %d,\n  \"budget_ms\": %.0f,\n  \"results\": [",
+		std::thread::hardware_concurrency(), static_cast<unsigned int>(sizeof(void *) * 8), s.reps, s.budget_ns / 1e6);
+
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		const result& r = results[i];
+		fprintf(out, "%s\n    {\"algorithm\": \"%s\", \"element\": \"%s\", \"iterator\": \"%s\", \"size\": %llu, \"threads\": %u, \"baseline\": \"%s\", ",
+			i == 0 ? "" : ",", r.algorithm, r.element, r.category, static_cast<unsigned long long>(r.size), r.threads, r.std_baseline ? "std" : "seq");
+		write_stats(out, "", r.parallel);
+		fprintf(out, ", ");
+		write_stats(out, "baseline_", r.baseline);
+		fprintf(out, ", \"elements_per_second\": %.6g, \"speedup\": %.4f}",
+			r.size / (r.parallel.median_ns / 1e9), r.baseline.median_ns / r.parallel.median_ns);
+	}
+	fprintf(out, "\n  ]\n}\n");
+}
+
+std::vector<std::string> split(const char *list)
+{
+	std::vector<std::string> items;
+	std::string item;
+	for (const char *c = list; ; ++c)
+	{
+		if (*c == ',' || *c == '\0')
+		{
+			if (!item.empty())
+				items.push_back(item);
+			item.clear();
+			if (*c == '\0')
+				break;
+		}
+		else
+			item += *c;
+	}
+	return items;
+}
+
+// The numbers take exponents, 1e6 is a million
+size_t parse_count(const std::string& text)
+{
+	return static_cast<size_t>(atof(text.c_str()));
+}
+
+bool parse(int argc, char *argv[], settings& s)
+{
+	size_t max_size = 10000000;
+	s.reps = 0;
+	s.micro = false;
+	s.budget_ns = 2000 * 1e6;
+	s.types = split("int,double");
+	s.categories = split("forward,bidirectional,random_access");
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (option == "--micro")
+		{
+			s.micro = true;
+			continue;
+		}
+
+		if (i + 1 == argc)
+			return false;
+
+		const char *value = argv[++i];
+		if (option == "--sizes")
+		{
+			for (auto& size : split(value))
+				s.sizes.push_back(parse_count(size));
+		}
+		else if (option == "--max-size")
+			max_size = parse_count(value);
+		else if (option == "--threads")
+		{
+			for (auto& n : split(value))
+				s.threads.push_back(static_cast<unsigned int>(parse_count(n)));
+		}
+		else if (option == "--reps")
+			s.reps = atoi(value);
+		else if (option == "--budget")
+			s.budget_ns = atof(value) * 1e6;
+		else if (option == "--types")
+			s.types = split(value);
+		else if (option == "--categories")
+			s.categories = split(value);
+		else if (option == "--filter")
+			s.filter = value;
+		else if (option == "--json")
+			s.json = value;
+		else if (option == "--scaling")
+			s.scaling = value;
+		else
+			return false;
+	}
+
+	if (s.reps == 0)
+		s.reps = s.micro ? 201 : 15;
+
+	if (s.micro)
+	{
+		// the microbenchmarks have sizes of their own and run on every thread
+		if (!s.scaling.empty())
+			return false;
+	}
+	else if (!s.scaling.empty())
+	{
+		// the scaling mode has sizes of its own, and sweeps every thread count
+		if (s.scaling != "strong" && s.scaling != "weak" && s.scaling != "both")
+			return false;
+
+		if (s.threads.empty())
+		{
+			const unsigned int hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+			for (unsigned int n = 1; n <= hardware; ++n)
+				s.threads.push_back(n);
+		}
+	}
+	else if (s.sizes.empty())
+	{
+		for (size_t size = 100; size <= max_size && size <= 1000000000; size *= 10)
+			s.sizes.push_back(size);
+	}
+
+	if (s.threads.empty())
+	{
+		const unsigned int hardware = (std::max)(std::thread::hardware_concurrency(), 1u);
+		for (unsigned int n = 1; n < hardware; n *= 2)
+			s.threads.push_back(n);
+		s.threads.push_back(hardware);
+	}
+
+	s.sizes.erase(std::remove(s.sizes.begin(), s.sizes.end(), size_t(0)), s.sizes.end());
+	s.threads.erase(std::remove(s.threads.begin(), s.threads.end(), 0u), s.threads.end());
+	s.reps = (std::max)(s.reps, 1);
+	return (!s.sizes.empty() || !s.scaling.empty() || s.micro) && !s.threads.empty();
+}
+
+int main(int argc, char *argv[])
+{
+	settings s;
+	if (!parse(argc, argv, s))
+	{
+		printf("usage: Benchmark [--sizes 1e3,1e6] [--max-size 1e9] [--threads 1,4] [--reps 15] [--budget 2000]\n"
+			"                 [--types int,double,string] [--categories forward,bidirectional,random_access]\n"
+			"                 [--filter name] [--json file] [--scaling strong|weak|both] [--micro]\n");
+		return 1;
+	}
+
+	if (s.micro)
+		return run_micro(s);
+	if (!s.scaling.empty())
+		return run_scaling(s);
+
+	std::vector<result> results;
+	for (auto& type : s.types)
+	{
+		if (type == "int")
+			run_element<int>(s, results, "int");
+		else if (type == "double")
+			run_element<double>(s, results, "double");
+		else if (type == "string")
+			run_element<std::string>(s, results, "string");
+	}
+
+	if (!s.json.empty())
+	{
+		FILE *out = nullptr;
+		if (fopen_s(&out, s.json.c_str(), "w") != 0 || out == nullptr)
+		{
+			printf("can't write %s\n", s.json.c_str());
+			return 1;
+		}
+		write_json(out, s, results);
+		fclose(out);
+	}
+	else
+		write_json(stdout, s, results);
+	return 0;
+}
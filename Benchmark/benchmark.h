@@ -0,0 +1,102 @@
+// benchmark.h : The measurements shared by the modes of the benchmark.
+
+#pragma once
+
+#include <Windows.h>
+#include <cmath>
+#include <string>
+#include "benchmark_cases.h"
+
+struct settings
+{
+	std::vector<size_t> sizes;
+	std::vector<unsigned int> threads;
+	int reps;
+	double budget_ns;
+	std::vector<std::string> types;
+	std::vector<std::string> categories;
+	std::string filter;
+	std::string json;
+	std::string scaling; // strong, weak or both, see scaling.cpp
+	bool micro; // see micro.cpp
+};
+
+struct stats
+{
+	double median_ns;
+	double p99_ns;
+	size_t samples;
+};
+
+inline double now_ns()
+{
+	static const double ns_per_tick = []
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		return 1e9 / frequency.QuadPart;
+	}();
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart * ns_per_tick;
+}
+
+inline stats summarize(std::vector<double>& samples)
+{
+	std::sort(samples.begin(), samples.end());
+
+	const size_t n = samples.size();
+	stats s;
+	s.median_ns = n % 2 != 0 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+	s.p99_ns = samples[static_cast<size_t>(std::ceil(0.99 * n)) - 1]; // nearest rank
+	s.samples = n;
+	return s;
+}
+
+template<typename T, typename F>
+stats measure(const settings& s, bench_buffers<T>& buffers, bool mutates, F f)
+{
+	// the warm up call sizes the batch
+	size_t batch = 1;
+	if (mutates)
+	{
+		buffers.restore();
+		f();
+	}
+	else
+	{
+		for (;;)
+		{
+			const double begin = now_ns();
+			for (size_t i = 0; i < batch; ++i)
+				f();
+			if (now_ns() - begin >= 10000 || batch >= 65536)
+				break;
+			batch *= 2;
+		}
+	}
+
+	std::vector<double> samples;
+	double total = 0;
+	for (int rep = 0; rep < s.reps && (rep < 3 || total < s.budget_ns); ++rep)
+	{
+		if (mutates)
+			buffers.restore();
+
+		const double begin = now_ns();
+		for (size_t i = 0; i < batch; ++i)
+			f();
+		const double elapsed = now_ns() - begin;
+
+		samples.push_back(elapsed / batch);
+		total += elapsed;
+	}
+	return summarize(samples);
+}
+
+// Runs the scaling mode, returns the exit code of the benchmark
+int run_scaling(const settings& s);
+
+// Runs the microbenchmarks of the runtime, returns the exit code of the benchmark
+int run_micro(const settings& s);
@@ -0,0 +1,625 @@
+// benchmark_cases.h : The algorithms the benchmark times, one case each.
+//
+// A case calls its algorithm twice: through the parallel library under a policy, and as the baseline, which is
+// the std:: algorithm or, where std:: has none, the library under seq. category is the weakest iterator category
+// the case runs with, it also runs with the stronger ones. A case that changes its input sets mutates, the inputs
+// are restored before each of its runs.
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <memory>
+#include <random>
+#include <functional>
+#include <string>
+#include <experimental/algorithm>
+#include <experimental/numeric>
+#include <experimental/memory>
+
+#define UTILS_NO_CPP_UNIT_TEST
+#include "../Test/Common/utils.h"
+
+namespace pstl = std::experimental::parallel;
+
+// The iterators a case runs on. The ranges are views of bench_buffers, the sorted ones hold repeated values.
+template<typename It, typename T>
+struct bench_data
+{
+	size_t size;
+	It first, mid, last;        // random values in [0, size)
+	It first2, last2;           // a copy of first, last
+	It sorted, sorted_last;
+	It sorted2, sorted2_last;
+	It halves, halves_mid, halves_last; // two sorted halves, for inplace_merge
+	It out, out_last;           // room for size elements, followed by out2
+	It out2, out2_last;         // room for size more elements, out, out2_last holds a merge
+	std::vector<size_t>::iterator indices;
+	std::vector<size_t>::iterator counts;
+	typename std::vector<typename std::vector<T>::iterator>::iterator positions; // search results
+	T *raw_out;                 // out as a pointer, for the index loops
+	size_t partial;             // the prefix partial_sort and partial_sort_copy sort
+	T value;                    // a value of the input
+	T missing;                  // a value that isn't in the input
+	T missing_values[4];
+};
+
+// The values of the elements: v itself for the numbers, and for strings records of v zero padded to 20 digits
+// and a payload, 48 characters in all, longer than a short string keeps in place. Their order is the order of v.
+template<typename T>
+struct bench_value
+{
+	static T make(size_t v) { return static_cast<T>(v); }
+	static T missing(int v) { return static_cast<T>(v); } // v is negative
+};
+
+template<>
+struct bench_value<std::string>
+{
+	static std::string make(size_t v)
+	{
+		std::string record = std::to_string(v);
+		record.insert(0, 20 - record.size(), '0');
+		return record.append(28, '.');
+	}
+
+	static std::string missing(int v) { return std::string(static_cast<size_t>(-v), '~'); }
+};
+
+// The storage of the ranges of bench_data
+template<typename T>
+struct bench_buffers
+{
+	std::vector<T> input, input2, pristine;
+	std::vector<T> sorted, sorted2;
+	std::vector<T> halves, pristine_halves;
+	std::vector<T> out;
+	std::vector<size_t> indices, counts;
+	std::vector<typename std::vector<T>::iterator> positions;
+
+	explicit bench_buffers(size_t size) : input(size), sorted2(size), out(2 * size), indices(size), counts(256), positions(size)
+	{
+		std::mt19937 engine(20140601);
+		std::uniform_int_distribution<size_t> values(0, size - 1);
+		for (auto& v : input)
+			v = bench_value<T>::make(values(engine));
+		for (auto& v : sorted2)
+			v = bench_value<T>::make(values(engine));
+
+		input2 = input;
+		pristine = input;
+		sorted = input;
+		std::sort(sorted.begin(), sorted.end());
+		std::sort(sorted2.begin(), sorted2.end());
+
+		pristine_halves = input;
+		std::sort(pristine_halves.begin(), pristine_halves.begin() + size / 2);
+		std::sort(pristine_halves.begin() + size / 2, pristine_halves.end());
+		halves = pristine_halves;
+	}
+
+	void restore()
+	{
+		std::copy(pristine.begin(), pristine.end(), input.begin());
+		std::copy(pristine.begin(), pristine.end(), input2.begin());
+		std::copy(pristine_halves.begin(), pristine_halves.end(), halves.begin());
+	}
+
+	template<typename It>
+	bench_data<It, T> data()
+	{
+		const size_t size = input.size();
+
+		bench_data<It, T> d;
+		d.size = size;
+		d.first = It(input.begin());
+		d.mid = It(input.begin() + size / 2);
+		d.last = It(input.end());
+		d.first2 = It(input2.begin());
+		d.last2 = It(input2.end());
+		d.sorted = It(sorted.begin());
+		d.sorted_last = It(sorted.end());
+		d.sorted2 = It(sorted2.begin());
+		d.sorted2_last = It(sorted2.end());
+		d.halves = It(halves.begin());
+		d.halves_mid = It(halves.begin() + size / 2);
+		d.halves_last = It(halves.end());
+		d.out = It(out.begin());
+		d.out_last = It(out.begin() + size);
+		d.out2 = It(out.begin() + size);
+		d.out2_last = It(out.end());
+		d.indices = indices.begin();
+		d.counts = counts.begin();
+		d.positions = positions.begin();
+		d.raw_out = out.data();
+		d.partial = size / 10 + 1;
+		d.value = input[size / 2];
+		d.missing = bench_value<T>::missing(-1);
+		for (auto& v : d.missing_values)
+			v = bench_value<T>::missing(-2);
+		return d;
+	}
+};
+
+// Makes the result of a call observable, so that the optimizer can't drop the call
+template<typename R>
+inline void keep(const R& r)
+{
+	static volatile unsigned char sink;
+	sink = *reinterpret_cast<const volatile unsigned char *>(&r);
+}
+
+// The function objects of the cases, they work on int and double alike
+struct is_odd
+{
+	template<typename T> bool operator()(const T& v) const { return static_cast<long long>(v) % 2 != 0; }
+};
+
+struct is_negative
+{
+	template<typename T> bool operator()(const T& v) const { return v < 0; }
+};
+
+struct is_not_negative
+{
+	template<typename T> bool operator()(const T& v) const { return !(v < 0); }
+};
+
+struct twice
+{
+	template<typename T> T operator()(const T& v) const { return v + v; }
+};
+
+struct increment
+{
+	template<typename T> void operator()(T& v) const { v += 1; }
+};
+
+struct bin_of
+{
+	template<typename T> size_t operator()(const T& v) const { return static_cast<size_t>(v) % 256; }
+};
+
+template<typename T>
+struct one
+{
+	T operator()() const { return T(1); }
+};
+
+template<typename T>
+struct store_index
+{
+	T *out;
+	explicit store_index(T *out) : out(out) {}
+	void operator()(size_t i) const { out[i] = static_cast<T>(i); }
+};
+
+template<typename T>
+struct uniform
+{
+	typedef std::uniform_int_distribution<T> type;
+};
+
+template<>
+struct uniform<double>
+{
+	typedef std::uniform_real_distribution<double> type;
+};
+
+// The two sorted ranges as the runs of multiway_merge
+template<typename It, typename T>
+std::vector<std::pair<It, It>> sorted_runs(const bench_data<It, T>& d)
+{
+	std::vector<std::pair<It, It>> runs;
+	runs.push_back(std::make_pair(d.sorted, d.sorted_last));
+	runs.push_back(std::make_pair(d.sorted2, d.sorted2_last));
+	return runs;
+}
+
+#define BENCH_CASE(algorithm, category_, mutates_, std_baseline_, baseline_call, parallel_call) \
+	struct algorithm##_case \
+	{ \
+		typedef category_ category; \
+		static const char *name() { return #algorithm; } \
+		static const bool mutates = mutates_; \
+		static const bool std_baseline = std_baseline_; \
+		template<typename It, typename T> \
+		static void baseline(bench_data<It, T>& d) { baseline_call; } \
+		template<typename Policy, typename It, typename T> \
+		static void parallel(const Policy& policy, bench_data<It, T>& d) { parallel_call; } \
+	};
+
+// A case of an algorithm std:: has
+#define BENCH_STD_CASE(algorithm, category, mutates, std_call, parallel_call) \
+	BENCH_CASE(algorithm, category, mutates, true, std_call, parallel_call)
+
+// A case of an algorithm of the library only, the baseline is the same call under seq
+#define BENCH_SEQ_CASE(algorithm, category, mutates, call) \
+	BENCH_CASE(algorithm, category, mutates, false, { const auto& policy = pstl::seq; call; }, call)
+
+typedef std::forward_iterator_tag forward;
+typedef std::bidirectional_iterator_tag bidirectional;
+typedef std::random_access_iterator_tag random_access;
+
+namespace cases
+{
+	// <experimental/algorithm>, non modifying
+	BENCH_STD_CASE(adjacent_find, forward, false,
+		keep(std::adjacent_find(d.sorted, d.sorted_last, std::greater<T>())),
+		keep(pstl::adjacent_find(policy, d.sorted, d.sorted_last, std::greater<T>())))
+	BENCH_STD_CASE(all_of, forward, false,
+		keep(std::all_of(d.first, d.last, is_not_negative())),
+		keep(pstl::all_of(policy, d.first, d.last, is_not_negative())))
+	BENCH_STD_CASE(any_of, forward, false,
+		keep(std::any_of(d.first, d.last, is_negative())),
+		keep(pstl::any_of(policy, d.first, d.last, is_negative())))
+	BENCH_STD_CASE(none_of, forward, false,
+		keep(std::none_of(d.first, d.last, is_negative())),
+		keep(pstl::none_of(policy, d.first, d.last, is_negative())))
+	BENCH_STD_CASE(count, forward, false,
+		keep(std::count(d.first, d.last, d.value)),
+		keep(pstl::count(policy, d.first, d.last, d.value)))
+	BENCH_STD_CASE(count_if, forward, false,
+		keep(std::count_if(d.first, d.last, is_odd())),
+		keep(pstl::count_if(policy, d.first, d.last, is_odd())))
+	BENCH_STD_CASE(equal, forward, false,
+		keep(std::equal(d.first, d.last, d.first2)),
+		keep(pstl::equal(policy, d.first, d.last, d.first2)))
+	BENCH_STD_CASE(find, forward, false,
+		keep(std::find(d.first, d.last, d.missing)),
+		keep(pstl::find(policy, d.first, d.last, d.missing)))
+	BENCH_STD_CASE(find_if, forward, false,
+		keep(std::find_if(d.first, d.last, is_negative())),
+		keep(pstl::find_if(policy, d.first, d.last, is_negative())))
+	BENCH_STD_CASE(find_if_not, forward, false,
+		keep(std::find_if_not(d.first, d.last, is_not_negative())),
+		keep(pstl::find_if_not(policy, d.first, d.last, is_not_negative())))
+	BENCH_STD_CASE(find_end, forward, false,
+		keep(std::find_end(d.first, d.last, d.missing_values, d.missing_values + 4)),
+		keep(pstl::find_end(policy, d.first, d.last, d.missing_values, d.missing_values + 4)))
+	BENCH_STD_CASE(find_first_of, forward, false,
+		keep(std::find_first_of(d.first, d.last, d.missing_values, d.missing_values + 4)),
+		keep(pstl::find_first_of(policy, d.first, d.last, d.missing_values, d.missing_values + 4)))
+	BENCH_STD_CASE(search, forward, false,
+		keep(std::search(d.first, d.last, d.missing_values, d.missing_values + 4)),
+		keep(pstl::search(policy, d.first, d.last, d.missing_values, d.missing_values + 4)))
+	BENCH_STD_CASE(search_n, forward, false,
+		keep(std::search_n(d.first, d.last, 4, d.missing)),
+		keep(pstl::search_n(policy, d.first, d.last, 4, d.missing)))
+	BENCH_STD_CASE(includes, forward, false,
+		keep(std::includes(d.sorted, d.sorted_last, d.sorted, d.sorted_last)),
+		keep(pstl::includes(policy, d.sorted, d.sorted_last, d.sorted, d.sorted_last)))
+	BENCH_STD_CASE(is_partitioned, forward, false,
+		keep(std::is_partitioned(d.first, d.last, is_negative())),
+		keep(pstl::is_partitioned(policy, d.first, d.last, is_negative())))
+	BENCH_STD_CASE(is_sorted, forward, false,
+		keep(std::is_sorted(d.sorted, d.sorted_last)),
+		keep(pstl::is_sorted(policy, d.sorted, d.sorted_last)))
+	BENCH_STD_CASE(is_sorted_until, forward, false,
+		keep(std::is_sorted_until(d.sorted, d.sorted_last)),
+		keep(pstl::is_sorted_until(policy, d.sorted, d.sorted_last)))
+	BENCH_STD_CASE(lexicographical_compare, forward, false,
+		keep(std::lexicographical_compare(d.first, d.last, d.first2, d.last2)),
+		keep(pstl::lexicographical_compare(policy, d.first, d.last, d.first2, d.last2)))
+	BENCH_STD_CASE(max_element, forward, false,
+		keep(std::max_element(d.first, d.last)),
+		keep(pstl::max_element(policy, d.first, d.last)))
+	BENCH_STD_CASE(min_element, forward, false,
+		keep(std::min_element(d.first, d.last)),
+		keep(pstl::min_element(policy, d.first, d.last)))
+	BENCH_STD_CASE(minmax_element, forward, false,
+		keep(std::minmax_element(d.first, d.last)),
+		keep(pstl::minmax_element(policy, d.first, d.last)))
+	BENCH_STD_CASE(mismatch, forward, false,
+		keep(std::mismatch(d.first, d.last, d.first2)),
+		keep(pstl::mismatch(policy, d.first, d.last, d.first2)))
+
+	// <experimental/algorithm>, writing to out
+	BENCH_STD_CASE(copy, forward, false,
+		keep(std::copy(d.first, d.last, d.out)),
+		keep(pstl::copy(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(copy_n, forward, false,
+		keep(std::copy_n(d.first, d.size, d.out)),
+		keep(pstl::copy_n(policy, d.first, d.size, d.out)))
+	BENCH_STD_CASE(copy_if, forward, false,
+		keep(std::copy_if(d.first, d.last, d.out, is_odd())),
+		keep(pstl::copy_if(policy, d.first, d.last, d.out, is_odd())))
+	BENCH_STD_CASE(move, forward, false,
+		keep(std::move(d.first, d.last, d.out)),
+		keep(pstl::move(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(fill, forward, false,
+		std::fill(d.out, d.out_last, d.value),
+		pstl::fill(policy, d.out, d.out_last, d.value))
+	BENCH_STD_CASE(fill_n, forward, false,
+		std::fill_n(d.out, d.size, d.value),
+		keep(pstl::fill_n(policy, d.out, d.size, d.value)))
+	BENCH_STD_CASE(generate, forward, false,
+		std::generate(d.out, d.out_last, one<T>()),
+		pstl::generate(policy, d.out, d.out_last, one<T>()))
+	BENCH_STD_CASE(generate_n, forward, false,
+		std::generate_n(d.out, d.size, one<T>()),
+		keep(pstl::generate_n(policy, d.out, d.size, one<T>())))
+	BENCH_STD_CASE(for_each, forward, false,
+		std::for_each(d.out, d.out_last, increment()),
+		pstl::for_each(policy, d.out, d.out_last, increment()))
+	BENCH_STD_CASE(merge, forward, false,
+		keep(std::merge(d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)),
+		keep(pstl::merge(policy, d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)))
+	BENCH_STD_CASE(partial_sort_copy, random_access, false,
+		keep(std::partial_sort_copy(d.first, d.last, d.out, d.out + d.partial)),
+		keep(pstl::partial_sort_copy(policy, d.first, d.last, d.out, d.out + d.partial)))
+	BENCH_STD_CASE(partition_copy, forward, false,
+		keep(std::partition_copy(d.first, d.last, d.out, d.out2, is_odd())),
+		keep(pstl::partition_copy(policy, d.first, d.last, d.out, d.out2, is_odd())))
+	BENCH_STD_CASE(remove_copy, forward, false,
+		keep(std::remove_copy(d.first, d.last, d.out, d.value)),
+		keep(pstl::remove_copy(policy, d.first, d.last, d.out, d.value)))
+	BENCH_STD_CASE(remove_copy_if, forward, false,
+		keep(std::remove_copy_if(d.first, d.last, d.out, is_odd())),
+		keep(pstl::remove_copy_if(policy, d.first, d.last, d.out, is_odd())))
+	BENCH_STD_CASE(replace_copy, forward, false,
+		keep(std::replace_copy(d.first, d.last, d.out, d.value, d.missing)),
+		keep(pstl::replace_copy(policy, d.first, d.last, d.out, d.value, d.missing)))
+	BENCH_STD_CASE(replace_copy_if, forward, false,
+		keep(std::replace_copy_if(d.first, d.last, d.out, is_odd(), d.missing)),
+		keep(pstl::replace_copy_if(policy, d.first, d.last, d.out, is_odd(), d.missing)))
+	BENCH_STD_CASE(reverse_copy, bidirectional, false,
+		keep(std::reverse_copy(d.first, d.last, d.out)),
+		keep(pstl::reverse_copy(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(rotate_copy, forward, false,
+		keep(std::rotate_copy(d.first, d.mid, d.last, d.out)),
+		keep(pstl::rotate_copy(policy, d.first, d.mid, d.last, d.out)))
+	BENCH_STD_CASE(set_difference, forward, false,
+		keep(std::set_difference(d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)),
+		keep(pstl::set_difference(policy, d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)))
+	BENCH_STD_CASE(set_intersection, forward, false,
+		keep(std::set_intersection(d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)),
+		keep(pstl::set_intersection(policy, d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)))
+	BENCH_STD_CASE(set_symmetric_difference, forward, false,
+		keep(std::set_symmetric_difference(d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)),
+		keep(pstl::set_symmetric_difference(policy, d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)))
+	BENCH_STD_CASE(set_union, forward, false,
+		keep(std::set_union(d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)),
+		keep(pstl::set_union(policy, d.sorted, d.sorted_last, d.sorted2, d.sorted2_last, d.out)))
+	BENCH_STD_CASE(swap_ranges, forward, true,
+		keep(std::swap_ranges(d.first2, d.last2, d.out)),
+		keep(pstl::swap_ranges(policy, d.first2, d.last2, d.out)))
+	BENCH_STD_CASE(transform, forward, false,
+		keep(std::transform(d.first, d.last, d.out, twice())),
+		keep(pstl::transform(policy, d.first, d.last, d.out, twice())))
+	BENCH_STD_CASE(unique_copy, forward, false,
+		keep(std::unique_copy(d.sorted, d.sorted_last, d.out)),
+		keep(pstl::unique_copy(policy, d.sorted, d.sorted_last, d.out)))
+
+	// <experimental/algorithm>, in place
+	BENCH_STD_CASE(inplace_merge, bidirectional, true,
+		std::inplace_merge(d.halves, d.halves_mid, d.halves_last),
+		pstl::inplace_merge(policy, d.halves, d.halves_mid, d.halves_last))
+	BENCH_STD_CASE(nth_element, random_access, true,
+		std::nth_element(d.first, d.mid, d.last),
+		pstl::nth_element(policy, d.first, d.mid, d.last))
+	BENCH_STD_CASE(partial_sort, random_access, true,
+		std::partial_sort(d.first, d.first + d.partial, d.last),
+		pstl::partial_sort(policy, d.first, d.first + d.partial, d.last))
+	BENCH_STD_CASE(partition, bidirectional, true,
+		keep(std::partition(d.first, d.last, is_odd())),
+		keep(pstl::partition(policy, d.first, d.last, is_odd())))
+	BENCH_STD_CASE(stable_partition, bidirectional, true,
+		keep(std::stable_partition(d.first, d.last, is_odd())),
+		keep(pstl::stable_partition(policy, d.first, d.last, is_odd())))
+	BENCH_STD_CASE(remove, forward, true,
+		keep(std::remove(d.first, d.last, d.value)),
+		keep(pstl::remove(policy, d.first, d.last, d.value)))
+	BENCH_STD_CASE(remove_if, forward, true,
+		keep(std::remove_if(d.first, d.last, is_odd())),
+		keep(pstl::remove_if(policy, d.first, d.last, is_odd())))
+	BENCH_STD_CASE(replace, forward, true,
+		std::replace(d.first, d.last, d.value, d.missing),
+		pstl::replace(policy, d.first, d.last, d.value, d.missing))
+	BENCH_STD_CASE(replace_if, forward, true,
+		std::replace_if(d.first, d.last, is_odd(), d.missing),
+		pstl::replace_if(policy, d.first, d.last, is_odd(), d.missing))
+	BENCH_STD_CASE(reverse, bidirectional, true,
+		std::reverse(d.first, d.last),
+		pstl::reverse(policy, d.first, d.last))
+	BENCH_STD_CASE(rotate, forward, true,
+		std::rotate(d.first, d.mid, d.last),
+		keep(pstl::rotate(policy, d.first, d.mid, d.last)))
+	BENCH_STD_CASE(sort, random_access, true,
+		std::sort(d.first, d.last),
+		pstl::sort(policy, d.first, d.last))
+	BENCH_STD_CASE(stable_sort, random_access, true,
+		std::stable_sort(d.first, d.last),
+		pstl::stable_sort(policy, d.first, d.last))
+	BENCH_STD_CASE(unique, forward, true,
+		keep(std::unique(d.first, d.last)),
+		keep(pstl::unique(policy, d.first, d.last)))
+
+	// <experimental/algorithm>, library only
+	BENCH_SEQ_CASE(for_each_n, forward, false,
+		keep(pstl::for_each_n(policy, d.out, d.size, increment())))
+	BENCH_SEQ_CASE(for_loop, random_access, false,
+		pstl::for_loop(policy, size_t(0), d.size, store_index<T>(d.raw_out)))
+	BENCH_SEQ_CASE(distinct, forward, false,
+		keep(pstl::distinct(policy, d.first, d.last, d.out)))
+	BENCH_SEQ_CASE(histogram, forward, false,
+		keep(pstl::histogram(policy, d.first, d.last, d.counts, 256, bin_of())))
+	BENCH_SEQ_CASE(generate_random, forward, false,
+		pstl::generate_random(policy, d.out, d.out_last, 42, typename uniform<T>::type(0, 1000)))
+	BENCH_SEQ_CASE(bulk_lower_bound, random_access, false,
+		keep(pstl::bulk_lower_bound(policy, d.sorted, d.sorted_last, d.first, d.last, d.positions)))
+	BENCH_SEQ_CASE(multiway_merge, random_access, false,
+		keep(pstl::multiway_merge(policy, sorted_runs(d), d.out)))
+	BENCH_SEQ_CASE(sort_by_key, random_access, true,
+		pstl::sort_by_key(policy, d.first, d.last, d.first2))
+	BENCH_SEQ_CASE(sort_indices, random_access, false,
+		keep(pstl::sort_indices(policy, d.first, d.last, d.indices)))
+
+	// <experimental/numeric>
+	BENCH_STD_CASE(adjacent_difference, forward, false,
+		keep(std::adjacent_difference(d.first, d.last, d.out)),
+		keep(pstl::adjacent_difference(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(inclusive_scan, forward, false,
+		keep(std::partial_sum(d.first, d.last, d.out)),
+		keep(pstl::inclusive_scan(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(inner_product, forward, false,
+		keep(std::inner_product(d.first, d.last, d.first2, T())),
+		keep(pstl::inner_product(policy, d.first, d.last, d.first2, T())))
+	BENCH_STD_CASE(reduce, forward, false,
+		keep(std::accumulate(d.first, d.last, T())),
+		keep(pstl::reduce(policy, d.first, d.last, T())))
+	BENCH_SEQ_CASE(exclusive_scan, forward, false,
+		keep(pstl::exclusive_scan(policy, d.first, d.last, d.out, T())))
+	BENCH_SEQ_CASE(transform_reduce, forward, false,
+		keep(pstl::transform_reduce(policy, d.first, d.last, T(), std::plus<T>(), twice())))
+	BENCH_SEQ_CASE(transform_inclusive_scan, forward, false,
+		keep(pstl::transform_inclusive_scan(policy, d.first, d.last, d.out, std::plus<T>(), twice())))
+	BENCH_SEQ_CASE(transform_exclusive_scan, forward, false,
+		keep(pstl::transform_exclusive_scan(policy, d.first, d.last, d.out, T(), std::plus<T>(), twice())))
+	BENCH_SEQ_CASE(inclusive_scan_by_key, forward, false,
+		keep(pstl::inclusive_scan_by_key(policy, d.sorted, d.sorted_last, d.first, d.out)))
+	BENCH_SEQ_CASE(exclusive_scan_by_key, forward, false,
+		keep(pstl::exclusive_scan_by_key(policy, d.sorted, d.sorted_last, d.first, d.out, T())))
+	BENCH_SEQ_CASE(reduce_by_key, forward, false,
+		keep(pstl::reduce_by_key(policy, d.sorted, d.sorted_last, d.first, d.out, d.out2)))
+
+	// <experimental/memory>
+	BENCH_STD_CASE(uninitialized_copy, forward, false,
+		keep(std::uninitialized_copy(d.first, d.last, d.out)),
+		keep(pstl::uninitialized_copy(policy, d.first, d.last, d.out)))
+	BENCH_STD_CASE(uninitialized_copy_n, forward, false,
+		keep(std::uninitialized_copy_n(d.first, d.size, d.out)),
+		keep(pstl::uninitialized_copy_n(policy, d.first, d.size, d.out)))
+	BENCH_STD_CASE(uninitialized_fill, forward, false,
+		std::uninitialized_fill(d.out, d.out_last, d.value),
+		pstl::uninitialized_fill(policy, d.out, d.out_last, d.value))
+	BENCH_STD_CASE(uninitialized_fill_n, forward, false,
+		std::uninitialized_fill_n(d.out, d.size, d.value),
+		keep(pstl::uninitialized_fill_n(policy, d.out, d.size, d.value)))
+}
+
+// Calls f.run<Case>() for each case
+template<typename F>
+void run_cases(F& f)
+{
+	using namespace cases;
+
+	f.template run<adjacent_find_case>();
+	f.template run<all_of_case>();
+	f.template run<any_of_case>();
+	f.template run<none_of_case>();
+	f.template run<count_case>();
+	f.template run<count_if_case>();
+	f.template run<equal_case>();
+	f.template run<find_case>();
+	f.template run<find_if_case>();
+	f.template run<find_if_not_case>();
+	f.template run<find_end_case>();
+	f.template run<find_first_of_case>();
+	f.template run<search_case>();
+	f.template run<search_n_case>();
+	f.template run<includes_case>();
+	f.template run<is_partitioned_case>();
+	f.template run<is_sorted_case>();
+	f.template run<is_sorted_until_case>();
+	f.template run<lexicographical_compare_case>();
+	f.template run<max_element_case>();
+	f.template run<min_element_case>();
+	f.template run<minmax_element_case>();
+	f.template run<mismatch_case>();
+
+	f.template run<copy_case>();
+	f.template run<copy_n_case>();
+	f.template run<copy_if_case>();
+	f.template run<move_case>();
+	f.template run<fill_case>();
+	f.template run<fill_n_case>();
+	f.template run<generate_case>();
+	f.template run<generate_n_case>();
+	f.template run<for_each_case>();
+	f.template run<merge_case>();
+	f.template run<partial_sort_copy_case>();
+	f.template run<partition_copy_case>();
+	f.template run<remove_copy_case>();
+	f.template run<remove_copy_if_case>();
+	f.template run<replace_copy_case>();
+	f.template run<replace_copy_if_case>();
+	f.template run<reverse_copy_case>();
+	f.template run<rotate_copy_case>();
+	f.template run<set_difference_case>();
+	f.template run<set_intersection_case>();
+	f.template run<set_symmetric_difference_case>();
+	f.template run<set_union_case>();
+	f.template run<swap_ranges_case>();
+	f.template run<transform_case>();
+	f.template run<unique_copy_case>();
+
+	f.template run<inplace_merge_case>();
+	f.template run<nth_element_case>();
+	f.template run<partial_sort_case>();
+	f.template run<partition_case>();
+	f.template run<stable_partition_case>();
+	f.template run<remove_case>();
+	f.template run<remove_if_case>();
+	f.template run<replace_case>();
+	f.template run<replace_if_case>();
+	f.template run<reverse_case>();
+	f.template run<rotate_case>();
+	f.template run<sort_case>();
+	f.template run<stable_sort_case>();
+	f.template run<unique_case>();
+
+	f.template run<for_each_n_case>();
+	f.template run<for_loop_case>();
+	f.template run<distinct_case>();
+	f.template run<histogram_case>();
+	f.template run<generate_random_case>();
+	f.template run<bulk_lower_bound_case>();
+	f.template run<multiway_merge_case>();
+	f.template run<sort_by_key_case>();
+	f.template run<sort_indices_case>();
+
+	f.template run<adjacent_difference_case>();
+	f.template run<inclusive_scan_case>();
+	f.template run<inner_product_case>();
+	f.template run<reduce_case>();
+	f.template run<exclusive_scan_case>();
+	f.template run<transform_reduce_case>();
+	f.template run<transform_inclusive_scan_case>();
+	f.template run<transform_exclusive_scan_case>();
+	f.template run<inclusive_scan_by_key_case>();
+	f.template run<exclusive_scan_by_key_case>();
+	f.template run<reduce_by_key_case>();
+
+	f.template run<uninitialized_copy_case>();
+	f.template run<uninitialized_copy_n_case>();
+	f.template run<uninitialized_fill_case>();
+	f.template run<uninitialized_fill_n_case>();
+}
+
+// Calls f.run<Case>() for the cases that only compare, move and copy their elements, the ones of the string records
+template<typename F>
+void run_string_cases(F& f)
+{
+	using namespace cases;
+
+	f.template run<find_case>();
+	f.template run<copy_case>();
+	f.template run<move_case>();
+	f.template run<merge_case>();
+	f.template run<set_difference_case>();
+	f.template run<set_union_case>();
+	f.template run<unique_copy_case>();
+
+	f.template run<inplace_merge_case>();
+	f.template run<nth_element_case>();
+	f.template run<partial_sort_case>();
+	f.template run<reverse_case>();
+	f.template run<rotate_case>();
+	f.template run<sort_case>();
+	f.template run<stable_sort_case>();
+
+	f.template run<multiway_merge_case>();
+	f.template run<sort_indices_case>();
+}
@@ -0,0 +1,284 @@
+// micro.cpp : The dispatch overhead microbenchmarks of the benchmark, --micro.
+//
+// Each one isolates a cost of the runtime, in nanoseconds per operation:
+//   for_each_empty         a for_each(par) with an empty body, per call, over --sizes elements (1e3 and 1e5)
+//   taskgroup_fork_join    a TaskGroup running k empty chores and joining them, per fork and join
+//   schedule_chore         a chore scheduled on the thread pool until it runs, per round trip
+//   completion_event_wake  CompletionEvent::completeOne until the waiter, asleep in wait(), runs again
+//   combinable_local       combinable::local() of a thread that already has its element, per lookup
+//   steal_latency          a chore pushed by a busy owner until a worker has stolen it, k at once for as many
+//                          workers, per chore
+// The latencies of a pool that went idle include waking or injecting its threads, the warm up call comes first.
+// --reps defaults to 201 samples here.
+//
+// The JSON records how the runtime is linked. Built with /p:PstlLink=static, BenchmarkStatic links the static
+// library of the runtime, and in Release its calls inline into the benchmark under link time code generation:
+// the difference of the medians of Benchmark --micro and BenchmarkStatic --micro is the cost of the DLL calls.
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <thread>
+#include "benchmark.h"
+
+namespace
+{
+	namespace details = std::experimental::parallel::details;
+
+	struct micro_result
+	{
+		const char *benchmark;
+		size_t parameter; // the elements or the chores, 0 if none
+		stats ns;
+	};
+
+	// Samples an operation, f runs it and returns its duration in nanoseconds
+	template<typename F>
+	stats sample(const settings& s, F f)
+	{
+		f();
+
+		std::vector<double> samples;
+		double total = 0;
+		for (int rep = 0; rep < s.reps && (rep < 3 || total < s.budget_ns); ++rep)
+		{
+			const double ns = f();
+			samples.push_back(ns);
+			total += ns;
+		}
+		return summarize(samples);
+	}
+
+	void report(std::vector<micro_result>& results, const char *benchmark, size_t parameter, const stats& ns)
+	{
+		micro_result r = { benchmark, parameter, ns };
+		results.push_back(r);
+		fprintf(stderr, "%-22s %10llu %12.0f ns median %12.0f ns p99\n",
+			benchmark, static_cast<unsigned long long>(parameter), ns.median_ns, ns.p99_ns);
+	}
+
+	void for_each_empty(const settings& s, std::vector<micro_result>& results)
+	{
+		std::vector<size_t> sizes(s.sizes);
+		if (sizes.empty())
+		{
+			sizes.push_back(1000);
+			sizes.push_back(100000);
+		}
+
+		for (auto size : sizes)
+		{
+			std::vector<int> data(size);
+			report(results, "for_each_empty", size, sample(s, [&data]
+			{
+				const double begin = now_ns();
+				pstl::for_each(pstl::par, data.begin(), data.end(), [](int&) {});
+				return now_ns() - begin;
+			}));
+		}
+	}
+
+	void taskgroup_fork_join(const settings& s, std::vector<micro_result>& results)
+	{
+		auto empty = [] {};
+		typedef decltype(details::make_task(empty)) chore;
+
+		const size_t counts[] = { 1, 8, 64 };
+		for (auto k : counts)
+		{
+			report(results, "taskgroup_fork_join", k, sample(s, [&empty, k]
+			{
+				std::vector<chore> chores;
+				chores.reserve(k);
+				for (size_t i = 0; i < k; ++i)
+					chores.push_back(details::make_task(empty));
+
+				details::TaskGroup tg;
+				const double begin = now_ns();
+				for (auto& c : chores)
+					tg.run(c);
+				tg.wait();
+				return now_ns() - begin;
+			}));
+		}
+	}
+
+	struct ping_chore : details::_Threadpool_chore
+	{
+		std::atomic<bool> done;
+
+		virtual void __cdecl invoke() override
+		{
+			done.store(true, std::memory_order_release);
+		}
+	};
+
+	void schedule_chore_round_trip(const settings& s, std::vector<micro_result>& results)
+	{
+		// a pool thread may still be returning from invoke when the caller sees done, the chore outlives the run
+		static ping_chore chore;
+
+		report(results, "schedule_chore", 0, sample(s, []
+		{
+			chore.done.store(false, std::memory_order_relaxed);
+
+			const double begin = now_ns();
+			if (chore.is_scheduled())
+				chore.reschedule();
+			else
+				details::schedule_chore(&chore);
+
+			while (!chore.done.load(std::memory_order_acquire))
+				YieldProcessor();
+			return now_ns() - begin;
+		}));
+	}
+
+	void completion_event_wake(const settings& s, std::vector<micro_result>& results)
+	{
+		report(results, "completion_event_wake", 0, sample(s, []
+		{
+			details::CompletionEvent event(1);
+			double woken = 0;
+			std::thread waiter([&event, &woken]
+			{
+				event.wait();
+				woken = now_ns();
+			});
+
+			// long enough for the waiter to give up spinning and sleep
+			Sleep(2);
+			const double set = now_ns();
+			event.completeOne();
+			waiter.join();
+			return woken - set;
+		}));
+	}
+
+	void combinable_local(const settings& s, std::vector<micro_result>& results)
+	{
+		const int lookups = 100000;
+		details::combinable<int> data([] { return 0; });
+		data.local();
+
+		report(results, "combinable_local", 0, sample(s, [&data, lookups]
+		{
+			const double begin = now_ns();
+			for (int i = 0; i < lookups; ++i)
+				keep(data.local());
+			return (now_ns() - begin) / lookups;
+		}));
+	}
+
+	// Stamps when a worker started the chore of the given index
+	struct steal_stamp
+	{
+		std::vector<double> *started;
+		std::atomic<size_t> *running;
+		size_t index;
+
+		void operator()() const
+		{
+			(*started)[index] = now_ns();
+			++*running;
+		}
+	};
+
+	void steal_latency(const settings& s, std::vector<micro_result>& results)
+	{
+		// as many chores as there are other threads to steal them
+		const size_t k = (std::max)(std::thread::hardware_concurrency(), 2u) - 1;
+		typedef decltype(details::make_task(std::declval<steal_stamp>())) chore;
+
+		report(results, "steal_latency", k, sample(s, [k]
+		{
+			std::vector<double> pushed(k), started(k);
+			std::atomic<size_t> running(0);
+
+			std::vector<chore> chores;
+			chores.reserve(k);
+			for (size_t i = 0; i < k; ++i)
+			{
+				steal_stamp stamp = { &started, &running, i };
+				chores.push_back(details::make_task(stamp));
+			}
+
+			details::TaskGroup tg;
+			for (size_t i = 0; i < k; ++i)
+			{
+				pushed[i] = now_ns();
+				tg.run(chores[i]);
+			}
+
+			// the owner doesn't pop its queue meanwhile, the workers steal every chore, or it runs the rest
+			// itself after a second
+			const double deadline = now_ns() + 1e9;
+			while (running.load() != k && now_ns() < deadline)
+				YieldProcessor();
+			tg.wait();
+
+			double latency = 0;
+			for (size_t i = 0; i < k; ++i)
+				latency += started[i] - pushed[i];
+			return latency / k;
+		}));
+	}
+
+#if defined(_PSTL_STATIC)
+	const char *const runtime_link = "static";
+#else
+	const char *const runtime_link = "dll";
+#endif
+
+	void write_json(FILE *out, const settings& s, const std::vector<micro_result>& results)
+	{
+		fprintf(out, "{\n  \"mode\": \"micro\",\n  \"runtime\": \"%s\",\n  \"hardware_threads\": %u,\n  \"pointer_bits\": %u,\n  \"max_reps\": %d,\n  \"budget_ms\": %.0f,\n  \"results\": [",
+			runtime_link, std::thread::hardware_concurrency(), static_cast<unsigned int>(sizeof(void *) * 8), s.reps, s.budget_ns / 1e6);
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const micro_result& r = results[i];
+			fprintf(out, "%s\n    {\"benchmark\": \"%s\", \"parameter\": %llu, \"median_ns\": %.1f, \"p99_ns\": %.1f, \"samples\": %llu}",
+				i == 0 ? "" : ",", r.benchmark, static_cast<unsigned long long>(r.parameter), r.ns.median_ns, r.ns.p99_ns,
+				static_cast<unsigned long long>(r.ns.samples));
+		}
+		fprintf(out, "\n  ]\n}\n");
+	}
+
+	bool selected(const settings& s, const char *benchmark)
+	{
+		return s.filter.empty() || std::string(benchmark).find(s.filter) != std::string::npos;
+	}
+}
+
+int run_micro(const settings& s)
+{
+	std::vector<micro_result> results;
+	if (selected(s, "for_each_empty"))
+		for_each_empty(s, results);
+	if (selected(s, "taskgroup_fork_join"))
+		taskgroup_fork_join(s, results);
+	if (selected(s, "schedule_chore"))
+		schedule_chore_round_trip(s, results);
+	if (selected(s, "completion_event_wake"))
+		completion_event_wake(s, results);
+	if (selected(s, "combinable_local"))
+		combinable_local(s, results);
+	if (selected(s, "steal_latency"))
+		steal_latency(s, results);
+
+	if (!s.json.empty())
+	{
+		FILE *out = nullptr;
+		if (fopen_s(&out, s.json.c_str(), "w") != 0 || out == nullptr)
+		{
+			printf("can't write %s\n", s.json.c_str());
+			return 1;
+		}
+		write_json(out, s, results);
+		fclose(out);
+	}
+	else
+		write_json(stdout, s, results);
+	return 0;
+}
@@ -0,0 +1,194 @@
+// scaling.cpp : The scaling curves of the benchmark, --scaling strong|weak|both.
+//
+// The runtime is pinned to each thread count in turn with set_concurrency_limit, the partitioners carve the loops
+// for as many threads and as many pool threads run them. Strong scaling keeps the size, 1e7 elements unless
+// --sizes is set: the efficiency at n threads is t(n0) n0 / (t(n) n), n0 being the first thread count. Weak scaling
+// gives each thread the size, 1e6 elements unless set: the efficiency is t(n0) / t(n). The speedup is over std:: on
+// the same input.
+//
+// The sorts also run on PPL, its scheduler pinned to as many threads, as Sort_Sample compares them. The elements
+// are ints, PPL's radix sort takes integers only.
+
+#include "stdafx.h"
+
+#include <cstring>
+#include <ppl.h>
+#include <thread>
+#include "benchmark.h"
+
+namespace
+{
+	struct scaling_result
+	{
+		const char *algorithm;
+		const char *mode;
+		size_t size;
+		unsigned int threads;
+		stats parallel;
+		stats baseline;
+		double efficiency;
+		bool ppl;
+		stats ppl_sort;
+		stats ppl_radixsort;
+	};
+
+	// Runs f on a PPL scheduler of the given number of threads
+	template<typename F>
+	void with_ppl_scheduler(unsigned int threads, F f)
+	{
+		concurrency::CurrentScheduler::Create(concurrency::SchedulerPolicy(2,
+			concurrency::MinConcurrency, threads, concurrency::MaxConcurrency, threads));
+		try
+		{
+			f();
+		}
+		catch (...)
+		{
+			concurrency::CurrentScheduler::Detach();
+			throw;
+		}
+		concurrency::CurrentScheduler::Detach();
+	}
+
+	template<typename Case>
+	void run_curve(const settings& s, const char *mode, size_t size, std::vector<scaling_result>& results)
+	{
+		if (!s.filter.empty() && std::string(Case::name()).find(s.filter) == std::string::npos)
+			return;
+
+		const bool weak = strcmp(mode, "weak") == 0;
+		const bool sorts = std::is_same<Case, cases::sort_case>::value;
+
+		stats baseline = {};
+		size_t baseline_size = 0;
+		double reference = 0; // t(n0) n0 for strong scaling, t(n0) for weak scaling
+
+		for (auto n : s.threads)
+		{
+			const size_t total = weak ? size * n : size;
+			std::unique_ptr<bench_buffers<int>> buffers;
+			try
+			{
+				buffers.reset(new bench_buffers<int>(total));
+			}
+			catch (const std::bad_alloc&)
+			{
+				fprintf(stderr, "%-16s %-6s %12llu skipped, out of memory\n", Case::name(), mode, static_cast<unsigned long long>(total));
+				continue;
+			}
+
+			auto d = buffers->data<std::vector<int>::iterator>();
+			const auto policy = pstl::par.with(pstl::max_threads(n));
+
+			scaling_result r = {};
+			r.algorithm = Case::name();
+			r.mode = mode;
+			r.size = total;
+			r.threads = n;
+
+			pstl::set_concurrency_limit(n);
+			r.parallel = measure(s, *buffers, Case::mutates, [&d, &policy] { Case::parallel(policy, d); });
+			pstl::set_concurrency_limit(0);
+
+			// the strong curve has one size, the baseline is measured once
+			if (total != baseline_size)
+			{
+				baseline = measure(s, *buffers, Case::mutates, [&d] { Case::baseline(d); });
+				baseline_size = total;
+			}
+			r.baseline = baseline;
+
+			if (reference == 0)
+				reference = weak ? r.parallel.median_ns : r.parallel.median_ns * n;
+			r.efficiency = weak ? reference / r.parallel.median_ns : reference / (r.parallel.median_ns * n);
+
+			if (sorts)
+			{
+				r.ppl = true;
+				with_ppl_scheduler(n, [&]
+				{
+					r.ppl_sort = measure(s, *buffers, true, [&d] { concurrency::parallel_sort(d.first, d.last); });
+					r.ppl_radixsort = measure(s, *buffers, true, [&d] { concurrency::parallel_radixsort(d.first, d.last); });
+				});
+			}
+
+			results.push_back(r);
+			fprintf(stderr, "%-16s %-6s %12llu %3u threads %14.0f ns median %7.2fx %6.1f%% efficiency\n",
+				r.algorithm, r.mode, static_cast<unsigned long long>(r.size), r.threads, r.parallel.median_ns,
+				r.baseline.median_ns / r.parallel.median_ns, r.efficiency * 100);
+		}
+	}
+
+	void run_curves(const settings& s, const char *mode, size_t default_size, std::vector<scaling_result>& results)
+	{
+		std::vector<size_t> sizes(s.sizes);
+		if (sizes.empty())
+			sizes.push_back(default_size);
+
+		for (auto size : sizes)
+		{
+			run_curve<cases::sort_case>(s, mode, size, results);
+			run_curve<cases::stable_sort_case>(s, mode, size, results);
+			run_curve<cases::inclusive_scan_case>(s, mode, size, results);
+			run_curve<cases::reduce_case>(s, mode, size, results);
+			run_curve<cases::transform_case>(s, mode, size, results);
+			run_curve<cases::merge_case>(s, mode, size, results);
+		}
+	}
+
+	void write_stats(FILE *out, const char *prefix, const stats& s)
+	{
+		fprintf(out, "\"%smedian_ns\": %.1f, \"%sp99_ns\": %.1f, \"%ssamples\": %llu",
+			prefix, s.median_ns, prefix, s.p99_ns, prefix, static_cast<unsigned long long>(s.samples));
+	}
+
+	void write_json(FILE *out, const settings& s, const std::vector<scaling_result>& results)
+	{
+		fprintf(out, "{\n  \"mode\": \"scaling\",\n  \"hardware_threads\": %u,\n  \"pointer_bits\": %u,\n  \"max_reps\": %d,\n  \"budget_ms\": %.0f,\n  \"results\": [",
+			std::thread::hardware_concurrency(), static_cast<unsigned int>(sizeof(void *) * 8), s.reps, s.budget_ns / 1e6);
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const scaling_result& r = results[i];
+			fprintf(out, "%s\n    {\"algorithm\": \"%s\", \"scaling\": \"%s\", \"element\": \"int\", \"size\": %llu, \"threads\": %u, ",
+				i == 0 ? "" : ",", r.algorithm, r.mode, static_cast<unsigned long long>(r.size), r.threads);
+			write_stats(out, "", r.parallel);
+			fprintf(out, ", ");
+			write_stats(out, "baseline_", r.baseline);
+			if (r.ppl)
+			{
+				fprintf(out, ", ");
+				write_stats(out, "ppl_sort_", r.ppl_sort);
+				fprintf(out, ", ");
+				write_stats(out, "ppl_radixsort_", r.ppl_radixsort);
+			}
+			fprintf(out, ", \"elements_per_second\": %.6g, \"speedup\": %.4f, \"efficiency\": %.4f}",
+				r.size / (r.parallel.median_ns / 1e9), r.baseline.median_ns / r.parallel.median_ns, r.efficiency);
+		}
+		fprintf(out, "\n  ]\n}\n");
+	}
+}
+
+int run_scaling(const settings& s)
+{
+	std::vector<scaling_result> results;
+	if (s.scaling != "weak")
+		run_curves(s, "strong", 10000000, results);
+	if (s.scaling != "strong")
+		run_curves(s, "weak", 1000000, results);
+
+	if (!s.json.empty())
+	{
+		FILE *out = nullptr;
+		if (fopen_s(&out, s.json.c_str(), "w") != 0 || out == nullptr)
+		{
+			printf("can't write %s\n", s.json.c_str());
+			return 1;
+		}
+		write_json(out, s, results);
+		fclose(out);
+	}
+	else
+		write_json(stdout, s, results);
+	return 0;
+}
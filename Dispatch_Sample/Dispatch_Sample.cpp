@@ -0,0 +1,98 @@
+// Dispatch_Sample.cpp : Measures the cost of handing a chore to the scheduler.
+//
+// Build the library with _PSTL_WORKER_POOL (the default) and without it to compare the
+// persistent worker pool against the Win32 threadpool backend. The raw Win32 threadpool
+// numbers are printed in both cases as a reference.
+
+#include "stdafx.h"
+
+#include <atomic>
+#include <vector>
+#include <Windows.h>
+#include <experimental/algorithm>
+
+using namespace std::experimental::parallel;
+
+template<typename F>
+void measure_latency(F&& f, int iterations, const char* name)
+{
+	using namespace std::chrono;
+
+	// warm up, the first call pays for the thread creation
+	f();
+
+	auto begin = high_resolution_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		f();
+	auto end = high_resolution_clock::now();
+
+	printf("%s %8.2f us per call\n", name,
+		duration_cast<nanoseconds>(end - begin).count() / 1000.0 / iterations);
+}
+
+struct flag_chore : public details::_Threadpool_chore
+{
+	std::atomic<bool> done;
+
+	flag_chore() : done(false) {}
+
+	virtual void __cdecl invoke() override
+	{
+		done.store(true, std::memory_order_release);
+	}
+};
+
+void CALLBACK flag_callback(PTP_CALLBACK_INSTANCE, PVOID _Args, PTP_WORK)
+{
+	static_cast<std::atomic<bool> *>(_Args)->store(true, std::memory_order_release);
+}
+
+void test_dispatch(int iterations)
+{
+	printf("\nRound trip of a single empty chore:\n");
+
+	measure_latency([]
+	{
+		std::atomic<bool> done(false);
+		PTP_WORK work = ::CreateThreadpoolWork(flag_callback, &done, NULL);
+		::SubmitThreadpoolWork(work);
+		while (!done.load(std::memory_order_acquire))
+			YieldProcessor();
+		::WaitForThreadpoolWorkCallbacks(work, FALSE);
+		::CloseThreadpoolWork(work);
+	}, iterations, "Win32 create/submit/close:");
+
+	measure_latency([]
+	{
+		flag_chore chore;
+		details::schedule_chore(&chore);
+		while (!chore.done.load(std::memory_order_acquire))
+			YieldProcessor();
+	}, iterations, "schedule_chore:           ");
+}
+
+void test_for_each(int size, int iterations)
+{
+	std::vector<int> v(size);
+
+	printf("\nfor_each over %d ints:\n", size);
+
+	measure_latency([&v]
+	{
+		std::for_each(v.begin(), v.end(), [](int& i) { ++i; });
+	}, iterations, "serial:      ");
+
+	measure_latency([&v]
+	{
+		for_each(par, v.begin(), v.end(), [](int& i) { ++i; });
+	}, iterations, "parallel STL:");
+}
+
+int _tmain(int /* argc */, _TCHAR* /* argv */ [])
+{
+	test_dispatch(10000);
+	test_for_each(1000, 10000);
+	test_for_each(10 * 1000, 10000);
+	test_for_each(100 * 1000, 1000);
+	return 0;
+}
@@ -1,5 +1,6 @@
 ﻿// Cartoonizer.cpp
 #include "pch.h"
+#include <chrono>
 #include "Cartoonizer.h"
 
 using namespace ImageCartoonizerServer;
@@ -9,20 +10,122 @@ using namespace Windows::Graphics::Display;
 using namespace Windows::Storage; 
 using namespace Windows::Storage::Pickers; 
 using namespace Windows::Storage::Streams; 
+using namespace Windows::Foundation::Collections;
+
+namespace
+{
+    const int neighbourWindow = 3;
+    const int phasesCount = 3;
+
+    // Images in flight in the pipeline of GetTransformImagesAsync, one per stage
+    const size_t pipelineImages = 4;
+
+    // An image going through the pipeline, hr is its first failure
+    struct PipelinedImage
+    {
+        ImageTransformer^ transformer;
+        String^ outFile;
+        HRESULT hr;
+    };
+
+    typedef std::unique_ptr<PipelinedImage> PipelinedImagePtr;
+}
 
 ImageTransformer::ImageTransformer(bool isParallel)
 {
 	isParallelTransform = isParallel;
+	pitch = 0;
+	pixelFormat = GUID_WICPixelFormatDontCare;
+	bufferRing = std::make_shared<FrameBufferRing>();
 }
 
 IAsyncActionWithProgress<int>^ ImageTransformer::GetTransformImageAsync(String^ inFile, String^ outFile)
 {
     return create_async([=](progress_reporter<int> progress) {
-        TransformImage(inFile, outFile, progress);
+        TransformImage(inFile, outFile, [progress](int percent) { progress.report(percent); });
+    });
+}
+
+IAsyncOperationWithProgress<double, int>^ ImageTransformer::GetTransformImagesAsync(IVectorView<String^>^ inFiles, IVectorView<String^>^ outFiles, bool pipelined)
+{
+    return create_async([=](progress_reporter<int> progress) -> double {
+        const unsigned int count = (std::min)(inFiles->Size, outFiles->Size);
+        ReportProgressCallback report = [progress](int percent) { progress.report(percent); };
+
+        auto begin = std::chrono::steady_clock::now();
+        if (pipelined)
+        {
+            TransformImagesPipelined(inFiles, outFiles, count, report);
+        }
+        else
+        {
+            // Every filter ends with a barrier, an image starts once the previous one is encoded
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                ImageTransformer^ transformer = ref new ImageTransformer(isParallelTransform);
+                transformer->TransformImage(inFiles->GetAt(i), outFiles->GetAt(i), [](int) {});
+                report(static_cast<int>(100 * (i + 1) / count));
+            }
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        return seconds > 0 ? count / seconds : 0;
     });
 }
 
-void ImageTransformer::TransformImage(String^ inFile, String^ outFile, progress_reporter<int> progress)
+void ImageTransformer::TransformImagesPipelined(IVectorView<String^>^ inFiles, IVectorView<String^>^ outFiles, unsigned int count, ReportProgressCallback progress)
+{
+    const bool isParallel = isParallelTransform;
+    std::shared_ptr<FrameBufferRing> frameBuffers = std::make_shared<FrameBufferRing>();
+    ReportProgressCallback ignoreProgress = [](int) {};
+    unsigned int next = 0;
+    unsigned int done = 0;
+
+    // The decoding and the encoding take the images in turn, the filters in between run on several images
+    // at once: the color simplification of an image overlaps the edge detection and the encoding of the
+    // previous ones, and the threads one filter leaves idle at its end pick up the other
+    parallel::parallel_pipeline(pipelineImages,
+        parallel::make_filter<void, PipelinedImagePtr>(parallel::filter_mode::serial_in_order, [&](parallel::flow_control& flow) -> PipelinedImagePtr {
+            if (next == count)
+            {
+                flow.stop();
+                return nullptr;
+            }
+
+            PipelinedImagePtr image(new PipelinedImage());
+            image->transformer = ref new ImageTransformer(isParallel);
+            image->transformer->bufferRing = frameBuffers;
+            image->outFile = outFiles->GetAt(next);
+            image->hr = image->transformer->LoadFromImageFile(inFiles->GetAt(next));
+            if (SUCCEEDED(image->hr))
+                image->hr = image->transformer->LoadFrame();
+            if (SUCCEEDED(image->hr))
+                image->transformer->frameProcessing->BeginFilters(phasesCount, isParallel);
+            ++next;
+            return image;
+        }) &
+        parallel::make_filter<PipelinedImagePtr, PipelinedImagePtr>(parallel::filter_mode::parallel, [&ignoreProgress](PipelinedImagePtr image) -> PipelinedImagePtr {
+            if (SUCCEEDED(image->hr))
+                image->transformer->frameProcessing->ApplyColorSimplifier(phasesCount, ignoreProgress);
+            return image;
+        }) &
+        parallel::make_filter<PipelinedImagePtr, PipelinedImagePtr>(parallel::filter_mode::parallel, [&ignoreProgress](PipelinedImagePtr image) -> PipelinedImagePtr {
+            if (SUCCEEDED(image->hr))
+            {
+                image->transformer->frameProcessing->ApplyEdgeDetection(ignoreProgress);
+                image->transformer->FinishFrame();
+            }
+            return image;
+        }) &
+        parallel::make_filter<PipelinedImagePtr, void>(parallel::filter_mode::serial_in_order, [&](PipelinedImagePtr image) {
+            if (SUCCEEDED(image->hr))
+                image->transformer->SaveToImageFile(image->outFile);
+            ++done;
+            progress(static_cast<int>(100 * done / count));
+        }));
+}
+
+void ImageTransformer::TransformImage(String^ inFile, String^ outFile, ReportProgressCallback progress)
 {
     HRESULT hr;
 
@@ -63,7 +166,18 @@ HRESULT ImageTransformer::LoadFromImageFile(String^ wFileName)
     return hr;
 }
 
-HRESULT ImageTransformer::InternalTransformImage(progress_reporter<int> progress)
+HRESULT ImageTransformer::InternalTransformImage(ReportProgressCallback progress)
+{
+    HRESULT hr = LoadFrame();
+    if (SUCCEEDED(hr))
+    {
+        frameProcessing->ApplyFilters(phasesCount, isParallelTransform, progress);
+        FinishFrame();
+    }
+    return hr;
+}
+
+HRESULT ImageTransformer::LoadFrame()
 {
     HRESULT hr = S_OK;
     WICBitmapTransformOptions options = WICBitmapTransformFlipHorizontal ;
@@ -78,81 +192,71 @@ HRESULT ImageTransformer::InternalTransformImage(progress_reporter<int> progress
         hr = GetImageSize();
     }
 
-    ComPtr<IWICBitmap> bitmap = NULL;
-
-    WICRect rcLock = { 0, 0, width, height };
-    IWICBitmapLock *pLock = NULL;
-
-    hr = wicFactory->CreateBitmapFromSource(wicBitmap.Get(), WICBitmapCacheOnDemand, &bitmap);
     if (SUCCEEDED(hr))
     {
-        hr = bitmap->Lock(&rcLock, WICBitmapLockWrite, &pLock);
+        WICPixelFormatGUID format;
+        wicBitmap->GetPixelFormat(&format);
+
+      	int bpp;
+		if (format == GUID_WICPixelFormat8bppGray || format == GUID_WICPixelFormat8bppAlpha || format == GUID_WICPixelFormat8bppIndexed)
+		{
+			bpp = 8;
+		}
+		else if (format == GUID_WICPixelFormat24bppRGB || format == GUID_WICPixelFormat24bppBGR)
+		{
+			bpp = 24;
+		}
+		else if (format == GUID_WICPixelFormat32bppBGR || format == GUID_WICPixelFormat32bppBGRA || format == GUID_WICPixelFormat32bppPBGRA)
+		{
+			bpp = 32;
+		}
+		else throw;
+
+        // The decoder writes the flipped pixels straight into a buffer of the ring, its rows start at
+        // multiples of 64 bytes
+        pixelFormat = format;
+        pitch = (width * bpp / 8 + 63) & ~63u;
+        const UINT size = pitch * height;
+        FrameBuffer frame = bufferRing->Acquire(size);
+
+        WICRect rcCopy = { 0, 0, width, height };
+        hr = wicBitmap->CopyPixels(&rcCopy, pitch, size, frame.Data());
 
         if (SUCCEEDED(hr))
         {
-            BYTE* pFrame = NULL;
-            UINT cbBufferSize = 0;
-            UINT cbStride = 0;
-
-            hr = pLock->GetStride(&cbStride);
-
-            if (SUCCEEDED(hr))
-            {
-                hr = pLock->GetDataPointer(&cbBufferSize, &pFrame);
-            }
-
-            WICPixelFormatGUID format;
-            wicBitmap->GetPixelFormat(&format);
-
-          	int bpp;
-			if (format == GUID_WICPixelFormat8bppGray || format == GUID_WICPixelFormat8bppAlpha || format == GUID_WICPixelFormat8bppIndexed)
-			{
-				bpp = 8;
-			}
-			else if (format == GUID_WICPixelFormat24bppRGB || format == GUID_WICPixelFormat24bppBGR)
-			{
-				bpp = 24;
-			}
-			else throw;
-			
-			
-            unsigned int size = cbBufferSize;
-
-            const int neighbourWindow = 3;
-            const int phasesCount = 3;
-
             FrameData frameData;
             frameData.m_BBP = bpp;
             frameData.m_ColorPlanes = 1;
             frameData.m_EndHeight = height;
             frameData.m_EndWidth = width;
             frameData.m_neighbourArea = neighbourWindow;
-            frameData.m_pFrame = pFrame;
+            frameData.m_pFrame = frame.Data();
             frameData.m_pFrameProcesser = NULL;
             frameData.m_PhaseCount = phasesCount;
-            frameData.m_Pitch = cbStride;
+            frameData.m_Pitch = pitch;
             frameData.m_Size = size;
             frameData.m_StartHeight = 0;
             frameData.m_StartWidth = 0;
 
-            FrameProcessing frameProcessing;
-            frameData.m_pFrameProcesser = &frameProcessing;
+            frameProcessing.reset(new FrameProcessing());
+            frameData.m_pFrameProcesser = frameProcessing.get();
 
+            frameData.m_pFrameProcesser->SetBufferRing(bufferRing);
             frameData.m_pFrameProcesser->SetNeighbourArea(frameData.m_neighbourArea);
-            frameData.m_pFrameProcesser->SetCurrentFrame(frameData.m_pFrame, frameData.m_Size, frameData.m_EndWidth,
+            frameData.m_pFrameProcesser->SetCurrentFrame(std::move(frame), frameData.m_EndWidth,
                                                             frameData.m_EndHeight, frameData.m_Pitch, frameData.m_BBP, frameData.m_ColorPlanes);
-
-            frameData.m_pFrameProcesser->ApplyFilters(frameData.m_PhaseCount, isParallelTransform, [progress](int percent) { progress.report(percent); });
-            frameData.m_pFrameProcesser->FrameDone(pFrame, size);
-
-            // Release the bitmap lock.
-            pLock->Release();
-            wicBitmap = bitmap;
         }
     }
     return hr;
 }
 
+void ImageTransformer::FinishFrame()
+{
+    // The filtered frame goes to the encoder as it is, the buffer of the source frame back to the ring
+    outputFrame = frameProcessing->TakeFrame();
+    frameProcessing.reset();
+}
+
 HRESULT ImageTransformer::SaveToImageFile(String^ outFile)
 {
     HRESULT hr = S_OK;
@@ -190,14 +294,34 @@ HRESULT ImageTransformer::SaveToImageFile(String^ outFile)
     if (SUCCEEDED(hr))
         hr = pFrameEncode->SetSize(width, height);
 
-    if (SUCCEEDED(hr))
+    // A filtered frame the encoder takes in its own format is written from its buffer, otherwise the encoder
+    // converts a bitmap of it
+    bool writePixels = false;
+    if (!outputFrame.Empty())
+    {
+        format = pixelFormat;
+        ComPtr<IWICBitmap> frameBitmap;
+        if (SUCCEEDED(hr))
+            hr = pFrameEncode->SetPixelFormat(&format);
+        writePixels = SUCCEEDED(hr) && format == pixelFormat;
+        if (SUCCEEDED(hr) && !writePixels)
+            hr = wicFactory->CreateBitmapFromMemory(width, height, pixelFormat, pitch, outputFrame.Size(), outputFrame.Data(), &frameBitmap);
+        if (SUCCEEDED(hr) && !writePixels)
+            wicBitmap = frameBitmap;
+    }
+    else if (SUCCEEDED(hr))
     {
         hr = pFrameEncode->SetPixelFormat(&format);
     }
+
     if (SUCCEEDED(hr))
     {
-        hr = pFrameEncode->WriteSource(wicBitmap.Get(), NULL);
+        if (writePixels)
+            hr = pFrameEncode->WritePixels(height, pitch, outputFrame.Size(), outputFrame.Data());
+        else
+            hr = pFrameEncode->WriteSource(wicBitmap.Get(), NULL);
     }
+    outputFrame.Release();
     if (SUCCEEDED(hr))
     {
         hr = pFrameEncode->Commit();
@@ -17,10 +17,21 @@ namespace ImageCartoonizerServer
         // Expose image transformation as an asynchronous action with progress
         //
         IAsyncActionWithProgress<int>^ GetTransformImageAsync(String^ inFile, String^ outFile);
+
+        //
+        // Transforms the images of inFiles into outFiles, returns the images per second. Pipelined, the
+        // color simplification of an image overlaps the edge detection and the encoding of the previous
+        // ones, otherwise the images are transformed one after the other. The progress is the share of
+        // the images done.
+        //
+        IAsyncOperationWithProgress<double, int>^ GetTransformImagesAsync(Windows::Foundation::Collections::IVectorView<String^>^ inFiles,
+            Windows::Foundation::Collections::IVectorView<String^>^ outFiles, bool pipelined);
 		ImageTransformer(bool isParallel);
 
     private:
-        void TransformImage(String^ inFile, String^ outFile, progress_reporter<int> progress);
+        void TransformImage(String^ inFile, String^ outFile, ReportProgressCallback progress);
+        void TransformImagesPipelined(Windows::Foundation::Collections::IVectorView<String^>^ inFiles,
+            Windows::Foundation::Collections::IVectorView<String^>^ outFiles, unsigned int count, ReportProgressCallback progress);
 
         unsigned int width, height;
         ComPtr<IWICBitmapSource> wicBitmap;
@@ -30,8 +41,18 @@ namespace ImageCartoonizerServer
 
         HRESULT GetImageSize();
         HRESULT LoadFromImageFile(String^ wFileName);
-        HRESULT InternalTransformImage(progress_reporter<int> progress);
+        HRESULT InternalTransformImage(ReportProgressCallback progress);
+        HRESULT LoadFrame();
+        void FinishFrame();
         HRESULT SaveToImageFile(String^ outFile);
 		bool isParallelTransform;
+
+        // The frame between LoadFrame and FinishFrame, filtered in the buffers of the ring, then the filtered
+        // frame the encoder writes
+        std::unique_ptr<FrameProcessing> frameProcessing;
+        FrameBuffer outputFrame;
+        UINT pitch;
+        WICPixelFormatGUID pixelFormat;
+        std::shared_ptr<FrameBufferRing> bufferRing;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <experimental\algorithm>
+
+// The pixels of a frame, their rows start at multiples of 64 bytes when the pitch is a multiple of 64
+typedef std::vector<BYTE, std::experimental::parallel::aligned_allocator<BYTE, 64>> FrameStorage;
+
+class FrameBufferRing;
+
+//
+// A frame buffer taken from a ring. It has a single owner at a time, the decoder, the filters and the
+// encoder hand it over by moving it, and it goes back to its ring when its last owner drops it.
+//
+class FrameBuffer
+{
+public:
+    FrameBuffer() : m_pStorage(NULL)
+    {
+    }
+
+    FrameBuffer(FrameBuffer&& other) : m_Ring(std::move(other.m_Ring)), m_pStorage(other.m_pStorage)
+    {
+        other.m_pStorage = NULL;
+    }
+
+    FrameBuffer& operator=(FrameBuffer&& other)
+    {
+        if (this != &other)
+        {
+            Release();
+            m_Ring = std::move(other.m_Ring);
+            m_pStorage = other.m_pStorage;
+            other.m_pStorage = NULL;
+        }
+        return *this;
+    }
+
+    ~FrameBuffer()
+    {
+        Release();
+    }
+
+    BYTE* Data() const
+    {
+        return NULL == m_pStorage ? NULL : m_pStorage->data();
+    }
+
+    unsigned int Size() const
+    {
+        return NULL == m_pStorage ? 0 : static_cast<unsigned int>(m_pStorage->size());
+    }
+
+    bool Empty() const
+    {
+        return NULL == m_pStorage;
+    }
+
+    // Gives the buffer back to its ring
+    inline void Release();
+
+private:
+    friend class FrameBufferRing;
+
+    FrameBuffer(const FrameBuffer&);
+    FrameBuffer& operator=(const FrameBuffer&);
+
+    FrameBuffer(std::shared_ptr<FrameBufferRing> ring, FrameStorage* pStorage) : m_Ring(std::move(ring)), m_pStorage(pStorage)
+    {
+    }
+
+    std::shared_ptr<FrameBufferRing> m_Ring;
+    FrameStorage* m_pStorage;
+};
+
+//
+// The buffers the frames of a transformation go through. A buffer dropped by a frame is taken by the next one
+// of the same size, so a run of frames allocates once per buffer in flight rather than once per frame.
+//
+class FrameBufferRing : public std::enable_shared_from_this<FrameBufferRing>
+{
+public:
+    FrameBuffer Acquire(unsigned int size)
+    {
+        std::lock_guard<std::mutex> lockHolder(m_Lock);
+        for (auto it = m_Free.begin(); it != m_Free.end(); ++it)
+        {
+            if ((*it)->size() == size)
+            {
+                FrameStorage* pStorage = *it;
+                m_Free.erase(it);
+                return FrameBuffer(shared_from_this(), pStorage);
+            }
+        }
+
+        m_Buffers.emplace_back(new FrameStorage(size));
+        return FrameBuffer(shared_from_this(), m_Buffers.back().get());
+    }
+
+private:
+    friend class FrameBuffer;
+
+    void Return(FrameStorage* pStorage)
+    {
+        std::lock_guard<std::mutex> lockHolder(m_Lock);
+        m_Free.push_back(pStorage);
+    }
+
+    std::mutex m_Lock;
+    std::vector<std::unique_ptr<FrameStorage>> m_Buffers;
+    std::vector<FrameStorage*> m_Free;
+};
+
+inline void FrameBuffer::Release()
+{
+    if (NULL != m_pStorage)
+    {
+        m_Ring->Return(m_pStorage);
+        m_pStorage = NULL;
+        m_Ring.reset();
+    }
+}
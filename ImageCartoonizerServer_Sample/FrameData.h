@@ -2,6 +2,7 @@
 
 #include <experimental\coordinate>
 #include <experimental\algorithm>
+#include "FrameBuffers.h"
 
 using namespace concurrency;
 using namespace std;
@@ -51,8 +52,19 @@ public:
     ~FrameProcessing(void);
 
     void ApplyFilters(int nPhases,bool isParallel, ReportProgressCallback progressCallback);
+    // Sets the policies and the progress of the filters up, for a caller that runs the color simplifier
+    // and the edge detection itself
+    void BeginFilters(int nPhases, bool isParallel);
     void StopFilters();
     void SetCurrentFrame(BYTE* pFrame,unsigned int size, int width, int height, int pitch, int bpp, int clrPlanes);
+    // Takes the frame over, the filters read it in place
+    void SetCurrentFrame(FrameBuffer frame, int width, int height, int pitch, int bpp, int clrPlanes);
+
+    // The ring the buffers of the frames are taken from, one of its own unless set
+    void SetBufferRing(std::shared_ptr<FrameBufferRing> ring)
+    {
+        m_BufferRing = std::move(ring);
+    }
 
     void SetNeighbourArea(unsigned int area)
     {
@@ -62,19 +74,34 @@ public:
     {
         return m_NeighborWindow;
     }
+
+    // The phases of the color simplifier run fused on tiles, or sweep the frame one after the other
+    void SetFusedColorPhases(bool fused)
+    {
+        m_FuseColorPhases = fused;
+    }
 	void FrameDone(BYTE* pTarget, size_t size)
     {
+        FillBuffer();
         memcpy_s(pTarget, min(size,m_Size), m_pBufferImage, min(size,m_Size));
     }
+    // Hands the filtered frame over, e.g. to the encoder, and lets the source frame go
+    FrameBuffer TakeFrame();
 	
 
 public: //methods
     void ApplyColorSimplifier(ReportProgressCallback progressCallback);
     void ApplyColorSimplifier(int nPhases,ReportProgressCallback progressCallback);
     void ApplyColorSimplifier(unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth, ReportProgressCallback progressCallback);
+    void ApplyColorSimplifierFused(int nPhases, ReportProgressCallback progressCallback);
     void SimplifyIndexOptimized(BYTE* pFrame, int x, int y);
+    // The simplified color of a pixel of color orgClr, neighbor(dx, dy) is the color dx columns and dy rows away
+    template<typename Neighbor>
+    static COLORREF SimplifyColor(COLORREF orgClr, int shift, Neighbor neighbor);
     void ApplyEdgeDetection(ReportProgressCallback progressCallback);
     void ApplyEdgeDetectionParallel(unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth,ReportProgressCallback progressCallback);
+    // The edge detection of 32 bpp frames, by row kernels of 8 pixels
+    void ApplyEdgeDetectionRows(unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth, ReportProgressCallback progressCallback);
     void CalculateSobel(BYTE* pSource, int row, int column, float& dy, float& du, float& dv);
 
 public:
@@ -97,15 +124,23 @@ public:
         pFrame[byteIndex] = GetBValue(color);
     }
 	parallel::execution_policy execPolicy = parallel::seq;
+	parallel::execution_policy simplifierPolicy = parallel::seq;
 	
 
 private: //members
 
+	parallel::affinity_partitioner m_SimplifierAffinity; // shared by the color simplifier phases
+
     BYTE* m_pCurrentImage;  // src for the current frame
 	BYTE* m_pBufferImage;  // current image being processed
+	FrameBuffer m_CurrentImage;  // the buffers of the two above
+	FrameBuffer m_BufferImage;
+	bool m_BufferStale;  // m_pBufferImage doesn't hold the frame yet, the first filter reads m_pCurrentImage
+	std::shared_ptr<FrameBufferRing> m_BufferRing;
 	BYTE* m_pOutputImage;  // frame after Processing
     
 	unsigned int m_NeighborWindow;
+	bool m_FuseColorPhases;
 
     unsigned int  m_Width;
     unsigned int  m_Height;
@@ -121,4 +156,7 @@ private: //members
     UINT m_workDone;
 
     void UpdateProgress(ReportProgressCallback progressCallback);
+    FrameBuffer AcquireBuffer();
+    void FillBuffer();
+    void CopyOutside(BYTE* pTarget, unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth);
 };
@@ -11,37 +11,128 @@
 #include "pch.h"
 #include "FrameData.h"
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#define CARTOONIZER_SSE2 1
+#endif
+
 const double Util::Wr = 0.299;
 const double Util::Wb = 0.114;
 const double Util::wg = 1 - Util::Wr - Util::Wb;
 
+#if CARTOONIZER_SSE2
+namespace
+{
+	// The edge detection of 32 bpp frames works on the Y, U and V of the pixels, a plane of floats per channel
+	struct YuvPlanes
+	{
+		std::vector<float> y, u, v;
+
+		explicit YuvPlanes(size_t size) : y(size), u(size), v(size)
+		{
+		}
+	};
+
+	// Converts 4 BGRA pixels as Util::RGBToYUV does
+	inline void PixelsToYuv(const BYTE* pPixels, __m128& y, __m128& u, __m128& v)
+	{
+		const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pPixels));
+		const __m128i byteMask = _mm_set1_epi32(0xFF);
+		const __m128 scale = _mm_set1_ps(1.0f / 255);
+
+		const __m128 b = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(bgra, byteMask)), scale);
+		const __m128 g = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(bgra, 8), byteMask)), scale);
+		const __m128 r = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(bgra, 16), byteMask)), scale);
+
+		y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(static_cast<float>(Util::Wr)), r), _mm_mul_ps(_mm_set1_ps(static_cast<float>(Util::Wb)), b)),
+			_mm_mul_ps(_mm_set1_ps(static_cast<float>(Util::wg)), g));
+		u = _mm_mul_ps(_mm_set1_ps(static_cast<float>(0.436 / (1 - Util::Wb))), _mm_sub_ps(b, y));
+		v = _mm_mul_ps(_mm_set1_ps(static_cast<float>(0.615 / (1 - Util::Wr))), _mm_sub_ps(r, y));
+	}
+
+	// Fills the planes from the pixels [startWidth, endWidth) of a row of a 32 bpp frame
+	void RowToYuv(BYTE* pRow, YuvPlanes& planes, size_t rowStart, int startWidth, int endWidth)
+	{
+		int x = startWidth;
+		for (; x + 4 <= endWidth; x += 4)
+		{
+			__m128 y, u, v;
+			PixelsToYuv(pRow + 4 * x, y, u, v);
+			_mm_storeu_ps(&planes.y[rowStart + x], y);
+			_mm_storeu_ps(&planes.u[rowStart + x], u);
+			_mm_storeu_ps(&planes.v[rowStart + x], v);
+		}
+
+		for (; x < endWidth; ++x)
+		{
+			double y, u, v;
+			Util::RGBToYUV(FrameProcessing::GetPixel(pRow, x, 0, 0, 32), y, u, v);
+			planes.y[rowStart + x] = static_cast<float>(y);
+			planes.u[rowStart + x] = static_cast<float>(u);
+			planes.v[rowStart + x] = static_cast<float>(v);
+		}
+	}
+
+	// The Sobel gradient magnitude of the 4 pixels from p of a plane of rows of width elements, as CalculateSobel
+	inline __m128 Sobel(const float* p, ptrdiff_t width)
+	{
+		const __m128 two = _mm_set1_ps(2.0f);
+		const __m128 across = _mm_add_ps(_mm_add_ps(
+			_mm_sub_ps(_mm_loadu_ps(p - width + 1), _mm_loadu_ps(p - width - 1)),
+			_mm_sub_ps(_mm_loadu_ps(p + width + 1), _mm_loadu_ps(p + width - 1))),
+			_mm_mul_ps(two, _mm_sub_ps(_mm_loadu_ps(p + 1), _mm_loadu_ps(p - 1))));
+		const __m128 down = _mm_add_ps(_mm_add_ps(
+			_mm_sub_ps(_mm_loadu_ps(p + width - 1), _mm_loadu_ps(p - width - 1)),
+			_mm_sub_ps(_mm_loadu_ps(p + width + 1), _mm_loadu_ps(p - width + 1))),
+			_mm_mul_ps(two, _mm_sub_ps(_mm_loadu_ps(p + width), _mm_loadu_ps(p - width))));
+		return _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(across, across), _mm_mul_ps(down, down)));
+	}
+
+	// Util::SmoothStep of 4 values
+	inline __m128 SmoothStep(float a, float b, __m128 x)
+	{
+		__m128 t = _mm_mul_ps(_mm_sub_ps(x, _mm_set1_ps(a)), _mm_set1_ps(1 / (b - a)));
+		t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+		return _mm_mul_ps(_mm_mul_ps(t, t), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_add_ps(t, t)));
+	}
+}
+#endif
+
 FrameProcessing::FrameProcessing()
 {
 	m_Size = 0;
 	m_BPP = 0;
 	m_Pitch = 0;
 	m_NeighborWindow = 3;
+	m_FuseColorPhases = true;
 	m_pCurrentImage = NULL;
 	m_pBufferImage = NULL;
+	m_BufferStale = false;
 }
 
 FrameProcessing::~FrameProcessing(void)
 {
-	if (NULL != m_pCurrentImage)
-	{
-		delete m_pCurrentImage;
-	}
-
-	if (NULL != m_pBufferImage)
-	{
-		delete m_pBufferImage;
-	}
 }
 
 void FrameProcessing::ApplyFilters(int nPhases, bool isParallel, ReportProgressCallback progressCallback)
 {
-	if (isParallel) execPolicy = parallel::par;
-	else execPolicy = parallel::seq;
+	BeginFilters(nPhases, isParallel);
+	ApplyColorSimplifier(nPhases, progressCallback);
+	ApplyEdgeDetection(progressCallback);
+}
+
+void FrameProcessing::BeginFilters(int nPhases, bool isParallel)
+{
+	if (isParallel)
+	{
+		execPolicy = parallel::par;
+		simplifierPolicy = parallel::par_affinity(m_SimplifierAffinity);
+	}
+	else
+	{
+		execPolicy = parallel::seq;
+		simplifierPolicy = parallel::seq;
+	}
 
 	// ColorSimplifier work:
 	m_totalCompletion = nPhases * (m_Height - m_NeighborWindow);
@@ -51,56 +142,156 @@ void FrameProcessing::ApplyFilters(int nPhases, bool isParallel, ReportProgressC
 
 	m_lastReportedCompletion = 0;
 	m_workDone = 0;
-
-	ApplyColorSimplifier(nPhases, progressCallback);
-	ApplyEdgeDetection(progressCallback);
 }
 
 void FrameProcessing::SetCurrentFrame(BYTE* pFrame, unsigned int size, int width, int height, int pitch, int bpp, int clrPlanes)
+{
+	m_Size = size;
+	FrameBuffer frame = AcquireBuffer();
+	memcpy_s(frame.Data(), size, pFrame, size);
+	SetCurrentFrame(std::move(frame), width, height, pitch, bpp, clrPlanes);
+}
+
+void FrameProcessing::SetCurrentFrame(FrameBuffer frame, int width, int height, int pitch, int bpp, int clrPlanes)
 {
 	m_Width = width;
 	m_Height = height;
 	m_Pitch = pitch;
 	m_BPP = bpp;
 	m_ColorPlanes = clrPlanes;
-	if (size != m_Size)
+	m_Size = frame.Size();
+
+	m_CurrentImage = std::move(frame);
+	m_pCurrentImage = m_CurrentImage.Data();
+
+	// The working buffer is filled by the first filter, which reads the frame and writes it
+	m_BufferImage = AcquireBuffer();
+	m_pBufferImage = m_BufferImage.Data();
+	m_BufferStale = true;
+}
+
+FrameBuffer FrameProcessing::TakeFrame()
+{
+	FillBuffer();
+	m_CurrentImage.Release();
+	m_pCurrentImage = NULL;
+	m_pBufferImage = NULL;
+	return std::move(m_BufferImage);
+}
+
+FrameBuffer FrameProcessing::AcquireBuffer()
+{
+	if (!m_BufferRing)
 	{
-		if (NULL != m_pCurrentImage)
-		{
-			delete m_pCurrentImage;
-			m_pCurrentImage = NULL;
-		}
+		m_BufferRing = std::make_shared<FrameBufferRing>();
+	}
+	return m_BufferRing->Acquire(m_Size);
+}
+
+void FrameProcessing::FillBuffer()
+{
+	if (m_BufferStale)
+	{
+		memcpy_s(m_pBufferImage, m_Size, m_pCurrentImage, m_Size);
+		m_BufferStale = false;
+	}
+}
 
-		if (NULL != m_pBufferImage)
+// Copies the pixels of the working buffer outside of the rectangle a filter writes to pTarget
+void FrameProcessing::CopyOutside(BYTE* pTarget, unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth)
+{
+	const unsigned int pitch = abs(m_Pitch);
+	const unsigned int bytesPerPixel = m_BPP / 8;
+	for (unsigned int y = 0; y < m_Height && y * pitch < m_Size; ++y)
+	{
+		const unsigned int row = y * pitch;
+		const unsigned int rowBytes = min(pitch, m_Size - row);
+		if (y < startHeight || y >= endHeight)
 		{
-			delete m_pBufferImage;
-			m_pBufferImage = NULL;
+			memcpy_s(pTarget + row, rowBytes, m_pBufferImage + row, rowBytes);
+			continue;
 		}
+
+		const unsigned int left = min(startWidth * bytesPerPixel, rowBytes);
+		const unsigned int right = min(endWidth * bytesPerPixel, rowBytes);
+		memcpy_s(pTarget + row, left, m_pBufferImage + row, left);
+		memcpy_s(pTarget + row + right, rowBytes - right, m_pBufferImage + row + right, rowBytes - right);
 	}
+}
 
-	if (NULL == m_pCurrentImage)
+void FrameProcessing::ApplyColorSimplifier(int nPhases, ReportProgressCallback progressCallback)
+{
+	if (m_FuseColorPhases && nPhases > 1)
 	{
-		m_pCurrentImage = new BYTE[size];
+		ApplyColorSimplifierFused(nPhases, progressCallback);
+		return;
 	}
 
-	if (NULL == m_pBufferImage)
+	// The phases run one after the other over the same pixels, each of them replays the
+	// row to thread mapping of the previous one, so the threads find their rows in cache
+	for (int phase = 0; phase < nPhases; ++phase)
 	{
-		m_pBufferImage = new BYTE[size];
+		ApplyColorSimplifier(progressCallback);
 	}
-
-	memcpy_s(m_pCurrentImage, size, pFrame, size);
-	memcpy_s(m_pBufferImage, size, pFrame, size);
-	m_Size = size;
 }
 
-void FrameProcessing::ApplyColorSimplifier(int nPhases, ReportProgressCallback progressCallback)
+void FrameProcessing::ApplyColorSimplifierFused(int nPhases, ReportProgressCallback progressCallback)
 {
-	bounds<1> bnd(nPhases);
-	std::experimental::parallel::for_each(execPolicy, begin(bnd), end(bnd), [&](index<1> /*idx*/)
+	if (NULL == m_pBufferImage)
 	{
-		ApplyColorSimplifier(progressCallback);
+		return;
+	}
+
+	// The pixels are read from the frame itself when nothing was written to the working buffer yet
+	BYTE* pSource = m_BufferStale ? m_pCurrentImage : m_pBufferImage;
+	const int shift = m_NeighborWindow / 2;
+	const int width = m_Width;
+	const int height = m_Height;
+	bounds<2> bnd{ height, width }; //creates bounds matrix of size height x width
+	std::vector<COLORREF> colors(bnd.size());
+	std::vector<COLORREF> simplified(bnd.size());
+
+	// The pixels are unpacked once, the phases run on them and they are packed back once
+	std::experimental::parallel::for_each(execPolicy, bnd, [&](index<2> idx)
+	{
+		colors[idx[0] * width + idx[1]] = GetPixel(pSource, static_cast<int>(idx[1]), static_cast<int>(idx[0]), m_Pitch, m_BPP);
 	});
 
+	// A tile goes through all the phases on a halo of shift pixels per phase while it is in the cache, the phases
+	// in between never reach the frame. A phase reads the colors of the phase before, the pixels within shift of
+	// the edges are kept as they are.
+	std::experimental::parallel::stencil(execPolicy, D4087::array_view<const COLORREF, 2>{ bnd, colors }, D4087::array_view<COLORREF, 2>{ bnd, simplified }, shift,
+		[shift, width, height](const parallel::stencil_neighborhood<COLORREF, 2>& neighborhood) -> COLORREF
+	{
+		const index<2>& pos = neighborhood.position();
+		if (pos[0] < shift || pos[0] >= height - shift || pos[1] < shift || pos[1] >= width - shift)
+		{
+			return neighborhood.center();
+		}
+
+		return SimplifyColor(neighborhood.center(), shift, [&neighborhood](int dx, int dy) { return neighborhood(dy, dx); });
+	}, nPhases);
+
+	// SetPixel leaves the bytes past the color of a pixel alone, a working buffer still to fill takes them from the frame
+	if (m_BufferStale && m_BPP != 24)
+	{
+		FillBuffer();
+	}
+	m_BufferStale = false;
+
+	std::mutex progressCritSec;
+	std::experimental::parallel::for_each(execPolicy, bnd, [&](index<2> idx)
+	{
+		SetPixel(m_pBufferImage, static_cast<int>(idx[1]), static_cast<int>(idx[0]), m_Pitch, m_BPP, simplified[idx[0] * width + idx[1]]);
+		if (idx[1] == 0)
+		{
+			std::lock_guard<std::mutex> lockHolder(progressCritSec);
+			for (int phase = 0; phase < nPhases; ++phase)
+			{
+				UpdateProgress(progressCallback);
+			}
+		}
+	});
 }
 
 void FrameProcessing::ApplyColorSimplifier(ReportProgressCallback progressCallback)
@@ -118,7 +309,8 @@ void FrameProcessing::ApplyColorSimplifier(unsigned int startHeight, unsigned in
 
 	if (NULL != m_pBufferImage)
 	{
-		std::experimental::parallel::for_each(execPolicy, begin(bnd), end(bnd), [&](index<2> idx)
+		FillBuffer();
+		std::experimental::parallel::for_each(simplifierPolicy, begin(bnd), end(bnd), [&](index<2> idx)
 		{
 			SimplifyIndexOptimized(m_pBufferImage, static_cast<int>(idx[0]) + startWidth, static_cast<int>(idx[1]) + startHeight);
 			if (idx[1] == 0)
@@ -132,23 +324,20 @@ void FrameProcessing::ApplyColorSimplifier(unsigned int startHeight, unsigned in
 	}
 }
 
-void FrameProcessing::SimplifyIndexOptimized(BYTE* pFrame, int x, int y)
+template<typename Neighbor>
+COLORREF FrameProcessing::SimplifyColor(COLORREF orgClr, int shift, Neighbor neighbor)
 {
-	COLORREF orgClr = GetPixel(pFrame, x, y, m_Pitch, m_BPP);
-
-	int shift = m_NeighborWindow / 2;
 	double sSum = 0;
 	double partialSumR = 0, partialSumG = 0, partialSumB = 0;
 	double standardDeviation = 0.025;
 
-	for (int j = y - shift; j <= (y + shift); ++j)
+	for (int dy = -shift; dy <= shift; ++dy)
 	{
-		for (int i = x - shift; i <= (x + shift); ++i)
+		for (int dx = -shift; dx <= shift; ++dx)
 		{
-			if (i != x || j != y) // don't apply filter to the requested index, only to the neighbors
+			if (dx != 0 || dy != 0) // don't apply filter to the requested index, only to the neighbors
 			{
-				COLORREF clr = GetPixel(pFrame, i, j, m_Pitch, m_BPP);
-				/*int index = (j - (y - shift)) * m_NeighborWindow + i - (x - shift);*/
+				COLORREF clr = neighbor(dx, dy);
 				double distance = Util::GetDistance(orgClr, clr);
 				double sValue = pow(M_E, -0.5 * pow(distance / standardDeviation, 2));
 				sSum += sValue;
@@ -159,13 +348,18 @@ void FrameProcessing::SimplifyIndexOptimized(BYTE* pFrame, int x, int y)
 		}
 	}
 
-	COLORREF simplifiedClr;
 	int simpleRed, simpleGreen, simpleBlue;
 
 	simpleRed = (int)min(max(partialSumR / sSum, 0), 255);
 	simpleGreen = (int)min(max(partialSumG / sSum, 0), 255);
 	simpleBlue = (int)min(max(partialSumB / sSum, 0), 255);
-	simplifiedClr = RGB(simpleRed, simpleGreen, simpleBlue);
+	return RGB(simpleRed, simpleGreen, simpleBlue);
+}
+
+void FrameProcessing::SimplifyIndexOptimized(BYTE* pFrame, int x, int y)
+{
+	COLORREF orgClr = GetPixel(pFrame, x, y, m_Pitch, m_BPP);
+	COLORREF simplifiedClr = SimplifyColor(orgClr, m_NeighborWindow / 2, [&](int dx, int dy) { return GetPixel(pFrame, x + dx, y + dy, m_Pitch, m_BPP); });
 	SetPixel(m_pBufferImage, x, y, m_Pitch, m_BPP, simplifiedClr);
 }
 
@@ -176,6 +370,14 @@ void FrameProcessing::ApplyEdgeDetection(ReportProgressCallback progressCallback
 
 void FrameProcessing::ApplyEdgeDetectionParallel(unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth, ReportProgressCallback progressCallback)
 {
+#if CARTOONIZER_SSE2
+	if (m_BPP == 32)
+	{
+		ApplyEdgeDetectionRows(startHeight, endHeight, startWidth, endWidth, progressCallback);
+		return;
+	}
+#endif
+
 	const float alpha = 0.3f;
 	const float beta = 0.8f;
 	const float s0 = 0.054f;
@@ -183,14 +385,18 @@ void FrameProcessing::ApplyEdgeDetectionParallel(unsigned int startHeight, unsig
 	const float a0 = 0.3f;
 	const float a1 = 0.7f;
 
-	BYTE* pFrame = new BYTE[m_Size];
-	memcpy_s(pFrame, m_Size, m_pBufferImage, m_Size);
+	// The frame is written to another buffer of the ring, which then becomes the working buffer
+	FillBuffer();
+	FrameBuffer target = AcquireBuffer();
+	BYTE* pFrame = target.Data();
+	CopyOutside(pFrame, startHeight, endHeight, startWidth, endWidth);
 
 	std::mutex progressCritSec;
 	
 	bounds<2> bnd{ (int __w64)(endHeight - startHeight), (int __w64)(endWidth - startWidth) }; //creates bounds matrix of size height x width
 
-	std::experimental::parallel::for_each(execPolicy, begin(bnd), end(bnd), [&](index<2> idx)
+	// Sobel reads the rows around a pixel, tiles keep them in the cache
+	std::experimental::parallel::for_each(execPolicy, bnd, [&](index<2> idx)
 	{
 		int y = static_cast<int>(idx[0]) + startHeight;
 		int x = static_cast<int>(idx[1]) + startWidth;
@@ -222,9 +428,120 @@ void FrameProcessing::ApplyEdgeDetectionParallel(unsigned int startHeight, unsig
 	});
 
 
-	memcpy_s(m_pBufferImage, m_Size, pFrame, m_Size);
-	delete[] pFrame;
+	m_BufferImage = std::move(target);
+	m_pBufferImage = m_BufferImage.Data();
+}
+
+#if CARTOONIZER_SSE2
+void FrameProcessing::ApplyEdgeDetectionRows(unsigned int startHeight, unsigned int endHeight, unsigned int startWidth, unsigned int endWidth, ReportProgressCallback progressCallback)
+{
+	const float alpha = 0.3f;
+	const float beta = 0.8f;
+	const float s0 = 0.054f;
+	const float s1 = 0.064f;
+	const float a0 = 0.3f;
+	const float a1 = 0.7f;
+
+	const int width = m_Width;
+	const int height = m_Height;
+	const int pitch = abs(m_Pitch);
+
+	// The frame is written to another buffer of the ring, which then becomes the working buffer
+	FillBuffer();
+	FrameBuffer target = AcquireBuffer();
+	BYTE* pFrame = target.Data();
+	CopyOutside(pFrame, startHeight, endHeight, startWidth, endWidth);
+
+	// The Y, U and V of both images are computed once, rather than for each of the 9 pixels around
+	YuvPlanes simplified(static_cast<size_t>(width) * height);
+	YuvPlanes original(static_cast<size_t>(width) * height);
+	bounds<2> frameBnd{ height, width };
+	std::experimental::parallel::for_each_tile(execPolicy, frameBnd, [&](const index<2>& origin, const bounds<2>& tile)
+	{
+		for (ptrdiff_t y = origin[0]; y < origin[0] + tile[0]; ++y)
+		{
+			const size_t rowStart = static_cast<size_t>(y) * width;
+			RowToYuv(m_pBufferImage + y * pitch, simplified, rowStart, static_cast<int>(origin[1]), static_cast<int>(origin[1] + tile[1]));
+			RowToYuv(m_pCurrentImage + y * pitch, original, rowStart, static_cast<int>(origin[1]), static_cast<int>(origin[1] + tile[1]));
+		}
+	});
+
+	std::mutex progressCritSec;
+
+	bounds<2> bnd{ (int __w64)(endHeight - startHeight), (int __w64)(endWidth - startWidth) }; //creates bounds matrix of size height x width
+
+	// A tile is a run of rows of a band of columns, each row goes 8 pixels at a time: their gradients, the
+	// edge strength and the darkened colors are computed 4 lanes at a time and stored as 2 runs of 4 pixels
+	std::experimental::parallel::for_each_tile(execPolicy, bnd, [&](const index<2>& origin, const bounds<2>& tile)
+	{
+		const int xBegin = static_cast<int>(origin[1]) + startWidth;
+		const int xEnd = xBegin + static_cast<int>(tile[1]);
+
+		for (ptrdiff_t row = origin[0]; row < origin[0] + tile[0]; ++row)
+		{
+			const int y = static_cast<int>(row) + startHeight;
+			const size_t rowStart = static_cast<size_t>(y) * width;
+			const BYTE* pSource = m_pBufferImage + y * pitch;
+			BYTE* pTarget = pFrame + y * pitch;
+
+			int x = xBegin;
+			for (; x + 8 <= xEnd; x += 8)
+			{
+				for (int half = 0; half < 8; half += 4)
+				{
+					const size_t at = rowStart + x + half;
+					const __m128 edgeS = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1 - alpha), Sobel(&simplified.y[at], width)),
+						_mm_mul_ps(_mm_set1_ps(alpha / 2), _mm_add_ps(Sobel(&simplified.u[at], width), Sobel(&simplified.v[at], width))));
+					const __m128 edgeA = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1 - alpha), Sobel(&original.y[at], width)),
+						_mm_mul_ps(_mm_set1_ps(alpha / 2), _mm_add_ps(Sobel(&original.u[at], width), Sobel(&original.v[at], width))));
+					const __m128 i = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1 - beta), SmoothStep(s0, s1, edgeS)),
+						_mm_mul_ps(_mm_set1_ps(beta), SmoothStep(a0, a1, edgeA)));
+					const __m128 oneMinusi = _mm_sub_ps(_mm_set1_ps(1.0f), i);
+
+					// the channels are darkened and truncated to bytes as RGB does, the fourth byte is kept
+					const __m128i bgra = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSource + 4 * (x + half)));
+					const __m128i byteMask = _mm_set1_epi32(0xFF);
+					const __m128i b = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(bgra, byteMask)), oneMinusi));
+					const __m128i g = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(bgra, 8), byteMask)), oneMinusi));
+					const __m128i r = _mm_cvttps_epi32(_mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(bgra, 16), byteMask)), oneMinusi));
+					const __m128i packed = _mm_or_si128(_mm_or_si128(b, _mm_slli_epi32(g, 8)),
+						_mm_or_si128(_mm_slli_epi32(r, 16), _mm_andnot_si128(_mm_set1_epi32(0xFFFFFF), bgra)));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(pTarget + 4 * (x + half)), packed);
+				}
+			}
+
+			for (; x < xEnd; ++x)
+			{
+				float Sy, Su, Sv;
+				float Ay, Au, Av;
+
+				CalculateSobel(m_pBufferImage, x, y, Sy, Su, Sv);
+				CalculateSobel(m_pCurrentImage, x, y, Ay, Au, Av);
+
+				float edgeS = (1 - alpha) * Sy + alpha * (Su + Sv) / 2;
+				float edgeA = (1 - alpha) * Ay + alpha * (Au + Av) / 2;
+				float i = (1 - beta) * Util::SmoothStep(s0, s1, edgeS) + beta * Util::SmoothStep(a0, a1, edgeA);
+
+				float oneMinusi = 1 - i;
+				COLORREF clr = GetPixel(m_pBufferImage, x, y, m_Pitch, m_BPP);
+				SetPixel(pFrame, x, y, m_Pitch, m_BPP, RGB(GetRValue(clr) * oneMinusi, GetGValue(clr) * oneMinusi, GetBValue(clr) * oneMinusi));
+			}
+		}
+
+		if (origin[1] == 0)
+		{
+			std::lock_guard<std::mutex> lockHolder(progressCritSec);
+			for (ptrdiff_t row = 0; row < tile[0]; ++row)
+			{
+				UpdateProgress(progressCallback);
+			}
+		}
+	});
+
+	m_BufferImage = std::move(target);
+	m_pBufferImage = m_BufferImage.Data();
 }
+#endif
 
 void FrameProcessing::CalculateSobel(BYTE* pSource, int row, int column, float& dy, float& du, float& dv)
 {
@@ -1,12 +1,20 @@
 #include "stdafx.h"
 #include <experimental/algorithm>
+#include <experimental/array_view>
 #include <experimental/coordinate>
+#include <algorithm>
+#include <cmath>
 #include <random>
 
+#if defined(_M_IX86) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
 using namespace std::experimental::D4087;
 
+// Prints the time f takes and the rate of the flops it does, a multiplication of N X N matrices does 2 N^3
 template<typename F>
-void measure_time(F&& f, const char* name)
+void measure_time(F&& f, const char* name, double flops)
 {
 	using namespace std::chrono;
 
@@ -14,9 +22,8 @@ void measure_time(F&& f, const char* name)
 	f();
 	auto end = high_resolution_clock::now();
 
-	printf("%s %llu.%03llu seconds\n", name,
-		duration_cast<seconds>(end - begin).count(),
-		duration_cast<milliseconds>(end - begin).count() % 1000);
+	const double seconds = duration<double>(end - begin).count();
+	printf("%s %8.3f seconds %8.2f GFLOP/s\n", name, seconds, seconds > 0 ? flops / seconds / 1e9 : 0.0);
 }
 
 void multiply_element(const index<2>& idx, const std::vector<double>& vA, const std::vector<double>& vB, std::vector<double>& vResult, int N)
@@ -32,6 +39,113 @@ void multiply_element(const index<2>& idx, const std::vector<double>& vA, const
 	vResult[row * N + col] = sum;
 }
 
+void multiply_element_transposed(const index<2>& idx, const std::vector<double>& vA, const std::vector<double>& vBt, std::vector<double>& vResult, int N)
+{
+	auto row = idx[0];
+	auto col = idx[1];
+
+	double sum = 0;
+
+	for (auto i = 0; i < N; i++)
+		sum += vA[row * N + i] * vBt[col * N + i];
+
+	vResult[row * N + col] = sum;
+}
+
+// The blocks of the result a chore computes are block_side X block_side, their inner products are summed
+// block_depth elements at a time: the rows of A and of the transposed B one pass reads, 2 X 64 X 256 doubles,
+// stay in the L2 cache while the 64 X 64 results are built from them.
+const ptrdiff_t block_side = 64;
+const ptrdiff_t block_depth = 256;
+
+// Adds the inner products of the rows a0, a1 of A with the rows b0, b1 of the transposed B, over depth
+// elements, to the 2 X 2 results at c. A pair of doubles is multiplied at a time, every element loaded
+// is used twice.
+void multiply_2x2(const double* a0, const double* a1, const double* b0, const double* b1, ptrdiff_t depth, double* c, ptrdiff_t c_stride)
+{
+	double c00 = 0, c01 = 0, c10 = 0, c11 = 0;
+	ptrdiff_t k = 0;
+
+#if defined(_M_IX86) || defined(_M_X64)
+	__m128d s00 = _mm_setzero_pd(), s01 = _mm_setzero_pd(), s10 = _mm_setzero_pd(), s11 = _mm_setzero_pd();
+	for (; k + 2 <= depth; k += 2)
+	{
+		const __m128d va0 = _mm_loadu_pd(a0 + k);
+		const __m128d va1 = _mm_loadu_pd(a1 + k);
+		const __m128d vb0 = _mm_loadu_pd(b0 + k);
+		const __m128d vb1 = _mm_loadu_pd(b1 + k);
+		s00 = _mm_add_pd(s00, _mm_mul_pd(va0, vb0));
+		s01 = _mm_add_pd(s01, _mm_mul_pd(va0, vb1));
+		s10 = _mm_add_pd(s10, _mm_mul_pd(va1, vb0));
+		s11 = _mm_add_pd(s11, _mm_mul_pd(va1, vb1));
+	}
+
+	c00 = _mm_cvtsd_f64(_mm_add_sd(s00, _mm_unpackhi_pd(s00, s00)));
+	c01 = _mm_cvtsd_f64(_mm_add_sd(s01, _mm_unpackhi_pd(s01, s01)));
+	c10 = _mm_cvtsd_f64(_mm_add_sd(s10, _mm_unpackhi_pd(s10, s10)));
+	c11 = _mm_cvtsd_f64(_mm_add_sd(s11, _mm_unpackhi_pd(s11, s11)));
+#endif
+
+	for (; k < depth; ++k)
+	{
+		c00 += a0[k] * b0[k];
+		c01 += a0[k] * b1[k];
+		c10 += a1[k] * b0[k];
+		c11 += a1[k] * b1[k];
+	}
+
+	c[0] += c00;
+	c[1] += c01;
+	c[c_stride] += c10;
+	c[c_stride + 1] += c11;
+}
+
+// Adds the inner products of the rows of a with the rows of bt, sections of A and of the transposed B
+// of the same depth, to the results at c. An odd last row or column pairs up with its neighbour, which
+// is then computed twice: the pass writes its results to a buffer, the overlap is written twice and
+// added once.
+void multiply_block(const strided_array_view<const double, 2>& a, const strided_array_view<const double, 2>& bt, double* c, ptrdiff_t c_stride)
+{
+	const ptrdiff_t rows = a.bounds()[0];
+	const ptrdiff_t cols = bt.bounds()[0];
+	const ptrdiff_t depth = a.bounds()[1];
+
+	if (rows < 2 || cols < 2)
+	{
+		for (ptrdiff_t i = 0; i < rows; ++i)
+			for (ptrdiff_t j = 0; j < cols; ++j)
+			{
+				const double* ai = &a[{ i, 0 }];
+				const double* bj = &bt[{ j, 0 }];
+				double sum = 0;
+				for (ptrdiff_t k = 0; k < depth; ++k)
+					sum += ai[k] * bj[k];
+				c[i * c_stride + j] += sum;
+			}
+		return;
+	}
+
+	double pass[block_side * block_side] = {};
+	for (ptrdiff_t i = 0; i < rows; i += 2)
+	{
+		const ptrdiff_t row = (std::min)(i, rows - 2);
+		for (ptrdiff_t j = 0; j < cols; j += 2)
+		{
+			const ptrdiff_t col = (std::min)(j, cols - 2);
+			double out[4] = {};
+			multiply_2x2(&a[{ row, 0 }], &a[{ row + 1, 0 }], &bt[{ col, 0 }], &bt[{ col + 1, 0 }], depth, out, 2);
+			pass[row * block_side + col] = out[0];
+			pass[row * block_side + col + 1] = out[1];
+			pass[(row + 1) * block_side + col] = out[2];
+			pass[(row + 1) * block_side + col + 1] = out[3];
+		}
+	}
+
+	for (ptrdiff_t i = 0; i < rows; ++i)
+		for (ptrdiff_t j = 0; j < cols; ++j)
+			c[i * c_stride + j] += pass[i * block_side + j];
+}
+
 void test_matrix_multiplication(int N)
 {
 	// Create a random number generator.
@@ -45,9 +159,12 @@ void test_matrix_multiplication(int N)
 
 	std::uniform_real_distribution<double> dist(-100, 100);
 
-	// Generate random numbers
-	std::generate(std::begin(vA), std::end(vA), [&generator, &dist](){ return dist(generator); }); //double distribution
-	std::generate(std::begin(vB), std::end(vB), [&generator, &dist](){ return dist(generator); });
+	// Generate random numbers, every element draws from a stream of its own so the chunks don't share the generator
+	std::experimental::parallel::generate_random(std::experimental::parallel::par, std::begin(vA), std::end(vA), generator(), dist); //double distribution
+	std::experimental::parallel::generate_random(std::experimental::parallel::par, std::begin(vB), std::end(vB), generator(), dist);
+
+	const double flops = 2.0 * N * N * N;
+	std::vector<double> vExpected(N * N);
 
 	measure_time([&]() mutable
 	{
@@ -58,7 +175,8 @@ void test_matrix_multiplication(int N)
 		std::for_each(std::begin(bnd), std::end(bnd), [&](index<2> idx) {
 			multiply_element(idx, vA, vB, vResult, N);
 		});
-	}, "serial:       ");
+		vExpected = std::move(vResult);
+	}, "serial:       ", flops);
 
 	measure_time([&]() mutable
 	{
@@ -69,7 +187,58 @@ void test_matrix_multiplication(int N)
 		std::experimental::parallel::for_each(std::experimental::parallel::par, std::begin(bnd), std::end(bnd), [&](index<2> idx)	{
 			multiply_element(idx, vA, vB, vResult, N);
 		});
-	}, "parallel STL: ");
+	}, "parallel STL: ", flops);
+
+	measure_time([&]() mutable
+	{
+		bounds<2> bnd{ N, N };
+		std::vector<double> vResult(bnd.size());
+
+		// Tiles reuse the rows of A and the columns of B they read while they are in the cache
+		std::experimental::parallel::for_each(std::experimental::parallel::par, bnd, [&](index<2> idx) {
+			multiply_element(idx, vA, vB, vResult, N);
+		});
+	}, "tiled:        ", flops);
+
+	measure_time([&]() mutable
+	{
+		bounds<2> bnd{ N, N };
+		std::vector<double> vResult(bnd.size());
+		std::vector<double> vBt(bnd.size());
+
+		// The columns of B are stored as rows once, the inner loop then reads both matrices in order
+		std::experimental::parallel::transpose(std::experimental::parallel::par, array_view<const double, 2>{ bnd, vB }, array_view<double, 2>{ bnd, vBt });
+		std::experimental::parallel::for_each(std::experimental::parallel::par, bnd, [&](index<2> idx) {
+			multiply_element_transposed(idx, vA, vBt, vResult, N);
+		});
+	}, "transposed:   ", flops);
+
+	std::vector<double> vBlocked(N * N);
+	measure_time([&]() mutable
+	{
+		bounds<2> bnd{ N, N };
+		std::vector<double> vBt(bnd.size());
+		array_view<const double, 2> avA{ bnd, vA };
+		array_view<const double, 2> avBt{ bnd, vBt };
+
+		// A chore computes a block of the result from the sections of the rows of A and of the transposed B
+		// it needs, a slice of their depth at a time, the kernel multiplies pairs of doubles
+		std::experimental::parallel::transpose(std::experimental::parallel::par, array_view<const double, 2>{ bnd, vB }, array_view<double, 2>{ bnd, vBt });
+		std::experimental::parallel::for_each_tile(std::experimental::parallel::par, bnd, index<2>{ block_side, block_side }, [&](const index<2>& origin, const bounds<2>& tile) {
+			double* c = &vBlocked[origin[0] * N + origin[1]];
+			for (ptrdiff_t k = 0; k < N; k += block_depth)
+			{
+				const ptrdiff_t depth = (std::min)(block_depth, N - k);
+				multiply_block(avA.section({ origin[0], k }, { tile[0], depth }), avBt.section({ origin[1], k }, { tile[1], depth }), c, N);
+			}
+		});
+	}, "blocked:      ", flops);
+
+	// the sums run in another order, they round differently
+	double error = 0;
+	for (size_t i = 0; i < vBlocked.size(); ++i)
+		error = (std::max)(error, std::abs(vBlocked[i] - vExpected[i]));
+	printf("blocked largest difference from serial %g\n", error);
 }
 
 int _tmain(int /* argc */, _TCHAR* /* argv */[])
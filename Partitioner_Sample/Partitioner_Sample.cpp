@@ -0,0 +1,78 @@
+// Partitioner_Sample.cpp : Compares the partitioners on workloads with uneven per element cost.
+//
+// par runs on the self guided (auto) partitioner, its chunks are fixed once carved.
+// par_dynamic splits running chunks on demand while there are idle workers.
+
+#include "stdafx.h"
+
+#include <vector>
+#include <numeric>
+#include <experimental/algorithm>
+
+using namespace std::experimental::parallel;
+
+template<typename F>
+void measure(F&& f, int iterations, const char* name)
+{
+	using namespace std::chrono;
+
+	// warm up the worker threads
+	f();
+
+	auto begin = high_resolution_clock::now();
+	for (int i = 0; i < iterations; ++i)
+		f();
+	auto end = high_resolution_clock::now();
+
+	printf("%s %10.2f us per call\n", name,
+		duration_cast<nanoseconds>(end - begin).count() / 1000.0 / iterations);
+}
+
+// Spins for the given number of iterations, stands in for parsing a record of that length
+inline void busy_work(size_t cost)
+{
+	volatile size_t sink = 0;
+	for (size_t i = 0; i < cost; ++i)
+		sink = sink + i;
+}
+
+template<typename CostFn>
+void compare_partitioners(const char* workload, size_t size, int iterations, CostFn cost)
+{
+	std::vector<size_t> costs(size);
+	for (size_t i = 0; i < size; ++i)
+		costs[i] = cost(i);
+
+	printf("\n%s, %zu elements, %zu iterations of work in total:\n", workload, size,
+		std::accumulate(costs.begin(), costs.end(), size_t{ 0 }));
+
+	measure([&costs]
+	{
+		std::for_each(costs.begin(), costs.end(), busy_work);
+	}, iterations, "serial:      ");
+
+	measure([&costs]
+	{
+		for_each(par, costs.begin(), costs.end(), busy_work);
+	}, iterations, "par (auto):  ");
+
+	measure([&costs]
+	{
+		for_each(par_dynamic, costs.begin(), costs.end(), busy_work);
+	}, iterations, "par_dynamic: ");
+}
+
+int _tmain(int /* argc */, _TCHAR* /* argv */ [])
+{
+	compare_partitioners("Uniform", 100000, 20, [](size_t) { return size_t{ 100 }; });
+
+	// One percent of the records are 1000 times longer, all of them at the front
+	compare_partitioners("Heavy head", 100000, 20, [](size_t i) { return i < 1000 ? size_t{ 10000 } : size_t{ 10 }; });
+
+	// Cost grows with the index, the last chunks are the most expensive
+	compare_partitioners("Linear ramp", 100000, 20, [](size_t i) { return i / 50; });
+
+	// A few random outliers
+	compare_partitioners("Sparse outliers", 100000, 20, [](size_t i) { return (i * 2654435761u) % 997 == 0 ? size_t{ 100000 } : size_t{ 10 }; });
+	return 0;
+}
@@ -5,6 +5,7 @@
 
 #include <experimental/algorithm>
 #include <ppl.h>
+#include <random>
 
 template<typename F>
 void measure_time(F&& f, const char* name)
@@ -34,21 +35,60 @@ int test_sort(int size)
 		std::sort(v.begin(), v.end());
 	}, "serial:       ");
 
-	// Using Parallel STL implementation
+	// Using Parallel STL implementation, ints under std::less take the radix sort
 	measure_time([v]() mutable 
 	{
 		std::experimental::parallel::sort(std::experimental::parallel::par, v.begin(), v.end());
 	}, "parallel STL: ");
 
+	// A comparator other than std::less or std::greater keeps the quicksort
+	measure_time([v]() mutable 
+	{
+		std::experimental::parallel::sort(std::experimental::parallel::par, v.begin(), v.end(), [](int a, int b) { return a < b; });
+	}, "par. STL qs:  ");
+
 	// Using PPL implementation
 	measure_time([v]() mutable 
 	{
 		concurrency::parallel_sort(v.begin(), v.end());
 	}, "PPL:          ");
 
+	measure_time([v]() mutable 
+	{
+		concurrency::parallel_radixsort(v.begin(), v.end());
+	}, "PPL radix:    ");
+
 	return 0;
 }
  
+int test_median(size_t size)
+{
+	// One vector refilled before every run, the largest size takes 4 GB already
+	std::vector<int> v(size);
+	auto refill = [&v] {
+		std::mt19937 gen(42);
+		for (auto& x : v)
+			x = static_cast<int>(gen());
+	};
+
+	printf("\nTesting median of %zu ints:\n", size);
+
+	refill();
+	measure_time([&v]()
+	{
+		std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+	}, "serial:       ");
+
+	// Sampled pivots, counted and partitioned in parallel
+	refill();
+	measure_time([&v]()
+	{
+		std::experimental::parallel::nth_element(std::experimental::parallel::par, v.begin(), v.begin() + v.size() / 2, v.end());
+	}, "parallel STL: ");
+
+	return 0;
+}
+
 int _tmain(int /* argc */, _TCHAR* /* argv */ [])
 {
 	test_sort(1000 * 100);
@@ -56,6 +96,10 @@ int _tmain(int /* argc */, _TCHAR* /* argv */ [])
 	test_sort(1000 * 1000 * 10);
 	test_sort(1000 * 1000 * 50);
 	test_sort(1000 * 1000 * 100);
+
+	test_median(1000 * 1000 * 10);
+	test_median(1000 * 1000 * 100);
+	test_median(size_t{ 1000 } * 1000 * 1000);
 	return 0;
 }
 
@@ -7,7 +7,9 @@
 #include <atomic>
 #include <type_traits>
 #include <chrono>
+#ifndef UTILS_NO_CPP_UNIT_TEST // the benchmark borrows the test iterators, without the test framework
 #include <CppUnitTest.h>
+#endif
 // GLUE macro
 #define GLUE2(A, B) A ## B
 #define GLUE(A, B) GLUE2(A, B)
@@ -320,6 +322,7 @@ public:
 		int _Copy_count;
 	};
 
+#ifndef UTILS_NO_CPP_UNIT_TEST
 	template<typename F>
 	void measure_time(F&& f, const char* name)
 	{
@@ -341,6 +344,7 @@ public:
 		Logger::WriteMessage(buffer);
 #endif
 	}
+#endif
 
 	struct CustomException {};
 
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include <list>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(AdjacentDifferenceTest)
+	{
+		TEST_METHOD(AdjacentDifference)
+		{
+			for (size_t _Size : { 0, 1, 2, 7, 8, 17, 1000, 100003 })
+			{
+				// a delta encoded column decodes back with partial_sum
+				std::vector<long long> _Column(_Size);
+				for (size_t _I = 0; _I < _Size; ++_I)
+					_Column[_I] = static_cast<long long>(_I * _I) - 1000;
+
+				std::vector<long long> _Expected(_Size);
+				std::adjacent_difference(std::begin(_Column), std::end(_Column), std::begin(_Expected));
+
+				std::vector<long long> _Deltas(_Size);
+				auto _It = adjacent_difference(seq, std::begin(_Column), std::end(_Column), std::begin(_Deltas));
+				Assert::IsTrue(_It == std::end(_Deltas));
+				Assert::IsTrue(_Deltas == _Expected);
+
+				std::fill(std::begin(_Deltas), std::end(_Deltas), 0);
+				_It = adjacent_difference(par, std::begin(_Column), std::end(_Column), std::begin(_Deltas));
+				Assert::IsTrue(_It == std::end(_Deltas));
+				Assert::IsTrue(_Deltas == _Expected);
+
+				std::fill(std::begin(_Deltas), std::end(_Deltas), 0);
+				_It = adjacent_difference(par_vec, std::begin(_Column), std::end(_Column), std::begin(_Deltas));
+				Assert::IsTrue(_It == std::end(_Deltas));
+				Assert::IsTrue(_Deltas == _Expected);
+
+				std::list<long long> _List(std::begin(_Column), std::end(_Column)), _List_out(_Size);
+				adjacent_difference(par, std::begin(_List), std::end(_List), std::begin(_List_out), std::minus<>());
+				Assert::IsTrue(std::equal(std::begin(_List_out), std::end(_List_out), std::begin(_Expected)));
+
+				std::vector<long long> _Decoded(_Size);
+				_It = partial_sum(par, std::begin(_Deltas), std::end(_Deltas), std::begin(_Decoded));
+				Assert::IsTrue(_It == std::end(_Decoded));
+				Assert::IsTrue(_Decoded == _Column);
+			}
+		}
+
+		TEST_METHOD(AdjacentDifferenceThrow)
+		{
+			std::vector<int> _Vec(10000), _Out(10000);
+			std::iota(std::begin(_Vec), std::end(_Vec), 0);
+
+			try {
+				adjacent_difference(par, std::begin(_Vec), std::end(_Vec), std::begin(_Out), [](int _Left, int) -> int {
+					if (_Left == 5000)
+						throw std::runtime_error("adjacent_difference");
+					return 0;
+				});
+				Assert::Fail();
+			}
+			catch (exception_list& e) {
+				Assert::IsTrue(e.size() > 0);
+			}
+		}
+	};
+} // ParallelSTL_Tests
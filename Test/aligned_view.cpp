@@ -0,0 +1,87 @@
+#include "stdafx.h"
+
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(AlignedViewTest)
+	{
+		static bool IsAligned(const void *_Ptr, size_t _Alignment)
+		{
+			return reinterpret_cast<std::uintptr_t>(_Ptr) % _Alignment == 0;
+		}
+
+		template<typename _Ty, int _Rank, typename _ExPolicy>
+		void CheckAlignedView(_ExPolicy&& _Policy, const bounds<_Rank>& _Bnd)
+		{
+			typedef aligned_array_view<_Ty, _Rank, 64> _Aligned_view;
+
+			std::vector<_Ty, aligned_allocator<_Ty, 64>> _Storage(_Aligned_view::required_size(_Bnd), _Ty(-3));
+			_Aligned_view _View(_Bnd, _Storage);
+			for (ptrdiff_t _Row = 0; _Row < _View.rows(); ++_Row)
+				Assert::IsTrue(IsAligned(_View.row(_Row), 64));
+
+			fill(_Policy, _View, 9);
+			for (auto _Idx : _Bnd)
+				Assert::IsTrue(_View[_Idx] == _Ty(9));
+
+			std::vector<_Ty> _In(_Bnd.size());
+			for (size_t _I = 0; _I < _In.size(); ++_I)
+				_In[_I] = _Ty(_I % 100 + 1);
+			copy(_Policy, array_view<const _Ty, _Rank>{ _Bnd, _In }, _View);
+
+			// aligned loads from an aligned source
+			std::vector<_Ty, aligned_allocator<_Ty, 64>> _Other_storage(_Aligned_view::required_size(_Bnd));
+			_Aligned_view _Other(_Bnd, _Other_storage);
+			copy(_Policy, _View, _Other);
+
+			size_t _Pos = 0;
+			for (auto _Idx : _Bnd)
+			{
+				Assert::IsTrue(_View[_Idx] == _In[_Pos]);
+				Assert::IsTrue(_Other[_Idx] == _In[_Pos]);
+				++_Pos;
+			}
+
+			// the padding at the end of the rows is left alone
+			if (_View.pitch() > _Bnd[_Rank - 1])
+				Assert::IsTrue(_Storage[_Bnd[_Rank - 1]] == _Ty(-3));
+		}
+
+		template<typename _ExPolicy>
+		void RunAlignedView(_ExPolicy&& _Policy)
+		{
+			CheckAlignedView<float>(_Policy, bounds<2>{ 5, 7 });
+			CheckAlignedView<float>(_Policy, bounds<2>{ 33, 100 });
+			CheckAlignedView<double>(_Policy, bounds<2>{ 100, 3 });
+			CheckAlignedView<char>(_Policy, bounds<2>{ 17, 130 });
+			CheckAlignedView<int>(_Policy, bounds<3>{ 3, 4, 21 });
+			CheckAlignedView<int>(_Policy, bounds<1>{ 1000 });
+			CheckAlignedView<long long>(_Policy, bounds<2>{ 6, 5 });
+		}
+
+		TEST_METHOD(AlignedView)
+		{
+			RunAlignedView(seq);
+			RunAlignedView(par);
+			RunAlignedView(par_vec);
+			RunAlignedView(par.with(partitioner(dynamic_)));
+			RunAlignedView(execution_policy(par));
+		}
+
+		TEST_METHOD(AlignedViewPitch)
+		{
+			Assert::AreEqual(ptrdiff_t(16), aligned_array_view<float, 2, 64>::padded_pitch(10));
+			Assert::AreEqual(ptrdiff_t(16), aligned_array_view<float, 2, 64>::padded_pitch(16));
+			Assert::AreEqual(ptrdiff_t(32), aligned_array_view<char, 2, 32>::padded_pitch(17));
+
+			// the rows of an image one pitch apart, the other algorithms take the view as a strided one
+			std::vector<int, aligned_allocator<int, 32>> _Image(20 * 24, 0);
+			aligned_array_view<int, 2, 32> _Rows({ 20, 21 }, 24, _Image.data());
+			for_each(par, _Rows, [](int& _Val) { _Val = 1; });
+
+			Assert::AreEqual(ptrdiff_t(20 * 21), std::count(std::begin(_Image), std::end(_Image), 1));
+			Assert::AreEqual(0, _Image[21]);
+		}
+	};
+} // ParallelSTL_Tests
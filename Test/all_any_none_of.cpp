@@ -162,6 +162,31 @@ namespace ParallelSTL_Tests
 			RunAllOf<random_access_iterator_tag>(Any, false);
 			RunAllOf<random_access_iterator_tag>(None, false);		
 		}
+
+		// A match in the first block ends every chunk at its next block
+		TEST_METHOD(AnyOfEarlyExit)
+		{
+			const size_t _Size = 4000000;
+			std::vector<int> _Ct(_Size, 0);
+
+			const size_t positions[] = { 0, 1023, _Size / 2, _Size - 1 };
+			for (auto _Pos : positions) {
+				_Ct[_Pos] = 1;
+
+				std::atomic<size_t> _Calls(0);
+				Assert::IsTrue(any_of(par, std::begin(_Ct), std::end(_Ct), [&_Calls](int _Val) { ++_Calls; return _Val == 1; }));
+				Assert::IsFalse(none_of(par_vec, std::begin(_Ct), std::end(_Ct), [](int _Val) { return _Val == 1; }));
+				Assert::IsFalse(all_of(par, std::begin(_Ct), std::end(_Ct), [](int _Val) { return _Val == 0; }));
+
+				if (_Pos == 0)
+					Assert::IsTrue(_Calls.load() < _Size);
+
+				_Ct[_Pos] = 0;
+			}
+
+			Assert::IsFalse(any_of(par, std::begin(_Ct), std::end(_Ct), [](int _Val) { return _Val == 1; }));
+			Assert::IsTrue(all_of(par_vec, std::begin(_Ct), std::end(_Ct), [](int _Val) { return _Val == 0; }));
+		}
 	};
 } // ParallelSTL_Tests
 
@@ -592,5 +592,80 @@ namespace ParallelSTL_Tests
 				c[idx] = sum;
 			});
 		}
+
+		template<typename _ExPolicy>
+		void RunParallelViewAlgorithms(_ExPolicy&& _Policy)
+		{
+			const ptrdiff_t _Rows = 70;
+			const ptrdiff_t _Cols = 130;
+			std::vector<int> _Vec(_Rows * _Cols);
+			std::iota(std::begin(_Vec), std::end(_Vec), 0);
+
+			array_view<int, 2> _Av{ { _Rows, _Cols }, _Vec };
+			strided_array_view<int, 2> _Inner = _Av.section({ 3, 5 }, { 60, 111 });
+			strided_array_view<int, 2> _Column_major{ { _Cols, _Rows }, { 1, _Cols }, _Vec.data() };
+
+			{ // for_each over a contiguous view, a section and a view of unit rows
+				for_each(_Policy, _Av, [](int& _Val) { _Val *= 2; });
+				for_each(_Policy, _Inner, [](int& _Val) { ++_Val; });
+				for_each(_Policy, _Column_major, [](int& _Val) { _Val += 1000000; });
+
+				for (ptrdiff_t _I = 0; _I < _Rows; ++_I)
+					for (ptrdiff_t _J = 0; _J < _Cols; ++_J)
+					{
+						const bool _In_section = _I >= 3 && _I < 63 && _J >= 5 && _J < 116;
+						Assert::AreEqual(static_cast<int>(2 * (_I * _Cols + _J) + 1000000 + (_In_section ? 1 : 0)), _Av[{ _I, _J }]);
+					}
+			}
+
+			{ // fill and copy between views of the same bounds with different strides
+				fill(_Policy, _Av, 7);
+				fill(_Policy, _Inner, 3);
+				Assert::AreEqual(static_cast<int>(_Inner.size()), static_cast<int>(std::count(std::begin(_Vec), std::end(_Vec), 3)));
+
+				std::vector<int> _Out(60 * 111);
+				array_view<int, 2> _Out_av{ { 60, 111 }, _Out };
+				copy(_Policy, _Inner, _Out_av);
+				Assert::IsTrue(std::all_of(std::begin(_Out), std::end(_Out), [](int _Val) { return _Val == 3; }));
+
+				strided_array_view<int, 2> _Transposed{ { _Cols, _Rows }, { 1, _Cols }, _Vec.data() };
+				std::vector<int> _Dest(_Cols * _Rows);
+				array_view<int, 2> _Dest_av{ { _Cols, _Rows }, _Dest };
+				std::iota(std::begin(_Vec), std::end(_Vec), 0);
+				copy(_Policy, _Transposed, _Dest_av);
+				for (ptrdiff_t _I = 0; _I < _Cols; ++_I)
+					for (ptrdiff_t _J = 0; _J < _Rows; ++_J)
+						Assert::AreEqual(static_cast<int>(_J * _Cols + _I), _Dest_av[{ _I, _J }]);
+			}
+
+			{ // transform of a read only view to a section, and of one long row cut in pieces
+				const std::vector<int> _Src(60 * 111, 5);
+				array_view<const int, 2> _Src_av{ { 60, 111 }, _Src };
+				fill(_Policy, _Av, 0);
+				transform(_Policy, _Src_av, _Inner, [](int _Val) { return _Val * 3; });
+				Assert::AreEqual(static_cast<int>(_Inner.size()), static_cast<int>(std::count(std::begin(_Vec), std::end(_Vec), 15)));
+
+				std::vector<int> _Long(5 * 100000, 1);
+				strided_array_view<int, 1> _Evens{ { 250000 }, { 2 }, _Long.data() };
+				transform(_Policy, _Evens, _Evens, [](int _Val) { return _Val + 1; });
+				for (size_t _I = 0; _I < _Long.size(); ++_I)
+					Assert::AreEqual(_I % 2 == 0 ? 2 : 1, _Long[_I]);
+			}
+
+			{ // empty views
+				array_view<int, 2> _Empty{ { 0, 10 }, _Vec };
+				for_each(_Policy, _Empty, [](int&) { Assert::Fail(); });
+				fill(_Policy, _Empty, 1);
+			}
+		}
+
+		TEST_METHOD(ParallelViewAlgorithms)
+		{
+			RunParallelViewAlgorithms(seq);
+			RunParallelViewAlgorithms(par);
+			RunParallelViewAlgorithms(par_vec);
+			RunParallelViewAlgorithms(par.with(grain(64)));
+			RunParallelViewAlgorithms(execution_policy(par));
+		}
 	};
 } // ParallelSTL_Tests
\ No newline at end of file
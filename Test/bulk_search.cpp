@@ -0,0 +1,76 @@
+#include "stdafx.h"
+#include <list>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(BulkSearchTest)
+	{
+		typedef std::vector<int>::const_iterator _Sorted_iterator;
+
+		template<typename _ExPolicy, typename _FwdIt>
+		void CheckBulkSearch(_ExPolicy&& _Policy, const std::vector<int>& _Sorted, _FwdIt _First, _FwdIt _Last)
+		{
+			const size_t _Count = std::distance(_First, _Last);
+			std::vector<_Sorted_iterator> _Lower(_Count), _Upper(_Count), _Indexed(_Count);
+			std::vector<std::pair<_Sorted_iterator, _Sorted_iterator>> _Ranges(_Count);
+
+			Assert::IsTrue(bulk_lower_bound(_Policy, _Sorted.cbegin(), _Sorted.cend(), _First, _Last, _Lower.begin()) == _Lower.end());
+			Assert::IsTrue(bulk_upper_bound(_Policy, _Sorted.cbegin(), _Sorted.cend(), _First, _Last, _Upper.begin()) == _Upper.end());
+			Assert::IsTrue(bulk_equal_range(_Policy, _Sorted.cbegin(), _Sorted.cend(), _First, _Last, _Ranges.begin()) == _Ranges.end());
+
+			size_t _I = 0;
+			for (_FwdIt _It = _First; _It != _Last; ++_It, ++_I)
+			{
+				Assert::IsTrue(_Lower[_I] == std::lower_bound(_Sorted.cbegin(), _Sorted.cend(), *_It));
+				Assert::IsTrue(_Upper[_I] == std::upper_bound(_Sorted.cbegin(), _Sorted.cend(), *_It));
+				Assert::IsTrue(_Ranges[_I] == std::make_pair(_Lower[_I], _Upper[_I]));
+			}
+
+			eytzinger_index<_Sorted_iterator> _Index(_Sorted.cbegin(), _Sorted.cend());
+			bulk_lower_bound(_Policy, _Index, _First, _Last, _Indexed.begin());
+			Assert::IsTrue(_Indexed == _Lower);
+			bulk_upper_bound(_Policy, _Index, _First, _Last, _Indexed.begin());
+			Assert::IsTrue(_Indexed == _Upper);
+		}
+
+		TEST_METHOD(BulkSearch)
+		{
+			for (size_t _Size : { 0, 1, 2, 17, 1000, 100003 })
+			{
+				// even values with duplicates, the odd queries fall between them
+				std::vector<int> _Sorted(_Size);
+				for (size_t _I = 0; _I < _Size; ++_I)
+					_Sorted[_I] = static_cast<int>(_I / 3 * 2);
+
+				std::vector<int> _Queries(20000);
+				for (size_t _I = 0; _I < _Queries.size(); ++_I)
+					_Queries[_I] = static_cast<int>((_I * 2654435761u) % (_Size + 3)) - 1;
+				std::list<int> _List(std::begin(_Queries), std::end(_Queries));
+
+				CheckBulkSearch(seq, _Sorted, std::begin(_Queries), std::end(_Queries));
+				CheckBulkSearch(par, _Sorted, std::begin(_Queries), std::end(_Queries));
+				CheckBulkSearch(par_vec, _Sorted, std::begin(_Queries), std::end(_Queries));
+				CheckBulkSearch(par, _Sorted, std::begin(_List), std::end(_List));
+
+				// ascending queries are searched from one bound to the next
+				std::sort(std::begin(_Queries), std::end(_Queries));
+				CheckBulkSearch(par, _Sorted, std::begin(_Queries), std::end(_Queries));
+				CheckBulkSearch(par.with(grain(256), max_threads(3)), _Sorted, std::begin(_Queries), std::end(_Queries));
+			}
+		}
+
+		TEST_METHOD(BulkSearchDescending)
+		{
+			std::vector<int> _Sorted(50000);
+			for (size_t _I = 0; _I < _Sorted.size(); ++_I)
+				_Sorted[_I] = static_cast<int>(_Sorted.size() - _I) / 2;
+
+			std::vector<int> _Queries = { 30000, 0, 12345, 25000, -1, 7 };
+
+			std::vector<_Sorted_iterator> _Lower(_Queries.size());
+			bulk_lower_bound(par, _Sorted.cbegin(), _Sorted.cend(), _Queries.begin(), _Queries.end(), _Lower.begin(), std::greater<int>());
+			for (size_t _I = 0; _I < _Queries.size(); ++_I)
+				Assert::IsTrue(_Lower[_I] == std::lower_bound(_Sorted.cbegin(), _Sorted.cend(), _Queries[_I], std::greater<int>()));
+		}
+	};
+} // ParallelSTL_Tests
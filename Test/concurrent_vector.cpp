@@ -0,0 +1,146 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	// An element whose copy throws when its source is marked, counts the elements alive
+	struct ThrowingCopy
+	{
+		static std::atomic<int> Live;
+		int Value;
+		bool Throws;
+
+		ThrowingCopy() : Value(0), Throws(false)
+		{
+			++Live;
+		}
+
+		ThrowingCopy(int _Val, bool _Throws) : Value(_Val), Throws(_Throws)
+		{
+			++Live;
+		}
+
+		ThrowingCopy(const ThrowingCopy& _Other) : Value(_Other.Value), Throws(false)
+		{
+			if (_Other.Throws)
+				throw std::runtime_error("copy");
+			++Live;
+		}
+
+		~ThrowingCopy()
+		{
+			--Live;
+		}
+	};
+
+	std::atomic<int> ThrowingCopy::Live;
+
+	TEST_CLASS(ConcurrentVectorTest)
+	{
+		template<typename _ExPolicy>
+		void TestCopyIf(_ExPolicy&& _Policy)
+		{
+			std::vector<int> _Data(100000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+			auto _Pred = [](int _Val) { return _Val % 3 == 0; };
+
+			concurrent_vector<int> _Kept;
+			copy_if(_Policy, std::begin(_Data), std::end(_Data), std::back_inserter(_Kept), _Pred);
+
+			std::vector<int> _Expected;
+			std::copy_if(std::begin(_Data), std::end(_Data), std::back_inserter(_Expected), _Pred);
+			std::vector<int> _Result(std::begin(_Kept), std::end(_Kept));
+			std::sort(std::begin(_Result), std::end(_Result));
+			Assert::IsTrue(_Expected == _Result);
+
+			concurrent_vector<int> _Removed;
+			remove_copy_if(_Policy, std::begin(_Data), std::end(_Data), std::back_inserter(_Removed), _Pred);
+			Assert::AreEqual(_Data.size() - _Expected.size(), _Removed.size());
+			for (int _Val : _Removed)
+				Assert::IsFalse(_Pred(_Val));
+		}
+
+	public:
+		TEST_METHOD(ConcurrentVectorGrowBy)
+		{
+			concurrent_vector<std::string> _Vec;
+			_Vec.push_back("first");
+			const std::string *_First = &_Vec[0];
+
+			std::vector<int> _Rounds(1000);
+			for_each(par, std::begin(_Rounds), std::end(_Rounds), [&_Vec](int) {
+				std::string _Values[] = { "a", "b", "c" };
+				auto _It = _Vec.grow_by(std::begin(_Values), std::end(_Values));
+				Assert::AreEqual(std::string("a"), *_It);
+				Assert::AreEqual(std::string("c"), _It[2]);
+			});
+
+			Assert::AreEqual(size_t(3001), _Vec.size());
+			Assert::IsTrue(_First == &_Vec[0]);
+			Assert::AreEqual(std::string("first"), _Vec[0]);
+			Assert::AreEqual(1000L, static_cast<long>(std::count(std::begin(_Vec), std::end(_Vec), std::string("b"))));
+
+			auto _It = _Vec.grow_by(5, std::string("x"));
+			Assert::IsTrue(_Vec.end() - _It == 5);
+			_Vec.clear();
+			Assert::IsTrue(_Vec.empty());
+		}
+
+		TEST_METHOD(ConcurrentVectorThrowingCopy)
+		{
+			ThrowingCopy::Live = 0;
+			{
+				concurrent_vector<ThrowingCopy> _Vec;
+				const ThrowingCopy _Good(1, false), _Bad(2, true);
+				_Vec.push_back(_Good);
+
+				// the slot of a failed append stays in the vector, value initialized
+				try {
+					_Vec.push_back(_Bad);
+					Assert::Fail(L"The copy didn't throw");
+				}
+				catch (const std::runtime_error&) {
+				}
+
+				ThrowingCopy _Moved(3, true);
+				try {
+					_Vec.push_back(std::move(_Moved));
+					Assert::Fail(L"The copy didn't throw");
+				}
+				catch (const std::runtime_error&) {
+				}
+
+				ThrowingCopy _Values[] = { ThrowingCopy(4, false), ThrowingCopy(5, true), ThrowingCopy(6, false) };
+				try {
+					_Vec.grow_by(std::begin(_Values), std::end(_Values));
+					Assert::Fail(L"The copy didn't throw");
+				}
+				catch (const std::runtime_error&) {
+				}
+
+				Assert::AreEqual(size_t(6), _Vec.size());
+				Assert::AreEqual(1, _Vec[0].Value);
+				Assert::AreEqual(0, _Vec[1].Value);
+				Assert::AreEqual(0, _Vec[2].Value);
+				Assert::AreEqual(4, _Vec[3].Value);
+				Assert::AreEqual(0, _Vec[4].Value);
+				Assert::AreEqual(0, _Vec[5].Value);
+
+				// every element clear destroys was constructed
+				_Vec.clear();
+				Assert::AreEqual(6, ThrowingCopy::Live.load());
+
+				_Vec.push_back(_Good);
+				_Vec.grow_by(2);
+				Assert::AreEqual(size_t(3), _Vec.size());
+			}
+			Assert::AreEqual(0, ThrowingCopy::Live.load());
+		}
+
+		TEST_METHOD(ConcurrentVectorCopyIf)
+		{
+			TestCopyIf(seq);
+			TestCopyIf(par);
+			TestCopyIf(par_vec);
+		}
+	};
+}
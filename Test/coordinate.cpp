@@ -938,5 +938,47 @@ namespace ParallelSTL_Tests
 				}
 			}
 		}
+
+		template <int Rank>
+		void CheckBoundsWalk(const bounds<Rank>& bnd)
+		{
+			ptrdiff_t pos = 0;
+			for (auto it = begin(bnd); it != end(bnd); ++it, ++pos)
+			{
+				Assert::IsTrue(bnd.contains(*it));
+				Assert::IsTrue(*(begin(bnd) + pos) == *it);
+				Assert::AreEqual(pos, it - begin(bnd));
+			}
+
+			Assert::AreEqual(static_cast<ptrdiff_t>(bnd.size()), pos);
+			Assert::AreEqual(pos, end(bnd) - begin(bnd));
+
+			index<Rank> past;
+			past[Rank - 1] = bnd[Rank - 1];
+			Assert::IsFalse(bnd.contains(past));
+
+			index<Rank> before;
+			before[0] = -1;
+			Assert::IsFalse(bnd.contains(before));
+		}
+
+		TEST_METHOD(BoundsWalkUnrolledRanks)
+		{
+			// the ranks up to 4 take the unrolled operations, the larger ones the loops
+			CheckBoundsWalk(bounds<2>{ 3, 4 });
+			CheckBoundsWalk(bounds<3>{ 2, 3, 4 });
+			CheckBoundsWalk(bounds<4>{ 2, 1, 3, 2 });
+			CheckBoundsWalk(bounds<5>{ 2, 2, 1, 3, 2 });
+
+			index<4> idx{ 1, 2, 3, 4 };
+			idx += index<4>{ 1, 1, 1, 1 };
+			idx *= 2;
+			Assert::IsTrue((idx == index<4>{ 4, 6, 8, 10 }));
+			Assert::IsTrue((-idx / 2 == index<4>{ -2, -3, -4, -5 }));
+
+			index<5> big{ 1, 2, 3, 4, 5 };
+			big -= big;
+			Assert::IsTrue((big == index<5>{}));
+		}
 	};
 } // ParallelSTL_Tests
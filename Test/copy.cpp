@@ -214,6 +214,76 @@ namespace ParallelSTL_Tests
 			}
 		}
 
+		template<typename _IterCat, typename _IterCat2 = _IterCat>
+		void RunUninitializedMove()
+		{
+			{  // seq
+				CopyAlgoTest<_IterCat, _IterCat2> _Alg;
+				_Alg.set_result(uninitialized_move(seq, _Alg.begin_in(), _Alg.end_in(), _Alg.begin_dest()));
+			}
+
+			{  //par
+				CopyAlgoTest<_IterCat, _IterCat2> _Alg;
+				_Alg.set_result(uninitialized_move(par, _Alg.begin_in(), _Alg.end_in(), _Alg.begin_dest()));
+			}
+
+			{  //par_affinity
+				affinity_partitioner _Affinity;
+				CopyAlgoTest<_IterCat, _IterCat2> _Alg;
+				_Alg.set_result(uninitialized_move(par_affinity(_Affinity), _Alg.begin_in(), _Alg.end_in(), _Alg.begin_dest()));
+			}
+
+			{  //par_vec
+				CopyAlgoTest<_IterCat, _IterCat2> _Alg;
+				_Alg.set_result(uninitialized_move_n(par_vec, _Alg.begin_in(), _Alg.size_in(), _Alg.begin_dest()).second);
+			}
+		}
+
+		TEST_METHOD(UninitializedMove)
+		{
+			RunUninitializedMove<random_access_iterator_tag>();
+			RunUninitializedMove<forward_iterator_tag>();
+			RunUninitializedMove<input_iterator_tag, forward_iterator_tag>();
+		}
+
+		// The chunks constructed by the workers of the affinity partitioner are destroyed when another one throws
+		TEST_METHOD(UninitializedMoveFirstTouchRollback)
+		{
+			const static int MAX_DATA_SIZE = 32 + (rand() % 1024);
+
+			UnintializeHelper::set_no_exception();
+
+			std::unique_ptr<UnintializeHelper[]> vec(new UnintializeHelper[MAX_DATA_SIZE]);
+			std::unique_ptr<UnintializeHelper[]> dest(new UnintializeHelper[MAX_DATA_SIZE]);
+
+			{
+				UnintializeHelper::reset();
+				affinity_partitioner _Affinity;
+
+				try {
+					uninitialized_move_n(par_affinity(_Affinity), vec.get(), MAX_DATA_SIZE, dest.get());
+					Assert::Fail();
+				}
+				catch (exception_list& e) {
+					Assert::IsTrue(e.size() > 0);
+
+					for (auto& _E : e) {
+						try {
+							std::rethrow_exception(_E);
+						}
+						catch (CustomException&) {}
+						catch (...) {
+							Assert::Fail();
+						}
+					}
+				}
+
+				Assert::AreEqual(0, UnintializeHelper::get_count());
+			}
+
+			UnintializeHelper::set_no_exception();
+		}
+
 		template<typename _IterCat, typename _IterCat2 = _IterCat>
 		void RunMove()
 		{
@@ -343,6 +413,77 @@ namespace ParallelSTL_Tests
 			
 			Assert::AreEqual(static_cast<size_t>(std::distance(std::begin(vec_out), _Iter)), size_t{ 5 });
 		}
+
+		TEST_METHOD(CopyIfFilterMaskBoundaries)
+		{
+			// Sizes around the word boundaries of the filter mask, the chunks split the range at whole words
+			for (size_t _Size : { 63, 64, 65, 127, 128, 129, 4095, 4097, 100003 }) {
+				std::vector<int> vec(_Size), dest(_Size, -1), expected;
+				for (size_t _I = 0; _I < _Size; ++_I)
+					vec[_I] = static_cast<int>((_I * 7919) % 13);
+
+				auto _Pred = [](int _Val) { return _Val % 3 == 0; };
+				std::copy_if(std::begin(vec), std::end(vec), std::back_inserter(expected), _Pred);
+
+				auto _Iter = copy_if(par, std::begin(vec), std::end(vec), std::begin(dest), _Pred);
+				Assert::AreEqual(expected.size(), static_cast<size_t>(std::distance(std::begin(dest), _Iter)));
+				Assert::IsTrue(std::equal(std::begin(expected), std::end(expected), std::begin(dest)));
+			}
+		}
+
+		// Trivially copyable contiguous ranges are copied by memcpy in chunks on page boundaries, the
+		// big ones with streaming stores
+		TEST_METHOD(CopyBulk)
+		{
+			const size_t sizes[] = { 1, 1000, 100003, 9000001 };
+
+			for (auto _Size : sizes) {
+				std::vector<int> src(_Size + 1);
+				std::iota(std::begin(src), std::end(src), 0);
+
+				// The destination starts off a page boundary
+				std::vector<int> dest(_Size + 2, -1);
+				auto _Res = copy(par, std::begin(src) + 1, std::end(src), std::begin(dest) + 1);
+				Assert::IsTrue(_Res == std::end(dest) - 1);
+				Assert::IsTrue(std::equal(std::begin(src) + 1, std::end(src), std::begin(dest) + 1));
+				Assert::IsTrue(dest.front() == -1 && dest.back() == -1);
+
+				std::vector<int> dest_n(_Size);
+				Assert::IsTrue(copy_n(par_vec, src.data(), _Size, dest_n.data()) == dest_n.data() + _Size);
+				Assert::IsTrue(std::equal(std::begin(dest_n), std::end(dest_n), std::begin(src)));
+
+				std::vector<int> moved(_Size);
+				Assert::IsTrue(move(par, std::begin(src), std::end(src) - 1, std::begin(moved)) == std::end(moved));
+				Assert::IsTrue(std::equal(std::begin(moved), std::end(moved), std::begin(src)));
+			}
+		}
+
+		// The copy stage of contiguous arithmetic ranges reads the marks a word at a time, runs of all marked and
+		// of none marked elements and the last partial word of every chunk must come out as the marks are read
+		template<typename _Ty>
+		static void CheckCopyIfCompressed(size_t _Size)
+		{
+			std::vector<_Ty> src(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+				src[_I] = static_cast<_Ty>((_I / 700) % 3 == 0 ? _I * 7 % 13 : ((_I / 700) % 3 == 1 ? 1 : 0));
+
+			auto _Pred = [](_Ty _Val) { return _Val > 3 || _Val == 1; };
+			std::vector<_Ty> expected;
+			std::copy_if(std::begin(src), std::end(src), std::back_inserter(expected), _Pred);
+
+			std::vector<_Ty> dest(_Size);
+			auto _End = copy_if(par, std::begin(src), std::end(src), std::begin(dest), _Pred);
+			Assert::AreEqual(expected.size(), static_cast<size_t>(std::distance(std::begin(dest), _End)));
+			Assert::IsTrue(std::equal(std::begin(expected), std::end(expected), std::begin(dest)));
+		}
+
+		TEST_METHOD(CopyIfCompressed)
+		{
+			CheckCopyIfCompressed<int>(100003);
+			CheckCopyIfCompressed<double>(100003);
+			CheckCopyIfCompressed<unsigned char>(64 * 1024);
+			CheckCopyIfCompressed<short>(63);
+		}
 	};
 } // namespace ParallelSTL_Tests
 
@@ -96,5 +96,39 @@ namespace ParallelSTL_Tests
 			RunCountIf<forward_iterator_tag>();
 			RunCountIf<input_iterator_tag>();
 		}
+
+		template<typename _Ty, typename _Val>
+		void RunCountVectorized(size_t _Size, _Val _Value)
+		{
+			std::vector<_Ty> _Ct(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+				_Ct[_I] = static_cast<_Ty>(_I % 3);
+
+			const auto _Expected = std::count(std::begin(_Ct), std::end(_Ct), _Value);
+			Assert::IsTrue(count(par, std::begin(_Ct), std::end(_Ct), _Value) == _Expected);
+			Assert::IsTrue(count(par_vec, std::begin(_Ct) + 1, std::end(_Ct), _Value) == std::count(std::begin(_Ct) + 1, std::end(_Ct), _Value));
+		}
+
+		// Contiguous ranges of bytes, integers and floating point types are counted a vector at a time
+		TEST_METHOD(CountVectorized)
+		{
+			const size_t sizes[] = { 1, 17, 4081, 100003, 2000001 };
+
+			for (auto _Size : sizes) {
+				RunCountVectorized<char>(_Size, char{ 1 });
+				RunCountVectorized<unsigned char>(_Size, 2);
+				RunCountVectorized<short>(_Size, short{ 0 });
+				RunCountVectorized<int>(_Size, 2);
+				RunCountVectorized<long long>(_Size, 1ll);
+				RunCountVectorized<float>(_Size, 1.0f);
+				RunCountVectorized<double>(_Size, 0.0);
+
+				// a value out of the range of the elements matches none of them
+				RunCountVectorized<unsigned char>(_Size, 258);
+			}
+
+			std::vector<double> _Nan(1000, std::numeric_limits<double>::quiet_NaN());
+			Assert::IsTrue(count(par, std::begin(_Nan), std::end(_Nan), std::numeric_limits<double>::quiet_NaN()) == 0);
+		}
 	};
 } // ParallelSTL_Tests
@@ -0,0 +1,84 @@
+#include "stdafx.h"
+#include <list>
+#include <string>
+#include <unordered_set>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(DistinctTest)
+	{
+		template<typename _Ty>
+		std::vector<_Ty> FirstOccurrences(const std::vector<_Ty>& _Vec)
+		{
+			std::vector<_Ty> _Expected;
+			std::unordered_set<_Ty> _Seen;
+			for (auto& _Val : _Vec)
+			{
+				if (_Seen.insert(_Val).second)
+					_Expected.push_back(_Val);
+			}
+			return _Expected;
+		}
+
+		template<typename _ExPolicy, typename _InIt, typename _Ty>
+		void CheckDistinct(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, const std::vector<_Ty>& _Expected)
+		{
+			std::vector<_Ty> _Out(std::distance(_First, _Last));
+			auto _It = distinct(_Policy, _First, _Last, std::begin(_Out));
+			Assert::IsTrue(std::equal(std::begin(_Out), _It, std::begin(_Expected), std::end(_Expected)));
+
+			std::vector<_Ty> _Appended;
+			distinct(_Policy, _First, _Last, std::back_inserter(_Appended));
+			Assert::IsTrue(_Appended == _Expected);
+		}
+
+		TEST_METHOD(Distinct)
+		{
+			// the first occurrences are kept in their order
+			for (size_t _Size : { 0, 1, 17, 1000, 100003, 1000000 })
+			{
+				for (size_t _Values : { 1, 10, 5000, 1 << 20 })
+				{
+					std::vector<int> _Vec(_Size);
+					for (size_t _I = 0; _I < _Size; ++_I)
+						_Vec[_I] = static_cast<int>((_I * 2654435761u) % _Values);
+					std::list<int> _List(std::begin(_Vec), std::end(_Vec));
+
+					const std::vector<int> _Expected = FirstOccurrences(_Vec);
+					CheckDistinct(seq, std::begin(_Vec), std::end(_Vec), _Expected);
+					CheckDistinct(par, std::begin(_Vec), std::end(_Vec), _Expected);
+					CheckDistinct(par_vec, std::begin(_Vec), std::end(_Vec), _Expected);
+					CheckDistinct(par.with(grain(256), max_threads(3)), std::begin(_Vec), std::end(_Vec), _Expected);
+					CheckDistinct(par, std::begin(_List), std::end(_List), _Expected);
+				}
+			}
+		}
+
+		TEST_METHOD(DistinctCustomEquality)
+		{
+			// the strings are the same when they differ only in case
+			std::vector<std::string> _Words(100000);
+			for (size_t _I = 0; _I < _Words.size(); ++_I)
+			{
+				_Words[_I] = std::to_string(_I % 4099);
+				if (_I % 3 == 0)
+					_Words[_I] += 'A';
+				else
+					_Words[_I] += 'a';
+			}
+
+			auto _Lower = [](std::string _Str) {
+				std::transform(std::begin(_Str), std::end(_Str), std::begin(_Str), [](char _Ch) { return static_cast<char>(::tolower(_Ch)); });
+				return _Str;
+			};
+
+			std::vector<std::string> _Out(_Words.size());
+			auto _It = distinct(par, std::begin(_Words), std::end(_Words), std::begin(_Out),
+				[&_Lower](const std::string& _Str) { return std::hash<std::string>()(_Lower(_Str)); },
+				[&_Lower](const std::string& _Left, const std::string& _Right) { return _Lower(_Left) == _Lower(_Right); });
+
+			Assert::AreEqual(size_t{ 4099 }, static_cast<size_t>(_It - std::begin(_Out)));
+			Assert::IsTrue(std::equal(std::begin(_Out), _It, std::begin(_Words)));
+		}
+	};
+} // ParallelSTL_Tests
@@ -203,5 +203,23 @@ namespace ParallelSTL_Tests
 			RunEqualElementPredicate4Params<forward_iterator_tag>(false);
 			RunEqualElementPredicate4Params<input_iterator_tag>(false);
 		}
+
+		// Contiguous ranges of integers are compared with memcmp, block by block
+		TEST_METHOD(EqualElementBytewise)
+		{
+			const size_t COLLECTION_SIZE = 100003;
+
+			std::vector<int> vec(COLLECTION_SIZE);
+			std::iota(std::begin(vec), std::end(vec), 0);
+			std::vector<int> other(vec);
+
+			Assert::IsTrue(equal(par, std::begin(vec), std::end(vec), std::begin(other)));
+			Assert::IsTrue(equal(par_vec, std::begin(vec), std::end(vec), std::begin(other), std::end(other)));
+
+			other[COLLECTION_SIZE - 1] = -1;
+			Assert::IsFalse(equal(par, std::begin(vec), std::end(vec), std::begin(other)));
+			Assert::IsFalse(equal(par, vec.data(), vec.data() + vec.size(), other.data(), other.data() + other.size()));
+			Assert::IsTrue(equal(par, std::begin(vec), std::end(vec) - 1, std::begin(other)));
+		}
 	};
 } // ParallelSTL_Tests
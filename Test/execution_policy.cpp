@@ -1,6 +1,36 @@
 #include "stdafx.h"
 #include <experimental\execution_policy>
 
+namespace std {
+	namespace experimental {
+		namespace parallel {
+			// A custom policy running the algorithms under a tuned parallel policy of its own
+			struct TunedPolicy
+			{
+				parallel_execution_policy tuned;
+
+				TunedPolicy() : tuned(par.with(grain(64), max_threads(2)))
+				{
+				}
+			};
+
+			template<> struct is_execution_policy<TunedPolicy> : true_type{};
+
+			template<> struct execution_policy_dispatch<TunedPolicy>
+			{
+				static const parallel_execution_policy& dispatch(const TunedPolicy& _Policy) _NOEXCEPT
+				{
+					return _Policy.tuned;
+				}
+			};
+
+			// Marked as a policy without a standard policy to run under
+			struct UnknownPolicy {};
+			template<> struct is_execution_policy<UnknownPolicy> : true_type{};
+		}
+	}
+}
+
 namespace ParallelSTL_Tests
 {
 	TEST_CLASS(execution_policy_tests)
@@ -61,5 +91,70 @@ namespace ParallelSTL_Tests
 			Assert::IsNotNull(ex_par.get<sequential_execution_policy>());
 			Assert::IsNull(ex_par.get<parallel_execution_policy>());
 		}
+
+		TEST_METHOD(Dynamic_ExPolicy_Kind)
+		{
+			Assert::IsTrue(execution_policy(seq).kind() == execution_policy_kind::sequential);
+			Assert::IsTrue(execution_policy(par).kind() == execution_policy_kind::parallel);
+			Assert::IsTrue(execution_policy(par_vec).kind() == execution_policy_kind::parallel_vector);
+			Assert::IsTrue(execution_policy(par_dynamic).kind() == execution_policy_kind::parallel_dynamic);
+
+			affinity_partitioner partitioner;
+			Assert::IsTrue(execution_policy(par_affinity(partitioner)).kind() == execution_policy_kind::parallel_affinity);
+
+			execution_policy ex(seq);
+			ex = par_vec;
+			Assert::IsTrue(ex.kind() == execution_policy_kind::parallel_vector);
+
+			// the custom policy keeps its type and runs under the policy it dispatches to
+			execution_policy custom{ TunedPolicy() };
+			Assert::IsTrue(custom.type() == typeid(TunedPolicy));
+			Assert::IsTrue(custom.kind() == execution_policy_kind::parallel);
+			Assert::AreEqual(size_t{ 64 }, custom._Dispatch_policy<parallel_execution_policy>().parameters().grain_size());
+			Assert::AreEqual(2u, custom._Dispatch_policy<parallel_execution_policy>().parameters().thread_limit());
+
+			std::vector<int> data(10000, 1);
+			for_each(custom, data.begin(), data.end(), [](int& _Val) { _Val *= 2; });
+			Assert::AreEqual(20000, std::accumulate(data.begin(), data.end(), 0));
+
+			execution_policy unknown{ UnknownPolicy() };
+			Assert::IsTrue(unknown.kind() == execution_policy_kind::unsupported);
+			bool _Exception = false;
+			try {
+				for_each(unknown, data.begin(), data.end(), [](int&) {});
+			}
+			catch (std::invalid_argument&) {
+				_Exception = true;
+			}
+			Assert::IsTrue(_Exception);
+		}
+
+		TEST_METHOD(ExPolicy_Parameters)
+		{
+			Assert::AreEqual(size_t{ 0 }, par.parameters().grain_size());
+			Assert::AreEqual(0u, par.parameters().thread_limit());
+			Assert::IsTrue(par.parameters().partitioner_choice() == partitioner_kind::default_);
+			Assert::IsFalse(par.parameters().no_throw_promised());
+
+			auto tuned = par.with(grain(4096), max_threads(8), partitioner(static_));
+			Assert::AreEqual(size_t{ 4096 }, tuned.parameters().grain_size());
+			Assert::AreEqual(8u, tuned.parameters().thread_limit());
+			Assert::IsTrue(tuned.parameters().partitioner_choice() == partitioner_kind::static_);
+
+			// with() adds to the parameters already attached and keeps the policy type
+			auto retuned = tuned.with(partitioner(dynamic_));
+			Assert::AreEqual(size_t{ 4096 }, retuned.parameters().grain_size());
+			Assert::IsTrue(retuned.parameters().partitioner_choice() == partitioner_kind::dynamic_);
+
+			Assert::IsTrue(retuned.with(no_throw()).parameters().no_throw_promised());
+			Assert::IsFalse(retuned.with(no_throw(false)).parameters().no_throw_promised());
+
+			parallel_dynamic_execution_policy dynamic = par_dynamic.with(grain(16));
+			Assert::AreEqual(size_t{ 16 }, dynamic.parameters().grain_size());
+
+			// the parameters survive the dynamic policy
+			execution_policy ex(tuned);
+			Assert::AreEqual(size_t{ 4096 }, ex.get<parallel_execution_policy>()->parameters().grain_size());
+		}
 	}; // TEST_CLASS(execution_policy)
 } // namespace ParallelSTL_Tests
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "stdafx.h"
+
+#include <fstream>
+#include <random>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(ExternalSortTest)
+	{
+		struct Record
+		{
+			unsigned int key;
+			unsigned int payload;
+		};
+
+		static const wchar_t *InputName()
+		{
+			return L"external_sort_input.bin";
+		}
+
+		static const wchar_t *OutputName()
+		{
+			return L"external_sort_output.bin";
+		}
+
+		template<typename _Ty>
+		static void WriteFile(const std::vector<_Ty>& _Values)
+		{
+			std::ofstream _File(InputName(), std::ios::binary | std::ios::trunc);
+			_File.write(reinterpret_cast<const char *>(_Values.data()), _Values.size() * sizeof(_Ty));
+		}
+
+		// Runs of 1000 ints, merged in blocks smaller than a run
+		static external_sort_options SmallRuns()
+		{
+			external_sort_options _Options;
+			_Options.memory_bytes = 2 * 1000 * sizeof(int);
+			_Options.block_bytes = 300 * sizeof(int);
+			_Options.temp_directory = L".";
+			return _Options;
+		}
+
+		TEST_METHOD(ExternalSortRuns)
+		{
+			std::vector<int> _Values(25 * 1000 + 17);
+			std::mt19937 _Gen(7);
+			std::uniform_int_distribution<int> _Dist(-5000, 5000);
+			std::generate(_Values.begin(), _Values.end(), [&] { return _Dist(_Gen); });
+			WriteFile(_Values);
+
+			external_sort<int>(par, InputName(), OutputName(), std::less<>(), SmallRuns());
+
+			std::sort(_Values.begin(), _Values.end());
+			{
+				mapped_array_view<const int> _Sorted(OutputName());
+				Assert::AreEqual(ptrdiff_t(_Values.size()), _Sorted.size());
+				Assert::IsTrue(std::equal(_Values.begin(), _Values.end(), _Sorted.data()));
+			}
+
+			// the same in descending order, sequentially
+			external_sort<int>(seq, InputName(), OutputName(), std::greater<>(), SmallRuns());
+			{
+				mapped_array_view<const int> _Sorted(OutputName());
+				Assert::IsTrue(std::equal(_Values.rbegin(), _Values.rend(), _Sorted.data()));
+			}
+		}
+
+		TEST_METHOD(ExternalSortRecords)
+		{
+			std::vector<Record> _Values(10 * 1000);
+			for (size_t _I = 0; _I < _Values.size(); ++_I)
+			{
+				_Values[_I].key = static_cast<unsigned int>((_I * 7919) % 1000);
+				_Values[_I].payload = static_cast<unsigned int>(_I);
+			}
+			WriteFile(_Values);
+
+			external_sort_options _Options = SmallRuns();
+			_Options.memory_bytes = 2 * 999 * sizeof(Record);
+			{
+				mapped_array_view<const Record> _Input(InputName());
+				external_sort(execution_policy(par), _Input, OutputName(), [](const Record& _Left, const Record& _Right) {
+					return _Left.key < _Right.key;
+				}, _Options);
+			}
+
+			mapped_array_view<const Record> _Sorted(OutputName());
+			Assert::AreEqual(ptrdiff_t(_Values.size()), _Sorted.size());
+
+			// every record is kept, in the order of its key
+			std::vector<bool> _Seen(_Values.size());
+			for (ptrdiff_t _I = 0; _I < _Sorted.size(); ++_I)
+			{
+				if (_I > 0)
+					Assert::IsTrue(_Sorted[_I - 1].key <= _Sorted[_I].key);
+				Assert::AreEqual(_Values[_Sorted[_I].payload].key, _Sorted[_I].key);
+				Assert::IsFalse(_Seen[_Sorted[_I].payload]);
+				_Seen[_Sorted[_I].payload] = true;
+			}
+		}
+
+		TEST_METHOD(ExternalSortInMemory)
+		{
+			// fits in one run, and an empty file
+			std::vector<int> _Values(1000);
+			std::iota(_Values.rbegin(), _Values.rend(), 0);
+			WriteFile(_Values);
+
+			external_sort_options _Options;
+			_Options.temp_directory = L".";
+			external_sort<int>(par, InputName(), OutputName(), std::less<>(), _Options);
+			{
+				mapped_array_view<const int> _Sorted(OutputName());
+				Assert::AreEqual(ptrdiff_t(1000), _Sorted.size());
+				Assert::IsTrue(std::is_sorted(_Sorted.data(), _Sorted.data() + _Sorted.size()));
+			}
+
+			WriteFile(std::vector<int>());
+			external_sort<int>(par, InputName(), OutputName());
+			Assert::AreEqual(ptrdiff_t(0), mapped_array_view<const int>(OutputName()).size());
+		}
+	};
+} // namespace ParallelSTL_Tests
@@ -166,5 +166,87 @@ namespace ParallelSTL_Tests
 			RunUninitializedFillN<random_access_iterator_tag>();
 			RunUninitializedFillN<forward_iterator_tag>();		
 		}
+
+		TEST_METHOD(UninitializedValueConstruct)
+		{
+			const size_t _Size = 1024 + (rand() % 1024);
+
+			{  // seq
+				std::vector<size_t> _Ct(_Size, FILL_VALUE);
+				Assert::IsTrue(uninitialized_value_construct_n(seq, _Ct.begin(), _Ct.size()) == _Ct.end());
+				Assert::IsTrue(std::all_of(_Ct.begin(), _Ct.end(), [](size_t _Val) { return _Val == 0; }));
+			}
+
+			{  //par
+				std::vector<size_t> _Ct(_Size, FILL_VALUE);
+				uninitialized_value_construct(par, _Ct.begin(), _Ct.end());
+				Assert::IsTrue(std::all_of(_Ct.begin(), _Ct.end(), [](size_t _Val) { return _Val == 0; }));
+			}
+
+			{  //par_vec
+				std::list<size_t> _Ct(_Size, FILL_VALUE);
+				Assert::IsTrue(uninitialized_value_construct_n(par_vec, _Ct.begin(), _Ct.size()) == _Ct.end());
+				Assert::IsTrue(std::all_of(_Ct.begin(), _Ct.end(), [](size_t _Val) { return _Val == 0; }));
+			}
+		}
+
+		// Under an affinity policy the pages of a trivial type are written even by default construction
+		TEST_METHOD(UninitializedDefaultConstructFirstTouch)
+		{
+			const size_t _Size = 1024 + (rand() % 1024);
+			std::vector<size_t> _Ct(_Size, FILL_VALUE);
+
+			Assert::IsTrue(uninitialized_default_construct_n(par, _Ct.begin(), _Ct.size()) == _Ct.end());
+
+			affinity_partitioner _Affinity;
+			uninitialized_default_construct(par_affinity(_Affinity), _Ct.begin(), _Ct.end());
+			Assert::IsTrue(std::all_of(_Ct.begin(), _Ct.end(), [](size_t _Val) { return _Val == 0; }));
+
+			// the loop over the constructed range runs its chunks on the workers that touched them
+			for_each(par_affinity(_Affinity), _Ct.begin(), _Ct.end(), [](size_t& _Val) { ++_Val; });
+			Assert::IsTrue(std::all_of(_Ct.begin(), _Ct.end(), [](size_t _Val) { return _Val == 1; }));
+		}
+
+		TEST_METHOD(DefaultConstructAndDestroy)
+		{
+			typedef std::aligned_storage<sizeof(UnintializeHelper), alignof(UnintializeHelper)>::type _Storage;
+
+			const int MAX_DATA_SIZE = 32 + (rand() % 1024);
+			std::vector<_Storage> _Buffer(MAX_DATA_SIZE);
+			UnintializeHelper * const _Ptr = reinterpret_cast<UnintializeHelper *>(_Buffer.data());
+
+			UnintializeHelper::reset();
+
+			uninitialized_default_construct(par, _Ptr, _Ptr + MAX_DATA_SIZE);
+			Assert::AreEqual(MAX_DATA_SIZE, UnintializeHelper::get_count());
+			Assert::IsTrue(destroy_n(par, _Ptr, MAX_DATA_SIZE) == _Ptr + MAX_DATA_SIZE);
+			Assert::AreEqual(0, UnintializeHelper::get_count());
+
+			affinity_partitioner _Affinity;
+			Assert::IsTrue(uninitialized_value_construct_n(par_affinity(_Affinity), _Ptr, MAX_DATA_SIZE) == _Ptr + MAX_DATA_SIZE);
+			Assert::AreEqual(MAX_DATA_SIZE, UnintializeHelper::get_count());
+			destroy(par_affinity(_Affinity), _Ptr, _Ptr + MAX_DATA_SIZE);
+			Assert::AreEqual(0, UnintializeHelper::get_count());
+
+			UnintializeHelper::set_no_exception();
+		}
+
+		// Trivially copyable contiguous ranges are filled in chunks on page boundaries, bytes by memset
+		// and the big ranges with streaming stores
+		TEST_METHOD(FillBulk)
+		{
+			const size_t sizes[] = { 1, 1000, 100003, 9000001 };
+
+			for (auto _Size : sizes) {
+				std::vector<double> vec(_Size + 2, 1.0);
+				fill(par, std::begin(vec) + 1, std::end(vec) - 1, 2.5);
+				Assert::IsTrue(vec.front() == 1.0 && vec.back() == 1.0);
+				Assert::IsTrue(std::all_of(std::begin(vec) + 1, std::end(vec) - 1, [](double _Val) { return _Val == 2.5; }));
+
+				std::vector<unsigned char> bytes(_Size + 1, 0);
+				Assert::IsTrue(fill_n(par_vec, std::begin(bytes) + 1, _Size, 200) == std::end(bytes));
+				Assert::IsTrue(bytes.front() == 0 && std::count(std::begin(bytes), std::end(bytes), 200) == static_cast<std::ptrdiff_t>(_Size));
+			}
+		}
 	};
 } // ParallelSTL_Tests
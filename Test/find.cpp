@@ -1,6 +1,8 @@
 #include "stdafx.h"
 
 #include <execution_policy_utils.h>
+#include <list>
+#include <string>
 
 namespace ParallelSTL_Tests
 {
@@ -443,5 +445,106 @@ namespace ParallelSTL_Tests
 			// Find the last element in the chunk
 			Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), _It)) == (_Pos + (MATCH_ELEMENTS * 2)));
 		}
+		template<typename _Ty, typename _Val>
+		void RunFindValue(_Val _Value, _Ty _Other)
+		{
+			const size_t COLLECTION_SIZE = 5003;
+			const size_t positions[] = { 0, 1, 7, 8, 15, 16, 31, 63, 64, 65, 1023, 1024, 4096, COLLECTION_SIZE - 1 };
+
+			for (auto _Pos : positions) {
+				std::vector<_Ty> vec(COLLECTION_SIZE, _Other);
+				vec[_Pos] = static_cast<_Ty>(_Value);
+				vec[COLLECTION_SIZE - 1] = static_cast<_Ty>(_Value); // Later match must not win
+
+				Assert::IsTrue(find(par, std::begin(vec), std::end(vec), _Value) == std::find(std::begin(vec), std::end(vec), _Value));
+				Assert::IsTrue(find(par_vec, vec.data(), vec.data() + vec.size(), _Value) == vec.data() + _Pos);
+			}
+
+			std::vector<_Ty> none(COLLECTION_SIZE, _Other);
+			Assert::IsTrue(find(par, std::begin(none), std::end(none), _Value) == std::end(none));
+		}
+
+		// find searches the contiguous ranges of arithmetic types with memchr and vector compares
+		TEST_METHOD(FindVectorizedValue)
+		{
+			RunFindValue<char>('x', ' ');
+			RunFindValue<unsigned char>(200, 0);
+			RunFindValue<short>(-5, 5);
+			RunFindValue<int>(42, 0);
+			RunFindValue<unsigned int>(7u, ~0u);
+			RunFindValue<long long>(1LL << 40, 0);
+			RunFindValue<float>(2.5f, 0.f);
+			RunFindValue<double>(-1.0, 1.0);
+
+			// The value compares as the element type promoted, as std::find does
+			std::vector<unsigned char> bytes(1000, 255);
+			Assert::IsTrue(find(par, std::begin(bytes), std::end(bytes), -1) == std::end(bytes));
+			std::vector<unsigned int> words(1000, ~0u);
+			Assert::IsTrue(find(par, std::begin(words), std::end(words), -1) == std::begin(words));
+			std::vector<int> ints(1000, 'a');
+			Assert::IsTrue(find(par, std::begin(ints), std::end(ints), 'a') == std::begin(ints));
+		}
+
+		// The loops poll the cancellation token once per block, matches on either side of
+		// a block border and in a partial last block must be found, the first one winning
+		TEST_METHOD(FindIfAroundPollBlocks)
+		{
+			const size_t COLLECTION_SIZE = 10007;
+			const size_t positions[] = { 0, 1, 3, 4, 255, 256, 257, 1023, 1024, 5000, COLLECTION_SIZE - 2, COLLECTION_SIZE - 1 };
+
+			for (auto _Pos : positions) {
+				std::vector<int> vec(COLLECTION_SIZE, 0);
+				vec[_Pos] = 1;
+				if (_Pos + 1 < COLLECTION_SIZE)
+					vec[COLLECTION_SIZE - 1] = 1; // Later match must not win
+
+				auto _Pred = [](int _Val) { return _Val == 1; };
+
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), find_if(par, std::begin(vec), std::end(vec), _Pred))) == _Pos);
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), find(par_vec, std::begin(vec), std::end(vec), 1))) == _Pos);
+				Assert::IsTrue(any_of(par, std::begin(vec), std::end(vec), _Pred));
+
+				std::list<int> lst(std::begin(vec), std::end(vec));
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(lst), find_if(par, std::begin(lst), std::end(lst), _Pred))) == _Pos);
+			}
+
+			std::vector<int> none(COLLECTION_SIZE, 0);
+			Assert::IsTrue(find(par, std::begin(none), std::end(none), 1) == std::end(none));
+			Assert::IsFalse(any_of(par, std::begin(none), std::end(none), [](int _Val) { return _Val == 1; }));
+		}
+
+		// find_first_of looks the bytes of a contiguous range up in the set of needles, a block at a time
+		TEST_METHOD(FindFirstOfByteSet)
+		{
+			const size_t COLLECTION_SIZE = 100003;
+			const char delimiters[] = { ',', ';', '\t', '|', '\n', '"', ' ', '=', ':', '/', '&', '?', '#', '[', ']', '{' };
+			const size_t positions[] = { 0, 15, 16, 17, 1023, 1024, 50000, COLLECTION_SIZE - 1 };
+
+			for (size_t _Needles = 1; _Needles <= 16; _Needles += 5) {
+				for (auto _Pos : positions) {
+					std::string text(COLLECTION_SIZE, 'a');
+					text[_Pos] = delimiters[_Needles - 1];
+					text[COLLECTION_SIZE - 1] = delimiters[0]; // Later match must not win
+
+					auto _Hit = find_first_of(par, std::begin(text), std::end(text), delimiters, delimiters + _Needles);
+					Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(text), _Hit)) == _Pos);
+					Assert::IsTrue(find_first_of(par_vec, std::begin(text), std::end(text), delimiters, delimiters + _Needles) == _Hit);
+				}
+			}
+
+			// More needles than the vector compares take, the set is looked up byte after byte
+			std::vector<unsigned char> bytes(COLLECTION_SIZE, 0);
+			bytes[70000] = 200;
+			std::vector<int> needles(100);
+			std::iota(std::begin(needles), std::end(needles), 150);
+			Assert::IsTrue(find_first_of(par, std::begin(bytes), std::end(bytes), std::begin(needles), std::end(needles)) == std::begin(bytes) + 70000);
+
+			// Needles compare as the element type promoted, as std::find_first_of does
+			std::vector<signed char> signed_bytes(1000, -1);
+			const int out_of_range[] = { 255, 300 };
+			Assert::IsTrue(find_first_of(par, std::begin(signed_bytes), std::end(signed_bytes), out_of_range, out_of_range + 2) == std::end(signed_bytes));
+			const int minus_one[] = { 300, -1 };
+			Assert::IsTrue(find_first_of(par, std::begin(signed_bytes), std::end(signed_bytes), minus_one, minus_one + 2) == std::begin(signed_bytes));
+		}
 	};
 } // ParallelSTL_Tests
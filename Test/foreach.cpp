@@ -1,4 +1,48 @@
 #include "stdafx.h"
+#include <deque>
+#include <list>
+#include <forward_list>
+#include <random>
+
+namespace ParallelSTL_Tests
+{
+	// The iterator of a container storing its elements in chunks that end on 256 byte boundaries
+	struct ChunkedIterator : std::vector<int>::iterator
+	{
+		static std::atomic<int> Segments;
+
+		ChunkedIterator(std::vector<int>::iterator _It) : std::vector<int>::iterator(_It)
+		{
+		}
+	};
+
+	std::atomic<int> ChunkedIterator::Segments;
+}
+
+namespace std {
+	namespace experimental {
+		namespace parallel {
+			template<> struct segmented_iterator_traits<ParallelSTL_Tests::ChunkedIterator>
+			{
+				static const bool is_segmented = true;
+
+				typedef int *local_iterator;
+
+				static size_t segment_length(const ParallelSTL_Tests::ChunkedIterator& _It, size_t _Count)
+				{
+					++ParallelSTL_Tests::ChunkedIterator::Segments;
+					const size_t _Offset = reinterpret_cast<std::uintptr_t>(&*_It) % 256 / sizeof(int);
+					return (std::min)(_Count, 256 / sizeof(int) - _Offset);
+				}
+
+				static local_iterator local(const ParallelSTL_Tests::ChunkedIterator& _It)
+				{
+					return &*_It;
+				}
+			};
+		}
+	}
+}
 
 namespace ParallelSTL_Tests
 {
@@ -134,11 +178,25 @@ namespace ParallelSTL_Tests
 				_Alg.set_result(for_each_impl<details::static_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
 			}
 
-			// The implementation of dynamic partitioner is broken thus commented out
-			//{ // dynamic_partitioner_tag
-			//	ForEachAlgoTest<random_access_iterator_tag> _Alg;
-			//	_Alg.set_result(for_each_impl<details::dynamic_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
-			//}
+			{ // dynamic_partitioner_tag
+				ForEachAlgoTest<random_access_iterator_tag> _Alg;
+				_Alg.set_result(for_each_impl<details::dynamic_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
+			}
+
+			{ // dynamic_partitioner_tag with forward iterators
+				ForEachAlgoTest<forward_iterator_tag> _Alg;
+				_Alg.set_result(for_each_impl<details::dynamic_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
+			}
+
+			{ // adaptive_partitioner_tag
+				ForEachAlgoTest<random_access_iterator_tag> _Alg;
+				_Alg.set_result(for_each_impl<details::adaptive_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
+			}
+
+			{ // adaptive_partitioner_tag with forward iterators
+				ForEachAlgoTest<forward_iterator_tag> _Alg;
+				_Alg.set_result(for_each_impl<details::adaptive_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
+			}
 
 			{ // auto_partitioner_tag
 				ForEachExAlgoTest<random_access_iterator_tag> _Alg;
@@ -154,13 +212,12 @@ namespace ParallelSTL_Tests
 				});
 			}
 
-			// The implementation of dynamic partitioner is broken thus commented out	
-			//{ // dynamic_partitioner_tag
-			//	ForEachExAlgoTest<random_access_iterator_tag> _Alg;
-			//	_Alg.Catch([&](){
-			//		_Alg.set_result(for_each_impl<details::dynamic_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
-			//	});
-			//}
+			{ // dynamic_partitioner_tag
+				ForEachExAlgoTest<random_access_iterator_tag> _Alg;
+				_Alg.Catch([&](){
+					_Alg.set_result(for_each_impl<details::dynamic_partitioner_tag>(_Alg.begin_in(), _Alg.size_in(), _Alg.callback()));
+				});
+			}
 		}
 
 		template<typename _IterCat>
@@ -180,6 +237,414 @@ namespace ParallelSTL_Tests
 				ForEachAlgoTest<_IterCat> _Alg(false);
 				for_each(par_vec, _Alg.begin_in(), _Alg.end_in(), _Alg.callback());
 			}
+
+			{  //par_dynamic
+				ForEachAlgoTest<_IterCat> _Alg(false);
+				for_each(par_dynamic, _Alg.begin_in(), _Alg.end_in(), _Alg.callback());
+			}
+
+			{  //par_affinity
+				affinity_partitioner _Affinity;
+				ForEachAlgoTest<_IterCat> _Alg(false);
+				for_each(par_affinity(_Affinity), _Alg.begin_in(), _Alg.end_in(), _Alg.callback());
+			}
+		}
+
+		TEST_METHOD(ForEachWithParameters)
+		{
+			const partitioner_kind _Kinds[] = { partitioner_kind::default_, static_, auto_, dynamic_ };
+			for (auto _Kind : _Kinds)
+			{
+				std::vector<int> _Ct(10000);
+				for_each(par.with(grain(64), max_threads(3), partitioner(_Kind)), std::begin(_Ct), std::end(_Ct), [](int& _Val) {
+					++_Val;
+				});
+
+				for (auto _Val : _Ct)
+					Assert::AreEqual(1, _Val);
+			}
+
+			{  // a grain larger than the range runs it as one chunk
+				ForEachAlgoTest<random_access_iterator_tag> _Alg(false);
+				for_each(par.with(grain(1000000), partitioner(static_)), _Alg.begin_in(), _Alg.end_in(), _Alg.callback());
+			}
+		}
+
+		// Loops over functions that can't throw run on the chores without exception handling
+		TEST_METHOD(ForEachNoThrow)
+		{
+			const partitioner_kind _Kinds[] = { partitioner_kind::default_, static_, auto_, dynamic_, adaptive_ };
+			for (auto _Kind : _Kinds)
+			{
+				std::vector<int> _Ct(10000);
+				auto _Policy = par.with(grain(64), partitioner(_Kind));
+
+				for_each(_Policy.with(no_throw()), std::begin(_Ct), std::end(_Ct), [](int& _Val) {
+					++_Val;
+				});
+
+#if _MSC_VER >= 1900
+				for_each(_Policy, std::begin(_Ct), std::end(_Ct), [](int& _Val) noexcept {
+					++_Val;
+				});
+
+				transform(_Policy, std::begin(_Ct), std::end(_Ct), std::begin(_Ct), [](int _Val) noexcept {
+					return _Val + 1;
+				});
+#else
+				for_each(_Policy, std::begin(_Ct), std::end(_Ct), [](int& _Val) { _Val += 2; });
+#endif
+
+				for (auto _Val : _Ct)
+					Assert::AreEqual(3, _Val);
+			}
+
+			{  // the dynamic and affinity policies take the parameter too
+				std::list<int> _Ct(1000);
+				for_each(par_dynamic.with(no_throw()), std::begin(_Ct), std::end(_Ct), [](int& _Val) { ++_Val; });
+
+				affinity_partitioner _Affinity;
+				for_each(par_affinity(_Affinity).with(no_throw()), std::begin(_Ct), std::end(_Ct), [](int& _Val) { ++_Val; });
+
+				for (auto _Val : _Ct)
+					Assert::AreEqual(2, _Val);
+			}
+		}
+
+		TEST_METHOD(ForEachVectorContiguous)
+		{
+			{ // raw pointers run the vectorized loop
+				std::vector<int> _Ct(10001);
+				for_each(par_vec, _Ct.data(), _Ct.data() + _Ct.size(), [](int& _Val) {
+					_Val += 2;
+				});
+
+				for (auto _Val : _Ct)
+					Assert::AreEqual(2, _Val);
+			}
+
+			{ // vector<bool> is not contiguous, its references are proxies
+				std::vector<bool> _Ct(10001, false);
+				for_each(par_vec, std::begin(_Ct), std::end(_Ct), [](std::vector<bool>::reference _Val) {
+					_Val = true;
+				});
+
+				Assert::IsTrue(std::all_of(std::begin(_Ct), std::end(_Ct), [](bool _Val) { return _Val; }));
+			}
+		}
+
+		TEST_METHOD(ForEachSegmented)
+		{
+			{ // the blocks of a deque run through raw pointers
+				std::deque<int> _Ct;
+				for (int _I = 0; _I < 10000; ++_I) {
+					_Ct.push_back(1);
+					_Ct.push_front(1);
+				}
+
+				for_each(par_vec, std::begin(_Ct) + 3, std::end(_Ct), [](int& _Val) {
+					++_Val;
+				});
+				fill_n(par, std::begin(_Ct), 2, 5);
+
+				Assert::AreEqual(5, _Ct[1]);
+				Assert::AreEqual(1, _Ct[2]);
+				for (size_t _I = 3; _I < _Ct.size(); ++_I)
+					Assert::AreEqual(2, _Ct[_I]);
+			}
+
+			{ // a chunked container opted in through the trait
+				std::vector<int> _Storage(10000);
+				ChunkedIterator::Segments = 0;
+				for_each(par, ChunkedIterator(std::begin(_Storage) + 1), ChunkedIterator(std::end(_Storage)), [](int& _Val) {
+					_Val += 2;
+				});
+
+				Assert::IsTrue(ChunkedIterator::Segments >= static_cast<int>(_Storage.size() * sizeof(int) / 256));
+				Assert::AreEqual(0, _Storage[0]);
+				Assert::IsTrue(std::all_of(std::begin(_Storage) + 1, std::end(_Storage), [](int _Val) { return _Val == 2; }));
+			}
+		}
+
+		TEST_METHOD(ForEachNodeContainer)
+		{
+			const partitioner_kind _Kinds[] = { static_, auto_ };
+			for (auto _Kind : _Kinds)
+			{
+				for (unsigned int _Threads : { 0u, 1u, 3u })
+				{
+					auto _Policy = par.with(max_threads(_Threads), partitioner(_Kind));
+
+					std::list<int> _List(10000);
+					for_each(_Policy, std::begin(_List), std::end(_List), [](int& _Val) {
+						++_Val;
+					});
+
+					for (auto _Val : _List)
+						Assert::AreEqual(1, _Val);
+
+					// the walk to the end of the range returns the iterator past the last element
+					std::forward_list<int> _Fwd(10000);
+					auto _Pos = std::next(std::begin(_Fwd), 7000);
+					Assert::IsTrue(_Pos == for_each_n(_Policy, std::begin(_Fwd), 7000, [](int& _Val) {
+						++_Val;
+					}));
+
+					Assert::AreEqual(7000, static_cast<int>(std::count(std::begin(_Fwd), std::end(_Fwd), 1)));
+				}
+			}
+		}
+
+		template<typename _ExPolicy>
+		void RunForEachTile(_ExPolicy&& _Policy)
+		{
+			using namespace std::experimental::D4087;
+
+			{ // tiles of the given shape, cut at the far edges
+				bounds<2> _Bnd{ 100, 37 };
+				index<2> _Shape{ 16, 8 };
+				std::vector<int> _Visits(_Bnd.size());
+				for_each_tile(_Policy, _Bnd, _Shape, [&](const index<2>& _Origin, const bounds<2>& _Tile) {
+					Assert::AreEqual(ptrdiff_t(0), _Origin[0] % _Shape[0]);
+					Assert::AreEqual(ptrdiff_t(0), _Origin[1] % _Shape[1]);
+					Assert::IsTrue(_Tile[0] == (std::min)(_Shape[0], _Bnd[0] - _Origin[0]));
+					Assert::IsTrue(_Tile[1] == (std::min)(_Shape[1], _Bnd[1] - _Origin[1]));
+
+					for (auto _Idx : _Tile)
+						++_Visits[(_Origin[0] + _Idx[0]) * _Bnd[1] + _Origin[1] + _Idx[1]];
+				});
+
+				for (auto _Val : _Visits)
+					Assert::AreEqual(1, _Val);
+			}
+
+			{ // every index once with the default tile shape
+				bounds<3> _Bnd{ 3, 70, 90 };
+				std::vector<int> _Visits(_Bnd.size());
+				for_each(_Policy, _Bnd, [&](const index<3>& _Idx) {
+					Assert::IsTrue(_Bnd.contains(_Idx));
+					++_Visits[(_Idx[0] * _Bnd[1] + _Idx[1]) * _Bnd[2] + _Idx[2]];
+				});
+
+				for (auto _Val : _Visits)
+					Assert::AreEqual(1, _Val);
+			}
+
+			{ // empty bounds
+				bounds<2> _Bnd{ 0, 10 };
+				for_each(_Policy, _Bnd, [](const index<2>&) {
+					Assert::Fail();
+				});
+			}
+		}
+
+		TEST_METHOD(ForEachTile)
+		{
+			RunForEachTile(seq);
+			RunForEachTile(par);
+			RunForEachTile(par_vec);
+			RunForEachTile(par.with(partitioner(dynamic_)));
+			RunForEachTile(execution_policy(par));
+		}
+
+		template<typename _ExPolicy>
+		void RunForEachBounds(_ExPolicy&& _Policy)
+		{
+			using namespace std::experimental::D4087;
+
+			{ // every index once, in rows that don't end on a chunk boundary
+				bounds<2> _Bnd{ 131, 77 };
+				std::vector<int> _Visits(_Bnd.size());
+				for_each(_Policy, std::begin(_Bnd), std::end(_Bnd), [&](const index<2>& _Idx) {
+					Assert::IsTrue(_Bnd.contains(_Idx));
+					++_Visits[_Idx[0] * _Bnd[1] + _Idx[1]];
+				});
+
+				for (auto _Val : _Visits)
+					Assert::AreEqual(1, _Val);
+			}
+
+			{ // from the middle of a row to the middle of another one
+				bounds<3> _Bnd{ 7, 13, 29 };
+				std::vector<int> _Visits(_Bnd.size());
+				auto _First = std::begin(_Bnd) + 100;
+				Assert::IsTrue(_First + 2000 == for_each_n(_Policy, _First, 2000, [&](const index<3>& _Idx) {
+					Assert::IsTrue(_Bnd.contains(_Idx));
+					++_Visits[(_Idx[0] * _Bnd[1] + _Idx[1]) * _Bnd[2] + _Idx[2]];
+				}));
+
+				for (size_t _I = 0; _I < _Visits.size(); ++_I)
+					Assert::AreEqual(_I >= 100 && _I < 2100 ? 1 : 0, _Visits[_I]);
+			}
+
+			{ // rows of one element
+				bounds<3> _Bnd{ 40, 50, 1 };
+				std::vector<int> _Visits(_Bnd.size());
+				for_each(_Policy, std::begin(_Bnd), std::end(_Bnd), [&](const index<3>& _Idx) {
+					++_Visits[_Idx[0] * _Bnd[1] + _Idx[1]];
+				});
+
+				for (auto _Val : _Visits)
+					Assert::AreEqual(1, _Val);
+			}
+		}
+
+		TEST_METHOD(ForEachBounds)
+		{
+			RunForEachBounds(seq);
+			RunForEachBounds(par);
+			RunForEachBounds(par_vec);
+			RunForEachBounds(par.with(grain(33)));
+			RunForEachBounds(par.with(partitioner(dynamic_)));
+			RunForEachBounds(execution_policy(par));
+		}
+
+		TEST_METHOD(ForEachAdaptiveCutoff)
+		{
+			auto _Adaptive = par.with(partitioner(adaptive_));
+
+			// Sampled on the first calls, then decided from the learned cost
+			for (size_t _Size : { 10, 200, 5000, 100000, 200, 100000 })
+			{
+				std::vector<int> _Ct(_Size);
+				for_each(_Adaptive, std::begin(_Ct), std::end(_Ct), [](int& _Val) {
+					++_Val;
+				});
+
+				for (auto _Val : _Ct)
+					Assert::AreEqual(1, _Val);
+			}
+
+			const size_t _Capacity = 64;
+			details::cutoff_site_info _Sites[_Capacity];
+			size_t _Num = details::get_cutoff_sites(_Sites, _Capacity);
+			Assert::IsTrue(_Num >= 1);
+
+			bool _Sampled = false;
+			for (size_t _I = 0; _I < (std::min)(_Num, _Capacity); ++_I)
+			{
+				Assert::IsNotNull(_Sites[_I].name);
+				Assert::IsTrue(_Sites[_I].grain >= 1);
+				_Sampled |= _Sites[_I].samples == details::_Cutoff_sample_runs;
+			}
+			Assert::IsTrue(_Sampled);
+		}
+
+		TEST_METHOD(ForEachAdaptiveEmpty)
+		{
+			auto _Adaptive = par.with(partitioner(adaptive_));
+			std::atomic<int> _Calls(0);
+			auto _Body = [&_Calls](int& _Val) {
+				++_Val;
+				++_Calls;
+			};
+
+			// The first calls of the site sample nothing, they neither divide by the count nor keep a sample
+			std::vector<int> _Empty;
+			for_each(_Adaptive, std::begin(_Empty), std::end(_Empty), _Body);
+			for_each_n(_Adaptive, std::begin(_Empty), 0, _Body);
+			Assert::AreEqual(0, _Calls.load());
+
+			// the partitioner called with nothing left to do, as an algorithm that handles a prefix itself calls it
+			std::atomic<int> _Chunks(0);
+			details::_Partitioner<details::adaptive_partitioner_tag>::_For_Each(std::begin(_Empty), 0, 0, [&_Chunks](std::vector<int>::iterator, size_t, int) {
+				++_Chunks;
+			});
+			Assert::AreEqual(0, _Chunks.load());
+
+			std::vector<int> _One(1);
+			for_each(_Adaptive, std::begin(_One), std::end(_One), _Body);
+			std::list<int> _One_list(1);
+			for_each(_Adaptive, std::begin(_One_list), std::end(_One_list), _Body);
+			Assert::AreEqual(1, _One.front());
+			Assert::AreEqual(1, _One_list.front());
+			Assert::AreEqual(2, _Calls.load());
+		}
+
+		TEST_METHOD(ForEachAffinityReplay)
+		{
+			affinity_partitioner _Affinity;
+			std::vector<size_t> _Ct(10000);
+
+			// The first run records the sub-ranges, the next ones replay them
+			for (size_t _Run = 0; _Run < 5; ++_Run)
+			{
+				for_each(par_affinity(_Affinity), std::begin(_Ct), std::end(_Ct), [](size_t& _Val) {
+					++_Val;
+				});
+			}
+
+			for (auto _Val : _Ct)
+				Assert::AreEqual(size_t{ 5 }, _Val);
+
+			// A range of another size is split again
+			std::vector<size_t> _Ct2(37);
+			for_each(par_affinity(_Affinity), std::begin(_Ct2), std::end(_Ct2), [](size_t& _Val) {
+				++_Val;
+			});
+
+			for (auto _Val : _Ct2)
+				Assert::AreEqual(size_t{ 1 }, _Val);
+
+			// Every sub-range that throws is reported
+			try {
+				for_each(par_affinity(_Affinity), std::begin(_Ct2), std::end(_Ct2), [](size_t&) {
+					throw std::exception();
+				});
+				Assert::Fail();
+			}
+			catch (const exception_list& _Ex) {
+				Assert::IsTrue(_Ex.size() >= 1 && _Ex.size() <= _Ct2.size());
+			}
+		}
+
+		TEST_METHOD(ForEachDynamicSkewed)
+		{
+			// Few expensive elements at the front, a fixed partition would leave them to one chore
+			std::vector<size_t> _Ct(10000);
+			std::iota(std::begin(_Ct), std::end(_Ct), 0);
+
+			for_each(par_dynamic, std::begin(_Ct), std::end(_Ct), [](size_t& _Val) {
+				size_t _Work = _Val < 100 ? 10000 : 1;
+				volatile size_t _Sink = 0;
+				for (size_t _I = 0; _I < _Work; ++_I)
+					_Sink = _Sink + _I;
+				_Val = _Val + 1;
+			});
+
+			for (size_t _I = 0; _I < _Ct.size(); ++_I)
+				Assert::AreEqual(_I + 1, _Ct[_I]);
+		}
+
+		TEST_METHOD(ForEachPrefetchHint)
+		{
+			// A lookup through a shuffled index, the hint points at the entry of the index ahead
+			std::vector<size_t> _Index(100000);
+			std::iota(std::begin(_Index), std::end(_Index), size_t{ 0 });
+			std::shuffle(std::begin(_Index), std::end(_Index), std::mt19937(7));
+			std::vector<size_t> _Table(_Index.size());
+			const auto _Ahead = [&_Table](size_t _Idx) { return &_Table[_Idx]; };
+
+			for (size_t _Distance : { 0, 0, 1, 8, 1000000 })
+			{
+				std::fill(std::begin(_Table), std::end(_Table), size_t{ 0 });
+				for_each(par, std::begin(_Index), std::end(_Index), [&_Table](size_t _Idx) {
+					_Table[_Idx] += _Idx + 1;
+				}, make_prefetch_hint(_Ahead, _Distance));
+
+				for (size_t _I = 0; _I < _Table.size(); ++_I)
+					Assert::AreEqual(_I + 1, _Table[_I]);
+			}
+
+			std::fill(std::begin(_Table), std::end(_Table), size_t{ 0 });
+			std::list<size_t> _List(std::begin(_Index), std::end(_Index));
+			for_each(seq, std::begin(_List), std::end(_List), [&_Table](size_t _Idx) { ++_Table[_Idx]; }, make_prefetch_hint(_Ahead));
+			for_each(par.with(grain(33)), std::begin(_List), std::end(_List), [&_Table](size_t _Idx) { ++_Table[_Idx]; }, make_prefetch_hint(_Ahead, 4));
+			for_each(execution_policy(par), std::begin(_List), std::end(_List), [&_Table](size_t _Idx) { ++_Table[_Idx]; }, make_prefetch_hint(_Ahead));
+			for (auto _Val : _Table)
+				Assert::AreEqual(size_t{ 3 }, _Val);
+
+			for_each(par, std::begin(_Index), std::begin(_Index), [](size_t) { Assert::Fail(); }, make_prefetch_hint(_Ahead));
 		}
 
 		TEST_METHOD(ForEach)
@@ -249,6 +714,56 @@ namespace ParallelSTL_Tests
 			RunForEachThrow<input_iterator_tag>();		
 		}
 
+		TEST_METHOD(ForLoop)
+		{
+			std::vector<int> _Ct(100003);
+
+			for_loop(par, 0, static_cast<int>(_Ct.size()), [&_Ct](int _I) {
+				_Ct[_I] = _I * 2;
+			});
+			for (size_t _I = 0; _I < _Ct.size(); ++_I)
+				Assert::AreEqual(static_cast<int>(_I * 2), _Ct[_I]);
+
+			// every third element, from the end down
+			std::fill(std::begin(_Ct), std::end(_Ct), 0);
+			for_loop_strided(par_vec, _Ct.size() - 1, size_t{ 0 }, -3, [&_Ct](size_t _I) {
+				_Ct[_I] = 1;
+			});
+			for (size_t _I = 0; _I < _Ct.size(); ++_I)
+				Assert::AreEqual((_Ct.size() - 1 - _I) % 3 == 0 && _I != 0 ? 1 : 0, _Ct[_I]);
+
+			std::fill(std::begin(_Ct), std::end(_Ct), 0);
+			for_loop_n_strided(par.with(grain(7)), 10, 100, 5, [&_Ct](int _I) {
+				++_Ct[_I];
+			});
+			Assert::AreEqual(100, std::accumulate(std::begin(_Ct), std::end(_Ct), 0));
+			Assert::AreEqual(1, _Ct[505]);
+			Assert::AreEqual(0, _Ct[510]);
+
+			// the reduction starts from the value of the variable
+			long long _Sum = 5;
+			for_loop(par, 0, 100000, reduction_plus(_Sum), [](int _I, long long& _Local) {
+				_Local += _I;
+			});
+			Assert::AreEqual(5 + 99999ll * 100000 / 2, _Sum);
+
+			long long _Seq_sum = 5;
+			for_loop(0, 100000, reduction_plus(_Seq_sum), [](int _I, long long& _Local) {
+				_Local += _I;
+			});
+			Assert::AreEqual(_Sum, _Seq_sum);
+
+			int _Max = -1;
+			for_loop_n(par_vec, size_t{ 0 }, _Ct.size(), reduction(_Max, -1, [](int _Left, int _Right) { return (std::max)(_Left, _Right); }), [](size_t _I, int& _Local) {
+				_Local = (std::max)(_Local, static_cast<int>(_I % 1000));
+			});
+			Assert::AreEqual(999, _Max);
+
+			// empty loops don't call the body
+			for_loop(par, 10, 10, [](int) { Assert::Fail(); });
+			for_loop_strided(par, 0, 10, -1, [](int) { Assert::Fail(); });
+		}
+
 		TEST_METHOD(ForEachPerfTest)
 		{
 			Logger::WriteMessage("-----------Begin performance tests for foreach----------");
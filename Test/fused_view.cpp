@@ -0,0 +1,96 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(FusedViewTest)
+	{
+		template<typename _ExPolicy>
+		void TestReduce(_ExPolicy&& _Policy)
+		{
+			std::vector<int> _Data(100000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+
+			long long _Expected = 0;
+			for (int _Val : _Data)
+				if (_Val % 3 == 0)
+					_Expected += 2LL * _Val;
+
+			auto _View = views::transform(views::filter(_Data, [](int _Val) { return _Val % 3 == 0; }), [](int _Val) { return 2LL * _Val; });
+			Assert::AreEqual(_Expected, reduce(_Policy, _View));
+			Assert::AreEqual(_Expected + 5, reduce(_Policy, _View, 5LL));
+			Assert::AreEqual(_Expected + 5, reduce(_Policy, _View, 5LL, std::plus<long long>()));
+
+			// the filter sees the transformed values
+			auto _Odd_squares = views::filter(views::transform(_Data, [](int _Val) { return static_cast<long long>(_Val) * _Val; }), [](long long _Val) { return _Val % 2 == 1; });
+			long long _Expected_squares = 0;
+			for (long long _Val : _Data)
+				if (_Val % 2 == 1)
+					_Expected_squares += _Val * _Val;
+			Assert::AreEqual(_Expected_squares, reduce(_Policy, _Odd_squares));
+
+			// nothing passes the filter
+			Assert::AreEqual(7, reduce(_Policy, views::filter(_Data, [](int _Val) { return _Val < 0; }), 7));
+		}
+
+		template<typename _ExPolicy>
+		void TestCopy(_ExPolicy&& _Policy)
+		{
+			std::vector<int> _Data(100000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+
+			std::vector<int> _Expected;
+			for (int _Val : _Data)
+				if (_Val % 7 == 0)
+					_Expected.push_back(_Val + 1);
+
+			std::vector<int> _Out(_Data.size());
+			auto _End = copy(_Policy, views::transform(views::filter(_Data, [](int _Val) { return _Val % 7 == 0; }), [](int _Val) { return _Val + 1; }), std::begin(_Out));
+			Assert::IsTrue(_End == std::begin(_Out) + _Expected.size());
+			Assert::IsTrue(std::equal(std::begin(_Expected), std::end(_Expected), std::begin(_Out)));
+
+			_End = copy(_Policy, views::transform(_Data, [](int _Val) { return -_Val; }), std::begin(_Out));
+			Assert::IsTrue(_End == std::end(_Out));
+			for (int _I = 0; _I < 100000; ++_I)
+				Assert::AreEqual(-_I, _Out[_I]);
+		}
+
+	public:
+		TEST_METHOD(FusedViewReduce)
+		{
+			TestReduce(seq);
+			TestReduce(par);
+			TestReduce(par_vec);
+		}
+
+		TEST_METHOD(FusedViewCopy)
+		{
+			TestCopy(seq);
+			TestCopy(par);
+			TestCopy(par_vec);
+		}
+
+		TEST_METHOD(FusedViewForEach)
+		{
+			std::vector<int> _Data(100000, 1);
+			std::atomic<int> _Count(0);
+
+			for_each(par, views::filter(views::transform(_Data, [](int _Val) { return _Val * 4; }), [](int _Val) { return _Val == 4; }), [&_Count](int _Val) {
+				_Count += _Val;
+			});
+			Assert::AreEqual(400000, _Count.load());
+		}
+
+		TEST_METHOD(FusedViewException)
+		{
+			std::vector<int> _Data(100000, 1);
+
+			try {
+				reduce(par, views::transform(_Data, [](int) -> int { throw std::runtime_error("failed"); }));
+				Assert::Fail(L"The exception of the transform was not rethrown");
+			}
+			catch (const exception_list& _List) {
+				Assert::IsTrue(_List.size() > 0);
+			}
+		}
+	};
+}
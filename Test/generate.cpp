@@ -1,4 +1,6 @@
 #include "stdafx.h"
+#include <list>
+#include <random>
 
 namespace ParallelSTL_Tests
 {
@@ -85,5 +87,47 @@ namespace ParallelSTL_Tests
 			RunGenerateN<forward_iterator_tag>();
 			RunGenerateN<output_iterator_tag>();
 		}
+
+		TEST_METHOD(GenerateRandom)
+		{
+			// the numbers only depend on the seed, the chunks don't share a generator
+			std::uniform_real_distribution<double> _Dist(-100, 100);
+			std::vector<double> _Expected(100003);
+			generate_random(std::begin(_Expected), std::end(_Expected), 42, _Dist);
+
+			for (auto _Val : _Expected)
+				Assert::IsTrue(_Val >= -100 && _Val < 100);
+			Assert::IsTrue(_Expected[0] != _Expected[1]);
+
+			for (size_t _Grain : { 1, 64, 5000, 0 })
+			{
+				std::vector<double> _Vec(_Expected.size());
+				generate_random(par.with(grain(_Grain)), std::begin(_Vec), std::end(_Vec), 42, _Dist);
+				Assert::IsTrue(_Vec == _Expected);
+
+				std::fill(std::begin(_Vec), std::end(_Vec), 0.0);
+				auto _It = generate_random_n(par_vec.with(grain(_Grain)), std::begin(_Vec), _Vec.size(), 42, _Dist);
+				Assert::IsTrue(_It == std::end(_Vec));
+				Assert::IsTrue(_Vec == _Expected);
+			}
+
+			std::list<double> _List(_Expected.size());
+			generate_random(par, std::begin(_List), std::end(_List), 42, _Dist);
+			Assert::IsTrue(std::equal(std::begin(_List), std::end(_List), std::begin(_Expected)));
+
+			// an element is the first number of its stream
+			counter_engine _Engine(42, 17);
+			Assert::AreEqual(_Dist(_Engine), _Expected[17]);
+
+			std::vector<double> _Other(_Expected.size());
+			generate_random(seq, std::begin(_Other), std::end(_Other), 43, _Dist);
+			Assert::IsTrue(_Other != _Expected);
+
+			// the distributions that keep a number for the next call still draw every element on its own stream
+			std::vector<double> _Normal(1001), _Normal_par(_Normal.size());
+			generate_random(seq, std::begin(_Normal), std::end(_Normal), 7, std::normal_distribution<double>());
+			generate_random(par.with(grain(3)), std::begin(_Normal_par), std::end(_Normal_par), 7, std::normal_distribution<double>());
+			Assert::IsTrue(_Normal == _Normal_par);
+		}
 	};
 } // ParallelSTL_Tests
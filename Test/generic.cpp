@@ -616,5 +616,34 @@ namespace ParallelSTL_Tests
 
 			Assert::AreEqual(true, _Exception);
 		}
+
+		TEST_METHOD(CombinableResetAndCombineParallel)
+		{
+			combinable<size_t> data([]{ return size_t{ 0 }; });
+			std::vector<size_t> vec(100000);
+			std::iota(std::begin(vec), std::end(vec), size_t{ 1 });
+			const size_t _Expected = vec.size() * (vec.size() + 1) / 2;
+			auto _Plus = [](size_t _Val, size_t _Val2) { return _Val + _Val2; };
+
+			for (int _Round = 0; _Round < 3; ++_Round) {
+				for_each(par, std::begin(vec), std::end(vec), [&data](size_t _Val) { data.local() += _Val; });
+
+				Assert::AreEqual(_Expected, data.combine(_Plus));
+				Assert::AreEqual(_Expected, data.combine_parallel(_Plus));
+
+				// The values start over, the nodes stay
+				data.reset();
+				Assert::AreEqual(size_t{ 0 }, data.combine_parallel(_Plus));
+			}
+
+			// The calling thread still has its node after a reset, but not after a clear
+			bool _Exists = false;
+			data.local(_Exists);
+			data.local() = 5;
+			data.clear();
+			data.local(_Exists);
+			Assert::IsFalse(_Exists);
+			Assert::AreEqual(size_t{ 0 }, data.combine_parallel(_Plus));
+		}
 	};
 } //ParallelSTL_Tests
@@ -0,0 +1,114 @@
+#include "stdafx.h"
+
+#if _EXP_AMP
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	struct GpuTwice
+	{
+		float operator()(int _Val) const restrict(amp, cpu)
+		{
+			return 2.0f * _Val;
+		}
+	};
+
+	struct GpuMax
+	{
+		int operator()(int _Left, int _Right) const restrict(amp, cpu)
+		{
+			return _Left < _Right ? _Right : _Left;
+		}
+	};
+
+	TEST_CLASS(GpuTest)
+	{
+		// under the threshold of par_gpu the algorithms take par, with a threshold of 1 the accelerator
+		template<typename _Fn>
+		static void RunGpu(_Fn _Check)
+		{
+			_Check(par_gpu);
+			_Check(par_gpu.offload_threshold(1));
+		}
+
+		TEST_METHOD(GpuTransform)
+		{
+			RunGpu([](const parallel_gpu_execution_policy& _Policy) {
+				for (int _Count : { 1, 1000, 300000, (1 << 20) + 17 }) {
+					std::vector<int> _In(_Count);
+					std::iota(std::begin(_In), std::end(_In), -500);
+					std::vector<float> _Out(_Count);
+
+					transform(_Policy, array_view<const int, 1>{ _In }, array_view<float, 1>{ _Out }, GpuTwice());
+					for (int _I = 0; _I < _Count; ++_I)
+						Assert::AreEqual(2.0f * _In[_I], _Out[_I]);
+				}
+			});
+		}
+
+		TEST_METHOD(GpuForEachBounds)
+		{
+			RunGpu([](const parallel_gpu_execution_policy& _Policy) {
+				std::vector<int> _Data(300 * 70, 0);
+				concurrency::array_view<int, 2> _Acc_data(300, 70, _Data);
+
+				for_each(_Policy, bounds<2>{ 300, 70 }, [=](concurrency::index<2> _Idx) restrict(amp, cpu) {
+					_Acc_data[_Idx] = _Idx[0] * 100 + _Idx[1];
+				});
+				_Acc_data.synchronize();
+
+				for (int _Row = 0; _Row < 300; ++_Row)
+					for (int _Col = 0; _Col < 70; ++_Col)
+						Assert::AreEqual(_Row * 100 + _Col, _Data[_Row * 70 + _Col]);
+			});
+		}
+
+		TEST_METHOD(GpuReduce)
+		{
+			RunGpu([](const parallel_gpu_execution_policy& _Policy) {
+				for (int _Count : { 1, 255, 257, 300000, (1 << 20) * 2 + 3 }) {
+					std::vector<int> _In(_Count, 1);
+					_In[_Count / 2] = 7;
+
+					Assert::AreEqual(_Count + 6, reduce(_Policy, array_view<const int, 1>{ _In }));
+					Assert::AreEqual(7, reduce(_Policy, array_view<const int, 1>{ _In }, 0, GpuMax()));
+				}
+			});
+		}
+
+		TEST_METHOD(GpuInclusiveScan)
+		{
+			RunGpu([](const parallel_gpu_execution_policy& _Policy) {
+				for (int _Count : { 1, 256, 1000, (1 << 20) + 300 }) {
+					std::vector<int> _In(_Count);
+					for (int _I = 0; _I < _Count; ++_I)
+						_In[_I] = _I % 3;
+					std::vector<int> _Out(_Count);
+
+					inclusive_scan(_Policy, array_view<const int, 1>{ _In }, array_view<int, 1>{ _Out });
+
+					std::vector<int> _Expected(_Count);
+					std::partial_sum(std::begin(_In), std::end(_In), std::begin(_Expected));
+					Assert::IsTrue(_Expected == _Out);
+				}
+			});
+		}
+
+		TEST_METHOD(GpuSort)
+		{
+			RunGpu([](const parallel_gpu_execution_policy& _Policy) {
+				for (int _Count : { 1, 2, 1000, 100003 }) {
+					std::vector<float> _Keys(_Count);
+					for (int _I = 0; _I < _Count; ++_I)
+						_Keys[_I] = static_cast<float>((_I * 7919) % 1009) - 500.0f;
+					std::vector<float> _Expected(_Keys);
+					std::sort(std::begin(_Expected), std::end(_Expected));
+
+					sort(_Policy, array_view<float, 1>{ _Keys });
+					Assert::IsTrue(_Expected == _Keys);
+				}
+			});
+		}
+	};
+} // ParallelSTL_Tests
+#endif // _EXP_AMP
@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include <list>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(HistogramTest)
+	{
+		template<typename _ExPolicy, typename _InIt>
+		void CheckHistogram(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, size_t _Bins, const std::vector<size_t>& _Expected)
+		{
+			std::vector<size_t> _Counts(_Bins, 7);
+			auto _It = histogram(_Policy, _First, _Last, std::begin(_Counts), _Bins, [_Bins](int _Val) { return _Val % (_Bins + 1); });
+			Assert::IsTrue(_It == std::end(_Counts));
+			Assert::IsTrue(_Counts == _Expected);
+		}
+
+		TEST_METHOD(Histogram)
+		{
+			// the values in the bin after the last one are not counted
+			for (size_t _Size : { 0, 1, 17, 1000, 100003 })
+			{
+				for (size_t _Bins : { 1, 16, 256, 5000 })
+				{
+					std::vector<int> _Vec(_Size);
+					for (size_t _I = 0; _I < _Size; ++_I)
+						_Vec[_I] = static_cast<int>((_I * 7919) % 10007);
+					std::list<int> _List(std::begin(_Vec), std::end(_Vec));
+
+					std::vector<size_t> _Expected(_Bins);
+					for (auto _Val : _Vec)
+					{
+						const size_t _Bin = _Val % (_Bins + 1);
+						if (_Bin < _Bins)
+							++_Expected[_Bin];
+					}
+
+					CheckHistogram(seq, std::begin(_Vec), std::end(_Vec), _Bins, _Expected);
+					CheckHistogram(par, std::begin(_Vec), std::end(_Vec), _Bins, _Expected);
+					CheckHistogram(par_vec, std::begin(_Vec), std::end(_Vec), _Bins, _Expected);
+					CheckHistogram(par, std::begin(_List), std::end(_List), _Bins, _Expected);
+				}
+			}
+		}
+
+		TEST_METHOD(HistogramThrow)
+		{
+			std::vector<int> _Vec(10000);
+			std::iota(std::begin(_Vec), std::end(_Vec), 0);
+			std::vector<size_t> _Counts(16);
+
+			try {
+				histogram(par, std::begin(_Vec), std::end(_Vec), std::begin(_Counts), _Counts.size(), [](int _Val) -> size_t {
+					if (_Val == 5000)
+						throw std::runtime_error("histogram");
+					return _Val % 16;
+				});
+				Assert::Fail();
+			}
+			catch (exception_list& e) {
+				Assert::IsTrue(e.size() > 0);
+			}
+		}
+	};
+} // ParallelSTL_Tests
@@ -136,5 +136,24 @@ namespace ParallelSTL_Tests
 
 			Assert::IsFalse(includes(par, std::begin(vec_sup), std::end(vec_sup), std::begin(vec_needle), std::end(vec_needle)));
 		}
+		TEST_METHOD(IncludesSkewed)
+		{
+			// A few values looked up in a range thousands of times their size
+			std::vector<int> vec(500000);
+			std::iota(std::begin(vec), std::end(vec), 0);
+			vec.insert(std::end(vec), 3, 777);
+			std::sort(std::begin(vec), std::end(vec));
+
+			std::vector<int> needle = { 3, 777, 777, 777, 777, 4096, 250000, 499999 };
+			Assert::IsTrue(includes(par, std::begin(vec), std::end(vec), std::begin(needle), std::end(needle)));
+
+			needle.push_back(777); // one more than the range holds
+			std::sort(std::begin(needle), std::end(needle));
+			Assert::IsFalse(includes(par, std::begin(vec), std::end(vec), std::begin(needle), std::end(needle)));
+
+			std::vector<int> missing = { 3, 4096, 500000 };
+			Assert::IsFalse(includes(par, std::begin(vec), std::end(vec), std::begin(missing), std::end(missing)));
+			Assert::IsFalse(includes(par, std::begin(missing), std::end(missing), std::begin(vec), std::end(vec)));
+		}
 	};
 }
\ No newline at end of file
@@ -176,5 +176,27 @@ namespace ParallelSTL_Tests
 			lexicographical_compare(par, _InIter, _InIter, _FwdIter, _FwdIter);
 			lexicographical_compare(par, _InIter, _InIter, _RaIter, _RaIter);
 		}
+
+		// Contiguous ranges of integers compared with std::less find the first difference with memcmp
+		TEST_METHOD(LexicographicalCompareBytewise)
+		{
+			const size_t COLLECTION_SIZE = 100003;
+
+			std::vector<unsigned char> vec(COLLECTION_SIZE, 7);
+			std::vector<unsigned char> other(vec);
+
+			Assert::IsFalse(lexicographical_compare(par, std::begin(vec), std::end(vec), std::begin(other), std::end(other)));
+			Assert::IsTrue(lexicographical_compare(par, std::begin(vec), std::end(vec) - 1, std::begin(other), std::end(other)));
+
+			other[5000] = 8;
+			other[6000] = 0; // Later difference must not decide
+			Assert::IsTrue(lexicographical_compare(par, std::begin(vec), std::end(vec), std::begin(other), std::end(other)));
+			Assert::IsFalse(lexicographical_compare(par_vec, std::begin(other), std::end(other), std::begin(vec), std::end(vec)));
+
+			std::vector<int> ints(COLLECTION_SIZE, -1), other_ints(COLLECTION_SIZE, -1);
+			other_ints[COLLECTION_SIZE / 2] = -2;
+			Assert::IsFalse(lexicographical_compare(par, std::begin(ints), std::end(ints), std::begin(other_ints), std::end(other_ints)));
+			Assert::IsTrue(lexicographical_compare(par, std::begin(other_ints), std::end(other_ints), std::begin(ints), std::end(ints), std::less<int>()));
+		}
 	};
 }
@@ -0,0 +1,103 @@
+#include "stdafx.h"
+
+#include <fstream>
+
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(MappedViewTest)
+	{
+		static const wchar_t *FileName()
+		{
+			return L"mapped_view_test.bin";
+		}
+
+		// A file of _Count ints numbered from 0
+		static void WriteFile(int _Count)
+		{
+			std::vector<int> _Values(_Count);
+			std::iota(std::begin(_Values), std::end(_Values), 0);
+
+			std::ofstream _File(FileName(), std::ios::binary | std::ios::trunc);
+			_File.write(reinterpret_cast<const char *>(_Values.data()), _Values.size() * sizeof(int));
+		}
+
+		TEST_METHOD(MappedViewReadOnly)
+		{
+			WriteFile(300 * 200);
+
+			{
+				mapped_array_view<const int> _Whole(FileName());
+				Assert::AreEqual(ptrdiff_t(300 * 200), _Whole.size());
+				_Whole.prefetch(par);
+				_Whole.prefetch(par.with(partitioner(static_)));
+				_Whole.prefetch(seq, 4096);
+
+				long long _Sum = reduce(par, _Whole.data(), _Whole.data() + _Whole.size(), 0ll);
+				Assert::AreEqual(300ll * 200 * (300 * 200 - 1) / 2, _Sum);
+
+				// the views algorithms take the mapped view as an array_view
+				mapped_array_view<const int, 2> _Matrix(FileName(), { 300, 200 });
+				_Matrix.prefetch({ 100, 0 }, 200 * 200);
+				std::vector<int> _Copy(300 * 200);
+				copy(par, _Matrix.section({ 0, 0 }, { 300, 100 }), array_view<int, 2>{ { 300, 100 }, _Copy });
+				Assert::AreEqual(150 * 200 + 99, _Copy[150 * 100 + 99]);
+
+				// the bounds start at an offset, the rest of the file holds fewer elements than asked for
+				mapped_array_view<const int> _Tail(FileName(), 100 * sizeof(int));
+				Assert::AreEqual(ptrdiff_t(300 * 200 - 100), _Tail.size());
+				Assert::AreEqual(100, _Tail[0]);
+
+				bool _Thrown = false;
+				try {
+					mapped_array_view<const int, 2> _Past(FileName(), { 300, 200 }, sizeof(int));
+				}
+				catch (std::out_of_range&) {
+					_Thrown = true;
+				}
+				Assert::IsTrue(_Thrown);
+			}
+
+			_wremove(FileName());
+		}
+
+		TEST_METHOD(MappedViewCopyOnWrite)
+		{
+			WriteFile(100000);
+
+			{
+				mapped_array_view<int> _Private(FileName(), { 100000 }, 0, mapped_access::random);
+				fill(par, _Private, 7);
+				Assert::AreEqual(ptrdiff_t(100000), std::count(_Private.data(), _Private.data() + _Private.size(), 7));
+
+				// the writes stay in the pages of the process, the file keeps its elements
+				mapped_array_view<const int> _File(FileName());
+				Assert::AreEqual(99999, _File[99999]);
+
+				// a copy shares the mapping after the first view has gone away
+				mapped_array_view<int> _Shared;
+				{
+					mapped_array_view<int> _First(FileName());
+					_First[5] = -5;
+					_Shared = _First;
+				}
+				Assert::AreEqual(-5, _Shared[5]);
+			}
+
+			_wremove(FileName());
+		}
+
+		TEST_METHOD(MappedViewMissingFile)
+		{
+			bool _Thrown = false;
+			try {
+				mapped_array_view<const int> _Missing(L"mapped_view_missing.bin");
+			}
+			catch (std::system_error&) {
+				_Thrown = true;
+			}
+			Assert::IsTrue(_Thrown);
+		}
+	};
+} // ParallelSTL_Tests
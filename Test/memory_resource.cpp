@@ -0,0 +1,98 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(MemoryResourceTest)
+	{
+	public:
+		TEST_METHOD(ScratchTrackerPeak)
+		{
+			std::vector<int> _Data(100000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+			std::vector<int> _Out(_Data.size());
+
+			scratch_tracker _Tracker;
+			auto _Policy = par.with(scratch_resource(_Tracker));
+
+			// the filter mask of copy_if holds a bit per element
+			auto _End = copy_if(_Policy, std::begin(_Data), std::end(_Data), std::begin(_Out), [](int _Val) { return _Val % 2 == 0; });
+			Assert::IsTrue(_End == std::begin(_Out) + _Data.size() / 2);
+			Assert::IsTrue(_Tracker.peak() >= _Data.size() / 8);
+			Assert::AreEqual(size_t(0), _Tracker.bytes_in_use());
+
+			_Tracker.reset();
+			Assert::AreEqual(size_t(0), _Tracker.peak());
+			Assert::AreEqual(4999950000LL, reduce(_Policy, std::begin(_Data), std::end(_Data), 0LL));
+			Assert::IsTrue(_Tracker.peak() > 0);
+			Assert::AreEqual(size_t(0), _Tracker.bytes_in_use());
+
+			// the policies without the parameter don't use it
+			_Tracker.reset();
+			copy_if(par, std::begin(_Data), std::end(_Data), std::begin(_Out), [](int _Val) { return _Val % 2 == 0; });
+			Assert::AreEqual(size_t(0), _Tracker.peak());
+		}
+
+		TEST_METHOD(MonotonicScratchArena)
+		{
+			std::vector<int> _Data(100000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+			std::reverse(std::begin(_Data), std::end(_Data));
+
+			scratch_tracker _Tracker;
+			monotonic_buffer_resource _Arena(&_Tracker);
+			auto _Policy = par.with(scratch_resource(_Arena));
+
+			stable_sort(_Policy, std::begin(_Data), std::end(_Data));
+			Assert::IsTrue(std::is_sorted(std::begin(_Data), std::end(_Data)));
+
+			Assert::AreEqual(4999950000LL, transform_reduce(_Policy, std::begin(_Data), std::end(_Data), 0LL, std::plus<long long>(), [](int _Val) { return static_cast<long long>(_Val); }));
+
+			// the arena keeps its blocks until it is released
+			Assert::IsTrue(_Tracker.bytes_in_use() > 0);
+			_Arena.release();
+			Assert::AreEqual(size_t(0), _Tracker.bytes_in_use());
+		}
+
+		TEST_METHOD(ScratchCacheReuse)
+		{
+			std::vector<int> _Data(1000000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+			std::vector<int> _Out(_Data.size());
+			auto _Even = [](int _Val) { return _Val % 2 == 0; };
+
+			trim_scratch_cache();
+			const size_t _Limit = scratch_cache_limit();
+
+			// the filter mask of the first call is kept and taken again by the second
+			copy_if(par, std::begin(_Data), std::end(_Data), std::begin(_Out), _Even);
+			const size_t _Retained = scratch_cache_retained_bytes();
+			Assert::IsTrue(_Retained >= _Data.size() / 8);
+			copy_if(par, std::begin(_Data), std::end(_Data), std::begin(_Out), _Even);
+			Assert::AreEqual(_Retained, scratch_cache_retained_bytes());
+
+			trim_scratch_cache();
+			Assert::AreEqual(size_t(0), scratch_cache_retained_bytes());
+
+			set_scratch_cache_limit(0);
+			copy_if(par, std::begin(_Data), std::end(_Data), std::begin(_Out), _Even);
+			Assert::AreEqual(size_t(0), scratch_cache_retained_bytes());
+			Assert::AreEqual(size_t(0), set_scratch_cache_limit(_Limit));
+		}
+
+		TEST_METHOD(MemoryResourceAlignment)
+		{
+			monotonic_buffer_resource _Arena(256);
+			for (size_t _Alignment = 1; _Alignment <= 256; _Alignment *= 2)
+			{
+				void *_Ptr = _Arena.allocate(3, _Alignment);
+				Assert::AreEqual(size_t(0), reinterpret_cast<size_t>(_Ptr) % _Alignment);
+			}
+
+			void *_Large = new_delete_resource()->allocate(1000, 128);
+			Assert::AreEqual(size_t(0), reinterpret_cast<size_t>(_Large) % 128);
+			new_delete_resource()->deallocate(_Large, 1000, 128);
+			Assert::IsTrue(new_delete_resource()->is_equal(*new_delete_resource()));
+			Assert::IsFalse(_Arena.is_equal(*new_delete_resource()));
+		}
+	};
+}
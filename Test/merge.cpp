@@ -1,4 +1,6 @@
 #include "stdafx.h"
+#include <atomic>
+#include <string>
 
 #pragma warning (disable : 4503) // decorated name length exceeded, name was truncated
 
@@ -65,6 +67,64 @@ namespace ParallelSTL_Tests
 		Assert::IsTrue(std::is_sorted(items.begin(), items.end()));
 	}
 
+	// A key tagged with the place of its value before a merge
+	struct TaggedKey
+	{
+		size_t key, origin;
+
+		TaggedKey(size_t k = 0, size_t o = 0) : key(k), origin(o)
+		{
+		}
+	};
+
+	// A value whose moves may throw, inplace_merge merges it with rotations in place of a buffer
+	struct MayThrowOnMove
+	{
+		size_t key, origin;
+
+		MayThrowOnMove(size_t k = 0, size_t o = 0) : key(k), origin(o)
+		{
+		}
+
+		MayThrowOnMove(const MayThrowOnMove& other) : key(other.key), origin(other.origin)
+		{
+		}
+
+		MayThrowOnMove& operator=(const MayThrowOnMove& other)
+		{
+			key = other.key;
+			origin = other.origin;
+			return *this;
+		}
+	};
+
+	// Two sorted runs of _Len1 and _Len2 values with many equal keys, the origin of a value is its place before the merge
+	template<typename _Ty>
+	vector<_Ty> TaggedRuns(size_t _Len1, size_t _Len2)
+	{
+		vector<_Ty> data(_Len1 + _Len2);
+		for (size_t i = 0; i < data.size(); i++)
+			data[i] = _Ty(i * 7919 % 97, 0);
+
+		auto by_key = [](const _Ty &left, const _Ty &right) { return left.key < right.key; };
+		std::sort(data.begin(), data.begin() + _Len1, by_key);
+		std::sort(data.begin() + _Len1, data.end(), by_key);
+		for (size_t i = 0; i < data.size(); i++)
+			data[i].origin = i;
+		return data;
+	}
+
+	template<typename _Ty>
+	void AssertStablyMerged(const vector<_Ty>& data)
+	{
+		for (size_t i = 1; i < data.size(); i++)
+		{
+			Assert::IsTrue(data[i - 1].key <= data[i].key);
+			if (data[i - 1].key == data[i].key)
+				Assert::IsTrue(data[i - 1].origin < data[i].origin);
+		}
+	}
+
 	TEST_CLASS(merge_tests)
 	{
 
@@ -114,6 +174,73 @@ namespace ParallelSTL_Tests
 			InplaceMergeImpl(par_vec);
 		}
 
+		TEST_METHOD(InplaceMergeBuffered)
+		{
+			auto by_key = [](const TaggedKey &left, const TaggedKey &right) { return left.key < right.key; };
+			const pair<size_t, size_t> lengths[] = { { 30000, 30000 }, { 1, 70000 }, { 70000, 3 }, { 0, 40000 }, { 40000, 0 }, { 5000, 65000 } };
+
+			// The tasks of the merge, not powers of two, over more values than _Merge_min_part for each of them
+			for (size_t div : { 3, 5, 6, 7, 13 })
+			{
+				for (const auto& length : lengths)
+				{
+					vector<TaggedKey> data = TaggedRuns<TaggedKey>(length.first, length.second);
+					details::_Parallel_buffered_inplace_merge(data.begin(), length.first, length.second, by_key, div);
+					Assert::AreEqual(length.first + length.second, data.size());
+					AssertStablyMerged(data);
+				}
+			}
+
+			for (unsigned int threads : { 3u, 5u, 7u })
+			{
+				vector<TaggedKey> data = TaggedRuns<TaggedKey>(25000, 61000);
+				inplace_merge(par.with(max_threads(threads)), data.begin(), data.begin() + 25000, data.end(), by_key);
+				AssertStablyMerged(data);
+			}
+		}
+
+		TEST_METHOD(InplaceMergeThrowingCompare)
+		{
+			const size_t size1 = 40000, size2 = 50000;
+			vector<string> data(size1 + size2);
+			for (size_t i = 0; i < data.size(); i++)
+				data[i] = "a value long enough to live on the heap " + std::to_string(i * 7919 % data.size());
+
+			std::sort(data.begin(), data.begin() + size1);
+			std::sort(data.begin() + size1, data.end());
+			vector<string> expected(data);
+			std::sort(expected.begin(), expected.end());
+
+			// The comparison throws partway through the moves to the buffer, the range keeps all of its values
+			for (size_t limit : { size_t{ 100 }, size1 / 2, size1 + size2 / 2 })
+			{
+				vector<string> values(data);
+				std::atomic<size_t> compared(0);
+				try {
+					inplace_merge(par.with(max_threads(5)), values.begin(), values.begin() + size1, values.end(), [&](const string &left, const string &right) {
+						if (compared++ == limit)
+							throw std::exception();
+						return left < right;
+					});
+					Assert::Fail();
+				}
+				catch (const exception_list& ex) {
+					Assert::AreEqual(size_t{ 1 }, ex.size());
+				}
+
+				std::sort(values.begin(), values.end());
+				Assert::IsTrue(values == expected);
+			}
+		}
+
+		TEST_METHOD(InplaceMergeMayThrowOnMove)
+		{
+			auto by_key = [](const MayThrowOnMove &left, const MayThrowOnMove &right) { return left.key < right.key; };
+			vector<MayThrowOnMove> data = TaggedRuns<MayThrowOnMove>(33000, 47000);
+			inplace_merge(par.with(max_threads(6)), data.begin(), data.begin() + 33000, data.end(), by_key);
+			AssertStablyMerged(data);
+		}
+
 		template<typename _IterCat, typename _IterCat2 = _IterCat>
 		void RunMerge()
 		{
@@ -140,6 +267,60 @@ namespace ParallelSTL_Tests
 			RunMerge<std::random_access_iterator_tag>();
 		}
 
+		// Merges two tagged runs in parallel and checks the result against std::merge
+		static void CheckMergePath(const vector<TaggedKey>& first, const vector<TaggedKey>& second, unsigned int threads)
+		{
+			auto by_key = [](const TaggedKey &left, const TaggedKey &right) { return left.key < right.key; };
+			vector<TaggedKey> merged(first.size() + second.size()), expected(merged.size());
+			std::merge(first.begin(), first.end(), second.begin(), second.end(), expected.begin(), by_key);
+
+			Assert::IsTrue(merge(par.with(max_threads(threads)), first.begin(), first.end(), second.begin(), second.end(), merged.begin(), by_key) == merged.end());
+			AssertStablyMerged(merged);
+			for (size_t i = 0; i < merged.size(); i++)
+				Assert::AreEqual(expected[i].origin, merged[i].origin);
+		}
+
+		TEST_METHOD(MergePathSplits)
+		{
+			// More values than _Merge_min_part for every task of the thread limits, which aren't powers of two
+			const size_t size1 = 512 * 64 + 77, size2 = 512 * 48 + 5;
+			for (unsigned int threads : { 3u, 5u, 7u, 12u })
+			{
+				vector<TaggedKey> runs = TaggedRuns<TaggedKey>(size1, size2);
+				const vector<TaggedKey> first(runs.begin(), runs.begin() + size1), second(runs.begin() + size1, runs.end());
+
+				// many ties
+				CheckMergePath(first, second, threads);
+				CheckMergePath(second, first, threads);
+
+				// one empty input
+				CheckMergePath(first, vector<TaggedKey>(), threads);
+				CheckMergePath(vector<TaggedKey>(), second, threads);
+
+				// disjoint inputs, one after the other either way
+				vector<TaggedKey> low(size1), high(size2);
+				for (size_t i = 0; i < size1; i++)
+					low[i] = TaggedKey(i, i);
+				for (size_t i = 0; i < size2; i++)
+					high[i] = TaggedKey(size1 + i, size1 + i);
+				CheckMergePath(low, high, threads);
+				CheckMergePath(high, low, threads);
+			}
+
+			// The merges of a sort move the values, the splits must not read a value another task moved out
+			vector<string> values(512 * 40);
+			for (size_t i = 0; i < values.size(); i++)
+				values[i] = "a value long enough to live on the heap " + std::to_string(i * 7919 % 1000);
+			std::sort(values.begin(), values.begin() + values.size() / 3);
+			std::sort(values.begin() + values.size() / 3, values.end());
+
+			vector<string> expected(values.size()), moved(values.size());
+			std::merge(values.begin(), values.begin() + values.size() / 3, values.begin() + values.size() / 3, values.end(), expected.begin());
+			std::less<string> less;
+			details::_Parallel_move_merge(values.begin(), values.size() / 3, values.begin() + values.size() / 3, values.size() - values.size() / 3, moved.begin(), less, 7);
+			Assert::IsTrue(moved == expected);
+		}
+
 
 		template<typename _IterCat>
 		struct InplaceMergeAlgoTest :
@@ -193,6 +374,41 @@ namespace ParallelSTL_Tests
 			RunMergeImplace<std::bidirectional_iterator_tag>();
 			RunMergeImplace<std::random_access_iterator_tag>();
 		}
+
+		TEST_METHOD(MultiwayMerge)
+		{
+			// Runs of uneven lengths, one of them empty, with values that repeat across the runs
+			vector<vector<pair<int, size_t>>> runs(24);
+			vector<pair<int, size_t>> expected;
+			for (size_t run = 0; run < runs.size(); ++run)
+			{
+				const size_t length = run == 7 ? 0 : 1000 + run * 997 % 5000;
+				for (size_t i = 0; i < length; ++i)
+					runs[run].push_back(make_pair(static_cast<int>(i * 31 % 500), 0));
+
+				std::sort(runs[run].begin(), runs[run].end());
+				for (size_t i = 0; i < length; ++i)
+					runs[run][i].second = run * 10000 + i;
+
+				expected.insert(expected.end(), runs[run].begin(), runs[run].end());
+			}
+
+			auto by_first = [](const pair<int, size_t> &left, const pair<int, size_t> &right) { return left.first < right.first; };
+			std::stable_sort(expected.begin(), expected.end(), by_first);
+
+			typedef vector<pair<int, size_t>>::const_iterator run_iterator;
+			vector<pair<run_iterator, run_iterator>> ranges;
+			for (const auto& run : runs)
+				ranges.push_back(make_pair(run.cbegin(), run.cend()));
+
+			vector<pair<int, size_t>> merged(expected.size());
+			Assert::IsTrue(multiway_merge(seq, ranges, merged.begin(), by_first) == merged.end());
+			Assert::IsTrue(merged == expected);
+
+			std::fill(merged.begin(), merged.end(), make_pair(0, size_t{ 0 }));
+			Assert::IsTrue(multiway_merge(par, ranges, merged.begin(), by_first) == merged.end());
+			Assert::IsTrue(merged == expected);
+		}
 	};
 
 
@@ -367,5 +367,43 @@ namespace ParallelSTL_Tests
 			Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), _Pair.first)) == _Pos);
 			Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), _Pair.second)) == (_Pos + 1));
 		}
+
+		template<typename _Ty>
+		void RunMinMaxVectorized(size_t _Size, int _Modulo)
+		{
+			std::vector<_Ty> _Ct(_Size);
+			for (auto& _El : _Ct)
+				_El = static_cast<_Ty>(rand() % _Modulo - _Modulo / 2);
+
+			Assert::IsTrue(min_element(par, std::begin(_Ct), std::end(_Ct)) == std::min_element(std::begin(_Ct), std::end(_Ct)));
+			Assert::IsTrue(max_element(par_vec, std::begin(_Ct), std::end(_Ct)) == std::max_element(std::begin(_Ct), std::end(_Ct)));
+			Assert::IsTrue(minmax_element(par, std::begin(_Ct), std::end(_Ct), std::less<_Ty>()) == std::minmax_element(std::begin(_Ct), std::end(_Ct)));
+		}
+
+		// Contiguous arithmetic ranges reduce their values a vector at a time, the elements found are the first
+		// smallest, the first largest and the last largest of the repeated values
+		TEST_METHOD(MinMaxElementVectorized)
+		{
+			const size_t sizes[] = { 1, 15, 1000, 100003, 2000001 };
+
+			for (auto _Size : sizes) {
+				RunMinMaxVectorized<signed char>(_Size, 200);
+				RunMinMaxVectorized<unsigned char>(_Size, 7);
+				RunMinMaxVectorized<short>(_Size, 30000);
+				RunMinMaxVectorized<unsigned short>(_Size, 3);
+				RunMinMaxVectorized<int>(_Size, 10);
+				RunMinMaxVectorized<unsigned int>(_Size, 30000);
+				RunMinMaxVectorized<long long>(_Size, 100);
+				RunMinMaxVectorized<float>(_Size, 5);
+				RunMinMaxVectorized<double>(_Size, 1000);
+			}
+
+			// NaNs are not ordered, the comparisons decide
+			std::vector<double> _Nan(10000, 1.0);
+			_Nan[10] = std::numeric_limits<double>::quiet_NaN();
+			_Nan[5000] = 0.5;
+			Assert::IsTrue(min_element(par, std::begin(_Nan), std::end(_Nan)) == std::begin(_Nan) + 5000);
+			Assert::IsTrue(minmax_element(par, std::begin(_Nan), std::end(_Nan)).second == std::begin(_Nan) + 9999);
+		}
 	};
 } // ParallelSTL_Tests
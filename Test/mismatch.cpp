@@ -291,5 +291,35 @@ namespace ParallelSTL_Tests
 			mismatch(par, _InIter, _InIter, _FwdIter, _FwdIter);
 			mismatch(par, _InIter, _InIter, _FwdIter, _FwdIter);
 		}
+
+		// Contiguous ranges of integers are compared with memcmp, block by block
+		TEST_METHOD(MismatchBytewise)
+		{
+			const size_t COLLECTION_SIZE = 100003;
+			const size_t positions[] = { 0, 1, 4095, 4096, 50000, COLLECTION_SIZE - 1 };
+
+			std::vector<unsigned char> bytes(COLLECTION_SIZE);
+			for (size_t i = 0; i < COLLECTION_SIZE; ++i)
+				bytes[i] = static_cast<unsigned char>(i * 31);
+			std::vector<long long> words(std::begin(bytes), std::end(bytes));
+
+			for (auto _Pos : positions) {
+				std::vector<unsigned char> other_bytes(bytes);
+				other_bytes[_Pos] ^= 1;
+				other_bytes[COLLECTION_SIZE - 1] ^= 2; // Later mismatch must not win
+				std::vector<long long> other_words(std::begin(other_bytes), std::end(other_bytes));
+
+				auto _Bytes = mismatch(par, std::begin(bytes), std::end(bytes), std::begin(other_bytes));
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(bytes), _Bytes.first)) == _Pos);
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(other_bytes), _Bytes.second)) == _Pos);
+
+				auto _Words = mismatch(par_vec, words.data(), words.data() + words.size(), other_words.data(), other_words.data() + other_words.size());
+				Assert::IsTrue(_Words.first == words.data() + _Pos);
+			}
+
+			std::vector<long long> same(words);
+			auto _Same = mismatch(par, std::begin(words), std::end(words), std::begin(same), std::end(same));
+			Assert::IsTrue(_Same.first == std::end(words) && _Same.second == std::end(same));
+		}
 	};
 }
@@ -0,0 +1,63 @@
+#include "stdafx.h"
+
+#include <forward_list>
+#include <list>
+#include <map>
+#include <set>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(NodeIndexTest)
+	{
+	public:
+		TEST_METHOD(NodeIndexMap)
+		{
+			// large enough to be indexed from both ends
+			std::map<int, long long> values;
+			long long expected = 0;
+			for (int i = 0; i < 200000; ++i)
+			{
+				values.emplace(i * 7 % 200003, i);
+				expected += 2 * i;
+			}
+
+			auto index = make_node_index(values);
+			Assert::AreEqual(values.size(), index.size());
+			Assert::IsTrue(std::equal(values.begin(), values.end(), index.begin()));
+
+			for_each(par, index.begin(), index.end(), [](std::pair<const int, long long>& node) { node.second *= 2; });
+			Assert::AreEqual(expected, std::accumulate(values.begin(), values.end(), 0ll,
+				[](long long sum, const std::pair<const int, long long>& node) { return sum + node.second; }));
+
+			auto is_odd_key = [](const std::pair<const int, long long>& node) { return node.first % 2 != 0; };
+			Assert::AreEqual(std::count_if(values.begin(), values.end(), is_odd_key), count_if(par, index.begin(), index.end(), is_odd_key));
+
+			Assert::AreEqual(expected, transform_reduce(par, index.begin(), index.end(), 0ll, std::plus<long long>(),
+				[](const std::pair<const int, long long>& node) { return node.second; }));
+		}
+
+		TEST_METHOD(NodeIndexForward)
+		{
+			std::set<int> keys;
+			for (int i = 0; i < 1000; ++i)
+				keys.insert(i * 31 % 1009);
+
+			node_index<std::set<int>::const_iterator> index(keys.begin(), keys.end());
+			Assert::AreEqual(keys.size(), index.size());
+			Assert::AreEqual(static_cast<ptrdiff_t>(500), count_if(par, index.begin(), index.end(), [](int key) { return key < 500; }));
+
+			std::forward_list<int> forward(5000, 3);
+			node_index<std::forward_list<int>::iterator> forward_index(forward.begin(), forward.end());
+			Assert::AreEqual(size_t(5000), forward_index.size());
+			Assert::AreEqual(15000, reduce(par, forward_index.begin(), forward_index.end(), 0));
+
+			std::list<int> list(100000, 1);
+			auto list_index = make_node_index(list);
+			for_each(par, list_index.begin(), list_index.end(), [](int& value) { ++value; });
+			Assert::IsTrue(std::all_of(list.begin(), list.end(), [](int value) { return value == 2; }));
+
+			node_index<std::forward_list<int>::iterator> empty;
+			Assert::IsTrue(empty.begin() == empty.end());
+		}
+	};
+} // namespace ParallelSTL_Tests
@@ -88,6 +88,27 @@ namespace ParallelSTL_Tests
 			}
 		}
 
+		TEST_METHOD(NthElementLarge)
+		{
+			// Large enough for the sampled pivots, with many equal values
+			const size_t size = 1 << 20;
+			std::vector<int> numbers(size);
+			for (size_t i = 0; i < size; ++i)
+				numbers[i] = static_cast<int>((i * 2654435761u) % 1000);
+
+			auto sorted = numbers;
+			std::sort(std::begin(sorted), std::end(sorted));
+
+			for (size_t nth : { size_t{ 0 }, size / 3, size / 2, size - 1 })
+			{
+				auto values = numbers;
+				nth_element(par, std::begin(values), std::begin(values) + nth, std::end(values));
+				Assert::AreEqual(sorted[nth], values[nth]);
+				Assert::IsTrue(std::all_of(std::begin(values), std::begin(values) + nth, [&](int _Val) { return _Val <= values[nth]; }));
+				Assert::IsTrue(std::all_of(std::begin(values) + nth, std::end(values), [&](int _Val) { return _Val >= values[nth]; }));
+			}
+		}
+
 		TEST_METHOD(NthElementEdgeCases)
 		{
 			std::vector<int> vec_empty;
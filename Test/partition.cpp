@@ -102,6 +102,21 @@ namespace ParallelSTL_Tests
 			RunStablePartition<bidirectional_iterator_tag>();
 		}
 
+		TEST_METHOD(StablePartitionLarge)
+		{
+			// Large enough for the blocks of the buffered partition, the order is kept on both sides
+			std::vector<size_t> vec(1 << 18);
+			std::iota(std::begin(vec), std::end(vec), 0);
+
+			auto _Pred = [](size_t _Val) { return _Val * 2654435761u % 7 < 3; };
+			auto _Mid = stable_partition(par, std::begin(vec), std::end(vec), _Pred);
+
+			Assert::IsTrue(std::all_of(std::begin(vec), _Mid, _Pred));
+			Assert::IsTrue(std::none_of(_Mid, std::end(vec), _Pred));
+			Assert::IsTrue(std::is_sorted(std::begin(vec), _Mid));
+			Assert::IsTrue(std::is_sorted(_Mid, std::end(vec)));
+		}
+
 		TEST_METHOD(StablePartitionEdgeCases)
 		{
 			std::vector<int> vec_empty;
@@ -207,5 +222,26 @@ namespace ParallelSTL_Tests
 			Assert::IsTrue(std::begin(vec_true) == _Res.first);
 			Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec_false), _Res.second)) == vec.size());
 		}
+
+		// partition_copy of contiguous arithmetic ranges compacts the marked and the unmarked elements of a chunk
+		// a mark word at a time, a chunk may send none of its elements to one of the outputs
+		TEST_METHOD(PartitionCopyCompressed)
+		{
+			const size_t _Size = 100003;
+			std::vector<float> vec(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+				vec[_I] = _I < _Size / 2 ? static_cast<float>(_I % 5) : 10.f;
+
+			auto _Pred = [](float _Val) { return _Val > 2.f; };
+			std::vector<float> expected_true, expected_false;
+			std::partition_copy(std::begin(vec), std::end(vec), std::back_inserter(expected_true), std::back_inserter(expected_false), _Pred);
+
+			std::vector<float> vec_true(_Size), vec_false(expected_false.size());
+			auto _Res = partition_copy(par, std::begin(vec), std::end(vec), std::begin(vec_true), std::begin(vec_false), _Pred);
+			Assert::AreEqual(expected_true.size(), static_cast<size_t>(std::distance(std::begin(vec_true), _Res.first)));
+			Assert::IsTrue(_Res.second == std::end(vec_false));
+			Assert::IsTrue(std::equal(std::begin(expected_true), std::end(expected_true), std::begin(vec_true)));
+			Assert::IsTrue(vec_false == expected_false);
+		}
 	};
 } // namespace ParallelSTL_Tests
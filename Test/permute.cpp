@@ -0,0 +1,99 @@
+#include "stdafx.h"
+
+#include <deque>
+#include <random>
+#include <string>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(PermuteTest)
+	{
+		static vector<size_t> Shuffled(size_t _Size)
+		{
+			vector<size_t> _Indices(_Size);
+			std::iota(_Indices.begin(), _Indices.end(), size_t(0));
+			std::shuffle(_Indices.begin(), _Indices.end(), std::mt19937(11));
+			return _Indices;
+		}
+
+		template<typename _ExecutionPolicy>
+		static void GatherScatter(const _ExecutionPolicy& _Policy, size_t _Size)
+		{
+			const vector<size_t> _Indices = Shuffled(_Size);
+			vector<long long> _Src(_Size);
+			std::iota(_Src.begin(), _Src.end(), 1000ll);
+
+			vector<long long> _Gathered(_Size);
+			Assert::IsTrue(gather(_Policy, _Indices.begin(), _Indices.end(), _Src.begin(), _Gathered.begin()) == _Gathered.end());
+			for (size_t _I = 0; _I < _Size; ++_I)
+				Assert::AreEqual(_Src[_Indices[_I]], _Gathered[_I]);
+
+			// the scatter through the same indices undoes the gather
+			vector<long long> _Scattered(_Size);
+			scatter(_Policy, _Indices.begin(), _Indices.end(), _Gathered.begin(), _Scattered.begin());
+			Assert::IsTrue(_Src == _Scattered);
+		}
+
+	public:
+		TEST_METHOD(GatherScatterPolicies)
+		{
+			GatherScatter(seq, 1000);
+			GatherScatter(par, 100000);
+			GatherScatter(execution_policy(par), 12345);
+			GatherScatter(par.with(partitioner(static_)), 0);
+		}
+
+		TEST_METHOD(ScatterPartitioned)
+		{
+			// large enough for the scatter to be partitioned by index first
+			GatherScatter(par, 3 * 1000 * 1000 + 7);
+
+			// into a larger range, every other place
+			const size_t _Size = 1 << 20;
+			vector<unsigned int> _Indices(_Size), _Src(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+			{
+				_Indices[_I] = static_cast<unsigned int>(2 * (_Size - 1 - _I));
+				_Src[_I] = static_cast<unsigned int>(_I);
+			}
+
+			vector<unsigned int> _Dest(2 * _Size, ~0u);
+			scatter(par, _Indices.begin(), _Indices.end(), _Src.begin(), _Dest.begin());
+			for (size_t _I = 0; _I < _Size; ++_I)
+			{
+				Assert::AreEqual(static_cast<unsigned int>(_Size - 1 - _I), _Dest[2 * _I]);
+				Assert::AreEqual(~0u, _Dest[2 * _I + 1]);
+			}
+		}
+
+		TEST_METHOD(ApplyPermutation)
+		{
+			const size_t _Size = 50000;
+			const vector<size_t> _Indices = Shuffled(_Size);
+
+			vector<string> _Values(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+				_Values[_I] = std::to_string(_I);
+
+			apply_permutation(par, _Values.begin(), _Values.end(), _Indices.begin());
+			for (size_t _I = 0; _I < _Size; ++_I)
+				Assert::AreEqual(std::to_string(_Indices[_I]), _Values[_I]);
+
+			// the order of sort_indices sorts the range
+			vector<int> _Keys(_Size);
+			std::generate(_Keys.begin(), _Keys.end(), std::mt19937(5));
+			vector<unsigned int> _Order(_Size);
+			sort_indices(par, _Keys.begin(), _Keys.end(), _Order.begin());
+			apply_permutation(par, _Keys.begin(), _Keys.end(), _Order.begin());
+			Assert::IsTrue(std::is_sorted(_Keys.begin(), _Keys.end()));
+
+			// without random access to contiguous storage, and sequentially
+			std::deque<int> _Deque(1000);
+			std::iota(_Deque.begin(), _Deque.end(), 0);
+			vector<size_t> _Backwards(1000);
+			std::iota(_Backwards.rbegin(), _Backwards.rend(), size_t(0));
+			apply_permutation(seq, _Deque.begin(), _Deque.end(), _Backwards.begin());
+			Assert::IsTrue(std::is_sorted(_Deque.begin(), _Deque.end(), std::greater<int>()));
+		}
+	};
+} // namespace ParallelSTL_Tests
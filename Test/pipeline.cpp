@@ -0,0 +1,81 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(PipelineTest)
+	{
+	public:
+		TEST_METHOD(PipelineInOrder)
+		{
+			int _Next = 0;
+			std::vector<int> _Out;
+
+			parallel_pipeline(8,
+				make_filter<void, int>(filter_mode::serial_in_order, [&](flow_control& _Fc) {
+					if (_Next == 10000) {
+						_Fc.stop();
+						return 0;
+					}
+					return _Next++;
+				}) &
+				make_filter<int, std::string>(filter_mode::parallel, [](int _Val) { return std::to_string(_Val); }) &
+				make_filter<std::string, int>(filter_mode::serial_out_of_order, [](const std::string& _Str) { return std::stoi(_Str); }) &
+				make_filter<int, void>(filter_mode::serial_in_order, [&](int _Val) { _Out.push_back(_Val); }));
+
+			Assert::AreEqual(size_t(10000), _Out.size());
+			for (int _I = 0; _I < 10000; ++_I)
+				Assert::AreEqual(_I, _Out[_I]);
+		}
+
+		TEST_METHOD(PipelineTokens)
+		{
+			int _Next = 0;
+			std::atomic<int> _In_flight(0), _Max_in_flight(0);
+
+			parallel_pipeline(3,
+				make_filter<void, int>(filter_mode::serial_in_order, [&](flow_control& _Fc) {
+					if (_Next == 2000) {
+						_Fc.stop();
+						return 0;
+					}
+					int _Count = ++_In_flight;
+					int _Max = _Max_in_flight.load();
+					while (_Count > _Max && !_Max_in_flight.compare_exchange_weak(_Max, _Count));
+					return _Next++;
+				}) &
+				make_filter<int, void>(filter_mode::parallel, [&](int) { --_In_flight; }));
+
+			Assert::AreEqual(0, _In_flight.load());
+			Assert::IsTrue(_Max_in_flight.load() <= 3);
+		}
+
+		TEST_METHOD(PipelineException)
+		{
+			int _Next = 0;
+
+			try {
+				parallel_pipeline(4,
+					make_filter<void, int>(filter_mode::serial_in_order, [&](flow_control& _Fc) {
+						if (_Next == 1000)
+							_Fc.stop();
+						return _Next++;
+					}) &
+					make_filter<int, void>(filter_mode::parallel, [](int _Val) {
+						if (_Val == 500)
+							throw std::runtime_error("failed");
+					}));
+				Assert::Fail(L"The exception of the filter was not rethrown");
+			}
+			catch (const exception_list& _List) {
+				Assert::AreEqual(size_t(1), _List.size());
+			}
+
+			try {
+				parallel_pipeline(0, make_filter<void, void>(filter_mode::parallel, [](flow_control& _Fc) { _Fc.stop(); }));
+				Assert::Fail(L"No token was accepted");
+			}
+			catch (const std::invalid_argument&) {
+			}
+		}
+	};
+}
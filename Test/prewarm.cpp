@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(prewarm_tests)
+	{
+	public:
+		TEST_METHOD(Prewarm_Default_Arena)
+		{
+			const unsigned int workers = prewarm(2);
+			Assert::IsTrue(workers >= 2);
+
+			// the prewarmed workers stay parked past the idle timeout
+			Sleep(2500);
+			Assert::IsTrue(prewarm(2) >= 2);
+
+			std::vector<long long> data(1 << 18);
+			std::iota(data.begin(), data.end(), 0ll);
+			const long long expected = static_cast<long long>(data.size()) * (data.size() - 1) / 2;
+			Assert::AreEqual(expected, reduce(par, data.begin(), data.end(), 0ll));
+
+			shutdown();
+			Assert::AreEqual(size_t(0), scratch_cache_retained_bytes());
+		}
+
+		TEST_METHOD(Prewarm_After_Shutdown)
+		{
+			std::vector<int> data(100000);
+			for (int round = 0; round < 3; ++round)
+			{
+				prewarm(0);
+				for_each(par, data.begin(), data.end(), [](int& v) { ++v; });
+				shutdown();
+
+				// the next call starts over without a prewarm
+				for_each(par, data.begin(), data.end(), [](int& v) { ++v; });
+				shutdown();
+			}
+			Assert::IsTrue(std::all_of(data.begin(), data.end(), [](int v) { return v == 6; }));
+		}
+
+		TEST_METHOD(Prewarm_Task_Arena)
+		{
+			std::vector<int> data(100000);
+			{
+				task_arena arena(2);
+				const unsigned int workers = arena.execute([] { return prewarm(8); });
+				Assert::IsTrue(workers <= 2);
+
+				arena.execute([&] {
+					for_each(par, data.begin(), data.end(), [](int& v) { ++v; });
+				});
+
+				// leaves the pool threads of the arena alone
+				shutdown();
+				arena.execute([&] {
+					for_each(par, data.begin(), data.end(), [](int& v) { ++v; });
+				});
+			}
+			Assert::IsTrue(std::all_of(data.begin(), data.end(), [](int v) { return v == 2; }));
+		}
+	};
+} // namespace ParallelSTL_Tests
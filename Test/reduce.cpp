@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <list>
 
 namespace ParallelSTL_Tests
 {
@@ -163,6 +164,51 @@ namespace ParallelSTL_Tests
 			Assert::AreEqual(_Val, int{ 55 });
 		}
 
+		TEST_METHOD(ReduceVectorLanes)
+		{
+			// the lanes and the tail of par_vec cover every element once, whatever the size
+			for (size_t _Size : { 1, 3, 4, 7, 8, 9, 15, 16, 17, 1000, 100003 })
+			{
+				std::vector<long long> _Vec(_Size);
+				std::iota(std::begin(_Vec), std::end(_Vec), 1ll);
+
+				const long long _Expected = static_cast<long long>(_Size) * (_Size + 1) / 2 + 5;
+				Assert::AreEqual(_Expected, reduce(par_vec, std::begin(_Vec), std::end(_Vec), 5ll));
+				Assert::AreEqual(_Expected, reduce(par_vec, _Vec.data(), _Vec.data() + _Size, 5ll));
+			}
+		}
+
+		TEST_METHOD(TransformReduce)
+		{
+			for (size_t _Size : { 0, 1, 7, 8, 17, 1000, 100003 })
+			{
+				std::vector<long long> _X(_Size), _Y(_Size);
+				std::iota(std::begin(_X), std::end(_X), 1ll);
+				std::iota(std::begin(_Y), std::end(_Y), -50ll);
+				std::list<long long> _List(std::begin(_Y), std::end(_Y));
+
+				const long long _Dot = std::inner_product(std::begin(_X), std::end(_X), std::begin(_Y), 3ll);
+				long long _Norm = 3;
+				for (auto _Val : _X)
+					_Norm += _Val * _Val;
+
+				auto _Square = [](long long _Val) { return _Val * _Val; };
+
+				Assert::AreEqual(_Norm, transform_reduce(seq, std::begin(_X), std::end(_X), 3ll, std::plus<>(), _Square));
+				Assert::AreEqual(_Norm, transform_reduce(par, std::begin(_X), std::end(_X), 3ll, std::plus<>(), _Square));
+				Assert::AreEqual(_Norm, transform_reduce(par_vec, std::begin(_X), std::end(_X), 3ll, std::plus<>(), _Square));
+				Assert::AreEqual(_Norm, transform_reduce(std::begin(_X), std::end(_X), 3ll, std::plus<>(), _Square));
+
+				Assert::AreEqual(_Dot, transform_reduce(seq, std::begin(_X), std::end(_X), std::begin(_Y), 3ll));
+				Assert::AreEqual(_Dot, transform_reduce(par, std::begin(_X), std::end(_X), std::begin(_Y), 3ll));
+				Assert::AreEqual(_Dot, transform_reduce(par_vec, _X.data(), _X.data() + _Size, _Y.data(), 3ll));
+				Assert::AreEqual(_Dot, transform_reduce(par, std::begin(_X), std::end(_X), std::begin(_List), 3ll, std::plus<>(), std::multiplies<>()));
+
+				Assert::AreEqual(_Dot, inner_product(par, std::begin(_X), std::end(_X), std::begin(_Y), 3ll));
+				Assert::AreEqual(_Dot, inner_product(par_vec, std::begin(_X), std::end(_X), std::begin(_List), 3ll, std::plus<>(), std::multiplies<>()));
+			}
+		}
+
 		TEST_METHOD(ReduceSequential)
 		{
 			{
@@ -216,5 +262,32 @@ namespace ParallelSTL_Tests
 				_Alg.set_result(reduce(_Alg.begin_in(), _Alg.end_in(), INITIAL_VALUE, _Alg.callback()));
 			}
 		}
+
+		TEST_METHOD(ReduceReproducible)
+		{
+			// Random access ranges combine their chunks in a fixed order, the floating point sums don't change between calls
+			std::vector<double> _Values(1000003);
+			for (size_t _I = 0; _I < _Values.size(); ++_I)
+				_Values[_I] = 1.0 / static_cast<double>(_I + 1) * ((_I % 3) == 0 ? -1e8 : 1.0);
+
+			const double _Par = reduce(par, std::begin(_Values), std::end(_Values), 0.0);
+			const double _Par_vec = reduce(par_vec, std::begin(_Values), std::end(_Values), 0.0);
+
+			for (int _Run = 0; _Run < 10; ++_Run) {
+				Assert::IsTrue(_Par == reduce(par, std::begin(_Values), std::end(_Values), 0.0));
+				Assert::IsTrue(_Par_vec == reduce(par_vec, std::begin(_Values), std::end(_Values), 0.0));
+			}
+
+			std::vector<int> _Ints(1000003);
+			std::iota(std::begin(_Ints), std::end(_Ints), -500000);
+			Assert::AreEqual(std::count_if(std::begin(_Ints), std::end(_Ints), [](int _Val) { return _Val % 7 == 0; }),
+				count_if(par, std::begin(_Ints), std::end(_Ints), [](int _Val) { return _Val % 7 == 0; }));
+
+			// Of equal elements min_element finds the first, minmax_element the first smallest and the last largest
+			std::vector<int> _Flat(100000, 5);
+			Assert::IsTrue(min_element(par, std::begin(_Flat), std::end(_Flat)) == std::begin(_Flat));
+			Assert::IsTrue(max_element(par, std::begin(_Flat), std::end(_Flat)) == std::begin(_Flat));
+			Assert::IsTrue(minmax_element(par, std::begin(_Flat), std::end(_Flat)) == std::minmax_element(std::begin(_Flat), std::end(_Flat)));
+		}
 	};
 } // namespace ParallelSTL_Tests
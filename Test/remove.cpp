@@ -165,5 +165,23 @@ namespace ParallelSTL_Tests
 			_Iter = remove_copy_if(par, std::begin(vec_data), std::end(vec_data), std::begin(vec_out), [](int _Val){ return _Val < 4 || _Val > 7; });
 			Assert::AreEqual(static_cast<size_t>(std::distance(std::begin(vec_out), _Iter)), size_t{ 4 });
 		}
+
+		// remove_if of a contiguous arithmetic range compacts the kept elements a mark word at a time, in place
+		TEST_METHOD(RemoveIfCompressed)
+		{
+			for (size_t _Size : { size_t{ 63 }, size_t{ 4096 }, size_t{ 100003 } }) {
+				std::vector<long long> vec(_Size);
+				for (size_t _I = 0; _I < _Size; ++_I)
+					vec[_I] = (_I / 500) % 2 == 0 ? static_cast<long long>(_I % 3) : 5;
+
+				auto _Pred = [](long long _Val) { return _Val == 0; };
+				std::vector<long long> expected(vec);
+				expected.erase(std::remove_if(std::begin(expected), std::end(expected), _Pred), std::end(expected));
+
+				auto _End = remove_if(par, std::begin(vec), std::end(vec), _Pred);
+				Assert::AreEqual(expected.size(), static_cast<size_t>(std::distance(std::begin(vec), _End)));
+				Assert::IsTrue(std::equal(std::begin(expected), std::end(expected), std::begin(vec)));
+			}
+		}
 	};
 }
@@ -50,6 +50,38 @@ namespace ParallelSTL_Tests
 			RunReverse<random_access_iterator_tag>();
 			RunReverse<bidirectional_iterator_tag>();		
 		}
+
+		template<typename _Ty>
+		void RunReverseBlocked(size_t _Size)
+		{
+			std::vector<_Ty> _Ct(_Size);
+			for (size_t _I = 0; _I < _Size; ++_I)
+				_Ct[_I] = static_cast<_Ty>(_I * 7 + 1);
+
+			std::vector<_Ty> _Expected(_Ct.rbegin(), _Ct.rend());
+
+			std::vector<_Ty> _Rev(_Ct);
+			reverse(par, std::begin(_Rev), std::end(_Rev));
+			Assert::IsTrue(_Rev == _Expected);
+
+			std::vector<_Ty> _Dest(_Size);
+			Assert::IsTrue(reverse_copy(par_vec, std::begin(_Ct), std::end(_Ct), std::begin(_Dest)) == std::end(_Dest));
+			Assert::IsTrue(_Dest == _Expected);
+		}
+
+		// Contiguous ranges of small trivially copyable types are reversed a vector at a time, odd sizes leave a middle element
+		TEST_METHOD(ReverseBlocked)
+		{
+			const size_t sizes[] = { 2, 17, 1001, 100003, 4000001 };
+
+			for (auto _Size : sizes) {
+				RunReverseBlocked<unsigned char>(_Size);
+				RunReverseBlocked<short>(_Size);
+				RunReverseBlocked<int>(_Size);
+				RunReverseBlocked<double>(_Size);
+				RunReverseBlocked<long long>(_Size);
+			}
+		}
 	}; // ReverseTest
 
 	TEST_CLASS(ReverseCopyTest)
@@ -153,6 +153,26 @@ namespace ParallelSTL_Tests
 			}
 		}
 
+		// Small rotates of trivially copyable contiguous ranges set their short side aside, the others take three blocked reverses
+		TEST_METHOD(RotateBlocked)
+		{
+			const size_t sizes[] = { 10, 1000, 100003, 4000001 };
+
+			for (auto _Size : sizes) {
+				std::vector<int> _Ct(_Size);
+				std::iota(std::begin(_Ct), std::end(_Ct), 0);
+
+				const size_t mids[] = { 1, 3, _Size / 3, _Size / 2, _Size - 3, _Size - 1 };
+				for (auto _Mid : mids) {
+					std::vector<int> _Expected(_Ct), _Rotated(_Ct);
+					std::rotate(std::begin(_Expected), std::begin(_Expected) + _Mid, std::end(_Expected));
+
+					Assert::IsTrue(rotate(par, std::begin(_Rotated), std::begin(_Rotated) + _Mid, std::end(_Rotated)) == std::begin(_Rotated) + (_Size - _Mid));
+					Assert::IsTrue(_Rotated == _Expected);
+				}
+			}
+		}
+
 		TEST_METHOD(Rotate)
 		{
 			RunRotate<random_access_iterator_tag>(false);
@@ -1,4 +1,6 @@
 #include "stdafx.h"
+#include <list>
+#include <string>
 
 namespace ParallelSTL_Tests
 {
@@ -55,6 +57,31 @@ namespace ParallelSTL_Tests
 		size_t _Init;
 	};
 
+	// x -> m * x + c modulo 2^64, composing them is associative but not commutative, so a scan
+	// that combines tiles out of order gives wrong results
+	struct Affine
+	{
+		unsigned long long m, c;
+
+		bool operator==(const Affine& _Other) const
+		{
+			return m == _Other.m && c == _Other.c;
+		}
+	};
+
+	inline Affine compose(const Affine& _First, const Affine& _Second)
+	{
+		return Affine{ _First.m * _Second.m, _First.c * _Second.m + _Second.c };
+	}
+
+	inline std::vector<Affine> affine_input(size_t _Size)
+	{
+		std::vector<Affine> _In(_Size);
+		for (size_t _I = 0; _I < _Size; ++_I)
+			_In[_I] = Affine{ (_I * 2654435761u) | 1, _I * 7 + 3 };
+		return _In;
+	}
+
 	TEST_CLASS(ExclusiveScanTest)
 	{
 		template<typename _IterCat, typename _IterCat2 = _IterCat>
@@ -129,6 +156,30 @@ namespace ParallelSTL_Tests
 			Assert::IsTrue(vec_out == expected);
 			Assert::IsTrue(_It == std::end(vec_out));
 		}
+
+		TEST_METHOD(ExclusiveScanLookback)
+		{
+			const auto _In = affine_input(100003);
+			const Affine _Init{ 1, 0 };
+			auto _Op = [](const Affine& _Left, const Affine& _Right) { return compose(_Left, _Right); };
+
+			std::vector<Affine> _Expected(_In.size());
+			Affine _Val = _Init;
+			for (size_t _I = 0; _I < _In.size(); ++_I)
+			{
+				_Expected[_I] = _Val;
+				_Val = compose(_Val, _In[_I]);
+			}
+
+			// small tiles make the tiles look back over several predecessors
+			for (size_t _Grain : { 1, 64, 5000, 0 })
+			{
+				std::vector<Affine> _Out(_In.size());
+				auto _It = exclusive_scan(par.with(grain(_Grain)), std::begin(_In), std::end(_In), std::begin(_Out), _Init, _Op);
+				Assert::IsTrue(_It == std::end(_Out));
+				Assert::IsTrue(_Out == _Expected);
+			}
+		}
 	};
 
 	TEST_CLASS(InclusiveScanTest)
@@ -205,5 +256,155 @@ namespace ParallelSTL_Tests
 			Assert::IsTrue(vec_out == expected);
 			Assert::IsTrue(_It == std::end(vec_out));
 		}
+
+		TEST_METHOD(InclusiveScanLookback)
+		{
+			const auto _In = affine_input(100003);
+			const Affine _Init{ 1, 0 };
+			auto _Op = [](const Affine& _Left, const Affine& _Right) { return compose(_Left, _Right); };
+
+			std::vector<Affine> _Expected(_In.size());
+			Affine _Val = _Init;
+			for (size_t _I = 0; _I < _In.size(); ++_I)
+			{
+				_Val = compose(_Val, _In[_I]);
+				_Expected[_I] = _Val;
+			}
+
+			for (size_t _Grain : { 1, 64, 5000, 0 })
+			{
+				std::vector<Affine> _Out(_In.size());
+				auto _It = inclusive_scan(par.with(grain(_Grain)), std::begin(_In), std::end(_In), std::begin(_Out), _Op, _Init);
+				Assert::IsTrue(_It == std::end(_Out));
+				Assert::IsTrue(_Out == _Expected);
+			}
+		}
+
+		TEST_METHOD(InclusiveScanThrow)
+		{
+			// the tiles after the one that throws stop looking back instead of waiting for it
+			std::vector<size_t> _In(100000, 1), _Out(_In.size());
+			try {
+				inclusive_scan(par.with(grain(64)), std::begin(_In), std::end(_In), std::begin(_Out), [](size_t _Left, size_t _Right) {
+					if (_Left == 50000)
+						throw std::runtime_error("scan");
+					return _Left + _Right;
+				}, size_t{ 0 });
+				Assert::Fail();
+			}
+			catch (exception_list& e) {
+				Assert::IsTrue(e.size() > 0);
+			}
+		}
+
+		TEST_METHOD(TransformScan)
+		{
+			// offsets of records from their lengths, without an array of the lengths
+			std::vector<std::string> _Records(100003);
+			for (size_t _I = 0; _I < _Records.size(); ++_I)
+				_Records[_I].assign(_I % 13, 'r');
+			std::list<std::string> _List(std::begin(_Records), std::end(_Records));
+
+			auto _Length = [](const std::string& _Rec) { return _Rec.size(); };
+
+			std::vector<size_t> _Exclusive(_Records.size()), _Inclusive(_Records.size());
+			size_t _Offset = 16;
+			for (size_t _I = 0; _I < _Records.size(); ++_I)
+			{
+				_Exclusive[_I] = _Offset;
+				_Offset += _Records[_I].size();
+				_Inclusive[_I] = _Offset;
+			}
+
+			for (size_t _Grain : { 1, 64, 5000, 0 })
+			{
+				std::vector<size_t> _Out(_Records.size());
+				auto _It = transform_exclusive_scan(par.with(grain(_Grain)), std::begin(_Records), std::end(_Records), std::begin(_Out), size_t{ 16 }, std::plus<>(), _Length);
+				Assert::IsTrue(_It == std::end(_Out));
+				Assert::IsTrue(_Out == _Exclusive);
+
+				std::fill(std::begin(_Out), std::end(_Out), 0);
+				_It = transform_inclusive_scan(par.with(grain(_Grain)), std::begin(_Records), std::end(_Records), std::begin(_Out), std::plus<>(), _Length, size_t{ 16 });
+				Assert::IsTrue(_It == std::end(_Out));
+				Assert::IsTrue(_Out == _Inclusive);
+			}
+
+			std::vector<size_t> _Out(_Records.size());
+			transform_exclusive_scan(seq, std::begin(_List), std::end(_List), std::begin(_Out), size_t{ 16 }, std::plus<>(), _Length);
+			Assert::IsTrue(_Out == _Exclusive);
+			transform_exclusive_scan(par, std::begin(_List), std::end(_List), std::begin(_Out), size_t{ 16 }, std::plus<>(), _Length);
+			Assert::IsTrue(_Out == _Exclusive);
+			transform_inclusive_scan(par_vec, std::begin(_List), std::end(_List), std::begin(_Out), std::plus<>(), _Length, size_t{ 16 });
+			Assert::IsTrue(_Out == _Inclusive);
+
+			// without an initial value the scan starts from the first transformed element
+			for (auto& _Val : _Inclusive)
+				_Val -= 16;
+			transform_inclusive_scan(par, std::begin(_Records), std::end(_Records), std::begin(_Out), std::plus<>(), _Length);
+			Assert::IsTrue(_Out == _Inclusive);
+			transform_inclusive_scan(std::begin(_Records), std::end(_Records), std::begin(_Out), std::plus<>(), _Length);
+			Assert::IsTrue(_Out == _Inclusive);
+		}
+	};
+
+	TEST_CLASS(ScanByKeyTest)
+	{
+		TEST_METHOD(ScanByKey)
+		{
+			// runs of 1 to 7 equal keys, long enough for every chunk to hold several segments
+			std::vector<int> _Keys(100003), _Values(_Keys.size());
+			for (size_t _I = 0, _Key = 0; _I < _Keys.size(); ++_Key)
+				for (size_t _Run = _Key % 7 + 1; _Run > 0 && _I < _Keys.size(); --_Run, ++_I)
+				{
+					_Keys[_I] = static_cast<int>(_Key % 3);
+					_Values[_I] = static_cast<int>(_I % 11);
+				}
+
+			std::vector<int> _Inclusive(_Keys.size()), _Exclusive(_Keys.size()), _Run_keys, _Run_sums;
+			for (size_t _I = 0; _I < _Keys.size(); ++_I)
+			{
+				const bool _Head = _I == 0 || _Keys[_I] != _Keys[_I - 1];
+				_Exclusive[_I] = _Head ? 5 : _Exclusive[_I - 1] + _Values[_I - 1];
+				_Inclusive[_I] = _Head ? _Values[_I] : _Inclusive[_I - 1] + _Values[_I];
+
+				if (_Head)
+				{
+					_Run_keys.push_back(_Keys[_I]);
+					_Run_sums.push_back(0);
+				}
+				_Run_sums.back() += _Values[_I];
+			}
+
+			std::vector<int> _Out(_Keys.size());
+			auto _It = inclusive_scan_by_key(par, std::begin(_Keys), std::end(_Keys), std::begin(_Values), std::begin(_Out));
+			Assert::IsTrue(_It == std::end(_Out));
+			Assert::IsTrue(_Out == _Inclusive);
+
+			std::fill(std::begin(_Out), std::end(_Out), 0);
+			_It = exclusive_scan_by_key(par_vec, std::begin(_Keys), std::end(_Keys), std::begin(_Values), std::begin(_Out), 5);
+			Assert::IsTrue(_It == std::end(_Out));
+			Assert::IsTrue(_Out == _Exclusive);
+
+			std::vector<int> _Keys_out(_Keys.size()), _Sums_out(_Keys.size());
+			auto _Ends = reduce_by_key(par, std::begin(_Keys), std::end(_Keys), std::begin(_Values), std::begin(_Keys_out), std::begin(_Sums_out));
+			Assert::IsTrue(std::vector<int>(std::begin(_Keys_out), _Ends.first) == _Run_keys);
+			Assert::IsTrue(std::vector<int>(std::begin(_Sums_out), _Ends.second) == _Run_sums);
+
+			// forward iterators go through the same pipeline
+			std::list<int> _Key_list(std::begin(_Keys), std::end(_Keys)), _Value_list(std::begin(_Values), std::end(_Values));
+			std::list<int> _Out_list(_Keys.size());
+			inclusive_scan_by_key(par, std::begin(_Key_list), std::end(_Key_list), std::begin(_Value_list), std::begin(_Out_list));
+			Assert::IsTrue(std::equal(std::begin(_Out_list), std::end(_Out_list), std::begin(_Inclusive)));
+
+			std::fill(std::begin(_Sums_out), std::end(_Sums_out), 0);
+			_Ends = reduce_by_key(seq, std::begin(_Keys), std::end(_Keys), std::begin(_Values), std::begin(_Keys_out), std::begin(_Sums_out));
+			Assert::IsTrue(std::vector<int>(std::begin(_Sums_out), _Ends.second) == _Run_sums);
+
+			// a single element is a segment of its own
+			int _Key = 4, _Value = 9, _Key_res = 0, _Value_res = 0;
+			reduce_by_key(par, &_Key, &_Key + 1, &_Value, &_Key_res, &_Value_res);
+			Assert::AreEqual(4, _Key_res);
+			Assert::AreEqual(9, _Value_res);
+		}
 	};
 } // namespace ParallelSTL_Tests
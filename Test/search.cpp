@@ -186,6 +186,43 @@ namespace ParallelSTL_Tests
 			Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(vec), _It)) == _Pos);		
 		}
 
+		// Long byte needles skip through the range with a table, a searcher keeps its table for many searches
+		TEST_METHOD(SearchLongNeedle)
+		{
+			const size_t COLLECTION_SIZE = 100000;
+			const size_t NEEDLE_SIZE = 128;
+
+			std::string hay(COLLECTION_SIZE, 'a');
+			for (size_t i = 0; i < COLLECTION_SIZE; ++i)
+				hay[i] = static_cast<char>('a' + (i * 7 + i / 13) % 4);
+
+			std::string needle = hay.substr(5000, NEEDLE_SIZE);
+			needle[NEEDLE_SIZE - 1] = 'z';
+
+			auto searcher = make_boyer_moore_horspool_searcher(std::begin(needle), std::end(needle));
+			Assert::IsTrue(search(par, std::begin(hay), std::end(hay), searcher) == std::end(hay));
+			Assert::IsTrue(search(par, std::begin(hay), std::end(hay), std::begin(needle), std::end(needle)) == std::end(hay));
+
+			const size_t positions[] = { 0, 1, 4095, 31337, COLLECTION_SIZE / 2, COLLECTION_SIZE - NEEDLE_SIZE };
+			for (auto _Pos : positions) {
+				std::string text = hay;
+				std::copy(std::begin(needle), std::end(needle), std::begin(text) + _Pos);
+				std::copy(std::begin(needle), std::end(needle), std::end(text) - NEEDLE_SIZE); // Later match must not win
+
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(text), search(par, std::begin(text), std::end(text), searcher))) == _Pos);
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(text), search(par_vec, std::begin(text), std::end(text), searcher))) == _Pos);
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(text), search(seq, std::begin(text), std::end(text), searcher))) == _Pos);
+				Assert::IsTrue(static_cast<size_t>(std::distance(std::begin(text), search(par, std::begin(text), std::end(text), std::begin(needle), std::end(needle)))) == _Pos);
+				Assert::IsTrue(searcher(std::begin(text), std::end(text)).first == std::search(std::begin(text), std::end(text), std::begin(needle), std::end(needle)));
+			}
+
+			// The table of other types is a hash table
+			std::vector<int> ints(std::begin(hay), std::end(hay));
+			std::vector<int> int_needle(std::begin(hay) + 777, std::begin(hay) + 777 + NEEDLE_SIZE);
+			auto int_searcher = make_boyer_moore_horspool_searcher(std::begin(int_needle), std::end(int_needle));
+			Assert::IsTrue(search(par, std::begin(ints), std::end(ints), int_searcher) == std::search(std::begin(ints), std::end(ints), std::begin(int_needle), std::end(int_needle)));
+		}
+
 		TEST_METHOD(SearchNOnChunkBorders)
 		{
 			const int COLLECTION_SIZE = 1024;
@@ -3,6 +3,7 @@
 #include <numeric>
 #include <iostream>
 #include <ctime>
+#include <string>
 
 using namespace std;
 namespace ParallelSTL_Tests
@@ -135,6 +136,49 @@ namespace ParallelSTL_Tests
 			genericSetOperationTest(par, b.begin(), b.end(), c.begin(), c.end(), 2001);
 
 		}
+
+		TEST_METHOD(sparseSetOperationsTest)
+		{
+			// The first range is sparse, most values of the second fall between the chunks of the first
+			vector<int> a(200), b(5000);
+			generate(a.begin(), a.end(), [] { return (std::rand() % 100) * 50; });
+			generate(b.begin(), b.end(), [] { return std::rand() % 5000; });
+			sort(a.begin(), a.end());
+			sort(b.begin(), b.end());
+			genericSetOperationTest(par, a.begin(), a.end(), b.begin(), b.end(), a.size() + b.size());
+			genericSetOperationTest(par, b.begin(), b.end(), a.begin(), a.end(), a.size() + b.size());
+
+			// Values that are not trivially copyable are counted first and written straight to the output
+			vector<string> c(a.size()), d(b.size());
+			transform(a.begin(), a.end(), c.begin(), [](int _Val) { return to_string(_Val); });
+			transform(b.begin(), b.end(), d.begin(), [](int _Val) { return to_string(_Val); });
+			sort(c.begin(), c.end());
+			sort(d.begin(), d.end());
+			genericSetOperationTest(par, c.begin(), c.end(), d.begin(), d.end(), c.size() + d.size());
+			genericSetOperationTest(par, d.begin(), d.end(), c.begin(), c.end(), c.size() + d.size());
+		}
+		TEST_METHOD(skewedSetOperationsTest)
+		{
+			// One range is hundreds of times the size of the other, the chunks gallop over the large one
+			vector<int> a(300), b(200000);
+			generate(a.begin(), a.end(), [] { return std::rand() % 400000; });
+			for (size_t i = 0; i < b.size(); i++)
+				b[i] = static_cast<int>(2 * i + (std::rand() % 2));
+			a.insert(a.end(), 50, 1000); // equal values more often in one range than in the other
+			b.insert(b.end(), 20, 1000);
+			sort(a.begin(), a.end());
+			sort(b.begin(), b.end());
+			genericSetOperationTest(par, a.begin(), a.end(), b.begin(), b.end(), a.size() + b.size());
+			genericSetOperationTest(par, b.begin(), b.end(), a.begin(), a.end(), a.size() + b.size());
+
+			vector<string> c(a.size()), d(b.size());
+			transform(a.begin(), a.end(), c.begin(), [](int _Val) { return to_string(_Val); });
+			transform(b.begin(), b.end(), d.begin(), [](int _Val) { return to_string(_Val); });
+			sort(c.begin(), c.end());
+			sort(d.begin(), d.end());
+			genericSetOperationTest(par, c.begin(), c.end(), d.begin(), d.end(), c.size() + d.size());
+			genericSetOperationTest(par, d.begin(), d.end(), c.begin(), c.end(), c.size() + d.size());
+		}
 	};
 
 } // namespace ParallelSTL_Tests
@@ -1,5 +1,15 @@
 #include "stdafx.h"
 
+#include <atomic>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <deque>
+#include <forward_list>
+#include <list>
+#include <random>
+#include <string>
+
 namespace ParallelSTL_Tests
 {
 	template<typename _ExecutionPolicy>
@@ -48,6 +58,47 @@ namespace ParallelSTL_Tests
 		Assert::IsTrue(numbers[midPos - 1] <= *std::min_element(numbers.begin() + midPos, numbers.end()));
 	}
 
+	// Large ranges of arithmetic values under std::less or std::greater take the radix sort
+	template<typename _Ty, typename _Pr>
+	void RadixSortImpl(std::vector<_Ty> numbers, _Pr _Pred)
+	{
+		auto expected = numbers;
+		std::sort(expected.begin(), expected.end(), _Pred);
+
+		sort(par, numbers.begin(), numbers.end(), _Pred);
+		Assert::IsTrue(numbers == expected);
+	}
+
+	// Counts the copies of its values, the moves leave a value empty
+	struct copy_counted
+	{
+		static std::atomic<size_t> copies;
+
+		size_t key;
+		std::string tag;
+
+		copy_counted(size_t k, std::string t) : key(k), tag(std::move(t)) {}
+		copy_counted(const copy_counted& other) : key(other.key), tag(other.tag) { ++copies; }
+		copy_counted(copy_counted&& other) noexcept : key(other.key), tag(std::move(other.tag)) {}
+
+		copy_counted& operator=(const copy_counted& other)
+		{
+			key = other.key;
+			tag = other.tag;
+			++copies;
+			return *this;
+		}
+
+		copy_counted& operator=(copy_counted&& other) noexcept
+		{
+			key = other.key;
+			tag = std::move(other.tag);
+			return *this;
+		}
+	};
+
+	std::atomic<size_t> copy_counted::copies;
+
 	TEST_CLASS(sort_tests)
 	{
 		TEST_METHOD(Sort)
@@ -55,6 +106,120 @@ namespace ParallelSTL_Tests
 			SortImpl(seq);
 			SortImpl(par);
 			SortImpl(par_vec);
+			SortImpl(par.with(grain(256), max_threads(2)));
+		}
+
+		TEST_METHOD(SortRadix)
+		{
+			const size_t size = 200000 + rand() % 1000;
+			std::mt19937 gen(static_cast<unsigned int>(size));
+
+			vector<int> ints(size);
+			std::generate(ints.begin(), ints.end(), [&] { return static_cast<int>(gen()); });
+			RadixSortImpl(ints, std::less<>());
+			RadixSortImpl(ints, std::greater<int>());
+
+			// All the values share their high bytes, those passes are skipped
+			vector<unsigned int> narrow(size);
+			std::generate(narrow.begin(), narrow.end(), [&] { return gen() % 100; });
+			RadixSortImpl(narrow, std::less<unsigned int>());
+
+			vector<uint64_t> wide(size);
+			std::generate(wide.begin(), wide.end(), [&] { return (static_cast<uint64_t>(gen()) << 32) | gen(); });
+			RadixSortImpl(wide, std::greater<>());
+
+			vector<float> floats(size);
+			std::generate(floats.begin(), floats.end(), [&] { return static_cast<float>(static_cast<int>(gen() % 20001) - 10000) / 7.0f; });
+			RadixSortImpl(floats, std::less<>());
+
+			vector<double> doubles(size);
+			std::generate(doubles.begin(), doubles.end(), [&] { return std::ldexp(static_cast<double>(static_cast<int>(gen())), static_cast<int>(gen() % 200) - 100); });
+			RadixSortImpl(doubles, std::greater<double>());
+
+			vector<short> shorts(size, -3);
+			RadixSortImpl(shorts, std::less<>());
+		}
+
+		// On 16 cores or more, large ranges sorted with a comparator take the sample sort
+		TEST_METHOD(SortVectorLeaves)
+		{
+			// Too small for the radix sort, the leaves of the quicksort and of the stable_sort are sorted by networks
+			std::mt19937 gen(17);
+			const size_t sizes[] = { 3000, 20000, 60000 };
+			for (auto size : sizes)
+			{
+				vector<int> ints(size);
+				std::generate(ints.begin(), ints.end(), [&] { return static_cast<int>(gen() % 4 == 0 ? gen() % 16 : gen()); });
+				ints[0] = INT_MIN;
+				ints[1] = INT_MAX;
+
+				auto expected = ints;
+				std::sort(expected.begin(), expected.end());
+				auto numbers = ints;
+				sort(par.with(grain(1000)), numbers.begin(), numbers.end());
+				Assert::IsTrue(numbers == expected);
+
+				numbers = ints;
+				stable_sort(par.with(grain(1000)), numbers.begin(), numbers.end(), std::less<int>());
+				Assert::IsTrue(numbers == expected);
+
+				// descending, and unsigned around the sign bit
+				vector<unsigned int> unsigned_ints(ints.begin(), ints.end());
+				vector<unsigned int> unsigned_expected = unsigned_ints;
+				std::sort(unsigned_expected.begin(), unsigned_expected.end(), std::greater<unsigned int>());
+				sort(par.with(grain(777)), unsigned_ints.begin(), unsigned_ints.end(), std::greater<>());
+				Assert::IsTrue(unsigned_ints == unsigned_expected);
+			}
+		}
+
+		TEST_METHOD(SortSample)
+		{
+			const size_t size = (1 << 20) + rand() % 1000;
+			std::mt19937 gen(static_cast<unsigned int>(size));
+			auto less = [](const pair<int, int>& left, const pair<int, int>& right) { return left < right; };
+
+			vector<pair<int, int>> numbers(size);
+			std::generate(numbers.begin(), numbers.end(), [&] { return make_pair(static_cast<int>(gen()), static_cast<int>(gen())); });
+			sort(par, numbers.begin(), numbers.end(), less);
+			Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
+
+			// A few distinct values, most buckets stay empty and one holds many copies
+			std::generate(numbers.begin(), numbers.end(), [&] { return make_pair(static_cast<int>(gen() % 3), 0); });
+			sort(par, numbers.begin(), numbers.end(), less);
+			Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
+		}
+
+		TEST_METHOD(SortPresorted)
+		{
+			const size_t size = 100000 + rand() % 1000;
+			auto less = [](int left, int right) { return left < right; };
+
+			vector<int> numbers(size);
+			std::iota(numbers.begin(), numbers.end(), 0);
+			sort(par, numbers.begin(), numbers.end(), less);
+			Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
+
+			std::iota(numbers.rbegin(), numbers.rend(), 0);
+			sort(par, numbers.begin(), numbers.end(), less);
+			Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
+
+			// Interleaved ascending runs are merged
+			const size_t runs[] = { 2, 5, 16, 17 };
+			for (auto run_count : runs)
+			{
+				for (size_t i = 0; i < size; ++i)
+					numbers[i] = static_cast<int>((i % (size / run_count)) * run_count + i / (size / run_count));
+
+				sort(par, numbers.begin(), numbers.end(), less);
+				Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
+			}
+
+			// Organ pipe, its splits are uneven until the patterns are broken
+			for (size_t i = 0; i < size; ++i)
+				numbers[i] = static_cast<int>((std::min)(i, size - i));
+
+			sort(par, numbers.begin(), numbers.end(), less);
+			Assert::IsTrue(std::is_sorted(numbers.begin(), numbers.end()));
 		}
 
 		TEST_METHOD(StableSort)
@@ -62,6 +227,154 @@ namespace ParallelSTL_Tests
 			StableSortImpl(seq);
 			StableSortImpl(par);
 			StableSortImpl(par_vec);
+			StableSortImpl(par.with(grain(256), max_threads(2)));
+		}
+
+		TEST_METHOD(StableSortScratch)
+		{
+			// No default constructor, the scratch holds moved-from values while the sort runs
+			struct record
+			{
+				size_t key;
+				std::string tag;
+
+				record(size_t k, std::string t) : key(k), tag(std::move(t)) {}
+			};
+
+			vector<record> records;
+			for (size_t i = 0; i < 100000; ++i)
+				records.emplace_back((i * 2654435761u) % 97, std::to_string(i));
+
+			auto by_key = [](const record& left, const record& right) { return left.key < right.key; };
+			auto expected = records;
+			std::stable_sort(expected.begin(), expected.end(), by_key);
+
+			sort_buffer<record> buffer;
+			for (int run = 0; run < 2; ++run)
+			{
+				auto numbers = records;
+				stable_sort(par, numbers.begin(), numbers.end(), by_key, buffer);
+				Assert::IsTrue(std::equal(numbers.begin(), numbers.end(), expected.begin(),
+					[](const record& left, const record& right) { return left.tag == right.tag; }));
+			}
+
+			Assert::IsTrue(buffer.capacity() >= records.size());
+		}
+
+		TEST_METHOD(StableSortMoves)
+		{
+			// The merges between the range and the scratch move the values, none of them is copied
+			vector<copy_counted> records;
+			for (size_t i = 0; i < 200000; ++i)
+				records.emplace_back((i * 2654435761u) % 1009, std::to_string(i));
+
+			auto by_key = [](const copy_counted& left, const copy_counted& right) { return left.key < right.key; };
+			auto expected = records;
+			std::stable_sort(expected.begin(), expected.end(), by_key);
+
+			copy_counted::copies = 0;
+			stable_sort(par, records.begin(), records.end(), by_key);
+			Assert::AreEqual(size_t(0), copy_counted::copies.load());
+			Assert::IsTrue(std::equal(records.begin(), records.end(), expected.begin(),
+				[](const copy_counted& left, const copy_counted& right) { return left.tag == right.tag; }));
+
+			// and so do the parallel merges in place
+			std::rotate(records.begin(), records.begin() + records.size() / 3, records.end());
+			copy_counted::copies = 0;
+			inplace_merge(par, records.begin(), records.begin() + (records.size() - records.size() / 3), records.end(), by_key);
+			Assert::AreEqual(size_t(0), copy_counted::copies.load());
+			Assert::IsTrue(std::is_sorted(records.begin(), records.end(), by_key));
+		}
+
+		TEST_METHOD(SortByKey)
+		{
+			const size_t size = 50000;
+			vector<int> keys(size), values(size);
+			for (size_t i = 0; i < size; ++i)
+			{
+				keys[i] = static_cast<int>((i * 2654435761u) % 1000);
+				values[i] = static_cast<int>(i);
+			}
+
+			vector<size_t> expected(size);
+			std::iota(expected.begin(), expected.end(), 0);
+			std::stable_sort(expected.begin(), expected.end(), [&keys](size_t left, size_t right) { return keys[left] < keys[right]; });
+
+			vector<size_t> indices(size);
+			Assert::IsTrue(sort_indices(par, keys.begin(), keys.end(), indices.begin()) == indices.end());
+			Assert::IsTrue(indices == expected);
+
+			sort_by_key(par, keys.begin(), keys.end(), values.begin());
+			Assert::IsTrue(std::is_sorted(keys.begin(), keys.end()));
+			for (size_t i = 0; i < size; ++i)
+				Assert::AreEqual(static_cast<int>(expected[i]), values[i]);
+		}
+
+		TEST_METHOD(SortStrings)
+		{
+			// Long common prefixes, prefixes of each other, embedded zeros and duplicates
+			std::mt19937 gen(17);
+			const string prefixes[] = { "", "http://www.example.com/", "http://www.example.com/index/", string("a\0b", 3) };
+			vector<string> strings(100000);
+			for (auto& value : strings)
+			{
+				value = prefixes[gen() % 4];
+				for (size_t length = gen() % 24; length > 0; --length)
+					value += static_cast<char>('a' + gen() % 3);
+				if (gen() % 8 == 0)
+					value += static_cast<char>(0x80 + gen() % 8);
+			}
+
+			auto expected = strings;
+			std::sort(expected.begin(), expected.end());
+			auto numbers = strings;
+			sort(par, numbers.begin(), numbers.end());
+			Assert::IsTrue(numbers == expected);
+
+			numbers = strings;
+			sort(par.with(grain(64)), numbers.begin(), numbers.end(), std::less<string>());
+			Assert::IsTrue(numbers == expected);
+
+			vector<wstring> wide(strings.size());
+			for (size_t i = 0; i < strings.size(); ++i)
+				wide[i] = wstring(strings[i].begin(), strings[i].end()) + static_cast<wchar_t>(0xd800 + i % 4);
+			auto wide_expected = wide;
+			std::sort(wide_expected.begin(), wide_expected.end());
+			sort(par, wide.begin(), wide.end());
+			Assert::IsTrue(wide == wide_expected);
+		}
+
+		TEST_METHOD(SortStringsDeep)
+		{
+			// A long shared prefix, strings that are prefixes of each other one after the other, and pairs that
+			// split off at every depth. Each character level recursing once would overflow the stack.
+			std::mt19937 gen(23);
+			const string prefix(100000, 'x');
+			vector<string> shared(2000);
+			for (auto& value : shared)
+				value = prefix + std::to_string(gen() % 500);
+
+			vector<string> chain;
+			for (size_t length = 0; length < 5000; ++length)
+				chain.push_back(string(length, 'a'));
+			std::shuffle(chain.begin(), chain.end(), gen);
+
+			vector<string> branching;
+			for (size_t depth = 0; depth < 1000; ++depth)
+			{
+				branching.push_back(string(8 * depth, 'a') + "b");
+				branching.push_back(string(8 * depth, 'a') + "c");
+				branching.push_back(string(8 * depth, 'a') + "c");
+			}
+			std::shuffle(branching.begin(), branching.end(), gen);
+
+			for (auto strings : { shared, chain, branching })
+			{
+				auto expected = strings;
+				std::sort(expected.begin(), expected.end());
+				sort(par.with(grain(64)), strings.begin(), strings.end());
+				Assert::IsTrue(strings == expected);
+			}
 		}
 
 		TEST_METHOD(PartialSort)
@@ -69,6 +382,71 @@ namespace ParallelSTL_Tests
 			PartialSortImpl(seq);
 			PartialSortImpl(par);
 			PartialSortImpl(par_vec);
+			PartialSortImpl(par.with(grain(256), max_threads(2)));
+		}
+
+		TEST_METHOD(PartialSortTopK)
+		{
+			// A few values out of a large range are selected with bounded heaps
+			const size_t size = 1 << 20, k = 100;
+			vector<int> numbers(size);
+			for (size_t i = 0; i < size; ++i)
+				numbers[i] = static_cast<int>((i * 2654435761u) % 100000);
+
+			auto expected = numbers;
+			std::sort(expected.begin(), expected.end(), std::greater<int>());
+
+			vector<int> best(k);
+			Assert::IsTrue(partial_sort_copy(par, numbers.begin(), numbers.end(), best.begin(), best.end(), std::greater<int>()) == best.end());
+			Assert::IsTrue(std::equal(best.begin(), best.end(), expected.begin()));
+
+			partial_sort(par, numbers.begin(), numbers.begin() + k, numbers.end(), std::greater<int>());
+			Assert::IsTrue(std::equal(numbers.begin(), numbers.begin() + k, expected.begin()));
+
+			std::sort(numbers.begin(), numbers.end(), std::greater<int>());
+			Assert::IsTrue(numbers == expected);
+		}
+
+		TEST_METHOD(SortWithoutRandomAccess)
+		{
+			const size_t size = 20000;
+			vector<pair<int, size_t>> expected(size);
+			for (size_t i = 0; i < size; ++i)
+				expected[i] = make_pair(static_cast<int>((i * 2654435761u) % 500), i);
+
+			auto by_first = [](const pair<int, size_t>& left, const pair<int, size_t>& right) { return left.first < right.first; };
+
+			std::list<pair<int, size_t>> nodes(expected.begin(), expected.end());
+			std::forward_list<pair<int, size_t>> links(expected.begin(), expected.end());
+			std::deque<pair<int, size_t>> blocks(expected.begin(), expected.end());
+			std::stable_sort(expected.begin(), expected.end(), by_first);
+
+			// the elements are moved through pointers
+			stable_sort(par, nodes.begin(), nodes.end(), by_first);
+			Assert::IsTrue(std::equal(nodes.begin(), nodes.end(), expected.begin()));
+
+			stable_sort(par, links.begin(), links.end(), by_first);
+			Assert::IsTrue(std::equal(links.begin(), links.end(), expected.begin()));
+
+			stable_sort(par_vec, blocks.begin(), blocks.end(), by_first);
+			Assert::IsTrue(std::equal(blocks.begin(), blocks.end(), expected.begin()));
+
+			sort(seq, links.begin(), links.end(), std::greater<pair<int, size_t>>());
+			Assert::IsTrue(std::is_sorted(links.begin(), links.end(), std::greater<pair<int, size_t>>()));
+
+			sort(par, links.begin(), links.end());
+			Assert::IsTrue(std::is_sorted(links.begin(), links.end()));
+
+			// the nodes are relinked
+			std::reverse(nodes.begin(), nodes.end());
+			const pair<int, size_t> *node = &nodes.front();
+			const pair<int, size_t> value = *node;
+			stable_sort(par, nodes, by_first);
+			Assert::IsTrue(std::equal(nodes.begin(), nodes.end(), expected.begin(), [](const pair<int, size_t>& left, const pair<int, size_t>& right) { return left.first == right.first; }));
+			Assert::IsTrue(&*std::find(nodes.begin(), nodes.end(), value) == node);
+
+			sort(par.with(grain(256), max_threads(2)), nodes, std::greater<pair<int, size_t>>());
+			Assert::IsTrue(std::is_sorted(nodes.begin(), nodes.end(), std::greater<pair<int, size_t>>()));
 		}
 	};
 
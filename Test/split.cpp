@@ -0,0 +1,88 @@
+#include "stdafx.h"
+
+#include <deque>
+#include <random>
+#include <string>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(SplitTest)
+	{
+		// The offsets of the delimiters out of quotes, one element at a time
+		template<typename _It, typename _Ty>
+		static vector<size_t> Expected(_It _First, _It _Last, _Ty _Delim, _Ty _Quote, bool _Quoted)
+		{
+			vector<size_t> _Offsets;
+			bool _In_quotes = false;
+			for (size_t _I = 0; _First != _Last; ++_First, ++_I)
+			{
+				if (_Quoted && *_First == _Quote)
+					_In_quotes = !_In_quotes;
+				else if (!_In_quotes && *_First == _Delim)
+					_Offsets.push_back(_I);
+			}
+			return _Offsets;
+		}
+
+		template<typename _ExecutionPolicy>
+		static void CheckSplit(const _ExecutionPolicy& _Policy, const string& _Text)
+		{
+			vector<size_t> _Offsets(_Text.size());
+			auto _End = split(_Policy, _Text.begin(), _Text.end(), '\n', _Offsets.begin());
+			_Offsets.erase(_End, _Offsets.end());
+			Assert::IsTrue(Expected(_Text.begin(), _Text.end(), '\n', '"', false) == _Offsets);
+
+			_Offsets.assign(_Text.size(), 0);
+			_End = split(_Policy, _Text.begin(), _Text.end(), ',', '"', _Offsets.begin());
+			_Offsets.erase(_End, _Offsets.end());
+			Assert::IsTrue(Expected(_Text.begin(), _Text.end(), ',', '"', true) == _Offsets);
+		}
+
+		// Lines of fields, some of them quoted with delimiters, escaped quotes and line breaks in them
+		static string Csv(size_t _Lines)
+		{
+			std::mt19937 _Gen(3);
+			const char *_Fields[] = { "plain", "\"a,b\"", "\"say \"\"hi\"\", ok\"", "\"two\nlines\"", "", "12345" };
+			string _Text;
+			for (size_t _Line = 0; _Line < _Lines; ++_Line)
+			{
+				const size_t _Count = 1 + _Gen() % 6;
+				for (size_t _Field = 0; _Field < _Count; ++_Field)
+				{
+					if (_Field != 0)
+						_Text += ',';
+					_Text += _Fields[_Gen() % 6];
+				}
+				_Text += '\n';
+			}
+			return _Text;
+		}
+
+	public:
+		TEST_METHOD(SplitLines)
+		{
+			const string _Text = Csv(20000);
+			CheckSplit(seq, _Text);
+			CheckSplit(par, _Text);
+			CheckSplit(execution_policy(par), _Text);
+
+			// small chunks, many of them start in a quoted field
+			CheckSplit(par.with(grain(64), max_threads(8)), _Text);
+			CheckSplit(par.with(grain(64)), string("\"a,b\",c"));
+			CheckSplit(par, string());
+		}
+
+		TEST_METHOD(SplitNonContiguous)
+		{
+			const string _Text = Csv(500);
+			std::deque<char> _Chars(_Text.begin(), _Text.end());
+
+			vector<unsigned int> _Offsets(_Chars.size());
+			auto _End = split(par.with(grain(64)), _Chars.begin(), _Chars.end(), ',', '"', _Offsets.begin());
+
+			const vector<size_t> _Expected = Expected(_Chars.begin(), _Chars.end(), ',', '"', true);
+			Assert::AreEqual(_Expected.size(), static_cast<size_t>(_End - _Offsets.begin()));
+			Assert::IsTrue(std::equal(_Expected.begin(), _Expected.end(), _Offsets.begin()));
+		}
+	};
+} // namespace ParallelSTL_Tests
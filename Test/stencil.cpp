@@ -0,0 +1,115 @@
+#include "stdafx.h"
+
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(StencilTest)
+	{
+		// Sum of the 3x3 neighborhood, weighted so a misplaced element changes the result
+		struct WeightedSum
+		{
+			int operator()(const stencil_neighborhood<int, 2>& _Nb) const
+			{
+				int _Sum = 0;
+				for (int _Row = -1; _Row <= 1; ++_Row)
+					for (int _Col = -1; _Col <= 1; ++_Col)
+						_Sum += (3 * _Row + _Col + 5) * _Nb(_Row, _Col);
+				return _Sum % 10007;
+			}
+		};
+
+		// One step computed element by element, with the indexes past the edges clamped
+		static std::vector<int> ReferenceStep(const std::vector<int>& _In, ptrdiff_t _Rows, ptrdiff_t _Cols)
+		{
+			std::vector<int> _Out(_In.size());
+			for (ptrdiff_t _I = 0; _I < _Rows; ++_I)
+				for (ptrdiff_t _J = 0; _J < _Cols; ++_J)
+				{
+					int _Sum = 0;
+					for (int _Row = -1; _Row <= 1; ++_Row)
+						for (int _Col = -1; _Col <= 1; ++_Col)
+						{
+							const ptrdiff_t _Y = (std::min)((std::max)(_I + _Row, ptrdiff_t(0)), _Rows - 1);
+							const ptrdiff_t _X = (std::min)((std::max)(_J + _Col, ptrdiff_t(0)), _Cols - 1);
+							_Sum += (3 * _Row + _Col + 5) * _In[_Y * _Cols + _X];
+						}
+					_Out[_I * _Cols + _J] = _Sum % 10007;
+				}
+			return _Out;
+		}
+
+		template<typename _ExPolicy>
+		void CheckStencil(_ExPolicy&& _Policy, ptrdiff_t _Rows, ptrdiff_t _Cols, size_t _Steps)
+		{
+			std::vector<int> _In(_Rows * _Cols);
+			std::iota(std::begin(_In), std::end(_In), 1);
+
+			std::vector<int> _Expected = _In;
+			for (size_t _Step = 0; _Step < _Steps; ++_Step)
+				_Expected = ReferenceStep(_Expected, _Rows, _Cols);
+
+			std::vector<int> _Out(_In.size(), -1);
+			array_view<const int, 2> _In_av{ { _Rows, _Cols }, _In };
+			array_view<int, 2> _Out_av{ { _Rows, _Cols }, _Out };
+			stencil(_Policy, _In_av, _Out_av, 1, WeightedSum(), _Steps);
+
+			Assert::IsTrue(_Expected == _Out);
+		}
+
+		template<typename _ExPolicy>
+		void RunStencil(_ExPolicy&& _Policy)
+		{
+			CheckStencil(_Policy, 200, 300, 1);
+			CheckStencil(_Policy, 1, 1, 1);
+			CheckStencil(_Policy, 2, 1000, 1);
+
+			// the steps are fused on the halos of the tiles
+			CheckStencil(_Policy, 150, 170, 3);
+			CheckStencil(_Policy, 5, 7, 4);
+			CheckStencil(_Policy, 20, 20, 0);
+		}
+
+		TEST_METHOD(Stencil)
+		{
+			RunStencil(seq);
+			RunStencil(par);
+			RunStencil(par_vec);
+			RunStencil(par.with(partitioner(dynamic_)));
+			RunStencil(execution_policy(par));
+		}
+
+		TEST_METHOD(StencilStridedRadius)
+		{
+			// a section of a bigger image, the neighborhood doesn't reach past the section
+			std::vector<int> _Image(60 * 80, 0);
+			array_view<int, 2> _Image_av{ { 60, 80 }, _Image };
+			fill(seq, _Image_av.section({ 10, 20 }, { 30, 40 }), 1);
+
+			std::vector<int> _Out(30 * 40);
+			array_view<int, 2> _Out_av{ { 30, 40 }, _Out };
+			stencil(par, _Image_av.section({ 10, 20 }, { 30, 40 }), _Out_av, 2, [](const stencil_neighborhood<int, 2>& _Nb) {
+				int _Sum = 0;
+				for (int _Row = -2; _Row <= 2; ++_Row)
+					for (int _Col = -2; _Col <= 2; ++_Col)
+						_Sum += _Nb(_Row, _Col);
+				return _Sum;
+			});
+
+			for (auto _Val : _Out)
+				Assert::AreEqual(25, _Val);
+
+			// a one dimensional moving sum, the edges repeat the first and the last element
+			std::vector<int> _Line(1000);
+			std::iota(std::begin(_Line), std::end(_Line), 0);
+			std::vector<int> _Sums(_Line.size());
+			stencil(par, array_view<const int, 1>{ _Line }, array_view<int, 1>{ _Sums }, 1, [](const stencil_neighborhood<int, 1>& _Nb) {
+				return _Nb[{ -1 }] + _Nb.center() + _Nb[{ 1 }];
+			});
+
+			Assert::AreEqual(0 + 0 + 1, _Sums[0]);
+			Assert::AreEqual(3 * 500, _Sums[500]);
+			Assert::AreEqual(998 + 999 + 999, _Sums[999]);
+		}
+	};
+} // ParallelSTL_Tests
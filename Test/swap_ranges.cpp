@@ -117,5 +117,42 @@ namespace ParallelSTL_Tests
 			RunSwapRanges<random_access_iterator_tag>();
 			RunSwapRanges<forward_iterator_tag>();
 		}
+
+		// Trivially copyable contiguous ranges swap in chunks on page boundaries
+		TEST_METHOD(SwapRangesBulk)
+		{
+			const size_t COLLECTION_SIZE = 1000003;
+
+			std::vector<int> vec(COLLECTION_SIZE + 1), other(COLLECTION_SIZE);
+			std::iota(std::begin(vec), std::end(vec), 0);
+			std::iota(std::begin(other), std::end(other), -static_cast<int>(COLLECTION_SIZE));
+
+			Assert::IsTrue(swap_ranges(par, std::begin(vec) + 1, std::end(vec), std::begin(other)) == std::end(other));
+			Assert::IsTrue(vec[0] == 0);
+			for (size_t i = 0; i < COLLECTION_SIZE; ++i) {
+				Assert::IsTrue(other[i] == static_cast<int>(i + 1));
+				Assert::IsTrue(vec[i + 1] == static_cast<int>(i) - static_cast<int>(COLLECTION_SIZE));
+			}
+		}
+
+		// Elements that aren't trivially copyable swap in chores through raw pointers at a shared offset
+		TEST_METHOD(SwapRangesContiguous)
+		{
+			const size_t COLLECTION_SIZE = 100003;
+
+			std::vector<std::string> vec(COLLECTION_SIZE), other(COLLECTION_SIZE);
+			for (size_t i = 0; i < COLLECTION_SIZE; ++i) {
+				vec[i] = std::to_string(i);
+				other[i] = std::to_string(COLLECTION_SIZE + i);
+			}
+
+			Assert::IsTrue(swap_ranges(par, std::begin(vec), std::end(vec), other.data()) == other.data() + COLLECTION_SIZE);
+			Assert::IsTrue(swap_ranges(par_vec, other.data(), other.data() + COLLECTION_SIZE / 2, std::begin(vec)) == std::begin(vec) + COLLECTION_SIZE / 2);
+			for (size_t i = 0; i < COLLECTION_SIZE; ++i) {
+				const bool back = i < COLLECTION_SIZE / 2;
+				Assert::IsTrue(vec[i] == std::to_string(back ? i : COLLECTION_SIZE + i));
+				Assert::IsTrue(other[i] == std::to_string(back ? COLLECTION_SIZE + i : i));
+			}
+		}
 	};
 } // ParallelSTL_Tests
@@ -0,0 +1,97 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TaskPolicyTest)
+	{
+	public:
+		TEST_METHOD(TaskSortAndReduce)
+		{
+			std::vector<int> _Keys(500000);
+			std::iota(std::rbegin(_Keys), std::rend(_Keys), 0);
+			std::vector<long long> _Values(300000);
+			std::iota(std::begin(_Values), std::end(_Values), 1LL);
+
+			task_future<void> _Sorted = sort(par(task), std::begin(_Keys), std::end(_Keys));
+			task_future<long long> _Sum = reduce(par(task).with(grain(1024)), std::begin(_Values), std::end(_Values));
+
+			Assert::AreEqual(300000LL * 300001LL / 2, _Sum.get());
+			_Sorted.get();
+			Assert::IsTrue(std::is_sorted(std::begin(_Keys), std::end(_Keys)));
+			Assert::IsFalse(_Sorted.valid());
+		}
+
+		TEST_METHOD(TaskResults)
+		{
+			std::vector<int> _In(100000), _Out(100000);
+			std::iota(std::begin(_In), std::end(_In), 0);
+
+			auto _End = transform(par(task), std::begin(_In), std::end(_In), std::begin(_Out), [](int _Val) { return 3 * _Val; }).get();
+			Assert::IsTrue(_End == std::end(_Out));
+			for (int _I = 0; _I < 100000; ++_I)
+				Assert::AreEqual(3 * _I, _Out[_I]);
+
+			auto _Scan_end = inclusive_scan(par(task), std::begin(_In), std::end(_In), std::begin(_Out)).get();
+			Assert::IsTrue(_Scan_end == std::end(_Out));
+			Assert::AreEqual(55, _Out[10]);
+		}
+
+		TEST_METHOD(TaskContinuation)
+		{
+			std::vector<int> _Data(200000, 2);
+
+			auto _Result = reduce(par(task), std::begin(_Data), std::end(_Data), 0).then([](task_future<int> _Sum) {
+				return _Sum.get() / 2;
+			}).then([](task_future<int> _Half) {
+				return std::to_string(_Half.get());
+			});
+			Assert::AreEqual(std::string("200000"), _Result.get());
+		}
+
+		TEST_METHOD(TaskWhenAll)
+		{
+			std::vector<int> _Keys(100000), _Data(100000, 1);
+			std::iota(std::rbegin(_Keys), std::rend(_Keys), 0);
+
+			auto _All = when_all(sort(par(task), std::begin(_Keys), std::end(_Keys)), reduce(par(task), std::begin(_Data), std::end(_Data)));
+			auto _Done = _All.get();
+			std::get<0>(_Done).get();
+			Assert::IsTrue(std::is_sorted(std::begin(_Keys), std::end(_Keys)));
+			Assert::AreEqual(100000, std::get<1>(_Done).get());
+
+			std::vector<task_future<int>> _Sums;
+			for (int _Part = 0; _Part < 10; ++_Part)
+				_Sums.push_back(reduce(par(task), std::begin(_Data) + _Part * 10000, std::begin(_Data) + (_Part + 1) * 10000));
+			auto _Total = when_all(std::begin(_Sums), std::end(_Sums)).then([](task_future<std::vector<task_future<int>>> _Parts) {
+				int _Sum = 0;
+				for (auto& _Part : _Parts.get())
+					_Sum += _Part.get();
+				return _Sum;
+			});
+			Assert::AreEqual(100000, _Total.get());
+
+			auto _None = when_all(std::begin(_Sums), std::begin(_Sums));
+			Assert::IsTrue(_None.get().empty());
+		}
+
+		TEST_METHOD(TaskException)
+		{
+			std::vector<int> _Data(100000, 1);
+
+			auto _Future = for_each(par(task), std::begin(_Data), std::end(_Data), [](int _Val) {
+				if (_Val == 1)
+					throw std::runtime_error("failed");
+			});
+			_Future.wait();
+			Assert::IsTrue(_Future.is_ready());
+
+			try {
+				_Future.get();
+				Assert::Fail(L"The exception of the algorithm was not rethrown");
+			}
+			catch (const exception_list& _List) {
+				Assert::IsTrue(_List.size() > 0);
+			}
+		}
+	};
+}
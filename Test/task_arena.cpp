@@ -0,0 +1,93 @@
+#include "stdafx.h"
+#include <functional>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(task_arena_tests)
+	{
+		// The threads that ran the chunks of a loop slow enough for the workers to join
+		template<typename _Run>
+		static size_t ThreadsOfLoop(_Run _Run_loop)
+		{
+			std::mutex lock;
+			std::set<std::thread::id> threads;
+			std::vector<int> data(256);
+			_Run_loop(data, [&](int&) {
+				Sleep(1);
+				std::lock_guard<std::mutex> guard(lock);
+				threads.insert(std::this_thread::get_id());
+			});
+			return threads.size();
+		}
+
+	public:
+		TEST_METHOD(Arena_Execute)
+		{
+			task_arena tenant(2);
+			Assert::AreEqual(2u, tenant.max_concurrency());
+			Assert::AreEqual(42, tenant.execute([] { return 42; }));
+
+			// the loops are split for the threads of the arena, the global limit is left alone
+			Assert::AreEqual(2u, tenant.execute([] { return details::get_hardware_concurrency(); }));
+			Assert::AreEqual(0u, concurrency_limit());
+
+			task_arena hardware(0);
+			Assert::AreEqual((std::max)(std::thread::hardware_concurrency(), 1u), hardware.max_concurrency());
+		}
+
+		TEST_METHOD(Arena_Caps_Workers)
+		{
+			task_arena tenant(2);
+
+			// two workers at most, the calling thread on top of them
+			const size_t threads = tenant.execute([] {
+				return ThreadsOfLoop([](std::vector<int>& data, const std::function<void(int&)>& f) {
+					for_each(par, data.begin(), data.end(), f);
+				});
+			});
+			Assert::IsTrue(threads <= 3);
+
+			const size_t withParameter = ThreadsOfLoop([&tenant](std::vector<int>& data, const std::function<void(int&)>& f) {
+				for_each(par.with(arena(tenant)), data.begin(), data.end(), f);
+			});
+			Assert::IsTrue(withParameter <= 3);
+		}
+
+		TEST_METHOD(Arena_Single_Thread)
+		{
+			task_arena tenant(1);
+
+			// a worker at most
+			std::vector<int> data(100000);
+			std::iota(data.begin(), data.end(), 0);
+			tenant.execute([&data] {
+				sort(par, data.rbegin(), data.rend());
+			});
+			Assert::IsTrue(std::is_sorted(data.rbegin(), data.rend()));
+
+			// the calling thread goes back to the default arena
+			Assert::AreEqual((std::max)(std::thread::hardware_concurrency(), 1u), details::get_hardware_concurrency());
+		}
+
+		TEST_METHOD(Arena_Nested_In_Default)
+		{
+			task_arena tenant(2);
+			std::vector<long long> data(1 << 16);
+			std::iota(data.begin(), data.end(), 0ll);
+
+			// an algorithm of the arena called from the chores of another algorithm
+			std::vector<long long> sums(8);
+			for_each(par, sums.begin(), sums.end(), [&](long long& sum) {
+				sum = reduce(par.with(arena(tenant)), data.begin(), data.end(), 0ll);
+			});
+
+			const long long expected = static_cast<long long>(data.size()) * (data.size() - 1) / 2;
+			for (auto sum : sums)
+				Assert::AreEqual(expected, sum);
+		}
+	};
+} // namespace ParallelSTL_Tests
@@ -0,0 +1,92 @@
+#include "stdafx.h"
+#include <atomic>
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TaskGraphTest)
+	{
+	public:
+		TEST_METHOD(TaskGraphOrder)
+		{
+			// a diamond per layer: each node records the step it ran at, after all of its predecessors
+			const int _Layers = 50;
+			std::atomic<int> _Step = 0;
+			std::vector<int> _Ran_at(3 * _Layers, -1);
+
+			task_graph _Graph;
+			std::vector<task_graph::node> _Nodes;
+			for (int _Idx = 0; _Idx < 3 * _Layers; ++_Idx)
+				_Nodes.push_back(_Graph.add_node([&, _Idx] { _Ran_at[_Idx] = _Step++; }));
+			for (int _Layer = 0; _Layer < _Layers; ++_Layer) {
+				const int _Top = 3 * _Layer;
+				_Graph.add_edge(_Nodes[_Top], _Nodes[_Top + 1]);
+				_Graph.add_edge(_Nodes[_Top], _Nodes[_Top + 2]);
+				if (_Layer + 1 < _Layers) {
+					_Graph.add_edge(_Nodes[_Top + 1], _Nodes[_Top + 3]);
+					_Graph.add_edge(_Nodes[_Top + 2], _Nodes[_Top + 3]);
+				}
+			}
+
+			for (int _Run = 0; _Run < 3; ++_Run) {
+				_Step = 0;
+				_Graph.run();
+				Assert::AreEqual(3 * _Layers, _Step.load());
+				for (int _Layer = 0; _Layer < _Layers; ++_Layer) {
+					const int _Top = 3 * _Layer;
+					Assert::IsTrue(_Ran_at[_Top] < _Ran_at[_Top + 1] && _Ran_at[_Top] < _Ran_at[_Top + 2]);
+					if (_Layer + 1 < _Layers)
+						Assert::IsTrue(_Ran_at[_Top + 1] < _Ran_at[_Top + 3] && _Ran_at[_Top + 2] < _Ran_at[_Top + 3]);
+				}
+			}
+		}
+
+		TEST_METHOD(TaskGraphAlgorithmNodes)
+		{
+			std::vector<int> _Data(200000);
+			long long _Sum = 0;
+
+			task_graph _Graph;
+			auto _Fill = _Graph.add_node([&] { std::iota(std::begin(_Data), std::end(_Data), 0); });
+			auto _Twice = _Graph.add_node([&] { for_each(par, std::begin(_Data), std::begin(_Data) + 100000, [](int& _Val) { _Val *= 2; }); });
+			auto _Thrice = _Graph.add_node([&] { for_each(par, std::begin(_Data) + 100000, std::end(_Data), [](int& _Val) { _Val *= 3; }); });
+			auto _Total = _Graph.add_node([&] { _Sum = reduce(par, std::begin(_Data), std::end(_Data), 0LL); });
+			_Graph.add_edge(_Fill, _Twice);
+			_Graph.add_edge(_Fill, _Thrice);
+			_Graph.add_edge(_Twice, _Total);
+			_Graph.add_edge(_Thrice, _Total);
+			_Graph.run();
+
+			long long _Expected = 0;
+			for (long long _Idx = 0; _Idx < 200000; ++_Idx)
+				_Expected += _Idx < 100000 ? 2 * _Idx : 3 * _Idx;
+			Assert::AreEqual(_Expected, _Sum);
+		}
+
+		TEST_METHOD(TaskGraphErrors)
+		{
+			bool _After = false;
+			task_graph _Graph;
+			auto _First = _Graph.add_node([] { throw std::runtime_error("failed"); });
+			auto _Second = _Graph.add_node([&] { _After = true; });
+			_Graph.add_edge(_First, _Second);
+
+			try {
+				_Graph.run();
+				Assert::Fail(L"The exception of the node was not rethrown");
+			}
+			catch (const exception_list& _List) {
+				Assert::AreEqual(static_cast<size_t>(1), _List.size());
+			}
+			Assert::IsFalse(_After);
+
+			_Graph.add_edge(_Second, _First);
+			try {
+				_Graph.run();
+				Assert::Fail(L"A cycle was accepted");
+			}
+			catch (const std::invalid_argument&) {
+			}
+		}
+	};
+}
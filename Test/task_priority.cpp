@@ -0,0 +1,74 @@
+#include "stdafx.h"
+#include <thread>
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(task_priority_tests)
+	{
+	public:
+		TEST_METHOD(Priority_Parameter)
+		{
+			Assert::IsTrue(par.parameters().priority_level() == task_priority::default_);
+			Assert::IsTrue(par.with(priority(task_priority::high)).parameters().priority_level() == task_priority::high);
+			Assert::IsTrue(par.with(priority(task_priority::high), grain(16)).with(priority(task_priority::normal)).parameters().priority_level() == task_priority::normal);
+
+			std::vector<int> data(100000);
+			std::iota(data.begin(), data.end(), 0);
+			sort(par.with(priority(task_priority::high)), data.rbegin(), data.rend());
+			Assert::IsTrue(std::is_sorted(data.rbegin(), data.rend()));
+		}
+
+		TEST_METHOD(Priority_High_Beside_Bulk)
+		{
+			reset_statistics();
+
+			// a bulk loop of slow chunks keeps the workers busy
+			std::vector<int> bulkData(2000);
+			std::thread bulk([&bulkData] {
+				for_each(par.with(partitioner(dynamic_), grain(4), priority(task_priority::normal)), bulkData.begin(), bulkData.end(), [](int& v) {
+					Sleep(1);
+					v = 1;
+				});
+			});
+
+			std::vector<long long> data(1 << 18);
+			std::iota(data.begin(), data.end(), 0ll);
+			const long long expected = static_cast<long long>(data.size()) * (data.size() - 1) / 2;
+			for (int call = 0; call < 20; ++call)
+				Assert::AreEqual(expected, reduce(par.with(priority(task_priority::high)), data.begin(), data.end(), 0ll));
+
+			bulk.join();
+			Assert::AreEqual(2000, std::accumulate(bulkData.begin(), bulkData.end(), 0));
+
+			scheduler_statistics stats;
+			get_scheduler_statistics(stats);
+			if (!telemetry_enabled())
+			{
+				Assert::AreEqual(size_t(0), stats.high_priority.chores_started);
+				return;
+			}
+
+			Assert::IsTrue(stats.high_priority.chores_started > 0);
+			Assert::IsTrue(stats.normal_priority.chores_started > 0);
+			Assert::IsTrue(stats.high_priority.max_queue_delay_ns * stats.high_priority.chores_started >= stats.high_priority.queue_delay_ns);
+		}
+
+		TEST_METHOD(Priority_Nested)
+		{
+			std::vector<long long> data(1 << 16);
+			std::iota(data.begin(), data.end(), 0ll);
+			const long long expected = static_cast<long long>(data.size()) * (data.size() - 1) / 2;
+
+			// the inner calls inherit the high priority of the chores they run in, or set their own
+			std::vector<long long> sums(8);
+			for_each(par.with(priority(task_priority::high)), sums.begin(), sums.end(), [&](long long& sum) {
+				sum = reduce(par, data.begin(), data.end(), 0ll) - reduce(par.with(priority(task_priority::normal)), data.begin(), data.end(), 0ll);
+				sum += reduce(par.with(partitioner(dynamic_)), data.begin(), data.end(), 0ll);
+			});
+
+			for (auto sum : sums)
+				Assert::AreEqual(expected, sum);
+		}
+	};
+} // namespace ParallelSTL_Tests
@@ -1,6 +1,11 @@
 #include "stdafx.h"
+#include <array>
+#include <chrono>
+#include <thread>
 #include <vector>
 #include <algorithm>
+#include <memory>
+#include <numeric>
 
 namespace ParallelSTL_Tests
 {
@@ -76,6 +81,85 @@ namespace ParallelSTL_Tests
 		stg.wait();
 	}
 
+	int invokeFib(int n)
+	{
+		if (n <= 1)
+			return n;
+		int res1, res2;
+		parallel_invoke([=, &res1] { res1 = invokeFib(n - 1); }, [=, &res2] { res2 = invokeFib(n - 2); });
+		return res1 + res2;
+	}
+
+	// Searches a complete binary tree of the depth for the leaf, every branch forks a task_group of its two
+	// subtrees. The first branch that finds it cancels the root, the others stop forking.
+	void searchLeaf(task_group& root, int depth, int node, int leaf, std::atomic<int>& visited, std::atomic<int>& found)
+	{
+		++visited;
+		if (depth == 0)
+		{
+			if (node == leaf)
+			{
+				found = node;
+				root.cancel();
+			}
+			return;
+		}
+
+		task_group branches;
+		branches.run([&, depth, node] { searchLeaf(root, depth - 1, node * 2, leaf, visited, found); });
+		branches.run([&, depth, node] { searchLeaf(root, depth - 1, node * 2 + 1, leaf, visited, found); });
+		branches.wait();
+	}
+
+	struct CountChore
+	{
+		std::atomic<int> *count;
+
+		void operator()() const
+		{
+			++*count;
+		}
+	};
+
+	// Pushes a chore per counter in one group and waits for them, the queue of the calling thread grows
+	// past its initial capacity while the workers steal from it
+	void fanOut(std::atomic<int> *counts, size_t count)
+	{
+		std::vector<UserWorkChore<CountChore>> chores;
+		chores.reserve(count);
+		for (size_t i = 0; i < count; i++)
+			chores.push_back(make_task(CountChore{ &counts[i] }));
+
+		TaskGroup tg;
+		for (auto& chore : chores)
+			tg.run(chore);
+		tg.wait();
+	}
+
+	// A chore that counts itself and the chores done so far, the owner of the queue watches the latter
+	struct DoneChore
+	{
+		std::atomic<int> *count;
+		std::atomic<size_t> *done;
+
+		void operator()() const
+		{
+			++*count;
+			++*done;
+		}
+	};
+
+	struct FanOutChore
+	{
+		std::atomic<int> *counts;
+		size_t count;
+
+		void operator()() const
+		{
+			fanOut(counts, count);
+		}
+	};
+
 	TEST_CLASS(taskgroup_tests)
 	{
 		TEST_METHOD(singletaskgroup)
@@ -149,5 +233,488 @@ namespace ParallelSTL_Tests
 				Assert::AreEqual(1000, counter[i].load());
 			}
 		}
+
+		TEST_METHOD(taskgroup_deque_growth)
+		{
+			// the owner pushes while the thieves steal and pops what is left, every chore runs once
+			const size_t count = 20000;
+			for (int round = 0; round < 10; round++)
+			{
+				std::vector<std::atomic<int>> counts(count);
+				fanOut(counts.data(), count);
+				for (size_t i = 0; i < count; i++)
+					Assert::AreEqual(1, counts[i].load());
+			}
+
+			// the chores fan out in turn, the queues of the workers grow while they are stolen from
+			const size_t outer = 64, inner = 1000;
+			std::vector<std::atomic<int>> counts(outer * inner);
+			std::vector<UserWorkChore<FanOutChore>> chores;
+			chores.reserve(outer);
+			for (size_t i = 0; i < outer; i++)
+				chores.push_back(make_task(FanOutChore{ &counts[i * inner], inner }));
+
+			TaskGroup tg;
+			for (auto& chore : chores)
+				tg.run(chore);
+			tg.wait();
+			for (size_t i = 0; i < counts.size(); i++)
+				Assert::AreEqual(1, counts[i].load());
+		}
+
+		TEST_METHOD(taskgroup_first_use)
+		{
+			// The queues of a new arena are created the first time its threads use a group. More threads than the
+			// victim table starts with do it at once, so it grows while the thieves read it.
+			task_arena fresh(0);
+			const size_t threadCount = 2 * get_hardware_concurrency() + 1;
+			const size_t count = 1000;
+			std::vector<std::atomic<int>> counts(threadCount * count);
+			std::atomic<size_t> arrived(0);
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < threadCount; t++)
+			{
+				threads.emplace_back([&, t] {
+					fresh.execute([&] {
+						++arrived;
+						while (arrived.load() != threadCount)
+							std::this_thread::yield();
+						fanOut(&counts[t * count], count);
+					});
+				});
+			}
+			for (auto& thread : threads)
+				thread.join();
+
+			for (size_t i = 0; i < counts.size(); i++)
+				Assert::AreEqual(1, counts[i].load());
+		}
+
+		TEST_METHOD(taskgroup_event_wakeups)
+		{
+			// Two threads play ping-pong, every now and then the setter sleeps so the waiter is past its spin and
+			// asleep, the other sets land in the spin or right at its end. A lost wake up hangs the test.
+			const int rounds = 4000;
+			std::unique_ptr<Event[]> pings(new Event[rounds]), pongs(new Event[rounds]);
+			std::thread partner([&] {
+				for (int i = 0; i < rounds; i++)
+				{
+					pings[i].wait();
+					if (i % 64 == 0)
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					pongs[i].set();
+				}
+			});
+			for (int i = 0; i < rounds; i++)
+			{
+				if (i % 64 == 32)
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				pings[i].set();
+				pongs[i].wait();
+			}
+			partner.join();
+
+			// The completers of a CompletionEvent touch its counter only, the last of them has to wake the waiter
+			// whether it announced its sleep before or after their decrements
+			const size_t completers = 4;
+			size_t missed = 0;
+			for (int round = 0; round < 500; round++)
+			{
+				CompletionEvent done(completers);
+				std::atomic<size_t> completed(0);
+				std::vector<std::thread> threads;
+				for (size_t c = 0; c < completers; c++)
+				{
+					threads.emplace_back([&, c] {
+						if ((round + c) % 8 == 0)
+							std::this_thread::sleep_for(std::chrono::milliseconds(1));
+						++completed;
+						done.completeOne();
+					});
+				}
+				done.wait();
+				if (completed.load() != completers)
+					++missed;
+				for (auto& thread : threads)
+					thread.join();
+			}
+			Assert::AreEqual(static_cast<size_t>(0), missed);
+		}
+
+		TEST_METHOD(taskgroup_chore_arena_threads)
+		{
+			// Every thread takes the blocks of its own arena while the others do the same, nested like the
+			// algorithm calls, freed out of order by a growing container, and past the size of the arena
+			typedef std::vector<size_t, _Chore_allocator<size_t>> chore_vector;
+			const size_t threadCount = 8;
+			std::vector<int> data(100000, 1);
+			std::atomic<int> failures(0);
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < threadCount; t++)
+			{
+				threads.emplace_back([&, t] {
+					for (size_t round = 0; round < 200; round++)
+					{
+						chore_vector outer(64 + round % 7, t);
+						{
+							chore_vector growing;
+							for (size_t i = 0; i < 100; i++)
+								growing.push_back(i);
+							chore_vector large(round % 50 == 0 ? 256 * 1024 : 16, round);
+
+							for (size_t i = 0; i < growing.size(); i++)
+							{
+								if (growing[i] != i)
+									++failures;
+							}
+							if (std::count(large.begin(), large.end(), round) != static_cast<ptrdiff_t>(large.size()))
+								++failures;
+						}
+
+						// an algorithm called on top of the blocks the thread holds
+						if (reduce(par, data.begin(), data.end(), 0) != 100000)
+							++failures;
+						if (std::count(outer.begin(), outer.end(), t) != static_cast<ptrdiff_t>(outer.size()))
+							++failures;
+					}
+				});
+			}
+			for (auto& thread : threads)
+				thread.join();
+
+			// the threads are gone with their arenas
+			Assert::AreEqual(0, failures.load());
+		}
+
+		// The steals counted on all the nodes, local and remote
+		static size_t StealCount()
+		{
+			size_t steals = 0, local, remote;
+			for (unsigned int node = 0; node < get_numa_node_count(); node++)
+			{
+				Assert::IsTrue(get_steal_counters(node, local, remote));
+				steals += local + remote;
+			}
+			return steals;
+		}
+
+		TEST_METHOD(taskgroup_steal_counters)
+		{
+			unsigned int nodes = get_numa_node_count();
+			Assert::IsTrue(nodes >= 1);
+
+			size_t local, remote;
+			Assert::IsFalse(get_steal_counters(nodes, local, remote));
+
+			// The owner of the queue stays busy until its chore is done, so only a thief runs it, one steal per round
+			const size_t rounds = 20;
+			const size_t before = StealCount();
+			for (size_t round = 0; round < rounds; round++)
+			{
+				std::atomic<bool> done(false);
+				std::thread::id ranOn;
+				TaskGroup tg;
+				auto chore = make_task([&] {
+					ranOn = std::this_thread::get_id();
+					done = true;
+				});
+				tg.run(chore);
+
+				const auto start = std::chrono::steady_clock::now();
+				while (!done.load())
+				{
+					Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(30), L"No worker stole the chore");
+					std::this_thread::yield();
+				}
+				tg.wait();
+				Assert::IsTrue(ranOn != std::this_thread::get_id());
+			}
+
+			Assert::AreEqual(before + rounds, StealCount());
+		}
+
+		TEST_METHOD(taskgroup_helping_wait)
+		{
+			// The only worker of the arena steals the chore of the group and queues one of its own that it
+			// doesn't run, the thread that waits for the group has to. The steals are random, a wait that misses
+			// blocks and the worker runs its chore after a while, so the test asks for most of the rounds only.
+			task_arena single(1);
+			const int rounds = 20;
+			int helped = 0;
+			for (int round = 0; round < rounds; round++)
+			{
+				std::atomic<bool> queued(false), innerDone(false);
+				std::thread::id innerRanOn;
+				int nested = 0;
+				auto inner = make_task([&] {
+					innerRanOn = std::this_thread::get_id();
+					// a wait in the chore of a helping wait
+					nested = fib(15);
+					innerDone = true;
+				});
+				auto blocker = make_task([&] {
+					TaskGroup group;
+					group.run(inner);
+					queued = true;
+
+					const auto start = std::chrono::steady_clock::now();
+					while (!innerDone.load() && std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500))
+						std::this_thread::yield();
+					group.wait();
+				});
+
+				single.execute([&] {
+					TaskGroup tg;
+					tg.run(blocker);
+					const auto start = std::chrono::steady_clock::now();
+					while (!queued.load())
+					{
+						Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(30), L"No worker stole the chore");
+						std::this_thread::yield();
+					}
+					tg.wait();
+				});
+
+				Assert::AreEqual(610, nested);
+				if (innerRanOn == std::this_thread::get_id())
+					++helped;
+			}
+			Assert::IsTrue(helped > rounds / 2);
+		}
+
+		TEST_METHOD(taskgroup_batch_steals)
+		{
+			// One queue holds all the chores and its owner doesn't pop any, the thieves steal them in batches and
+			// steal from each other the chores a batch moved. Every steal takes a chore that runs, a batch moves
+			// some more along with it, so the steals stay fewer than the chores.
+			const size_t count = 10000;
+			for (int round = 0; round < 5; round++)
+			{
+				std::vector<std::atomic<int>> counts(count);
+				std::atomic<size_t> done(0);
+				std::vector<UserWorkChore<DoneChore>> chores;
+				chores.reserve(count);
+				for (size_t i = 0; i < count; i++)
+					chores.push_back(make_task(DoneChore{ &counts[i], &done }));
+
+				const size_t before = StealCount();
+				TaskGroup tg;
+				for (auto& chore : chores)
+					tg.run(chore);
+
+				const auto start = std::chrono::steady_clock::now();
+				while (done.load() != count)
+				{
+					Assert::IsTrue(std::chrono::steady_clock::now() - start < std::chrono::seconds(30), L"The thieves didn't take every chore");
+					std::this_thread::yield();
+				}
+				tg.wait();
+
+				for (size_t i = 0; i < count; i++)
+					Assert::AreEqual(1, counts[i].load());
+				const size_t steals = StealCount() - before;
+				Assert::IsTrue(steals >= 1);
+				Assert::IsTrue(steals < count);
+			}
+		}
+
+		TEST_METHOD(taskgroup_partition_count_shards)
+		{
+			// More threads than the partition count has shards call nested algorithms at once, several of them
+			// share a shard. Each checks right after its call returned that every element was done.
+			const size_t threadCount = 96, outer = 64, inner = 1000;
+			std::atomic<int> failures(0);
+			std::vector<std::thread> threads;
+			for (size_t t = 0; t < threadCount; t++)
+			{
+				threads.emplace_back([&] {
+					std::vector<std::atomic<int>> counts(outer * inner);
+					std::vector<size_t> rows(outer);
+					std::iota(rows.begin(), rows.end(), size_t(0));
+					for (int round = 0; round < 4; round++)
+					{
+						for_each(par, rows.begin(), rows.end(), [&](size_t row) {
+							for_each(par, counts.begin() + row * inner, counts.begin() + (row + 1) * inner, [](std::atomic<int>& count) {
+								++count;
+							});
+						});
+
+						for (auto& count : counts)
+						{
+							if (count.load() != round + 1)
+								++failures;
+						}
+					}
+				});
+			}
+			for (auto& thread : threads)
+				thread.join();
+
+			Assert::AreEqual(0, failures.load());
+
+			// the partitions of the threads are all released, a nested loop after them still covers its range
+			std::atomic<int> counter(0);
+			std::vector<int> rows(64);
+			for_each(par, rows.begin(), rows.end(), [&](int) {
+				std::vector<int> cells(1000);
+				for_each(par, cells.begin(), cells.end(), [&](int) {
+					++counter;
+				});
+			});
+			Assert::AreEqual(64000, counter.load());
+		}
+
+		TEST_METHOD(taskgroup_concurrency_limit)
+		{
+			const unsigned int previous = set_concurrency_limit(2);
+			Assert::AreEqual(2u, concurrency_limit());
+			Assert::AreEqual(2u, get_hardware_concurrency());
+
+			// the loops are carved for the pinned workers and still cover every element
+			std::vector<int> data(1000000, 1);
+			Assert::AreEqual(1000000, reduce(par, data.begin(), data.end(), 0));
+			Assert::AreEqual(75025, fib(25));
+
+			Assert::AreEqual(2u, set_concurrency_limit(previous));
+			Assert::AreEqual(previous, concurrency_limit());
+		}
+
+		TEST_METHOD(taskgroup_parallel_invoke)
+		{
+			Assert::AreEqual(75025, invokeFib(25));
+
+			std::atomic<int> counter = 0;
+			auto doWork = [&] {
+				++counter;
+			};
+			parallel_invoke(doWork, doWork, doWork, doWork, doWork);
+			Assert::AreEqual(5, counter.load());
+		}
+
+		TEST_METHOD(taskgroup_public_group)
+		{
+			std::atomic<int> counter = 0;
+			std::array<int, 64> big;
+			big.fill(1);
+
+			task_group tg;
+			auto handle = make_task_handle([&] { ++counter; });
+			tg.run(handle);
+			for (int i = 0; i < 20; i++)
+				tg.run([&] { ++counter; });
+			// too large for the inline buffer of the group
+			tg.run([&counter, big] { counter += static_cast<int>(big.size()); });
+			tg.run_and_wait([&] { ++counter; });
+			Assert::AreEqual(86, counter.load());
+
+			// the group takes new functions after a wait
+			tg.run([&] { ++counter; });
+			tg.wait();
+			Assert::AreEqual(87, counter.load());
+		}
+
+		TEST_METHOD(taskgroup_exceptions)
+		{
+			task_group tg;
+			for (int i = 0; i < 4; i++)
+				tg.run([] { throw std::runtime_error("failed"); });
+			tg.run([] {});
+
+			try {
+				tg.wait();
+				Assert::Fail(L"The exceptions of the group were not rethrown");
+			}
+			catch (const exception_list& list) {
+				Assert::AreEqual(static_cast<size_t>(4), list.size());
+			}
+
+			tg.wait();
+
+			try {
+				parallel_invoke([] {}, [] { throw std::runtime_error("failed"); });
+				Assert::Fail(L"The exception of parallel_invoke was not rethrown");
+			}
+			catch (const exception_list& list) {
+				Assert::AreEqual(static_cast<size_t>(1), list.size());
+			}
+		}
+
+		TEST_METHOD(taskgroup_cancel)
+		{
+			std::atomic<int> counter = 0;
+
+			// the functions that haven't started by the cancel are dropped
+			task_group tg;
+			tg.cancel();
+			Assert::IsTrue(tg.is_canceling());
+			for (int i = 0; i < 100; i++)
+				tg.run([&] { ++counter; });
+			tg.wait();
+			Assert::AreEqual(0, counter.load());
+
+			// the wait clears the cancellation
+			Assert::IsFalse(tg.is_canceling());
+			tg.run([&] { ++counter; });
+			tg.wait();
+			Assert::AreEqual(1, counter.load());
+
+			// a running function sees it
+			std::atomic<bool> sawCancel = false;
+			tg.run([&] {
+				tg.cancel();
+				sawCancel = is_current_task_group_canceling();
+			});
+			tg.wait();
+			Assert::IsTrue(sawCancel.load());
+			Assert::IsFalse(is_current_task_group_canceling());
+		}
+
+		TEST_METHOD(taskgroup_cancel_nested)
+		{
+			// the leaf the calling thread reaches first, it pops the right branches first
+			const int depth = 16;
+			const int leaf = (1 << depth) - 1;
+
+			std::atomic<int> visited = 0;
+			std::atomic<int> found = -1;
+			task_group root;
+			root.run([&] { searchLeaf(root, depth, 0, leaf, visited, found); });
+			root.wait();
+
+			Assert::AreEqual(leaf, found.load());
+			Assert::IsTrue(visited.load() < (2 << depth) - 1);
+
+			// a parallel algorithm called in a canceled branch still covers its range
+			std::vector<int> data(100000, 1);
+			int sum = 0;
+			root.run([&] {
+				root.cancel();
+				sum = reduce(par, data.begin(), data.end(), 0);
+			});
+			root.wait();
+			Assert::AreEqual(100000, sum);
+		}
+
+		TEST_METHOD(taskgroup_outlives_parent)
+		{
+			// groups created in the functions of a group that is gone before them, a heap object holds them
+			std::unique_ptr<task_group> inner, canceledInner;
+			{
+				task_group outer;
+				outer.run([&] { inner.reset(new task_group); });
+				outer.wait();
+				outer.run([&] {
+					canceledInner.reset(new task_group);
+					outer.cancel();
+				});
+				outer.wait();
+			}
+
+			// they read the chain they were created under, which the groups of their functions left behind
+			Assert::IsFalse(inner->is_canceling());
+			Assert::IsTrue(canceledInner->is_canceling());
+			canceledInner.reset();
+			inner.reset();
+		}
 	};
 } // namespace ParallelSTL_Tests
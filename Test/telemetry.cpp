@@ -0,0 +1,97 @@
+#include "stdafx.h"
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TelemetryTest)
+	{
+		static const algorithm_statistics *Find(const statistics_snapshot& _Snapshot, const char *_Name)
+		{
+			for (auto& _Algorithm : _Snapshot.algorithms)
+			{
+				if (strcmp(_Algorithm.name, _Name) == 0)
+					return &_Algorithm;
+			}
+			return nullptr;
+		}
+
+	public:
+		TEST_METHOD(TelemetryAlgorithmCalls)
+		{
+			std::vector<int> _Data(1000000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+			std::reverse(std::begin(_Data), std::end(_Data));
+
+			reset_statistics();
+			sort(par, std::begin(_Data), std::end(_Data));
+			sort(par, std::begin(_Data), std::end(_Data), std::greater<int>());
+			Assert::AreEqual(499999500000LL, reduce(par, std::begin(_Data), std::end(_Data), 0LL));
+
+			auto _Snapshot = take_statistics_snapshot();
+			if (!telemetry_enabled())
+			{
+				Assert::IsTrue(_Snapshot.algorithms.empty());
+				Assert::IsTrue(_Snapshot.workers.empty());
+				Assert::AreEqual(size_t(0), _Snapshot.scheduler.workers.chores_executed);
+				return;
+			}
+
+			// the overload forwarding to the one with the predicate is a single call
+			auto _Sort = Find(_Snapshot, "sort");
+			Assert::IsNotNull(_Sort);
+			Assert::AreEqual(size_t(2), _Sort->calls);
+			Assert::IsTrue(_Sort->total_ns > 0);
+
+			auto _Reduce = Find(_Snapshot, "reduce");
+			Assert::IsNotNull(_Reduce);
+			Assert::IsTrue(_Reduce->calls >= 1);
+
+			Assert::IsTrue(_Snapshot.scheduler.workers.chores_executed > 0);
+			Assert::IsFalse(_Snapshot.workers.empty());
+			Assert::IsTrue(_Snapshot.scheduler.workers.steals <= _Snapshot.scheduler.workers.steal_attempts);
+
+			reset_statistics();
+			_Snapshot = take_statistics_snapshot();
+			Assert::IsTrue(_Snapshot.algorithms.empty());
+			Assert::AreEqual(size_t(0), _Snapshot.scheduler.workers.chores_executed);
+		}
+
+		TEST_METHOD(ImbalanceProfileAdvice)
+		{
+			std::vector<double> _Data(1000000, 1.0);
+			auto _Body = [](double& _Val) { _Val = _Val * 0.5 + 1.0; };
+
+			reset_imbalance_profiles();
+			const imbalance_profiling _Previous = set_imbalance_profiling(imbalance_profiling::record);
+			if (!telemetry_enabled())
+			{
+				for_each(par, std::begin(_Data), std::end(_Data), _Body);
+				Assert::IsTrue(imbalance_profiling_mode() == imbalance_profiling::off);
+				Assert::AreEqual(size_t(0), get_imbalance_profiles(nullptr, 0));
+				return;
+			}
+
+			for (int _Call = 0; _Call < 4; ++_Call)
+				for_each(par, std::begin(_Data), std::end(_Data), _Body);
+
+			std::vector<imbalance_profile_info> _Sites(get_imbalance_profiles(nullptr, 0));
+			_Sites.resize((std::min)(get_imbalance_profiles(_Sites.data(), _Sites.size()), _Sites.size()));
+			auto _Site = std::find_if(std::begin(_Sites), std::end(_Sites), [](const imbalance_profile_info& _Info) { return _Info.calls == 4; });
+			Assert::IsTrue(_Site != std::end(_Sites));
+			Assert::IsTrue(_Site->partitioner != partitioner_kind::default_);
+			Assert::IsTrue(_Site->grain > 0);
+			Assert::IsTrue(_Site->tail_ratio >= 1.0);
+			Assert::IsTrue(_Site->ns_per_element > 0.0);
+
+			// the adaptive partitioner follows the advice
+			set_imbalance_profiling(imbalance_profiling::tune);
+			std::vector<double> _Expected(_Data);
+			std::for_each(std::begin(_Expected), std::end(_Expected), _Body);
+			for_each(par.with(partitioner(adaptive_)), std::begin(_Data), std::end(_Data), _Body);
+			Assert::IsTrue(_Expected == _Data);
+
+			set_imbalance_profiling(_Previous);
+			reset_imbalance_profiles();
+			Assert::AreEqual(size_t(0), get_imbalance_profiles(nullptr, 0));
+		}
+	};
+}
@@ -0,0 +1,78 @@
+#include "stdafx.h"
+
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TiledViewTest)
+	{
+		template<ptrdiff_t _Side, typename _ExPolicy>
+		void CheckTiledView(_ExPolicy&& _Policy, ptrdiff_t _Rows, ptrdiff_t _Cols)
+		{
+			typedef tiled_array_view<int, _Side> _Tiled_view;
+
+			std::vector<int> _In(_Rows * _Cols);
+			std::iota(std::begin(_In), std::end(_In), 1);
+			array_view<const int, 2> _In_av{ { _Rows, _Cols }, _In };
+
+			std::vector<int> _Storage(_Tiled_view::required_size({ _Rows, _Cols }));
+			_Tiled_view _Tiled({ _Rows, _Cols }, _Storage);
+			copy(_Policy, _In_av, _Tiled);
+
+			for (ptrdiff_t _Row = 0; _Row < _Rows; ++_Row)
+				for (ptrdiff_t _Col = 0; _Col < _Cols; ++_Col)
+					Assert::AreEqual(_In[_Row * _Cols + _Col], _Tiled[{ _Row, _Col }]);
+
+			// the padding of the edge tiles is left alone
+			for_each(_Policy, _Tiled, [](int& _Val) { _Val *= 2; });
+
+			std::vector<int> _Out(_In.size());
+			copy(_Policy, tiled_array_view<const int, _Side>(_Tiled), array_view<int, 2>{ { _Rows, _Cols }, _Out });
+			for (size_t _I = 0; _I < _In.size(); ++_I)
+				Assert::AreEqual(2 * _In[_I], _Out[_I]);
+
+			// a chore gets whole tiles
+			std::atomic<ptrdiff_t> _Visited(0);
+			for_each_tile(_Policy, _Tiled, [&_Tiled, &_Visited](const index<2>& _Origin, const strided_array_view<int, 2>& _Tile) {
+				Assert::IsTrue(&_Tile[{ 0, 0 }] == &_Tiled[_Origin]);
+				_Visited += _Tile.size();
+			});
+			Assert::AreEqual(_Tiled.size(), _Visited.load());
+		}
+
+		template<typename _ExPolicy>
+		void RunTiledView(_ExPolicy&& _Policy)
+		{
+			CheckTiledView<32>(_Policy, 1, 1);
+			CheckTiledView<32>(_Policy, 64, 64);
+			CheckTiledView<32>(_Policy, 100, 37);
+			CheckTiledView<16>(_Policy, 1, 300);
+			CheckTiledView<5>(_Policy, 200, 3);
+		}
+
+		TEST_METHOD(TiledView)
+		{
+			RunTiledView(seq);
+			RunTiledView(par);
+			RunTiledView(par_vec);
+			RunTiledView(par.with(partitioner(dynamic_)));
+			RunTiledView(execution_policy(par));
+		}
+
+		TEST_METHOD(TiledViewFromColumns)
+		{
+			// the columns of a row major matrix stored as the rows of a tiled one
+			std::vector<int> _In(300 * 200);
+			std::iota(std::begin(_In), std::end(_In), 0);
+			strided_array_view<const int, 2> _Columns{ { 200, 300 }, { 1, 200 }, _In.data() };
+
+			std::vector<int> _Storage(tiled_array_view<int>::required_size({ 200, 300 }));
+			tiled_array_view<int> _Tiled({ 200, 300 }, _Storage);
+			copy(par, _Columns, _Tiled);
+
+			for (ptrdiff_t _Row = 0; _Row < 200; ++_Row)
+				for (ptrdiff_t _Col = 0; _Col < 300; ++_Col)
+					Assert::AreEqual(_In[_Col * 200 + _Row], _Tiled[{ _Row, _Col }]);
+		}
+	};
+} // ParallelSTL_Tests
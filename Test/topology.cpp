@@ -0,0 +1,64 @@
+#include "stdafx.h"
+#include <list>
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(topology_tests)
+	{
+	public:
+		TEST_METHOD(Topology_Detected)
+		{
+			core_topology topology;
+			get_core_topology(topology);
+
+			Assert::IsTrue(topology.efficiency_classes >= 1);
+			Assert::IsTrue(topology.performance_threads >= 1);
+			if (topology.efficiency_classes == 1)
+				Assert::AreEqual(0u, topology.efficiency_threads);
+			Assert::IsTrue(topology.efficiency_speed_percent > 0 && topology.efficiency_speed_percent <= 100);
+		}
+
+		TEST_METHOD(Topology_Efficiency_Speed)
+		{
+			const unsigned int previous = set_efficiency_core_speed(50);
+			Assert::AreEqual(50u, set_efficiency_core_speed(200));
+
+			// clamped to the speed of a performance core, 0 for the default
+			core_topology topology;
+			get_core_topology(topology);
+			Assert::AreEqual(100u, topology.efficiency_speed_percent);
+			set_efficiency_core_speed(0);
+			get_core_topology(topology);
+			Assert::AreEqual(60u, topology.efficiency_speed_percent);
+
+			set_efficiency_core_speed(previous);
+		}
+
+		TEST_METHOD(Topology_Weighted_Static_Partitions)
+		{
+			const unsigned int previousSpeed = set_efficiency_core_speed(25);
+			const bool previousPinning = set_worker_pinning(true);
+
+			// every element is visited once whatever the shares of the threads
+			const size_t sizes[] = { 1, 7, 1000, 100003 };
+			for (auto size : sizes)
+			{
+				std::vector<int> data(size);
+				for_each(par.with(partitioner(static_)), data.begin(), data.end(), [](int& v) { ++v; });
+				Assert::IsTrue(std::all_of(data.begin(), data.end(), [](int v) { return v == 1; }));
+
+				std::list<int> list(size, 1);
+				Assert::AreEqual(static_cast<long long>(size), transform_reduce(par.with(partitioner(static_)), list.begin(), list.end(),
+					0ll, std::plus<long long>(), [](int v) { return static_cast<long long>(v); }));
+			}
+
+			core_topology topology;
+			get_core_topology(topology);
+			Assert::IsTrue(topology.workers_pinned);
+
+			Assert::IsTrue(set_worker_pinning(previousPinning));
+			set_efficiency_core_speed(previousSpeed);
+		}
+	};
+} // namespace ParallelSTL_Tests
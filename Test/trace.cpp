@@ -0,0 +1,51 @@
+#include "stdafx.h"
+#include <sstream>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TraceTest)
+	{
+	public:
+		TEST_METHOD(TraceChunkEvents)
+		{
+			std::vector<int> _Data(1000000);
+			std::iota(std::begin(_Data), std::end(_Data), 0);
+
+			const bool _Enabled = start_tracing();
+			Assert::AreEqual(_Enabled, tracing_active());
+			for_each(par, std::begin(_Data), std::end(_Data), [](int& _Val) { _Val *= 2; });
+			stop_tracing();
+			Assert::IsFalse(tracing_active());
+
+			auto _Events = take_trace();
+			if (!_Enabled)
+			{
+				Assert::IsTrue(_Events.empty());
+				return;
+			}
+
+			// a chunk is a part of the loop, the caller may run a short loop at once
+			size_t _Elements = 0;
+			for (auto& _Event : _Events)
+			{
+				if (strcmp(_Event.category, "chunk") == 0)
+				{
+					Assert::IsNotNull(_Event.name);
+					Assert::AreEqual("for_each", _Event.name);
+					Assert::IsTrue(_Event.worker != 0);
+					_Elements += _Event.count;
+				}
+			}
+			Assert::IsTrue(_Elements <= _Data.size());
+
+			std::ostringstream _Out;
+			write_chrome_trace(_Out);
+			const std::string _Json = _Out.str();
+			Assert::AreEqual(size_t(0), _Json.find("{\"traceEvents\":["));
+
+			// a stopped trace records nothing more
+			for_each(par, std::begin(_Data), std::end(_Data), [](int& _Val) { _Val /= 2; });
+			Assert::AreEqual(_Events.size(), take_trace().size());
+		}
+	};
+}
@@ -1,4 +1,5 @@
 #include "stdafx.h"
+#include <random>
 
 namespace ParallelSTL_Tests
 {
@@ -81,6 +82,12 @@ namespace ParallelSTL_Tests
 				TransformAlgoTest<_IterCat, _IterCat2> _Alg;
 				_Alg.set_result(transform(par_vec, _Alg.begin_in(), _Alg.end_in(), _Alg.begin_dest(), _Alg.binary()));
 			}
+
+			{  //par_affinity
+				affinity_partitioner _Affinity;
+				TransformAlgoTest<_IterCat, _IterCat2> _Alg;
+				_Alg.set_result(transform(par_affinity(_Affinity), _Alg.begin_in(), _Alg.end_in(), _Alg.begin_dest(), _Alg.binary()));
+			}
 		}
 
 		TEST_METHOD(Transform)
@@ -107,6 +114,12 @@ namespace ParallelSTL_Tests
 				TransformAlgoTest<_IterCat, _IterCat2> _Alg(true);
 				_Alg.set_result(transform(par_vec, _Alg.begin_in(), _Alg.end_in(), _Alg.begin_in2(), _Alg.begin_dest(), _Alg.binary_op()));
 			}
+
+			{  //par_affinity
+				affinity_partitioner _Affinity;
+				TransformAlgoTest<_IterCat, _IterCat2> _Alg(true);
+				_Alg.set_result(transform(par_affinity(_Affinity), _Alg.begin_in(), _Alg.end_in(), _Alg.begin_in2(), _Alg.begin_dest(), _Alg.binary_op()));
+			}
 		}
 
 		TEST_METHOD(TransformTwoParamsPred)
@@ -115,5 +128,28 @@ namespace ParallelSTL_Tests
 			RunTransformTwoParamsPred<forward_iterator_tag>();
 			RunTransformTwoParamsPred<input_iterator_tag, output_iterator_tag>();
 		}
+
+		TEST_METHOD(TransformPrefetchHint)
+		{
+			std::vector<size_t> _Index(50000);
+			std::iota(std::begin(_Index), std::end(_Index), size_t{ 0 });
+			std::shuffle(std::begin(_Index), std::end(_Index), std::mt19937(11));
+			std::vector<size_t> _Table(_Index.size());
+			std::iota(std::begin(_Table), std::end(_Table), size_t{ 1 });
+
+			const auto _Lookup = [&_Table](size_t _Idx) { return _Table[_Idx]; };
+			const auto _Ahead = [&_Table](size_t _Idx) { return &_Table[_Idx]; };
+			for (size_t _Distance : { 0, 16 })
+			{
+				std::vector<size_t> _Dest(_Index.size());
+				Assert::IsTrue(transform(par, std::begin(_Index), std::end(_Index), std::begin(_Dest), _Lookup, make_prefetch_hint(_Ahead, _Distance)) == std::end(_Dest));
+				for (size_t _I = 0; _I < _Index.size(); ++_I)
+					Assert::AreEqual(_Index[_I] + 1, _Dest[_I]);
+
+				std::vector<size_t> _Seq_dest(_Index.size());
+				Assert::IsTrue(transform(seq, std::begin(_Index), std::end(_Index), std::begin(_Seq_dest), _Lookup, make_prefetch_hint(_Ahead, _Distance)) == std::end(_Seq_dest));
+				Assert::IsTrue(_Dest == _Seq_dest);
+			}
+		}
 	};
 } // ParallelSTL_Tests
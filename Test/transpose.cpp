@@ -0,0 +1,86 @@
+#include "stdafx.h"
+
+using namespace std::experimental::D4087;
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(TransposeTest)
+	{
+		template<typename _Ty, typename _ExPolicy>
+		void CheckTranspose(_ExPolicy&& _Policy, ptrdiff_t _Rows, ptrdiff_t _Cols)
+		{
+			std::vector<_Ty> _In(_Rows * _Cols);
+			std::iota(std::begin(_In), std::end(_In), _Ty(1));
+
+			std::vector<_Ty> _Out(_In.size());
+			array_view<const _Ty, 2> _In_av{ { _Rows, _Cols }, _In };
+			array_view<_Ty, 2> _Out_av{ { _Cols, _Rows }, _Out };
+			transpose(_Policy, _In_av, _Out_av);
+
+			for (ptrdiff_t _Row = 0; _Row < _Rows; ++_Row)
+				for (ptrdiff_t _Col = 0; _Col < _Cols; ++_Col)
+					Assert::IsTrue(_In[_Row * _Cols + _Col] == _Out[_Col * _Rows + _Row]);
+
+			// transposed back the source is read along its columns
+			std::vector<_Ty> _Back(_In.size());
+			transpose(_Policy, _Out_av, array_view<_Ty, 2>{ { _Rows, _Cols }, _Back });
+			Assert::IsTrue(_In == _Back);
+		}
+
+		template<typename _ExPolicy>
+		void RunTranspose(_ExPolicy&& _Policy)
+		{
+			CheckTranspose<float>(_Policy, 1, 1);
+			CheckTranspose<float>(_Policy, 3, 5);
+			CheckTranspose<float>(_Policy, 256, 256);
+			CheckTranspose<float>(_Policy, 129, 131);
+			CheckTranspose<double>(_Policy, 100, 37);
+			CheckTranspose<double>(_Policy, 1, 1000);
+			CheckTranspose<int>(_Policy, 1000, 3);
+			CheckTranspose<short>(_Policy, 70, 90);
+			CheckTranspose<long long>(_Policy, 33, 17);
+		}
+
+		TEST_METHOD(Transpose)
+		{
+			RunTranspose(seq);
+			RunTranspose(par);
+			RunTranspose(par_vec);
+			RunTranspose(par.with(partitioner(dynamic_)));
+			RunTranspose(execution_policy(par));
+		}
+
+		TEST_METHOD(TransposeSection)
+		{
+			std::vector<int> _In(40 * 60);
+			std::iota(std::begin(_In), std::end(_In), 0);
+			array_view<const int, 2> _In_av{ { 40, 60 }, _In };
+
+			std::vector<int> _Image(80 * 70, -1);
+			array_view<int, 2> _Image_av{ { 80, 70 }, _Image };
+			transpose(par, _In_av, _Image_av.section({ 10, 5 }, { 60, 40 }));
+
+			for (ptrdiff_t _Row = 0; _Row < 80; ++_Row)
+				for (ptrdiff_t _Col = 0; _Col < 70; ++_Col)
+				{
+					const bool _Inside = _Row >= 10 && _Row < 70 && _Col >= 5 && _Col < 45;
+					Assert::AreEqual(_Inside ? _In[(_Col - 5) * 60 + _Row - 10] : -1, _Image[_Row * 70 + _Col]);
+				}
+		}
+
+		TEST_METHOD(CopyStridedColumns)
+		{
+			// the columns of a transposed view are copied by blocks to the rows of another one
+			std::vector<int> _In(300 * 200);
+			std::iota(std::begin(_In), std::end(_In), 0);
+			strided_array_view<const int, 2> _Columns{ { 200, 300 }, { 1, 200 }, _In.data() };
+
+			std::vector<int> _Out(_In.size());
+			copy(par, _Columns, array_view<int, 2>{ { 200, 300 }, _Out });
+
+			for (ptrdiff_t _Row = 0; _Row < 200; ++_Row)
+				for (ptrdiff_t _Col = 0; _Col < 300; ++_Col)
+					Assert::AreEqual(_In[_Col * 200 + _Row], _Out[_Row * 300 + _Col]);
+		}
+	};
+} // ParallelSTL_Tests
@@ -1,5 +1,7 @@
 #include "stdafx.h"
 
+#include <list>
+
 namespace ParallelSTL_Tests
 {
 	TEST_CLASS(UniqueTest)
@@ -189,5 +191,70 @@ namespace ParallelSTL_Tests
 
 			Assert::AreEqual(static_cast<size_t>(std::distance(std::begin(vec), _Iter)), size_t{ 9 });
 		}
+
+		template<typename _ExecutionPolicy, typename _Container>
+		static void CheckRunLengthEncode(const _ExecutionPolicy& _Policy, const _Container& _Ct)
+		{
+			std::vector<int> _Expected_values;
+			std::vector<size_t> _Expected_counts;
+			for (auto _It = std::begin(_Ct); _It != std::end(_Ct); ++_It)
+			{
+				if (_Expected_values.empty() || _Expected_values.back() != *_It) {
+					_Expected_values.push_back(*_It);
+					_Expected_counts.push_back(0);
+				}
+				++_Expected_counts.back();
+			}
+
+			std::vector<int> _Values(_Ct.size());
+			std::vector<size_t> _Counts(_Ct.size());
+			auto _Ends = run_length_encode(_Policy, std::begin(_Ct), std::end(_Ct), _Values.begin(), _Counts.begin());
+			_Values.erase(_Ends.first, _Values.end());
+			_Counts.erase(_Ends.second, _Counts.end());
+
+			Assert::IsTrue(_Expected_values == _Values);
+			Assert::IsTrue(_Expected_counts == _Counts);
+			Assert::AreEqual(_Expected_values.size(), unique_count(_Policy, std::begin(_Ct), std::end(_Ct)));
+		}
+
+		TEST_METHOD(RunLengthEncode)
+		{
+			// Runs of every length, some of them much longer than a chunk
+			std::vector<int> _Vec;
+			for (int _Run = 0; _Run < 400; ++_Run)
+				_Vec.insert(_Vec.end(), _Run % 7 == 0 ? 5000 + _Run : 1 + _Run % 13, _Run);
+
+			CheckRunLengthEncode(seq, _Vec);
+			CheckRunLengthEncode(par, _Vec);
+			CheckRunLengthEncode(par_vec, _Vec);
+			CheckRunLengthEncode(execution_policy(par), _Vec);
+			CheckRunLengthEncode(par, std::list<int>(_Vec.begin(), _Vec.end()));
+
+			// One run over the whole range, and no run longer than one
+			CheckRunLengthEncode(par, std::vector<int>(100000, 3));
+			std::vector<int> _Distinct(100000);
+			std::iota(_Distinct.begin(), _Distinct.end(), 0);
+			CheckRunLengthEncode(par, _Distinct);
+
+			CheckRunLengthEncode(par, std::vector<int>());
+			CheckRunLengthEncode(par, std::vector<int>(1, 7));
+		}
+
+		TEST_METHOD(UniqueCountShort)
+		{
+			// a range of one element has no pair to compare, none of the partitioners gets a loop of it
+			const std::list<int> _One(1, 7);
+			const std::vector<int> _One_vec(1, 7);
+			Assert::AreEqual(size_t(1), unique_count(par, std::begin(_One), std::end(_One)));
+			Assert::AreEqual(size_t(1), unique_count(par.with(partitioner(adaptive_)), std::begin(_One), std::end(_One)));
+			Assert::AreEqual(size_t(1), unique_count(par.with(partitioner(adaptive_)), std::begin(_One_vec), std::end(_One_vec)));
+			Assert::AreEqual(size_t(1), unique_count(seq, std::begin(_One), std::end(_One)));
+
+			const std::list<int> _Empty;
+			Assert::AreEqual(size_t(0), unique_count(par.with(partitioner(adaptive_)), std::begin(_Empty), std::end(_Empty)));
+
+			const std::list<int> _Two = { 7, 8 };
+			Assert::AreEqual(size_t(2), unique_count(par.with(partitioner(adaptive_)), std::begin(_Two), std::end(_Two)));
+		}
 	};
 }
@@ -0,0 +1,63 @@
+#include "stdafx.h"
+#include <vector>
+
+namespace ParallelSTL_Tests
+{
+	TEST_CLASS(worker_parking_tests)
+	{
+	public:
+		TEST_METHOD(Parking_Spin_Budget)
+		{
+			const unsigned int previous = set_worker_spin_budget(0);
+			Assert::AreEqual(0u, worker_spin_budget());
+			Assert::AreEqual(0u, set_worker_spin_budget(1000));
+			Assert::AreEqual(1000u, worker_spin_budget());
+			set_worker_spin_budget(previous);
+		}
+
+		TEST_METHOD(Parking_Wake_After_Idle)
+		{
+			const unsigned int previous = set_worker_spin_budget(0);
+			reset_statistics();
+
+			std::vector<long long> data(1 << 18);
+			std::iota(data.begin(), data.end(), 0ll);
+			const long long expected = static_cast<long long>(data.size()) * (data.size() - 1) / 2;
+
+			// the workers park between the calls and are woken by the pushes of the next one
+			for (int call = 0; call < 10; ++call)
+			{
+				Assert::AreEqual(expected, reduce(par, data.begin(), data.end(), 0ll));
+				Sleep(20);
+			}
+
+			scheduler_statistics stats;
+			get_scheduler_statistics(stats);
+			if (telemetry_enabled())
+				Assert::IsTrue(stats.worker_parks > 0);
+			else
+				Assert::AreEqual(size_t(0), stats.worker_parks);
+
+			set_worker_spin_budget(previous);
+		}
+
+		TEST_METHOD(Parking_Arena_Destroyed)
+		{
+			const unsigned int previous = set_worker_spin_budget(0);
+
+			std::vector<int> data(100000);
+			for (int round = 0; round < 4; ++round)
+			{
+				// the destructor wakes the parked workers of the arena and waits for them to retire
+				task_arena arena(4);
+				arena.execute([&] {
+					for_each(par.with(partitioner(dynamic_)), data.begin(), data.end(), [](int& v) { ++v; });
+				});
+				Sleep(10);
+			}
+			Assert::IsTrue(std::all_of(data.begin(), data.end(), [](int v) { return v == 4; }));
+
+			set_worker_spin_budget(previous);
+		}
+	};
+} // namespace ParallelSTL_Tests
@@ -0,0 +1,88 @@
+#pragma once
+
+#ifndef _IMPL_ADJACENT_DIFFERENCE_H_
+#define _IMPL_ADJACENT_DIFFERENCE_H_ 1
+
+#include "algorithm_impl.h"
+#include "transform.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	//
+	// adjacent_difference
+	//
+	template <class _InIt, class _OutIt, class _BinOp, class _IterCat>
+	_OutIt _Adjacent_difference_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _IterCat)
+	{
+		_EXP_TRY
+			return std::adjacent_difference(_First, _Last, _Dest, _Op);
+		_EXP_RETHROW
+	}
+
+	// Every output reads its element and the one before it, so the range is the binary transform
+	// of itself and itself shifted by one. A chunk reads the element before its first one from the
+	// range of the previous chunk, it's never written, and par_vec gets the raw pointer loop.
+	template <class _ExPolicy, class _InIt, class _OutIt, class _BinOp, class _IterCat>
+	_OutIt _Adjacent_difference_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _IterCat _Cat)
+	{
+		if (_First == _Last)
+			return _Dest;
+
+		*_Dest = *_First;
+
+		_InIt _Next = _First;
+		return _Transform_impl_binary(_Policy, ++_Next, _Last, _First, ++_Dest, _Op, _Cat);
+	}
+
+	// An input iterator can't be read twice
+	template <class _ExPolicy, class _InIt, class _OutIt, class _BinOp>
+	typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Adjacent_difference_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, std::input_iterator_tag _Cat)
+	{
+		return _Adjacent_difference_impl(seq, _First, _Last, _Dest, _Op, _Cat);
+	}
+
+	template <class _InIt, class _OutIt, class _BinOp, class _IterCat>
+	_OutIt _Adjacent_difference_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Adjacent_difference_impl, _Policy, _First, _Last, _Dest, _Op, _Cat);
+	}
+} // details
+
+// The output range must not overlap the input, the chunks would read elements already overwritten
+template <class _ExPolicy, class _InIt, class _OutIt, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type adjacent_difference(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("adjacent_difference");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
+	return details::_Adjacent_difference_impl(_Policy, _First, _Last, _Dest, _Op, _Cat);
+}
+
+template <class _ExPolicy, class _InIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type adjacent_difference(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("adjacent_difference");
+	return adjacent_difference(_Policy, _First, _Last, _Dest, std::minus<>());
+}
+
+// partial_sum is the inclusive scan from the first element, the parallel one may regroup the
+// sums so _Op must be associative
+template <class _ExPolicy, class _InIt, class _OutIt, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type partial_sum(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("partial_sum");
+	return transform_inclusive_scan(_Policy, _First, _Last, _Dest, _Op, details::_Identity_transform());
+}
+
+template <class _ExPolicy, class _InIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type partial_sum(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("partial_sum");
+	return partial_sum(_Policy, _First, _Last, _Dest, std::plus<>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_ADJACENT_DIFFERENCE_H_
@@ -19,7 +19,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _FwdIt, class _BinPr, class _IterCat>
-	inline _FwdIt _Adjacent_find_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _BinPr _Pred, _IterCat)
+	inline _FwdIt _Adjacent_find_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _BinPr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_FwdIt>::difference_type difference_type;
@@ -32,19 +32,20 @@ namespace details {
 
 			cancellation_token_with_position<difference_type> _Token(_Size);
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size - 1, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Size - 1, _Pred,
 				[&_Token, &_First](_FwdIt _Begin, size_t _Count, _BinPr& _UserFunc){
 				auto _Dist = std::distance(_First, _Begin);
 
 				auto _Prev = _Begin;
 				++_Begin;
+				_Cancellation_poll<_FwdIt> _Poll;
 
 				for (size_t _Curr_pos = 0; _Curr_pos < _Count; ++_Curr_pos, ++_Begin) {
 					if (_UserFunc(*_Prev, *_Begin)) {
 						_Token.cancel(_Dist + _Curr_pos);
 						break;
 					}
-					else if (_Token.is_cancelled(_Dist))
+					else if (_Poll.due() && _Token.is_cancelled(_Dist + _Curr_pos))
 						break;
 
 					_Prev = _Begin;
@@ -71,6 +72,7 @@ namespace details {
 template<class _ExPolicy, class _FwdIt, class _BinPr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type adjacent_find(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _BinPr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("adjacent_find");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Adjacent_find_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -79,6 +81,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type adjacent_fin
 template<class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type adjacent_find(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("adjacent_find");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Adjacent_find_impl(_Policy, _First, _Last, std::equal_to<>(), std::_Iter_cat(_First));
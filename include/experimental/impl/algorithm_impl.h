@@ -7,6 +7,7 @@
 #pragma warning(disable: 4503) // decorated name length exceeded, name was truncated
 
 #include <vector>
+#include <algorithm>
 #include <string>
 #include <iterator>
 #include <type_traits>
@@ -14,6 +15,13 @@
 #include <memory>
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <limits>
+#include <typeinfo>
+#include <cstring>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #include "defines.h"
 #include <experimental/execution_policy>
@@ -21,10 +29,32 @@
 
 #include "algorithm_scheduler.h"
 #include "event.h"
+#include "taskgroup.h"
+#include "telemetry.h"
+#include "trace.h"
+#include "coordinate.h"
+#include "array_view.h"
+#include "segmented_iterator.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
 
+	// A thread remembers the node it last used in a few combinable objects, keyed by the object's
+	// instance key. Keys come from a process wide counter and are never reused, so the entry of a
+	// destroyed or cleared object just stops matching.
+	struct _Combinable_cache_entry
+	{
+		size_t _Key;
+		void *_Node;
+	};
+
+	const size_t _Combinable_cache_ways = 8;
+
+	_EXP_IMPL size_t __cdecl _Next_combinable_key();
+
+	// The _Combinable_cache_ways entries of the calling thread
+	_EXP_IMPL _Combinable_cache_entry * __cdecl _Thread_combinable_cache();
+
 #pragma warning(push)
 	// object allocated on the heap may not be aligned 64
 #pragma warning(disable: 4316)
@@ -82,7 +112,7 @@ namespace details {
 		/// </remarks>
 		/// <seealso cref="Parallel Containers and Objects"/>
 		combinable()
-			: _Fn_initialize(_Default_init)
+			: _Instance_key(_Next_combinable_key()), _Fn_initialize(_Default_init), _Resource(_Scratch_resource())
 		{
 			_FwdItNew();
 		}
@@ -106,7 +136,7 @@ namespace details {
 		/// <seealso cref="Parallel Containers and Objects"/>
 		template <typename _Function>
 		explicit combinable(_Function _Initialize)
-			: _Fn_initialize(_Initialize)
+			: _Instance_key(_Next_combinable_key()), _Fn_initialize(_Initialize), _Resource(_Scratch_resource())
 		{
 			_FwdItNew();
 		}
@@ -125,7 +155,7 @@ namespace details {
 		/// </remarks>
 		/// <seealso cref="Parallel Containers and Objects"/>
 		combinable(const combinable& _Copy)
-			: _Size(_Copy._Size), _Fn_initialize(_Copy._Fn_initialize)
+			: _Size(_Copy._Size), _Instance_key(_Next_combinable_key()), _Fn_initialize(_Copy._Fn_initialize), _Resource(_Scratch_resource())
 		{
 			_FwdItCopy(_Copy);
 		}
@@ -142,9 +172,9 @@ namespace details {
 		combinable& operator=(const combinable& _Copy)
 		{
 			clear();
-			delete [] _Buckets;
+			_Deallocate_scratch(_Resource, const_cast<_Node **>(_Buckets), _Size);
 			_Fn_initialize = _Copy._Fn_initialize;
-			_Size = _Copy._M_size;
+			_Size = _Copy._Size;
 			_FwdItCopy(_Copy);
 
 			return *this;
@@ -155,8 +185,8 @@ namespace details {
 		/// </summary>
 		~combinable()
 		{
-			clear();
-			delete [] _Buckets;
+			_Delete_nodes();
+			_Deallocate_scratch(_Resource, const_cast<_Node **>(_Buckets), _Size);
 		}
 
 		/// <summary>
@@ -186,6 +216,14 @@ namespace details {
 		/// <seealso cref="Parallel Containers and Objects"/>
 		_Ty& local(bool& _Exists)
 		{
+			// The node this thread used last is found without hashing the thread id
+			_Combinable_cache_entry& _Cached = _Thread_combinable_cache()[_Instance_key % _Combinable_cache_ways];
+			if (_Cached._Key == _Instance_key)
+			{
+				_Exists = true;
+				return static_cast<_Node*>(_Cached._Node)->_Value;
+			}
+
 			auto _Key = get_current_thread_id();
 			size_t _Index;
 			_Node* _ExistingNode = _FindLocalItem(_Key, &_Index);
@@ -200,25 +238,44 @@ namespace details {
 			}
 
 			_ASSERTE(_ExistingNode != nullptr);
+			_Cached._Key = _Instance_key;
+			_Cached._Node = _ExistingNode;
 			return _ExistingNode->_Value;
 		}
 
 		/// <summary>
 		///     Clears any intermediate computational results from a previous usage.
 		/// </summary>
+		/// <remarks>
+		///     The thread-private nodes are freed. A repeated algorithm that only needs fresh values should use
+		///     <see cref="combinable::reset Method"/> instead.
+		/// </remarks>
 		void clear()
+		{
+			_Delete_nodes();
+			memset((void*) _Buckets, 0, _Size * sizeof _Buckets[0]);
+
+			// The nodes cached by the threads are gone
+			_Instance_key = _Next_combinable_key();
+		}
+
+		/// <summary>
+		///     Sets every thread-private sub-computation back to the value of the initialization functor and keeps
+		///     the nodes that hold them, so threads that call <c>local</c> again do not allocate.
+		/// </summary>
+		/// <remarks>
+		///     As for <c>clear</c>, no thread may use the object meanwhile. The reset sub-computations still exist:
+		///     <c>local(bool&amp;)</c> sets its argument to <c>true</c> on a thread that had one before.
+		/// </remarks>
+		void reset()
 		{
 			for (size_t _Index = 0; _Index < _Size; ++_Index)
 			{
-				_Node* _CurrentNode = _Buckets[_Index];
-				while (_CurrentNode != nullptr)
+				for (_Node* _CurrentNode = _Buckets[_Index]; _CurrentNode != nullptr; _CurrentNode = _CurrentNode->_Chain)
 				{
-					_Node* _NextNode = _CurrentNode->_Chain;
-					delete _CurrentNode;
-					_CurrentNode = _NextNode;
+					_CurrentNode->_Value = _Fn_initialize();
 				}
 			}
-			memset((void*) _Buckets, 0, _Size * sizeof _Buckets[0]);
 		}
 
 		/// <summary>
@@ -302,6 +359,29 @@ namespace details {
 			}
 		}
 
+		/// <summary>
+		///     Computes a final value from the set of thread-local sub-computations by combining them in a binary
+		///     tree, the wide levels of the tree in parallel.
+		/// </summary>
+		/// <typeparam name="_Function">
+		///     The type of the function object that will be invoked to combine two thread-local sub-computations.
+		/// </typeparam>
+		/// <param name="_Fn_combine">
+		///     The functor that is used to combine the sub-computations. Its signature is <c>T (T, T)</c> or
+		///     <c>T (const T&amp;, const T&amp;)</c>, it must be associative and commutative and may be called
+		///     from several threads at a time.
+		/// </param>
+		/// <returns>
+		///     The final result of combining all the thread-private sub-computations.
+		/// </returns>
+		/// <remarks>
+		///     Worth it over <c>combine</c> when there are many sub-computations or the functor is expensive,
+		///     e.g. merging per thread containers.
+		/// </remarks>
+		/// <seealso cref="Parallel Containers and Objects"/>
+		template<typename _Function>
+		_Ty combine_parallel(_Function _Fn_combine) const;
+
 		size_t size() const _NOEXCEPT
 		{
 			return _Size;
@@ -338,25 +418,59 @@ namespace details {
 		void _FwdItNew()
 		{
 			_Size = _GetCombinableSize();
-			_Buckets = new _Node*[_Size];
+			_Buckets = _Allocate_scratch<_Node*>(_Resource, _Size);
 			memset((void*) _Buckets, 0, _Size * sizeof _Buckets[0]);
 		}
 
+		void _Delete_nodes()
+		{
+			for (size_t _Index = 0; _Index < _Size; ++_Index)
+			{
+				_Node* _CurrentNode = _Buckets[_Index];
+				while (_CurrentNode != nullptr)
+				{
+					_Node* _NextNode = _CurrentNode->_Chain;
+					_Free_node(_CurrentNode);
+					_CurrentNode = _NextNode;
+				}
+			}
+		}
+
 		void _FwdItCopy(const combinable& _Copy)
 		{
-			_Buckets = new _Node*[_Size];
+			_Buckets = _Allocate_scratch<_Node*>(_Resource, _Size);
 			for (size_t _Index = 0; _Index < _Size; ++_Index)
 			{
 				_Buckets[_Index] = nullptr;
 				for (_Node* _CurrentNode = _Copy._Buckets[_Index]; _CurrentNode != nullptr; _CurrentNode = _CurrentNode->_Chain)
 				{
-					_Node* _NewNode = new _Node(_CurrentNode->_Key, _CurrentNode->_Value);
+					_Node* _NewNode = _New_node(_CurrentNode->_Key, _CurrentNode->_Value);
 					_NewNode->_Chain = _Buckets[_Index];
 					_Buckets[_Index] = _NewNode;
 				}
 			}
 		}
 
+		_Node* _New_node(size_t _Key, _Ty _Value)
+		{
+			_Node* _Storage = _Allocate_scratch<_Node>(_Resource, 1);
+			try
+			{
+				return ::new (static_cast<void *>(_Storage)) _Node(_Key, std::move(_Value));
+			}
+			catch (...)
+			{
+				_Deallocate_scratch(_Resource, _Storage, 1);
+				throw;
+			}
+		}
+
+		void _Free_node(_Node* _Item)
+		{
+			_Item->~_Node();
+			_Deallocate_scratch(_Resource, _Item, 1);
+		}
+
 		_Node* _FindLocalItem(size_t _Key, size_t* _PIndex)
 		{
 			_ASSERTE(_PIndex != nullptr);
@@ -380,7 +494,7 @@ namespace details {
 
 		_Node* _AddLocalItem(size_t _Key, size_t _Index)
 		{
-			_Node* _NewNode = new _Node(_Key, _Fn_initialize());
+			_Node* _NewNode = _New_node(_Key, _Fn_initialize());
 			_Node* _TopNode;
 			do
 			{
@@ -394,11 +508,33 @@ namespace details {
 	private:
 		_Node *volatile * _Buckets;
 		size_t _Size;
+		size_t _Instance_key;
 		std::function<_Ty()> _Fn_initialize;
+		memory_resource *_Resource; // of the thread that constructed the object, the nodes of all threads come from it
 	};
 
 #pragma warning(pop) // C4316
 
+	// Contiguous Container Iterator Traits
+	// Please note, it will NOT identify all contiguous iterators. It only tries its best.
+	// vector<bool> packs its elements in words, its references are proxies without an address.
+	template <typename _ItrType>
+	struct _Contiguous_container_iterator_traits : std::integral_constant<bool,
+		std::is_pointer<_ItrType>::value
+		|| (std::is_convertible<_ItrType, typename std::vector<typename std::iterator_traits<_ItrType>::value_type>::const_iterator>::value
+			&& !std::is_same<typename std::iterator_traits<_ItrType>::value_type, bool>::value)
+		|| std::is_convertible<_ItrType, typename std::string::const_iterator>::value
+		|| std::is_convertible<_ItrType, typename std::wstring::const_iterator>::value>
+	{};
+
+	// Raw pointer to the element of a contiguous iterator, loops through it are unchecked and
+	// easier for the vectorizer. _It must be dereferenceable.
+	template <typename _It>
+	inline typename std::iterator_traits<_It>::pointer _Unwrap_contiguous(const _It& _Iter)
+	{
+		return std::addressof(*_Iter);
+	}
+
 	// Helper that picks the lowest common iterator type from given iterator tags
 	template<class _IterTag0, class _IterTag1>
 	struct common_iterator_helper
@@ -668,838 +804,2860 @@ namespace details {
 	private:
 		value_type _Myval;
 	};
-	template<typename ... _It>
-	class composable_iterator :
-		public composable_iterator_base<typename common_iterator<_It...>::iterator_category, _It...>
-	{
-	public:
-		composable_iterator(const _It&... _Val) :
-			composable_iterator_base(_Val...) {}
 
-		composable_iterator() : composable_iterator_base() {}
-	};
+	class _Filter_mask_iterator;
 
+	// Members of a zip iterator, addressed by an offset from their first position
 	template<typename _It>
-	class composable_iterator<_It> :
-		public composable_iterator_base<typename std::iterator_traits<_It>::iterator_category, _It>
+	struct _Is_zip_member : std::integral_constant<bool, _Contiguous_container_iterator_traits<_It>::value
+		|| std::is_same<_It, _Filter_mask_iterator>::value>
 	{
-	public:
-		composable_iterator(const _It& _Val) :
-			composable_iterator_base(_Val) {}
-
-		composable_iterator() : composable_iterator_base() {}
 	};
 
 	template<typename ... _It>
-	composable_iterator<_It...> make_composable_iterator(const _It&... _Val)
-	{
-		return composable_iterator<_It...>(_Val...);
-	}
+	struct _Is_zip_range;
 
-
-	class _Partition_status_tracker
+	template<typename _It0, typename ... _It>
+	struct _Is_zip_range<_It0, _It...> : std::integral_constant<bool, _Is_zip_member<_It0>::value && _Is_zip_range<_It...>::value>
 	{
-		size_t _PartitionNum;
-	public:
-		_Partition_status_tracker() : _PartitionNum(0) {}
-
-		_EXP_IMPL bool _IsPartitionNumUnderLimit();
-
-		_EXP_IMPL void _AddPartitions(size_t);
+	};
 
-		_EXP_IMPL ~_Partition_status_tracker();
+	template<>
+	struct _Is_zip_range<> : std::true_type
+	{
 	};
 
-	class _Contextaware_waitable_chore : public _Threadpool_chore
+	// composable_iterator of contiguous ranges and filter masks: the members keep their first position
+	// and share one offset, stepping the iterator is one add whatever the number of members. The
+	// positions are made on dereference, the chores take raw pointers through _Unwrap_zip_member.
+	template<typename ... _It>
+	class _Zip_iterator_base
 	{
-		CompletionEvent *_ChoreSetCmpEvent;
-		std::atomic<size_t> _Counter;
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef std::tuple<_It...> value_type;
+		typedef typename iterator_traits<typename extract_iterator<_It...>::iterator>::difference_type difference_type;
+		typedef void pointer;
+		typedef value_type reference;
+		typedef _Zip_iterator_base<_It... > _Myiter;
 
-		void _CompleteOne()
+	private:
+		template<typename _Tuple, size_t _Count>
+		struct _Advance_members
 		{
-			auto _Ref = --_Counter;
-			_ASSERTE(_Ref >= 0);
-			if (_Ref == 0)
+			static void _Apply(_Tuple& _T, difference_type _Off)
 			{
-				_ASSERT(_ChoreSetCmpEvent);
-				_ChoreSetCmpEvent->completeOne();
+				std::get<_Count - 1>(_T) += _Off;
+				_Advance_members<_Tuple, _Count - 1>::_Apply(_T, _Off);
 			}
-		}
+		};
 
-		_EXP_IMPL static void _Set_current_chore(_Contextaware_waitable_chore *);
-	public:
-		virtual void waitable_invoke() = 0;
+		template<typename _Tuple>
+		struct _Advance_members<_Tuple, 0>
+		{
+			static void _Apply(_Tuple&, difference_type)
+			{
+			}
+		};
 
-		virtual void __cdecl invoke() override final
+		value_type _Origin;
+		difference_type _Offset;
+
+		value_type _At(difference_type _Off) const
 		{
-			_Contextaware_waitable_chore *_Backup = current_chore();
-			_Set_current_chore(this);
-			waitable_invoke();
-			_Set_current_chore(_Backup);
-			_CompleteOne();
+			value_type _Pos = _Origin;
+			_Advance_members<value_type, sizeof...(_It)>::_Apply(_Pos, _Offset + _Off);
+			return _Pos;
 		}
 
-		_Contextaware_waitable_chore() : _ChoreSetCmpEvent(nullptr), _Counter(2) {}
-		_Contextaware_waitable_chore(const _Contextaware_waitable_chore &) : _ChoreSetCmpEvent(nullptr), _Counter(2) {}
+	public:
+		_Zip_iterator_base(const _It&... _Args) : _Origin(_Args...), _Offset(0)
+		{
+		}
 
-		// hide the base case reschedule() method
-		void reschedule()
+		_Zip_iterator_base() : _Origin(), _Offset(0)
 		{
-			auto _Ref = ++_Counter;
-			_ASSERTE(_Ref >= 1);
-			if (_Ref == 1)
-			{
-				_ASSERT(_ChoreSetCmpEvent);
-				_ChoreSetCmpEvent->addOne();
-			}
-			_Threadpool_chore::reschedule();
 		}
 
-		// wait can only be called once
-		template <typename _RangeCt>
-		static void wait(_RangeCt &_Range)
+		reference operator*() const
 		{
-			if (_Range.empty())
-				return;
+			return _At(0);
+		}
 
-			CompletionEvent _Event(_Range.size());
-			for (auto &_Chore : _Range)
-			{
-				if (_Chore.is_scheduled())
-				{
-					_ASSERT(_Chore._ChoreSetCmpEvent == nullptr);
-					_Chore._ChoreSetCmpEvent = &_Event;
-					_Chore._CompleteOne();
-				}
-				else // we assume the chore is completed if it has never been scheduled
-					_Event.completeOne();
-			}
+		reference operator[](difference_type _Off) const
+		{
+			return _At(_Off);
+		}
 
-			_Event.wait();
+		_Myiter& operator++()
+		{
+			++_Offset;
+			return (*this);
 		}
 
-		_EXP_IMPL static _Contextaware_waitable_chore * current_chore();
+		_Myiter operator++(int)
+		{
+			_Myiter _Tmp = *this;
+			++_Offset;
+			return (_Tmp);
+		}
 
-	};
+		_Myiter& operator--()
+		{
+			--_Offset;
+			return (*this);
+		}
 
-	// Disable warning C4324: structure was padded due to __declspec(align())
-	// This padding is expected and necessary.
-#pragma warning(push)
-#pragma warning(disable: 4324)			
-	template <typename _It, typename _UserData, typename _Callback>
-	class __declspec(align(64)) _Static_chore_noexcept :
-		public _Contextaware_waitable_chore
-	{
-	protected:
-		_Static_chore_noexcept& operator=(const _Static_chore_noexcept&) {};
+		_Myiter operator--(int)
+		{
+			_Myiter _Tmp = *this;
+			--_Offset;
+			return (_Tmp);
+		}
 
-		_It _Begin;
-		size_t _Count;
-		const _Callback& _AlgoCallback;
-		_UserData _AlgoData;
-	public:
-		_Static_chore_noexcept()
+		_Myiter& operator+=(difference_type _Off)
 		{
+			_Offset += _Off;
+			return (*this);
 		}
 
-		_Static_chore_noexcept(_It _First, size_t _Dist, _UserData _Data, const _Callback& _Func) :
-			_Begin(std::move(_First)), _Count(_Dist), _AlgoData(std::move(_Data)), _AlgoCallback(_Func) {}
+		_Myiter operator+(difference_type _Off) const
+		{
+			_Myiter _Tmp = *this;
+			return (_Tmp += _Off);
+		}
 
-		virtual void waitable_invoke() override
+		_Myiter& operator-=(difference_type _Off)
 		{
-			_ASSERTE(_Count > 0);
-			_AlgoCallback(_Begin, _Count, _AlgoData);
+			_Offset -= _Off;
+			return (*this);
 		}
 
-		void rethrow_exception()
+		_Myiter operator-(difference_type _Off) const
 		{
+			_Myiter _Tmp = *this;
+			return (_Tmp -= _Off);
 		}
-		template <typename _PartTag, bool _IsNoExcept> friend struct _Partitioner;
-	};
 
-	template <typename _It, typename _UserData, typename _Callback>
-	class __declspec(align(64)) _Static_chore :
-		public _Static_chore_noexcept<_It, _UserData, _Callback>
-	{
-		_Static_chore& operator=(const _Static_chore&) {}
+		difference_type operator-(const _Myiter& _Right) const
+		{	// the iterators may come from different first positions in the same ranges
+			return (std::get<0>(_Origin) - std::get<0>(_Right._Origin)) + (_Offset - _Right._Offset);
+		}
 
-		std::exception_ptr _Exception;
-	public:
-		_Static_chore()
+		bool operator==(const _Myiter& _Right) const
 		{
+			return (*this - _Right) == 0;
 		}
 
-		_Static_chore(_It _First, size_t _Count, _UserData _Data, const _Callback& _Func) :
-			_Static_chore_noexcept(std::move(_First), _Count, std::move(_Data), _Func), _Exception(nullptr)
+		bool operator!=(const _Myiter& _Right) const
 		{
+			return (!(*this == _Right));
 		}
 
-		virtual void waitable_invoke() override
+		bool operator<(const _Myiter& _Right) const
 		{
-			try {
-				_ASSERTE(_Count > 0);
-				_AlgoCallback(_Begin, _Count, _AlgoData);
-			}
-			catch (...) {
-				_Exception = std::current_exception();
-			}
+			return (*this - _Right) < 0;
 		}
 
-		void rethrow_exception()
+		bool operator>(const _Myiter& _Right) const
 		{
-			if (_Exception != nullptr)
-			{
-				std::list<std::exception_ptr> _ExList;
-				_ExList.push_back(std::move(_Exception));
-				throw exception_list(std::move(_ExList));
-			}
+			return (_Right < *this);
 		}
 
-		template <typename _RangeCt>
-		static void wait(_RangeCt &_Range)
+		bool operator<=(const _Myiter& _Right) const
 		{
-			_Contextaware_waitable_chore::wait(_Range);
-			std::list<std::exception_ptr> _ExList;
-			for (auto &_Chore : _Range)
-			{
-				if (_Chore._Exception != nullptr)
-					_ExList.push_back(std::move(_Chore._Exception));
-			}
-
-			if (!_ExList.empty())
-				throw exception_list(std::move(_ExList));
+			return (!(_Right < *this));
 		}
 
-		template <typename _PartTag, bool _IsNoExcept> friend struct _Partitioner;
+		bool operator>=(const _Myiter& _Right) const
+		{
+			return (!(*this < _Right));
+		}
 	};
-#pragma warning(pop) // C4324
-
-	/*
-	//The implementation of dynamic partitioner is broken thus commented out
-	template <typename _It, typename _Fn>
-	class _Semi_splittable_chore : public _Contextaware_waitable_chore
-	{
-	_Semi_splittable_chore& operator=(const _Semi_splittable_chore&) {}
 
-	_It _Begin;
-	// TODO: change long back to atomic<size_t> after testing the performance of new STL
-	volatile long _Size;
-	long _Chunk_size;
-
-	struct ExceptionListNode
+	template<typename ... _It>
+	struct _Composable_iterator_base
 	{
-	std::exception_ptr _Exception;
-	ExceptionListNode *_Next;
+		typedef typename std::conditional<_Is_zip_range<_It...>::value,
+			_Zip_iterator_base<_It...>,
+			composable_iterator_base<typename common_iterator<_It...>::iterator_category, _It...> >::type type;
 	};
 
-	ExceptionListNode * volatile _Exception_list;
-
-	void push_exception(std::exception_ptr&& _ExPtr)
+	template<typename ... _It>
+	class composable_iterator :
+		public _Composable_iterator_base<_It...>::type
 	{
-	auto _Node = new ExceptionListNode;
-	_Node->_Exception = std::move(_ExPtr);
-	_Node->_Next = _Exception_list;
-
-	while (_InterlockedCompareExchangePointer(reinterpret_cast<void *volatile *>(&_Exception_list), _Node, _Node->_Next) != _Node->_Next)
-	_Node->_Next = _Exception_list;
-	}
-
-	const _Fn _Func;
+		typedef typename _Composable_iterator_base<_It...>::type _Mybase;
 	public:
+		composable_iterator(const _It&... _Val) :
+			_Mybase(_Val...) {}
 
-	_Semi_splittable_chore(_It _First, size_t _S, const _Fn& _Fn, size_t _Chunk) :
-	_Begin(_First), _Size(static_cast<long>(_S)), _Func(_Fn), _Chunk_size(static_cast<long>(_Chunk)), _Exception_list(nullptr)
-	{
-	}
-
-	virtual void waitable_invoke() override
-	{
-	long _Len = _Size;
-	_It _Curr = _Begin;
-	_Size = 0;
+		composable_iterator() : _Mybase() {}
+	};
 
-	try
-	{
-	while (_Len > _Chunk_size)
-	{
-	if (!_Size && _InterlockedCompareExchange(&_Size, (_Len - _Len) / 2, 0) == 0)
+	template<typename _It>
+	class composable_iterator<_It> :
+		public composable_iterator_base<typename std::iterator_traits<_It>::iterator_category, _It>
 	{
-	_Len /= 2;
-	_Begin = _Curr;
-	std::advance(_Begin, _Len);
-	reschedule();
-	}
+	public:
+		composable_iterator(const _It& _Val) :
+			composable_iterator_base(_Val) {}
 
-	_Func(_Curr, (std::min)(_Len, _Chunk_size));
-	_Len -= _Chunk_size;
-	std::advance(_Curr, _Chunk_size);
-	}
+		composable_iterator() : composable_iterator_base() {}
+	};
 
-	if (_Len > 0)
-	_Func(_Curr, _Len);
-	}
-	catch (...)
+	template<typename ... _It>
+	composable_iterator<_It...> make_composable_iterator(const _It&... _Val)
 	{
-	push_exception(std::current_exception());
-	}
+		return composable_iterator<_It...>(_Val...);
 	}
 
-	template <typename _RangeCt>
-	static void wait(_RangeCt &_Range)
-	{
-	_Contextaware_waitable_chore::wait(_Range);
-	std::list<std::exception_ptr> _ExList;
-	for (auto &_Chore : _Range)
+	// A member of a zip iterator as a chore loops over it: the raw pointer to the element of a
+	// contiguous range, the iterator itself otherwise. _It must be dereferenceable.
+	template<typename _It, bool = _Contiguous_container_iterator_traits<_It>::value>
+	struct _Unwrapped_zip_member
 	{
-	ExceptionListNode *_Head = _Chore._Exception_list;
-	while (_Head != nullptr)
-	{
-	_ExList.push_back(std::move(_Head->_Exception));
-	auto _Next = _Head->_Next;
-	delete _Head;
-	_Head = _Next;
-	}
-	}
+		typedef typename std::iterator_traits<_It>::pointer type;
 
-	if (!_ExList.empty())
-	throw exception_list(std::move(_ExList));
-	}
+		static type _Get(const _It& _Iter)
+		{
+			return _Unwrap_contiguous(_Iter);
+		}
 	};
-	*/
-
-	struct static_partitioner_tag {};
-	struct auto_partitioner_tag {}; // self_guided that is default
-	struct dynamic_partitioner_tag {};
-	struct copy_partitioner_tag {};
-	struct remove_partitioner_tag {};
 
-
-	template<typename _PartTag, bool _IsNoExcept = std::is_base_of<parallel_vector_execution_policy, _PartTag>::value>
-	struct _Partitioner;
-
-	// Partitioners implementation
-	template<typename _PartTag, bool _IsNoExcept>
-	struct _Partitioner
+	template<typename _It>
+	struct _Unwrapped_zip_member<_It, false>
 	{
-		static_assert(sizeof(_PartTag) == 0, "Partitioner tag not supported.");
+		typedef _It type;
+
+		static type _Get(const _It& _Iter)
+		{
+			return _Iter;
+		}
 	};
 
-	template<bool _IsNoExcept>
-	struct _Partitioner<static_partitioner_tag, _IsNoExcept>
+	template<typename _It>
+	inline typename _Unwrapped_zip_member<_It>::type _Unwrap_zip_member(const _It& _Iter)
 	{
-	private:
-		template<typename _Container, typename _FwdIt, typename _UserData, typename _Callback>
-		static _FwdIt _For_Each_impl(_Container& _Chores, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0)
-		{
-			_Partition_status_tracker _Tracker;
+		return _Unwrapped_zip_member<_It>::_Get(_Iter);
+	}
 
-			// when we are nested loops and there are too many chores, we run the loop inline
-			if (_Contextaware_waitable_chore::current_chore() != nullptr && !_Tracker._IsPartitionNumUnderLimit())
-			{
-				typename _Container::value_type _Chore(_First, _Count, _Data, _Func);
-				_Chore.invoke();
-				_Chore.rethrow_exception();
-			}
-			else
-			{
-				if (_Chunk_size == 0) {
-					const unsigned int _HdConc = get_hardware_concurrency();
-					_Chunk_size = (_Count + _HdConc - 1) / _HdConc;
-				}
 
-				_Chores.reserve(_Count / _Chunk_size + 1);
+	_EXP_IMPL void * __cdecl _Allocate_chore_storage(size_t _Size);
+	_EXP_IMPL void __cdecl _Free_chore_storage(void *_Ptr, size_t _Size);
 
-				_Tracker._AddPartitions(_Count / _Chunk_size);
+	// Allocator of the partitioners' chore containers. The storage comes from an arena owned by
+	// the calling thread, so steady state algorithm calls make no heap allocations. A container
+	// using it must be destroyed on the thread that created it.
+	template <typename _Ty>
+	class _Chore_allocator
+	{
+	public:
+		typedef _Ty value_type;
+		typedef _Ty *pointer;
+		typedef const _Ty *const_pointer;
+		typedef _Ty &reference;
+		typedef const _Ty &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+
+		template <typename _Other>
+		struct rebind
+		{
+			typedef _Chore_allocator<_Other> other;
+		};
 
-				while (_Count > _Chunk_size)
-				{
-					_Chores.emplace_back(_First, _Chunk_size, _Data, _Func);
-					schedule_chore(&_Chores.back());
-					_Count -= _Chunk_size;
-					std::advance(_First, _Chunk_size);
-				}
+		_Chore_allocator() throw() {}
 
-				_Chores.emplace_back(_First, _Count, _Data, _Func);
-				_Chores.back().invoke();
+		template <typename _Other>
+		_Chore_allocator(const _Chore_allocator<_Other>&) throw() {}
 
-				std::iterator_traits<_Container::iterator>::value_type::wait(_Chores);
-			}
-			std::advance(_First, _Count);
-			return _First;
-		}
-	public:
-		template<typename _FwdIt, typename _UserData, typename _Callback>
-		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0)
+		pointer allocate(size_type _Count, const void * = nullptr)
 		{
-			typedef std::conditional < _IsNoExcept, _Static_chore_noexcept<_FwdIt, _UserData, _Callback>,
-				_Static_chore < _FwdIt, _UserData, _Callback >> ::type _ChoreType;
-			std::vector<_ChoreType> _Chores;
-
-			return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size);
+			if (_Count > max_size())
+				throw std::bad_alloc();
+			return static_cast<pointer>(_Allocate_chore_storage(_Count * sizeof(_Ty)));
 		}
 
-		template<typename _FwdIt, typename _UserData, typename _Callback, typename _Cleanup_callback>
-		static _FwdIt _For_each_with_cleanup(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, _Cleanup_callback _Cleanup, size_t _Chunk_size = 0)
+		void deallocate(pointer _Ptr, size_type _Count)
 		{
-			typedef _Static_chore<_FwdIt, _UserData, _Callback> _ChoreType;
-			std::vector<_ChoreType> _Chores;
-
-			try {
-				return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size);
-			}
-			catch (const exception_list&) {
-				for (auto _It = std::begin(_Chores); _It != std::end(_Chores); ++_It)
-					_Cleanup(_It->_Begin, _It->_Count, _It->_Exception);
+			_Free_chore_storage(_Ptr, _Count * sizeof(_Ty));
+		}
 
-				throw;
-			}
+		size_type max_size() const throw()
+		{
+			return static_cast<size_type>(-1) / sizeof(_Ty);
 		}
-	};
 
-	template<bool _IsNoExcept>
-	struct _Partitioner<auto_partitioner_tag, _IsNoExcept>
-	{
-	protected:
-		template<typename _Container, typename _FwdIt, typename _UserData, typename _Callback>
-		static _FwdIt _For_Each_impl(_Container& _Chores, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size)
+		template <typename _Objty, typename... _Types>
+		void construct(_Objty *_Ptr, _Types&&... _Args)
 		{
-			_Partition_status_tracker _Tracker;
+			::new (static_cast<void *>(_Ptr)) _Objty(std::forward<_Types>(_Args)...);
+		}
 
-			// when we are nested loops and there are too many chores, we run the loop inline
-			if (_Contextaware_waitable_chore::current_chore() != nullptr && !_Tracker._IsPartitionNumUnderLimit())
-			{
-				typename _Container::value_type _Chore(_First, _Count, _Data, _Func);
-				_Chore.invoke();
-				_Chore.rethrow_exception();
-			}
-			else
-			{
-				if (_Chunk_size == 0)
-					_Chunk_size = 2u;
+		template <typename _Uty>
+		void destroy(_Uty *_Ptr)
+		{
+			_Ptr->~_Uty();
+		}
 
-				const unsigned int _HdConc = get_hardware_concurrency();
-				size_t _Chores_size = 1;
+		template <typename _Other>
+		bool operator==(const _Chore_allocator<_Other>&) const throw()
+		{
+			return true;
+		}
 
-				size_t _Count_tmp = _Count;
-				while (_Count_tmp > _Chunk_size)
-				{
-					size_t _Step = (std::max)(_Count_tmp / _HdConc, _Chunk_size);
-					_Count_tmp -= _Step;
-					_Chores_size++;
-				}
+		template <typename _Other>
+		bool operator!=(const _Chore_allocator<_Other>&) const throw()
+		{
+			return false;
+		}
+	};
 
-				_Tracker._AddPartitions(_Chores_size - 1);
-				_Chores.reserve(_Chores_size);
+	template <typename _Ty>
+	using _Chore_vector = std::vector<_Ty, _Chore_allocator<_Ty>>;
 
-				while (_Count > _Chunk_size)
-				{
-					size_t _Step = (std::max)(_Count / _HdConc, _Chunk_size);
-					_Chores.emplace_back(_First, _Step, _Data, _Func);
-					schedule_chore(&_Chores.back());
-					_Count -= _Step;
-					std::advance(_First, _Step);
-				}
+	// Runs _Func(_Block) for the blocks 0 to _Blocks - 1, block 0 on the calling thread
+	template<typename _Fn>
+	inline void _Run_blocks(size_t _Blocks, const _Fn& _Func)
+	{
+		auto _Block_task = [&_Func](size_t _Block) {
+			return make_task([&_Func, _Block] { _Func(_Block); });
+		};
 
-				_Chores.emplace_back(_First, _Count, _Data, _Func);
-				_Chores.back().invoke();
-				std::iterator_traits<_Container::iterator>::value_type::wait(_Chores);
-			}
+		_Chore_vector<decltype(_Block_task(0))> _Tasks;
+		_Tasks.reserve(_Blocks - 1);
 
-			std::advance(_First, _Count);
-			return _First;
-		}
-	public:
-		template<typename _FwdIt, typename _UserData, typename _Callback>
-		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0)
+		TaskGroup _Tg;
+		for (size_t _Block = 1; _Block < _Blocks; ++_Block)
 		{
-			typedef std::conditional < _IsNoExcept, _Static_chore_noexcept<_FwdIt, _UserData, _Callback>,
-				_Static_chore < _FwdIt, _UserData, _Callback >> ::type _ChoreType;
+			_Tasks.push_back(_Block_task(_Block));
+			_Tg.run(_Tasks.back());
+		}
 
-			std::vector<_ChoreType> _Chores;
+		_Func(0);
+		_Tg.wait();
+	}
 
-			return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size);
-		}
+	// Values moved through a buffer in parallel chores, which must not throw
+	template<typename _Ty>
+	struct _Is_nothrow_movable : std::integral_constant<bool,
+		std::is_nothrow_move_constructible<_Ty>::value && std::is_nothrow_move_assignable<_Ty>::value>
+	{
 	};
 
-	template<typename _OutIt, typename _DiffType = typename std::iterator_traits<_OutIt>::difference_type>
-	class _Output_token
+	// Makes the scratch resource of a policy the calling thread's for the time of an algorithm call, the
+	// chores it schedules run with it too. A policy without one leaves the thread's resource as it is.
+	class _Scratch_scope
 	{
-		_OutIt _Begin;
-		_DiffType _Iter_pos;
-	public:
-		const static _DiffType EMPTY_POSITION = static_cast<_DiffType>(-1);
+		memory_resource *_Previous;
+		bool _Set;
 
-		_Output_token(_OutIt _It) : _Begin(_It)
+		_Scratch_scope(const _Scratch_scope&);
+		_Scratch_scope& operator=(const _Scratch_scope&);
+	public:
+		explicit _Scratch_scope(const _Parameterized_policy& _Policy) : _Previous(nullptr), _Set(_Policy.parameters().scratch_memory() != nullptr)
 		{
+			if (_Set)
+				_Previous = _Exchange_thread_scratch_resource(_Policy.parameters().scratch_memory());
 		}
 
-		// Can be called only on one thread and set once
-		void set_position(_DiffType _Pos)
+		explicit _Scratch_scope(const sequential_execution_policy&) : _Previous(nullptr), _Set(false)
 		{
-			_Iter_pos = _Pos;
 		}
 
-		_OutIt get() const
+		~_Scratch_scope()
 		{
-			return _Begin;
+			if (_Set)
+				_Exchange_thread_scratch_resource(_Previous);
 		}
+	};
 
-		_OutIt get_result() const
+	// The arena of the arena execution parameter, an algorithm runs in it for the time of the call
+	inline WorkArena *_Policy_arena(const _Parameterized_policy& _Policy)
+	{
+		task_arena *_Arena = _Policy.parameters().work_arena();
+		return _Arena != nullptr ? _Arena->_Get() : nullptr;
+	}
+
+	inline WorkArena *_Policy_arena(const sequential_execution_policy&)
+	{
+		return nullptr;
+	}
+
+	// Schedules the chores of an algorithm call in the lane of the priority of its policy. A policy without
+	// one leaves the lane of the calling thread as it is.
+	class _Priority_scope
+	{
+		unsigned int _Previous;
+		bool _Set;
+
+		_Priority_scope(const _Priority_scope&);
+		_Priority_scope& operator=(const _Priority_scope&);
+	public:
+		explicit _Priority_scope(const _Parameterized_policy& _Policy) : _Previous(_Normal_lane), _Set(_Policy.parameters().priority_level() != task_priority::default_)
 		{
-			_OutIt _Out = _Begin;
-			std::advance(_Out, _Iter_pos);
-			return _Out;
+			if (_Set)
+				_Previous = _Exchange_thread_lane(_Policy.parameters().priority_level() == task_priority::high ? _High_lane : _Normal_lane);
 		}
 
-		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
-	public:
-		void move(_Output_token& _Token)
+		explicit _Priority_scope(const sequential_execution_policy&) : _Previous(_Normal_lane), _Set(false)
 		{
-			_Begin = _Token._Begin;
-			std::advance(_Begin, _Token._Iter_pos);
 		}
 
-		bool empty() const
+		~_Priority_scope()
 		{
-			return _Iter_pos == 0;
+			if (_Set)
+				_Exchange_thread_lane(_Previous);
 		}
 	};
 
-	template<typename _OutIt, typename _OutIt2, typename _DiffType = typename std::iterator_traits<_OutIt>::difference_type>
-	class _Output_token_double
+	// Storage for _Count values left unconstructed, its owner constructs and destroys them. The storage
+	// comes from the scratch resource of the thread that allocates it.
+	template<typename _Ty>
+	class _Uninitialized_buffer
 	{
-		_OutIt _Begin;
-		_OutIt2 _Begin2;
-		_DiffType _Iter_pos;
-		_DiffType _Iter_pos2;
-	public:
-		const static _DiffType EMPTY_POSITION = static_cast<_DiffType>(-1);
+		_Ty *_Data;
+		size_t _Count;
+		memory_resource *_Resource;
 
-		_Output_token_double(_OutIt _It, _OutIt2 _It2) : _Begin(_It), _Begin2(_It2)
+		_Uninitialized_buffer(const _Uninitialized_buffer&);
+		_Uninitialized_buffer& operator=(const _Uninitialized_buffer&);
+	public:
+		_Uninitialized_buffer() : _Data(nullptr), _Count(0), _Resource(nullptr)
 		{
 		}
 
-		// Can be called only on one thread and set once
-		void set_position(_DiffType _Pos, _DiffType _Pos2)
+		explicit _Uninitialized_buffer(size_t _Cnt) : _Data(nullptr), _Count(0), _Resource(_Scratch_resource())
 		{
-			_Iter_pos = _Pos;
-			_Iter_pos2 = _Pos2;
+			_Data = _Allocate_scratch<_Ty>(_Resource, _Cnt);
+			_Count = _Cnt;
 		}
 
-		std::pair<_OutIt, _OutIt2> get() const
+		~_Uninitialized_buffer()
 		{
-			return std::pair<_OutIt, _OutIt2>(_Begin, _Begin2);
+			if (_Data)
+				_Deallocate_scratch(_Resource, _Data, _Count);
 		}
 
-		std::pair<_OutIt, _OutIt2> get_result() const
+		// Grows the storage to _Cnt values at least. The old storage is released first so both never
+		// live at once, the buffer is left empty if the allocation throws.
+		void _Reserve(size_t _Cnt)
 		{
-			_OutIt _Out = _Begin;
-			std::advance(_Out, _Iter_pos);
+			if (_Cnt <= _Count)
+				return;
 
-			_OutIt _Out2 = _Begin2;
-			std::advance(_Out2, _Iter_pos2);
+			if (_Data)
+				_Deallocate_scratch(_Resource, _Data, _Count);
 
-			return std::pair<_OutIt, _OutIt2>(_Out, _Out2);
+			_Data = nullptr;
+			_Count = 0;
+			_Resource = _Scratch_resource();
+			_Data = _Allocate_scratch<_Ty>(_Resource, _Cnt);
+			_Count = _Cnt;
 		}
 
-		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
-	public:
-		void move(_Output_token_double& _Token)
+		_Ty *get() const
 		{
-			_Begin = _Token._Begin;
-			std::advance(_Begin, _Token._Iter_pos);
-
-			_Begin2 = _Token._Begin2;
-			std::advance(_Begin2, _Token._Iter_pos2);
+			return _Data;
 		}
 
-		bool empty() const
+		size_t size() const
 		{
-			return _Iter_pos == 0 && _Iter_pos2 == 0;
+			return _Count;
+		}
+	};
+
+	class _Partition_status_tracker
+	{
+		size_t _PartitionNum;
+	public:
+		_Partition_status_tracker() : _PartitionNum(0) {}
+
+		_EXP_IMPL bool _IsPartitionNumUnderLimit();
+
+		_EXP_IMPL void _AddPartitions(size_t);
+
+		_EXP_IMPL ~_Partition_status_tracker();
+	};
+
+	class _Contextaware_waitable_chore : public _Threadpool_chore
+	{
+		CompletionEvent *_ChoreSetCmpEvent;
+		std::atomic<size_t> _Counter;
+
+		void _CompleteOne()
+		{
+			auto _Ref = --_Counter;
+			_ASSERTE(_Ref >= 0);
+			if (_Ref == 0)
+			{
+				_ASSERT(_ChoreSetCmpEvent);
+				_ChoreSetCmpEvent->completeOne();
+			}
+		}
+
+		_EXP_IMPL static void _Set_current_chore(_Contextaware_waitable_chore *);
+	public:
+		virtual void waitable_invoke() = 0;
+
+		virtual void __cdecl invoke() override final
+		{
+			_EXP_TRACE_ONLY(const unsigned long long _Trace_start = _Trace_begin());
+			_Contextaware_waitable_chore *_Backup = current_chore();
+			_Set_current_chore(this);
+			waitable_invoke();
+			_Set_current_chore(_Backup);
+			_EXP_TRACE_ONLY(_Trace_end(_Trace_start, "chunk", _Trace_count()));
+			_CompleteOne();
+		}
+
+		// The elements of the chunk, for the trace
+		virtual size_t _Trace_count() const
+		{
+			return 0;
+		}
+
+		_Contextaware_waitable_chore() : _ChoreSetCmpEvent(nullptr), _Counter(2) {}
+		_Contextaware_waitable_chore(const _Contextaware_waitable_chore &) : _ChoreSetCmpEvent(nullptr), _Counter(2) {}
+
+		// hide the base case reschedule() method
+		void reschedule()
+		{
+			auto _Ref = ++_Counter;
+			_ASSERTE(_Ref >= 1);
+			if (_Ref == 1)
+			{
+				_ASSERT(_ChoreSetCmpEvent);
+				_ChoreSetCmpEvent->addOne();
+			}
+			_Threadpool_chore::reschedule();
+		}
+
+		// wait can only be called once
+		template <typename _RangeCt>
+		static void wait(_RangeCt &_Range)
+		{
+			if (_Range.empty())
+				return;
+
+			CompletionEvent _Event(_Range.size());
+			for (auto &_Chore : _Range)
+			{
+				if (_Chore.is_scheduled())
+				{
+					_ASSERT(_Chore._ChoreSetCmpEvent == nullptr);
+					_Chore._ChoreSetCmpEvent = &_Event;
+					_Chore._CompleteOne();
+				}
+				else // we assume the chore is completed if it has never been scheduled
+					_Event.completeOne();
+			}
+
+			// Keep the thread busy with queued chores until the partitions are done
+			while (!_Event.is_complete() && help_with_stolen_chore())
+			{
+			}
+			_Event.wait();
 		}
+
+		_EXP_IMPL static _Contextaware_waitable_chore * current_chore();
+
 	};
 
 	// Disable warning C4324: structure was padded due to __declspec(align())
 	// This padding is expected and necessary.
 #pragma warning(push)
-#pragma warning(disable: 4324)
-	template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
-	class __declspec(align(64)) _Copy_chore : public _Contextaware_waitable_chore
+#pragma warning(disable: 4324)			
+	template <typename _It, typename _UserData, typename _Callback>
+	class __declspec(align(64)) _Static_chore_noexcept :
+		public _Contextaware_waitable_chore
 	{
 	protected:
-		enum _ChoreInternalState {
-			_Started = 0x00,
-			_Filtered = 0x00,
-			_Missed = 0x01,
-			_NotFiltered = 0x02
-		};
+		_Static_chore_noexcept& operator=(const _Static_chore_noexcept&) {};
 
 		_It _Begin;
-		size_t _Size;
-		_First_stage _Stage1;
-		_Second_stage _Stage2;
-		_Copy_chore* _Next_chore;
-		_OutToken _Output;
+		size_t _Count;
+		const _Callback& _AlgoCallback;
+		_UserData _AlgoData;
+	public:
+		_Static_chore_noexcept()
+		{
+		}
+
+		_Static_chore_noexcept(_It _First, size_t _Dist, _UserData _Data, const _Callback& _Func) :
+			_Begin(std::move(_First)), _Count(_Dist), _AlgoData(std::move(_Data)), _AlgoCallback(_Func) {}
+
+		virtual void waitable_invoke() override
+		{
+			_ASSERTE(_Count > 0);
+			_AlgoCallback(_Begin, _Count, _AlgoData);
+		}
+
+		virtual size_t _Trace_count() const override
+		{
+			return _Count;
+		}
+
+		void rethrow_exception()
+		{
+		}
+		template <typename _PartTag, bool _IsNoExcept> friend struct _Partitioner;
+	};
+
+	template <typename _It, typename _UserData, typename _Callback>
+	class __declspec(align(64)) _Static_chore :
+		public _Static_chore_noexcept<_It, _UserData, _Callback>
+	{
+		_Static_chore& operator=(const _Static_chore&) {}
+
 		std::exception_ptr _Exception;
-		std::atomic<int> _State;
+	public:
+		_Static_chore()
+		{
+		}
 
-		bool try_filter()
+		_Static_chore(_It _First, size_t _Count, _UserData _Data, const _Callback& _Func) :
+			_Static_chore_noexcept(std::move(_First), _Count, std::move(_Data), _Func), _Exception(nullptr)
 		{
-			return (_State.fetch_or(_Missed | _NotFiltered) & _NotFiltered) == _Filtered;
 		}
 
-		bool try_filter_missed()
+		virtual void waitable_invoke() override
 		{
-			int _ExpectedState = _Missed | _Filtered;
-			return _State.compare_exchange_strong(_ExpectedState, _Missed | _NotFiltered);
+			try {
+				_ASSERTE(_Count > 0);
+				_AlgoCallback(_Begin, _Count, _AlgoData);
+			}
+			catch (...) {
+				_Exception = std::current_exception();
+			}
+		}
+
+		void rethrow_exception()
+		{
+			if (_Exception != nullptr)
+			{
+				std::list<std::exception_ptr> _ExList;
+				_ExList.push_back(std::move(_Exception));
+				throw exception_list(std::move(_ExList));
+			}
+		}
+
+		template <typename _RangeCt>
+		static void wait(_RangeCt &_Range)
+		{
+			_Contextaware_waitable_chore::wait(_Range);
+
+			// The list allocates, it is built only once a chore is known to have thrown
+			auto _Thrown = std::begin(_Range);
+			while (_Thrown != std::end(_Range) && _Thrown->_Exception == nullptr)
+				++_Thrown;
+
+			if (_Thrown == std::end(_Range))
+				return;
+
+			std::list<std::exception_ptr> _ExList;
+			for (; _Thrown != std::end(_Range); ++_Thrown)
+			{
+				if (_Thrown->_Exception != nullptr)
+					_ExList.push_back(std::move(_Thrown->_Exception));
+			}
+
+			throw exception_list(std::move(_ExList));
+		}
+
+		template <typename _PartTag, bool _IsNoExcept> friend struct _Partitioner;
+	};
+#pragma warning(pop) // C4324
+
+	// Runs a partition chore from the work-stealing queue of the thread that created it.
+	// Nested algorithms push their partitions to the same queues, so idle workers can steal
+	// them instead of adding more threadpool work.
+	template <typename _ChoreType>
+	class _Stealable_chore : public WorkChoreBase
+	{
+		_ChoreType *_Chore;
+	protected:
+		virtual void __cdecl userFunc() override
+		{
+			// invoke() keeps current_chore() and exceptions consistent with the threadpool path
+			_Chore->invoke();
+		}
+	public:
+		explicit _Stealable_chore(_ChoreType *_Ch) : _Chore(_Ch) {}
+
+		// Only used by the vector before the chore is scheduled
+		_Stealable_chore(const _Stealable_chore& _Other) : _Chore(_Other._Chore) {}
+	};
+
+	// Threads a loop is split for: the hardware concurrency, capped by the max_threads parameter
+	inline unsigned int _Thread_count(unsigned int _Max_threads)
+	{
+		const unsigned int _HdConc = get_hardware_concurrency();
+		return _Max_threads != 0 && _Max_threads < _HdConc ? _Max_threads : _HdConc;
+	}
+
+	// The calling thread runs the last chunk of a loop itself when the end of that chunk can be
+	// reached in constant time. A forward or bidirectional range takes as long to walk as the chunk,
+	// so its last chunk is queued like the others and the walk to the end overlaps with them.
+	template<typename _FwdIt>
+	struct _Caller_runs_last_chunk :
+		std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>
+	{
+	};
+
+	template<typename _Container, typename _Tasks_container, typename _FwdIt>
+	inline void _Run_last_chunk(_Container& _Chores, _Tasks_container& _Tasks, TaskGroup& _Tg, _FwdIt& _First, size_t& _Count)
+	{
+		if (_Caller_runs_last_chunk<_FwdIt>::value || _Tasks.empty())
+		{
+			_Chores.back().invoke();
+		}
+		else
+		{
+			_Tasks.emplace_back(&_Chores.back());
+			_Tg.run(_Tasks.back());
+			std::advance(_First, _Count);
+			_Count = 0;
+		}
+	}
+
+	// Chores the self guided partitioner carves _Count elements into: a share of the threads while
+	// that is more than _Chunk_size, then chunks of _Chunk_size.
+	inline size_t _Auto_chore_count(size_t _Count, size_t _Chunk_size, unsigned int _HdConc)
+	{
+		size_t _Chores_size = 1;
+		while (_Count / _HdConc > _Chunk_size)
+		{
+			_Count -= _Count / _HdConc;
+			_Chores_size++;
+		}
+
+		if (_Count > _Chunk_size)
+			_Chores_size += (_Count - 1) / _Chunk_size;
+		return _Chores_size;
+	}
+
+	// The chunks of the static partitioner: chunks of _Chunk_size if it is set, else a chunk per thread. On a
+	// hybrid machine the share of a thread follows its speed, the threads taken fastest first, so the largest
+	// chunks are queued first and the first thieves take them.
+	class _Static_shares
+	{
+		size_t _Total;
+		size_t _Chunk_size;
+		unsigned int _Threads;
+		unsigned long long _Weight_sum; // 0 for chunks of _Chunk_size
+
+	public:
+		_Static_shares(size_t _Count, size_t _Chunk, unsigned int _Max_threads) : _Total(_Count), _Chunk_size(_Chunk), _Threads(0), _Weight_sum(0)
+		{
+			if (_Chunk_size != 0)
+				return;
+
+			_Threads = _Thread_count(_Max_threads);
+			_Chunk_size = (_Count + _Threads - 1) / _Threads;
+			if (_Hybrid_topology(_Threads))
+			{
+				for (unsigned int _Rank = 0; _Rank < _Threads; ++_Rank)
+					_Weight_sum += _Thread_weight(_Rank, _Threads);
+			}
+		}
+
+		// The chunks at most
+		size_t _Chunks() const
+		{
+			return _Weight_sum != 0 ? _Threads : _Total / _Chunk_size + 1;
+		}
+
+		// The size of a chunk, the walk stops at a chunk as large as what is left: the last one takes the rest
+		size_t _Chunk(size_t _Index) const
+		{
+			if (_Weight_sum == 0)
+				return _Chunk_size;
+			if (_Index + 1 >= _Threads)
+				return static_cast<size_t>(-1);
+
+			const unsigned long long _Share = static_cast<unsigned long long>(_Total) * _Thread_weight(static_cast<unsigned int>(_Index), _Threads) / _Weight_sum;
+			return (std::max)(static_cast<size_t>(_Share), static_cast<size_t>(1));
 		}
+	};
+
+	struct static_partitioner_tag {};
+	struct auto_partitioner_tag {}; // self_guided that is default
+	struct dynamic_partitioner_tag {};
+	struct affinity_partitioner_tag {};
+	struct adaptive_partitioner_tag {};
+	struct copy_partitioner_tag {};
+	struct remove_partitioner_tag {};
+
+
+	template<typename _PartTag, bool _IsNoExcept = std::is_base_of<parallel_vector_execution_policy, _PartTag>::value>
+	struct _Partitioner;
+
+	// Partitioners implementation
+	template<typename _PartTag, bool _IsNoExcept>
+	struct _Partitioner
+	{
+		static_assert(sizeof(_PartTag) == 0, "Partitioner tag not supported.");
+	};
+
+	template<bool _IsNoExcept>
+	struct _Partitioner<static_partitioner_tag, _IsNoExcept>
+	{
+	private:
+		template<typename _Container, typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each_impl(_Container& _Chores, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			_Partition_status_tracker _Tracker;
+
+			// when we are nested loops and there are too many chores, we run the loop inline
+			if (_Contextaware_waitable_chore::current_chore() != nullptr && !_Tracker._IsPartitionNumUnderLimit())
+			{
+				typename _Container::value_type _Chore(_First, _Count, _Data, _Func);
+				_Chore.invoke();
+				_Chore.rethrow_exception();
+			}
+			else
+			{
+				const _Static_shares _Shares(_Count, _Chunk_size, _Max_threads);
+				_Chores.reserve(_Shares._Chunks());
+
+				_Tracker._AddPartitions(_Shares._Chunks() - 1);
+
+				_Chore_vector<_Stealable_chore<typename _Container::value_type>> _Tasks;
+				_Tasks.reserve(_Shares._Chunks());
+				TaskGroup _Tg;
+
+				// each chunk is queued as soon as the walk reaches it
+				size_t _Index = 0;
+				for (size_t _Step = _Shares._Chunk(_Index); _Count > _Step; _Step = _Shares._Chunk(++_Index))
+				{
+					_Chores.emplace_back(_First, _Step, _Data, _Func);
+					_Tasks.emplace_back(&_Chores.back());
+					_Tg.run(_Tasks.back());
+					_Count -= _Step;
+					std::advance(_First, _Step);
+				}
+
+				_Chores.emplace_back(_First, _Count, _Data, _Func);
+				_Run_last_chunk(_Chores, _Tasks, _Tg, _First, _Count);
+
+				_Tg.wait();
+				std::iterator_traits<_Container::iterator>::value_type::wait(_Chores);
+			}
+			std::advance(_First, _Count);
+			return _First;
+		}
+	public:
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			typedef std::conditional < _IsNoExcept, _Static_chore_noexcept<_FwdIt, _UserData, _Callback>,
+				_Static_chore < _FwdIt, _UserData, _Callback >> ::type _ChoreType;
+			_Chore_vector<_ChoreType> _Chores;
+
+			return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size, _Max_threads);
+		}
+
+		template<typename _FwdIt, typename _UserData, typename _Callback, typename _Cleanup_callback>
+		static _FwdIt _For_each_with_cleanup(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, _Cleanup_callback _Cleanup, size_t _Chunk_size = 0)
+		{
+			typedef _Static_chore<_FwdIt, _UserData, _Callback> _ChoreType;
+			_Chore_vector<_ChoreType> _Chores;
+
+			try {
+				return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size);
+			}
+			catch (const exception_list&) {
+				for (auto _It = std::begin(_Chores); _It != std::end(_Chores); ++_It)
+					_Cleanup(_It->_Begin, _It->_Count, _It->_Exception);
+
+				throw;
+			}
+		}
+	};
+
+	template<bool _IsNoExcept>
+	struct _Partitioner<auto_partitioner_tag, _IsNoExcept>
+	{
+	protected:
+		template<typename _Container, typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each_impl(_Container& _Chores, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size, unsigned int _Max_threads)
+		{
+			_Partition_status_tracker _Tracker;
+
+			// when we are nested loops and there are too many chores, we run the loop inline
+			if (_Contextaware_waitable_chore::current_chore() != nullptr && !_Tracker._IsPartitionNumUnderLimit())
+			{
+				typename _Container::value_type _Chore(_First, _Count, _Data, _Func);
+				_Chore.invoke();
+				_Chore.rethrow_exception();
+			}
+			else
+			{
+				if (_Chunk_size == 0)
+					_Chunk_size = 2u;
+
+				const unsigned int _HdConc = _Thread_count(_Max_threads);
+
+				// a single thread runs the whole loop, a share of it would leave an empty last chunk
+				if (_HdConc == 1)
+					_Chunk_size = (std::max)(_Count, _Chunk_size);
+
+				const size_t _Chores_size = _Auto_chore_count(_Count, _Chunk_size, _HdConc);
+
+				_Tracker._AddPartitions(_Chores_size - 1);
+				_Chores.reserve(_Chores_size);
+
+				_Chore_vector<_Stealable_chore<typename _Container::value_type>> _Tasks;
+				_Tasks.reserve(_Chores_size);
+				TaskGroup _Tg;
+
+				// each chunk is queued as soon as the walk reaches it
+				while (_Count > _Chunk_size)
+				{
+					size_t _Step = (std::max)(_Count / _HdConc, _Chunk_size);
+					_Chores.emplace_back(_First, _Step, _Data, _Func);
+					_Tasks.emplace_back(&_Chores.back());
+					_Tg.run(_Tasks.back());
+					_Count -= _Step;
+					std::advance(_First, _Step);
+				}
+
+				_Chores.emplace_back(_First, _Count, _Data, _Func);
+				_Run_last_chunk(_Chores, _Tasks, _Tg, _First, _Count);
+
+				_Tg.wait();
+				std::iterator_traits<_Container::iterator>::value_type::wait(_Chores);
+			}
+
+			std::advance(_First, _Count);
+			return _First;
+		}
+	public:
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			typedef std::conditional < _IsNoExcept, _Static_chore_noexcept<_FwdIt, _UserData, _Callback>,
+				_Static_chore < _FwdIt, _UserData, _Callback >> ::type _ChoreType;
+
+			_Chore_vector<_ChoreType> _Chores;
+
+			return _For_Each_impl(_Chores, std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size, _Max_threads);
+		}
+	};
+
+	// Reference to one bit of a filter mask
+	class _Filter_mask_bit
+	{
+		size_t *_Word;
+		size_t _Bit;
+	public:
+		_Filter_mask_bit(size_t *_W, size_t _B) : _Word(_W), _Bit(_B)
+		{
+		}
+
+		_Filter_mask_bit& operator=(bool _Val)
+		{
+			if (_Val)
+				*_Word |= _Bit;
+			else
+				*_Word &= ~_Bit;
+			return *this;
+		}
+
+		operator bool() const
+		{
+			return (*_Word & _Bit) != 0;
+		}
+	};
+
+	// Walks a filter mask one bit per element, zipped with the filtered range
+	class _Filter_mask_iterator :
+		public std::iterator<std::random_access_iterator_tag, bool, ptrdiff_t, void, _Filter_mask_bit>
+	{
+		size_t *_Words;
+		ptrdiff_t _Pos;
+	public:
+		static const size_t _Word_bits = sizeof(size_t) * CHAR_BIT;
+
+		_Filter_mask_iterator() : _Words(nullptr), _Pos(0)
+		{
+		}
+
+		_Filter_mask_iterator(size_t *_W, ptrdiff_t _P) : _Words(_W), _Pos(_P)
+		{
+		}
+
+		_Filter_mask_bit operator*() const
+		{
+			const size_t _Index = static_cast<size_t>(_Pos);
+			return _Filter_mask_bit(_Words + _Index / _Word_bits, size_t(1) << (_Index % _Word_bits));
+		}
+
+		_Filter_mask_bit operator[](ptrdiff_t _Off) const
+		{
+			return *(*this + _Off);
+		}
+
+		_Filter_mask_iterator& operator++()
+		{
+			++_Pos;
+			return *this;
+		}
+
+		_Filter_mask_iterator operator++(int)
+		{
+			_Filter_mask_iterator _Tmp = *this;
+			++_Pos;
+			return _Tmp;
+		}
+
+		_Filter_mask_iterator& operator--()
+		{
+			--_Pos;
+			return *this;
+		}
+
+		_Filter_mask_iterator operator--(int)
+		{
+			_Filter_mask_iterator _Tmp = *this;
+			--_Pos;
+			return _Tmp;
+		}
+
+		_Filter_mask_iterator& operator+=(ptrdiff_t _Off)
+		{
+			_Pos += _Off;
+			return *this;
+		}
+
+		_Filter_mask_iterator& operator-=(ptrdiff_t _Off)
+		{
+			_Pos -= _Off;
+			return *this;
+		}
+
+		_Filter_mask_iterator operator+(ptrdiff_t _Off) const
+		{
+			return _Filter_mask_iterator(_Words, _Pos + _Off);
+		}
+
+		_Filter_mask_iterator operator-(ptrdiff_t _Off) const
+		{
+			return _Filter_mask_iterator(_Words, _Pos - _Off);
+		}
+
+		ptrdiff_t operator-(const _Filter_mask_iterator& _Right) const
+		{
+			return _Pos - _Right._Pos;
+		}
+
+		bool operator==(const _Filter_mask_iterator& _Right) const
+		{
+			return _Pos == _Right._Pos;
+		}
+
+		bool operator!=(const _Filter_mask_iterator& _Right) const
+		{
+			return _Pos != _Right._Pos;
+		}
+
+		bool operator<(const _Filter_mask_iterator& _Right) const
+		{
+			return _Pos < _Right._Pos;
+		}
+
+		bool operator>(const _Filter_mask_iterator& _Right) const
+		{
+			return _Right._Pos < _Pos;
+		}
+
+		bool operator<=(const _Filter_mask_iterator& _Right) const
+		{
+			return !(_Right._Pos < _Pos);
+		}
+
+		bool operator>=(const _Filter_mask_iterator& _Right) const
+		{
+			return !(_Pos < _Right._Pos);
+		}
+
+		// The word of the iterator's bit, the chunks of a mask start at a word boundary
+		size_t *_Word() const
+		{
+			return _Words + static_cast<size_t>(_Pos) / _Word_bits;
+		}
+	};
+
+	// The copy partitioner's filtering stage marks the elements it keeps, one bit each, and the
+	// copy stage writes the marked ones. Chunks are rounded to whole words so that no two chores
+	// write the same word, the side memory of a range of n elements is n/8 bytes.
+	class _Filter_mask
+	{
+		size_t *_Words;
+		size_t _Word_count;
+		memory_resource *_Resource;
+
+		_Filter_mask(const _Filter_mask&);
+		_Filter_mask& operator=(const _Filter_mask&);
+	public:
+		explicit _Filter_mask(size_t _Count)
+			: _Words(nullptr), _Word_count((_Count + _Filter_mask_iterator::_Word_bits - 1) / _Filter_mask_iterator::_Word_bits), _Resource(_Scratch_resource())
+		{
+			_Words = _Allocate_scratch<size_t>(_Resource, _Word_count);
+			std::fill_n(_Words, _Word_count, size_t(0));
+		}
+
+		~_Filter_mask()
+		{
+			_Deallocate_scratch(_Resource, _Words, _Word_count);
+		}
+
+		// _Offset is the position of the range's first element relative to the first bit,
+		// a range that filters from its second element on starts at -1
+		_Filter_mask_iterator begin(ptrdiff_t _Offset = 0)
+		{
+			return _Filter_mask_iterator(_Words, _Offset);
+		}
+
+		static size_t chunk_size(size_t _Count)
+		{
+			const size_t _Word_bits = _Filter_mask_iterator::_Word_bits;
+			const unsigned int _HdConc = get_hardware_concurrency();
+			const size_t _Chunk = (_Count + _HdConc - 1) / _HdConc;
+
+			return (_Chunk + _Word_bits - 1) / _Word_bits * _Word_bits;
+		}
+	};
+
+	// The position of the lowest bit set of a non zero word of a filter mask
+	inline size_t _Lowest_mask_bit(size_t _Word)
+	{
+#ifdef _MSC_VER
+		unsigned long _Index;
+#ifdef _WIN64
+		_BitScanForward64(&_Index, _Word);
+#else
+		_BitScanForward(&_Index, _Word);
+#endif
+		return _Index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(_Word));
+#endif
+	}
+
+	// The copy stages of copy_if, remove_if and partition_copy on contiguous ranges of arithmetic elements read
+	// the mask a word at a time instead of branching on every bit, which the predicate leaves unpredictable: a
+	// word of no marks is skipped, a word of all marks is copied as a block and the marks of the others are
+	// visited by a bit scan, one store each.
+	template<typename _InIt, typename _OutIt, typename _El = typename std::iterator_traits<_InIt>::value_type>
+	struct _Is_compress_copy : std::integral_constant<bool, _Contiguous_container_iterator_traits<_InIt>::value
+		&& _Contiguous_container_iterator_traits<_OutIt>::value && std::is_arithmetic<_El>::value
+		&& std::is_same<_El, typename std::iterator_traits<_OutIt>::value_type>::value>
+	{
+	};
+
+	// Writes the _Count elements from _Src marked in the words from _Words to _Dest and returns the end of the
+	// output, the unmarked ones with _Flip all ones. The output may overlap the elements from _Src, below them.
+	template<typename _El>
+	inline _El *_Compress_marked(const _El *_Src, size_t _Count, const size_t *_Words, _El *_Dest, size_t _Flip)
+	{
+		const size_t _Word_bits = _Filter_mask_iterator::_Word_bits;
+
+		for (size_t _Base = 0; _Base < _Count; _Base += _Word_bits, ++_Words)
+		{
+			size_t _Word = *_Words ^ _Flip;
+			if (_Count - _Base < _Word_bits)
+				_Word &= (size_t(1) << (_Count - _Base)) - 1;
+
+			if (_Word == ~size_t(0)) {
+				std::memmove(_Dest, _Src + _Base, _Word_bits * sizeof(_El));
+				_Dest += _Word_bits;
+				continue;
+			}
+
+			for (; _Word != 0; _Word &= _Word - 1)
+				*_Dest++ = _Src[_Base + _Lowest_mask_bit(_Word)];
+		}
+
+		return _Dest;
+	}
+
+	// The marked elements of the chunk at _Begin of a range zipped with its mask to _Out, or the unmarked ones.
+	// _Out is dereferenced only if the chunk has elements for it, it may be the end of the output otherwise.
+	template<typename _Iter_type, typename _OutIt>
+	inline _OutIt _Compress_chunk(_Iter_type _Begin, size_t _Count, _OutIt _Out, bool _Marked)
+	{
+		const size_t _Word_bits = _Filter_mask_iterator::_Word_bits;
+
+		auto _Elements = *_Begin;
+		const size_t * const _Words = std::get<1>(_Elements)._Word();
+		const size_t _Flip = _Marked ? size_t(0) : ~size_t(0);
+
+		size_t _Base = 0;
+		for (; _Base < _Count; _Base += _Word_bits)
+		{
+			size_t _Word = _Words[_Base / _Word_bits] ^ _Flip;
+			if (_Count - _Base < _Word_bits)
+				_Word &= (size_t(1) << (_Count - _Base)) - 1;
+			if (_Word != 0)
+				break;
+		}
+
+		if (_Base >= _Count)
+			return _Out;
+
+		const auto _Dest = _Unwrap_contiguous(_Out);
+		return _Out + (_Compress_marked(_Unwrap_contiguous(std::get<0>(_Elements)), _Count, _Words, _Dest, _Flip) - _Dest);
+	}
+
+	template<typename _OutIt, typename _DiffType = typename std::iterator_traits<_OutIt>::difference_type>
+	class _Output_token
+	{
+		_OutIt _Begin;
+		_DiffType _Iter_pos;
+	public:
+		const static _DiffType EMPTY_POSITION = static_cast<_DiffType>(-1);
+
+		_Output_token(_OutIt _It) : _Begin(_It)
+		{
+		}
+
+		// Can be called only on one thread and set once
+		void set_position(_DiffType _Pos)
+		{
+			_Iter_pos = _Pos;
+		}
+
+		_OutIt get() const
+		{
+			return _Begin;
+		}
+
+		_OutIt get_result() const
+		{
+			_OutIt _Out = _Begin;
+			std::advance(_Out, _Iter_pos);
+			return _Out;
+		}
+
+		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
+	public:
+		void move(_Output_token& _Token)
+		{
+			_Begin = _Token._Begin;
+			std::advance(_Begin, _Token._Iter_pos);
+		}
+
+		bool empty() const
+		{
+			return _Iter_pos == 0;
+		}
+	};
+
+	template<typename _OutIt, typename _OutIt2, typename _DiffType = typename std::iterator_traits<_OutIt>::difference_type>
+	class _Output_token_double
+	{
+		_OutIt _Begin;
+		_OutIt2 _Begin2;
+		_DiffType _Iter_pos;
+		_DiffType _Iter_pos2;
+	public:
+		const static _DiffType EMPTY_POSITION = static_cast<_DiffType>(-1);
+
+		_Output_token_double(_OutIt _It, _OutIt2 _It2) : _Begin(_It), _Begin2(_It2)
+		{
+		}
+
+		// Can be called only on one thread and set once
+		void set_position(_DiffType _Pos, _DiffType _Pos2)
+		{
+			_Iter_pos = _Pos;
+			_Iter_pos2 = _Pos2;
+		}
+
+		std::pair<_OutIt, _OutIt2> get() const
+		{
+			return std::pair<_OutIt, _OutIt2>(_Begin, _Begin2);
+		}
+
+		std::pair<_OutIt, _OutIt2> get_result() const
+		{
+			_OutIt _Out = _Begin;
+			std::advance(_Out, _Iter_pos);
+
+			_OutIt _Out2 = _Begin2;
+			std::advance(_Out2, _Iter_pos2);
+
+			return std::pair<_OutIt, _OutIt2>(_Out, _Out2);
+		}
+
+		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
+	public:
+		void move(_Output_token_double& _Token)
+		{
+			_Begin = _Token._Begin;
+			std::advance(_Begin, _Token._Iter_pos);
+
+			_Begin2 = _Token._Begin2;
+			std::advance(_Begin2, _Token._Iter_pos2);
+		}
+
+		bool empty() const
+		{
+			return _Iter_pos == 0 && _Iter_pos2 == 0;
+		}
+	};
+
+	// Disable warning C4324: structure was padded due to __declspec(align())
+	// This padding is expected and necessary.
+#pragma warning(push)
+#pragma warning(disable: 4324)
+	template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
+	class __declspec(align(64)) _Copy_chore : public _Contextaware_waitable_chore
+	{
+	protected:
+		enum _ChoreInternalState {
+			_Started = 0x00,
+			_Filtered = 0x00,
+			_Missed = 0x01,
+			_NotFiltered = 0x02
+		};
+
+		_It _Begin;
+		size_t _Size;
+		_First_stage _Stage1;
+		_Second_stage _Stage2;
+		_Copy_chore* _Next_chore;
+		_OutToken _Output;
+		std::exception_ptr _Exception;
+		std::atomic<int> _State;
+
+		bool try_filter()
+		{
+			return (_State.fetch_or(_Missed | _NotFiltered) & _NotFiltered) == _Filtered;
+		}
+
+		bool try_filter_missed()
+		{
+			int _ExpectedState = _Missed | _Filtered;
+			return _State.compare_exchange_strong(_ExpectedState, _Missed | _NotFiltered);
+		}
+
+		bool is_started()
+		{
+			return (_State.load() & _Missed) == _Started;
+		}
+
+		void set_filtered()
+		{
+			_State.fetch_and(~_NotFiltered);
+		}
+	public:
+		_Copy_chore(_It _First, size_t _S, _OutToken _Dest, const _First_stage& _St1, const _Second_stage& _St2, bool _Is_first = false) :
+			_Begin(_First), _Size(_S), _Output(_Dest), _Stage1(_St1), _Stage2(_St2), _Next_chore(nullptr), _Exception(nullptr)
+		{
+			_State = _Started | (_Is_first ? _Filtered : _NotFiltered);
+		}
+
+		void set_next(_Copy_chore* _Next)
+		{
+			_Next_chore = _Next;
+		}
+
+		virtual size_t _Trace_count() const override
+		{
+			return _Size;
+		}
+
+		// Can be executed on the single thread only
+		_OutToken get_output_token()
+		{
+			_ASSERT(_Next_chore == nullptr);
+			return _Output;
+		}
+
+		virtual void waitable_invoke() override
+		{
+			try {
+				if (is_started())
+					_Stage1(_Begin, _Size, _Output);
+
+				if (try_filter()) { // Check if the output buffer position was set
+					_Copy_chore* _Next = this;
+					do {
+						if (_Next->_Next_chore != nullptr) { // Pass the results to the next chore in chain
+							_Next->_Next_chore->_Output.move(_Next->_Output);
+							_Next->_Next_chore->set_filtered();
+
+							if (!_Next->_Next_chore->is_started() && _Next->_Next_chore->is_scheduled())
+								_Next->_Next_chore->reschedule();
+						}
+
+						// If none of the element was filtered there will be no copy to the buffer
+						// Skipping the stage2 handler
+						if (!_Next->_Output.empty())
+							_Next->_Stage2(_Next->_Begin, _Next->_Size, _Next->_Output);
+
+						_Next = _Next->_Next_chore;
+
+						// Pick up the work if it's not beeing executed yet
+					} while (_Next != nullptr && _Next->try_filter_missed());
+				}
+			}
+			catch (...) {
+				_Exception = std::current_exception();
+			}
+		}
+
+		template <typename _RangeCt>
+		static void wait(_RangeCt &_Range)
+		{
+			_Contextaware_waitable_chore::wait(_Range);
+
+			// The list allocates, it is built only once a chore is known to have thrown
+			auto _Thrown = std::begin(_Range);
+			while (_Thrown != std::end(_Range) && _Thrown->_Exception == nullptr)
+				++_Thrown;
+
+			if (_Thrown == std::end(_Range))
+				return;
+
+			std::list<std::exception_ptr> _ExList;
+			for (; _Thrown != std::end(_Range); ++_Thrown)
+			{
+				if (_Thrown->_Exception != nullptr)
+					_ExList.push_back(std::move(_Thrown->_Exception));
+			}
+
+			throw exception_list(std::move(_ExList));
+		}
+
+		template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
+		friend class _Remove_chore;
+	};
+
+	template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
+	class __declspec(align(64)) _Remove_chore :
+		public _Copy_chore<_It, _OutToken, _First_stage, _Second_stage>
+	{
+	public:
+		_Remove_chore(_It _First, size_t _S, _OutToken _Dest, const _First_stage& _St1, const _Second_stage& _St2, bool _Is_first = false) :
+			_Copy_chore(_First, _S, _Dest, _St1, _St2, _Is_first)
+		{
+		}
+
+		virtual void waitable_invoke() override
+		{
+			try {
+				if (is_started())
+					_Stage1(_Begin, _Size, _Output);
+
+				if (try_filter()) { // Check if the output buffer position was set
+					_Copy_chore* _Next = this;
+					do {
+						// If none of the element was filtered there will be no copy to the buffer
+						// Skipping the stage2 handler
+						if (!_Next->_Output.empty())
+							_Next->_Stage2(_Next->_Begin, _Next->_Size, _Next->_Output);
+
+						if (_Next->_Next_chore != nullptr) { // Pass the results to the next chore in chain
+							_Next->_Next_chore->_Output.move(_Next->_Output);
+							_Next->_Next_chore->set_filtered();
+						}
+
+						_Next = _Next->_Next_chore;
+
+						// Pick up the work if it's not beeing executed yet
+					} while (_Next != nullptr && _Next->try_filter_missed());
+				}
+			}
+			catch (...) {
+				_Exception = std::current_exception();
+			}
+		}
+	};
+#pragma warning(pop) // C4324
+
+	template<>
+	struct _Partitioner<copy_partitioner_tag>
+	{
+	protected:
+		template<typename _ChoreType, typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
+		static _OutToken _For_Each_impl(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		{
+			_ChoreType* _Prev_chore = nullptr;
+
+			if (_Chunk_size == 0) {
+				const unsigned int _HdConc = get_hardware_concurrency();
+				_Chunk_size = (_Count + _HdConc - 1) / _HdConc;
+			}
+
+			std::list<_ChoreType, _Chore_allocator<_ChoreType>> _Chores;
+
+			while (_Count > _Chunk_size) {
+				if (!_Chores.empty())
+					_Prev_chore = &_Chores.back();
+
+				_Chores.emplace_back(_First, _Chunk_size, _Dest, _Stage1, _Stage2, _Prev_chore == nullptr);
+
+				if (_Prev_chore != nullptr) {
+					auto _Current = &_Chores.back();
+					_Prev_chore->set_next(_Current);
+					schedule_chore(_Prev_chore);
+				}
+
+				_Count -= _Chunk_size;
+				std::advance(_First, _Chunk_size);
+			}
+
+			if (!_Chores.empty())
+				_Prev_chore = &_Chores.back();
+
+			_Chores.emplace_back(_First, _Count, _Dest, _Stage1, _Stage2, _Prev_chore == nullptr);
+
+			if (_Prev_chore != nullptr) {
+				_Prev_chore->set_next(&_Chores.back());
+				schedule_chore(_Prev_chore);
+			}
+
+			_Prev_chore = &_Chores.back();
+			_Prev_chore->waitable_invoke();
+			_ChoreType::wait(_Chores);
+
+			return _Prev_chore->get_output_token();
+		}
+
+	public:
+		template<typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
+		static _OutToken _For_Each(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		{
+			typedef _Copy_chore<_FwdIt, _OutToken, _First_stage, _Second_stage> _ChoreType;
+
+			return _For_Each_impl<_ChoreType>(_First, _Count, _Dest, _Stage1, _Stage2, _Chunk_size);
+		}
+	};
+
+	template<bool _IsNoExcept>
+	struct _Partitioner<remove_partitioner_tag, _IsNoExcept> :
+		public _Partitioner<copy_partitioner_tag, _IsNoExcept>
+	{
+		template<typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
+		static _OutToken _For_Each(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		{
+			typedef _Remove_chore<_FwdIt, _OutToken, _First_stage, _Second_stage> _ChoreType;
+
+			return _For_Each_impl<_ChoreType>(_First, _Count, _Dest, _Stage1, _Stage2, _Chunk_size);
+		}
+	};
+
+	// Lazy binary splitting. A chore runs its range chunk by chunk, and before each chunk it
+	// hands the second half of what is left to a new chore if there are idle workers to take it.
+	// Ranges split only as far as the machine can use, and a chunk that turns out to be
+	// expensive doesn't hold back the rest of its range as a fixed partition would. A normal
+	// priority chore runs the high priority ones waiting in its arena between two chunks.
+	template <typename _It, typename _UserData, typename _Callback, bool _IsNoExcept>
+	class _Splittable_chore : public WorkChoreBase
+	{
+	public:
+		struct _Shared_state
+		{
+			const _Callback& _Func;
+			const size_t _Chunk_size;
+			std::atomic<size_t> _Splits_left; // keeps the chores of a max_threads loop below its limit
+			std::mutex _Lock;
+			std::list<std::exception_ptr> _Exceptions; // lock protected
+
+			_Shared_state(const _Callback& _Fn, size_t _Chunk, size_t _Splits) : _Func(_Fn), _Chunk_size(_Chunk), _Splits_left(_Splits) {}
+
+			bool _Try_split()
+			{
+				size_t _Left = _Splits_left.load(std::memory_order_relaxed);
+				while (_Left != 0)
+				{
+					if (_Splits_left.compare_exchange_weak(_Left, _Left - 1, std::memory_order_relaxed))
+						return true;
+				}
+				return false;
+			}
+		};
+
+	private:
+		_Shared_state *_State;
+		_It _Begin;
+		size_t _Count;
+		_UserData _AlgoData;
+
+		_Splittable_chore& operator=(const _Splittable_chore&);
+
+		// Every split at least halves the range still to run, so this many children suffice
+		static size_t _Max_splits(size_t _Count, size_t _Chunk_size)
+		{
+			size_t _Splits = 0;
+			for (; _Count >= 2 * _Chunk_size; _Count -= _Count / 2)
+				++_Splits;
+			return _Splits;
+		}
+
+		void _Run_chunks(_Chore_vector<_Splittable_chore>& _Children, TaskGroup& _Tg)
+		{
+			const size_t _Chunk_size = _State->_Chunk_size;
+			_It _Curr = _Begin;
+			size_t _Left = _Count;
+
+			while (_Left > _Chunk_size)
+			{
+				if (_Left >= 2 * _Chunk_size && _Children.size() < _Children.capacity() && idleWorkerCount() != 0 && _State->_Try_split())
+				{
+					size_t _Half = _Left / 2;
+					_It _Split = _Curr;
+					std::advance(_Split, _Left - _Half);
+					_Children.emplace_back(_State, _Split, _Half, _AlgoData);
+					_Tg.run(_Children.back());
+					_Left -= _Half;
+					continue;
+				}
+
+				_State->_Func(_Curr, _Chunk_size, _AlgoData);
+				std::advance(_Curr, _Chunk_size);
+				_Left -= _Chunk_size;
+
+				// a chunk boundary, the high priority chores that queued up meanwhile go first
+				_Yield_to_high_lane();
+			}
+
+			if (_Left > 0)
+				_State->_Func(_Curr, _Left, _AlgoData);
+		}
+
+		void _Run_chunks_and_catch(_Chore_vector<_Splittable_chore>& _Children, TaskGroup& _Tg, std::true_type)
+		{
+			_Run_chunks(_Children, _Tg);
+		}
+
+		void _Run_chunks_and_catch(_Chore_vector<_Splittable_chore>& _Children, TaskGroup& _Tg, std::false_type)
+		{
+			try {
+				_Run_chunks(_Children, _Tg);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> _Guard(_State->_Lock);
+				_State->_Exceptions.push_back(std::current_exception());
+			}
+		}
+
+	protected:
+		virtual void __cdecl userFunc() override
+		{
+			run_range();
+		}
+
+	public:
+		_Splittable_chore(_Shared_state *_St, _It _First, size_t _Dist, const _UserData& _Data) :
+			_State(_St), _Begin(std::move(_First)), _Count(_Dist), _AlgoData(_Data) {}
+
+		// Only used by the vector before the chore is scheduled
+		_Splittable_chore(const _Splittable_chore& _Other) :
+			_State(_Other._State), _Begin(_Other._Begin), _Count(_Other._Count), _AlgoData(_Other._AlgoData) {}
+
+		void run_range()
+		{
+			_Chore_vector<_Splittable_chore> _Children;
+			_Children.reserve(_Max_splits(_Count, _State->_Chunk_size));
+
+			TaskGroup _Tg;
+			_Run_chunks_and_catch(_Children, _Tg, std::integral_constant<bool, _IsNoExcept>());
+			_Tg.wait();
+		}
+	};
+
+	template<bool _IsNoExcept>
+	struct _Partitioner<dynamic_partitioner_tag, _IsNoExcept>
+	{
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			typedef _Splittable_chore<_FwdIt, _UserData, _Callback, _IsNoExcept> _ChoreType;
+
+			// Small enough that the last chunks even out, large enough to amortize the idle check
+			if (_Chunk_size == 0)
+				_Chunk_size = (std::max)(_Count / (_Thread_count(_Max_threads) * 32), static_cast<size_t>(1));
+
+			// Without a limit the ranges split as long as there are idle workers
+			const size_t _Splits = _Max_threads != 0 ? _Max_threads - 1 : (std::numeric_limits<size_t>::max)();
+			typename _ChoreType::_Shared_state _State(_Func, _Chunk_size, _Splits);
+			_ChoreType _Root(&_State, _First, _Count, _Data);
+			_Root.run_range();
+
+			if (!_State._Exceptions.empty())
+				throw exception_list(std::move(_State._Exceptions));
+
+			std::advance(_First, _Count);
+			return _First;
+		}
+	};
+
+	// One loop scheduled through an affinity_partitioner. The range is cut into the sub-ranges of
+	// the previous run and every thread that joins the loop first claims the sub-ranges it ran
+	// last time. What is left, because their worker is busy elsewhere or the range has changed,
+	// is claimed from the back by whoever runs out of its own. The new owners are recorded for
+	// the next run.
+	template <typename _It, typename _UserData, typename _Callback, bool _IsNoExcept>
+	class _Affinity_loop
+	{
+		const _Callback& _Func;
+		const _UserData& _Data;
+		const size_t _Count;
+		const size_t _Parts;
+		const unsigned int *_Last_workers; // nullptr on the first run
+		std::vector<unsigned int>& _Next_workers;
+		_Chore_vector<_It> _Begins;
+		std::unique_ptr<std::atomic<bool>[]> _Claimed;
+		std::mutex _Lock;
+		std::list<std::exception_ptr> _Exceptions; // lock protected
+
+		_Affinity_loop& operator=(const _Affinity_loop&);
+
+		size_t _Part_size(size_t _Part) const
+		{
+			return _Count / _Parts + (_Part < _Count % _Parts ? 1 : 0);
+		}
+
+		bool _Try_claim(size_t _Part)
+		{
+			return !_Claimed[_Part].load(std::memory_order_relaxed) && !_Claimed[_Part].exchange(true, std::memory_order_acquire);
+		}
+
+		void _Run_part(size_t _Part, unsigned int _Worker, std::true_type)
+		{
+			_UserData _Part_data(_Data);
+			_Next_workers[_Part] = _Worker;
+			_Func(_Begins[_Part], _Part_size(_Part), _Part_data);
+		}
+
+		void _Run_part(size_t _Part, unsigned int _Worker, std::false_type)
+		{
+			try {
+				_Run_part(_Part, _Worker, std::true_type());
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> _Guard(_Lock);
+				_Exceptions.push_back(std::current_exception());
+			}
+		}
+
+	public:
+		_Affinity_loop(_It _First, size_t _Dist, const _UserData& _Dt, const _Callback& _Fn, size_t _Part_count, const unsigned int *_Last, std::vector<unsigned int>& _Next) :
+			_Func(_Fn), _Data(_Dt), _Count(_Dist), _Parts(_Part_count), _Last_workers(_Last), _Next_workers(_Next), _Claimed(new std::atomic<bool>[_Part_count])
+		{
+			_Begins.reserve(_Parts);
+			for (size_t _Part = 0; _Part < _Parts; ++_Part)
+			{
+				_Begins.push_back(_First);
+				_Claimed[_Part].store(false, std::memory_order_relaxed);
+				if (_Part + 1 < _Parts)
+					std::advance(_First, _Part_size(_Part));
+			}
+		}
+
+		// Runs sub-ranges on the calling thread until all of them are claimed
+		void run_worker()
+		{
+			const unsigned int _Worker = current_worker_slot();
+			std::integral_constant<bool, _IsNoExcept> _Catch_tag;
+
+			if (_Last_workers != nullptr)
+			{
+				for (size_t _Part = 0; _Part < _Parts; ++_Part)
+				{
+					if (_Last_workers[_Part] == _Worker && _Try_claim(_Part))
+						_Run_part(_Part, _Worker, _Catch_tag);
+				}
+			}
+
+			for (size_t _Part = _Parts; _Part-- > 0;)
+			{
+				if (_Try_claim(_Part))
+					_Run_part(_Part, _Worker, _Catch_tag);
+			}
+		}
+
+		std::list<std::exception_ptr>& exceptions()
+		{
+			return _Exceptions;
+		}
+	};
+
+	template <typename _LoopType>
+	class _Affinity_chore : public WorkChoreBase
+	{
+		_LoopType *_Loop;
+	protected:
+		virtual void __cdecl userFunc() override
+		{
+			_Loop->run_worker();
+		}
+	public:
+		explicit _Affinity_chore(_LoopType *_Lp) : _Loop(_Lp) {}
+
+		// Only used by the vector before the chore is scheduled
+		_Affinity_chore(const _Affinity_chore& _Other) : _Loop(_Other._Loop) {}
+	};
+
+	template<bool _IsNoExcept>
+	struct _Partitioner<affinity_partitioner_tag, _IsNoExcept>
+	{
+		static const size_t _Parts_per_thread = 4;
+
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each(affinity_partitioner& _Affinity, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			typedef _Affinity_loop<_FwdIt, _UserData, _Callback, _IsNoExcept> _LoopType;
+
+			const unsigned int _HdConc = _Thread_count(_Max_threads);
+
+			// The sub-ranges are replayed only for a range of the same size
+			const bool _Replay = _Affinity._Count == _Count && !_Affinity._Workers.empty();
+			size_t _Parts = _Affinity._Workers.size();
+			if (!_Replay)
+			{
+				if (_Chunk_size == 0)
+					_Chunk_size = 1;
+				_Parts = (std::max)((std::min)(_Count / _Chunk_size, _HdConc * _Parts_per_thread), static_cast<size_t>(1));
+			}
+
+			std::vector<unsigned int> _Next_workers(_Parts, 0);
+			_LoopType _Loop(_First, _Count, _Data, _Func, _Parts, _Replay ? _Affinity._Workers.data() : nullptr, _Next_workers);
+
+			{
+				_Chore_vector<_Affinity_chore<_LoopType>> _Tasks;
+				size_t _Task_count = (std::min)(_Parts, static_cast<size_t>(_HdConc)) - 1;
+				_Tasks.reserve(_Task_count);
+
+				TaskGroup _Tg;
+				for (size_t _Task = 0; _Task < _Task_count; ++_Task)
+				{
+					_Tasks.emplace_back(&_Loop);
+					_Tg.run(_Tasks.back());
+				}
+
+				_Loop.run_worker();
+				_Tg.wait();
+			}
+
+			_Affinity._Workers.swap(_Next_workers);
+			_Affinity._Count = _Count;
+
+			if (!_Loop.exceptions().empty())
+				throw exception_list(std::move(_Loop.exceptions()));
+
+			std::advance(_First, _Count);
+			return _First;
+		}
+	};
+
+	// Per element cost the adaptive partitioner learned for one algorithm and functor instantiation.
+	// A site is a zero initialized static, registered for diagnostics when it is first sampled.
+	struct _Cutoff_site
+	{
+		std::atomic<unsigned int> _Samples;
+		std::atomic<unsigned long long> _Ps_per_element; // picoseconds, averaged over the samples
+		std::atomic<bool> _Registered;
+		const char *_Name;
+		_Cutoff_site *_Next;
+
+		// What the imbalance profiler gathered over the calls it timed, summed
+		std::atomic<unsigned int> _Profiled_calls;
+		std::atomic<unsigned int> _Same_size_calls; // over as many elements as the call before
+		std::atomic<size_t> _Last_count;
+		std::atomic<unsigned long long> _Chunks;
+		std::atomic<unsigned long long> _Elements;
+		std::atomic<unsigned long long> _Chunk_ps;
+		std::atomic<unsigned long long> _Tail_permille;
+		std::atomic<unsigned long long> _Spread_permille;
+		std::atomic<unsigned int> _Advice; // the partitioner_kind advised plus 1, 0 without an advice
+		std::atomic<size_t> _Advice_grain;
+	};
+
+	/// <summary>
+	///     What the adaptive partitioner learned about a call site, see get_cutoff_sites.
+	/// </summary>
+	struct cutoff_site_info
+	{
+		const char *name; // type of the loop body
+		unsigned int samples; // calls that were timed
+		double ns_per_element;
+		size_t sequential_cutoff; // ranges up to this size run inline
+		size_t grain; // smallest chunk handed to a thread
+	};
+
+	const unsigned int _Cutoff_sample_runs = 4;
+	const unsigned long long _Cutoff_probe_ps = 20000000ull; // 20us of the first calls run inline to time the body
+	const unsigned long long _Cutoff_parallel_work_ps = 50000000ull; // less work than 50us doesn't pay for the fork and join
+	const unsigned long long _Cutoff_chunk_work_ps = 10000000ull; // 10us of work per chunk amortizes its scheduling
+
+	inline size_t _Cutoff_sequential_limit(unsigned long long _Ps_per_element)
+	{
+		return static_cast<size_t>(_Cutoff_parallel_work_ps / (std::max)(_Ps_per_element, 1ull));
+	}
+
+	inline size_t _Cutoff_grain(unsigned long long _Ps_per_element)
+	{
+		return (std::max)(static_cast<size_t>(_Cutoff_chunk_work_ps / (std::max)(_Ps_per_element, 1ull)), static_cast<size_t>(1));
+	}
+
+	_EXP_IMPL unsigned long long __cdecl _Cutoff_clock_ps();
+	_EXP_IMPL void __cdecl _Register_cutoff_site(_Cutoff_site *_Site, const char *_Name);
+
+	// Fills up to _Capacity entries with the call sites the adaptive partitioner has sampled so far,
+	// returns the number of sites.
+	_EXP_IMPL size_t __cdecl get_cutoff_sites(cutoff_site_info *_Sites, size_t _Capacity);
+
+	// The site of a loop body, shared by the adaptive partitioner and the imbalance profiler
+	template<typename _FwdIt, typename _UserData, typename _Callback>
+	inline _Cutoff_site& _Cutoff_site_of()
+	{
+		static _Cutoff_site _Instance;
+		return _Instance;
+	}
+
+	// The chunk times of a call the imbalance profiler times
+	struct _Chunk_timings
+	{
+		std::atomic<size_t> _Chunks;
+		std::atomic<size_t> _Elements;
+		std::atomic<unsigned long long> _Ps;
+		std::atomic<unsigned long long> _Max_ps;
+		std::atomic<unsigned long long> _Min_ps_per_element; // of the chunks long enough to time
+		std::atomic<unsigned long long> _Max_ps_per_element;
+
+		_Chunk_timings() : _Chunks(0), _Elements(0), _Ps(0), _Max_ps(0), _Min_ps_per_element((std::numeric_limits<unsigned long long>::max)()), _Max_ps_per_element(0)
+		{
+		}
+
+		void _Add(size_t _Count, unsigned long long _Elapsed)
+		{
+			_Chunks.fetch_add(1, std::memory_order_relaxed);
+			_Elements.fetch_add(_Count, std::memory_order_relaxed);
+			_Ps.fetch_add(_Elapsed, std::memory_order_relaxed);
+			_Raise(_Max_ps, _Elapsed);
+
+			// the clock ticks in 100ns or so, the cost of shorter chunks is mostly noise
+			if (_Elapsed >= 1000000ull && _Count != 0)
+			{
+				const unsigned long long _Per_element = _Elapsed / _Count;
+				_Raise(_Max_ps_per_element, _Per_element);
+
+				unsigned long long _Min = _Min_ps_per_element.load(std::memory_order_relaxed);
+				while (_Per_element < _Min && !_Min_ps_per_element.compare_exchange_weak(_Min, _Per_element, std::memory_order_relaxed))
+				{
+				}
+			}
+		}
+
+		static void _Raise(std::atomic<unsigned long long>& _Max, unsigned long long _Value)
+		{
+			unsigned long long _Current = _Max.load(std::memory_order_relaxed);
+			while (_Value > _Current && !_Max.compare_exchange_weak(_Current, _Value, std::memory_order_relaxed))
+			{
+			}
+		}
+	};
+
+	// A chunk callback that times the chunks of a loop
+	template<typename _Callback>
+	struct _Timed_chunk_callback
+	{
+		const _Callback& _Func;
+		_Chunk_timings& _Timings;
+
+		_Timed_chunk_callback(const _Callback& _Fn, _Chunk_timings& _Tm) : _Func(_Fn), _Timings(_Tm)
+		{
+		}
+
+		template<typename _FwdIt, typename _UserData>
+		void operator()(_FwdIt&& _First, size_t _Count, _UserData&& _Data) const
+		{
+			const unsigned long long _Start = _Cutoff_clock_ps();
+			_Func(std::forward<_FwdIt>(_First), _Count, std::forward<_UserData>(_Data));
+			_Timings._Add(_Count, _Cutoff_clock_ps() - _Start);
+		}
+
+	private:
+		_Timed_chunk_callback& operator=(const _Timed_chunk_callback&);
+	};
+
+	// The loop body a site is keyed on, a timed loop has the site of its body
+	template<typename _Callback>
+	struct _Untimed_callback
+	{
+		typedef _Callback type;
+	};
+
+	template<typename _Callback>
+	struct _Untimed_callback<_Timed_chunk_callback<_Callback>>
+	{
+		typedef _Callback type;
+	};
+
+	// Adds a call of _Count elements to the profile of a site and updates its advice
+	_EXP_IMPL void __cdecl _Record_imbalance(_Cutoff_site& _Site, const char *_Name, const _Chunk_timings& _Timings, size_t _Count);
+
+	// Times the body on a prefix of the first calls of a site, then runs the calls whose work is
+	// below the cost of going parallel inline and hands the others to the self guided partitioner
+	// with a grain worth scheduling.
+	template<bool _IsNoExcept>
+	struct _Partitioner<adaptive_partitioner_tag, _IsNoExcept>
+	{
+	private:
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static void _Run_inline(_FwdIt _First, size_t _Count, const _UserData& _Data, const _Callback& _Func, std::true_type)
+		{
+			_UserData _Chunk_data(_Data);
+			_Func(_First, _Count, _Chunk_data);
+		}
+
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static void _Run_inline(_FwdIt _First, size_t _Count, const _UserData& _Data, const _Callback& _Func, std::false_type)
+		{
+			try {
+				_Run_inline(std::move(_First), _Count, _Data, _Func, std::true_type());
+			}
+			catch (...) {
+				std::list<std::exception_ptr> _ExList;
+				_ExList.push_back(std::current_exception());
+				throw exception_list(std::move(_ExList));
+			}
+		}
+
+		static void _Record(_Cutoff_site& _Site, const char *_Name, size_t _Count, unsigned long long _Elapsed_ps)
+		{
+			if (!_Site._Registered.exchange(true))
+				_Register_cutoff_site(&_Site, _Name);
+			if (_Count == 0)
+				return;
+
+			// concurrent first calls may lose a sample, the estimate stays close enough
+			const unsigned long long _Ps = (std::max)(_Elapsed_ps / _Count, 1ull);
+			const unsigned int _Sample = (std::min)(_Site._Samples.fetch_add(1, std::memory_order_relaxed), _Cutoff_sample_runs);
+			const unsigned long long _Average = _Site._Ps_per_element.load(std::memory_order_relaxed);
+			_Site._Ps_per_element.store((_Average * _Sample + _Ps) / (_Sample + 1), std::memory_order_relaxed);
+		}
+
+	public:
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_Each(_FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Chunk_size = 0, unsigned int _Max_threads = 0)
+		{
+			typedef typename _Untimed_callback<_Callback>::type _Body;
+			if (_Count == 0)
+				return _First;
+
+			const std::integral_constant<bool, _IsNoExcept> _Catch_tag = {};
+			_Cutoff_site& _Site = _Cutoff_site_of<_FwdIt, _UserData, _Body>();
+
+			if (_Site._Samples.load(std::memory_order_relaxed) < _Cutoff_sample_runs)
+			{
+				// Batches of doubling size until the time taken is large enough to measure
+				const unsigned long long _Start = _Cutoff_clock_ps();
+				unsigned long long _Elapsed = 0;
+				size_t _Done = 0;
+				for (size_t _Batch = 1; _Done < _Count && _Elapsed < _Cutoff_probe_ps; _Batch *= 2)
+				{
+					const size_t _Step = (std::min)(_Batch, _Count - _Done);
+					_Run_inline(_First, _Step, _Data, _Func, _Catch_tag);
+					std::advance(_First, _Step);
+					_Done += _Step;
+					_Elapsed = _Cutoff_clock_ps() - _Start;
+				}
+
+				_Record(_Site, typeid(_Body).name(), _Done, _Elapsed);
+				_Count -= _Done;
+				if (_Count == 0)
+					return _First;
+			}
+
+			const unsigned long long _Ps = _Site._Ps_per_element.load(std::memory_order_relaxed);
+			if (_Count <= _Cutoff_sequential_limit(_Ps))
+			{
+				_Run_inline(_First, _Count, _Data, _Func, _Catch_tag);
+				std::advance(_First, _Count);
+				return _First;
+			}
+
+#if _EXP_TELEMETRY
+			// The advice of the imbalance profiler comes from the chunks of the parallel calls, it replaces
+			// the grain estimated from the inline samples
+			const unsigned int _Advice = _Site._Advice.load(std::memory_order_relaxed);
+			if (_Advice != 0 && imbalance_profiling_mode() == imbalance_profiling::tune)
+			{
+				const size_t _Advice_grain = (std::max)(_Site._Advice_grain.load(std::memory_order_relaxed), _Chunk_size);
+				return _For_each_advised(static_cast<partitioner_kind>(_Advice - 1), std::move(_First), _Count, std::move(_Data), _Func, _Advice_grain, _Max_threads);
+			}
+#endif
+
+			const size_t _Grain = (std::max)(_Cutoff_grain(_Ps), _Chunk_size);
+			return _Partitioner<auto_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+		}
+
+	private:
+		template<typename _FwdIt, typename _UserData, typename _Callback>
+		static _FwdIt _For_each_advised(partitioner_kind _Kind, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, size_t _Grain, unsigned int _Max_threads)
+		{
+			switch (_Kind)
+			{
+			case partitioner_kind::static_:
+			{
+				const unsigned int _Threads = _Thread_count(_Max_threads);
+				const size_t _Chunk_size = (std::max)((_Count + _Threads - 1) / _Threads, _Grain);
+				return _Partitioner<static_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size, _Max_threads);
+			}
+			case partitioner_kind::dynamic_:
+				return _Partitioner<dynamic_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+			default:
+				return _Partitioner<auto_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+			}
+		}
+	};
+
+	// parallel_execution_policy defaults to self guided partitioner
+	template<bool _IsNoExcept>
+	struct _Partitioner<parallel_execution_policy, _IsNoExcept> :
+		public _Partitioner<auto_partitioner_tag, _IsNoExcept>
+	{
+	};
+
+	// parallel_dynamic_execution_policy splits the ranges on demand
+	template<bool _IsNoExcept>
+	struct _Partitioner<parallel_dynamic_execution_policy, _IsNoExcept> :
+		public _Partitioner<dynamic_partitioner_tag, _IsNoExcept>
+	{
+	};
+
+	// parallel_vector_execution_policy defaults to self guided partitioner
+	template<bool _IsNoExcept>
+	struct _Partitioner<parallel_vector_execution_policy, _IsNoExcept> :
+		public _Partitioner<auto_partitioner_tag, _IsNoExcept>
+	{
+	};
+
+	// parallel_affinity_execution_policy without its partitioner, for the algorithms that don't replay affinity
+	template<bool _IsNoExcept>
+	struct _Partitioner<parallel_affinity_execution_policy, _IsNoExcept> :
+		public _Partitioner<auto_partitioner_tag, _IsNoExcept>
+	{
+	};
+
+	// True if the element function _Fn can be called on the elements of _InIts without throwing
+	template<typename _Fn, typename... _InIts>
+	struct _Is_nothrow_element_call : std::integral_constant<bool,
+		_EXP_IS_NOEXCEPT(std::declval<_Fn&>()(std::declval<typename std::iterator_traits<_InIts>::reference>()...))>
+	{
+	};
+
+	// True if storing the result of _Fn called on the elements of _InIts to an element of _OutIt can't throw
+	template<typename _Fn, typename _OutIt, typename... _InIts>
+	struct _Is_nothrow_element_store : std::integral_constant<bool,
+		_EXP_IS_NOEXCEPT(std::declval<typename std::iterator_traits<_OutIt>::reference>() =
+			std::declval<_Fn&>()(std::declval<typename std::iterator_traits<_InIts>::reference>()...))>
+	{
+	};
+
+	// True if the chunk callback of a loop is declared not to throw
+	template<typename _Callback, typename _FwdIt, typename _UserData>
+	struct _Is_nothrow_chunk_callback : std::integral_constant<bool,
+		_EXP_IS_NOEXCEPT(std::declval<const _Callback&>()(std::declval<_FwdIt&>(), size_t(), std::declval<_UserData&>()))>
+	{
+	};
+
+	// Runs a loop on the partitioner of the execution policy, or the one picked by its execution
+	// parameters, which also give the grain and the thread limit. Policies that carry the state
+	// of their partitioner hand it over here.
+	template<typename _ExPolicy, typename _FwdIt, typename _UserData, typename _Callback, bool _IsNoExcept>
+	inline _FwdIt _Partitioned_for_each(const _ExPolicy& _Policy, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, std::integral_constant<bool, _IsNoExcept>)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const execution_parameters& _Params = _Policy.parameters();
+		const size_t _Grain = _Params.grain_size();
+		const unsigned int _Max_threads = _Params.thread_limit();
+
+		switch (_Params.partitioner_choice())
+		{
+		case partitioner_kind::static_:
+		{
+			// the static partitioner takes an exact chunk size, the grain only bounds it from below
+			const unsigned int _Threads = _Thread_count(_Max_threads);
+			const size_t _Chunk_size = _Grain != 0 ? (std::max)((_Count + _Threads - 1) / _Threads, _Grain) : 0;
+			return _Partitioner<static_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Chunk_size, _Max_threads);
+		}
+		case partitioner_kind::auto_:
+			return _Partitioner<auto_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+		case partitioner_kind::dynamic_:
+			return _Partitioner<dynamic_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+		case partitioner_kind::adaptive_:
+			return _Partitioner<adaptive_partitioner_tag, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+		default:
+			return _Partitioner<_ExPolicy, _IsNoExcept>::_For_Each(std::move(_First), _Count, std::move(_Data), _Func, _Grain, _Max_threads);
+		}
+	}
+
+	template<typename _FwdIt, typename _UserData, typename _Callback, bool _IsNoExcept>
+	inline _FwdIt _Partitioned_for_each(const parallel_affinity_execution_policy& _Policy, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, std::integral_constant<bool, _IsNoExcept>)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const execution_parameters& _Params = _Policy.parameters();
+		return _Partitioner<affinity_partitioner_tag, _IsNoExcept>::_For_Each(_Policy.partitioner(), std::move(_First), _Count, std::move(_Data), _Func, _Params.grain_size(), _Params.thread_limit());
+	}
+
+	// Times the chunks of the loop while the imbalance profiler records
+	template<typename _ExPolicy, typename _FwdIt, typename _UserData, typename _Callback, typename _No_throw>
+	inline _FwdIt _Profiled_for_each(const _ExPolicy& _Policy, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func, _No_throw _Tag)
+	{
+#if _EXP_TELEMETRY
+		if (_Count != 0 && imbalance_profiling_mode() != imbalance_profiling::off)
+		{
+			_Chunk_timings _Timings;
+			const _Timed_chunk_callback<_Callback> _Timed(_Func, _Timings);
+			_First = _Partitioned_for_each(_Policy, std::move(_First), _Count, std::move(_Data), _Timed, _Tag);
+			_Record_imbalance(_Cutoff_site_of<_FwdIt, _UserData, _Callback>(), typeid(_Callback).name(), _Timings, _Count);
+			return _First;
+		}
+#endif
+		return _Partitioned_for_each(_Policy, std::move(_First), _Count, std::move(_Data), _Func, _Tag);
+	}
+
+	// The chores skip the exception handling under par_vec, for chunk callbacks declared noexcept
+	// and when the policy carries the no_throw parameter
+	template<typename _ExPolicy, typename _FwdIt, typename _UserData, typename _Callback>
+	inline _FwdIt _Partitioned_for_each(const _ExPolicy& _Policy, _FwdIt _First, size_t _Count, _UserData _Data, const _Callback& _Func)
+	{
+		typedef std::integral_constant<bool, std::is_base_of<parallel_vector_execution_policy, _ExPolicy>::value
+			|| _Is_nothrow_chunk_callback<_Callback, _FwdIt, _UserData>::value> _Static_no_throw;
+
+		if (!_Static_no_throw::value && _Policy.parameters().no_throw_promised())
+			return _Profiled_for_each(_Policy, std::move(_First), _Count, std::move(_Data), _Func, std::true_type());
+
+		return _Profiled_for_each(_Policy, std::move(_First), _Count, std::move(_Data), _Func, _Static_no_throw());
+	}
+
+	// Destroys _Count constructed objects from _First
+	template<typename _FwdIt>
+	inline void _Destroy_range(_FwdIt _First, size_t _Count)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		for (; _Count > 0; --_Count, ++_First)
+			std::addressof(*_First)->~value_type();
+	}
+
+	// Runs the chunks of an uninitialized algorithm. A chunk either constructs all of its objects or rolls
+	// back, when one fails _Destroy_fn destroys the objects of the chunks that completed before the
+	// exceptions are rethrown.
+	template<typename _ExPolicy, typename _FwdIt, typename _Callback, typename _Destroy>
+	inline _FwdIt _Uninitialized_for_each(const _ExPolicy&, _FwdIt _First, size_t _Count, const _Callback& _Func, const _Destroy& _Destroy_fn)
+	{
+		return _Partitioner<static_partitioner_tag>::_For_each_with_cleanup(std::move(_First), _Count, std::tuple<>(),
+			[&_Func](_FwdIt _Begin, size_t _Partition_size, std::tuple<>) {
+			_Func(_Begin, _Partition_size);
+		},
+			[&_Destroy_fn](_FwdIt _Begin, size_t _Partition_size, std::exception_ptr& _Ex) {
+			if (_Ex == nullptr)
+				_Destroy_fn(_Begin, _Partition_size);
+		});
+	}
+
+	// First touch: the chunks run on the affinity partitioner of the policy, which records the worker of each
+	// of them. A later loop over a range of the same size with that partitioner gives every chunk back to the
+	// worker that touched its pages first, the memory it reads is on its own NUMA node.
+	template<typename _FwdIt, typename _Callback, typename _Destroy>
+	inline _FwdIt _Uninitialized_for_each(const parallel_affinity_execution_policy& _Policy, _FwdIt _First, size_t _Count, const _Callback& _Func, const _Destroy& _Destroy_fn)
+	{
+		const execution_parameters& _Params = _Policy.parameters();
+		std::mutex _Lock;
+		std::vector<std::pair<_FwdIt, size_t>> _Completed;
+
+		try {
+			return _Partitioner<affinity_partitioner_tag, false>::_For_Each(_Policy.partitioner(), std::move(_First), _Count, 0,
+				[&_Func, &_Destroy_fn, &_Lock, &_Completed](_FwdIt _Begin, size_t _Partition_size, int&) {
+				_Func(_Begin, _Partition_size);
+
+				try {
+					std::lock_guard<std::mutex> _Guard(_Lock);
+					_Completed.emplace_back(_Begin, _Partition_size);
+				}
+				catch (...) {
+					_Destroy_fn(_Begin, _Partition_size);
+					throw;
+				}
+			}, _Params.grain_size(), _Params.thread_limit());
+		}
+		catch (const exception_list&) {
+			for (auto& _Chunk : _Completed)
+				_Destroy_fn(_Chunk.first, _Chunk.second);
+
+			throw;
+		}
+	}
+
+	// Sequential cutoff of the algorithms that split recursively: the grain of the policy if set
+	template<typename _ExPolicy>
+	inline size_t _Grain_size(const _ExPolicy& _Policy, size_t _Default)
+	{
+		const size_t _Grain = _Policy.parameters().grain_size();
+		return _Grain != 0 ? _Grain : _Default;
+	}
+
+	// Threads the recursive algorithms split their work for
+	template<typename _ExPolicy>
+	inline unsigned int _Policy_thread_count(const _ExPolicy& _Policy)
+	{
+		return _Thread_count(_Policy.parameters().thread_limit());
+	}
+
+	// A chunked reduction splits its range into chunks of the grain at least, and no more than a few
+	// chunks per thread. The split only depends on the size, the grain and the thread limit, so the
+	// partial results of a range are combined in the same order from one call to the next.
+	const size_t _Reduction_min_chunk = 2048;
+	const size_t _Reduction_chunks_per_thread = 4;
+
+	// Tree levels with fewer pairs of partial results are combined on the calling thread
+	const size_t _Reduction_tree_min_pairs = 8;
+
+	template<typename _ExPolicy>
+	inline size_t _Reduction_chunk_count(const _ExPolicy& _Policy, size_t _Count)
+	{
+		const size_t _Grain = _Grain_size(_Policy, _Reduction_min_chunk);
+		const size_t _Max_chunks = static_cast<size_t>(_Policy_thread_count(_Policy)) * _Reduction_chunks_per_thread;
+
+		return (std::max)(size_t{ 1 }, (std::min)((_Count + _Grain - 1) / _Grain, _Max_chunks));
+	}
+
+	// Disable warning C4324: structure was padded due to __declspec(align())
+	// This padding is expected and necessary.
+#pragma warning(push)
+#pragma warning(disable: 4324)
+	template<typename _Ty>
+	struct __declspec(align(64)) _Reduction_slot
+	{
+		typename std::aligned_storage<sizeof(_Ty), std::alignment_of<_Ty>::value>::type _Storage;
+		bool _Constructed;
+
+		_Ty& get()
+		{
+			return *reinterpret_cast<_Ty *>(&_Storage);
+		}
+	};
+#pragma warning(pop) // C4324
+
+	// Partial results of a chunked reduction indexed by chunk, each slot on a cache line of its own
+	// so the chunks don't false share. A slot is constructed by its chunk, and destroyed with the array.
+	template<typename _Ty>
+	class _Reduction_slots
+	{
+		typedef _Reduction_slot<_Ty> _Slot;
+
+		_Slot *_Slots;
+		size_t _Count;
+		memory_resource *_Resource;
+
+		_Reduction_slots(const _Reduction_slots&);
+		_Reduction_slots& operator=(const _Reduction_slots&);
+	public:
+		explicit _Reduction_slots(size_t _Cnt) : _Slots(nullptr), _Count(_Cnt), _Resource(_Scratch_resource())
+		{
+			// the resource is asked for the cache line alignment of the slots
+			_Slots = _Allocate_scratch<_Slot>(_Resource, _Cnt);
+
+			// value initialized, the slots start unconstructed
+			for (size_t _I = 0; _I < _Count; ++_I)
+				::new (static_cast<void *>(_Slots + _I)) _Slot();
+		}
+
+		~_Reduction_slots()
+		{
+			for (size_t _I = 0; _I < _Count; ++_I)
+			{
+				if (_Slots[_I]._Constructed)
+					_Slots[_I].get().~_Ty();
+			}
+			_Deallocate_scratch(_Resource, _Slots, _Count);
+		}
+
+		template<typename _Uty>
+		void emplace(size_t _I, _Uty&& _Val)
+		{
+			::new (static_cast<void *>(&_Slots[_I]._Storage)) _Ty(std::forward<_Uty>(_Val));
+			_Slots[_I]._Constructed = true;
+		}
+
+		_Ty& operator[](size_t _I)
+		{
+			return _Slots[_I].get();
+		}
+
+		_Slot *begin() const
+		{
+			return _Slots;
+		}
+
+		size_t size() const
+		{
+			return _Count;
+		}
+	};
+
+	// Combines the slots into the first one in a binary tree: neighbours first, then pairs of pairs,
+	// a combine sees the left and the right partial results in that order. The levels with enough
+	// pairs are combined in parallel, every chore on its copy of _Data.
+	template<typename _Ty, typename _UserData, typename _CombineFn, bool _IsNoExcept>
+	void _Combine_slots(_Reduction_slots<_Ty>& _Slots, _UserData& _Data, const _CombineFn& _Combine, unsigned int _Max_threads, std::integral_constant<bool, _IsNoExcept>)
+	{
+		typedef _Reduction_slot<_Ty> _Slot;
+
+		const size_t _Count = _Slots.size();
+		_Slot * const _Base = _Slots.begin();
+
+		for (size_t _Stride = 1; _Stride < _Count; _Stride *= 2)
+		{
+			const size_t _Pairs = (_Count - _Stride + 2 * _Stride - 1) / (2 * _Stride);
+			auto _Combine_pair = [&_Slots, &_Combine, _Stride](size_t _Pair, _UserData& _User) {
+				const size_t _Left = _Pair * 2 * _Stride;
+				_Slots[_Left] = _Combine(_Slots[_Left], _Slots[_Left + _Stride], _User);
+			};
+
+			if (_Pairs < _Reduction_tree_min_pairs)
+			{
+				for (size_t _Pair = 0; _Pair < _Pairs; ++_Pair)
+					_Combine_pair(_Pair, _Data);
+			}
+			else
+			{
+				// The partitioner walks the slots as pair numbers
+				_Partitioner<static_partitioner_tag, _IsNoExcept>::_For_Each(_Base, _Pairs, _Data,
+					[_Base, &_Combine_pair](_Slot *_Begin, size_t _Pair_count, _UserData& _User) {
+					for (size_t _Pair = _Begin - _Base, _End = _Pair + _Pair_count; _Pair < _End; ++_Pair)
+						_Combine_pair(_Pair, _User);
+				}, 1, _Max_threads);
+			}
+		}
+	}
+
+	// Reduces _Count elements of a random access range without per thread state. _Func(_Begin, _Count, _Data)
+	// gives the partial result of a chunk, which is stored to the chunk's slot, and the slots are combined by
+	// _Combine(_Left, _Right, _Data) in _Combine_slots' tree. The order of the chunks is kept, so with the same
+	// split the result is the same from one call to the next, floating point sums included.
+	template<typename _Ty, typename _ExPolicy, typename _RanIt, typename _UserData, typename _Fn, typename _CombineFn>
+	_Ty _Chunked_reduce(const _ExPolicy& _Policy, _RanIt _First, size_t _Count, _UserData _Data, const _Fn& _Func, const _CombineFn& _Combine)
+	{
+		typedef _Reduction_slot<_Ty> _Slot;
+		typedef _Partitioner<static_partitioner_tag, std::is_base_of<parallel_vector_execution_policy, _ExPolicy>::value> _Chunk_partitioner;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Chunks = _Reduction_chunk_count(_Policy, _Count);
+		const size_t _Step = _Count / _Chunks;
+		const size_t _Extra = _Count % _Chunks; // the first _Extra chunks take one element more
+		const unsigned int _Max_threads = _Policy.parameters().thread_limit();
+
+		_Reduction_slots<_Ty> _Slots(_Chunks);
+		_Slot * const _Base = _Slots.begin();
+
+		// The partitioner walks the slots, a chore reduces the chunks of the slots it is given
+		_Chunk_partitioner::_For_Each(_Base, _Chunks, _Data,
+			[&_Slots, _Base, &_First, _Step, _Extra, &_Func](_Slot *_Begin, size_t _Slot_count, _UserData& _User) {
+			for (size_t _Chunk = _Begin - _Base, _End = _Chunk + _Slot_count; _Chunk < _End; ++_Chunk)
+				_Slots.emplace(_Chunk, _Func(_First + (_Chunk * _Step + (std::min)(_Chunk, _Extra)), _Step + (_Chunk < _Extra ? 1 : 0), _User));
+		}, 1, _Max_threads);
+
+		_Combine_slots(_Slots, _Data, _Combine, _Max_threads, std::integral_constant<bool, std::is_base_of<parallel_vector_execution_policy, _ExPolicy>::value>());
+		return _Slots[0];
+	}
+
+	template<typename _Ty>
+	template<typename _Function>
+	_Ty combinable<_Ty>::combine_parallel(_Function _Fn_combine) const
+	{
+		std::vector<const _Node*> _Nodes;
+		for (size_t _Index = 0; _Index < _Size; ++_Index)
+		{
+			for (const _Node* _CurrentNode = _Buckets[_Index]; _CurrentNode != nullptr; _CurrentNode = _CurrentNode->_Chain)
+			{
+				_Nodes.push_back(_CurrentNode);
+			}
+		}
+
+		if (_Nodes.empty())
+		{
+			return _Fn_initialize();
+		}
+
+		typedef _Reduction_slot<_Ty> _Slot;
+		typedef std::integral_constant<bool, false> _IsNoExcept;
+
+		auto _Combine = [&_Fn_combine](const _Ty& _Left, const _Ty& _Right, int&) -> _Ty {
+			return _Fn_combine(_Left, _Right);
+		};
+
+		// The first level reads the nodes, the values are only copied for an odd node out
+		const size_t _Pairs = (_Nodes.size() + 1) / 2;
+		_Reduction_slots<_Ty> _Slots(_Pairs);
+		_Slot * const _Base = _Slots.begin();
+		auto _Combine_nodes = [&_Slots, &_Nodes, &_Fn_combine](size_t _Pair) {
+			const size_t _Left = _Pair * 2;
+			if (_Left + 1 < _Nodes.size())
+				_Slots.emplace(_Pair, _Fn_combine(_Nodes[_Left]->_Value, _Nodes[_Left + 1]->_Value));
+			else
+				_Slots.emplace(_Pair, _Nodes[_Left]->_Value);
+		};
+
+		int _Data = 0;
+		if (_Pairs < _Reduction_tree_min_pairs)
+		{
+			for (size_t _Pair = 0; _Pair < _Pairs; ++_Pair)
+				_Combine_nodes(_Pair);
+		}
+		else
+		{
+			_Partitioner<static_partitioner_tag, _IsNoExcept::value>::_For_Each(_Base, _Pairs, _Data,
+				[_Base, &_Combine_nodes](_Slot *_Begin, size_t _Pair_count, int&) {
+				for (size_t _Pair = _Begin - _Base, _End = _Pair + _Pair_count; _Pair < _End; ++_Pair)
+					_Combine_nodes(_Pair);
+			}, 1);
+		}
+
+		_Combine_slots(_Slots, _Data, _Combine, 0, _IsNoExcept());
+		return _Slots[0];
+	}
+
+	// Elements in a tile when no tile shape is given: 32KB of doubles, a tile and the rows its
+	// kernel reads around it stay in the first level caches.
+	const size_t _Default_tile_elements = 4096;
+
+	// Largest _Side with _Side to the power of _Dims not above _Budget
+	inline size_t _Tile_side(size_t _Budget, int _Dims)
+	{
+		if (_Dims == 1)
+			return _Budget;
 
-		bool is_started()
+		size_t _Side = 1;
+		for (;;)
 		{
-			return (_State.load() & _Missed) == _Started;
+			size_t _Volume = 1;
+			for (int _I = 0; _I < _Dims && _Volume <= _Budget; ++_I)
+				_Volume *= _Side + 1;
+			if (_Volume > _Budget)
+				return _Side;
+			++_Side;
 		}
+	}
 
-		void set_filtered()
-		{
-			_State.fetch_and(~_NotFiltered);
-		}
+	// Tiles per thread a small bounds is at least cut into, so the threads can balance them
+	const size_t _Tiles_per_thread = 4;
+
+	// A close to cubic tile of about _Default_tile_elements, smaller when the bounds would give
+	// too few tiles for the threads. Dimensions shorter than their share are taken whole and
+	// hand the rest of the budget to the longer ones.
+	template<int _Rank>
+	D4087::index<_Rank> _Default_tile_shape(const D4087::bounds<_Rank>& _Bnd)
+	{
+		int _Order[_Rank];
+		for (int _I = 0; _I < _Rank; ++_I)
+			_Order[_I] = _I;
+		std::sort(_Order, _Order + _Rank, [&_Bnd](int _Left, int _Right) { return _Bnd[_Left] < _Bnd[_Right]; });
+
+		D4087::index<_Rank> _Shape;
+		const size_t _Share = static_cast<size_t>(_Bnd.size()) / (get_hardware_concurrency() * _Tiles_per_thread);
+		size_t _Budget = (std::max)((std::min)(_Default_tile_elements, _Share), static_cast<size_t>(1));
+		for (int _I = 0; _I < _Rank; ++_I)
+		{
+			const int _Dim = _Order[_I];
+			const size_t _Side = (std::min)(_Tile_side(_Budget, _Rank - _I), static_cast<size_t>((std::max)(_Bnd[_Dim], ptrdiff_t(1))));
+			_Shape[_Dim] = static_cast<ptrdiff_t>(_Side);
+			_Budget = (std::max)(_Budget / _Side, static_cast<size_t>(1));
+		}
+		return _Shape;
+	}
+
+	// Splits a bounds<_Rank> into rectangular tiles of _Shape, the tiles at the far edges are cut
+	// to the bounds. The tiles are numbered in row major order, a run of tile numbers handed to
+	// a chore covers neighbouring tiles.
+	template<int _Rank>
+	class _Tiling
+	{
+		D4087::bounds<_Rank> _Extent;
+		D4087::index<_Rank> _Shape;
+		D4087::bounds<_Rank> _Grid; // tiles per dimension
 	public:
-		_Copy_chore(_It _First, size_t _S, _OutToken _Dest, const _First_stage& _St1, const _Second_stage& _St2, bool _Is_first = false) :
-			_Begin(_First), _Size(_S), _Output(_Dest), _Stage1(_St1), _Stage2(_St2), _Next_chore(nullptr), _Exception(nullptr)
+		_Tiling(const D4087::bounds<_Rank>& _Bnd, const D4087::index<_Rank>& _Tile_shape) : _Extent(_Bnd), _Shape(_Tile_shape)
 		{
-			_State = _Started | (_Is_first ? _Filtered : _NotFiltered);
+			for (int _I = 0; _I < _Rank; ++_I)
+			{
+				_ASSERTE(_Shape[_I] > 0);
+				_Grid[_I] = (_Extent[_I] + _Shape[_I] - 1) / _Shape[_I];
+			}
 		}
 
-		void set_next(_Copy_chore* _Next)
+		const D4087::bounds<_Rank>& _Tiles() const
 		{
-			_Next_chore = _Next;
+			return _Grid;
 		}
 
-		// Can be executed on the single thread only
-		_OutToken get_output_token()
+		// Calls _Func with the origin and the bounds of the tile at _Tile_idx of the grid
+		template<typename _Fn>
+		void _Apply(const D4087::index<_Rank>& _Tile_idx, _Fn& _Func) const
 		{
-			_ASSERT(_Next_chore == nullptr);
-			return _Output;
+			D4087::index<_Rank> _Origin;
+			D4087::bounds<_Rank> _Tile;
+			for (int _I = 0; _I < _Rank; ++_I)
+			{
+				_Origin[_I] = _Tile_idx[_I] * _Shape[_I];
+				_Tile[_I] = (std::min)(_Shape[_I], _Extent[_I] - _Origin[_I]);
+			}
+			_Func(_Origin, _Tile);
 		}
+	};
 
-		virtual void waitable_invoke() override
-		{
-			try {
-				if (is_started())
-					_Stage1(_Begin, _Size, _Output);
+	// The array views the algorithms take in place of a range, _enable_if_view<_View, _Ty>::type is _Ty
+	// for an array_view or a strided_array_view
+	template<typename _View, typename _Ty = void>
+	struct _enable_if_view
+	{
+	};
 
-				if (try_filter()) { // Check if the output buffer position was set
-					_Copy_chore* _Next = this;
-					do {
-						if (_Next->_Next_chore != nullptr) { // Pass the results to the next chore in chain
-							_Next->_Next_chore->_Output.move(_Next->_Output);
-							_Next->_Next_chore->set_filtered();
+	template<typename _Ty, int _Rank, typename _Ret>
+	struct _enable_if_view<D4087::array_view<_Ty, _Rank>, _Ret>
+	{
+		typedef _Ret type;
+	};
 
-							if (!_Next->_Next_chore->is_started() && _Next->_Next_chore->is_scheduled())
-								_Next->_Next_chore->reschedule();
-						}
+	template<typename _Ty, int _Rank, typename _Ret>
+	struct _enable_if_view<D4087::strided_array_view<_Ty, _Rank>, _Ret>
+	{
+		typedef _Ret type;
+	};
 
-						// If none of the element was filtered there will be no copy to the buffer
-						// Skipping the stage2 handler
-						if (!_Next->_Output.empty())
-							_Next->_Stage2(_Next->_Begin, _Next->_Size, _Next->_Output);
+	// The algorithms work on the strided form of both kinds of views
+	template<typename _Ty, int _Rank>
+	inline D4087::strided_array_view<_Ty, _Rank> _Strided_view(const D4087::array_view<_Ty, _Rank>& _View)
+	{
+		return D4087::strided_array_view<_Ty, _Rank>(_View);
+	}
 
-						_Next = _Next->_Next_chore;
+	template<typename _Ty, int _Rank>
+	inline const D4087::strided_array_view<_Ty, _Rank>& _Strided_view(const D4087::strided_array_view<_Ty, _Rank>& _View)
+	{
+		return _View;
+	}
 
-						// Pick up the work if it's not beeing executed yet
-					} while (_Next != nullptr && _Next->try_filter_missed());
-				}
-			}
-			catch (...) {
-				_Exception = std::current_exception();
-			}
-		}
+	// A view without gaps between its elements, in row major order from its first one
+	template<typename _Ty, int _Rank>
+	inline bool _Is_dense_view(const D4087::strided_array_view<_Ty, _Rank>& _View)
+	{
+		return _View.stride() == D4087::details::make_stride(_View.bounds());
+	}
 
-		template <typename _RangeCt>
-		static void wait(_RangeCt &_Range)
+	// Address of the first element of a non empty view
+	template<typename _Ty, int _Rank>
+	inline _Ty *_View_data(const D4087::strided_array_view<_Ty, _Rank>& _View)
+	{
+		return std::addressof(_View[D4087::index<_Rank>()]);
+	}
+
+	// The elements of a view from raw pointers, the rows of the innermost dimension are walked with
+	// the pointer step instead of the index math of the view
+	template<typename _Ty, int _Rank>
+	class _View_cursor
+	{
+		_Ty *_Base;
+		D4087::index<_Rank> _Stride;
+	public:
+		explicit _View_cursor(const D4087::strided_array_view<_Ty, _Rank>& _View) : _Base(_View_data(_View)), _Stride(_View.stride())
 		{
-			_Contextaware_waitable_chore::wait(_Range);
-			std::list<std::exception_ptr> _ExList;
-			for (auto &_Chore : _Range)
-			{
-				if (_Chore._Exception != nullptr)
-					_ExList.push_back(std::move(_Chore._Exception));
-			}
+		}
 
-			if (!_ExList.empty())
-				throw exception_list(std::move(_ExList));
+		_Ty *_At(const D4087::index<_Rank>& _Idx) const
+		{
+			ptrdiff_t _Offset = 0;
+			for (int _I = 0; _I < _Rank; ++_I)
+				_Offset += _Idx[_I] * _Stride[_I];
+			return _Base + _Offset;
 		}
 
-		template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
-		friend class _Remove_chore;
+		ptrdiff_t _Step() const
+		{
+			return _Stride[_Rank - 1];
+		}
 	};
 
-	template <typename _It, typename _OutToken, typename _First_stage, typename _Second_stage>
-	class __declspec(align(64)) _Remove_chore :
-		public _Copy_chore<_It, _OutToken, _First_stage, _Second_stage>
+	// Cuts the elements of a bounds in segments of the rows of its innermost dimension. A row is one
+	// segment when there are _Segments_wanted rows, the rows of a bounds with fewer rows are cut in
+	// pieces of _Min_length elements at least. The segments are numbered in row major order.
+	template<int _Rank>
+	class _View_segments
 	{
+		D4087::bounds<_Rank> _Bnd;
+		size_t _Rows;
+		size_t _Pieces; // segments per row
+		size_t _Piece_length;
 	public:
-		_Remove_chore(_It _First, size_t _S, _OutToken _Dest, const _First_stage& _St1, const _Second_stage& _St2, bool _Is_first = false) :
-			_Copy_chore(_First, _S, _Dest, _St1, _St2, _Is_first)
-		{
-		}
-
-		virtual void waitable_invoke() override
+		_View_segments(const D4087::bounds<_Rank>& _Bounds, size_t _Segments_wanted, size_t _Min_length) : _Bnd(_Bounds), _Rows(0), _Pieces(1), _Piece_length(0)
 		{
-			try {
-				if (is_started())
-					_Stage1(_Begin, _Size, _Output);
+			const size_t _Length = static_cast<size_t>(_Bnd[_Rank - 1]);
+			if (_Length == 0)
+				return;
 
-				if (try_filter()) { // Check if the output buffer position was set
-					_Copy_chore* _Next = this;
-					do {
-						// If none of the element was filtered there will be no copy to the buffer
-						// Skipping the stage2 handler
-						if (!_Next->_Output.empty())
-							_Next->_Stage2(_Next->_Begin, _Next->_Size, _Next->_Output);
+			_Rows = static_cast<size_t>(_Bnd.size()) / _Length;
+			if (_Rows == 0)
+				return;
 
-						if (_Next->_Next_chore != nullptr) { // Pass the results to the next chore in chain
-							_Next->_Next_chore->_Output.move(_Next->_Output);
-							_Next->_Next_chore->set_filtered();
-						}
+			if (_Rows < _Segments_wanted)
+				_Pieces = (std::max)((std::min)((_Segments_wanted + _Rows - 1) / _Rows, _Length / (std::max)(_Min_length, size_t(1))), size_t(1));
 
-						_Next = _Next->_Next_chore;
+			// the last piece of a row isn't empty
+			_Piece_length = (_Length + _Pieces - 1) / _Pieces;
+			_Pieces = (_Length + _Piece_length - 1) / _Piece_length;
+		}
 
-						// Pick up the work if it's not beeing executed yet
-					} while (_Next != nullptr && _Next->try_filter_missed());
-				}
-			}
-			catch (...) {
-				_Exception = std::current_exception();
-			}
+		size_t _Count() const
+		{
+			return _Rows * _Pieces;
 		}
-	};
-#pragma warning(pop) // C4324
 
-	template<>
-	struct _Partitioner<copy_partitioner_tag>
-	{
-	protected:
-		template<typename _ChoreType, typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
-		static _OutToken _For_Each_impl(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		// Calls _Func with the origin and the length of the segments from _First to _First + _Count. The
+		// origin of the first one is found once, the next ones are carried from it.
+		template<typename _Fn>
+		void _Apply(size_t _First, size_t _Count, _Fn& _Func) const
 		{
-			_ChoreType* _Prev_chore = nullptr;
+			if (_Count == 0)
+				return;
 
-			if (_Chunk_size == 0) {
-				const unsigned int _HdConc = get_hardware_concurrency();
-				_Chunk_size = (_Count + _HdConc - 1) / _HdConc;
+			D4087::index<_Rank> _Origin;
+			size_t _Row = _First / _Pieces;
+			size_t _Piece = _First % _Pieces;
+			for (int _Dim = _Rank - 1; _Dim-- > 0;) {
+				_Origin[_Dim] = static_cast<ptrdiff_t>(_Row % static_cast<size_t>(_Bnd[_Dim]));
+				_Row /= static_cast<size_t>(_Bnd[_Dim]);
 			}
 
-			std::list<_ChoreType> _Chores;
-
-			while (_Count > _Chunk_size) {
-				if (!_Chores.empty())
-					_Prev_chore = &_Chores.back();
+			const size_t _Length = static_cast<size_t>(_Bnd[_Rank - 1]);
+			for (;;) {
+				const size_t _Column = _Piece * _Piece_length;
+				_Origin[_Rank - 1] = static_cast<ptrdiff_t>(_Column);
+				_Func(static_cast<const D4087::index<_Rank>&>(_Origin), (std::min)(_Piece_length, _Length - _Column));
 
-				_Chores.emplace_back(_First, _Chunk_size, _Dest, _Stage1, _Stage2, _Prev_chore == nullptr);
+				if (--_Count == 0)
+					return;
 
-				if (_Prev_chore != nullptr) {
-					auto _Current = &_Chores.back();
-					_Prev_chore->set_next(_Current);
-					schedule_chore(_Prev_chore);
+				if (++_Piece == _Pieces) {
+					_Piece = 0;
+					for (int _Dim = _Rank - 1; _Dim-- > 0;) {
+						if (++_Origin[_Dim] < _Bnd[_Dim])
+							break;
+						_Origin[_Dim] = 0;
+					}
 				}
-
-				_Count -= _Chunk_size;
-				std::advance(_First, _Chunk_size);
 			}
+		}
+	};
 
-			if (!_Chores.empty())
-				_Prev_chore = &_Chores.back();
+	// A sequential run walks the view row by row
+	template<int _Rank>
+	inline _View_segments<_Rank> _Make_view_segments(const sequential_execution_policy&, const D4087::bounds<_Rank>& _Bnd)
+	{
+		return _View_segments<_Rank>(_Bnd, 1, 1);
+	}
 
-			_Chores.emplace_back(_First, _Count, _Dest, _Stage1, _Stage2, _Prev_chore == nullptr);
+	// Enough segments for the threads to balance them, the long rows of a short view are cut at the grain
+	template<typename _ExPolicy, int _Rank>
+	inline _View_segments<_Rank> _Make_view_segments(const _ExPolicy& _Policy, const D4087::bounds<_Rank>& _Bnd)
+	{
+		return _View_segments<_Rank>(_Bnd, _Policy_thread_count(_Policy) * _Tiles_per_thread, _Grain_size(_Policy, _Default_tile_elements));
+	}
 
-			if (_Prev_chore != nullptr) {
-				_Prev_chore->set_next(&_Chores.back());
-				schedule_chore(_Prev_chore);
-			}
+	// Calls _Func(first segment, count, data) with chunks of the _Count segments of a view
+	template<typename _ExPolicy, typename _UserData, typename _Callback>
+	inline void _Partitioned_for_each_segment(const _ExPolicy& _Policy, size_t _Count, _UserData _Data, const _Callback& _Func)
+	{
+		if (_Count == 0)
+			return;
 
-			_Prev_chore = &_Chores.back();
-			_Prev_chore->waitable_invoke();
-			_ChoreType::wait(_Chores);
+		const D4087::bounds<1> _Numbers{ static_cast<ptrdiff_t>(_Count) };
+		_Partitioned_for_each(_Policy, std::begin(_Numbers), _Count, std::move(_Data), [&_Func](D4087::bounds_iterator<1> _Begin, size_t _Chunk_count, _UserData& _Local) {
+			_Func(static_cast<size_t>((*_Begin)[0]), _Chunk_count, _Local);
+		});
+	}
 
-			return _Prev_chore->get_output_token();
-		}
+	// Elements an early exit loop runs between two polls of its cancellation token: about 1KB
+	// of data and at least 16 elements. Polling the shared flag after every element costs a load
+	// per iteration and keeps the compiler from unrolling the loop.
+	template<typename _Ty>
+	struct _Cancellation_poll_interval : std::integral_constant<size_t, (sizeof(_Ty) >= 64 ? 16 : 1024 / sizeof(_Ty))>
+	{
+	};
+
+	// Counts down the elements a hand written early exit loop runs, due() is true once per
+	// _Cancellation_poll_interval calls, when the loop should poll its token
+	template<typename _It>
+	class _Cancellation_poll
+	{
+		size_t _Left;
 
 	public:
-		template<typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
-		static _OutToken _For_Each(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		_Cancellation_poll() throw() : _Left(_Cancellation_poll_interval<typename std::iterator_traits<_It>::value_type>::value)
 		{
-			typedef _Copy_chore<_FwdIt, _OutToken, _First_stage, _Second_stage> _ChoreType;
-
-			return _For_Each_impl<_ChoreType>(_First, _Count, _Dest, _Stage1, _Stage2, _Chunk_size);
 		}
-	};
 
-	template<bool _IsNoExcept>
-	struct _Partitioner<remove_partitioner_tag, _IsNoExcept> :
-		public _Partitioner<copy_partitioner_tag, _IsNoExcept>
-	{
-		template<typename _FwdIt, typename _OutToken, typename _First_stage, typename _Second_stage>
-		static _OutToken _For_Each(_FwdIt _First, size_t _Count, _OutToken _Dest, const _First_stage& _Stage1, const _Second_stage& _Stage2, size_t _Chunk_size = 0)
+		bool due() throw()
 		{
-			typedef _Remove_chore<_FwdIt, _OutToken, _First_stage, _Second_stage> _ChoreType;
+			if (--_Left != 0)
+				return false;
 
-			return _For_Each_impl<_ChoreType>(_First, _Count, _Dest, _Stage1, _Stage2, _Chunk_size);
+			_Left = _Cancellation_poll_interval<typename std::iterator_traits<_It>::value_type>::value;
+			return true;
 		}
 	};
 
-	// The implementation of dynamic partitioner is broken thus commented out
-	/*
-	template<>
-	struct _Partitioner<dynamic_partitioner_tag>
-	{
-	template<typename _FwdIt, typename _Fn>
-	static _FwdIt _For_Each(_FwdIt _First, size_t _Count, const _Fn& _Func, size_t _Trunk_size)
+	// Position of the first of the _Count elements from _First satisfying _Pred, _Count if none
+	// does. _First is left on that element. The loop does not poll, callers bound _Count by the
+	// poll interval.
+	template<typename _It, typename _Pr, typename _IterCat>
+	inline size_t _Find_if_block(_It& _First, size_t _Count, _Pr& _Pred, _IterCat)
 	{
-	typedef _Semi_splitable_chore<_FwdIt, _Fn> _ChoreType;
-
-	const unsigned int _HdConc = get_hardware_concurrency();
-
-	std::vector<_ChoreType> _Chores;
-	_Chores.reserve(_HdConc);
-
-	if (_Trunk_size == 0)
-	_Trunk_size = 1;
+		size_t _I = 0;
+		for (; _I < _Count; ++_I, ++_First) {
+			if (_Pred(*_First))
+				break;
+		}
 
-	size_t _Big_chunk_size = (_Count + _HdConc - 1) / _HdConc;
+		return _I;
+	}
 
-	while (_Count > _Big_chunk_size)
+	// Unrolled by four, a group is tested without a branch per element and rescanned on a hit
+	template<typename _It, typename _Pr>
+	inline size_t _Find_if_block(_It& _First, size_t _Count, _Pr& _Pred, std::random_access_iterator_tag)
 	{
-	_Chores.emplace_back(_First, _Big_chunk_size, _Func, _Trunk_size);
-	schedule_chore(&_Chores.back());
-	_Count -= _Big_chunk_size;
-	std::advance(_First, _Big_chunk_size);
-	}
+		const size_t _Unrolled = _Count & ~size_t{ 3 };
+		size_t _I = 0;
 
-	_Chores.emplace_back(_First, _Count, _Func, _Trunk_size);
-	schedule_chore(&_Chores.back());
+		for (; _I < _Unrolled; _I += 4) {
+			if (!!_Pred(_First[_I]) | !!_Pred(_First[_I + 1]) | !!_Pred(_First[_I + 2]) | !!_Pred(_First[_I + 3]))
+				break;
+		}
 
-	_ChoreType::wait(_Chores);
+		for (; _I < _Count; ++_I) {
+			if (_Pred(_First[_I]))
+				break;
+		}
 
-	std::advance(_First, _Count);
-	return _First;
+		std::advance(_First, _I);
+		return _I;
 	}
-	};
-	*/
-
-	// parallel_execution_policy defaults to self guided partitioner
-	template<bool _IsNoExcept>
-	struct _Partitioner<parallel_execution_policy, _IsNoExcept> :
-		public _Partitioner<auto_partitioner_tag, _IsNoExcept>
-	{
-	};
-
-	// parallel_vector_execution_policy defaults to self guided partitioner
-	template<bool _IsNoExcept>
-	struct _Partitioner<parallel_vector_execution_policy, _IsNoExcept> :
-		public _Partitioner<auto_partitioner_tag, _IsNoExcept>
-	{
-	};
 
 	// Abstracting loop helpers
 	template <typename _ExPolicy, typename _It, typename _IterCat = typename std::iterator_traits<_It>::iterator_category>
@@ -1516,19 +3674,27 @@ namespace details {
 			return _It;
 		}
 
+		// The token is polled once per _Cancellation_poll_interval elements, the loop stops at
+		// the end of the block in which it sees the token cancelled
 		template<typename _Fn, typename _CancellationToken>
-		static _It Loop(_It _It, size_t _Count, const _Fn& _Func, const _CancellationToken& _Token)
+		static _It Loop(_It _First, size_t _Count, const _Fn& _Func, const _CancellationToken& _Token)
 		{
-			for (; 0 < _Count; --_Count) {
-				_Func(*_It);
+			const size_t _Interval = _Cancellation_poll_interval<typename std::iterator_traits<_It>::value_type>::value;
 
-				if (_Token.is_cancelled())
-					return _It;
+			while (0 < _Count) {
+				size_t _Block = (std::min)(_Count, _Interval);
+				_Count -= _Block;
 
-				++_It;
+				for (; 0 < _Block; --_Block) {
+					_Func(*_First);
+					++_First;
+				}
+
+				if (_Token.is_cancelled())
+					break;
 			}
 
-			return _It;
+			return _First;
 		}
 	};
 
@@ -1546,32 +3712,64 @@ namespace details {
 		}
 
 		template<typename _Fn, typename _CancellationToken>
-		static _It Loop(_It _It, size_t _Count, const _Fn& _Func, const _CancellationToken& _Token)
+		static _It Loop(_It _First, size_t _Count, const _Fn& _Func, const _CancellationToken& _Token)
 		{
+			const size_t _Interval = _Cancellation_poll_interval<typename std::iterator_traits<_It>::value_type>::value;
 			size_t _I = 0;
 
-			for (; _I < _Count; ++_I) {
-				_Func(_It[_I]);
+			while (_I < _Count) {
+				const size_t _Block_end = _I + (std::min)(_Count - _I, _Interval);
 
-				if (_Token.is_cancelled())	{
-					std::advance(_It, _I);
-					return _It;
-				}
+				for (; _I < _Block_end; ++_I)
+					_Func(_First[_I]);
+
+				if (_Token.is_cancelled())
+					break;
 			}
 
-			std::advance(_It, _I);
-			return _It;
+			std::advance(_First, _I);
+			return _First;
 		}
 	};
 
-	// Contiguous Container Iterator Traits
-	// Please note, it will NOT identify all contiguous iterators. It only tries its best.
-	template <typename _ItrType>
-	struct _Contiguous_container_iterator_traits : std::integral_constant<bool,
-		std::is_convertible<_ItrType, typename std::vector<typename std::iterator_traits<_ItrType>::value_type>::const_iterator>::value
-		|| std::is_convertible<_ItrType, typename std::string::const_iterator>::value
-		|| std::is_convertible<_ItrType, typename std::wstring::const_iterator>::value>
-	{};
+	// pragma par_vec: contiguous ranges run through a raw pointer, and the loops carry no
+	// dependences the vectorizer has to prove absent. Loops polling a cancellation token exit
+	// early and stay scalar.
+	template <typename _It>
+	struct LoopHelper<parallel_vector_execution_policy, _It, std::random_access_iterator_tag> :
+		public LoopHelper<parallel_execution_policy, _It, std::random_access_iterator_tag>
+	{
+		using LoopHelper<parallel_execution_policy, _It, std::random_access_iterator_tag>::Loop;
+
+		template<typename _Fn>
+		static _It Loop(_It _First, size_t _Count, const _Fn& _Func)
+		{
+			_Vec_loop(_First, _Count, _Func, _Contiguous_container_iterator_traits<_It>());
+			std::advance(_First, _Count);
+			return _First;
+		}
+
+	private:
+		template<typename _Fn>
+		static void _Vec_loop(const _It& _First, size_t _Count, const _Fn& _Func, std::true_type)
+		{
+			if (_Count == 0)
+				return;
+
+			typename std::iterator_traits<_It>::pointer _EXP_RESTRICT _FirstP = _Unwrap_contiguous(_First);
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_Func(_FirstP[_I]);
+		}
+
+		template<typename _Fn>
+		static void _Vec_loop(const _It& _First, size_t _Count, const _Fn& _Func, std::false_type)
+		{
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_Func(_First[_I]);
+		}
+	};
 
 	//  cancellation tokens
 	class cancellation_token
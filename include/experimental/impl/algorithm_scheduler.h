@@ -4,6 +4,7 @@
 #define _ALGORITHM_SCHEDULER_H_
 
 #include "defines.h"
+#include <new>
 #include <thread>
 
 _PSTL_NS1_BEGIN
@@ -37,20 +38,259 @@ namespace details {
 		virtual void __cdecl invoke() = 0;
 	};
 
+	_EXP_IMPL unsigned int __cdecl _Concurrency_limit() _NOEXCEPT;
+
+	// The threads the algorithms are carved for, the limit of set_concurrency_limit if one is set or the
+	// concurrency of the task_arena the calling thread runs in if lower
 	inline unsigned int get_hardware_concurrency()
 	{
+		const unsigned int _Limit = _Concurrency_limit();
+		if (_Limit != 0)
+			return _Limit;
+
 		unsigned int _Res = std::thread::hardware_concurrency();
 		return _Res == 0 ? 1 : _Res;
 	}
 
 	_EXP_IMPL void __cdecl yield();
 
+	// Internal notifications around blocking waits of the runtime (see Event::wait),
+	// the worker pool backend uses them to keep enough runnable threads.
+	void __cdecl _Scheduler_block_begin();
+	void __cdecl _Scheduler_block_end();
+
+	// The backend's side of prewarm and shutdown: starts pool threads ahead of the first chores, and lets
+	// the idle ones exit. No-ops on the system threadpools, which own their threads.
+	void __cdecl _Scheduler_prewarm(unsigned int _Threads);
+	void __cdecl _Scheduler_shutdown();
+
 	_EXP_IMPL void __cdecl schedule_chore(_Threadpool_chore*);
 
 	_EXP_IMPL unsigned int __cdecl get_current_thread_id();
 
+	class WorkArena;
+	class WorkStealingQueue;
+
+	// The arena and the queue of a thread before it entered another arena
+	struct _Arena_frame
+	{
+		WorkArena *_Arena;
+		WorkStealingQueue *_Queue;
+	};
+
+	// Returns nullptr when out of memory, 0 threads stand for the hardware concurrency
+	_EXP_IMPL WorkArena * __cdecl create_arena(unsigned int _Max_concurrency);
+
+	// Waits for the workers of the arena to retire, no thread may be in it
+	_EXP_IMPL void __cdecl destroy_arena(WorkArena *_Arena);
+
+	_EXP_IMPL unsigned int __cdecl arena_concurrency(const WorkArena *_Arena);
+
+	// Moves the calling thread into the arena, returns false if it already runs in it
+	_EXP_IMPL bool __cdecl enter_arena(WorkArena *_Arena, _Arena_frame &_Frame);
+
+	// Moves the calling thread back to the arena it was in before enter_arena
+	_EXP_IMPL void __cdecl leave_arena(const _Arena_frame &_Frame);
+
+	// Runs the calling thread in an arena for the lifetime of the scope, nullptr leaves it where it is
+	class _Arena_scope
+	{
+		_Arena_frame _Frame;
+		bool _Entered;
+
+		_Arena_scope(const _Arena_scope&);
+		_Arena_scope& operator=(const _Arena_scope&);
+	public:
+		explicit _Arena_scope(WorkArena *_Arena) : _Entered(_Arena != nullptr && enter_arena(_Arena, _Frame))
+		{
+		}
+
+		~_Arena_scope()
+		{
+			if (_Entered)
+				leave_arena(_Frame);
+		}
+	};
+
+	// The lanes of the work-stealing queues, one per priority class. The high lane is popped and stolen from first.
+	const unsigned int _Normal_lane = 0;
+	const unsigned int _High_lane = 1;
+	const unsigned int _Lane_count = 2;
+
+	// The lane of the chores the calling thread schedules, the lane of the chore it runs. Returns the previous one.
+	_EXP_IMPL unsigned int __cdecl _Exchange_thread_lane(unsigned int _Lane) _NOEXCEPT;
+
+	// Runs the high priority chores waiting in the arena of the calling thread, if it runs a normal one.
+	// Called between two chunks of a loop, returns false if there was nothing to run.
+	_EXP_IMPL bool __cdecl _Yield_to_high_lane();
+
+	// True if a loop of _Threads threads runs on cores of different speeds, see get_core_topology
+	_EXP_IMPL bool __cdecl _Hybrid_topology(unsigned int _Threads) _NOEXCEPT;
+
+	// The speed, in percent of a performance core, of the logical processor of a rank, fastest first, while a
+	// loop keeps the first _Threads of them busy
+	_EXP_IMPL unsigned int __cdecl _Thread_weight(unsigned int _Rank, unsigned int _Threads) _NOEXCEPT;
+
+	// The worker pool's side of the topology: the workers of the efficiency cores let the others steal first,
+	// and a worker pins itself to the processor of its rank again whenever the generation changed
+	bool __cdecl _On_efficiency_core();
+	unsigned int __cdecl _Worker_pinning_generation();
+	unsigned int __cdecl _Apply_worker_pinning(unsigned int _Rank);
+
+	// The chore arena and the scratch cache of the calling thread, allocated ahead of its first algorithm
+	// call by prewarm and released by shutdown while unused
+	void __cdecl _Prewarm_thread_storage();
+	void __cdecl _Release_thread_storage();
 }
-_PSTL_NS1_END // std::experimental::parallel::details
+
+/// <summary>
+///     A concurrency arena: the algorithms called in execute, or with the arena execution parameter, run their chores
+///     on at most max_concurrency pool threads of their own and split their loops for as many threads. The workers of
+///     an arena steal from its queues only, a batch of work in one arena neither delays the algorithms of another nor
+///     takes its threads.
+/// </summary>
+/// <remarks>
+///     The threads calling into the arena run chores too, on top of its workers. The arena must outlive the calls
+///     made in it, its destructor waits for its idle workers to retire.
+/// </remarks>
+class task_arena
+{
+	details::WorkArena *_Arena;
+
+	task_arena(const task_arena&);
+	task_arena& operator=(const task_arena&);
+public:
+	/// <summary>
+	///     Constructs an arena of _Max_concurrency threads, 0 for the hardware concurrency.
+	/// </summary>
+	explicit task_arena(unsigned int _Max_concurrency) : _Arena(details::create_arena(_Max_concurrency))
+	{
+		if (_Arena == nullptr)
+			throw std::bad_alloc();
+	}
+
+	~task_arena()
+	{
+		details::destroy_arena(_Arena);
+	}
+
+	/// <summary>
+	///     Returns the number of threads the arena runs its chores on at most.
+	/// </summary>
+	unsigned int max_concurrency() const _NOEXCEPT
+	{
+		return details::arena_concurrency(_Arena);
+	}
+
+	/// <summary>
+	///     Runs _Func on the calling thread in the arena and returns its result.
+	/// </summary>
+	template<typename _Fn>
+	auto execute(_Fn&& _Func) -> decltype(_Func())
+	{
+		details::_Arena_scope _Scope(_Arena);
+		return _Func();
+	}
+
+	details::WorkArena *_Get() const _NOEXCEPT
+	{
+		return _Arena;
+	}
+};
+
+/// <summary>
+///     The logical processors of the machine by the efficiency class of their core, see get_core_topology.
+/// </summary>
+struct core_topology
+{
+	unsigned int efficiency_classes; // 1 on a machine of uniform cores
+	unsigned int performance_threads; // logical processors of the cores of the highest class
+	unsigned int efficiency_threads; // logical processors of the other cores
+	unsigned int efficiency_speed_percent; // see set_efficiency_core_speed
+	bool workers_pinned; // see set_worker_pinning
+};
+
+/// <summary>
+///     Fills the topology of the machine, detected once when the library is loaded.
+/// </summary>
+/// <remarks>
+///     On a hybrid machine the static partitioner weighs its chunks by the speed of the threads of the loop, the
+///     fastest ones taken first, and queues the largest chunks first. The workers of the efficiency cores let the
+///     ones of the performance cores steal first, so the split chunks of the other partitioners go to the fast cores.
+/// </remarks>
+_EXP_IMPL void __cdecl get_core_topology(core_topology& _Info) _NOEXCEPT;
+
+/// <summary>
+///     Sets the speed of an efficiency core against a performance core the static partitioner weighs by, in percent,
+///     0 for the default of 60. 100 splits the loops evenly. Returns the previous speed.
+/// </summary>
+_EXP_IMPL unsigned int __cdecl set_efficiency_core_speed(unsigned int _Percent) _NOEXCEPT;
+
+/// <summary>
+///     Pins each worker of the pool to a logical processor, the performance cores first, or lets them float again.
+///     The workers apply it when they take their next chore. Returns the previous setting.
+/// </summary>
+/// <remarks>
+///     The pool of the library only, the Win32 threadpool backend leaves its threads alone. Pinning keeps the caches
+///     of a worker warm and its timings steady on a dedicated machine, but a pinned worker can't move off a processor
+///     another process keeps busy.
+/// </remarks>
+_EXP_IMPL bool __cdecl set_worker_pinning(bool _Pinned) _NOEXCEPT;
+
+/// <summary>
+///     Pins the work-stealing runtime to _Threads workers, 0 lifts the limit. The partitioners carve the loops for
+///     _Threads threads and at most _Threads pool threads run chores, the threads that wait for an algorithm help
+///     on top of them. Returns the previous limit.
+/// </summary>
+/// <remarks>
+///     Meant for measuring how the algorithms scale, the default is the hardware concurrency and twice as many pool
+///     threads to make up for the blocked ones. The pool threads past a new limit retire once they run out of
+///     chores, change it between algorithm calls.
+/// </remarks>
+_EXP_IMPL unsigned int __cdecl set_concurrency_limit(unsigned int _Threads) _NOEXCEPT;
+
+/// <summary>
+///     Returns the limit of set_concurrency_limit, 0 if none is set.
+/// </summary>
+_EXP_IMPL unsigned int __cdecl concurrency_limit() _NOEXCEPT;
+
+/// <summary>
+///     Brings up _Workers workers of the arena the calling thread runs in, 0 for the hardware concurrency, ahead of the
+///     first algorithm call: the pool threads are started, the workers allocate their queues, chore arenas and scratch
+///     caches and park. Returns the workers the arena has.
+/// </summary>
+/// <remarks>
+///     The first parallel call of a process otherwise pays for all of them. The prewarmed workers stay parked past the
+///     idle timeout until shutdown, or until the task_arena they belong to is destroyed. At most the concurrency of the
+///     arena are started.
+/// </remarks>
+_EXP_IMPL unsigned int __cdecl prewarm(unsigned int _Workers) _NOEXCEPT;
+
+/// <summary>
+///     Retires the workers of the default arena, frees its idle queues and the storage of the calling thread, and
+///     lets the idle pool threads exit. The next algorithm call starts over as in a new process.
+/// </summary>
+/// <remarks>
+///     No algorithm may run in the default arena meanwhile, and it must not be called from a chore.
+/// </remarks>
+_EXP_IMPL void __cdecl shutdown() _NOEXCEPT;
+
+/// <summary>
+///     Sets how long, in microseconds, a worker out of chores keeps looking for more before it parks, 0 parks it at
+///     once. Returns the previous budget, 50 by default.
+/// </summary>
+/// <remarks>
+///     A parked worker sleeps on the arena until chores are pushed and retires after two seconds without any. A
+///     larger budget lowers the latency of the next algorithm call at the cost of spinning cores, a smaller one saves
+///     power between sparse calls.
+/// </remarks>
+_EXP_IMPL unsigned int __cdecl set_worker_spin_budget(unsigned int _Microseconds) _NOEXCEPT;
+
+/// <summary>
+///     Returns the spin budget of set_worker_spin_budget, in microseconds.
+/// </summary>
+_EXP_IMPL unsigned int __cdecl worker_spin_budget() _NOEXCEPT;
+_PSTL_NS1_END // std::experimental::parallel
 
 #endif // _ALGORITHM_SCHEDULER_H_
 
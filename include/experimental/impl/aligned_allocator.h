@@ -0,0 +1,87 @@
+#pragma once
+
+#ifndef _IMPL_ALIGNED_ALLOCATOR_H_
+#define _IMPL_ALIGNED_ALLOCATOR_H_ 1
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <malloc.h>
+#include <new>
+#include <type_traits>
+#include "defines.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     Allocates the elements at addresses multiple of _Alignment bytes, e.g. the storage of a
+///     std::vector the aligned_array_view of its elements is made of.
+/// </summary>
+template<class _Ty, size_t _Alignment = 64>
+class aligned_allocator
+{
+	static_assert(_Alignment != 0 && (_Alignment & (_Alignment - 1)) == 0, "Required an alignment that is a power of two.");
+	static_assert(_Alignment >= std::alignment_of<_Ty>::value, "Required an alignment not below the one of the elements.");
+
+public:
+	typedef _Ty value_type;
+	typedef _Ty *pointer;
+	typedef const _Ty *const_pointer;
+	typedef _Ty& reference;
+	typedef const _Ty& const_reference;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+
+	static const size_t alignment = _Alignment;
+
+	template<class _Other>
+	struct rebind
+	{
+		typedef aligned_allocator<_Other, _Alignment> other;
+	};
+
+	aligned_allocator() _NOEXCEPT
+	{
+	}
+
+	template<class _Other>
+	aligned_allocator(const aligned_allocator<_Other, _Alignment>&) _NOEXCEPT
+	{
+	}
+
+	pointer allocate(size_type _Count)
+	{
+		if (_Count > max_size())
+			throw std::bad_alloc();
+
+		void *_Ptr = _aligned_malloc((std::max)(_Count * sizeof(_Ty), static_cast<size_t>(1)), _Alignment);
+		if (_Ptr == nullptr)
+			throw std::bad_alloc();
+		return static_cast<pointer>(_Ptr);
+	}
+
+	void deallocate(pointer _Ptr, size_type) _NOEXCEPT
+	{
+		_aligned_free(_Ptr);
+	}
+
+	size_type max_size() const _NOEXCEPT
+	{
+		return (std::numeric_limits<size_type>::max)() / sizeof(_Ty);
+	}
+};
+
+template<class _Ty, class _Other, size_t _Alignment>
+inline bool operator==(const aligned_allocator<_Ty, _Alignment>&, const aligned_allocator<_Other, _Alignment>&) _NOEXCEPT
+{
+	return true;
+}
+
+template<class _Ty, class _Other, size_t _Alignment>
+inline bool operator!=(const aligned_allocator<_Ty, _Alignment>&, const aligned_allocator<_Other, _Alignment>&) _NOEXCEPT
+{
+	return false;
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_ALIGNED_ALLOCATOR_H_
@@ -0,0 +1,338 @@
+#pragma once
+
+#ifndef _IMPL_ALIGNED_VIEW_H_
+#define _IMPL_ALIGNED_VIEW_H_ 1
+
+#include <cstdint>
+#include <type_traits>
+#include "algorithm_impl.h"
+#include "aligned_allocator.h"
+
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     A strided_array_view whose rows start at addresses multiple of _Alignment bytes. The rows are
+///     pitch() elements apart, the pitch pads a row up to the next multiple of the alignment unless
+///     another one is given. The algorithms that know the alignment at compile time load and store
+///     the rows in aligned blocks.
+/// </summary>
+template<class _Ty, int _Rank = 2, size_t _Alignment = 64>
+class aligned_array_view : public D4087::strided_array_view<_Ty, _Rank>
+{
+	typedef D4087::strided_array_view<_Ty, _Rank> _Base;
+	static_assert(_Alignment != 0 && (_Alignment & (_Alignment - 1)) == 0, "Required an alignment that is a power of two.");
+	static_assert(_Alignment % sizeof(_Ty) == 0, "Required an alignment holding whole elements.");
+
+	_Ty *_Rows;
+	ptrdiff_t _Pitch;
+
+	// The rows are laid one pitch apart whatever the rank, the dimensions above the rows multiply it
+	static D4087::index<_Rank> _Strides(const D4087::bounds<_Rank>& _Bnd, ptrdiff_t _Row_pitch)
+	{
+		D4087::index<_Rank> _Stride;
+		ptrdiff_t _Step = 1;
+		for (int _I = _Rank - 1; _I >= 0; --_I)
+		{
+			_Stride[_I] = _Step;
+			_Step *= _I == _Rank - 1 ? _Row_pitch : _Bnd[_I];
+		}
+		return _Stride;
+	}
+
+	static ptrdiff_t _Row_count(const D4087::bounds<_Rank>& _Bnd)
+	{
+		return _Bnd[_Rank - 1] == 0 ? 0 : _Bnd.size() / _Bnd[_Rank - 1];
+	}
+
+	static bool _Is_aligned(const void *_Ptr)
+	{
+		return reinterpret_cast<std::uintptr_t>(_Ptr) % _Alignment == 0;
+	}
+
+public:
+	typedef _Ty *pointer;
+
+	static const size_t alignment = _Alignment;
+
+	/// <summary>
+	///     The shortest pitch from _Cols elements on that keeps every row aligned.
+	/// </summary>
+	static ptrdiff_t padded_pitch(ptrdiff_t _Cols)
+	{
+		const ptrdiff_t _Per_block = static_cast<ptrdiff_t>(_Alignment / sizeof(_Ty));
+		return (_Cols + _Per_block - 1) / _Per_block * _Per_block;
+	}
+
+	/// <summary>
+	///     The number of elements the storage of a view of _Bnd with the padded pitch holds.
+	/// </summary>
+	static size_t required_size(const D4087::bounds<_Rank>& _Bnd)
+	{
+		return static_cast<size_t>(_Row_count(_Bnd) * padded_pitch(_Bnd[_Rank - 1]));
+	}
+
+	aligned_array_view() : _Rows(nullptr), _Pitch(0)
+	{
+	}
+
+	// Preconditions: _Data is aligned and holds required_size(_Bnd) elements
+	aligned_array_view(const D4087::bounds<_Rank>& _Bnd, pointer _Data)
+		: _Base(_Bnd, _Strides(_Bnd, padded_pitch(_Bnd[_Rank - 1])), _Data), _Rows(_Data), _Pitch(padded_pitch(_Bnd[_Rank - 1]))
+	{
+		_ASSERTE(_Is_aligned(_Data));
+	}
+
+	// Preconditions: _Data is aligned, _Row_pitch elements hold a row and keep the next one aligned
+	aligned_array_view(const D4087::bounds<_Rank>& _Bnd, ptrdiff_t _Row_pitch, pointer _Data)
+		: _Base(_Bnd, _Strides(_Bnd, _Row_pitch), _Data), _Rows(_Data), _Pitch(_Row_pitch)
+	{
+		_ASSERTE(_Is_aligned(_Data) && _Row_pitch >= _Bnd[_Rank - 1]);
+		_ASSERTE(_Rank == 1 || (_Row_pitch * sizeof(_Ty)) % _Alignment == 0);
+	}
+
+	// Preconditions: the storage is aligned, e.g. by aligned_allocator, and holds required_size(_Bnd) elements
+	template<class _Container, class = typename std::enable_if<std::is_convertible<decltype(std::declval<_Container&>().data()), pointer>::value>::type>
+	aligned_array_view(const D4087::bounds<_Rank>& _Bnd, _Container& _Storage)
+		: aligned_array_view(_Bnd, _Storage.data())
+	{
+		_ASSERTE(required_size(_Bnd) <= static_cast<size_t>(_Storage.size()));
+	}
+
+	ptrdiff_t pitch() const
+	{
+		return _Pitch;
+	}
+
+	/// <summary>
+	///     The number of rows, the elements of the last dimension of the bounds are a row.
+	/// </summary>
+	ptrdiff_t rows() const
+	{
+		return _Row_count(_Base::bounds());
+	}
+
+	/// <summary>
+	///     The first element of the row _Row, counting the rows of every dimension above the last one in row major order.
+	/// </summary>
+	pointer row(ptrdiff_t _Row) const
+	{
+		return _Rows + _Row * _Pitch;
+	}
+};
+
+namespace details {
+
+	// The view algorithms take the aligned views as the strided_array_views they are
+	template<typename _Ty, int _Rank, size_t _Alignment, typename _Ret>
+	struct _enable_if_view<aligned_array_view<_Ty, _Rank, _Alignment>, _Ret>
+	{
+		typedef _Ret type;
+	};
+
+	// The alignment of the rows of a view known at compile time
+	template<typename _View>
+	struct _View_alignment : std::integral_constant<size_t, std::alignment_of<typename _View::value_type>::value>
+	{
+	};
+
+	template<typename _Ty, int _Rank, size_t _Alignment>
+	struct _View_alignment<aligned_array_view<_Ty, _Rank, _Alignment>> : std::integral_constant<size_t, _Alignment>
+	{
+	};
+
+	// Rows of elements that 16 byte blocks hold whole, written by aligned block stores
+	template<typename _Ty, size_t _Alignment>
+	struct _Is_aligned_block_row : std::integral_constant<bool, _EXP_SSE2 != 0 && _Alignment % 16 == 0
+		&& std::is_trivially_copyable<_Ty>::value && 16 % sizeof(_Ty) == 0>
+	{
+	};
+
+	// The index of the first element of the row _Row of _Bnd
+	template<int _Rank>
+	inline D4087::index<_Rank> _Row_origin(const D4087::bounds<_Rank>& _Bnd, ptrdiff_t _Row)
+	{
+		D4087::index<_Rank> _Origin;
+		for (int _I = _Rank - 2; _I >= 0; --_I)
+		{
+			_Origin[_I] = _Row % _Bnd[_I];
+			_Row /= _Bnd[_I];
+		}
+		return _Origin;
+	}
+
+	//
+	// Row loops over an aligned view, a chore takes whole rows so every run it writes starts aligned
+	//
+	template<class _Fn>
+	inline void _Aligned_rows_impl(const sequential_execution_policy&, size_t _Rows, _Fn _Func)
+	{
+		_EXP_TRY
+			_Func(0, _Rows);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _Fn>
+	inline void _Aligned_rows_impl(const _ExPolicy& _Policy, size_t _Rows, _Fn _Func)
+	{
+		_Partitioned_for_each_segment(_Policy, _Rows, _Func, [](size_t _First, size_t _Count, _Fn& _Row_func) {
+			_Row_func(_First, _Count);
+		});
+	}
+
+	template<class _Fn>
+	inline void _Aligned_rows_impl(const execution_policy& _Policy, size_t _Rows, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Aligned_rows_impl, _Policy, _Rows, _Func);
+	}
+
+#if _EXP_SSE2
+	inline __m128i _Load_block(const void *_Src, std::true_type)
+	{
+		return _mm_load_si128(static_cast<const __m128i *>(_Src));
+	}
+
+	inline __m128i _Load_block(const void *_Src, std::false_type)
+	{
+		return _mm_loadu_si128(static_cast<const __m128i *>(_Src));
+	}
+#endif
+
+	template<typename _Ty>
+	inline void _Fill_aligned_row(_Ty *_Row, size_t _Count, const _Ty& _Val, std::true_type)
+	{
+#if _EXP_SSE2
+		const size_t _Per_block = 16 / sizeof(_Ty);
+		_Ty _Pattern[16 / sizeof(_Ty)];
+		std::fill(_Pattern, _Pattern + _Per_block, _Val);
+		const __m128i _Block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Pattern));
+
+		size_t _I = 0;
+		for (; _I + _Per_block <= _Count; _I += _Per_block)
+			_mm_store_si128(reinterpret_cast<__m128i *>(_Row + _I), _Block);
+		std::fill(_Row + _I, _Row + _Count, _Val);
+#else
+		std::fill_n(_Row, _Count, _Val);
+#endif
+	}
+
+	// _Src_aligned tells whether the source rows start aligned too
+	template<typename _InTy, typename _OutTy, bool _Src_aligned>
+	inline void _Copy_aligned_row(const _InTy *_From, _OutTy *_To, size_t _Count, std::integral_constant<bool, _Src_aligned>, std::true_type)
+	{
+#if _EXP_SSE2
+		const size_t _Per_block = 16 / sizeof(_OutTy);
+		size_t _I = 0;
+		for (; _I + _Per_block <= _Count; _I += _Per_block)
+			_mm_store_si128(reinterpret_cast<__m128i *>(_To + _I), _Load_block(_From + _I, std::integral_constant<bool, _Src_aligned>()));
+		std::copy(_From + _I, _From + _Count, _To + _I);
+#else
+		std::copy_n(_From, _Count, _To);
+#endif
+	}
+
+	template<typename _InTy, typename _OutTy, bool _Src_aligned>
+	inline void _Copy_aligned_row(const _InTy *_From, _OutTy *_To, size_t _Count, std::integral_constant<bool, _Src_aligned>, std::false_type)
+	{
+		std::copy_n(_From, _Count, _To);
+	}
+
+	template<typename _Ty, int _Rank, size_t _Alignment, typename _Val>
+	struct _Fill_aligned_rows
+	{
+		const aligned_array_view<_Ty, _Rank, _Alignment>& _View;
+		const _Val& _Value;
+
+		void operator()(size_t _First, size_t _Count) const
+		{
+			typedef std::integral_constant<bool, _Is_aligned_block_row<_Ty, _Alignment>::value
+				&& (std::is_same<_Ty, _Val>::value || (std::is_arithmetic<_Ty>::value && std::is_arithmetic<_Val>::value))> _Block_stores;
+
+			_Fill(_First, _Count, _Block_stores());
+		}
+
+		void _Fill(size_t _First, size_t _Count, std::true_type) const
+		{
+			const _Ty _Local = static_cast<_Ty>(_Value);
+			const size_t _Cols = static_cast<size_t>(_View.bounds()[_Rank - 1]);
+			for (size_t _Row = _First; _Row < _First + _Count; ++_Row)
+				_Fill_aligned_row(_View.row(static_cast<ptrdiff_t>(_Row)), _Cols, _Local, std::true_type());
+		}
+
+		void _Fill(size_t _First, size_t _Count, std::false_type) const
+		{
+			const size_t _Cols = static_cast<size_t>(_View.bounds()[_Rank - 1]);
+			for (size_t _Row = _First; _Row < _First + _Count; ++_Row)
+				std::fill_n(_View.row(static_cast<ptrdiff_t>(_Row)), _Cols, _Value);
+		}
+	};
+
+	template<typename _InView, typename _OutTy, int _Rank, size_t _Alignment>
+	struct _Copy_aligned_rows
+	{
+		typedef typename _InView::value_type _InTy;
+
+		const D4087::strided_array_view<_InTy, _Rank>& _Source;
+		const aligned_array_view<_OutTy, _Rank, _Alignment>& _Dest;
+
+		void operator()(size_t _First, size_t _Count) const
+		{
+			typedef std::integral_constant<bool, _Is_aligned_block_row<_OutTy, _Alignment>::value
+				&& std::is_same<typename std::remove_cv<_InTy>::type, _OutTy>::value> _Block_stores;
+			typedef std::integral_constant<bool, _View_alignment<_InView>::value % 16 == 0> _Block_loads;
+
+			const D4087::bounds<_Rank> _Bnd = _Source.bounds();
+			const size_t _Cols = static_cast<size_t>(_Bnd[_Rank - 1]);
+			const ptrdiff_t _Step = _Source.stride()[_Rank - 1];
+			for (size_t _Row = _First; _Row < _First + _Count; ++_Row)
+			{
+				const _InTy *_From = &_Source[_Row_origin(_Bnd, static_cast<ptrdiff_t>(_Row))];
+				_OutTy *_To = _Dest.row(static_cast<ptrdiff_t>(_Row));
+				if (_Step == 1)
+					_Copy_aligned_row(_From, _To, _Cols, _Block_loads(), _Block_stores());
+				else
+					for (size_t _I = 0; _I < _Cols; ++_I, _From += _Step)
+						_To[_I] = *_From;
+			}
+		}
+	};
+} // details
+
+/// <summary>
+///     Assigns _Val to every element of an aligned view, row by row with aligned stores.
+/// </summary>
+template <class _ExPolicy, class _Ty, int _Rank, size_t _Alignment, class _Val>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type fill(_ExPolicy&& _Policy, const aligned_array_view<_Ty, _Rank, _Alignment>& _View, const _Val& _Value)
+{
+	_EXP_TELEMETRY_ALGORITHM("fill");
+	if (_View.size() == 0)
+		return;
+
+	const details::_Fill_aligned_rows<_Ty, _Rank, _Alignment, _Val> _Rows = { _View, _Value };
+	details::_Aligned_rows_impl(_Policy, static_cast<size_t>(_View.rows()), _Rows);
+}
+
+/// <summary>
+///     Copies every element of a view to the element at the same index of an aligned view of the same bounds,
+///     row by row with aligned stores, and aligned loads when the source is an aligned view too.
+/// </summary>
+template <class _ExPolicy, class _InView, class _OutTy, int _Rank, size_t _Alignment>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView>::type>::type copy(_ExPolicy&& _Policy, const _InView& _View, const aligned_array_view<_OutTy, _Rank, _Alignment>& _Dest_view)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy");
+	static_assert(_InView::rank == _Rank, "Required views of the same rank.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	if (_View.size() == 0)
+		return;
+
+	const auto& _Source = details::_Strided_view(_View);
+	const details::_Copy_aligned_rows<_InView, _OutTy, _Rank, _Alignment> _Rows = { _Source, _Dest_view };
+	details::_Aligned_rows_impl(_Policy, static_cast<size_t>(_Dest_view.rows()), _Rows);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_ALIGNED_VIEW_H_
@@ -4,6 +4,7 @@
 #define _IMPL_ALL_ANY_NONE_OF_H_ 1
 
 #include "algorithm_impl.h"
+#include "find.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -18,23 +19,29 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	// A chunk scans a block without polling and stops at its first match, the token is checked
+	// before each block: a match found elsewhere ends the chunk without looking at the next one
 	template <class _ExPolicy, class _InIt, class _Pr, class _IterCat>
-	bool _Any_of_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
+	bool _Any_of_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
 	{
-		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
-
 		if (_First != _Last)
 		{
 			cancellation_token _Token;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, std::distance(_First, _Last), _Pred,
+			_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Pred,
 				[&_Token](_InIt _Begin, size_t _Count, _Pr& _UserPred){
+				const size_t _Interval = _Cancellation_poll_interval<typename std::iterator_traits<_InIt>::value_type>::value;
+
+				for (size_t _Curr_pos = 0; _Curr_pos < _Count && !_Token.is_cancelled();) {
+					size_t _Block = (std::min)(_Count - _Curr_pos, _Interval);
 
-				LoopHelper<_ExecutionPolicy, _InIt>::Loop(_Begin, _Count, [&_Token, &_UserPred](const std::iterator_traits<_InIt>::reference _El){
-					if (_UserPred(_El))
+					if (_Find_block(_Begin, _Block, _UserPred, _IterCat()) != _Block) {
 						_Token.cancel();
-				}, _Token);
+						break;
+					}
 
+					_Curr_pos += _Block;
+				}
 			});
 
 			return _Token.is_cancelled();
@@ -79,8 +86,8 @@ namespace details {
 		return true;
 	}
 
-	template <class _ExPolicy, class _InIt, class _Pr, class _IterCat>
-	bool _All_of_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, std::input_iterator_tag _Cat)
+	template <class _ExPolicy, class _InIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, bool>::type _All_of_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, std::input_iterator_tag _Cat)
 	{
 		return _All_of_impl(seq, _First, _Last, _Pred, _Cat);
 	}
@@ -95,6 +102,7 @@ namespace details {
 template <class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type any_of(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("any_of");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Any_of_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -103,6 +111,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type any_of(_ExPoli
 template <class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type none_of(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("none_of");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Any_of_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First)) == false;
@@ -111,6 +120,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type none_of(_ExPol
 template <class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type all_of(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("all_of");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_All_of_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -0,0 +1,203 @@
+#pragma once
+
+#ifndef _IMPL_BULK_MEMORY_H_
+#define _IMPL_BULK_MEMORY_H_ 1
+
+#include <cstdint>
+#include <cstring>
+#include "algorithm_impl.h"
+
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// The chunks of a bulk copy or fill start on page boundaries of the destination, two chores never
+	// write the same cache line
+	const size_t _Bulk_page_bytes = 4096;
+
+	// Ranges smaller than this are copied by one memcpy on the calling thread
+	const size_t _Bulk_parallel_bytes = 64 * 1024;
+
+	// Destinations from this size on are bigger than the last level cache, they are written with
+	// streaming stores that don't evict the working set of the other threads
+	const size_t _Streaming_store_bytes = 32 * 1024 * 1024;
+
+	// Contiguous ranges of the same trivially copyable type, copied and moved as bytes. The output
+	// iterators without a value type are not.
+	template<typename _InIt, typename _OutIt, typename _Ty = typename std::iterator_traits<_OutIt>::value_type, bool = std::is_void<_Ty>::value>
+	struct _Is_memcpy_range : std::integral_constant<bool, _Contiguous_container_iterator_traits<_InIt>::value && _Contiguous_container_iterator_traits<_OutIt>::value
+		&& std::is_same<typename std::remove_const<typename std::iterator_traits<_InIt>::value_type>::type, _Ty>::value
+		&& std::is_trivially_copyable<_Ty>::value>
+	{
+	};
+
+	template<typename _InIt, typename _OutIt, typename _Ty>
+	struct _Is_memcpy_range<_InIt, _OutIt, _Ty, true> : std::false_type
+	{
+	};
+
+	// A contiguous range of a trivially copyable type filled with a value of its own type, or converted
+	// from another arithmetic type
+	template<typename _OutIt, typename _Val, typename _Ty = typename std::iterator_traits<_OutIt>::value_type, bool = std::is_void<_Ty>::value>
+	struct _Is_bulk_fill : std::integral_constant<bool, _Contiguous_container_iterator_traits<_OutIt>::value && std::is_trivially_copyable<_Ty>::value
+		&& (std::is_same<_Ty, _Val>::value || (std::is_arithmetic<_Ty>::value && std::is_arithmetic<_Val>::value))>
+	{
+	};
+
+	template<typename _OutIt, typename _Val, typename _Ty>
+	struct _Is_bulk_fill<_OutIt, _Val, _Ty, true> : std::false_type
+	{
+	};
+
+	// memcpy through non-temporal stores, the destination is written in aligned 16 byte blocks
+	inline void _Stream_copy(void *_Dest, const void *_Src, size_t _Bytes)
+	{
+#if _EXP_SSE2
+		unsigned char *_To = static_cast<unsigned char *>(_Dest);
+		const unsigned char *_From = static_cast<const unsigned char *>(_Src);
+
+		const size_t _Head = (std::min)(_Bytes, (16 - reinterpret_cast<std::uintptr_t>(_To) % 16) % 16);
+		std::memcpy(_To, _From, _Head);
+		_To += _Head;
+		_From += _Head;
+		_Bytes -= _Head;
+
+		for (; _Bytes >= 16; _Bytes -= 16, _To += 16, _From += 16)
+			_mm_stream_si128(reinterpret_cast<__m128i *>(_To), _mm_loadu_si128(reinterpret_cast<const __m128i *>(_From)));
+
+		std::memcpy(_To, _From, _Bytes);
+		_mm_sfence();
+#else
+		std::memcpy(_Dest, _Src, _Bytes);
+#endif
+	}
+
+	// Fills through non-temporal stores when 16 byte blocks hold whole elements and the destination
+	// reaches an aligned block on an element boundary
+	template<typename _Ty>
+	inline void _Stream_fill(_Ty *_Dest, size_t _Count, const _Ty& _Val)
+	{
+#if _EXP_SSE2
+		const size_t _Misalign = reinterpret_cast<std::uintptr_t>(_Dest) % 16;
+		if (16 % sizeof(_Ty) == 0 && _Misalign % sizeof(_Ty) == 0) {
+			const size_t _Head = (std::min)(_Count, (16 - _Misalign) % 16 / sizeof(_Ty));
+			std::fill(_Dest, _Dest + _Head, _Val);
+			_Dest += _Head;
+			_Count -= _Head;
+
+			const size_t _Per_block = 16 / sizeof(_Ty);
+			_Ty _Pattern[16 / sizeof(_Ty)];
+			std::fill(_Pattern, _Pattern + _Per_block, _Val);
+			const __m128i _Block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Pattern));
+
+			for (; _Count >= _Per_block; _Count -= _Per_block, _Dest += _Per_block)
+				_mm_stream_si128(reinterpret_cast<__m128i *>(_Dest), _Block);
+
+			std::fill(_Dest, _Dest + _Count, _Val);
+			_mm_sfence();
+			return;
+		}
+#endif
+		std::fill(_Dest, _Dest + _Count, _Val);
+	}
+
+	template<typename _Ty>
+	inline void _Block_fill(_Ty *_Dest, size_t _Count, const _Ty& _Val, std::true_type) // bytes
+	{
+		unsigned char _Byte;
+		std::memcpy(&_Byte, &_Val, 1);
+		std::memset(_Dest, _Byte, _Count);
+	}
+
+	template<typename _Ty>
+	inline void _Block_fill(_Ty * _EXP_RESTRICT _Dest, size_t _Count, const _Ty& _Val, std::false_type)
+	{
+		const _Ty _Local = _Val;
+		_EXP_LOOP_IVDEP
+			for (size_t _I = 0; _I < _Count; ++_I)
+				_Dest[_I] = _Local;
+	}
+
+	// Splits the _Count elements from _Dest in chunks that start on page boundaries, the part before
+	// the first one goes to the calling thread. _Fn is called with the offset and the size of each
+	// chunk, and whether it should write with streaming stores. It must not throw.
+	template<typename _ExPolicy, typename _Ty, typename _Fn>
+	void _Bulk_for_each_chunk(const _ExPolicy& _Policy, _Ty *_Dest, size_t _Count, const _Fn& _Func)
+	{
+		const size_t _Bytes = _Count * sizeof(_Ty);
+		bool _Stream = _Bytes >= _Streaming_store_bytes;
+
+		if (_Bytes < _Bulk_parallel_bytes) {
+			_Func(0, _Count, _Stream);
+			return;
+		}
+
+		const unsigned int _Max_threads = _Policy.parameters().thread_limit();
+		const unsigned int _Threads = _Thread_count(_Max_threads);
+		size_t _Head = 0;
+		size_t _Chunk = (_Count + _Threads - 1) / _Threads;
+
+		// elements that straddle the pages can't keep the chunks on page boundaries
+		if (_Bulk_page_bytes % sizeof(_Ty) == 0) {
+			const size_t _Head_bytes = (_Bulk_page_bytes - reinterpret_cast<std::uintptr_t>(_Dest) % _Bulk_page_bytes) % _Bulk_page_bytes;
+			const size_t _Per_page = _Bulk_page_bytes / sizeof(_Ty);
+
+			if (_Head_bytes % sizeof(_Ty) == 0)
+				_Head = _Head_bytes / sizeof(_Ty);
+			_Chunk = (_Chunk + _Per_page - 1) / _Per_page * _Per_page;
+		}
+
+		if (_Head != 0)
+			_Func(0, _Head, _Stream);
+
+		_Partitioner<static_partitioner_tag, true>::_For_Each(_Dest + _Head, _Count - _Head, _Stream,
+			[_Dest, &_Func](_Ty *_Begin, size_t _Chunk_count, bool& _Use_stream) {
+			_Func(static_cast<size_t>(_Begin - _Dest), _Chunk_count, _Use_stream);
+		}, _Chunk, _Max_threads);
+	}
+
+	template<typename _ExPolicy, typename _Ty>
+	void _Bulk_copy(const _ExPolicy& _Policy, const _Ty *_First, size_t _Count, _Ty *_Dest)
+	{
+		_Bulk_for_each_chunk(_Policy, _Dest, _Count, [_First, _Dest](size_t _Offset, size_t _Chunk_count, bool _Stream) {
+			if (_Stream)
+				_Stream_copy(_Dest + _Offset, _First + _Offset, _Chunk_count * sizeof(_Ty));
+			else
+				std::memcpy(_Dest + _Offset, _First + _Offset, _Chunk_count * sizeof(_Ty));
+		});
+	}
+
+	template<typename _ExPolicy, typename _Ty>
+	void _Bulk_fill(const _ExPolicy& _Policy, _Ty *_Dest, size_t _Count, const _Ty& _Val)
+	{
+		_Bulk_for_each_chunk(_Policy, _Dest, _Count, [_Dest, &_Val](size_t _Offset, size_t _Chunk_count, bool _Stream) {
+			if (_Stream)
+				_Stream_fill(_Dest + _Offset, _Chunk_count, _Val);
+			else
+				_Block_fill(_Dest + _Offset, _Chunk_count, _Val, std::integral_constant<bool, sizeof(_Ty) == 1>());
+		});
+	}
+
+	// Both ranges are read and written, the chunks keep the page boundaries but not the streaming stores
+	template<typename _ExPolicy, typename _Ty>
+	void _Bulk_swap(const _ExPolicy& _Policy, _Ty *_First, size_t _Count, _Ty *_Dest)
+	{
+		_Bulk_for_each_chunk(_Policy, _Dest, _Count, [_First, _Dest](size_t _Offset, size_t _Chunk_count, bool) {
+			_Ty * _EXP_RESTRICT _Left = _First + _Offset;
+			_Ty * _EXP_RESTRICT _Right = _Dest + _Offset;
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Chunk_count; ++_I)
+				{
+					const _Ty _Tmp = _Left[_I];
+					_Left[_I] = _Right[_I];
+					_Right[_I] = _Tmp;
+				}
+		});
+	}
+} // details
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_BULK_MEMORY_H_
@@ -0,0 +1,446 @@
+#pragma once
+
+#ifndef _IMPL_BULK_SEARCH_H_
+#define _IMPL_BULK_SEARCH_H_ 1
+
+#include <functional>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include "algorithm_impl.h"
+
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	inline void _Prefetch_read(const void *_Ptr)
+	{
+#if _EXP_SSE2
+		_mm_prefetch(static_cast<const char *>(_Ptr), _MM_HINT_T0);
+#else
+		(void)_Ptr;
+#endif
+	}
+
+	template<typename _RanIt>
+	inline void _Prefetch_element(const _RanIt& _It, std::true_type) // contiguous
+	{
+		_Prefetch_read(_Unwrap_contiguous(_It));
+	}
+
+	template<typename _RanIt>
+	inline void _Prefetch_element(const _RanIt&, std::false_type)
+	{
+	}
+
+	// The elements before the lower bound of _Val
+	template<typename _Ty, typename _Pr>
+	struct _Before_lower_bound
+	{
+		const _Ty& _Val;
+		_Pr& _Pred;
+
+		_Before_lower_bound(const _Ty& _Value, _Pr& _Less) : _Val(_Value), _Pred(_Less)
+		{
+		}
+
+		template<typename _El>
+		bool operator()(const _El& _Elem) const
+		{
+			return _Pred(_Elem, _Val) ? true : false;
+		}
+	};
+
+	// The elements before the upper bound of _Val
+	template<typename _Ty, typename _Pr>
+	struct _Before_upper_bound
+	{
+		const _Ty& _Val;
+		_Pr& _Pred;
+
+		_Before_upper_bound(const _Ty& _Value, _Pr& _Less) : _Val(_Value), _Pred(_Less)
+		{
+		}
+
+		template<typename _El>
+		bool operator()(const _El& _Elem) const
+		{
+			return _Pred(_Val, _Elem) ? false : true;
+		}
+	};
+
+	// Offset of the first of the _Count elements from _First _Is_before doesn't hold for. The range is halved
+	// the same number of times whatever the values, the half to go on with is picked without a branch the
+	// processor could mispredict. The two elements the next step may compare are prefetched meanwhile.
+	template<typename _RanIt, typename _Before>
+	inline size_t _Branchless_bound(_RanIt _First, size_t _Count, const _Before& _Is_before)
+	{
+		typedef _Contiguous_container_iterator_traits<_RanIt> _Contiguous;
+
+		if (_Count == 0)
+			return 0;
+
+		size_t _Base = 0;
+		while (_Count > 1)
+		{
+			const size_t _Half = _Count / 2;
+			_Count -= _Half;
+			_Prefetch_element(_First + (_Base + _Count / 2), _Contiguous());
+			_Prefetch_element(_First + (_Base + _Half + _Count / 2), _Contiguous());
+			_Base += _Is_before(_First[_Base + _Half]) ? _Half : 0;
+		}
+
+		return _Base + (_Is_before(_First[_Base]) ? 1 : 0);
+	}
+
+	// Offset of the bound of ascending queries, which is not before _Start. The search gallops from _Start
+	// by steps that double, then halves the last step, a query close to the one before is found in a few
+	// comparisons on the cache lines that one touched.
+	template<typename _RanIt, typename _Before>
+	inline size_t _Galloping_bound(_RanIt _First, size_t _Count, size_t _Start, const _Before& _Is_before)
+	{
+		for (size_t _Step = 1;; _Step *= 2)
+		{
+			const size_t _Probe = _Start + _Step - 1;
+			if (_Probe >= _Count)
+				return _Start + _Branchless_bound(_First + _Start, _Count - _Start, _Is_before);
+
+			if (!_Is_before(_First[_Probe]))
+				return _Start + _Branchless_bound(_First + _Start, _Probe - _Start, _Is_before);
+
+			_Start = _Probe + 1;
+		}
+	}
+
+	struct _Lower_bound_tag {};
+	struct _Upper_bound_tag {};
+	struct _Equal_range_tag {};
+
+	// The queries of a chunk are checked to ascend when they are of the type of the elements, the
+	// predicate may not compare the other ones with each other
+	template<typename _QIt, typename _RanIt, typename _Pr, bool = std::is_same<typename std::iterator_traits<_QIt>::value_type,
+		typename std::iterator_traits<_RanIt>::value_type>::value>
+	struct _Ascending_queries
+	{
+		static bool _Check(_QIt _First, size_t _Count, _Pr& _Pred)
+		{
+			if (_Count < 2)
+				return false;
+
+			for (_QIt _Next = _First; --_Count > 0; _First = _Next)
+			{
+				if (_Pred(*++_Next, *_First))
+					return false;
+			}
+			return true;
+		}
+	};
+
+	template<typename _QIt, typename _RanIt, typename _Pr>
+	struct _Ascending_queries<_QIt, _RanIt, _Pr, false>
+	{
+		static bool _Check(_QIt, size_t, _Pr&)
+		{
+			return false;
+		}
+	};
+
+	// Searches one sorted range. A chunk of queries that ascend is searched from one bound to the next
+	template<typename _RanIt, typename _Pr, typename _Kind>
+	class _Range_searcher
+	{
+		_RanIt _First;
+		size_t _Size;
+		_Pr _Pred;
+
+		template<typename _Ty>
+		_RanIt _Bound(const _Ty& _Val, size_t& _Start, bool _Ascending, _Lower_bound_tag)
+		{
+			const _Before_lower_bound<_Ty, _Pr> _Is_before(_Val, _Pred);
+			_Start = _Ascending ? _Galloping_bound(_First, _Size, _Start, _Is_before) : _Branchless_bound(_First, _Size, _Is_before);
+			return _First + _Start;
+		}
+
+		template<typename _Ty>
+		_RanIt _Bound(const _Ty& _Val, size_t& _Start, bool _Ascending, _Upper_bound_tag)
+		{
+			const _Before_upper_bound<_Ty, _Pr> _Is_before(_Val, _Pred);
+			_Start = _Ascending ? _Galloping_bound(_First, _Size, _Start, _Is_before) : _Branchless_bound(_First, _Size, _Is_before);
+			return _First + _Start;
+		}
+
+		// The upper bound is searched from the lower one on
+		template<typename _Ty>
+		std::pair<_RanIt, _RanIt> _Bound(const _Ty& _Val, size_t& _Start, bool _Ascending, _Equal_range_tag)
+		{
+			_RanIt _Lower = _Bound(_Val, _Start, _Ascending, _Lower_bound_tag());
+			const size_t _Upper = _Galloping_bound(_First, _Size, _Start, _Before_upper_bound<_Ty, _Pr>(_Val, _Pred));
+			return std::make_pair(_Lower, _First + _Upper);
+		}
+
+	public:
+		_Range_searcher(_RanIt _Begin, _RanIt _End, _Pr _Less) : _First(_Begin), _Size(_End - _Begin), _Pred(_Less)
+		{
+		}
+
+		template<typename _QIt, typename _OutIt>
+		_OutIt operator()(_QIt _Queries, size_t _Count, _OutIt _Dest)
+		{
+			const bool _Ascending = _Ascending_queries<_QIt, _RanIt, _Pr>::_Check(_Queries, _Count, _Pred);
+
+			size_t _Start = 0;
+			for (; _Count > 0; --_Count, ++_Queries, ++_Dest)
+				*_Dest = _Bound(*_Queries, _Start, _Ascending, _Kind());
+			return _Dest;
+		}
+	};
+} // details
+
+/// <summary>
+///     A copy of a sorted range in the Eytzinger layout: the root first, then the children of every node in the order
+///     of their parents. A search walks down from the root, the first levels share a few cache lines and the 16
+///     descendants four levels down of a node are contiguous, they are prefetched while it's compared. Built once,
+///     it's searched by any number of bulk_lower_bound, bulk_upper_bound calls. The range must outlive it.
+/// </summary>
+template<class _RanIt, class _Pr = std::less<>>
+class eytzinger_index
+{
+	typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+	_RanIt _First;
+	size_t _Size;
+	_Pr _Pred;
+	std::vector<_Value_type> _Tree; // the node _K at _K - 1, the root is node 1
+	std::vector<size_t> _Rank; // the offset in the range of every node
+
+	// Numbers the nodes of the subtree of _Node in order, from the offset _Next on
+	size_t _Build(size_t _Node, size_t _Next)
+	{
+		if (_Node > _Size)
+			return _Next;
+
+		_Next = _Build(2 * _Node, _Next);
+		_Rank[_Node - 1] = _Next++;
+		return _Build(2 * _Node + 1, _Next);
+	}
+
+	template<typename _Before>
+	size_t _Search(const _Before& _Is_before) const
+	{
+		size_t _Node = 1;
+		while (_Node <= _Size)
+		{
+			if (16 * _Node <= _Size)
+				details::_Prefetch_read(_Tree.data() + (16 * _Node - 1));
+			_Node = 2 * _Node + (_Is_before(_Tree[_Node - 1]) ? 1 : 0);
+		}
+
+		// The bound is the last node the search went left from, drop the right turns after it and that turn
+		while (_Node & 1)
+			_Node >>= 1;
+		_Node >>= 1;
+
+		return _Node == 0 ? _Size : _Rank[_Node - 1];
+	}
+
+public:
+	eytzinger_index(_RanIt _Begin, _RanIt _End, _Pr _Less = _Pr()) : _First(_Begin), _Size(_End - _Begin), _Pred(_Less), _Rank(_Size)
+	{
+		_Build(1, 0);
+
+		_Tree.reserve(_Size);
+		for (size_t _Node = 0; _Node < _Size; ++_Node)
+			_Tree.push_back(_First[_Rank[_Node]]);
+	}
+
+	size_t size() const _NOEXCEPT
+	{
+		return _Size;
+	}
+
+	template<class _Ty>
+	_RanIt lower_bound(const _Ty& _Val) const
+	{
+		return _First + _Search(details::_Before_lower_bound<_Ty, const _Pr>(_Val, _Pred));
+	}
+
+	template<class _Ty>
+	_RanIt upper_bound(const _Ty& _Val) const
+	{
+		return _First + _Search(details::_Before_upper_bound<_Ty, const _Pr>(_Val, _Pred));
+	}
+};
+
+namespace details {
+
+	template<typename _RanIt, typename _Pr, typename _Kind>
+	class _Eytzinger_searcher
+	{
+		const eytzinger_index<_RanIt, _Pr>& _Index;
+
+		template<typename _Ty>
+		_RanIt _Bound(const _Ty& _Val, _Lower_bound_tag) const
+		{
+			return _Index.lower_bound(_Val);
+		}
+
+		template<typename _Ty>
+		_RanIt _Bound(const _Ty& _Val, _Upper_bound_tag) const
+		{
+			return _Index.upper_bound(_Val);
+		}
+
+	public:
+		explicit _Eytzinger_searcher(const eytzinger_index<_RanIt, _Pr>& _Idx) : _Index(_Idx)
+		{
+		}
+
+		template<typename _QIt, typename _OutIt>
+		_OutIt operator()(_QIt _Queries, size_t _Count, _OutIt _Dest) const
+		{
+			for (; _Count > 0; --_Count, ++_Queries, ++_Dest)
+				*_Dest = _Bound(*_Queries, _Kind());
+			return _Dest;
+		}
+	};
+
+	//
+	// bulk_lower_bound, bulk_upper_bound, bulk_equal_range
+	//
+	template<class _FwdIt, class _OutIt, class _Searcher, class _IterCat>
+	inline _OutIt _Bulk_search_impl(const sequential_execution_policy&, _FwdIt _First, _FwdIt _Last, _OutIt _Dest, _Searcher _Search, _IterCat)
+	{
+		_EXP_TRY
+			return _Search(_First, std::distance(_First, _Last), _Dest);
+		_EXP_RETHROW
+	}
+
+	// The chunks of queries are searched independently, every chunk decides on its own whether its
+	// queries ascend
+	template<class _ExPolicy, class _FwdIt, class _OutIt, class _Searcher, class _IterCat>
+	inline _OutIt _Bulk_search_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _OutIt _Dest, _Searcher _Search, _IterCat)
+	{
+		if (_First == _Last)
+			return _Dest;
+
+		return std::get<1>(*_Partitioned_for_each(_Policy, make_composable_iterator(_First, _Dest), std::distance(_First, _Last), _Search,
+			[](composable_iterator<_FwdIt, _OutIt> _Begin, size_t _Count, _Searcher& _User_search) {
+			_User_search(std::get<0>(*_Begin), _Count, std::get<1>(*_Begin));
+		}));
+	}
+
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Searcher>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Bulk_search_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Searcher _Search, std::input_iterator_tag _Cat)
+	{
+		return _Bulk_search_impl(seq, _First, _Last, _Dest, _Search, _Cat);
+	}
+
+	template<class _FwdIt, class _OutIt, class _Searcher, class _IterCat>
+	inline _OutIt _Bulk_search_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _OutIt _Dest, _Searcher _Search, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Bulk_search_impl, _Policy, _First, _Last, _Dest, _Search, _Cat);
+	}
+} // details
+
+/// <summary>
+///     Writes std::lower_bound(_First, _Last, *_Query, _Pred) for every query of [_Queries_first, _Queries_last) to _Dest.
+///     The searches are branch free, a chunk of queries that ascend is searched from one result to the next.
+/// </summary>
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_lower_bound(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_lower_bound");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	typename details::common_iterator<_FwdIt, _OutIt>::iterator_category _Cat;
+	return details::_Bulk_search_impl(_Policy, _Queries_first, _Queries_last, _Dest, details::_Range_searcher<_RanIt, _Pr, details::_Lower_bound_tag>(_First, _Last, _Pred), _Cat);
+}
+
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_lower_bound(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_lower_bound");
+	return bulk_lower_bound(std::forward<_ExPolicy>(_Policy), _First, _Last, _Queries_first, _Queries_last, _Dest, std::less<>());
+}
+
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_upper_bound(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_upper_bound");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	typename details::common_iterator<_FwdIt, _OutIt>::iterator_category _Cat;
+	return details::_Bulk_search_impl(_Policy, _Queries_first, _Queries_last, _Dest, details::_Range_searcher<_RanIt, _Pr, details::_Upper_bound_tag>(_First, _Last, _Pred), _Cat);
+}
+
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_upper_bound(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_upper_bound");
+	return bulk_upper_bound(std::forward<_ExPolicy>(_Policy), _First, _Last, _Queries_first, _Queries_last, _Dest, std::less<>());
+}
+
+/// <summary>
+///     Writes the pair of std::equal_range(_First, _Last, *_Query, _Pred) for every query, the upper bound is searched from the lower one.
+/// </summary>
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_equal_range(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_equal_range");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	typename details::common_iterator<_FwdIt, _OutIt>::iterator_category _Cat;
+	return details::_Bulk_search_impl(_Policy, _Queries_first, _Queries_last, _Dest, details::_Range_searcher<_RanIt, _Pr, details::_Equal_range_tag>(_First, _Last, _Pred), _Cat);
+}
+
+template<class _ExPolicy, class _RanIt, class _FwdIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_equal_range(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_equal_range");
+	return bulk_equal_range(std::forward<_ExPolicy>(_Policy), _First, _Last, _Queries_first, _Queries_last, _Dest, std::less<>());
+}
+
+/// <summary>
+///     Searches the range of the index for every query, the results are iterators to the range.
+/// </summary>
+template<class _ExPolicy, class _RanIt, class _Pr, class _FwdIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_lower_bound(_ExPolicy&& _Policy, const eytzinger_index<_RanIt, _Pr>& _Index,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_lower_bound");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	typename details::common_iterator<_FwdIt, _OutIt>::iterator_category _Cat;
+	return details::_Bulk_search_impl(_Policy, _Queries_first, _Queries_last, _Dest, details::_Eytzinger_searcher<_RanIt, _Pr, details::_Lower_bound_tag>(_Index), _Cat);
+}
+
+template<class _ExPolicy, class _RanIt, class _Pr, class _FwdIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type bulk_upper_bound(_ExPolicy&& _Policy, const eytzinger_index<_RanIt, _Pr>& _Index,
+	_FwdIt _Queries_first, _FwdIt _Queries_last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("bulk_upper_bound");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	typename details::common_iterator<_FwdIt, _OutIt>::iterator_category _Cat;
+	return details::_Bulk_search_impl(_Policy, _Queries_first, _Queries_last, _Dest, details::_Eytzinger_searcher<_RanIt, _Pr, details::_Upper_bound_tag>(_Index), _Cat);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_BULK_SEARCH_H_
@@ -0,0 +1,618 @@
+#pragma once
+
+#ifndef _IMPL_CONCURRENT_VECTOR_H_
+#define _IMPL_CONCURRENT_VECTOR_H_ 1
+
+#include <atomic>
+#include <climits>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+
+namespace details {
+
+	// The position of the highest bit set of a non zero value
+	inline size_t _Highest_bit(size_t _Val)
+	{
+#ifdef _MSC_VER
+		unsigned long _Index;
+#ifdef _WIN64
+		_BitScanReverse64(&_Index, _Val);
+#else
+		_BitScanReverse(&_Index, _Val);
+#endif
+		return _Index;
+#else
+		return sizeof(unsigned long long) * CHAR_BIT - 1 - __builtin_clzll(_Val);
+#endif
+	}
+
+	template<typename _Vector, typename _Value>
+	class _Concurrent_vector_iterator :
+		public std::iterator<std::random_access_iterator_tag, typename std::remove_const<_Value>::type, ptrdiff_t, _Value *, _Value&>
+	{
+		_Vector *_Vec;
+		size_t _Index;
+
+		template<typename, typename> friend class _Concurrent_vector_iterator;
+	public:
+		_Concurrent_vector_iterator() : _Vec(nullptr), _Index(0)
+		{
+		}
+
+		_Concurrent_vector_iterator(_Vector *_V, size_t _I) : _Vec(_V), _Index(_I)
+		{
+		}
+
+		// iterator to const_iterator
+		template<typename _Other_vector, typename _Other_value>
+		_Concurrent_vector_iterator(const _Concurrent_vector_iterator<_Other_vector, _Other_value>& _Other) : _Vec(_Other._Vec), _Index(_Other._Index)
+		{
+		}
+
+		_Value& operator*() const
+		{
+			return (*_Vec)[_Index];
+		}
+
+		_Value *operator->() const
+		{
+			return std::addressof((*_Vec)[_Index]);
+		}
+
+		_Value& operator[](ptrdiff_t _Off) const
+		{
+			return (*_Vec)[_Index + _Off];
+		}
+
+		_Concurrent_vector_iterator& operator++()
+		{
+			++_Index;
+			return *this;
+		}
+
+		_Concurrent_vector_iterator operator++(int)
+		{
+			_Concurrent_vector_iterator _Tmp = *this;
+			++_Index;
+			return _Tmp;
+		}
+
+		_Concurrent_vector_iterator& operator--()
+		{
+			--_Index;
+			return *this;
+		}
+
+		_Concurrent_vector_iterator operator--(int)
+		{
+			_Concurrent_vector_iterator _Tmp = *this;
+			--_Index;
+			return _Tmp;
+		}
+
+		_Concurrent_vector_iterator& operator+=(ptrdiff_t _Off)
+		{
+			_Index += _Off;
+			return *this;
+		}
+
+		_Concurrent_vector_iterator& operator-=(ptrdiff_t _Off)
+		{
+			_Index -= _Off;
+			return *this;
+		}
+
+		_Concurrent_vector_iterator operator+(ptrdiff_t _Off) const
+		{
+			return _Concurrent_vector_iterator(_Vec, _Index + _Off);
+		}
+
+		_Concurrent_vector_iterator operator-(ptrdiff_t _Off) const
+		{
+			return _Concurrent_vector_iterator(_Vec, _Index - _Off);
+		}
+
+		ptrdiff_t operator-(const _Concurrent_vector_iterator& _Right) const
+		{
+			return static_cast<ptrdiff_t>(_Index - _Right._Index);
+		}
+
+		bool operator==(const _Concurrent_vector_iterator& _Right) const
+		{
+			return _Index == _Right._Index;
+		}
+
+		bool operator!=(const _Concurrent_vector_iterator& _Right) const
+		{
+			return _Index != _Right._Index;
+		}
+
+		bool operator<(const _Concurrent_vector_iterator& _Right) const
+		{
+			return _Index < _Right._Index;
+		}
+
+		bool operator>(const _Concurrent_vector_iterator& _Right) const
+		{
+			return _Right._Index < _Index;
+		}
+
+		bool operator<=(const _Concurrent_vector_iterator& _Right) const
+		{
+			return !(_Right._Index < _Index);
+		}
+
+		bool operator>=(const _Concurrent_vector_iterator& _Right) const
+		{
+			return !(_Index < _Right._Index);
+		}
+	};
+
+	// Gives the copies of the elements of a range one after the other
+	template<typename _FwdIt>
+	class _Range_values
+	{
+		_FwdIt _Next;
+	public:
+		explicit _Range_values(_FwdIt _First) : _Next(_First)
+		{
+		}
+
+		typename std::iterator_traits<_FwdIt>::reference operator()()
+		{
+			typename std::iterator_traits<_FwdIt>::reference _Val = *_Next;
+			++_Next;
+			return _Val;
+		}
+	};
+
+	template<typename _Ty>
+	class _Repeated_value
+	{
+		const _Ty& _Val;
+
+		_Repeated_value& operator=(const _Repeated_value&);
+	public:
+		explicit _Repeated_value(const _Ty& _V) : _Val(_V)
+		{
+		}
+
+		const _Ty& operator()()
+		{
+			return _Val;
+		}
+	};
+
+	template<typename _Ty>
+	class _Moved_value
+	{
+		_Ty& _Val;
+
+		_Moved_value& operator=(const _Moved_value&);
+	public:
+		explicit _Moved_value(_Ty& _V) : _Val(_V)
+		{
+		}
+
+		_Ty&& operator()()
+		{
+			return std::move(_Val);
+		}
+	};
+
+	template<typename _Ty>
+	struct _Value_initialized
+	{
+		_Ty operator()() const
+		{
+			return _Ty();
+		}
+	};
+}
+
+/// <summary>
+///     A vector that threads grow at the same time. Its elements sit in segments, each twice the size of the one
+///     before, so an element never moves and its address stays valid while the vector grows. <c>grow_by</c> reserves
+///     the new elements with one atomic addition, and the first thread that reaches a segment without storage
+///     allocates it. The elements are appended by the threads in the order they reserve them.
+///     The elements of a <c>grow_by</c> are constructed when it returns on its thread, another thread reads them
+///     after that, e.g. after the algorithm that grew the vector returned. <c>clear</c> and the destructor run
+///     alone.
+/// </summary>
+template<class _Ty, class _Alloc = std::allocator<_Ty>>
+class concurrent_vector
+{
+	static const size_t _First_segment_bits = 3;
+	static const size_t _First_segment_size = size_t(1) << _First_segment_bits;
+	static const size_t _Segment_count = sizeof(size_t) * CHAR_BIT - _First_segment_bits;
+
+	_Alloc _Allocator;
+	std::atomic<_Ty *> _Segments[_Segment_count];
+	std::atomic<size_t> _Size;
+
+	// The element _Index is _Index + _First_segment_size - (size of segment k) in segment k, where k is
+	// the highest bit of _Index + _First_segment_size above the bits of the first segment
+	static size_t _Segment_of(size_t _Index)
+	{
+		return details::_Highest_bit(_Index + _First_segment_size) - _First_segment_bits;
+	}
+
+	static size_t _Segment_base(size_t _Segment)
+	{
+		return (_First_segment_size << _Segment) - _First_segment_size;
+	}
+
+	static size_t _Segment_size(size_t _Segment)
+	{
+		return _First_segment_size << _Segment;
+	}
+
+	// Allocates the segment unless another thread did, the thread that loses the race frees its storage
+	void _Ensure_segment(size_t _Segment)
+	{
+		if (_Segments[_Segment].load(std::memory_order_acquire) != nullptr)
+			return;
+
+		_Ty *_Storage = _Allocator.allocate(_Segment_size(_Segment));
+		_Ty *_Expected = nullptr;
+		if (!_Segments[_Segment].compare_exchange_strong(_Expected, _Storage, std::memory_order_acq_rel))
+			_Allocator.deallocate(_Storage, _Segment_size(_Segment));
+	}
+
+	template<class _Source>
+	void _Construct_reserved(size_t _Index, size_t _Count, _Source& _Next)
+	{
+		size_t _I = 0;
+		try {
+			for (; _I < _Count; ++_I)
+				::new (static_cast<void *>(std::addressof((*this)[_Index + _I]))) _Ty(_Next());
+		}
+		catch (...) {
+			// The elements are reserved for good, the ones not copied are value initialized
+			for (; _I < _Count; ++_I)
+				::new (static_cast<void *>(std::addressof((*this)[_Index + _I]))) _Ty();
+			throw;
+		}
+	}
+
+	void _Destroy_elements()
+	{
+		const size_t _Count = _Size.load(std::memory_order_relaxed);
+		for (size_t _I = 0; _I < _Count; ++_I)
+			(*this)[_I].~_Ty();
+	}
+
+public:
+	typedef _Ty value_type;
+	typedef _Alloc allocator_type;
+	typedef size_t size_type;
+	typedef ptrdiff_t difference_type;
+	typedef _Ty& reference;
+	typedef const _Ty& const_reference;
+	typedef _Ty *pointer;
+	typedef const _Ty *const_pointer;
+	typedef details::_Concurrent_vector_iterator<concurrent_vector, _Ty> iterator;
+	typedef details::_Concurrent_vector_iterator<const concurrent_vector, const _Ty> const_iterator;
+
+	explicit concurrent_vector(const _Alloc& _Al = _Alloc()) : _Allocator(_Al), _Size(0)
+	{
+		for (size_t _Segment = 0; _Segment < _Segment_count; ++_Segment)
+			_Segments[_Segment].store(nullptr, std::memory_order_relaxed);
+	}
+
+	concurrent_vector(const concurrent_vector&) = delete;
+	concurrent_vector& operator=(const concurrent_vector&) = delete;
+
+	~concurrent_vector()
+	{
+		_Destroy_elements();
+		for (size_t _Segment = 0; _Segment < _Segment_count; ++_Segment)
+		{
+			_Ty *_Storage = _Segments[_Segment].load(std::memory_order_relaxed);
+			if (_Storage != nullptr)
+				_Allocator.deallocate(_Storage, _Segment_size(_Segment));
+		}
+	}
+
+	/// <summary>
+	///     Reserves _Count elements at the end of the vector and allocates the segments they fall in, the elements
+	///     are left to construct. Returns the index of the first of them.
+	/// </summary>
+	size_type _Reserve(size_type _Count)
+	{
+		const size_t _Index = _Size.fetch_add(_Count);
+		if (_Count != 0)
+		{
+			for (size_t _Segment = _Segment_of(_Index), _Last = _Segment_of(_Index + _Count - 1); _Segment <= _Last; ++_Segment)
+				_Ensure_segment(_Segment);
+		}
+		return _Index;
+	}
+
+	/// <summary>
+	///     Appends _Count value initialized elements, returns an iterator to the first of them.
+	/// </summary>
+	iterator grow_by(size_type _Count)
+	{
+		const size_t _Index = _Reserve(_Count);
+		details::_Value_initialized<_Ty> _Source;
+		_Construct_reserved(_Index, _Count, _Source);
+		return iterator(this, _Index);
+	}
+
+	/// <summary>
+	///     Appends _Count copies of _Val, returns an iterator to the first of them.
+	/// </summary>
+	iterator grow_by(size_type _Count, const _Ty& _Val)
+	{
+		const size_t _Index = _Reserve(_Count);
+		details::_Repeated_value<_Ty> _Source(_Val);
+		_Construct_reserved(_Index, _Count, _Source);
+		return iterator(this, _Index);
+	}
+
+	/// <summary>
+	///     Appends copies of the elements of [_First, _Last), returns an iterator to the first of them. If a copy
+	///     throws, the elements after it are value initialized and the exception is rethrown.
+	/// </summary>
+	template<class _FwdIt>
+	typename std::enable_if<!std::is_integral<_FwdIt>::value, iterator>::type grow_by(_FwdIt _First, _FwdIt _Last)
+	{
+		const size_t _Count = static_cast<size_t>(std::distance(_First, _Last));
+		const size_t _Index = _Reserve(_Count);
+		details::_Range_values<_FwdIt> _Source(_First);
+		_Construct_reserved(_Index, _Count, _Source);
+		return iterator(this, _Index);
+	}
+
+	/// <summary>
+	///     Constructs the _Count elements reserved from _Index with the values _Next() returns in turn.
+	/// </summary>
+	template<class _Source>
+	void _Construct_from(size_type _Index, size_type _Count, _Source& _Next)
+	{
+		_Construct_reserved(_Index, _Count, _Next);
+	}
+
+	/// <summary>
+	///     Appends a copy of _Val. If the copy throws, the element is value initialized and the exception is rethrown,
+	///     the other threads may have appended after it already.
+	/// </summary>
+	iterator push_back(const _Ty& _Val)
+	{
+		const size_t _Index = _Reserve(1);
+		details::_Repeated_value<_Ty> _Source(_Val);
+		_Construct_reserved(_Index, 1, _Source);
+		return iterator(this, _Index);
+	}
+
+	iterator push_back(_Ty&& _Val)
+	{
+		const size_t _Index = _Reserve(1);
+		details::_Moved_value<_Ty> _Source(_Val);
+		_Construct_reserved(_Index, 1, _Source);
+		return iterator(this, _Index);
+	}
+
+	reference operator[](size_type _Index)
+	{
+		const size_t _Segment = _Segment_of(_Index);
+		return _Segments[_Segment].load(std::memory_order_acquire)[_Index - _Segment_base(_Segment)];
+	}
+
+	const_reference operator[](size_type _Index) const
+	{
+		const size_t _Segment = _Segment_of(_Index);
+		return _Segments[_Segment].load(std::memory_order_acquire)[_Index - _Segment_base(_Segment)];
+	}
+
+	reference at(size_type _Index)
+	{
+		if (_Index >= size())
+			throw std::out_of_range("Invalid concurrent_vector index.");
+		return (*this)[_Index];
+	}
+
+	const_reference at(size_type _Index) const
+	{
+		if (_Index >= size())
+			throw std::out_of_range("Invalid concurrent_vector index.");
+		return (*this)[_Index];
+	}
+
+	/// <summary>
+	///     The number of elements appended, the ones a concurrent grow_by constructs included.
+	/// </summary>
+	size_type size() const _NOEXCEPT
+	{
+		return _Size.load(std::memory_order_acquire);
+	}
+
+	bool empty() const _NOEXCEPT
+	{
+		return size() == 0;
+	}
+
+	/// <summary>
+	///     Destroys the elements and keeps the segments for the next ones.
+	/// </summary>
+	void clear()
+	{
+		_Destroy_elements();
+		_Size.store(0, std::memory_order_relaxed);
+	}
+
+	allocator_type get_allocator() const
+	{
+		return allocator_type(_Allocator);
+	}
+
+	iterator begin()
+	{
+		return iterator(this, 0);
+	}
+
+	iterator end()
+	{
+		return iterator(this, size());
+	}
+
+	const_iterator begin() const
+	{
+		return const_iterator(this, 0);
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(this, size());
+	}
+
+	const_iterator cbegin() const
+	{
+		return begin();
+	}
+
+	const_iterator cend() const
+	{
+		return end();
+	}
+};
+
+namespace details {
+
+	template<typename _Container>
+	struct _Back_inserter_access : std::back_insert_iterator<_Container>
+	{
+		static _Container& _Get(const std::back_insert_iterator<_Container>& _It)
+		{
+			return *(_It.*(&_Back_inserter_access::container));
+		}
+	};
+
+	// Gives the elements of a chunk its filter marks, one after the other
+	template<typename _RanIt>
+	class _Marked_values
+	{
+		composable_iterator<_RanIt, _Filter_mask_iterator> _Next;
+	public:
+		explicit _Marked_values(const composable_iterator<_RanIt, _Filter_mask_iterator>& _First) : _Next(_First)
+		{
+		}
+
+		typename std::iterator_traits<_RanIt>::reference operator()()
+		{
+			while (!*std::get<1>(*_Next))
+				++_Next;
+
+			_RanIt _Elem = std::get<0>(*_Next);
+			++_Next;
+			return *_Elem;
+		}
+	};
+
+	//
+	// copy_if to a concurrent_vector
+	//
+	template<class _InIt, class _Ty, class _Alloc, class _Pr, class _IterCat>
+	inline void _Copy_if_grow_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, concurrent_vector<_Ty, _Alloc>& _Dest, _Pr _Pred, _IterCat)
+	{
+		_EXP_TRY
+			std::copy_if(_First, _Last, std::back_inserter(_Dest), _Pred);
+		_EXP_RETHROW
+	}
+
+	// A chunk marks the elements it keeps in its words of the filter mask and counts them, then reserves
+	// all of them with one grow_by and copies the marked ones. The chunks don't wait for one another, the
+	// elements of a chunk stay in order and the chunks are appended in the order they finish.
+	template<class _ExPolicy, class _RanIt, class _Ty, class _Alloc, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Copy_if_grow_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, concurrent_vector<_Ty, _Alloc>& _Dest, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		typedef composable_iterator<_RanIt, _Filter_mask_iterator> _Iter_type;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		if (_First == _Last)
+			return;
+
+		const size_t _Size = static_cast<size_t>(_Last - _First);
+		_Filter_mask _Filter(_Size);
+
+		// The static partitioner cuts the range at multiples of the chunk size, whole words of the mask
+		_Partitioner<static_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Filter.begin()), _Size, _Pred,
+			[&_Dest](_Iter_type _Begin, size_t _Count, _Pr& _UserPred) {
+
+			size_t _Kept = 0;
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Count,
+				[&_UserPred, &_Kept](typename _Iter_type::reference _It){
+
+				const bool _Keep = _UserPred(*std::get<0>(_It)) ? true : false;
+				*std::get<1>(_It) = _Keep;
+				if (_Keep)
+					++_Kept;
+			});
+
+			if (_Kept == 0)
+				return;
+
+			_Marked_values<_RanIt> _Source(_Begin);
+			_Dest._Construct_from(_Dest._Reserve(_Kept), _Kept, _Source);
+		}, _Filter_mask::chunk_size(_Size), _Policy.parameters().thread_limit());
+	}
+
+	template<class _ExPolicy, class _InIt, class _Ty, class _Alloc, class _Pr, class _IterCat>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Copy_if_grow_impl(const _ExPolicy&, _InIt _First, _InIt _Last, concurrent_vector<_Ty, _Alloc>& _Dest, _Pr _Pred, _IterCat _Cat)
+	{
+		_Copy_if_grow_impl(seq, _First, _Last, _Dest, _Pred, _Cat);
+	}
+
+	template<class _InIt, class _Ty, class _Alloc, class _Pr, class _IterCat>
+	inline void _Copy_if_grow_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, concurrent_vector<_Ty, _Alloc>& _Dest, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Copy_if_grow_impl, _Policy, _First, _Last, _Dest, _Pred, _Cat);
+	}
+} // details
+
+/// <summary>
+///     Appends the elements of [_First, _Last) for which _Pred is true to the concurrent_vector of the inserter.
+///     Each chunk appends the elements it keeps with one grow_by, so the number of them need not be known before.
+///     The elements of a chunk keep their order, the chunks are appended in any order.
+/// </summary>
+template<class _ExPolicy, class _InIt, class _Ty, class _Alloc, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, std::back_insert_iterator<concurrent_vector<_Ty, _Alloc>>>::type copy_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, std::back_insert_iterator<concurrent_vector<_Ty, _Alloc>> _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy_if");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+
+	details::_Copy_if_grow_impl(_Policy, _First, _Last, details::_Back_inserter_access<concurrent_vector<_Ty, _Alloc>>::_Get(_Dest), _Pred, std::_Iter_cat(_First));
+	return _Dest;
+}
+
+/// <summary>
+///     Appends the elements of [_First, _Last) for which _Pred is false to the concurrent_vector of the inserter,
+///     the way copy_if does.
+/// </summary>
+template<class _ExPolicy, class _InIt, class _Ty, class _Alloc, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, std::back_insert_iterator<concurrent_vector<_Ty, _Alloc>>>::type remove_copy_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, std::back_insert_iterator<concurrent_vector<_Ty, _Alloc>> _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("remove_copy_if");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+
+	details::_Copy_if_grow_impl(_Policy, _First, _Last, details::_Back_inserter_access<concurrent_vector<_Ty, _Alloc>>::_Get(_Dest), [_Pred](typename std::iterator_traits<_InIt>::reference _El){
+		return !_Pred(_El);
+	}, std::_Iter_cat(_First));
+	return _Dest;
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_CONCURRENT_VECTOR_H_
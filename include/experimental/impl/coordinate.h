@@ -15,6 +15,310 @@ namespace std {
 			
 			namespace details
 			{
+				// Component-wise operations of the coordinates. The small ranks get them unrolled at compile time,
+				// each component adds one step to the expression of the rank below, so the index and bounds
+				// arithmetic of the inner loops is straight-line code kept in registers.
+				template <int Rank, bool Unrolled = (Rank <= 4)>
+				struct coordinate_ops
+				{
+					using lower = coordinate_ops<Rank - 1>;
+
+					template <typename T>
+					static void fill(T* elems, T v) _NOEXCEPT
+					{
+						lower::fill(elems, v);
+						elems[Rank - 1] = v;
+					}
+
+					template <typename T>
+					static void copy(T* elems, const T* from) _NOEXCEPT
+					{
+						lower::copy(elems, from);
+						elems[Rank - 1] = from[Rank - 1];
+					}
+
+					template <typename T>
+					static void add(T* elems, const T* rhs) _NOEXCEPT
+					{
+						lower::add(elems, rhs);
+						elems[Rank - 1] += rhs[Rank - 1];
+					}
+
+					template <typename T>
+					static void subtract(T* elems, const T* rhs) _NOEXCEPT
+					{
+						lower::subtract(elems, rhs);
+						elems[Rank - 1] -= rhs[Rank - 1];
+					}
+
+					template <typename T>
+					static void negate(T* elems) _NOEXCEPT
+					{
+						lower::negate(elems);
+						elems[Rank - 1] = -elems[Rank - 1];
+					}
+
+					template <typename T>
+					static void multiply(T* elems, T v) _NOEXCEPT
+					{
+						lower::multiply(elems, v);
+						elems[Rank - 1] *= v;
+					}
+
+					template <typename T>
+					static void divide(T* elems, T v) _NOEXCEPT
+					{
+						lower::divide(elems, v);
+						elems[Rank - 1] /= v;
+					}
+
+					// Compares all the components without an early exit
+					template <typename T>
+					static bool equal(const T* lhs, const T* rhs) _NOEXCEPT
+					{
+						return lower::equal(lhs, rhs) & (lhs[Rank - 1] == rhs[Rank - 1]);
+					}
+
+					template <typename T>
+					static T product(const T* elems) _NOEXCEPT
+					{
+						return lower::product(elems) * elems[Rank - 1];
+					}
+
+					template <typename T>
+					static bool contains(const T* bnd, const T* idx) _NOEXCEPT
+					{
+						return lower::contains(bnd, idx) & (idx[Rank - 1] >= 0) & (idx[Rank - 1] < bnd[Rank - 1]);
+					}
+
+					// The row major offset of idx in bnd
+					template <typename T>
+					static T linearize(const T* bnd, const T* idx) _NOEXCEPT
+					{
+						return lower::linearize(bnd, idx) * bnd[Rank - 1] + idx[Rank - 1];
+					}
+
+					// The index at the row major offset pos of bnd, the first component takes what is left of pos
+					template <typename T>
+					static void delinearize(const T* bnd, T* idx, T pos) _NOEXCEPT
+					{
+						idx[Rank - 1] = pos % bnd[Rank - 1];
+						lower::delinearize(bnd, idx, pos / bnd[Rank - 1]);
+					}
+
+					// Steps idx to the next index of bnd in row major order, returns true when it wraps over
+					template <typename T>
+					static bool increment(const T* bnd, T* idx) _NOEXCEPT
+					{
+						if (++idx[Rank - 1] < bnd[Rank - 1])
+							return false;
+						idx[Rank - 1] = 0;
+						return lower::increment(bnd, idx);
+					}
+				};
+
+				template <>
+				struct coordinate_ops<1, true>
+				{
+					template <typename T>
+					static void fill(T* elems, T v) _NOEXCEPT
+					{
+						elems[0] = v;
+					}
+
+					template <typename T>
+					static void copy(T* elems, const T* from) _NOEXCEPT
+					{
+						elems[0] = from[0];
+					}
+
+					template <typename T>
+					static void add(T* elems, const T* rhs) _NOEXCEPT
+					{
+						elems[0] += rhs[0];
+					}
+
+					template <typename T>
+					static void subtract(T* elems, const T* rhs) _NOEXCEPT
+					{
+						elems[0] -= rhs[0];
+					}
+
+					template <typename T>
+					static void negate(T* elems) _NOEXCEPT
+					{
+						elems[0] = -elems[0];
+					}
+
+					template <typename T>
+					static void multiply(T* elems, T v) _NOEXCEPT
+					{
+						elems[0] *= v;
+					}
+
+					template <typename T>
+					static void divide(T* elems, T v) _NOEXCEPT
+					{
+						elems[0] /= v;
+					}
+
+					template <typename T>
+					static bool equal(const T* lhs, const T* rhs) _NOEXCEPT
+					{
+						return lhs[0] == rhs[0];
+					}
+
+					template <typename T>
+					static T product(const T* elems) _NOEXCEPT
+					{
+						return elems[0];
+					}
+
+					template <typename T>
+					static bool contains(const T* bnd, const T* idx) _NOEXCEPT
+					{
+						return (idx[0] >= 0) & (idx[0] < bnd[0]);
+					}
+
+					template <typename T>
+					static T linearize(const T*, const T* idx) _NOEXCEPT
+					{
+						return idx[0];
+					}
+
+					template <typename T>
+					static void delinearize(const T*, T* idx, T pos) _NOEXCEPT
+					{
+						idx[0] = pos;
+					}
+
+					template <typename T>
+					static bool increment(const T* bnd, T* idx) _NOEXCEPT
+					{
+						if (++idx[0] < bnd[0])
+							return false;
+						idx[0] = 0;
+						return true;
+					}
+				};
+
+				// The larger ranks loop over the components
+				template <int Rank>
+				struct coordinate_ops<Rank, false>
+				{
+					template <typename T>
+					static void fill(T* elems, T v) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] = v;
+					}
+
+					template <typename T>
+					static void copy(T* elems, const T* from) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] = from[i];
+					}
+
+					template <typename T>
+					static void add(T* elems, const T* rhs) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] += rhs[i];
+					}
+
+					template <typename T>
+					static void subtract(T* elems, const T* rhs) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] -= rhs[i];
+					}
+
+					template <typename T>
+					static void negate(T* elems) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] = -elems[i];
+					}
+
+					template <typename T>
+					static void multiply(T* elems, T v) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] *= v;
+					}
+
+					template <typename T>
+					static void divide(T* elems, T v) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+							elems[i] /= v;
+					}
+
+					template <typename T>
+					static bool equal(const T* lhs, const T* rhs) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+						{
+							if (lhs[i] != rhs[i])
+								return false;
+						}
+						return true;
+					}
+
+					template <typename T>
+					static T product(const T* elems) _NOEXCEPT
+					{
+						T ret = elems[0];
+						for (int i = 1; i < Rank; ++i)
+							ret *= elems[i];
+						return ret;
+					}
+
+					template <typename T>
+					static bool contains(const T* bnd, const T* idx) _NOEXCEPT
+					{
+						for (int i = 0; i < Rank; ++i)
+						{
+							if (idx[i] < 0 || idx[i] >= bnd[i])
+								return false;
+						}
+						return true;
+					}
+
+					template <typename T>
+					static T linearize(const T* bnd, const T* idx) _NOEXCEPT
+					{
+						T ret = idx[0];
+						for (int i = 1; i < Rank; ++i)
+							ret = ret * bnd[i] + idx[i];
+						return ret;
+					}
+
+					template <typename T>
+					static void delinearize(const T* bnd, T* idx, T pos) _NOEXCEPT
+					{
+						for (int i = Rank; i-- > 1;)
+						{
+							idx[i] = pos % bnd[i];
+							pos /= bnd[i];
+						}
+						idx[0] = pos;
+					}
+
+					template <typename T>
+					static bool increment(const T* bnd, T* idx) _NOEXCEPT
+					{
+						for (int i = Rank; i-- > 0;)
+						{
+							if (++idx[i] < bnd[i])
+								return false;
+							idx[i] = 0;
+						}
+						return true;
+					}
+				};
+
 				template <typename ConcreteType, typename ValueType, int Rank>
 				class coordinate_facade
 				{
@@ -27,12 +331,12 @@ namespace std {
 					using size_type       = size_t;
 					using value_type      = ValueType;
 					static const int rank = Rank;
+					using ops             = coordinate_ops<Rank>;
 
 					_CONSTEXPR coordinate_facade() _NOEXCEPT
 					{
 						static_assert(std::is_base_of<coordinate_facade, ConcreteType>::value, "ConcreteType must be derived from coordinate_facade.");
-						for (int i = 0; i < rank; ++i)
-							elems[i] = {};
+						ops::fill(elems, value_type{});
 					}
 
 					_CONSTEXPR coordinate_facade(value_type e0) _NOEXCEPT
@@ -70,12 +374,7 @@ namespace std {
 
 					_CONSTEXPR bool operator==(const ConcreteType& rhs) const _NOEXCEPT
 					{
-						for (int i = 0; i < rank; ++i)
-						{
-							if (elems[i] != rhs.elems[i])
-								return false;
-						}
-						return true;
+						return ops::equal(elems, rhs.elems);
 					}
 
 					_CONSTEXPR bool operator!=(const ConcreteType& rhs) const _NOEXCEPT
@@ -91,8 +390,7 @@ namespace std {
 					_CONSTEXPR ConcreteType operator-() const
 					{
 						ConcreteType ret = to_concrete();
-						for (int i = 0; i < rank; ++i)
-							ret.elems[i] = -ret.elems[i];
+						ops::negate(ret.elems);
 						return ret;
 					}
 
@@ -112,15 +410,13 @@ namespace std {
 
 					_CONSTEXPR ConcreteType& operator+=(const ConcreteType& rhs)
 					{
-						for (int i = 0; i < rank; ++i)
-							elems[i] += rhs.elems[i];
+						ops::add(elems, rhs.elems);
 						return to_concrete();
 					}
 
 					_CONSTEXPR ConcreteType& operator-=(const ConcreteType& rhs)
 					{
-						for (int i = 0; i < rank; ++i)
-							elems[i] -= rhs.elems[i];
+						ops::subtract(elems, rhs.elems);
 						return to_concrete();
 					}
 
@@ -175,15 +471,13 @@ namespace std {
 
 					_CONSTEXPR ConcreteType& operator*=(value_type v)
 					{
-						for (int i = 0; i < rank; ++i)
-							elems[i] *= v;
+						ops::multiply(elems, v);
 						return to_concrete();
 					}
 
 					_CONSTEXPR ConcreteType& operator/=(value_type v)
 					{
-						for (int i = 0; i < rank; ++i)
-							elems[i] /= v;
+						ops::divide(elems, v);
 						return to_concrete();
 					}
 
@@ -465,34 +759,24 @@ namespace std {
 
 				_CONSTEXPR bounds& operator+=(const index<rank>& rhs)
 				{
-					for (int i = 0; i < rank; ++i)
-						Base::elems[i] += rhs[i];
+					Base::ops::add(Base::elems, &rhs[0]);
 					return *this;
 				}
 
 				_CONSTEXPR bounds& operator-=(const index<rank>& rhs)
 				{
-					for (int i = 0; i < rank; ++i)
-						Base::elems[i] -= rhs[i];
+					Base::ops::subtract(Base::elems, &rhs[0]);
 					return *this;
 				}
 
 				_CONSTEXPR size_type size() const _NOEXCEPT
 				{
-					size_type ret = Base::elems[0];
-					for (int i = 1; i < rank; ++i)
-						ret *= Base::elems[i];
-					return ret;
+					return static_cast<size_type>(Base::ops::product(Base::elems));
 				}
 
 				_CONSTEXPR bool contains(const index<rank>& idx) const _NOEXCEPT
 				{
-					for (int i = 0; i < rank; ++i)
-					{
-						if (idx[i] < 0 || idx[i] >= Base::elems[i])
-							return false;
-					}
-					return true;
+					return Base::ops::contains(Base::elems, &idx[0]);
 				}
 
 				const_iterator begin() const _NOEXCEPT
@@ -503,8 +787,7 @@ namespace std {
 				const_iterator end() const _NOEXCEPT
 				{
 					index<rank> idx_end;
-					for (int i = 0; i < rank; ++i)
-						idx_end[i] = (*this)[i];
+					Base::ops::copy(&idx_end[0], Base::elems);
 					return const_iterator{ *this, idx_end };
 				}
 			};
@@ -533,25 +816,17 @@ namespace std {
 					return details::arrow_proxy<index<Rank>>{ curr };
 				}
 
-				bounds_iterator& operator++() _NOEXCEPT
+				// The bounds the iterator walks, the algorithms run a range of them as nested loops
+				const bounds<Rank>& _Bounds() const _NOEXCEPT
 				{
-					for (int i = Rank; i-- > 0;)
-					{
-						if (++curr[i] < bnd[i])
-						{
-							return *this;
-						}
-						else
-						{
-							curr[i] = 0;
-						}
-					}
+					return bnd;
+				}
 
-					// If we're here we've wrapped over - set to past-the-end.
-					for (int i = 0; i < Rank; ++i)
-					{
-						curr[i] = bnd[i];
-					}
+				bounds_iterator& operator++() _NOEXCEPT
+				{
+					// If we've wrapped over - set to past-the-end.
+					if (ops::increment(&bnd[0], &curr[0]))
+						ops::copy(&curr[0], &bnd[0]);
 					return *this;
 				}
 
@@ -597,21 +872,7 @@ namespace std {
 
 				bounds_iterator& operator+=(difference_type n) _NOEXCEPT
 				{
-					auto linear_idx = linearize(curr) + n;
-
-					bounds<Rank> stride;
-					stride[Rank - 1] = 1;
-					for (int i = Rank - 1; i-- > 0;)
-					{
-						stride[i] = stride[i + 1] * bnd[i + 1];
-					}
-
-					for (int i = 0; i < Rank; ++i)
-					{
-						curr[i] = linear_idx / stride[i];
-						linear_idx = linear_idx % stride[i];
-					}
-
+					ops::delinearize(&bnd[0], &curr[0], linearize(curr) + n);
 					return *this;
 				}
 
@@ -678,43 +939,14 @@ namespace std {
 				}
 
 			private:
+				using ops = details::coordinate_ops<Rank>;
+
 				ptrdiff_t linearize(const index<Rank>& idx) const _NOEXCEPT
 				{
-					// TODO: Smarter impl.
-
-					// Check if past-the-end
-					bool pte = true;
-					for (int i = 0; i < Rank; ++i)
-					{
-						if (idx[i] != bnd[i])
-						{
-							pte = false;
-							break;
-						}
-					}
-
-					ptrdiff_t multiplier = 1;
-					ptrdiff_t res = 0;
-
-					if (pte)
-					{
-						res = 1;
-						for (int i = Rank; i-- > 0;)
-						{
-							res += (idx[i] - 1) * multiplier;
-							multiplier *= bnd[i];
-						}
-					}
-					else
-					{
-						for (int i = Rank; i-- > 0;)
-						{
-							res += idx[i] * multiplier;
-							multiplier *= bnd[i];
-						}
-					}
-
-					return res;
+					// The past-the-end index is the bounds themselves and comes right after the last index
+					if (ops::equal(&idx[0], &bnd[0]))
+						return ops::product(&bnd[0]);
+					return ops::linearize(&bnd[0], &idx[0]);
 				}
 
 				bounds<Rank> bnd;
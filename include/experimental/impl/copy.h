@@ -4,7 +4,9 @@
 #define _IMPL_COPY_H_ 1
 
 #include "algorithm_impl.h"
+#include "bulk_memory.h"
 #include "foreach.h"
+#include "transpose.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -20,7 +22,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _Diff, class _OutIt, class _IterCat>
-	inline _OutIt _Copy_n_impl(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _OutIt _Dest, _IterCat _Cat)
+	inline _OutIt _Copy_n_helper(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _OutIt _Dest, _IterCat _Cat, std::false_type)
 	{
 		return std::get<1>(*_For_each_n_impl(_Policy, make_composable_iterator(_First, _Dest), _Count,
 			[](typename composable_iterator<_InIt, _OutIt>::reference _It){
@@ -28,6 +30,23 @@ namespace details {
 		}, _Cat));
 	}
 
+	// The chunks of trivially copyable contiguous ranges are copied by memcpy
+	template<class _ExPolicy, class _InIt, class _Diff, class _OutIt, class _IterCat>
+	inline _OutIt _Copy_n_helper(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _OutIt _Dest, _IterCat, std::true_type)
+	{
+		if (_Count <= 0)
+			return _Dest;
+
+		_Bulk_copy(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Count), _Unwrap_contiguous(_Dest));
+		return _Dest + _Count;
+	}
+
+	template<class _ExPolicy, class _InIt, class _Diff, class _OutIt, class _IterCat>
+	inline _OutIt _Copy_n_impl(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _OutIt _Dest, _IterCat _Cat)
+	{
+		return _Copy_n_helper(_Policy, _First, _Count, _Dest, _Cat, _Is_memcpy_range<_InIt, _OutIt>());
+	}
+
 	template<class _ExPolicy, class _InIt, class _Diff, class _OutIt>
 	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Copy_n_impl(const _ExPolicy&, _InIt _First, _Diff _Count, _OutIt _Dest, std::input_iterator_tag _Cat)
 	{
@@ -80,48 +99,62 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	// The copy stage of copy_if, the elements the filtering stage marked
+	template<class _ExPolicy, class _Iter_type, class _OutIt>
+	inline void _Copy_marked(_Iter_type _Begin, size_t _Count, _OutIt _Out, std::false_type)
+	{
+		LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Count,
+			[&_Out](typename _Iter_type::reference _It){
+
+			if (*std::get<1>(_It)) {
+				*_Out = *std::get<0>(_It);
+				++_Out;
+			}
+		});
+	}
+
+	template<class _ExPolicy, class _Iter_type, class _OutIt>
+	inline void _Copy_marked(_Iter_type _Begin, size_t _Count, _OutIt _Out, std::true_type)
+	{
+		_Compress_chunk(_Begin, _Count, _Out, true);
+	}
+
 	template<class _ExPolicy, class _InIt, class _OutIt, class _Pr, class _IterCat>
-	inline _OutIt _Copy_if_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred, _IterCat)
+	inline _OutIt _Copy_if_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred, _IterCat)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
-		typedef composable_iterator<_InIt, std::vector<difference_type>::iterator > _Iter_type;
+		typedef composable_iterator<_InIt, _Filter_mask_iterator> _Iter_type;
 		typedef _Output_token<_OutIt> _Output_token;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First == _Last)
 			return _Dest;
 
 		auto _Size = std::distance(_First, _Last);
-		std::vector<difference_type> _Filter(_Size);
+		_Filter_mask _Filter(_Size);
 
-		return _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_First, std::begin(_Filter)), _Size, _Output_token(_Dest),
+		return _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Filter.begin()), _Size, _Output_token(_Dest),
 			[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
 
 			difference_type _Sum = 0;
 			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
 				[&_Pred, &_Sum](_Iter_type::reference _It){
 
-				if (_Pred(*std::get<0>(_It))) {
-					*std::get<1>(_It) = _Sum;
+				const bool _Keep = _Pred(*std::get<0>(_It)) ? true : false;
+				*std::get<1>(_It) = _Keep;
+				if (_Keep)
 					++_Sum;
-				}
-				else *std::get<1>(_It) = _Output_token::EMPTY_POSITION;
 			});
 
 			_Output.set_position(_Sum);
 		},
 			[](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage
-			auto _Out = _Dest.get();
-
-			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
-				[&_Out](_Iter_type::reference _It){
-
-				if (*std::get<1>(_It) != _Output_token::EMPTY_POSITION) {
-					*_Out = *std::get<0>(_It);
-					++_Out;
-				}
-			});
-		}).get_result();
+			_Copy_marked<_ExPolicy>(_Begin, _Partition_count, _Dest.get(), _Is_compress_copy<_InIt, _OutIt>());
+		}, _Filter_mask::chunk_size(_Size)).get_result();
 	}
 
 	template<class _ExPolicy, class _InIt, class _OutIt, class _Pr>
@@ -135,11 +168,85 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_Copy_if_impl, _Policy, _First, _Last, _Dest, _Pred, _Cat);
 	}
+
+	//
+	// copy between array views
+	//
+
+	// Copies the segments of a view to another one of the same bounds, as ranges of pointers when
+	// the rows of both are contiguous
+	template<typename _InTy, typename _OutTy, int _Rank>
+	struct _Copy_view_segment
+	{
+		const _View_cursor<_InTy, _Rank>& _Source;
+		const _View_cursor<_OutTy, _Rank>& _Dest;
+
+		void operator()(const D4087::index<_Rank>& _Origin, size_t _Count) const
+		{
+			_InTy *_First = _Source._At(_Origin);
+			_OutTy *_Out = _Dest._At(_Origin);
+			const ptrdiff_t _Step = _Source._Step();
+			const ptrdiff_t _Out_step = _Dest._Step();
+			if (_Step == 1 && _Out_step == 1)
+				std::copy_n(_First, _Count, _Out);
+			else
+				for (size_t _I = 0; _I < _Count; ++_I, _First += _Step, _Out += _Out_step)
+					*_Out = *_First;
+		}
+	};
+
+	template<class _InTy, class _OutTy, int _Rank>
+	inline void _Copy_view_impl(const sequential_execution_policy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view)
+	{
+		const _View_cursor<_InTy, _Rank> _Source(_View);
+		const _View_cursor<_OutTy, _Rank> _Dest(_Dest_view);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Copy_view_segment<_InTy, _OutTy, _Rank> _Segment = { _Source, _Dest };
+
+		_EXP_TRY
+			_Segments._Apply(0, _Segments._Count(), _Segment);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _InTy, class _OutTy, int _Rank>
+	inline void _Copy_view_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view)
+	{
+		const _View_cursor<_InTy, _Rank> _Source(_View);
+		const _View_cursor<_OutTy, _Rank> _Dest(_Dest_view);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Partitioned_for_each_segment(_Policy, _Segments._Count(), 0, [&_Source, &_Dest, &_Segments](size_t _First, size_t _Count, int&) {
+			_Copy_view_segment<_InTy, _OutTy, _Rank> _Segment = { _Source, _Dest };
+			_Segments._Apply(_First, _Count, _Segment);
+		});
+	}
+
+	template<class _InTy, class _OutTy, int _Rank>
+	inline void _Copy_view_impl(const execution_policy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Copy_view_impl, _Policy, _View, _Dest_view);
+	}
+
+	template<class _ExPolicy, class _InTy, class _OutTy, int _Rank>
+	inline void _Copy_view_dispatch(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view)
+	{
+		_Copy_view_impl(_Policy, _View, _Dest_view);
+	}
+
+	// Rows walked with a stride on either side miss the cache on every element, such views are copied by blocks
+	template<class _ExPolicy, class _InTy, class _OutTy>
+	inline void _Copy_view_dispatch(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, 2>& _View, const D4087::strided_array_view<_OutTy, 2>& _Dest_view)
+	{
+		if (_View.stride()[1] == 1 && _Dest_view.stride()[1] == 1)
+			_Copy_view_impl(_Policy, _View, _Dest_view);
+		else
+			_Copy_2d_impl(_Policy, _View, _Dest_view);
+	}
 } // details
 
 template<class _ExPolicy, class _InIt, class _Diff, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type copy_n(_ExPolicy&& _Policy, _InIt _First, _Diff _Count, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("copy_n");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -150,6 +257,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type copy_n(_ExPo
 template<class _ExPolicy, class _InIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -160,12 +268,36 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type copy(_ExPoli
 template<class _ExPolicy, class _InIt, class _OutIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type copy_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("copy_if");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
 	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
 	return details::_Copy_if_impl(_Policy, _First, _Last, _Dest, _Pred, _Cat);
 }
+
+/// <summary>
+///     Copies every element of an array view to the element at the same index of another view of
+///     the same bounds. Two views without gaps are copied as contiguous ranges, two dimensional views with
+///     strided rows are copied by cache sized blocks.
+/// </summary>
+template<class _ExPolicy, class _InView, class _OutView>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type copy(_ExPolicy&& _Policy, const _InView& _View, const _OutView& _Dest_view)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy");
+	static_assert(_InView::rank == _OutView::rank, "Required views of the same rank.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	if (_View.size() == 0)
+		return;
+
+	const auto& _Source = details::_Strided_view(_View);
+	const auto& _Dest = details::_Strided_view(_Dest_view);
+	if (details::_Is_dense_view(_Source) && details::_Is_dense_view(_Dest))
+		details::_Copy_n_impl(_Policy, details::_View_data(_Source), _Source.size(), details::_View_data(_Dest), std::random_access_iterator_tag());
+	else
+		details::_Copy_view_dispatch(_Policy, _Source, _Dest);
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_COPY_H_
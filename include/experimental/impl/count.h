@@ -4,9 +4,108 @@
 #define _IMPL_COUNT_H_ 1
 
 #include "algorithm_impl.h"
+#include "find.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
+
+#if _EXP_SSE2
+	// A compare sets the lanes that hit to -1, subtracting it counts them
+	inline __m128i _Vec_sub_lanes(__m128i _Counters, __m128i _Mask, std::integral_constant<size_t, 1>)
+	{
+		return _mm_sub_epi8(_Counters, _Mask);
+	}
+
+	inline __m128i _Vec_sub_lanes(__m128i _Counters, __m128i _Mask, std::integral_constant<size_t, 2>)
+	{
+		return _mm_sub_epi16(_Counters, _Mask);
+	}
+
+	inline __m128i _Vec_sub_lanes(__m128i _Counters, __m128i _Mask, std::integral_constant<size_t, 4>)
+	{
+		return _mm_sub_epi32(_Counters, _Mask);
+	}
+
+	inline __m128i _Vec_sub_lanes(__m128i _Counters, __m128i _Mask, std::integral_constant<size_t, 8>)
+	{
+		return _mm_sub_epi64(_Counters, _Mask);
+	}
+#endif
+
+	// Number of the _Count elements from _First equal to _Val. The lanes count their matches for up to
+	// 255 vectors, a count that fits the low byte of its lane, and one sum of the bytes adds them all up.
+	template<typename _El>
+	inline size_t _Count_value_vec(const _El *_First, size_t _Count, _El _Val)
+	{
+		size_t _Found = 0;
+		size_t _I = 0;
+#if _EXP_SSE2
+		const size_t _Lanes = sizeof(__m128i) / sizeof(_El);
+		_El _Fill[_Lanes];
+		std::fill(_Fill, _Fill + _Lanes, _Val);
+		const __m128i _Key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Fill));
+		const __m128i _Zero = _mm_setzero_si128();
+		const _Vec_find_lane<_El> _Lane;
+		const std::integral_constant<size_t, sizeof(_El)> _Width;
+
+		while (_I + _Lanes <= _Count) {
+			const size_t _Steps = (std::min)((_Count - _I) / _Lanes, size_t{ 255 });
+			__m128i _Counters = _Zero;
+
+			for (size_t _Step = 0; _Step < _Steps; ++_Step, _I += _Lanes)
+				_Counters = _Vec_sub_lanes(_Counters, _Vec_equal(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_First + _I)), _Key, _Lane), _Width);
+
+			const __m128i _Sums = _mm_sad_epu8(_Counters, _Zero);
+			_Found += static_cast<size_t>(_mm_cvtsi128_si32(_Sums)) + static_cast<size_t>(_mm_cvtsi128_si32(_mm_srli_si128(_Sums, 8)));
+		}
+#endif
+		for (; _I < _Count; ++_I)
+			_Found += _First[_I] == _Val ? 1 : 0;
+
+		return _Found;
+	}
+
+	// The elements of a chunk satisfying the predicate, counted without a branch
+	template<typename _ExPolicy, typename _RanIt, typename _Pr>
+	inline size_t _Count_pred_block(_RanIt _First, size_t _Count, _Pr& _Pred)
+	{
+		size_t _Found = 0;
+
+		LoopHelper<_ExPolicy, _RanIt>::Loop(_First, _Count, [&_Found, &_Pred](const typename std::iterator_traits<_RanIt>::reference _El){
+			_Found += _Pred(_El) ? 1 : 0;
+		});
+
+		return _Found;
+	}
+
+	template<typename _ExPolicy, typename _RanIt, typename _Ty>
+	inline size_t _Count_value_block(_RanIt _First, size_t _Count, _Equal_to_value<_Ty>& _Pred, std::false_type)
+	{
+		return _Count_pred_block<_ExPolicy>(_First, _Count, _Pred);
+	}
+
+	// A value that doesn't survive the conversion to the element type equals none of the elements
+	template<typename _ExPolicy, typename _RanIt, typename _Ty>
+	inline size_t _Count_value_block(_RanIt _First, size_t _Count, _Equal_to_value<_Ty>& _Pred, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _El;
+
+		const _El _Val = static_cast<_El>(_Pred._Val);
+		return (_Count == 0 || !(_Val == _Pred._Val)) ? 0 : _Count_value_vec(_Unwrap_contiguous(_First), _Count, _Val);
+	}
+
+	template<typename _ExPolicy, typename _RanIt, typename _Pr>
+	inline size_t _Count_if_block(_RanIt _First, size_t _Count, _Pr& _Pred)
+	{
+		return _Count_pred_block<_ExPolicy>(_First, _Count, _Pred);
+	}
+
+	template<typename _ExPolicy, typename _RanIt, typename _Ty>
+	inline size_t _Count_if_block(_RanIt _First, size_t _Count, _Equal_to_value<_Ty>& _Pred)
+	{
+		return _Count_value_block<_ExPolicy>(_First, _Count, _Pred, _Is_vector_find<_RanIt, _Ty>());
+	}
+
 	//
 	// count_if
 	//
@@ -19,15 +118,19 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _InIt, class _Pr, class _IterCat>
-	typename std::iterator_traits<_InIt>::difference_type _Count_if_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
+	typename std::iterator_traits<_InIt>::difference_type _Count_if_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_InIt>::difference_type difference_type;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First != _Last) {
 			combinable<difference_type> _Combine;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, std::distance(_First, _Last), _Pred,
+			_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Pred,
 				[&_Combine](_InIt _Begin, size_t _Count, _Pr& _UserPred){
 
 				auto &_CountEl = _Combine.local();
@@ -47,6 +150,25 @@ namespace details {
 		return 0;
 	}
 
+	// Random access ranges count into one slot per chunk
+	template <class _ExPolicy, class _RanIt, class _Pr>
+	typename _enable_if_parallel<_ExPolicy, typename std::iterator_traits<_RanIt>::difference_type>::type _Count_if_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef typename std::iterator_traits<_RanIt>::difference_type difference_type;
+
+		if (_First == _Last)
+			return 0;
+
+		return _Chunked_reduce<difference_type>(_Policy, _First, _Last - _First, _Pred,
+			[](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			return static_cast<difference_type>(_Count_if_block<_ExecutionPolicy>(_Begin, _Count, _UserPred));
+		},
+			[](difference_type _Left, difference_type _Right, _Pr&) {
+			return _Left + _Right;
+		});
+	}
+
 	template <class _ExPolicy, class _InIt, class _Pr>
 	typename _enable_if_parallel<_ExPolicy, typename std::iterator_traits<_InIt>::difference_type>::type _Count_if_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, std::input_iterator_tag _Cat)
 	{
@@ -73,9 +195,7 @@ namespace details {
 	template <class _ExPolicy, class _InIt, class _Ty, class _IterCat>
 	typename std::iterator_traits<_InIt>::difference_type _Count_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, const _Ty& _Val, _IterCat _Cat)
 	{
-		return _Count_if_impl(_Policy, _First, _Last, [&_Val](const typename std::iterator_traits<_InIt>::reference _El){
-			return _Val == _El;
-		}, _Cat);
+		return _Count_if_impl(_Policy, _First, _Last, _Equal_to_value<_Ty>(_Val), _Cat);
 	}
 
 	template <class _ExPolicy, class _InIt, class _Ty, class _IterCat>
@@ -94,6 +214,7 @@ namespace details {
 template <class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, typename std::iterator_traits<_InIt>::difference_type>::type count_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("count_if");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Count_if_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -102,6 +223,7 @@ inline typename details::_enable_if_policy<_ExPolicy, typename std::iterator_tra
 template <class _ExPolicy, class _InIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, typename std::iterator_traits<_InIt>::difference_type>::type count(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("count");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Count_impl(_Policy, _First, _Last, _Val, std::_Iter_cat(_First));
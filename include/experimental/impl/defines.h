@@ -2,8 +2,12 @@
 #ifndef _IMPL_DEFINES_H_
 #define _IMPL_DEFINES_H_
 
-// Export definitions
-#ifdef _PSTL_DLL
+// Export definitions. _PSTL_STATIC links the runtime into the module from the static library instead
+// of the DLL, the library and its users define it, and under whole program optimization the calls to
+// the runtime can inline into the algorithms.
+#if defined(_PSTL_STATIC)
+#define _EXP_IMPL
+#elif defined(_PSTL_DLL)
 #define _EXP_IMPL __declspec(dllexport)
 #else
 #define _EXP_IMPL __declspec(dllimport)
@@ -17,4 +21,69 @@
 #define _PSTL_NS1_END }}}
 #endif
 
+// Inner loops of parallel_vector_execution_policy: the iterations carry no dependences, and the
+// contiguous ranges they walk through raw pointers don't overlap another range of the loop
+#if _MSC_VER >= 1700
+#define _EXP_LOOP_IVDEP __pragma(loop(ivdep))
+#else
+#define _EXP_LOOP_IVDEP
+#endif
+#define _EXP_RESTRICT __restrict
+
+// Loops over callables that can't throw skip the exception handling of their chores, the noexcept
+// operator and specifications need Visual C++ 2015
+#if _MSC_VER >= 1900
+#define _EXP_IS_NOEXCEPT(_Expr) noexcept(_Expr)
+#define _EXP_NOEXCEPT_IF(_Cond) noexcept(_Cond)
+#else
+#define _EXP_IS_NOEXCEPT(_Expr) false
+#define _EXP_NOEXCEPT_IF(_Cond)
+#endif
+
+// The bounds of the random number engines are constant expressions from Visual C++ 2015 on
+#if _MSC_VER >= 1900
+#define _EXP_CONSTEXPR constexpr
+#else
+#define _EXP_CONSTEXPR
+#endif
+
+// The SSE2 kernels of the searches over contiguous arithmetic ranges, every x64 target has SSE2
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+#define _EXP_SSE2 1
+#else
+#define _EXP_SSE2 0
+#endif
+
+// parallel_gpu_execution_policy runs on the accelerators of C++ AMP from Visual C++ 2012 on, _EXP_NO_AMP
+// leaves out the policy and the <amp.h> header
+#if _MSC_VER >= 1700 && !defined(_EXP_NO_AMP) && !defined(_M_CEE)
+#define _EXP_AMP 1
+#else
+#define _EXP_AMP 0
+#endif
+
+// Scheduler and algorithm statistics, see telemetry.h. Off by default: the counters and timers compile away
+// and the statistics read as zeros. The library and the programs using it are built with the same setting.
+#ifndef _EXP_TELEMETRY
+#define _EXP_TELEMETRY 0
+#endif
+
+#if _EXP_TELEMETRY
+#define _EXP_TELEMETRY_ONLY(...) __VA_ARGS__
+#else
+#define _EXP_TELEMETRY_ONLY(...)
+#endif
+
+// Timelines of the chores, see trace.h. Off by default, when it is set the events are recorded once
+// start_tracing is called or an ETW session enables the provider. Set the same way as _EXP_TELEMETRY.
+#ifndef _EXP_TRACE
+#define _EXP_TRACE 0
+#endif
+
+#if _EXP_TRACE
+#define _EXP_TRACE_ONLY(...) __VA_ARGS__
+#else
+#define _EXP_TRACE_ONLY(...)
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#ifndef _IMPL_DESTROY_H_
+#define _IMPL_DESTROY_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+	//
+	// destroy_n
+	//
+	template<class _FwdIt, class _Diff, class _IterCat>
+	inline _FwdIt _Destroy_n_impl(const sequential_execution_policy&, _FwdIt _First, _Diff _Count, _IterCat)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		for (; _Count > 0; --_Count, ++_First)
+			std::addressof(*_First)->~value_type();
+
+		return _First;
+	}
+
+	// The destructors don't throw, the chunks skip the exception handling. A range constructed under an
+	// affinity policy is destroyed by the workers that first touched it.
+	template<class _ExPolicy, class _FwdIt, class _Diff, class _IterCat>
+	inline _FwdIt _Destroy_n_impl(const _ExPolicy& _Policy, _FwdIt _First, _Diff _Count, _IterCat)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		if (_Count <= 0)
+			return _First;
+
+		if (std::is_trivially_destructible<value_type>::value) {
+			std::advance(_First, _Count);
+			return _First;
+		}
+
+		return _Partitioned_for_each(_Policy, _First, static_cast<size_t>(_Count), 0,
+			[](_FwdIt _Begin, size_t _Partition_size, int&) _EXP_NOEXCEPT_IF(true) {
+			_Destroy_range(_Begin, _Partition_size);
+		});
+	}
+
+	template<class _FwdIt, class _Diff, class _IterCat>
+	inline _FwdIt _Destroy_n_impl(const execution_policy& _Policy, _FwdIt _First, _Diff _Count, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Destroy_n_impl, _Policy, _First, _Count, _Cat);
+	}
+} // details
+
+template<class _ExPolicy, class _FwdIt, class _Diff>
+inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type destroy_n(_ExPolicy&& _Policy, _FwdIt _First, _Diff _Count)
+{
+	_EXP_TELEMETRY_ALGORITHM("destroy_n");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	return details::_Destroy_n_impl(_Policy, _First, _Count, std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type destroy(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	_EXP_TELEMETRY_ALGORITHM("destroy");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Destroy_n_impl(_Policy, _First, std::distance(_First, _Last), std::_Iter_cat(_First));
+}
+_PSTL_NS1_END// std::experimental::parallel
+
+#endif // _IMPL_DESTROY_H_
@@ -0,0 +1,308 @@
+#pragma once
+
+#ifndef _IMPL_DISTINCT_H_
+#define _IMPL_DISTINCT_H_ 1
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Elements per shard the tables are sized for, a table of twice as many slots stays in the L2 cache
+	const size_t _Distinct_shard_elements = 16 * 1024;
+
+	const size_t _Distinct_max_shard_bits = 16;
+
+	// The hashes are scrambled before their top bits pick the shard, the hashes of the integers are
+	// often the integers themselves
+	inline std::uint64_t _Scramble_hash(size_t _Hash)
+	{
+		return static_cast<std::uint64_t>(_Hash) * 0x9E3779B97F4A7C15ull;
+	}
+
+	// Keeps the first occurrence of every element of a random access range, in the order of the range.
+	// The elements are hashed and their indices scattered by the top bits of their hashes into shards,
+	// in the order of the range. Every shard is then deduplicated on its own with an open addressing
+	// table, the first index to reach a slot wins. No lock is taken, a shard is owned by one block.
+	template<typename _RanIt, typename _Hasher, typename _Keyeq>
+	class _Parallel_distinct
+	{
+		_RanIt _First;
+		size_t _Size;
+		size_t _Blocks;
+		size_t _Shard_bits;
+		_Hasher& _Hash;
+		_Keyeq& _Eq;
+		std::unique_ptr<std::uint64_t[]> _Hashes;
+		std::unique_ptr<size_t[]> _Order; // the indices, shard after shard
+		std::unique_ptr<unsigned char[]> _Keep;
+		std::vector<size_t> _Counts; // the shards per block, then the place of each run
+		std::vector<size_t> _Shard_begin;
+
+		_Parallel_distinct(const _Parallel_distinct&);
+		_Parallel_distinct& operator=(const _Parallel_distinct&);
+
+		size_t _Block_begin(size_t _Block) const
+		{
+			return _Size / _Blocks * _Block + (std::min)(_Block, _Size % _Blocks);
+		}
+
+		size_t _Shards() const
+		{
+			return size_t{ 1 } << _Shard_bits;
+		}
+
+		size_t _Shard(std::uint64_t _Scrambled) const
+		{
+			return _Shard_bits == 0 ? 0 : static_cast<size_t>(_Scrambled >> (64 - _Shard_bits));
+		}
+
+		void _Scatter()
+		{
+			const size_t _Shard_count = _Shards();
+
+			_Run_blocks(_Blocks, [this, _Shard_count](size_t _Block) {
+				size_t *_Count = _Counts.data() + _Block * _Shard_count;
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+				{
+					_Hashes[_I] = _Scramble_hash(_Hash(_First[_I]));
+					_Keep[_I] = 0;
+					++_Count[_Shard(_Hashes[_I])];
+				}
+			});
+
+			// The runs of a shard follow the order of the blocks, the indices of a shard ascend
+			size_t _Place = 0;
+			for (size_t _Shard_index = 0; _Shard_index < _Shard_count; ++_Shard_index)
+			{
+				_Shard_begin[_Shard_index] = _Place;
+				for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+				{
+					size_t& _Count = _Counts[_Block * _Shard_count + _Shard_index];
+					const size_t _Run = _Count;
+					_Count = _Place;
+					_Place += _Run;
+				}
+			}
+			_Shard_begin[_Shard_count] = _Place;
+
+			_Run_blocks(_Blocks, [this, _Shard_count](size_t _Block) {
+				size_t * const _Place = _Counts.data() + _Block * _Shard_count;
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+					_Order[_Place[_Shard(_Hashes[_I])]++] = _I;
+			});
+		}
+
+		// The bits below the shard's pick the first slot of a table of 2 ^ _Table_bits slots
+		size_t _Home_slot(std::uint64_t _Scrambled, size_t _Table_bits) const
+		{
+			return static_cast<size_t>((_Scrambled << _Shard_bits) >> (64 - _Table_bits));
+		}
+
+		void _Grow(std::vector<size_t>& _Table, size_t& _Table_bits) const
+		{
+			std::vector<size_t> _Old(size_t{ 1 } << ++_Table_bits, 0);
+			_Old.swap(_Table);
+
+			const size_t _Mask = _Table.size() - 1;
+			for (size_t _Held : _Old)
+			{
+				if (_Held != 0)
+				{
+					size_t _Slot = _Home_slot(_Hashes[_Held - 1], _Table_bits);
+					while (_Table[_Slot] != 0)
+						_Slot = (_Slot + 1) & _Mask;
+					_Table[_Slot] = _Held;
+				}
+			}
+		}
+
+		// Slots hold an index plus one, zero is an empty slot. The table starts at twice the elements
+		// of the shard up to its expected size and doubles when it's half full, a shard made of a few
+		// elements repeated many times doesn't take a table of its size.
+		void _Dedup_shard(size_t _Shard_index, std::vector<size_t>& _Table)
+		{
+			const size_t _Begin = _Shard_begin[_Shard_index];
+			const size_t _End = _Shard_begin[_Shard_index + 1];
+			if (_Begin == _End)
+				return;
+
+			size_t _Table_bits = 1;
+			while ((size_t{ 1 } << _Table_bits) < 2 * (std::min)(_End - _Begin, _Distinct_shard_elements))
+				++_Table_bits;
+
+			_Table.assign(size_t{ 1 } << _Table_bits, 0);
+			size_t _Used = 0;
+
+			for (size_t _J = _Begin; _J < _End; ++_J)
+			{
+				const size_t _I = _Order[_J];
+				const std::uint64_t _Scrambled = _Hashes[_I];
+				const size_t _Mask = _Table.size() - 1;
+
+				for (size_t _Slot = _Home_slot(_Scrambled, _Table_bits);; _Slot = (_Slot + 1) & _Mask)
+				{
+					const size_t _Held = _Table[_Slot];
+					if (_Held == 0)
+					{
+						_Table[_Slot] = _I + 1;
+						_Keep[_I] = 1;
+						if (2 * ++_Used > _Table.size())
+							_Grow(_Table, _Table_bits);
+						break;
+					}
+
+					if (_Hashes[_Held - 1] == _Scrambled && _Eq(_First[_Held - 1], _First[_I]))
+						break;
+				}
+			}
+		}
+
+	public:
+		_Parallel_distinct(_RanIt _Begin, size_t _Count, size_t _Block_count, _Hasher& _Hasher_fn, _Keyeq& _Keyeq_fn) :
+			_First(_Begin), _Size(_Count), _Blocks(_Block_count), _Shard_bits(0), _Hash(_Hasher_fn), _Eq(_Keyeq_fn),
+			_Hashes(new std::uint64_t[_Count]), _Order(new size_t[_Count]), _Keep(new unsigned char[_Count])
+		{
+			while (_Shard_bits < _Distinct_max_shard_bits && ((size_t{ 1 } << _Shard_bits) < _Blocks * 4 || (_Size >> _Shard_bits) > _Distinct_shard_elements))
+				++_Shard_bits;
+
+			_Counts.assign(_Blocks * _Shards(), 0);
+			_Shard_begin.resize(_Shards() + 1);
+		}
+
+		// Marks the first occurrences and returns how many there are before every block, and in all
+		std::vector<size_t> _Mark()
+		{
+			_Scatter();
+
+			const size_t _Shard_count = _Shards();
+
+			_Run_blocks(_Blocks, [this, _Shard_count](size_t _Block) {
+				std::vector<size_t> _Table;
+				for (size_t _Shard_index = _Shard_count * _Block / _Blocks, _End = _Shard_count * (_Block + 1) / _Blocks; _Shard_index < _End; ++_Shard_index)
+					_Dedup_shard(_Shard_index, _Table);
+			});
+
+			std::vector<size_t> _Kept(_Blocks + 1);
+			_Run_blocks(_Blocks, [this, &_Kept](size_t _Block) {
+				size_t _Sum = 0;
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+					_Sum += _Keep[_I];
+				_Kept[_Block + 1] = _Sum;
+			});
+
+			for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+				_Kept[_Block + 1] += _Kept[_Block];
+
+			return _Kept;
+		}
+
+		template<typename _OutIt>
+		_OutIt _Copy(_OutIt _Dest, const std::vector<size_t>& _Kept, std::random_access_iterator_tag)
+		{
+			_Run_blocks(_Blocks, [this, _Dest, &_Kept](size_t _Block) {
+				_OutIt _Out = _Dest + _Kept[_Block];
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+				{
+					if (_Keep[_I])
+					{
+						*_Out = _First[_I];
+						++_Out;
+					}
+				}
+			});
+
+			return _Dest + _Kept[_Blocks];
+		}
+
+		// An output iterator is written in order on the calling thread
+		template<typename _OutIt, typename _IterCat>
+		_OutIt _Copy(_OutIt _Dest, const std::vector<size_t>&, _IterCat)
+		{
+			for (size_t _I = 0; _I < _Size; ++_I)
+			{
+				if (_Keep[_I])
+				{
+					*_Dest = _First[_I];
+					++_Dest;
+				}
+			}
+
+			return _Dest;
+		}
+	};
+
+	//
+	// distinct
+	//
+	template<class _InIt, class _OutIt, class _Hasher, class _Keyeq, class _IterCat>
+	inline _OutIt _Distinct_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq, _IterCat)
+	{
+		_EXP_TRY
+			return distinct(_First, _Last, _Dest, _Hash, _Eq);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _RanIt, class _OutIt, class _Hasher, class _Keyeq>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Distinct_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq, std::random_access_iterator_tag)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Last - _First;
+		const size_t _Blocks = (std::min)(static_cast<size_t>(_Policy_thread_count(_Policy)), _Size / _Grain_size(_Policy, 2048));
+
+		if (_Blocks < 2)
+			return _Distinct_impl(seq, _First, _Last, _Dest, _Hash, _Eq, std::random_access_iterator_tag());
+
+		_Parallel_distinct<_RanIt, _Hasher, _Keyeq> _Distinct(_First, _Size, _Blocks, _Hash, _Eq);
+		const std::vector<size_t> _Kept = _Distinct._Mark();
+		return _Distinct._Copy(_Dest, _Kept, std::_Iter_cat(_Dest));
+	}
+
+	// A range without random access is read once into the hash set
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Hasher, class _Keyeq>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Distinct_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq, std::input_iterator_tag _Cat)
+	{
+		return _Distinct_impl(seq, _First, _Last, _Dest, _Hash, _Eq, _Cat);
+	}
+
+	template<class _InIt, class _OutIt, class _Hasher, class _Keyeq, class _IterCat>
+	inline _OutIt _Distinct_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Distinct_impl, _Policy, _First, _Last, _Dest, _Hash, _Eq, _Cat);
+	}
+} // details
+
+// Copies the first occurrence of every element of [_First, _Last) to _Dest, in the order of the range, without
+// sorting it. Elements are the same when their hashes are and _Eq holds for them. Returns the end of the copies.
+template <class _ExPolicy, class _InIt, class _OutIt, class _Hasher, class _Keyeq>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type distinct(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq)
+{
+	_EXP_TELEMETRY_ALGORITHM("distinct");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	return details::_Distinct_impl(_Policy, _First, _Last, _Dest, _Hash, _Eq, std::_Iter_cat(_First));
+}
+
+template <class _ExPolicy, class _InIt, class _OutIt, class _Hasher>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type distinct(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash)
+{
+	_EXP_TELEMETRY_ALGORITHM("distinct");
+	return distinct(std::forward<_ExPolicy>(_Policy), _First, _Last, _Dest, _Hash, std::equal_to<>());
+}
+
+template <class _ExPolicy, class _InIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type distinct(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("distinct");
+	return distinct(std::forward<_ExPolicy>(_Policy), _First, _Last, _Dest, std::hash<typename std::iterator_traits<_InIt>::value_type>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_DISTINCT_H_
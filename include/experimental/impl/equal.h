@@ -4,17 +4,25 @@
 #define _IMPL_EQUAL_H_ 1
 
 #include "algorithm_impl.h"
+#include "mismatch.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
+	// The ranges are equal where memcmp finds no mismatch
 	template<class _ExPolicy, class _InIt, class _InIt2, class _Diff, class _Pr>
-	bool _Equal_helper(const _ExPolicy&, _InIt _First, _InIt2 _First2, _Diff _Count, _Pr _Pred)
+	bool _Equal_helper(const _ExPolicy& _Policy, _InIt _First, _InIt2 _First2, _Diff _Count, _Pr _Pred, std::true_type _Memcmp)
+	{
+		return _Mismatch_impl_helper(_Policy, _First, _Count, _First2, _Pred, _Memcmp) == _Count;
+	}
+
+	template<class _ExPolicy, class _InIt, class _InIt2, class _Diff, class _Pr>
+	bool _Equal_helper(const _ExPolicy& _Policy, _InIt _First, _InIt2 _First2, _Diff _Count, _Pr _Pred, std::false_type)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
 		cancellation_token _Token;
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(make_composable_iterator(_First, _First2), _Count, _Pred,
+		_Partitioned_for_each(_Policy, make_composable_iterator(_First, _First2), _Count, _Pred,
 			[&_Token](details::composable_iterator<_InIt, _InIt2> _Begin, size_t _Count, _Pr& _UserPred){
 
 			LoopHelper<_ExecutionPolicy, composable_iterator<_InIt, _InIt2> >::Loop(_Begin, _Count,
@@ -27,6 +35,12 @@ namespace details {
 		return !_Token.is_cancelled();
 	}
 
+	template<class _ExPolicy, class _InIt, class _InIt2, class _Diff, class _Pr>
+	bool _Equal_helper(const _ExPolicy& _Policy, _InIt _First, _InIt2 _First2, _Diff _Count, _Pr _Pred)
+	{
+		return _Equal_helper(_Policy, _First, _First2, _Count, _Pred, _Is_memcmp_equal<_InIt, _InIt2, _Pr>());
+	}
+
 	//
 	// equal
 	//
@@ -114,6 +128,7 @@ namespace details {
 template <class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("equal");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -123,6 +138,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolic
 template <class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2)
 {
+	_EXP_TELEMETRY_ALGORITHM("equal");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -132,6 +148,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolic
 template <class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("equal");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -141,6 +158,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolic
 template <class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type equal(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("equal");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -9,11 +9,13 @@
 
 _PSTL_NS1_BEGIN
 namespace details {
+	// Spin-then-block event. A waiter polls m_state for a short while before it goes to sleep,
+	// so a set() that comes a few microseconds later costs no kernel transition.
 	class Event
 	{
-		intptr_t m_lock;
+		intptr_t m_lock; // used when the OS has no address waits
 		intptr_t m_cond;
-		bool m_isSet;
+		std::atomic<int> m_state;
 	public:
 		Event(const Event &) = delete;
 		Event &operator =(const Event &) = delete;
@@ -23,32 +25,42 @@ namespace details {
 	};
 
 	// The completin Event will never be reset
+	// The counter is the only word completers touch. The waiter sets the top bit of it when it
+	// is about to sleep, so the completer of the last chore knows whether anybody needs a wake up.
 	class CompletionEvent
 	{
+		static const size_t _Sleeping = ~(~static_cast<size_t>(0) >> 1);
+
 		std::atomic<size_t> m_counter;
-		Event m_event;
+		Event m_event; // wakes the waiter when the OS has no address waits
+
+		_EXP_IMPL void __cdecl wake();
 	public:
 		CompletionEvent(size_t cnt) : m_counter(cnt) {}
 
-		void wait()
+		_EXP_IMPL void __cdecl wait();
+
+		bool is_complete() const
 		{
-			m_event.wait();
+			return m_counter.load(std::memory_order_acquire) == 0;
 		}
 
 		size_t completeOne()
 		{
 			auto cnt = --m_counter;
-			if (cnt != 0)
-				return cnt;
+			if (cnt == _Sleeping)
+			{
+				wake();
+				return 0;
+			}
 
-			_ASSERTE(cnt >= 0);
-			m_event.set();
-			return 0;
+			_ASSERTE(cnt != ~static_cast<size_t>(0));
+			return cnt & ~_Sleeping;
 		}
 
 		size_t addOne()
 		{
-			return ++m_counter;
+			return ++m_counter & ~_Sleeping;
 		}
 	};
 }
@@ -0,0 +1,261 @@
+#pragma once
+
+#ifndef _IMPL_EXTERNAL_SORT_H_
+#define _IMPL_EXTERNAL_SORT_H_ 1
+
+#include <vector>
+#include "algorithm_impl.h"
+#include "copy.h"
+#include "mapped_view.h"
+#include "merge.h"
+#include "sort.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     The limits external_sort works in, the defaults fit a sort that has the machine to itself.
+/// </summary>
+struct external_sort_options
+{
+	size_t memory_bytes; // the buffers of the runs, 0 for half of the available physical memory
+	size_t block_bytes; // the blocks the runs are merged in and read ahead by, 0 for 64 MB
+	const wchar_t *temp_directory; // where the runs are written, nullptr for the temp directory of the user
+
+	external_sort_options() : memory_bytes(0), block_bytes(0), temp_directory(nullptr)
+	{
+	}
+};
+
+namespace details {
+
+	// The file the runs or the output of an external sort are written to with overlapped writes, queued on one
+	// of two slots: the buffer of a slot is filled again after the writes from it are waited for.
+	struct _Sort_file;
+	const unsigned int _Sort_file_slots = 2;
+
+	// Creates the file at _Path, or a temp file in _Directory if _Path is null, and allocates _Bytes for it.
+	// Throws std::system_error when the file can't be created or written.
+	_EXP_IMPL _Sort_file * __cdecl _Create_sort_file(const wchar_t *_Path, const wchar_t *_Directory, unsigned long long _Bytes);
+
+	// Queues the write of _Bytes after the ones before, _Data must stay untouched until the slot is waited for
+	_EXP_IMPL void __cdecl _Write_sort_file(_Sort_file *_File, unsigned int _Slot, const void *_Data, size_t _Bytes);
+
+	_EXP_IMPL void __cdecl _Wait_sort_file(_Sort_file *_File, unsigned int _Slot);
+
+	// Waits for the writes and closes the file, returns its path
+	_EXP_IMPL const wchar_t * __cdecl _Close_sort_file(_Sort_file *_File);
+
+	// Waits for the writes, throwing nothing, and deletes the file if asked to
+	_EXP_IMPL void __cdecl _Release_sort_file(_Sort_file *_File, bool _Remove) _NOEXCEPT;
+
+	_EXP_IMPL size_t __cdecl _Default_sort_memory() _NOEXCEPT;
+
+	const size_t _External_block = 64 * 1024 * 1024;
+
+	// Deletes the file unless it was kept, declared after the buffers it writes from so it waits for them first
+	class _Sort_file_owner
+	{
+		_Sort_file *_File;
+		bool _Remove;
+
+		_Sort_file_owner(const _Sort_file_owner&);
+		_Sort_file_owner& operator=(const _Sort_file_owner&);
+	public:
+		_Sort_file_owner(const wchar_t *_Path, const wchar_t *_Directory, unsigned long long _Bytes)
+			: _File(_Create_sort_file(_Path, _Directory, _Bytes)), _Remove(true)
+		{
+		}
+
+		~_Sort_file_owner()
+		{
+			_Release_sort_file(_File, _Remove);
+		}
+
+		void _Write(unsigned int _Slot, const void *_Data, size_t _Bytes)
+		{
+			_Write_sort_file(_File, _Slot, _Data, _Bytes);
+		}
+
+		void _Wait(unsigned int _Slot)
+		{
+			_Wait_sort_file(_File, _Slot);
+		}
+
+		const wchar_t *_Close()
+		{
+			return _Close_sort_file(_File);
+		}
+
+		void _Keep()
+		{
+			_Remove = false;
+		}
+	};
+
+	//
+	// external_sort
+	//
+	// The input is cut in runs of half the memory, each one copied out of the mapped view, sorted in parallel
+	// and written to a temp file while the next one is sorted in the other half. The runs are merged from the
+	// mapped temp file in blocks, the part of every run the next block needs is read ahead while the current
+	// one is merged and the block before it written.
+	template<class _ExPolicy, class _Ty, class _Pr>
+	void _External_sort_impl(const _ExPolicy& _Policy, const mapped_array_view<const _Ty>& _Input, const wchar_t *_Output, _Pr _Pred, const external_sort_options& _Options)
+	{
+		typedef std::random_access_iterator_tag _Cat;
+		typedef std::pair<const _Ty *, const _Ty *> _Run_range;
+
+		const size_t _Size = static_cast<size_t>(_Input.size());
+		const _Ty *const _Data = _Input.data();
+		const unsigned long long _Bytes = static_cast<unsigned long long>(_Size) * sizeof(_Ty);
+
+		const size_t _Memory = _Options.memory_bytes != 0 ? _Options.memory_bytes : _Default_sort_memory();
+		const size_t _Run = (std::min)((std::max)(_Memory / _Sort_file_slots / sizeof(_Ty), size_t(1)), (std::max)(_Size, size_t(1)));
+		const size_t _Runs = (_Size + _Run - 1) / _Run;
+
+		// The buffers go before the files, which wait for the writes from them when they are released
+		_Uninitialized_buffer<_Ty> _First_buffer(_Run), _Second_buffer;
+		if (_Runs > 1)
+			_Second_buffer._Reserve(_Run);
+		_Ty *const _Buffers[_Sort_file_slots] = { _First_buffer.get(), _Second_buffer.get() };
+
+		if (_Runs <= 1)
+		{
+			_Sort_file_owner _Dest(_Output, nullptr, _Bytes);
+			_Copy_impl(_Policy, _Data, _Data + _Size, _Buffers[0], _Cat());
+			_Sort_impl(_Policy, _Buffers[0], _Buffers[0] + _Size, _Pred, _Cat());
+			_Dest._Write(0, _Buffers[0], _Size * sizeof(_Ty));
+			_Dest._Close();
+			_Dest._Keep();
+			return;
+		}
+
+		_Sort_file_owner _Temp(nullptr, _Options.temp_directory, _Bytes);
+		_Prefetch_chunks_impl(_Policy, reinterpret_cast<const char *>(_Data), _Run * sizeof(_Ty), _Prefetch_window);
+		for (size_t _Index = 0; _Index < _Runs; ++_Index)
+		{
+			const unsigned int _Slot = _Index % _Sort_file_slots;
+			const size_t _Begin = _Index * _Run, _Count = (std::min)(_Run, _Size - _Begin);
+			_Ty *const _Buffer = _Buffers[_Slot];
+
+			_Temp._Wait(_Slot);
+			_Copy_impl(_Policy, _Data + _Begin, _Data + _Begin + _Count, _Buffer, _Cat());
+			if (_Index + 1 < _Runs)
+				_Prefetch_chunks_impl(_Policy, reinterpret_cast<const char *>(_Data + _Begin + _Count),
+					(std::min)(_Run, _Size - _Begin - _Count) * sizeof(_Ty), _Prefetch_window);
+
+			_Sort_impl(_Policy, _Buffer, _Buffer + _Count, _Pred, _Cat());
+			_Temp._Write(_Slot, _Buffer, _Count * sizeof(_Ty));
+		}
+
+		const wchar_t *const _Temp_path = _Temp._Close();
+		{
+			const mapped_array_view<const _Ty> _Sorted(_Temp_path, 0, mapped_access::sequential);
+			_Sort_file_owner _Dest(_Output, nullptr, _Bytes);
+
+			std::vector<_Run_range> _Heads;
+			_Heads.reserve(_Runs);
+			for (size_t _Begin = 0; _Begin < _Size; _Begin += _Run)
+				_Heads.push_back(_Run_range(_Sorted.data() + _Begin, _Sorted.data() + (std::min)(_Begin + _Run, _Size)));
+
+			// Every run is read ahead by at least the prefetch window, and by as much as the last block took of it
+			const size_t _Block_bytes = _Options.block_bytes != 0 ? _Options.block_bytes : _External_block;
+			const size_t _Block = (std::min)((std::max)(_Block_bytes / sizeof(_Ty), size_t(1)), _Run);
+			const size_t _Window = (std::max)(_Prefetch_window / sizeof(_Ty), size_t(1));
+			std::vector<size_t> _Ahead(_Runs, (std::max)(_Block / _Runs, _Window));
+
+			std::vector<_Run_range> _Slice(_Runs);
+			std::vector<_Mapped_range> _Ranges;
+			_Ranges.reserve(_Runs);
+			for (size_t _Done = 0, _Index = 0; _Done < _Size; ++_Index)
+			{
+				const unsigned int _Slot = _Index % _Sort_file_slots;
+				const size_t _Count = (std::min)(_Block, _Size - _Done);
+				const std::vector<size_t> _Split = _Multiway_split(_Heads, _Count, _Pred);
+
+				_Ranges.clear();
+				for (size_t _Run_index = 0; _Run_index < _Runs; ++_Run_index)
+				{
+					const size_t _Left = static_cast<size_t>(_Heads[_Run_index].second - _Heads[_Run_index].first) - _Split[_Run_index];
+					const _Mapped_range _Range = { _Heads[_Run_index].first + _Split[_Run_index], (std::min)(_Ahead[_Run_index], _Left) * sizeof(_Ty) };
+					if (_Range._Bytes != 0)
+						_Ranges.push_back(_Range);
+
+					_Slice[_Run_index] = _Run_range(_Heads[_Run_index].first, _Heads[_Run_index].first + _Split[_Run_index]);
+					_Heads[_Run_index].first += _Split[_Run_index];
+					_Ahead[_Run_index] = (std::max)(_Split[_Run_index], _Window);
+				}
+				if (!_Ranges.empty())
+					_Prefetch_mapped(_Ranges.data(), _Ranges.size());
+
+				_Dest._Wait(_Slot);
+				_Multiway_merge_impl(_Policy, _Slice, _Buffers[_Slot], _Pred, _Cat());
+				_Dest._Write(_Slot, _Buffers[_Slot], _Count * sizeof(_Ty));
+				_Done += _Count;
+			}
+
+			_Dest._Close();
+			_Dest._Keep();
+		}
+	}
+} // details
+
+/// <summary>
+///     Sorts the records of a file that may not fit in memory into the file _Output, replacing it. The records are
+///     sorted in runs of half of memory_bytes by the parallel sort, the runs written to a temp file while the next one
+///     is sorted, then merged in one pass by a parallel multiway merge.
+/// </summary>
+/// <remarks>
+///     The sort is not stable. The output must be another file than the input, it is deleted if the sort throws. The
+///     temp file holds as many bytes as the input and is deleted once merged. A file smaller than one run is sorted
+///     in memory and written at once.
+/// </remarks>
+template<class _ExPolicy, class _Ty, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const mapped_array_view<const _Ty>& _Input,
+	const wchar_t *_Output, _Pr _Pred, const external_sort_options& _Options)
+{
+	_EXP_TELEMETRY_ALGORITHM("external_sort");
+	details::_External_sort_impl(_Policy, _Input, _Output, _Pred, _Options);
+}
+
+template<class _ExPolicy, class _Ty, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const mapped_array_view<const _Ty>& _Input,
+	const wchar_t *_Output, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("external_sort");
+	external_sort(std::forward<_ExPolicy>(_Policy), _Input, _Output, _Pred, external_sort_options());
+}
+
+template<class _ExPolicy, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const mapped_array_view<const _Ty>& _Input,
+	const wchar_t *_Output)
+{
+	_EXP_TELEMETRY_ALGORITHM("external_sort");
+	external_sort(std::forward<_ExPolicy>(_Policy), _Input, _Output, std::less<>(), external_sort_options());
+}
+
+/// <summary>
+///     Sorts the records of type _Ty stored in the file _Input into the file _Output, see above. A partial record at
+///     the end of the input is left out.
+/// </summary>
+template<class _Ty, class _ExPolicy, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const wchar_t *_Input, const wchar_t *_Output,
+	_Pr _Pred, const external_sort_options& _Options)
+{
+	external_sort(std::forward<_ExPolicy>(_Policy), mapped_array_view<const _Ty>(_Input, 0, mapped_access::sequential), _Output, _Pred, _Options);
+}
+
+template<class _Ty, class _ExPolicy, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const wchar_t *_Input, const wchar_t *_Output, _Pr _Pred)
+{
+	external_sort(std::forward<_ExPolicy>(_Policy), mapped_array_view<const _Ty>(_Input, 0, mapped_access::sequential), _Output, _Pred, external_sort_options());
+}
+
+template<class _Ty, class _ExPolicy>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type external_sort(_ExPolicy&& _Policy, const wchar_t *_Input, const wchar_t *_Output)
+{
+	external_sort(std::forward<_ExPolicy>(_Policy), mapped_array_view<const _Ty>(_Input, 0, mapped_access::sequential), _Output, std::less<>(), external_sort_options());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_EXTERNAL_SORT_H_
@@ -4,6 +4,7 @@
 #define _IMPL_FILL_H_ 1
 
 #include "algorithm_impl.h"
+#include "bulk_memory.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -19,13 +20,31 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _OutIt, class _Diff, class _Ty, class _IterCat>
-	inline _OutIt _Fill_n_impl(const _ExPolicy& _Policy, _OutIt _First, _Diff _Count, const _Ty& _Val, _IterCat _Cat)
+	inline _OutIt _Fill_n_helper(const _ExPolicy& _Policy, _OutIt _First, _Diff _Count, const _Ty& _Val, _IterCat _Cat, std::false_type)
 	{
 		return _For_each_n_impl(_Policy, _First, _Count, [&_Val](typename std::iterator_traits<_OutIt>::reference _El){
 			_El = _Val;
 		}, _Cat);
 	}
 
+	// The chunks of trivially copyable contiguous ranges are filled by memset or a raw pointer loop
+	template <class _ExPolicy, class _OutIt, class _Diff, class _Ty, class _IterCat>
+	inline _OutIt _Fill_n_helper(const _ExPolicy& _Policy, _OutIt _First, _Diff _Count, const _Ty& _Val, _IterCat, std::true_type)
+	{
+		if (_Count <= 0)
+			return _First;
+
+		const typename std::iterator_traits<_OutIt>::value_type _Fill_val = _Val;
+		_Bulk_fill(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Count), _Fill_val);
+		return _First + _Count;
+	}
+
+	template <class _ExPolicy, class _OutIt, class _Diff, class _Ty, class _IterCat>
+	inline _OutIt _Fill_n_impl(const _ExPolicy& _Policy, _OutIt _First, _Diff _Count, const _Ty& _Val, _IterCat _Cat)
+	{
+		return _Fill_n_helper(_Policy, _First, _Count, _Val, _Cat, _Is_bulk_fill<_OutIt, _Ty>());
+	}
+
 	template <class _ExPolicy, class _OutIt, class _Diff, class _Ty>
 	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Fill_n_impl(const _ExPolicy&, _OutIt _First, _Diff _Count, const _Ty& _Val, std::output_iterator_tag _Cat)
 	{
@@ -66,11 +85,64 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_Fill_impl, _Policy, _First, _Last, _Val, _Cat);
 	}
+
+	//
+	// fill over an array view
+	//
+
+	// Fills the segments of a view, as ranges of pointers when its rows are contiguous
+	template<typename _Ty, int _Rank, typename _Val>
+	struct _Fill_view_segment
+	{
+		const _View_cursor<_Ty, _Rank>& _Cursor;
+		const _Val& _Value;
+
+		void operator()(const D4087::index<_Rank>& _Origin, size_t _Count) const
+		{
+			_Ty *_First = _Cursor._At(_Origin);
+			const ptrdiff_t _Step = _Cursor._Step();
+			if (_Step == 1)
+				std::fill_n(_First, _Count, _Value);
+			else
+				for (size_t _I = 0; _I < _Count; ++_I, _First += _Step)
+					*_First = _Value;
+		}
+	};
+
+	template <class _Ty, int _Rank, class _Val>
+	inline void _Fill_view_impl(const sequential_execution_policy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, const _Val& _Value)
+	{
+		const _View_cursor<_Ty, _Rank> _Cursor(_View);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Fill_view_segment<_Ty, _Rank, _Val> _Segment = { _Cursor, _Value };
+
+		_EXP_TRY
+			_Segments._Apply(0, _Segments._Count(), _Segment);
+		_EXP_RETHROW
+	}
+
+	template <class _ExPolicy, class _Ty, int _Rank, class _Val>
+	inline void _Fill_view_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, const _Val& _Value)
+	{
+		const _View_cursor<_Ty, _Rank> _Cursor(_View);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Partitioned_for_each_segment(_Policy, _Segments._Count(), 0, [&_Cursor, &_Segments, &_Value](size_t _First, size_t _Count, int&) {
+			_Fill_view_segment<_Ty, _Rank, _Val> _Segment = { _Cursor, _Value };
+			_Segments._Apply(_First, _Count, _Segment);
+		});
+	}
+
+	template <class _Ty, int _Rank, class _Val>
+	inline void _Fill_view_impl(const execution_policy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, const _Val& _Value)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Fill_view_impl, _Policy, _View, _Value);
+	}
 } // details
 
 template <class _ExPolicy, class _OutIt, class _Diff, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type fill_n(_ExPolicy&& _Policy, _OutIt _First, _Diff _Count, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("fill_n");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
 	return details::_Fill_n_impl(_Policy, _First, _Count, _Val, std::_Iter_cat(_First));
@@ -79,10 +151,29 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type fill_n(_ExPo
 template <class _ExPolicy, class _FwdIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type fill(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("fill");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	details::_Fill_impl(_Policy, _First, _Last, _Val, std::_Iter_cat(_First));
 }
+
+/// <summary>
+///     Assigns _Val to every element of an array_view or a strided_array_view. A view without gaps
+///     is filled as one contiguous range.
+/// </summary>
+template <class _ExPolicy, class _ArrayView, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_ArrayView>::type>::type fill(_ExPolicy&& _Policy, const _ArrayView& _View, const _Ty& _Val)
+{
+	_EXP_TELEMETRY_ALGORITHM("fill");
+	if (_View.size() == 0)
+		return;
+
+	const auto& _Strided = details::_Strided_view(_View);
+	if (details::_Is_dense_view(_Strided))
+		details::_Fill_n_impl(_Policy, details::_View_data(_Strided), _Strided.size(), _Val, std::random_access_iterator_tag());
+	else
+		details::_Fill_view_impl(_Policy, _Strided, _Val);
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_FILL_H_
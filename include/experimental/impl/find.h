@@ -3,10 +3,281 @@
 #ifndef _IMPL_FIND_H_
 #define _IMPL_FIND_H_ 1
 
+#include <cstring>
 #include "algorithm_impl.h"
 
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
+
 _PSTL_NS1_BEGIN
 namespace details {
+
+	// The predicate of find, the blocks of a contiguous arithmetic range are searched for the value
+	// with a vector compare instead of calling it on every element
+	template<typename _Ty>
+	struct _Equal_to_value
+	{
+		const _Ty& _Val;
+
+		explicit _Equal_to_value(const _Ty& _Value) : _Val(_Value)
+		{
+		}
+
+		template<typename _El>
+		bool operator()(_El&& _Elem) const
+		{
+			return _Elem == _Val;
+		}
+	};
+
+	// The elements compare to the value bitwise, or as the float and double lanes of SSE2 compare
+	template<typename _It, typename _Ty, typename _El = typename std::iterator_traits<_It>::value_type>
+	struct _Is_vector_find : std::integral_constant<bool, _Contiguous_container_iterator_traits<_It>::value
+		&& ((std::is_integral<_El>::value && !std::is_same<_El, bool>::value && std::is_integral<_Ty>::value && !std::is_same<_Ty, bool>::value)
+			|| ((std::is_same<_El, float>::value || std::is_same<_El, double>::value) && std::is_same<_El, _Ty>::value))>
+	{
+	};
+
+#if _EXP_SSE2
+	// Lane of a vector compare, negative sizes for the floating point lanes
+	template<typename _El>
+	struct _Vec_find_lane : std::integral_constant<int, std::is_floating_point<_El>::value ? -static_cast<int>(sizeof(_El)) : static_cast<int>(sizeof(_El))>
+	{
+	};
+
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, 1>)
+	{
+		return _mm_cmpeq_epi8(_Left, _Right);
+	}
+
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, 2>)
+	{
+		return _mm_cmpeq_epi16(_Left, _Right);
+	}
+
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, 4>)
+	{
+		return _mm_cmpeq_epi32(_Left, _Right);
+	}
+
+	// SSE2 has no 64 bit compare, both halves of a lane must be equal
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, 8>)
+	{
+		const __m128i _Halves = _mm_cmpeq_epi32(_Left, _Right);
+		return _mm_and_si128(_Halves, _mm_shuffle_epi32(_Halves, _MM_SHUFFLE(2, 3, 0, 1)));
+	}
+
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, -4>)
+	{
+		return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(_Left), _mm_castsi128_ps(_Right)));
+	}
+
+	inline __m128i _Vec_equal(__m128i _Left, __m128i _Right, std::integral_constant<int, -8>)
+	{
+		return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(_Left), _mm_castsi128_pd(_Right)));
+	}
+
+	inline size_t _Lowest_set_bit(unsigned int _Mask)
+	{
+#ifdef _MSC_VER
+		unsigned long _Index;
+		_BitScanForward(&_Index, _Mask);
+		return _Index;
+#else
+		return __builtin_ctz(_Mask);
+#endif
+	}
+
+	inline size_t _Highest_set_bit(unsigned int _Mask)
+	{
+#ifdef _MSC_VER
+		unsigned long _Index;
+		_BitScanReverse(&_Index, _Mask);
+		return _Index;
+#else
+		return 31 - __builtin_clz(_Mask);
+#endif
+	}
+#endif
+
+	// Position of the first of the _Count elements from _First equal to _Val, _Count if none is
+	inline size_t _Find_value_vec(const char *_First, size_t _Count, char _Val)
+	{
+		const void *_Hit = std::memchr(_First, static_cast<unsigned char>(_Val), _Count);
+		return _Hit ? static_cast<const char *>(_Hit) - _First : _Count;
+	}
+
+	inline size_t _Find_value_vec(const signed char *_First, size_t _Count, signed char _Val)
+	{
+		return _Find_value_vec(reinterpret_cast<const char *>(_First), _Count, static_cast<char>(_Val));
+	}
+
+	inline size_t _Find_value_vec(const unsigned char *_First, size_t _Count, unsigned char _Val)
+	{
+		return _Find_value_vec(reinterpret_cast<const char *>(_First), _Count, static_cast<char>(_Val));
+	}
+
+	// Four vectors are compared per step, the lowest lane of the step that hit is found after the loop
+	template<typename _El>
+	inline size_t _Find_value_vec(const _El *_First, size_t _Count, _El _Val)
+	{
+		size_t _I = 0;
+#if _EXP_SSE2
+		const size_t _Lanes = sizeof(__m128i) / sizeof(_El);
+		_El _Fill[_Lanes];
+		std::fill(_Fill, _Fill + _Lanes, _Val);
+		const __m128i _Key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Fill));
+		const _Vec_find_lane<_El> _Lane;
+
+		for (; _I + 4 * _Lanes <= _Count; _I += 4 * _Lanes) {
+			const __m128i * const _Data = reinterpret_cast<const __m128i *>(_First + _I);
+			const __m128i _Any = _mm_or_si128(
+				_mm_or_si128(_Vec_equal(_mm_loadu_si128(_Data), _Key, _Lane), _Vec_equal(_mm_loadu_si128(_Data + 1), _Key, _Lane)),
+				_mm_or_si128(_Vec_equal(_mm_loadu_si128(_Data + 2), _Key, _Lane), _Vec_equal(_mm_loadu_si128(_Data + 3), _Key, _Lane)));
+			if (_mm_movemask_epi8(_Any) != 0)
+				break;
+		}
+
+		for (; _I + _Lanes <= _Count; _I += _Lanes) {
+			const unsigned int _Mask = static_cast<unsigned int>(_mm_movemask_epi8(_Vec_equal(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_First + _I)), _Key, _Lane)));
+			if (_Mask != 0)
+				return _I + _Lowest_set_bit(_Mask) / sizeof(_El);
+		}
+#endif
+		for (; _I < _Count; ++_I) {
+			if (_First[_I] == _Val)
+				break;
+		}
+
+		return _I;
+	}
+
+	template<typename _It, typename _Ty, typename _IterCat>
+	inline size_t _Find_value_block(_It& _First, size_t _Count, _Equal_to_value<_Ty>& _Pred, _IterCat _Cat, std::false_type)
+	{
+		return _Find_if_block(_First, _Count, _Pred, _Cat);
+	}
+
+	// A value that doesn't survive the conversion to the element type equals none of the elements
+	template<typename _It, typename _Ty, typename _IterCat>
+	inline size_t _Find_value_block(_It& _First, size_t _Count, _Equal_to_value<_Ty>& _Pred, _IterCat, std::true_type)
+	{
+		typedef typename std::iterator_traits<_It>::value_type _El;
+
+		const _El _Val = static_cast<_El>(_Pred._Val);
+		const size_t _Hit = (_Count == 0 || !(_Val == _Pred._Val)) ? _Count : _Find_value_vec(_Unwrap_contiguous(_First), _Count, _Val);
+
+		std::advance(_First, _Hit);
+		return _Hit;
+	}
+
+	template<typename _It, typename _Pr, typename _IterCat>
+	inline size_t _Find_block(_It& _First, size_t _Count, _Pr& _Pred, _IterCat _Cat)
+	{
+		return _Find_if_block(_First, _Count, _Pred, _Cat);
+	}
+
+	template<typename _It, typename _Ty, typename _IterCat>
+	inline size_t _Find_block(_It& _First, size_t _Count, _Equal_to_value<_Ty>& _Pred, _IterCat _Cat)
+	{
+		return _Find_value_block(_First, _Count, _Pred, _Cat, _Is_vector_find<_It, _Ty>());
+	}
+
+	// The needles of find_first_of on a contiguous range of bytes with the default equality, a bit per byte value.
+	// Up to _Byte_set_vector_max of them, a delimiter set, are kept as bytes too and a block of the range is
+	// compared to all of them at once, a larger set is looked up in the bits one element after the other.
+	const size_t _Byte_set_vector_max = 16;
+
+	template<typename _It, typename _FwdIt, typename _BinPr, typename _El = typename std::iterator_traits<_It>::value_type,
+		typename _Ty = typename std::iterator_traits<_FwdIt>::value_type>
+	struct _Is_vector_find_any : std::integral_constant<bool, _Contiguous_container_iterator_traits<_It>::value
+		&& sizeof(_El) == 1 && std::is_integral<_El>::value && !std::is_same<_El, bool>::value
+		&& std::is_integral<_Ty>::value && !std::is_same<_Ty, bool>::value && std::is_same<_BinPr, std::equal_to<>>::value>
+	{
+	};
+
+	template<typename _El>
+	struct _Equal_to_any_byte
+	{
+		unsigned int _Bits[256 / 32];
+		unsigned char _Bytes[_Byte_set_vector_max];
+		size_t _Count;
+
+		// A needle that doesn't survive the conversion to the element type equals none of the elements
+		template<typename _FwdIt>
+		_Equal_to_any_byte(_FwdIt _First, _FwdIt _Last) : _Count(0)
+		{
+			std::fill(_Bits, _Bits + 256 / 32, 0u);
+			for (; _First != _Last; ++_First) {
+				const _El _Val = static_cast<_El>(*_First);
+				const unsigned char _Byte = static_cast<unsigned char>(_Val);
+				if (!(_Val == *_First) || _Contains(_Byte))
+					continue;
+
+				_Bits[_Byte / 32] |= 1u << (_Byte % 32);
+				if (_Count < _Byte_set_vector_max)
+					_Bytes[_Count] = _Byte;
+				++_Count;
+			}
+		}
+
+		bool _Contains(unsigned char _Byte) const
+		{
+			return (_Bits[_Byte / 32] >> (_Byte % 32) & 1u) != 0;
+		}
+
+		template<typename _Elem>
+		bool operator()(_Elem&& _Elem_val) const
+		{
+			return _Contains(static_cast<unsigned char>(_Elem_val));
+		}
+	};
+
+	// Position of the first of the _Count bytes from _First in the set, _Count if none is. Every byte of a block
+	// is compared to every needle and the compares are or-ed, a block costs a compare per needle.
+	template<typename _El>
+	inline size_t _Find_any_byte_vec(const unsigned char *_First, size_t _Count, const _Equal_to_any_byte<_El>& _Set)
+	{
+		if (_Set._Count == 0)
+			return _Count;
+
+		size_t _I = 0;
+#if _EXP_SSE2
+		if (_Set._Count <= _Byte_set_vector_max) {
+			__m128i _Keys[_Byte_set_vector_max];
+			for (size_t _N = 0; _N < _Set._Count; ++_N)
+				_Keys[_N] = _mm_set1_epi8(static_cast<char>(_Set._Bytes[_N]));
+
+			for (; _I + sizeof(__m128i) <= _Count; _I += sizeof(__m128i)) {
+				const __m128i _Data = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_First + _I));
+				__m128i _Any = _mm_cmpeq_epi8(_Data, _Keys[0]);
+				for (size_t _N = 1; _N < _Set._Count; ++_N)
+					_Any = _mm_or_si128(_Any, _mm_cmpeq_epi8(_Data, _Keys[_N]));
+
+				const unsigned int _Mask = static_cast<unsigned int>(_mm_movemask_epi8(_Any));
+				if (_Mask != 0)
+					return _I + _Lowest_set_bit(_Mask);
+			}
+		}
+#endif
+		for (; _I < _Count; ++_I) {
+			if (_Set._Contains(_First[_I]))
+				break;
+		}
+
+		return _I;
+	}
+
+	template<typename _It, typename _El, typename _IterCat>
+	inline size_t _Find_block(_It& _First, size_t _Count, _Equal_to_any_byte<_El>& _Pred, _IterCat)
+	{
+		const size_t _Hit = _Count == 0 ? 0 : _Find_any_byte_vec(reinterpret_cast<const unsigned char *>(_Unwrap_contiguous(_First)), _Count, _Pred);
+
+		std::advance(_First, _Hit);
+		return _Hit;
+	}
+
 	//
 	// find
 	//
@@ -19,7 +290,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _Pr, class _IterCat>
-	inline _InIt _Find_if_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
+	inline _InIt _Find_if_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_InIt>::difference_type difference_type;
@@ -29,16 +300,27 @@ namespace details {
 			auto _Size = std::distance(_First, _Last);
 			cancellation_token_with_position<difference_type> _Token(_Size);
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Size, _Pred,
 				[&_Token, &_First](_InIt& _Begin, size_t _Count, _Pr& _UserPred){
+				const size_t _Interval = _Cancellation_poll_interval<typename std::iterator_traits<_InIt>::value_type>::value;
 				auto _Dist = std::distance(_First, _Begin);
 
-				for (size_t _Curr_pos = 0; _Curr_pos < _Count; ++_Curr_pos, ++_Begin) {
-					if (_UserPred(*_Begin)) {
-						_Token.cancel(_Dist + _Curr_pos);
+				// A chunk behind a match found already has nothing to look at
+				if (_Token.is_cancelled(_Dist))
+					return;
+
+				// Scan a block without polling, then stop if a match before the next block was found
+				for (size_t _Curr_pos = 0; _Curr_pos < _Count;) {
+					size_t _Block = (std::min)(_Count - _Curr_pos, _Interval);
+					size_t _Hit = _Find_block(_Begin, _Block, _UserPred, _IterCat());
+
+					if (_Hit != _Block) {
+						_Token.cancel(_Dist + _Curr_pos + _Hit);
 						break;
 					}
-					else if (_Token.is_cancelled(_Dist))
+
+					_Curr_pos += _Block;
+					if (_Token.is_cancelled(_Dist + _Curr_pos))
 						break;
 				}
 			});
@@ -77,7 +359,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _FwdIt, class _BinPr, class _IterCat>
-	inline _InIt _Find_first_of_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr _Pred, _IterCat)
+	inline _InIt _Find_first_of_chunks(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr _Pred, _IterCat, std::false_type)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_InIt>::difference_type difference_type;
@@ -87,10 +369,12 @@ namespace details {
 			auto _Size = std::distance(_First, _Last);
 			cancellation_token_with_position<difference_type> _Token(_Size);
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Size, _Pred,
 				[&_Token, &_First, &_First2, &_Last2](typename _InIt& _Begin, size_t _Count, _BinPr _UserPred){
 				auto _Dist = std::distance(_First, _Begin);
 
+				_Cancellation_poll<_InIt> _Poll;
+
 				for (size_t _Curr_pos = 0; _Curr_pos < _Count; ++_Curr_pos, ++_Begin) {
 
 					for (auto _Mid = _First2; _Mid != _Last2; ++_Mid) {
@@ -98,9 +382,10 @@ namespace details {
 							_Token.cancel(_Dist + _Curr_pos);
 							return;
 						}
-						else if (_Token.is_cancelled(_Dist))
-							break;
 					}
+
+					if (_Poll.due() && _Token.is_cancelled(_Dist + _Curr_pos))
+						return;
 				}
 			});
 
@@ -114,6 +399,23 @@ namespace details {
 		return _Last;
 	}
 
+	// A range of bytes is searched for the set of needles as find searches it for a value, in blocks between the
+	// polls of the cancellation token
+	template<class _ExPolicy, class _InIt, class _FwdIt, class _BinPr, class _IterCat>
+	inline _InIt _Find_first_of_chunks(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr, _IterCat _Cat, std::true_type)
+	{
+		if (_First2 == _Last2)
+			return _Last;
+
+		return _Find_if_impl(_Policy, _First, _Last, _Equal_to_any_byte<typename std::iterator_traits<_InIt>::value_type>(_First2, _Last2), _Cat);
+	}
+
+	template<class _ExPolicy, class _InIt, class _FwdIt, class _BinPr, class _IterCat>
+	inline _InIt _Find_first_of_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr _Pred, _IterCat _Cat)
+	{
+		return _Find_first_of_chunks(_Policy, _First, _Last, _First2, _Last2, _Pred, _Cat, _Is_vector_find_any<_InIt, _FwdIt, _BinPr>());
+	}
+
 	template<class _ExPolicy, class _InIt, class _FwdIt, class _BinPr>
 	inline typename _enable_if_parallel<_ExPolicy, _InIt>::type _Find_first_of_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr _Pred, std::input_iterator_tag _Cat)
 	{
@@ -138,7 +440,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _FwdIt, class _FwdIt2, class _BinPr, class _IterCat>
-	inline _FwdIt _Find_end_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _BinPr _Pred, _IterCat)
+	inline _FwdIt _Find_end_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _BinPr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_FwdIt2>::difference_type difference_type;
@@ -153,11 +455,12 @@ namespace details {
 
 		cancellation_token_with_position<difference_type, std::greater_equal<difference_type>> _Token(-1);
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
+		_Partitioned_for_each(_Policy, _First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
 			[&_Token, &_First2, _Count, &_First](_FwdIt& _Begin, size_t _Partition_count, _BinPr _UserPred) {
 
 			auto _Dist = std::distance(_First, _Begin);
 			auto _Offset = _Dist;
+			_Cancellation_poll<_FwdIt> _Poll;
 
 			for (size_t _Curr_pos = 0; _Curr_pos < _Partition_count; ++_Curr_pos, ++_Begin) {
 
@@ -172,7 +475,7 @@ namespace details {
 
 						if (!_UserPred(*_Mid, *_Needle))
 							break;
-						else if (_Token.is_cancelled(_Dist))
+						else if (_Poll.due() && _Token.is_cancelled(_Dist))
 							return;
 					}
 
@@ -182,7 +485,7 @@ namespace details {
 					}
 				} // _Pred
 
-				if (_Token.is_cancelled(_Dist))
+				if (_Poll.due() && _Token.is_cancelled(_Dist))
 					return;
 			}
 		});
@@ -207,16 +510,16 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("find");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
-	return details::_Find_if_impl(_Policy, _First, _Last, [&_Val](typename std::iterator_traits<_InIt>::reference _El){
-		return _El == _Val;
-	}, std::_Iter_cat(_First));
+	return details::_Find_if_impl(_Policy, _First, _Last, details::_Equal_to_value<_Ty>(_Val), std::_Iter_cat(_First));
 }
 
 template<class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_if");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Find_if_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -225,6 +528,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_if(_ExPo
 template<class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_if_not(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_if_not");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Find_if_impl(_Policy, _First, _Last, [_Pred](typename std::iterator_traits<_InIt>::reference _El){
@@ -235,6 +539,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_if_not(_
 template<class _ExPolicy, class _InIt, class _FwdIt, class _BinPr>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_first_of(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2, _BinPr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_first_of");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
@@ -244,12 +549,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_first_of
 template<class _ExPolicy, class _InIt, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type find_first_of(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _FwdIt _First2, _FwdIt _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_first_of");
 	return find_first_of(_Policy, _First, _Last, _First2, _Last2, std::equal_to<>());
 }
 
 template<class _ExPolicy, class _FwdIt, class _FwdIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type find_end(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_end");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt2>::iterator_category>::value, "Required forward iterator or stronger.");
 
@@ -259,6 +566,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type find_end(_Ex
 template<class _ExPolicy, class _FwdIt, class _FwdIt2>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type find_end(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("find_end");
 	return find_end(_Policy, _First, _Last, _First2, _Last2, std::equal_to<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
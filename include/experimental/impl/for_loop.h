@@ -0,0 +1,431 @@
+#pragma once
+
+#ifndef _IMPL_FOR_LOOP_H_
+#define _IMPL_FOR_LOOP_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// The end of a loop converts to the type of its start instead of taking part in the deduction
+	template<typename _Ty>
+	struct _Non_deduced
+	{
+		typedef _Ty type;
+	};
+
+	// Walks the iteration numbers of a loop, the partitioners hand out its chunks as they do the ones of
+	// a random access range
+	class _Iteration_iterator :
+		public std::iterator<std::random_access_iterator_tag, size_t, ptrdiff_t, const size_t *, size_t>
+	{
+		size_t _Pos;
+	public:
+		_Iteration_iterator() : _Pos(0)
+		{
+		}
+
+		explicit _Iteration_iterator(size_t _Start) : _Pos(_Start)
+		{
+		}
+
+		size_t operator*() const
+		{
+			return _Pos;
+		}
+
+		size_t operator[](ptrdiff_t _Off) const
+		{
+			return _Pos + _Off;
+		}
+
+		_Iteration_iterator& operator++()
+		{
+			++_Pos;
+			return *this;
+		}
+
+		_Iteration_iterator operator++(int)
+		{
+			_Iteration_iterator _Tmp = *this;
+			++_Pos;
+			return _Tmp;
+		}
+
+		_Iteration_iterator& operator--()
+		{
+			--_Pos;
+			return *this;
+		}
+
+		_Iteration_iterator operator--(int)
+		{
+			_Iteration_iterator _Tmp = *this;
+			--_Pos;
+			return _Tmp;
+		}
+
+		_Iteration_iterator& operator+=(ptrdiff_t _Off)
+		{
+			_Pos += _Off;
+			return *this;
+		}
+
+		_Iteration_iterator& operator-=(ptrdiff_t _Off)
+		{
+			_Pos -= _Off;
+			return *this;
+		}
+
+		_Iteration_iterator operator+(ptrdiff_t _Off) const
+		{
+			return _Iteration_iterator(_Pos + _Off);
+		}
+
+		_Iteration_iterator operator-(ptrdiff_t _Off) const
+		{
+			return _Iteration_iterator(_Pos - _Off);
+		}
+
+		ptrdiff_t operator-(const _Iteration_iterator& _Right) const
+		{
+			return static_cast<ptrdiff_t>(_Pos - _Right._Pos);
+		}
+
+		bool operator==(const _Iteration_iterator& _Right) const
+		{
+			return _Pos == _Right._Pos;
+		}
+
+		bool operator!=(const _Iteration_iterator& _Right) const
+		{
+			return _Pos != _Right._Pos;
+		}
+
+		bool operator<(const _Iteration_iterator& _Right) const
+		{
+			return _Pos < _Right._Pos;
+		}
+
+		bool operator>(const _Iteration_iterator& _Right) const
+		{
+			return _Pos > _Right._Pos;
+		}
+
+		bool operator<=(const _Iteration_iterator& _Right) const
+		{
+			return _Pos <= _Right._Pos;
+		}
+
+		bool operator>=(const _Iteration_iterator& _Right) const
+		{
+			return _Pos >= _Right._Pos;
+		}
+	};
+
+	// Iterations from _Start by _Stride that stay before _Finish
+	template<typename _Int, typename _Size>
+	inline size_t _Loop_trip_count(_Int _Start, _Int _Finish, _Size _Stride)
+	{
+		_ASSERT(_Stride != 0);
+		if (_Stride > 0)
+			return _Start < _Finish ? static_cast<size_t>(_Finish - _Start - 1) / static_cast<size_t>(_Stride) + 1 : 0;
+
+		return _Finish < _Start ? static_cast<size_t>(_Start - _Finish - 1) / static_cast<size_t>(-_Stride) + 1 : 0;
+	}
+
+	// The index of the iteration _Trip, the unsigned indices wrap around to count down
+	template<typename _Int, typename _Size>
+	inline _Int _Loop_index(_Int _Start, _Size _Stride, size_t _Trip)
+	{
+		return static_cast<_Int>(_Start + static_cast<_Int>(static_cast<_Size>(_Trip) * _Stride));
+	}
+
+	template<typename _ExPolicy>
+	struct _For_loop_helper
+	{
+		template<typename _Int, typename _Size, typename _Fn>
+		static void Loop(_Int _Start, _Size _Stride, size_t _First, size_t _Count, _Fn& _UserFunc)
+		{
+			for (size_t _I = 0; _I < _Count; ++_I)
+				_UserFunc(_Loop_index(_Start, _Stride, _First + _I));
+		}
+	};
+
+	// pragma par
+	template<>
+	struct _For_loop_helper<parallel_execution_policy>
+	{
+		template<typename _Int, typename _Size, typename _Fn>
+		static void Loop(_Int _Start, _Size _Stride, size_t _First, size_t _Count, _Fn& _UserFunc)
+		{
+			_EXP_PRAGMA_PAR
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_UserFunc(_Loop_index(_Start, _Stride, _First + _I));
+		}
+	};
+
+	// pragma par_vec, the indices come from the loop counter so the loop vectorizes like one over an array
+	template<>
+	struct _For_loop_helper<parallel_vector_execution_policy>
+	{
+		template<typename _Int, typename _Size, typename _Fn>
+		static void Loop(_Int _Start, _Size _Stride, size_t _First, size_t _Count, _Fn& _UserFunc)
+		{
+			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_UserFunc(_Loop_index(_Start, _Stride, _First + _I));
+		}
+	};
+
+	template<typename _Ty, typename _BinOp>
+	class _Reduction_variable
+	{
+		_Ty& _Var;
+	public:
+		const _Ty _Identity;
+		const _BinOp _Combiner;
+
+		_Reduction_variable(_Ty& _V, const _Ty& _Id, _BinOp _Op) : _Var(_V), _Identity(_Id), _Combiner(_Op)
+		{
+		}
+
+		// The result of the loop is combined with the value the variable had before it
+		void combine(const _Ty& _Result)
+		{
+			_Var = _Combiner(_Var, _Result);
+		}
+	};
+
+	// A chunk accumulates into a local variable of its own, from the identity
+	template<typename _Fn, typename _Ty, typename _BinOp>
+	struct _For_loop_reduction_data
+	{
+		_Fn _Func;
+		_Ty _Identity;
+		_BinOp _Combiner;
+
+		_For_loop_reduction_data(_Fn _F, const _Ty& _Id, _BinOp _Op) : _Func(_F), _Identity(_Id), _Combiner(_Op)
+		{
+		}
+	};
+
+	//
+	// for_loop
+	//
+	template<class _Int, class _Size, class _Fn>
+	inline void _For_loop_impl(const sequential_execution_policy&, _Int _Start, _Size _Stride, size_t _Trips, _Fn _Func)
+	{
+		_EXP_TRY
+			for (size_t _Trip = 0; _Trip < _Trips; ++_Trip)
+				_Func(_Loop_index(_Start, _Stride, _Trip));
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _Int, class _Size, class _Fn>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _For_loop_impl(const _ExPolicy& _Policy, _Int _Start, _Size _Stride, size_t _Trips, _Fn _Func)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+		if (_Trips == 0)
+			return;
+
+		_Partitioned_for_each(_Policy, _Iteration_iterator(0), _Trips, _Func,
+			[_Start, _Stride](_Iteration_iterator _Begin, size_t _Count, _Fn& _UserFunc) {
+			_For_loop_helper<_ExecutionPolicy>::Loop(_Start, _Stride, *_Begin, _Count, _UserFunc);
+		});
+	}
+
+	template<class _Int, class _Size, class _Fn>
+	inline void _For_loop_impl(const execution_policy& _Policy, _Int _Start, _Size _Stride, size_t _Trips, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_loop_impl, _Policy, _Start, _Stride, _Trips, _Func);
+	}
+
+	//
+	// for_loop with a reduction
+	//
+	template<class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+	inline void _For_loop_reduce_impl(const sequential_execution_policy&, _Int _Start, _Size _Stride, size_t _Trips, _Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+	{
+		_EXP_TRY
+			_Ty _Local = _Reduction._Identity;
+			for (size_t _Trip = 0; _Trip < _Trips; ++_Trip)
+				_Func(_Loop_index(_Start, _Stride, _Trip), _Local);
+			_Reduction.combine(_Local);
+		_EXP_RETHROW
+	}
+
+	// The chunks reduce into slots as reduce does, so the result keeps the order of the iterations. The body
+	// carries the local variable from an iteration to the next, the loop is not marked independent.
+	template<class _ExPolicy, class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _For_loop_reduce_impl(const _ExPolicy& _Policy, _Int _Start, _Size _Stride, size_t _Trips, _Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+	{
+		typedef _For_loop_reduction_data<_Fn, _Ty, _BinOp> _Data;
+
+		if (_Trips == 0)
+			return;
+
+		_Reduction.combine(_Chunked_reduce<_Ty>(_Policy, _Iteration_iterator(0), _Trips, _Data(_Func, _Reduction._Identity, _Reduction._Combiner),
+			[_Start, _Stride](_Iteration_iterator _Begin, size_t _Count, _Data& _User) {
+			_Ty _Local = _User._Identity;
+			for (size_t _Trip = *_Begin, _End = _Trip + _Count; _Trip < _End; ++_Trip)
+				_User._Func(_Loop_index(_Start, _Stride, _Trip), _Local);
+			return _Local;
+		},
+			[](const _Ty& _Left, const _Ty& _Right, _Data& _User) {
+			return _User._Combiner(_Left, _Right);
+		}));
+	}
+
+	template<class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+	inline void _For_loop_reduce_impl(const execution_policy& _Policy, _Int _Start, _Size _Stride, size_t _Trips, _Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_loop_reduce_impl, _Policy, _Start, _Stride, _Trips, _Reduction, _Func);
+	}
+} // details
+
+// A reduction variable of for_loop. Every chunk of the loop gets a local variable starting from _Identity,
+// the body gets it as its second argument. The locals are combined by _Combiner, which must be associative,
+// and the result is combined into _Var.
+template<class _Ty, class _BinOp>
+inline details::_Reduction_variable<_Ty, _BinOp> reduction(_Ty& _Var, const _Ty& _Identity, _BinOp _Combiner)
+{
+	return details::_Reduction_variable<_Ty, _BinOp>(_Var, _Identity, _Combiner);
+}
+
+template<class _Ty>
+inline details::_Reduction_variable<_Ty, std::plus<>> reduction_plus(_Ty& _Var)
+{
+	return reduction(_Var, _Ty(), std::plus<>());
+}
+
+template<class _Ty>
+inline details::_Reduction_variable<_Ty, std::multiplies<>> reduction_multiplies(_Ty& _Var)
+{
+	return reduction(_Var, _Ty(1), std::multiplies<>());
+}
+
+// Calls _Func with the integer indices of [_Start, _Finish) by _Stride, no iterator is built for them.
+// A negative stride counts down to _Finish, the stride can't be 0.
+template<class _ExPolicy, class _Int, class _Size, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_strided(_ExPolicy&& _Policy, _Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Size _Stride, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_strided");
+	static_assert(std::is_integral<_Int>::value, "Required integral indices.");
+	static_assert(std::is_integral<_Size>::value, "Required integral stride.");
+
+	details::_For_loop_impl(_Policy, _Start, _Stride, details::_Loop_trip_count(_Start, _Finish, _Stride), _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_strided(_ExPolicy&& _Policy, _Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Size _Stride, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_strided");
+	static_assert(std::is_integral<_Int>::value, "Required integral indices.");
+	static_assert(std::is_integral<_Size>::value, "Required integral stride.");
+
+	details::_For_loop_reduce_impl(_Policy, _Start, _Stride, details::_Loop_trip_count(_Start, _Finish, _Stride), _Reduction, _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop(_ExPolicy&& _Policy, _Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop");
+	for_loop_strided(_Policy, _Start, _Finish, 1, _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Ty, class _BinOp, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop(_ExPolicy&& _Policy, _Int _Start, typename details::_Non_deduced<_Int>::type _Finish, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop");
+	for_loop_strided(_Policy, _Start, _Finish, 1, _Reduction, _Func);
+}
+
+// The loops of _Count iterations from _Start
+template<class _ExPolicy, class _Int, class _Size, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_n_strided(_ExPolicy&& _Policy, _Int _Start, _Size _Count, _Size _Stride, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_n_strided");
+	static_assert(std::is_integral<_Int>::value, "Required integral indices.");
+	static_assert(std::is_integral<_Size>::value, "Required integral count.");
+
+	details::_For_loop_impl(_Policy, _Start, _Stride, _Count > 0 ? static_cast<size_t>(_Count) : 0, _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_n_strided(_ExPolicy&& _Policy, _Int _Start, _Size _Count, _Size _Stride, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_n_strided");
+	static_assert(std::is_integral<_Int>::value, "Required integral indices.");
+	static_assert(std::is_integral<_Size>::value, "Required integral count.");
+
+	details::_For_loop_reduce_impl(_Policy, _Start, _Stride, _Count > 0 ? static_cast<size_t>(_Count) : 0, _Reduction, _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Size, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_n(_ExPolicy&& _Policy, _Int _Start, _Size _Count, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_n");
+	for_loop_n_strided(_Policy, _Start, _Count, _Size(1), _Func);
+}
+
+template<class _ExPolicy, class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_loop_n(_ExPolicy&& _Policy, _Int _Start, _Size _Count, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_loop_n");
+	for_loop_n_strided(_Policy, _Start, _Count, _Size(1), _Reduction, _Func);
+}
+
+template<class _Int, class _Size, class _Fn>
+inline void for_loop_strided(_Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Size _Stride, _Fn _Func)
+{
+	for_loop_strided(seq, _Start, _Finish, _Stride, _Func);
+}
+
+template<class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline void for_loop_strided(_Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Size _Stride, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	for_loop_strided(seq, _Start, _Finish, _Stride, _Reduction, _Func);
+}
+
+template<class _Int, class _Fn>
+inline void for_loop(_Int _Start, typename details::_Non_deduced<_Int>::type _Finish, _Fn _Func)
+{
+	for_loop_strided(seq, _Start, _Finish, 1, _Func);
+}
+
+template<class _Int, class _Ty, class _BinOp, class _Fn>
+inline void for_loop(_Int _Start, typename details::_Non_deduced<_Int>::type _Finish, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	for_loop_strided(seq, _Start, _Finish, 1, _Reduction, _Func);
+}
+
+template<class _Int, class _Size, class _Fn>
+inline void for_loop_n_strided(_Int _Start, _Size _Count, _Size _Stride, _Fn _Func)
+{
+	for_loop_n_strided(seq, _Start, _Count, _Stride, _Func);
+}
+
+template<class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline void for_loop_n_strided(_Int _Start, _Size _Count, _Size _Stride, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	for_loop_n_strided(seq, _Start, _Count, _Stride, _Reduction, _Func);
+}
+
+template<class _Int, class _Size, class _Fn>
+inline void for_loop_n(_Int _Start, _Size _Count, _Fn _Func)
+{
+	for_loop_n_strided(seq, _Start, _Count, _Size(1), _Func);
+}
+
+template<class _Int, class _Size, class _Ty, class _BinOp, class _Fn>
+inline void for_loop_n(_Int _Start, _Size _Count, details::_Reduction_variable<_Ty, _BinOp> _Reduction, _Fn _Func)
+{
+	for_loop_n_strided(seq, _Start, _Count, _Size(1), _Reduction, _Func);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_FOR_LOOP_H_
@@ -3,10 +3,14 @@
 #ifndef _IMPL_FOREACH_H_
 #define _IMPL_FOREACH_H_ 1
 
+#include <algorithm>
+#include <atomic>
 #include <type_traits>
 #include <iterator>
+#include <utility>
 
 #include "algorithm_impl.h"
+#include "bulk_search.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -51,8 +55,9 @@ namespace details {
 			if (_Count == 0)
 				return;
 			// We are doing this for helping compiler vectorize loops. Vectorizer likes raw pointer more.
-			typename std::iterator_traits<_InIt>::pointer _FirstP = std::addressof(*_First);
+			typename std::iterator_traits<_InIt>::pointer _EXP_RESTRICT _FirstP = _Unwrap_contiguous(_First);
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_UserFunc(_FirstP[_I]);
 		}
@@ -61,11 +66,75 @@ namespace details {
 		static void VecLoopHelper(_InIt _First, size_t _Count, _Fn _UserFunc, std::false_type)
 		{
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_UserFunc(_First[_I]);
 		}
 	};
 
+	// The chunks of segmented iterators run segment by segment through raw pointers
+	template<typename _ExPolicy, typename _Fn>
+	struct _For_each_local
+	{
+		_Fn& _UserFunc;
+
+		template<typename _LocalIt>
+		void operator()(_LocalIt _First, size_t _Count) const
+		{
+			_For_each_helper<_ExPolicy, std::random_access_iterator_tag>::template Loop<_LocalIt, _Fn&>(_First, _Count, _UserFunc);
+		}
+	};
+
+	template<typename _ExPolicy, typename _IterCat, typename _InIt, typename _Fn>
+	inline void _For_each_chunk(_InIt _First, size_t _Count, _Fn& _UserFunc, std::false_type)
+	{
+		_For_each_helper<_ExPolicy, _IterCat>::Loop(_First, _Count, _UserFunc);
+	}
+
+	template<typename _ExPolicy, typename _IterCat, typename _InIt, typename _Fn>
+	inline void _For_each_chunk(_InIt _First, size_t _Count, _Fn& _UserFunc, std::true_type)
+	{
+		_For_each_local<_ExPolicy, _Fn> _Local = { _UserFunc };
+		_For_each_local_segment(_First, _Count, _Local);
+	}
+
+	// Visits _Count indexes of a bounds from the one of _First as nested row-major loops. The innermost
+	// dimension runs without carrying, the outer ones are carried once per row instead of on every
+	// increment of the iterator.
+	template<int _Rank, typename _Fn>
+	inline void _For_each_bounds(D4087::bounds_iterator<_Rank> _First, size_t _Count, _Fn& _UserFunc)
+	{
+		const D4087::bounds<_Rank>& _Bnd = _First._Bounds();
+		D4087::index<_Rank> _Idx = *_First;
+		const D4087::index<_Rank>& _Cur = _Idx;
+
+		while (_Count > 0) {
+			const size_t _Row = (std::min)(_Count, static_cast<size_t>(_Bnd[_Rank - 1] - _Idx[_Rank - 1]));
+			const ptrdiff_t _End = _Idx[_Rank - 1] + static_cast<ptrdiff_t>(_Row);
+			for (; _Idx[_Rank - 1] < _End; ++_Idx[_Rank - 1])
+				_UserFunc(_Cur);
+
+			_Count -= _Row;
+			if (_Count == 0)
+				break;
+
+			_Idx[_Rank - 1] = 0;
+			for (int _Dim = _Rank - 1; _Dim-- > 0;) {
+				if (++_Idx[_Dim] < _Bnd[_Dim])
+					break;
+				_Idx[_Dim] = 0;
+			}
+		}
+	}
+
+	// the iterator of a one dimensional bounds doesn't carry
+	template<typename _Fn>
+	inline void _For_each_bounds(D4087::bounds_iterator<1> _First, size_t _Count, _Fn& _UserFunc)
+	{
+		for (size_t _I = 0; _I < _Count; ++_First, ++_I)
+			_UserFunc(*_First);
+	}
+
 	//
 	//  for_each_n
 	//
@@ -82,13 +151,42 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _Diff, class _Fn, class _IterTag>
-	inline _InIt _For_each_n_impl(const _ExPolicy&, _InIt _First, _Diff _Count, _Fn _Func, _IterTag)
+	inline _InIt _For_each_n_impl(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _Fn _Func, _IterTag)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
 		if (_Count > 0) {
-			return _Partitioner<_ExecutionPolicy>::_For_Each(_First, _Count, _Func, [](_InIt _Begin, size_t _Count, _Fn& _UserFunc) {
-				_For_each_helper<_ExecutionPolicy, _IterTag>::Loop(_Begin, _Count, _UserFunc);
+			// The helpers take a copy of the function
+			return _Partitioned_for_each(_Policy, _First, _Count, _Func, [](_InIt _Begin, size_t _Count, _Fn& _UserFunc)
+				_EXP_NOEXCEPT_IF((_Is_nothrow_element_call<_Fn, _InIt>::value && std::is_nothrow_copy_constructible<_Fn>::value)) {
+				_For_each_chunk<_ExecutionPolicy, _IterTag>(_Begin, _Count, _UserFunc, std::integral_constant<bool, segmented_iterator_traits<_InIt>::is_segmented>());
+			});
+		}
+
+		return _First;
+	}
+
+	template<int _Rank, class _Diff, class _Fn>
+	inline D4087::bounds_iterator<_Rank> _For_each_n_impl(const sequential_execution_policy&, D4087::bounds_iterator<_Rank> _First, _Diff _Count, _Fn _Func, std::random_access_iterator_tag)
+	{
+		if (_Count <= 0)
+			return _First;
+
+		_EXP_TRY
+			_For_each_bounds(_First, static_cast<size_t>(_Count), _Func);
+		_EXP_RETHROW
+
+		return _First + static_cast<ptrdiff_t>(_Count);
+	}
+
+	// Each chunk finds the index of its begin once and runs its elements as nested loops
+	template<class _ExPolicy, int _Rank, class _Diff, class _Fn>
+	inline typename _enable_if_parallel<_ExPolicy, D4087::bounds_iterator<_Rank>>::type _For_each_n_impl(const _ExPolicy& _Policy, D4087::bounds_iterator<_Rank> _First, _Diff _Count, _Fn _Func, std::random_access_iterator_tag)
+	{
+		if (_Count > 0) {
+			return _Partitioned_for_each(_Policy, _First, static_cast<size_t>(_Count), _Func, [](D4087::bounds_iterator<_Rank> _Begin, size_t _Count, _Fn& _UserFunc)
+				_EXP_NOEXCEPT_IF((_Is_nothrow_element_call<_Fn, D4087::bounds_iterator<_Rank>>::value && std::is_nothrow_copy_constructible<_Fn>::value)) {
+				_For_each_bounds(_Begin, _Count, _UserFunc);
 			});
 		}
 
@@ -118,6 +216,12 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	template<int _Rank, class _Fn>
+	inline void _For_each_impl(const sequential_execution_policy& _Policy, D4087::bounds_iterator<_Rank> _First, D4087::bounds_iterator<_Rank> _Last, _Fn _Func, std::random_access_iterator_tag _Cat)
+	{
+		_For_each_n_impl(_Policy, _First, _Last - _First, _Func, _Cat);
+	}
+
 	template<class _ExPolicy, class _InIt, class _Fn, class _IterTag>
 	inline void _For_each_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Fn _Func, _IterTag)
 	{
@@ -135,11 +239,258 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_For_each_impl, _Policy, _First, _Last, _Func, _Cat);
 	}
+
+	//
+	//  for_each with a prefetch hint
+	//
+	// A body that reaches memory through its element, a lookup by index or a pointer chased, misses once per
+	// element when the memory outgrows the caches. The loop hands the element _Distance iterations ahead to the
+	// prefetch functor and prefetches the address it returns, so the misses of consecutive elements overlap.
+	// A distance of 0 is tuned per call site: the first chunks are timed, and the distance covers the latency
+	// of a miss with the work of the elements in between.
+	const size_t _For_each_prefetch_distance = 16; // until the site has been timed
+	const size_t _For_each_prefetch_max_distance = 64;
+	const unsigned int _For_each_prefetch_samples = 8;
+	const unsigned long long _For_each_prefetch_latency_ps = 100000ull; // a miss to memory, 100ns
+
+	// What the timed chunks of a prefetching for_each learned about the cost of its body, a zero initialized static
+	struct _Prefetch_site
+	{
+		std::atomic<unsigned int> _Samples;
+		std::atomic<unsigned long long> _Ps_per_element; // picoseconds, averaged over the samples
+	};
+
+	template<typename _FwdIt, typename _Fn, typename _Pf>
+	inline _Prefetch_site& _Prefetch_site_of()
+	{
+		static _Prefetch_site _Site;
+		return _Site;
+	}
+
+	inline size_t _Prefetch_distance(const _Prefetch_site& _Site)
+	{
+		if (_Site._Samples.load(std::memory_order_relaxed) == 0)
+			return _For_each_prefetch_distance;
+
+		const unsigned long long _Ps = (std::max)(_Site._Ps_per_element.load(std::memory_order_relaxed), 1ull);
+		const unsigned long long _Distance = (_For_each_prefetch_latency_ps + _Ps - 1) / _Ps;
+		return static_cast<size_t>((std::min)(_Distance, static_cast<unsigned long long>(_For_each_prefetch_max_distance)));
+	}
+
+	inline void _Record_prefetch_sample(_Prefetch_site& _Site, size_t _Count, unsigned long long _Elapsed_ps)
+	{
+		// concurrent chunks may lose a sample, the estimate stays close enough
+		const unsigned long long _Ps = (std::max)(_Elapsed_ps / _Count, 1ull);
+		const unsigned int _Sample = (std::min)(_Site._Samples.fetch_add(1, std::memory_order_relaxed), _For_each_prefetch_samples);
+		const unsigned long long _Average = _Site._Ps_per_element.load(std::memory_order_relaxed);
+		_Site._Ps_per_element.store((_Average * _Sample + _Ps) / (_Sample + 1), std::memory_order_relaxed);
+	}
+
+	// Calls _Func(_It) for the iterators of [_First, _First + _Count) in order, and prefetches the address
+	// _Prefetch returns for the element _Distance iterations ahead. The look ahead stops at the end of the run.
+	template<typename _FwdIt, typename _Fn, typename _Pf>
+	inline void _Prefetched_for_each(_FwdIt _First, size_t _Count, _Fn& _Func, const _Pf& _Prefetch, size_t _Distance)
+	{
+		const size_t _Lead = (std::min)(_Distance, _Count);
+		_FwdIt _Ahead = _First;
+		for (size_t _I = 0; _I < _Lead; ++_I, ++_Ahead)
+			_Prefetch_read(_Prefetch(*_Ahead));
+
+		size_t _I = 0;
+		for (; _I + _Lead < _Count; ++_I, ++_First, ++_Ahead)
+		{
+			_Prefetch_read(_Prefetch(*_Ahead));
+			_Func(_First);
+		}
+
+		for (; _I < _Count; ++_I, ++_First)
+			_Func(_First);
+	}
+
+	// Runs the prefetched loop over a chunk, timed while the site of a tuned distance is sampled
+	template<typename _FwdIt, typename _Fn, typename _Pf>
+	inline void _Prefetched_chunk(_FwdIt _First, size_t _Count, _Fn& _Func, const _Pf& _Prefetch, size_t _Distance, _Prefetch_site *_Site)
+	{
+		if (_Site == nullptr || _Count == 0 || _Site->_Samples.load(std::memory_order_relaxed) >= _For_each_prefetch_samples)
+			return _Prefetched_for_each(_First, _Count, _Func, _Prefetch, _Distance);
+
+		const unsigned long long _Start = _Cutoff_clock_ps();
+		_Prefetched_for_each(_First, _Count, _Func, _Prefetch, _Distance);
+		_Record_prefetch_sample(*_Site, _Count, _Cutoff_clock_ps() - _Start);
+	}
+
+	// Calls the user function on the element an iterator of the prefetched loop points to
+	template<typename _Fn>
+	struct _Call_on_element
+	{
+		_Fn& _Func;
+
+		template<typename _It>
+		void operator()(const _It& _Iter) const
+		{
+			_Func(*_Iter);
+		}
+	};
+
+	template<class _InIt, class _Fn, class _Pf, class _IterTag>
+	inline void _For_each_prefetch_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterTag)
+	{
+		_Prefetch_site *_Site = _Distance == 0 ? &_Prefetch_site_of<_InIt, _Fn, _Pf>() : nullptr;
+		if (_Site != nullptr)
+			_Distance = _Prefetch_distance(*_Site);
+
+		_Call_on_element<_Fn> _Call = { _Func };
+		_EXP_TRY
+			_Prefetched_chunk(_First, static_cast<size_t>(std::distance(_First, _Last)), _Call, _Prefetch, _Distance, _Site);
+		_EXP_RETHROW
+	}
+
+	// The distance is decided once per call, the chunks of the call all sample the same one
+	template<class _ExPolicy, class _InIt, class _Fn, class _Pf, class _IterTag>
+	inline void _For_each_prefetch_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterTag)
+	{
+		const size_t _Count = static_cast<size_t>(std::distance(_First, _Last));
+		if (_Count == 0)
+			return;
+
+		_Prefetch_site *_Site = _Distance == 0 ? &_Prefetch_site_of<_InIt, _Fn, _Pf>() : nullptr;
+		if (_Site != nullptr)
+			_Distance = _Prefetch_distance(*_Site);
+
+		_Partitioned_for_each(_Policy, _First, _Count, _Func, [&_Prefetch, _Distance, _Site](_InIt _Begin, size_t _Count, _Fn& _UserFunc) {
+			_Call_on_element<_Fn> _Call = { _UserFunc };
+			_Prefetched_chunk(_Begin, _Count, _Call, _Prefetch, _Distance, _Site);
+		});
+	}
+
+	// An input range can't be looked ahead of
+	template<class _InIt, class _Fn, class _Pf>
+	inline void _For_each_prefetch_impl(const sequential_execution_policy& _Policy, _InIt _First, _InIt _Last, _Fn _Func, _Pf, size_t, std::input_iterator_tag _Cat)
+	{
+		_For_each_impl(_Policy, _First, _Last, _Func, _Cat);
+	}
+
+	template<class _ExPolicy, class _InIt, class _Fn, class _Pf>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _For_each_prefetch_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Fn _Func, _Pf _Prefetch, size_t _Distance, std::input_iterator_tag _Cat)
+	{
+		_For_each_prefetch_impl(seq, _First, _Last, _Func, _Prefetch, _Distance, _Cat);
+	}
+
+	template<class _InIt, class _Fn, class _Pf, class _IterTag>
+	inline void _For_each_prefetch_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterTag _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_each_prefetch_impl, _Policy, _First, _Last, _Func, _Prefetch, _Distance, _Cat);
+	}
+
+	//
+	//  for_each_tile
+	//
+	template<int _Rank, class _Fn>
+	inline void _For_each_tile_impl(const sequential_execution_policy&, const _Tiling<_Rank>& _Tiles, _Fn _Func)
+	{
+		// the iterators of an empty bounds don't meet, there is nothing to visit
+		if (_Tiles._Tiles().size() == 0)
+			return;
+
+		_EXP_TRY
+			for (auto _Tile_idx : _Tiles._Tiles())
+				_Tiles._Apply(_Tile_idx, _Func);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, int _Rank, class _Fn>
+	inline void _For_each_tile_impl(const _ExPolicy& _Policy, const _Tiling<_Rank>& _Tiles, _Fn _Func)
+	{
+		const size_t _Count = _Tiles._Tiles().size();
+		if (_Count > 0) {
+			_Partitioned_for_each(_Policy, std::begin(_Tiles._Tiles()), _Count, _Func, [&_Tiles](D4087::bounds_iterator<_Rank> _Begin, size_t _Count, _Fn& _UserFunc) {
+				for (size_t _I = 0; _I < _Count; ++_Begin, ++_I)
+					_Tiles._Apply(*_Begin, _UserFunc);
+			});
+		}
+	}
+
+	template<int _Rank, class _Fn>
+	inline void _For_each_tile_impl(const execution_policy& _Policy, const _Tiling<_Rank>& _Tiles, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_each_tile_impl, _Policy, _Tiles, _Func);
+	}
+
+	// Calls the user function for every index of a tile, so for_each over bounds visits the
+	// elements tile by tile
+	template<int _Rank, class _Fn>
+	struct _Tile_elements
+	{
+		_Fn _Func;
+
+		void operator()(const D4087::index<_Rank>& _Origin, const D4087::bounds<_Rank>& _Tile)
+		{
+			for (auto _Idx : _Tile)
+				_Func(_Origin + _Idx);
+		}
+	};
+
+	//
+	//  for_each over an array view
+	//
+
+	// Calls the function on the elements of the segments of a view, through the vectorizable loops
+	// of the pointers when its rows are contiguous
+	template<typename _ExPolicy, typename _Ty, int _Rank, typename _Fn>
+	struct _For_each_view_segment
+	{
+		const _View_cursor<_Ty, _Rank>& _Cursor;
+		_Fn& _Func;
+
+		void operator()(const D4087::index<_Rank>& _Origin, size_t _Count) const
+		{
+			_Ty *_First = _Cursor._At(_Origin);
+			const ptrdiff_t _Step = _Cursor._Step();
+			if (_Step == 1)
+				_For_each_helper<_ExPolicy, std::random_access_iterator_tag>::template Loop<_Ty *, _Fn&>(_First, _Count, _Func);
+			else
+				for (size_t _I = 0; _I < _Count; ++_I, _First += _Step)
+					_Func(*_First);
+		}
+	};
+
+	template<class _Ty, int _Rank, class _Fn>
+	inline void _For_each_view_impl(const sequential_execution_policy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, _Fn _Func)
+	{
+		const _View_cursor<_Ty, _Rank> _Cursor(_View);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_For_each_view_segment<sequential_execution_policy, _Ty, _Rank, _Fn> _Segment = { _Cursor, _Func };
+
+		_EXP_TRY
+			_Segments._Apply(0, _Segments._Count(), _Segment);
+		_EXP_RETHROW
+	}
+
+	// The chunks are runs of whole rows, or of pieces of the rows of a view with few of them
+	template<class _ExPolicy, class _Ty, int _Rank, class _Fn>
+	inline void _For_each_view_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, _Fn _Func)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+		const _View_cursor<_Ty, _Rank> _Cursor(_View);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Partitioned_for_each_segment(_Policy, _Segments._Count(), _Func, [&_Cursor, &_Segments](size_t _First, size_t _Count, _Fn& _UserFunc) {
+			_For_each_view_segment<_ExecutionPolicy, _Ty, _Rank, _Fn> _Segment = { _Cursor, _UserFunc };
+			_Segments._Apply(_First, _Count, _Segment);
+		});
+	}
+
+	template<class _Ty, int _Rank, class _Fn>
+	inline void _For_each_view_impl(const execution_policy& _Policy, const D4087::strided_array_view<_Ty, _Rank>& _View, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_each_view_impl, _Policy, _View, _Func);
+	}
 } // details
 
 template <class _ExPolicy, class _InIt, class _Diff, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type for_each_n(_ExPolicy&& _Policy, _InIt _First, _Diff _Count, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("for_each_n");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_For_each_n_impl(_Policy, _First, _Count, _Func, std::_Iter_cat(_First));
@@ -148,10 +499,122 @@ inline typename details::_enable_if_policy<_ExPolicy, _InIt>::type for_each_n(_E
 template<class _ExPolicy, class _InIt, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("for_each");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_For_each_impl(_Policy, _First, _Last, _Func, std::_Iter_cat(_First));
 }
+
+/// <summary>
+///     The functor and distance of the software prefetches of a for_each or transform over a body that reaches
+///     memory through its element, an index into a table or a pointer to a node for instance. The loop calls
+///     _Func with the element it will visit _Distance iterations later and prefetches the address returned.
+/// </summary>
+/// <remarks>
+///     A distance of 0 leaves it to the algorithm, which times the first chunks of the call site and looks ahead
+///     of as many elements as it takes to cover a miss to memory. The look ahead stops at the end of a chunk.
+/// </remarks>
+template<class _Pf>
+class prefetch_hint
+{
+	_Pf _Func;
+	size_t _Distance;
+
+public:
+	explicit prefetch_hint(_Pf _Fn, size_t _Dist = 0) : _Func(std::move(_Fn)), _Distance(_Dist)
+	{
+	}
+
+	const _Pf& prefetcher() const _NOEXCEPT
+	{
+		return _Func;
+	}
+
+	size_t distance() const _NOEXCEPT
+	{
+		return _Distance;
+	}
+};
+
+/// <summary>
+///     The prefetch hint of _Func, which returns the address to prefetch for an element, see prefetch_hint.
+/// </summary>
+template<class _Pf>
+inline prefetch_hint<_Pf> make_prefetch_hint(_Pf _Func, size_t _Distance = 0)
+{
+	return prefetch_hint<_Pf>(std::move(_Func), _Distance);
+}
+
+/// <summary>
+///     Calls _Func for every element of the range and prefetches ahead of it what the hint points to.
+///     An input range is visited without the prefetches.
+/// </summary>
+template<class _ExPolicy, class _InIt, class _Fn, class _Pf>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Fn _Func, const prefetch_hint<_Pf>& _Hint)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+
+	details::_For_each_prefetch_impl(_Policy, _First, _Last, _Func, _Hint.prefetcher(), _Hint.distance(), std::_Iter_cat(_First));
+}
+
+/// <summary>
+///     Splits the bounds into rectangular tiles of _Tile_shape and calls _Func(origin, tile) once per
+///     tile, where origin is the index of the first element of the tile and tile its bounds.
+///     The tiles at the far edges are cut to the bounds.
+/// </summary>
+template<class _ExPolicy, int _Rank, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each_tile(_ExPolicy&& _Policy, const D4087::bounds<_Rank>& _Bnd, const D4087::index<_Rank>& _Tile_shape, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each_tile");
+	details::_For_each_tile_impl(_Policy, details::_Tiling<_Rank>(_Bnd, _Tile_shape), _Func);
+}
+
+/// <summary>
+///     Calls _Func(origin, tile) once per tile of a shape derived from the size of the first level caches.
+/// </summary>
+template<class _ExPolicy, int _Rank, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each_tile(_ExPolicy&& _Policy, const D4087::bounds<_Rank>& _Bnd, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each_tile");
+	for_each_tile(_Policy, _Bnd, details::_Default_tile_shape(_Bnd), _Func);
+}
+
+/// <summary>
+///     Calls _Func for every index of the bounds, visiting them tile by tile rather than row by row.
+/// </summary>
+template<class _ExPolicy, int _Rank, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, const D4087::bounds<_Rank>& _Bnd, const D4087::index<_Rank>& _Tile_shape, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	details::_Tile_elements<_Rank, _Fn> _Elements = { _Func };
+	for_each_tile(_Policy, _Bnd, _Tile_shape, _Elements);
+}
+
+template<class _ExPolicy, int _Rank, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, const D4087::bounds<_Rank>& _Bnd, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	for_each(_Policy, _Bnd, details::_Default_tile_shape(_Bnd), _Func);
+}
+
+/// <summary>
+///     Calls _Func for every element of an array_view or a strided_array_view. A view without gaps
+///     is run as one contiguous range, the others row by row with the stride of their innermost dimension.
+/// </summary>
+template<class _ExPolicy, class _ArrayView, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_ArrayView>::type>::type for_each(_ExPolicy&& _Policy, const _ArrayView& _View, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	if (_View.size() == 0)
+		return;
+
+	const auto& _Strided = details::_Strided_view(_View);
+	if (details::_Is_dense_view(_Strided))
+		details::_For_each_n_impl(_Policy, details::_View_data(_Strided), _Strided.size(), _Func, std::random_access_iterator_tag());
+	else
+		details::_For_each_view_impl(_Policy, _Strided, _Func);
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_FOREACH_H_
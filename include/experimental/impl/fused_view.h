@@ -0,0 +1,587 @@
+#pragma once
+
+#ifndef _IMPL_FUSED_VIEW_H_
+#define _IMPL_FUSED_VIEW_H_ 1
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// The views of the views namespace. A view holds the source range and the functions, an algorithm walks
+	// the source by chunks and sends every source element down the chain of functions, one fused loop per chunk
+	// without temporaries. Every view gives:
+	//   _Apply(_Ref, _Sink)  calls _Sink with the value of the element if the filters keep it
+	//   _Test(_Ref)          tells if the filters keep the element
+	//   _Project(_Ref)       the value of the element, filters left out
+	struct _Fused_view_base
+	{
+	};
+
+	template<typename _Ty>
+	struct _Is_fused_view : std::is_base_of<_Fused_view_base, typename std::decay<_Ty>::type>
+	{
+	};
+
+	template<typename _View, typename _Ty = void>
+	struct _enable_if_fused_view : std::enable_if<_Is_fused_view<_View>::value, _Ty>
+	{
+	};
+
+	// A random access range, the first view of a chain
+	template<typename _RanIt>
+	class _Range_source : public _Fused_view_base
+	{
+		_RanIt _First;
+		size_t _Count;
+
+	public:
+		static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+
+		typedef _RanIt _Source_iterator;
+		typedef typename std::iterator_traits<_RanIt>::reference _Source_reference;
+		typedef _Source_reference _Projected;
+		typedef typename std::iterator_traits<_RanIt>::value_type value_type;
+		static const bool _Filters = false;
+
+		_Range_source(_RanIt _Begin, _RanIt _End) : _First(_Begin), _Count(static_cast<size_t>(_End - _Begin))
+		{
+		}
+
+		_RanIt _Source_begin() const
+		{
+			return _First;
+		}
+
+		size_t _Source_size() const
+		{
+			return _Count;
+		}
+
+		template<typename _Sink>
+		void _Apply(_Source_reference _Elem, _Sink& _Next) const
+		{
+			_Next(_Elem);
+		}
+
+		bool _Test(_Source_reference) const
+		{
+			return true;
+		}
+
+		_Projected _Project(_Source_reference _Elem) const
+		{
+			return _Elem;
+		}
+	};
+
+	template<typename _Fn, typename _Sink>
+	class _Transform_sink
+	{
+		const _Fn& _Func;
+		_Sink& _Next;
+
+		_Transform_sink& operator=(const _Transform_sink&);
+	public:
+		_Transform_sink(const _Fn& _F, _Sink& _S) : _Func(_F), _Next(_S)
+		{
+		}
+
+		template<typename _Ty>
+		void operator()(_Ty&& _Val)
+		{
+			_Next(_Func(std::forward<_Ty>(_Val)));
+		}
+	};
+
+	template<typename _Pr, typename _Sink>
+	class _Filter_sink
+	{
+		const _Pr& _Pred;
+		_Sink& _Next;
+
+		_Filter_sink& operator=(const _Filter_sink&);
+	public:
+		_Filter_sink(const _Pr& _P, _Sink& _S) : _Pred(_P), _Next(_S)
+		{
+		}
+
+		template<typename _Ty>
+		void operator()(_Ty&& _Val)
+		{
+			if (_Pred(_Val))
+				_Next(std::forward<_Ty>(_Val));
+		}
+	};
+
+	template<typename _Base, typename _Fn>
+	class _Transform_view : public _Fused_view_base
+	{
+		_Base _Inner;
+		_Fn _Func;
+
+	public:
+		typedef typename _Base::_Source_iterator _Source_iterator;
+		typedef typename _Base::_Source_reference _Source_reference;
+		typedef typename std::decay<decltype(std::declval<const _Fn&>()(std::declval<typename _Base::_Projected>()))>::type value_type;
+		typedef value_type _Projected;
+		static const bool _Filters = _Base::_Filters;
+
+		_Transform_view(const _Base& _In, const _Fn& _F) : _Inner(_In), _Func(_F)
+		{
+		}
+
+		_Source_iterator _Source_begin() const
+		{
+			return _Inner._Source_begin();
+		}
+
+		size_t _Source_size() const
+		{
+			return _Inner._Source_size();
+		}
+
+		template<typename _Sink>
+		void _Apply(_Source_reference _Elem, _Sink& _Next) const
+		{
+			_Transform_sink<_Fn, _Sink> _Stage(_Func, _Next);
+			_Inner._Apply(_Elem, _Stage);
+		}
+
+		// The function runs once the element is kept, not to test it
+		bool _Test(_Source_reference _Elem) const
+		{
+			return _Inner._Test(_Elem);
+		}
+
+		_Projected _Project(_Source_reference _Elem) const
+		{
+			return _Func(_Inner._Project(_Elem));
+		}
+	};
+
+	template<typename _Base, typename _Pr>
+	class _Filter_view : public _Fused_view_base
+	{
+		_Base _Inner;
+		_Pr _Pred;
+
+	public:
+		typedef typename _Base::_Source_iterator _Source_iterator;
+		typedef typename _Base::_Source_reference _Source_reference;
+		typedef typename _Base::_Projected _Projected;
+		typedef typename _Base::value_type value_type;
+		static const bool _Filters = true;
+
+		_Filter_view(const _Base& _In, const _Pr& _P) : _Inner(_In), _Pred(_P)
+		{
+		}
+
+		_Source_iterator _Source_begin() const
+		{
+			return _Inner._Source_begin();
+		}
+
+		size_t _Source_size() const
+		{
+			return _Inner._Source_size();
+		}
+
+		template<typename _Sink>
+		void _Apply(_Source_reference _Elem, _Sink& _Next) const
+		{
+			_Filter_sink<_Pr, _Sink> _Stage(_Pred, _Next);
+			_Inner._Apply(_Elem, _Stage);
+		}
+
+		bool _Test(_Source_reference _Elem) const
+		{
+			return _Inner._Test(_Elem) && _Pred(_Inner._Project(_Elem));
+		}
+
+		_Projected _Project(_Source_reference _Elem) const
+		{
+			return _Inner._Project(_Elem);
+		}
+	};
+
+	// A view is taken as it is, a container becomes the source of a new chain
+	template<typename _Range, bool = _Is_fused_view<_Range>::value>
+	struct _View_of
+	{
+		static_assert(std::is_lvalue_reference<_Range>::value, "Required a view or a container that outlives the view.");
+
+		typedef _Range_source<decltype(std::begin(std::declval<_Range>()))> type;
+
+		static type _Make(_Range _Rng)
+		{
+			return type(std::begin(_Rng), std::end(_Rng));
+		}
+	};
+
+	template<typename _Range>
+	struct _View_of<_Range, true>
+	{
+		typedef typename std::decay<_Range>::type type;
+
+		static const type& _Make(const type& _View)
+		{
+			return _View;
+		}
+	};
+
+	// Folds the values of a chunk into the thread's partial result, the first value of the chunk
+	// finds the result
+	template<typename _Ty, typename _BinOp>
+	class _Reduce_sink
+	{
+		combinable<_Ty>& _Combine;
+		_BinOp& _Op;
+		_Ty *_Sum;
+
+		_Reduce_sink& operator=(const _Reduce_sink&);
+	public:
+		_Reduce_sink(combinable<_Ty>& _C, _BinOp& _O) : _Combine(_C), _Op(_O), _Sum(nullptr)
+		{
+		}
+
+		template<typename _Val>
+		void operator()(_Val&& _Elem)
+		{
+			if (_Sum != nullptr) {
+				*_Sum = _Op(*_Sum, std::forward<_Val>(_Elem));
+				return;
+			}
+
+			bool _Exists;
+			_Sum = &_Combine.local(_Exists);
+			if (_Exists)
+				*_Sum = _Op(*_Sum, std::forward<_Val>(_Elem));
+			else
+				*_Sum = std::forward<_Val>(_Elem);
+		}
+	};
+
+	template<typename _Fn>
+	class _For_each_sink
+	{
+		_Fn& _Func;
+
+		_For_each_sink& operator=(const _For_each_sink&);
+	public:
+		explicit _For_each_sink(_Fn& _F) : _Func(_F)
+		{
+		}
+
+		template<typename _Val>
+		void operator()(_Val&& _Elem)
+		{
+			_Func(std::forward<_Val>(_Elem));
+		}
+	};
+
+	template<typename _Ty, typename _BinOp>
+	class _Sequential_reduce_sink
+	{
+		_Ty& _Sum;
+		_BinOp& _Op;
+
+		_Sequential_reduce_sink& operator=(const _Sequential_reduce_sink&);
+	public:
+		_Sequential_reduce_sink(_Ty& _S, _BinOp& _O) : _Sum(_S), _Op(_O)
+		{
+		}
+
+		template<typename _Val>
+		void operator()(_Val&& _Elem)
+		{
+			_Sum = _Op(_Sum, std::forward<_Val>(_Elem));
+		}
+	};
+
+	template<typename _OutIt>
+	class _Copy_sink
+	{
+		_OutIt& _Dest;
+
+		_Copy_sink& operator=(const _Copy_sink&);
+	public:
+		explicit _Copy_sink(_OutIt& _D) : _Dest(_D)
+		{
+		}
+
+		template<typename _Val>
+		void operator()(_Val&& _Elem)
+		{
+			*_Dest = std::forward<_Val>(_Elem);
+			++_Dest;
+		}
+	};
+
+	//
+	// reduce
+	//
+	template<class _View, class _Ty, class _BinOp>
+	inline _Ty _Fused_reduce_impl(const sequential_execution_policy&, const _View& _Vw, _Ty _Init, _BinOp _Op)
+	{
+		_EXP_TRY
+			auto _First = _Vw._Source_begin();
+			_Sequential_reduce_sink<_Ty, _BinOp> _Sink(_Init, _Op);
+			for (size_t _I = 0, _Count = _Vw._Source_size(); _I < _Count; ++_I)
+				_Vw._Apply(_First[_I], _Sink);
+		_EXP_RETHROW
+
+		return _Init;
+	}
+
+	// The values of a chunk are folded as the chunk produces them, a chunk the filters empty leaves the
+	// partial result of its thread alone
+	template<class _ExPolicy, class _View, class _Ty, class _BinOp>
+	inline _Ty _Fused_reduce_impl(const _ExPolicy& _Policy, const _View& _Vw, _Ty _Init, _BinOp _Op)
+	{
+		typedef typename _View::_Source_iterator _Source_iterator;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		if (_Vw._Source_size() == 0)
+			return _Init;
+
+		// There is not requirement for _Ty to be default constructible thus combinable needs to be initialized with _Init value
+		combinable<_Ty> _Combine([_Init]{ return _Init; });
+
+		_Partitioned_for_each(_Policy, _Vw._Source_begin(), _Vw._Source_size(), _Op,
+			[&_Combine, &_Vw](_Source_iterator _Begin, size_t _Count, _BinOp& _UserOp) {
+			_Reduce_sink<_Ty, _BinOp> _Sink(_Combine, _UserOp);
+			for (size_t _I = 0; _I < _Count; ++_I)
+				_Vw._Apply(_Begin[_I], _Sink);
+		});
+
+		bool _Any = false;
+		_Combine.combine_each([&_Any](const _Ty&) { _Any = true; });
+		return _Any ? _Op(_Init, _Combine.combine(_Op)) : _Init;
+	}
+
+	template<class _View, class _Ty, class _BinOp>
+	inline _Ty _Fused_reduce_impl(const execution_policy& _Policy, const _View& _Vw, _Ty _Init, _BinOp _Op)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Fused_reduce_impl, _Policy, _Vw, _Init, _Op);
+	}
+
+	//
+	// for_each
+	//
+	template<class _View, class _Fn>
+	inline void _Fused_for_each_impl(const sequential_execution_policy&, const _View& _Vw, _Fn _Func)
+	{
+		_EXP_TRY
+			auto _First = _Vw._Source_begin();
+			_For_each_sink<_Fn> _Sink(_Func);
+			for (size_t _I = 0, _Count = _Vw._Source_size(); _I < _Count; ++_I)
+				_Vw._Apply(_First[_I], _Sink);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _View, class _Fn>
+	inline void _Fused_for_each_impl(const _ExPolicy& _Policy, const _View& _Vw, _Fn _Func)
+	{
+		typedef typename _View::_Source_iterator _Source_iterator;
+
+		if (_Vw._Source_size() == 0)
+			return;
+
+		_Partitioned_for_each(_Policy, _Vw._Source_begin(), _Vw._Source_size(), _Func,
+			[&_Vw](_Source_iterator _Begin, size_t _Count, _Fn& _UserFunc) {
+			_For_each_sink<_Fn> _Sink(_UserFunc);
+			for (size_t _I = 0; _I < _Count; ++_I)
+				_Vw._Apply(_Begin[_I], _Sink);
+		});
+	}
+
+	template<class _View, class _Fn>
+	inline void _Fused_for_each_impl(const execution_policy& _Policy, const _View& _Vw, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Fused_for_each_impl, _Policy, _Vw, _Func);
+	}
+
+	//
+	// copy
+	//
+	template<class _View, class _OutIt>
+	inline _OutIt _Fused_copy_impl(const sequential_execution_policy&, const _View& _Vw, _OutIt _Dest)
+	{
+		_EXP_TRY
+			auto _First = _Vw._Source_begin();
+			_Copy_sink<_OutIt> _Sink(_Dest);
+			for (size_t _I = 0, _Count = _Vw._Source_size(); _I < _Count; ++_I)
+				_Vw._Apply(_First[_I], _Sink);
+		_EXP_RETHROW
+
+		return _Dest;
+	}
+
+	// Without a filter every element has its place, the chunks write their values without counting them
+	template<class _ExPolicy, class _View, class _OutIt>
+	inline _OutIt _Fused_copy_impl(const _ExPolicy& _Policy, const _View& _Vw, _OutIt _Dest, std::false_type)
+	{
+		typedef typename _View::_Source_iterator _Source_iterator;
+
+		const size_t _Count = _Vw._Source_size();
+		_Partitioned_for_each(_Policy, _Vw._Source_begin(), _Count, _Dest,
+			[&_Vw](_Source_iterator _Begin, size_t _Chunk_count, _OutIt& _Out) {
+			const size_t _Offset = static_cast<size_t>(_Begin - _Vw._Source_begin());
+			_OutIt _Chunk_dest = _Out;
+			std::advance(_Chunk_dest, _Offset);
+			for (size_t _I = 0; _I < _Chunk_count; ++_I, ++_Chunk_dest)
+				*_Chunk_dest = _Vw._Project(_Begin[_I]);
+		});
+
+		std::advance(_Dest, _Count);
+		return _Dest;
+	}
+
+	// The filtering stage of the copy partitioner marks the elements the filters keep and counts them,
+	// once the chunks before it are counted the copy stage writes the values of the marked ones. The functions
+	// before the last filter run a second time for the elements kept.
+	template<class _ExPolicy, class _View, class _OutIt>
+	inline _OutIt _Fused_copy_impl(const _ExPolicy& _Policy, const _View& _Vw, _OutIt _Dest, std::true_type)
+	{
+		typedef typename _View::_Source_iterator _Source_iterator;
+		typedef typename std::iterator_traits<_OutIt>::difference_type difference_type;
+		typedef composable_iterator<_Source_iterator, _Filter_mask_iterator> _Iter_type;
+		typedef _Output_token<_OutIt> _Output_token;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Vw._Source_size();
+		_Filter_mask _Filter(_Size);
+
+		return _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_Vw._Source_begin(), _Filter.begin()), _Size, _Output_token(_Dest),
+			[&_Vw](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) { // Filtering stage
+
+			difference_type _Sum = 0;
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
+				[&_Vw, &_Sum](typename _Iter_type::reference _It){
+
+				const bool _Keep = _Vw._Test(*std::get<0>(_It));
+				*std::get<1>(_It) = _Keep;
+				if (_Keep)
+					++_Sum;
+			});
+
+			_Output.set_position(_Sum);
+		},
+			[&_Vw](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage
+			auto _Out = _Dest.get();
+
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
+				[&_Vw, &_Out](typename _Iter_type::reference _It){
+
+				if (*std::get<1>(_It)) {
+					*_Out = _Vw._Project(*std::get<0>(_It));
+					++_Out;
+				}
+			});
+		}, _Filter_mask::chunk_size(_Size)).get_result();
+	}
+
+	template<class _ExPolicy, class _View, class _OutIt>
+	inline _OutIt _Fused_copy_impl(const _ExPolicy& _Policy, const _View& _Vw, _OutIt _Dest)
+	{
+		if (_Vw._Source_size() == 0)
+			return _Dest;
+
+		return _Fused_copy_impl(_Policy, _Vw, _Dest, std::integral_constant<bool, _View::_Filters>());
+	}
+
+	template<class _View, class _OutIt>
+	inline _OutIt _Fused_copy_impl(const execution_policy& _Policy, const _View& _Vw, _OutIt _Dest)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Fused_copy_impl, _Policy, _Vw, _Dest);
+	}
+} // details
+
+namespace views {
+
+	/// <summary>
+	///     A lazy view of <c>_Func(x)</c> for the elements x of a random access container or of another view.
+	///     Nothing runs until an algorithm takes the view, the container must outlive the view.
+	/// </summary>
+	template<class _Range, class _Fn>
+	inline details::_Transform_view<typename details::_View_of<_Range&&>::type, _Fn> transform(_Range&& _Rng, _Fn _Func)
+	{
+		typedef typename details::_View_of<_Range&&>::type _Base;
+		return details::_Transform_view<_Base, _Fn>(details::_View_of<_Range&&>::_Make(std::forward<_Range>(_Rng)), _Func);
+	}
+
+	/// <summary>
+	///     A lazy view of the elements x of a random access container or of another view for which <c>_Pred(x)</c>
+	///     is true. Nothing runs until an algorithm takes the view, the container must outlive the view.
+	/// </summary>
+	template<class _Range, class _Pr>
+	inline details::_Filter_view<typename details::_View_of<_Range&&>::type, _Pr> filter(_Range&& _Rng, _Pr _Pred)
+	{
+		typedef typename details::_View_of<_Range&&>::type _Base;
+		return details::_Filter_view<_Base, _Pr>(details::_View_of<_Range&&>::_Make(std::forward<_Range>(_Rng)), _Pred);
+	}
+} // views
+
+/// <summary>
+///     Reduces the values of a view of the views namespace. Every chunk of the source runs its elements through
+///     the functions and the filters of the view and folds the values in the same loop, no intermediate range
+///     is written.
+/// </summary>
+template<class _ExPolicy, class _View, class _Ty, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_fused_view<_View, _Ty>::type>::type reduce(_ExPolicy&& _Policy, const _View& _Vw, _Ty _Init, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce");
+	return details::_Fused_reduce_impl(_Policy, _Vw, _Init, _Op);
+}
+
+template<class _ExPolicy, class _View, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_fused_view<_View, _Ty>::type>::type reduce(_ExPolicy&& _Policy, const _View& _Vw, _Ty _Init)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce");
+	return details::_Fused_reduce_impl(_Policy, _Vw, _Init, std::plus<>());
+}
+
+template<class _ExPolicy, class _View>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_fused_view<_View, typename _View::value_type>::type>::type reduce(_ExPolicy&& _Policy, const _View& _Vw)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce");
+	return details::_Fused_reduce_impl(_Policy, _Vw, typename _View::value_type{}, std::plus<>());
+}
+
+/// <summary>
+///     Calls <c>_Func</c> on the values of a view of the views namespace, the values are computed in the loop
+///     of the chunk that calls the function.
+/// </summary>
+template<class _ExPolicy, class _View, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_fused_view<_View>::type>::type for_each(_ExPolicy&& _Policy, const _View& _Vw, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	details::_Fused_for_each_impl(_Policy, _Vw, _Func);
+}
+
+/// <summary>
+///     Writes the values of a view of the views namespace to the range from <c>_Dest</c> and returns the end of
+///     the values written. A view with a filter is compacted in two passes over the source, the first marks the
+///     elements kept, one bit each, the second writes them once the chunks before it are counted.
+/// </summary>
+template<class _ExPolicy, class _View, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_fused_view<_View, _OutIt>::type>::type copy(_ExPolicy&& _Policy, const _View& _Vw, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	return details::_Fused_copy_impl(_Policy, _Vw, _Dest);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_FUSED_VIEW_H_
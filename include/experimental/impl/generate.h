@@ -71,6 +71,7 @@ namespace details {
 template <class _ExPolicy, class _FwdIt, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type generate(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("generate");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	details::_Generate_impl(_Policy, _First, _Last, _Func, std::_Iter_cat(_First));
@@ -79,6 +80,7 @@ inline typename details::_enable_if_policy<_ExPolicy, void>::type generate(_ExPo
 template <class _ExPolicy, class _OutIt, class _Diff, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type generate_n(_ExPolicy&& _Policy, _OutIt _First, _Diff _Count, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("generate_n");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
 	return details::_Generate_n_impl(_Policy, _First, _Count, _Func, std::_Iter_cat(_First));
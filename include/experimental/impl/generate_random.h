@@ -0,0 +1,183 @@
+#pragma once
+
+#ifndef _IMPL_GENERATE_RANDOM_H_
+#define _IMPL_GENERATE_RANDOM_H_ 1
+
+#include <cstdint>
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+
+// Counter based random number engine. The numbers of a stream are a hash of the seed, the stream
+// and their position in it, so a stream is built where it's needed and gives the same numbers on
+// any thread. generate_random draws the element at index _I from the stream _I.
+class counter_engine
+{
+	std::uint64_t _Base;
+	std::uint64_t _Counter;
+
+	static std::uint64_t _Mix(std::uint64_t _Val)
+	{
+		// the splitmix64 finalizer
+		_Val = (_Val ^ (_Val >> 30)) * 0xBF58476D1CE4E5B9ull;
+		_Val = (_Val ^ (_Val >> 27)) * 0x94D049BB133111EBull;
+		return _Val ^ (_Val >> 31);
+	}
+public:
+	typedef std::uint64_t result_type;
+
+	counter_engine(std::uint64_t _Seed, std::uint64_t _Stream) : _Base(_Mix(_Mix(_Seed) ^ (_Stream * 0x9E3779B97F4A7C15ull))), _Counter(0)
+	{
+	}
+
+	static _EXP_CONSTEXPR result_type (min)()
+	{
+		return 0;
+	}
+
+	static _EXP_CONSTEXPR result_type (max)()
+	{
+		return ~result_type{ 0 };
+	}
+
+	result_type operator()()
+	{
+		return _Mix(_Base + ++_Counter * 0x9E3779B97F4A7C15ull);
+	}
+};
+
+template <class _OutIt, class _Diff, class _Dist>
+inline _OutIt generate_random_n(_OutIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution)
+{
+	for (_Diff _I = 0; _I < _Count; ++_I, ++_First) {
+		counter_engine _Engine(_Seed, static_cast<std::uint64_t>(_I));
+		_Dist _Local(_Distribution);
+		*_First = _Local(_Engine);
+	}
+
+	return _First;
+}
+
+template <class _FwdIt, class _Dist>
+inline void generate_random(_FwdIt _First, _FwdIt _Last, std::uint64_t _Seed, _Dist _Distribution)
+{
+	generate_random_n(_First, std::distance(_First, _Last), _Seed, _Distribution);
+}
+
+namespace details {
+
+	// The element at _Index draws from a copy of the distribution on its own stream, the distributions
+	// that keep numbers for the next call don't make an element depend on the ones before it
+	template<typename _Dist>
+	inline auto _Draw_random(const _Dist& _Distribution, std::uint64_t _Seed, size_t _Index) -> decltype(std::declval<_Dist&>()(std::declval<counter_engine&>()))
+	{
+		counter_engine _Engine(_Seed, _Index);
+		_Dist _Local(_Distribution);
+		return _Local(_Engine);
+	}
+
+	template<typename _ExPolicy, typename _IterCat>
+	struct _Generate_random_helper
+	{
+		template<typename _RanIt, typename _Dist>
+		static void Loop(_RanIt _First, size_t _Count, std::uint64_t _Seed, size_t _Index, const _Dist& _Distribution)
+		{
+			for (size_t _I = 0; _I < _Count; ++_I)
+				_First[_I] = _Draw_random(_Distribution, _Seed, _Index + _I);
+		}
+	};
+
+	// pragma par_vec, the elements are independent of each other
+	template<>
+	struct _Generate_random_helper < parallel_vector_execution_policy, std::random_access_iterator_tag >
+	{
+		template<typename _RanIt, typename _Dist>
+		static void Loop(_RanIt _First, size_t _Count, std::uint64_t _Seed, size_t _Index, const _Dist& _Distribution)
+		{
+			VecLoopHelper(_First, _Count, _Seed, _Index, _Distribution, _Contiguous_container_iterator_traits<_RanIt>());
+		}
+
+		template<typename _RanIt, typename _Dist>
+		static void VecLoopHelper(_RanIt _First, size_t _Count, std::uint64_t _Seed, size_t _Index, const _Dist& _Distribution, std::true_type) // with contiguous iterator
+		{
+			if (_Count == 0)
+				return;
+			typename std::iterator_traits<_RanIt>::pointer _EXP_RESTRICT _FirstP = _Unwrap_contiguous(_First);
+			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_FirstP[_I] = _Draw_random(_Distribution, _Seed, _Index + _I);
+		}
+
+		template<typename _RanIt, typename _Dist>
+		static void VecLoopHelper(_RanIt _First, size_t _Count, std::uint64_t _Seed, size_t _Index, const _Dist& _Distribution, std::false_type)
+		{
+			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
+				for (size_t _I = 0; _I < _Count; ++_I)
+					_First[_I] = _Draw_random(_Distribution, _Seed, _Index + _I);
+		}
+	};
+
+	//
+	// generate_random_n
+	//
+	template <class _OutIt, class _Diff, class _Dist, class _IterCat>
+	inline _OutIt _Generate_random_n_impl(const sequential_execution_policy&, _OutIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution, _IterCat)
+	{
+		_EXP_TRY
+			return generate_random_n(_First, _Count, _Seed, _Distribution);
+		_EXP_RETHROW
+	}
+
+	// The chunks find the streams of their elements from the offset of their begin
+	template <class _ExPolicy, class _RanIt, class _Diff, class _Dist>
+	inline typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Generate_random_n_impl(const _ExPolicy& _Policy, _RanIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution, std::random_access_iterator_tag)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+		if (_Count <= 0)
+			return _First;
+
+		return _Partitioned_for_each(_Policy, _First, static_cast<size_t>(_Count), _Distribution,
+			[_First, _Seed](_RanIt _Begin, size_t _Chunk_count, _Dist& _UserDist) {
+			_Generate_random_helper<_ExecutionPolicy, std::random_access_iterator_tag>::Loop(_Begin, _Chunk_count, _Seed, static_cast<size_t>(_Begin - _First), _UserDist);
+		});
+	}
+
+	// A chunk of a forward range can't tell its offset without walking to it
+	template <class _ExPolicy, class _OutIt, class _Diff, class _Dist, class _IterCat>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Generate_random_n_impl(const _ExPolicy&, _OutIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution, _IterCat _Cat)
+	{
+		return _Generate_random_n_impl(seq, _First, _Count, _Seed, _Distribution, _Cat);
+	}
+
+	template <class _OutIt, class _Diff, class _Dist, class _IterCat>
+	inline _OutIt _Generate_random_n_impl(const execution_policy& _Policy, _OutIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Generate_random_n_impl, _Policy, _First, _Count, _Seed, _Distribution, _Cat);
+	}
+} // details
+
+// Fills the range with numbers from _Distribution, which is called with a counter_engine. The element at
+// index _I is drawn from the stream _I of _Seed, the result only depends on the seed whatever the policy.
+template <class _ExPolicy, class _OutIt, class _Diff, class _Dist>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type generate_random_n(_ExPolicy&& _Policy, _OutIt _First, _Diff _Count, std::uint64_t _Seed, _Dist _Distribution)
+{
+	_EXP_TELEMETRY_ALGORITHM("generate_random_n");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	return details::_Generate_random_n_impl(_Policy, _First, _Count, _Seed, _Distribution, std::_Iter_cat(_First));
+}
+
+template <class _ExPolicy, class _FwdIt, class _Dist>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type generate_random(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, std::uint64_t _Seed, _Dist _Distribution)
+{
+	_EXP_TELEMETRY_ALGORITHM("generate_random");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Generate_random_n_impl(_Policy, _First, std::distance(_First, _Last), _Seed, _Distribution, std::_Iter_cat(_First));
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_GENERATE_RANDOM_H_
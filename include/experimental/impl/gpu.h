@@ -0,0 +1,131 @@
+#pragma once
+
+#ifndef _IMPL_GPU_H_
+#define _IMPL_GPU_H_ 1
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+#include "defines.h"
+
+#if _EXP_AMP
+#include <amp.h>
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     Runs transform and for_each over array views and bounds, reduce, inclusive_scan and the sort of
+///     arithmetic keys on the default C++ AMP accelerator. The functions of the algorithms must be
+///     restrict(amp, cpu) and the elements types of C++ AMP. Ranges with fewer elements than the offload
+///     threshold, and every range when the only accelerator is an emulated one, run under par instead.
+/// </summary>
+class parallel_gpu_execution_policy
+{
+	size_t _Threshold;
+
+public:
+	parallel_gpu_execution_policy() _NOEXCEPT : _Threshold(1 << 16)
+	{
+	}
+
+	explicit parallel_gpu_execution_policy(size_t _Min_count) _NOEXCEPT : _Threshold(_Min_count)
+	{
+	}
+
+	/// <summary>
+	///     A copy of the policy that offloads the ranges of at least _Min_count elements.
+	/// </summary>
+	parallel_gpu_execution_policy offload_threshold(size_t _Min_count) const _NOEXCEPT
+	{
+		return parallel_gpu_execution_policy(_Min_count);
+	}
+
+	size_t offload_threshold() const _NOEXCEPT
+	{
+		return _Threshold;
+	}
+};
+
+const parallel_gpu_execution_policy par_gpu{};
+
+namespace details {
+
+	template<class _ExPolicy, class _Ty = void>
+	struct _enable_if_gpu_policy : std::enable_if<std::is_same<typename std::decay<_ExPolicy>::type, parallel_gpu_execution_policy>::value, _Ty>
+	{
+	};
+
+	// The elements of a piece streamed through the accelerator, and the threads of a tile of the kernels
+	const int _Gpu_piece = 1 << 20;
+	const int _Gpu_tile = 256;
+
+	// The accelerator runs the range, otherwise par does
+	inline bool _Gpu_offload(const parallel_gpu_execution_policy& _Policy, size_t _Count)
+	{
+		return _Count > 0 && _Count >= _Policy.offload_threshold() && !concurrency::accelerator().is_emulated;
+	}
+
+	inline int _Gpu_piece_size(size_t _Count)
+	{
+		return static_cast<int>((std::min)(_Count, static_cast<size_t>(_Gpu_piece)));
+	}
+
+	inline int _Gpu_tiles(int _Count)
+	{
+		return (_Count + _Gpu_tile - 1) / _Gpu_tile;
+	}
+
+	template<class _Ty>
+	struct _Gpu_plus
+	{
+		_Ty operator()(const _Ty& _Left, const _Ty& _Right) const restrict(amp, cpu)
+		{
+			return _Left + _Right;
+		}
+	};
+
+	// Streams the _Count elements from _First through the accelerator in pieces. _Run(buffer, count, position, slot)
+	// queues the kernels of a piece and returns the download of its results; the pieces alternate between two
+	// buffers, so the upload of a piece overlaps the kernels and the download of the one before it.
+	template<class _Ty, class _Kernel>
+	inline void _Gpu_stream(const concurrency::accelerator_view& _Acc_view, const _Ty *_First, size_t _Count, _Kernel& _Run)
+	{
+		typedef typename std::remove_const<_Ty>::type _Elem;
+
+		const int _Piece = _Gpu_piece_size(_Count);
+		const size_t _Pieces = (_Count + _Piece - 1) / _Piece;
+
+		concurrency::array<_Elem, 1> _Buffer0(_Piece, _Acc_view), _Buffer1(_Piece, _Acc_view);
+		concurrency::array<_Elem, 1> *_Buffers[2] = { &_Buffer0, &_Buffer1 };
+		concurrency::completion_future _Uploads[2], _Downloads[2];
+
+		_Uploads[0] = concurrency::copy_async(_First, _First + _Piece, _Buffer0.section(0, _Piece));
+		for (size_t _K = 0; _K < _Pieces; ++_K) {
+			const size_t _Pos = _K * _Piece;
+			const int _Len = static_cast<int>((std::min)(_Count - _Pos, static_cast<size_t>(_Piece)));
+			const int _Slot = static_cast<int>(_K % 2);
+
+			_Uploads[_Slot].get();
+			if (_K + 1 < _Pieces) {
+				const size_t _Next = _Pos + _Piece;
+				const int _Next_len = static_cast<int>((std::min)(_Count - _Next, static_cast<size_t>(_Piece)));
+
+				// the other buffer is free once the piece before this one is back
+				if (_Downloads[1 - _Slot].valid())
+					_Downloads[1 - _Slot].get();
+				_Uploads[1 - _Slot] = concurrency::copy_async(_First + _Next, _First + _Next + _Next_len, _Buffers[1 - _Slot]->section(0, _Next_len));
+			}
+
+			_Downloads[_Slot] = _Run(*_Buffers[_Slot], _Len, _Pos, _Slot);
+		}
+
+		for (int _Slot = 0; _Slot < 2; ++_Slot)
+			if (_Downloads[_Slot].valid())
+				_Downloads[_Slot].get();
+	}
+} // details
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _EXP_AMP
+
+#endif // _IMPL_GPU_H_
@@ -0,0 +1,183 @@
+#pragma once
+
+#ifndef _IMPL_GPU_ALGORITHM_H_
+#define _IMPL_GPU_ALGORITHM_H_ 1
+
+#include <limits>
+#include "algorithm_impl.h"
+#include "foreach.h"
+#include "gpu.h"
+#include "sort.h"
+#include "transform.h"
+
+#if _EXP_AMP
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Stores _Func of the elements of every piece to the pieces of _Dest
+	template<class _InTy, class _OutTy, class _Fn>
+	class _Gpu_transform_kernel
+	{
+		_Fn _Func;
+		_OutTy *_Dest;
+		concurrency::array<_OutTy, 1> _Out0, _Out1;
+
+	public:
+		_Gpu_transform_kernel(const concurrency::accelerator_view& _Acc_view, int _Piece, _OutTy *_Dest_first, _Fn _Fn_arg)
+			: _Func(_Fn_arg), _Dest(_Dest_first), _Out0(_Piece, _Acc_view), _Out1(_Piece, _Acc_view)
+		{
+		}
+
+		concurrency::completion_future operator()(concurrency::array<_InTy, 1>& _In, int _Count, size_t _Pos, int _Slot)
+		{
+			concurrency::array<_OutTy, 1>& _Out = _Slot == 0 ? _Out0 : _Out1;
+			const _Fn _Op = _Func;
+
+			concurrency::parallel_for_each(_In.get_accelerator_view(), concurrency::extent<1>(_Count), [=, &_In, &_Out](concurrency::index<1> _Idx) restrict(amp) {
+				_Out[_Idx] = _Op(_In[_Idx]);
+			});
+			return concurrency::copy_async(_Out.section(0, _Count), _Dest + _Pos);
+		}
+	};
+
+	// The index of the bounds the fallback under par runs _Func for, as the one of the accelerator
+	template<int _Rank, class _Fn>
+	struct _Gpu_index_call
+	{
+		_Fn _Func;
+
+		void operator()(const D4087::index<_Rank>& _Idx)
+		{
+			concurrency::index<_Rank> _Acc_idx;
+			for (int _Dim = 0; _Dim < _Rank; ++_Dim)
+				_Acc_idx[_Dim] = static_cast<int>(_Idx[_Dim]);
+			_Func(_Acc_idx);
+		}
+	};
+
+	template<class _Ty>
+	struct _Is_gpu_key : std::integral_constant<bool, std::is_same<_Ty, int>::value || std::is_same<_Ty, unsigned int>::value
+		|| std::is_same<_Ty, long>::value || std::is_same<_Ty, unsigned long>::value || std::is_same<_Ty, float>::value || std::is_same<_Ty, double>::value>
+	{
+	};
+
+	// Bitonic sort of the keys, padded with the largest key to a power of two
+	template<class _Ty>
+	inline void _Gpu_sort(const concurrency::accelerator_view& _Acc_view, _Ty *_First, int _Count)
+	{
+		int _Padded = 1;
+		while (_Padded < _Count)
+			_Padded *= 2;
+
+		concurrency::array<_Ty, 1> _Keys(_Padded, _Acc_view);
+		concurrency::copy(_First, _First + _Count, _Keys.section(0, _Count));
+		if (_Padded > _Count) {
+			const _Ty _Largest = (std::numeric_limits<_Ty>::max)();
+			concurrency::parallel_for_each(_Acc_view, concurrency::extent<1>(_Padded - _Count), [=, &_Keys](concurrency::index<1> _Idx) restrict(amp) {
+				_Keys[_Idx[0] + _Count] = _Largest;
+			});
+		}
+
+		for (int _Size = 2; _Size <= _Padded; _Size *= 2) {
+			for (int _Stride = _Size / 2; _Stride > 0; _Stride /= 2) {
+				concurrency::parallel_for_each(_Acc_view, concurrency::extent<1>(_Padded / 2), [=, &_Keys](concurrency::index<1> _Idx) restrict(amp) {
+					// the pair of the thread, _Low with the bit of _Stride clear
+					const int _Low = 2 * _Idx[0] - (_Idx[0] & (_Stride - 1));
+					const int _High = _Low + _Stride;
+					const bool _Ascending = (_Low & _Size) == 0;
+
+					const _Ty _Left = _Keys[_Low];
+					const _Ty _Right = _Keys[_High];
+					if ((_Left > _Right) == _Ascending) {
+						_Keys[_Low] = _Right;
+						_Keys[_High] = _Left;
+					}
+				});
+			}
+		}
+
+		concurrency::copy(_Keys.section(0, _Count), _First);
+	}
+} // details
+
+/// <summary>
+///     Stores _Func of every element of an array view to the element at the same index of another view
+///     on the accelerator, the pieces of the views uploaded while the accelerator runs the ones before.
+///     Views with gaps between their elements run under par.
+/// </summary>
+template <class _ExPolicy, class _InView, class _OutView, class _Fn>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type transform(_ExPolicy&& _Policy, const _InView& _View, const _OutView& _Dest_view, _Fn _Func)
+{
+	static_assert(_InView::rank == _OutView::rank, "Required views of the same rank.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	const auto& _Source = details::_Strided_view(_View);
+	const auto& _Dest = details::_Strided_view(_Dest_view);
+	const size_t _Count = static_cast<size_t>(_Source.size());
+	if (!details::_Gpu_offload(_Policy, _Count) || !details::_Is_dense_view(_Source) || !details::_Is_dense_view(_Dest)) {
+		transform(par, _View, _Dest_view, _Func);
+		return;
+	}
+
+	typedef typename std::remove_const<typename _InView::value_type>::type _InTy;
+	typedef typename _OutView::value_type _OutTy;
+
+	_EXP_TRY
+		concurrency::accelerator_view _Acc_view = concurrency::accelerator().default_view;
+		details::_Gpu_transform_kernel<_InTy, _OutTy, _Fn> _Kernel(_Acc_view, details::_Gpu_piece_size(_Count), details::_View_data(_Dest), _Func);
+		details::_Gpu_stream(_Acc_view, details::_View_data(_Source), _Count, _Kernel);
+	_EXP_RETHROW
+}
+
+/// <summary>
+///     Calls _Func(concurrency::index<_Rank>) for every index of the bounds on the accelerator, the
+///     data of _Func reached through the concurrency::array_view objects it captures.
+/// </summary>
+template<class _ExPolicy, int _Rank, class _Fn>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, const D4087::bounds<_Rank>& _Bnd, _Fn _Func)
+{
+	if (!details::_Gpu_offload(_Policy, static_cast<size_t>(_Bnd.size()))) {
+		details::_Gpu_index_call<_Rank, _Fn> _Call = { _Func };
+		for_each(par, _Bnd, _Call);
+		return;
+	}
+
+	concurrency::extent<_Rank> _Ext;
+	for (int _Dim = 0; _Dim < _Rank; ++_Dim)
+		_Ext[_Dim] = static_cast<int>(_Bnd[_Dim]);
+
+	_EXP_TRY
+		concurrency::accelerator_view _Acc_view = concurrency::accelerator().default_view;
+		concurrency::parallel_for_each(_Acc_view, _Ext, [=](concurrency::index<_Rank> _Idx) restrict(amp) {
+			_Func(_Idx);
+		});
+		_Acc_view.wait();
+	_EXP_RETHROW
+}
+
+/// <summary>
+///     Sorts the arithmetic keys of an array view in ascending order on the accelerator.
+/// </summary>
+template<class _ExPolicy, class _Ty>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, const D4087::array_view<_Ty, 1>& _View)
+{
+	static_assert(details::_Is_gpu_key<typename std::remove_const<_Ty>::type>::value, "Required 32 bit integer or floating point keys.");
+	static_assert(!std::is_const<_Ty>::value, "Required a view of mutable keys.");
+
+	const size_t _Count = static_cast<size_t>(_View.size());
+	if (!details::_Gpu_offload(_Policy, _Count) || _Count > (1u << 30)) {
+		auto _First = _View.data();
+		sort(par, _First, _First + _Count);
+		return;
+	}
+
+	_EXP_TRY
+		details::_Gpu_sort(concurrency::accelerator().default_view, _View.data(), static_cast<int>(_Count));
+	_EXP_RETHROW
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _EXP_AMP
+
+#endif // _IMPL_GPU_ALGORITHM_H_
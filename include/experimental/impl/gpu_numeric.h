@@ -0,0 +1,216 @@
+#pragma once
+
+#ifndef _IMPL_GPU_NUMERIC_H_
+#define _IMPL_GPU_NUMERIC_H_ 1
+
+#include "algorithm_impl.h"
+#include "gpu.h"
+#include "reduce.h"
+#include "scan.h"
+
+#if _EXP_AMP
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Reduces every tile of a piece on the accelerator, the partial sums of the tiles of all the pieces
+	// come back in order and the host folds them into the initial value
+	template<class _Ty, class _BinOp>
+	class _Gpu_reduce_kernel
+	{
+		_BinOp _Op;
+		int _Tiles_per_piece;
+		concurrency::array<_Ty, 1> _Partials0, _Partials1;
+		std::vector<_Ty> _Host;
+
+	public:
+		_Gpu_reduce_kernel(const concurrency::accelerator_view& _Acc_view, size_t _Count, _BinOp _Op_arg)
+			: _Op(_Op_arg), _Tiles_per_piece(_Gpu_tiles(_Gpu_piece_size(_Count))),
+			_Partials0(_Tiles_per_piece, _Acc_view), _Partials1(_Tiles_per_piece, _Acc_view)
+		{
+			const size_t _Piece = static_cast<size_t>(_Gpu_piece_size(_Count));
+			const size_t _Last = _Count - (_Count - 1) / _Piece * _Piece;
+			_Host.resize((_Count - 1) / _Piece * _Tiles_per_piece + _Gpu_tiles(static_cast<int>(_Last)));
+		}
+
+		concurrency::completion_future operator()(concurrency::array<_Ty, 1>& _In, int _Count, size_t _Pos, int _Slot)
+		{
+			concurrency::array<_Ty, 1>& _Partials = _Slot == 0 ? _Partials0 : _Partials1;
+			const int _Tiles = _Gpu_tiles(_Count);
+			const _BinOp _Fn = _Op;
+
+			concurrency::parallel_for_each(_In.get_accelerator_view(), concurrency::extent<1>(_Tiles * _Gpu_tile).tile<_Gpu_tile>(),
+				[=, &_In, &_Partials](concurrency::tiled_index<_Gpu_tile> _Tidx) restrict(amp) {
+				tile_static _Ty _Shared[_Gpu_tile];
+				const int _Local = _Tidx.local[0];
+				if (_Tidx.global[0] < _Count)
+					_Shared[_Local] = _In[_Tidx.global];
+				_Tidx.barrier.wait();
+
+				// the elements of the tile left to combine, the last tile of a piece may be short
+				int _Valid = _Count - _Tidx.tile_origin[0];
+				if (_Valid > _Gpu_tile)
+					_Valid = _Gpu_tile;
+				for (int _Half = _Gpu_tile / 2; _Half > 0; _Half /= 2) {
+					if (_Local < _Half && _Local + _Half < _Valid)
+						_Shared[_Local] = _Fn(_Shared[_Local], _Shared[_Local + _Half]);
+					_Tidx.barrier.wait();
+					if (_Valid > _Half)
+						_Valid = _Half;
+				}
+
+				if (_Local == 0)
+					_Partials[_Tidx.tile] = _Shared[0];
+			});
+
+			return concurrency::copy_async(_Partials.section(0, _Tiles), _Host.data() + _Pos / _Gpu_piece * _Tiles_per_piece);
+		}
+
+		template<class _Init>
+		_Init _Fold(_Init _Val) const
+		{
+			for (auto _It = _Host.begin(); _It != _Host.end(); ++_It)
+				_Val = _Op(_Val, *_It);
+			return _Val;
+		}
+	};
+
+	// Scans every tile of a piece on the accelerator, then adds to the tiles the sums of the ones before
+	// them, in this piece and in the pieces before it, that the host scans from the sums of the tiles
+	template<class _Ty, class _BinOp>
+	class _Gpu_scan_kernel
+	{
+		_BinOp _Op;
+		_Ty *_Dest;
+		concurrency::array<_Ty, 1> _Out0, _Out1, _Sums, _Offsets;
+		std::vector<_Ty> _Host_sums, _Host_offsets;
+		bool _Has_carry;
+		_Ty _Carry;
+
+	public:
+		_Gpu_scan_kernel(const concurrency::accelerator_view& _Acc_view, int _Piece, _Ty *_Dest_first, _BinOp _Op_arg)
+			: _Op(_Op_arg), _Dest(_Dest_first), _Out0(_Piece, _Acc_view), _Out1(_Piece, _Acc_view),
+			_Sums(_Gpu_tiles(_Piece), _Acc_view), _Offsets(_Gpu_tiles(_Piece), _Acc_view),
+			_Host_sums(_Gpu_tiles(_Piece)), _Host_offsets(_Gpu_tiles(_Piece)), _Has_carry(false), _Carry()
+		{
+		}
+
+		concurrency::completion_future operator()(concurrency::array<_Ty, 1>& _In, int _Count, size_t _Pos, int _Slot)
+		{
+			concurrency::array<_Ty, 1>& _Out = _Slot == 0 ? _Out0 : _Out1;
+			concurrency::array<_Ty, 1>& _Sums_ref = _Sums;
+			concurrency::array<_Ty, 1>& _Offsets_ref = _Offsets;
+			const int _Tiles = _Gpu_tiles(_Count);
+			const _BinOp _Fn = _Op;
+
+			concurrency::parallel_for_each(_In.get_accelerator_view(), concurrency::extent<1>(_Tiles * _Gpu_tile).tile<_Gpu_tile>(),
+				[=, &_In, &_Out, &_Sums_ref](concurrency::tiled_index<_Gpu_tile> _Tidx) restrict(amp) {
+				tile_static _Ty _Shared[_Gpu_tile];
+				const int _Local = _Tidx.local[0];
+				const bool _Inside = _Tidx.global[0] < _Count;
+				if (_Inside)
+					_Shared[_Local] = _In[_Tidx.global];
+				_Tidx.barrier.wait();
+
+				for (int _Dist = 1; _Dist < _Gpu_tile; _Dist *= 2) {
+					const bool _Take = _Inside && _Local >= _Dist;
+					_Ty _Sum = _Shared[_Local];
+					if (_Take)
+						_Sum = _Fn(_Shared[_Local - _Dist], _Sum);
+					_Tidx.barrier.wait();
+					if (_Take)
+						_Shared[_Local] = _Sum;
+					_Tidx.barrier.wait();
+				}
+
+				if (_Inside) {
+					_Out[_Tidx.global] = _Shared[_Local];
+					if (_Local == _Gpu_tile - 1 || _Tidx.global[0] == _Count - 1)
+						_Sums_ref[_Tidx.tile] = _Shared[_Local];
+				}
+			});
+
+			// the offset of a tile is only valid with an element before the tile
+			concurrency::copy(_Sums.section(0, _Tiles), _Host_sums.begin());
+			const bool _First_offset = _Has_carry;
+			for (int _Tile = 0; _Tile < _Tiles; ++_Tile) {
+				_Host_offsets[_Tile] = _Carry;
+				_Carry = _Has_carry ? _Op(_Carry, _Host_sums[_Tile]) : _Host_sums[_Tile];
+				_Has_carry = true;
+			}
+			concurrency::copy(_Host_offsets.begin(), _Host_offsets.begin() + _Tiles, _Offsets.section(0, _Tiles));
+
+			concurrency::parallel_for_each(_In.get_accelerator_view(), concurrency::extent<1>(_Count), [=, &_Out, &_Offsets_ref](concurrency::index<1> _Idx) restrict(amp) {
+				const int _Tile = _Idx[0] / _Gpu_tile;
+				if (_Tile > 0 || _First_offset)
+					_Out[_Idx] = _Fn(_Offsets_ref[_Tile], _Out[_Idx]);
+			});
+			return concurrency::copy_async(_Out.section(0, _Count), _Dest + _Pos);
+		}
+	};
+} // details
+
+/// <summary>
+///     Reduces the elements of an array view with _Op on the accelerator and folds the partial sums into
+///     _Init, _Op associative and commutative.
+/// </summary>
+template <class _ExPolicy, class _Ty, int _Rank, class _Init, class _BinOp>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, _Init>::type reduce(_ExPolicy&& _Policy, const D4087::array_view<_Ty, _Rank>& _View, _Init _Val, _BinOp _Op)
+{
+	typedef typename std::remove_const<_Ty>::type _Elem;
+
+	const size_t _Count = static_cast<size_t>(_View.size());
+	if (!details::_Gpu_offload(_Policy, _Count)) {
+		auto _First = _View.data();
+		return reduce(par, _First, _First + _Count, _Val, _Op);
+	}
+
+	_EXP_TRY
+		concurrency::accelerator_view _Acc_view = concurrency::accelerator().default_view;
+		details::_Gpu_reduce_kernel<_Elem, _BinOp> _Kernel(_Acc_view, _Count, _Op);
+		details::_Gpu_stream(_Acc_view, _View.data(), _Count, _Kernel);
+		return _Kernel._Fold(_Val);
+	_EXP_RETHROW
+}
+
+template <class _ExPolicy, class _Ty, int _Rank>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, typename std::remove_const<_Ty>::type>::type reduce(_ExPolicy&& _Policy, const D4087::array_view<_Ty, _Rank>& _View)
+{
+	typedef typename std::remove_const<_Ty>::type _Elem;
+	return reduce(_Policy, _View, _Elem{}, details::_Gpu_plus<_Elem>());
+}
+
+/// <summary>
+///     Stores the inclusive scan of the elements of an array view with _Op to another view of the same
+///     bounds on the accelerator, _Op associative.
+/// </summary>
+template <class _ExPolicy, class _Ty, class _OutTy, int _Rank, class _BinOp>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, void>::type inclusive_scan(_ExPolicy&& _Policy, const D4087::array_view<_Ty, _Rank>& _View, const D4087::array_view<_OutTy, _Rank>& _Dest_view, _BinOp _Op)
+{
+	static_assert(std::is_same<typename std::remove_const<_Ty>::type, _OutTy>::value, "Required views of the same element type.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	const size_t _Count = static_cast<size_t>(_View.size());
+	if (!details::_Gpu_offload(_Policy, _Count)) {
+		auto _First = _View.data();
+		inclusive_scan(par, _First, _First + _Count, _Dest_view.data(), _Op);
+		return;
+	}
+
+	_EXP_TRY
+		concurrency::accelerator_view _Acc_view = concurrency::accelerator().default_view;
+		details::_Gpu_scan_kernel<_OutTy, _BinOp> _Kernel(_Acc_view, details::_Gpu_piece_size(_Count), _Dest_view.data(), _Op);
+		details::_Gpu_stream(_Acc_view, _View.data(), _Count, _Kernel);
+	_EXP_RETHROW
+}
+
+template <class _ExPolicy, class _Ty, class _OutTy, int _Rank>
+inline typename details::_enable_if_gpu_policy<_ExPolicy, void>::type inclusive_scan(_ExPolicy&& _Policy, const D4087::array_view<_Ty, _Rank>& _View, const D4087::array_view<_OutTy, _Rank>& _Dest_view)
+{
+	inclusive_scan(_Policy, _View, _Dest_view, details::_Gpu_plus<_OutTy>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _EXP_AMP
+
+#endif // _IMPL_GPU_NUMERIC_H_
@@ -0,0 +1,216 @@
+#pragma once
+
+#ifndef _IMPL_HISTOGRAM_H_
+#define _IMPL_HISTOGRAM_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Histograms up to this many bins are counted per chunk, 32KB of counters for a chunk.
+	// Bigger ones are counted per thread.
+	const size_t _Histogram_private_bins = 4096;
+
+	const size_t _Histogram_row_alignment = 64;
+
+	// Counters of a histogram counted per chunk. The row of a chunk starts on a cache line of its own,
+	// so the chunks don't false share. The rows are kept apart for the algorithms that place the
+	// elements of a chunk from its own counts, like a radix sort does.
+	class _Histogram_rows
+	{
+		std::unique_ptr<unsigned char[]> _Memory;
+		std::unique_ptr<size_t *[]> _Row_begins;
+		size_t _Rows;
+		size_t _Bins;
+
+		_Histogram_rows(const _Histogram_rows&);
+		_Histogram_rows& operator=(const _Histogram_rows&);
+	public:
+		_Histogram_rows(size_t _Row_count, size_t _Bin_count) : _Row_begins(new size_t *[_Row_count]), _Rows(_Row_count), _Bins(_Bin_count)
+		{
+			const size_t _Per_line = _Histogram_row_alignment / sizeof(size_t);
+			const size_t _Stride = (_Bins + _Per_line - 1) / _Per_line * _Per_line;
+			size_t _Space = _Rows * _Stride * sizeof(size_t) + _Histogram_row_alignment;
+
+			// operator new only guarantees the alignment of the fundamental types
+			_Memory.reset(new unsigned char[_Space]);
+			void *_Ptr = _Memory.get();
+			size_t * const _Counters = static_cast<size_t *>(std::align(_Histogram_row_alignment, _Rows * _Stride * sizeof(size_t), _Ptr, _Space));
+
+			std::fill(_Counters, _Counters + _Rows * _Stride, size_t{ 0 });
+			for (size_t _Row = 0; _Row < _Rows; ++_Row)
+				_Row_begins[_Row] = _Counters + _Row * _Stride;
+		}
+
+		size_t *operator[](size_t _Row) const
+		{
+			return _Row_begins[_Row];
+		}
+
+		// The partitioners walk the rows, the offset from begin() is the chunk number
+		size_t * const *begin() const
+		{
+			return _Row_begins.get();
+		}
+
+		size_t rows() const
+		{
+			return _Rows;
+		}
+
+		size_t bins() const
+		{
+			return _Bins;
+		}
+
+		// Adds the other rows to the first one
+		const size_t *sum() const
+		{
+			size_t * const _Total = _Row_begins[0];
+			for (size_t _Row = 1; _Row < _Rows; ++_Row)
+			{
+				const size_t * const _Counts = _Row_begins[_Row];
+				for (size_t _Bin = 0; _Bin < _Bins; ++_Bin)
+					_Total[_Bin] += _Counts[_Bin];
+			}
+			return _Total;
+		}
+	};
+
+	// Counts the elements of a random access range into the rows, one row per chunk. The range is split
+	// as _Chunked_reduce splits it, _Rows must have _Reduction_chunk_count(_Policy, _Count) rows.
+	// An element goes to the bin _Key gives for it, the ones out of the bins are not counted.
+	template<typename _ExPolicy, typename _RanIt, typename _KeyFn>
+	void _Count_chunk_bins(const _ExPolicy& _Policy, _RanIt _First, size_t _Count, _KeyFn _Key, const _Histogram_rows& _Rows)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef _Partitioner<static_partitioner_tag, std::is_base_of<parallel_vector_execution_policy, _ExPolicy>::value> _Chunk_partitioner;
+		typedef size_t * const *_Row_iterator;
+
+		const size_t _Chunks = _Rows.rows();
+		const size_t _Step = _Count / _Chunks;
+		const size_t _Extra = _Count % _Chunks; // the first _Extra chunks take one element more
+		const size_t _Bins = _Rows.bins();
+		const _Row_iterator _Base = _Rows.begin();
+
+		_Chunk_partitioner::_For_Each(_Base, _Chunks, _Key,
+			[_Base, &_First, _Step, _Extra, _Bins](_Row_iterator _Begin, size_t _Row_count, _KeyFn& _UserKey) {
+			for (size_t _Chunk = _Begin - _Base, _End = _Chunk + _Row_count; _Chunk < _End; ++_Chunk)
+			{
+				size_t * const _Counts = _Base[_Chunk];
+				LoopHelper<_ExecutionPolicy, _RanIt>::Loop(_First + (_Chunk * _Step + (std::min)(_Chunk, _Extra)), _Step + (_Chunk < _Extra ? 1 : 0),
+					[_Counts, _Bins, &_UserKey](const typename std::iterator_traits<_RanIt>::reference _El) {
+					const size_t _Bin = static_cast<size_t>(_UserKey(_El));
+					if (_Bin < _Bins)
+						++_Counts[_Bin];
+				});
+			}
+		}, 1, _Policy.parameters().thread_limit());
+	}
+
+	//
+	// histogram
+	//
+	template <class _InIt, class _OutIt, class _KeyFn, class _IterCat>
+	_OutIt _Histogram_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key, _IterCat)
+	{
+		_EXP_TRY
+			return histogram(_First, _Last, _Dest, _Bins, _Key);
+		_EXP_RETHROW
+	}
+
+	// Every thread counts into a histogram of its own, the histograms are summed in parallel over the bins
+	template <class _ExPolicy, class _InIt, class _OutIt, class _KeyFn, class _IterCat>
+	_OutIt _Histogram_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key, _IterCat)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef std::vector<size_t> _Counters;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		std::vector<size_t> _Total(_Bins);
+		if (_First != _Last && _Bins != 0) {
+			combinable<_Counters> _Combine([_Bins] { return _Counters(_Bins); });
+
+			_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Key,
+				[&_Combine](_InIt _Begin, size_t _Count, _KeyFn& _UserKey) {
+				auto &_Counts = _Combine.local();
+				const size_t _Bins = _Counts.size();
+
+				LoopHelper<_ExecutionPolicy, _InIt>::Loop(_Begin, _Count, [&_Counts, _Bins, &_UserKey](const typename std::iterator_traits<_InIt>::reference _El) {
+					const size_t _Bin = static_cast<size_t>(_UserKey(_El));
+					if (_Bin < _Bins)
+						++_Counts[_Bin];
+				});
+			});
+
+			std::vector<const _Counters *> _Locals;
+			_Combine.combine_each([&_Locals](const _Counters& _Counts) {
+				_Locals.push_back(&_Counts);
+			});
+
+			_Partitioner<static_partitioner_tag, true>::_For_Each(_Total.data(), _Bins, 0,
+				[&_Locals, &_Total](size_t *_Begin, size_t _Count, int&) _EXP_NOEXCEPT_IF(true) {
+				const size_t _Offset = _Begin - _Total.data();
+				for (auto _Counts : _Locals)
+				{
+					const size_t * const _Src = _Counts->data() + _Offset;
+					_EXP_PRAGMA_VEC
+					_EXP_LOOP_IVDEP
+						for (size_t _I = 0; _I < _Count; ++_I)
+							_Begin[_I] += _Src[_I];
+				}
+			}, 0, _Policy.parameters().thread_limit());
+		}
+
+		return std::copy(std::begin(_Total), std::end(_Total), _Dest);
+	}
+
+	// Small histograms of random access ranges are counted per chunk, into rows on cache lines of their own
+	template <class _ExPolicy, class _RanIt, class _OutIt, class _KeyFn>
+	typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Histogram_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key, std::random_access_iterator_tag)
+	{
+		if (_Bins > _Histogram_private_bins)
+			return _Histogram_impl(_Policy, _First, _Last, _Dest, _Bins, _Key, std::forward_iterator_tag());
+
+		if (_First == _Last)
+			return std::fill_n(_Dest, _Bins, 0);
+
+		const size_t _Count = _Last - _First;
+		_Histogram_rows _Rows(_Reduction_chunk_count(_Policy, _Count), _Bins);
+		_Count_chunk_bins(_Policy, _First, _Count, _Key, _Rows);
+
+		const size_t *_Total = _Rows.sum();
+		return std::copy(_Total, _Total + _Bins, _Dest);
+	}
+
+	template <class _ExPolicy, class _InIt, class _OutIt, class _KeyFn>
+	typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Histogram_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key, std::input_iterator_tag _Cat)
+	{
+		return _Histogram_impl(seq, _First, _Last, _Dest, _Bins, _Key, _Cat);
+	}
+
+	template <class _InIt, class _OutIt, class _KeyFn, class _IterCat>
+	_OutIt _Histogram_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Histogram_impl, _Policy, _First, _Last, _Dest, _Bins, _Key, _Cat);
+	}
+} // details
+
+// Counts the elements of [_First, _Last) by the bin _Key gives for each of them, and writes the counts of
+// the _Bins bins to _Dest. The elements whose bin is not below _Bins are not counted. Returns the end
+// of the counts.
+template <class _ExPolicy, class _InIt, class _OutIt, class _KeyFn>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type histogram(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key)
+{
+	_EXP_TELEMETRY_ALGORITHM("histogram");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+
+	return details::_Histogram_impl(_Policy, _First, _Last, _Dest, _Bins, _Key, std::_Iter_cat(_First));
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_HISTOGRAM_H_
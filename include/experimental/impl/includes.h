@@ -4,12 +4,29 @@
 #define _IMPL_INCLUDES_H_ 1
 
 #include "algorithm_impl.h"
+#include "set_operations.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
 	//
 	// includes
 	//
+	template<class _InIt, class _InIt2, class _Pr, class _IterCat>
+	inline bool _Includes_chunk(_InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr& _Pred, _IterCat)
+	{
+		return std::includes(_First, _Last, _First2, _Last2, _Pred);
+	}
+
+	// A chunk of a few values looked up in a large range gallops over it, see set_intersection
+	template<class _RanIt, class _RanIt2, class _Pr>
+	inline bool _Includes_chunk(_RanIt _First, _RanIt _Last, _RanIt2 _First2, _RanIt2 _Last2, _Pr& _Pred, std::random_access_iterator_tag)
+	{
+		if (_Is_skewed(static_cast<size_t>(_Last - _First), static_cast<size_t>(_Last2 - _First2)))
+			return _Gallop_includes(_First, _Last, _First2, _Last2, _Pred);
+
+		return std::includes(_First, _Last, _First2, _Last2, _Pred);
+	}
+
 	template<class _InIt, class _InIt2, class _Pr, class _IterCat>
 	inline bool _Includes_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred, _IterCat)
 	{
@@ -19,7 +36,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _InIt2, class _Pr, class _IterCat>
-	inline bool _Includes_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred, _IterCat)
+	inline bool _Includes_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
@@ -30,7 +47,7 @@ namespace details {
 			auto _Size = std::distance(_First2, _Last2);
 			cancellation_token _Token;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First2, _Size, _Pred,
+			_Partitioned_for_each(_Policy, _First2, _Size, _Pred,
 				[_First, _Last, _First2, _Last2, &_Token](_InIt2 _Begin, size_t _Partition_count, _Pr& _UserPred) {
 				_ASSERTE(_Partition_count > 0);
 
@@ -52,7 +69,7 @@ namespace details {
 					return;
 				}
 
-				_InIt2 _HiBound;
+				_InIt _HiBound;
 
 				if (_End != _Last2) {
 					_HiBound = std::upper_bound(_LoBound, _Last, *_End, _UserPred);
@@ -60,7 +77,7 @@ namespace details {
 				}
 				else _HiBound = _Last;
 
-				if (!std::includes(_LoBound, _HiBound, _Begin, _End, _UserPred))
+				if (!_Includes_chunk(_LoBound, _HiBound, _Begin, _End, _UserPred, _IterCat()))
 					_Token.cancel();
 			});
 
@@ -86,6 +103,7 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type includes(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("includes");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -96,6 +114,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type includes(_ExPo
 template<class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type includes(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("includes");
 	return includes(_Policy, _First, _Last, _First2, _Last2, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
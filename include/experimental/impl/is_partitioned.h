@@ -19,7 +19,7 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _Pr, class _IterTag>
-	inline bool _Is_partitioned_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, _IterTag)
+	inline bool _Is_partitioned_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Pr _Pred, _IterTag)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_InIt>::difference_type difference_type;
@@ -28,7 +28,7 @@ namespace details {
 		if (_Size > 1) {
 			cancellation_token _Token;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size - 1, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Size - 1, _Pred,
 				[&_Token](_InIt _Begin, size_t _Count, _Pr& _UserPred) {
 				_ASSERTE(_Count > 0); // Must process at least 1 element
 
@@ -67,6 +67,7 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type is_partitioned(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("is_partitioned");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Is_partitioned_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -19,7 +19,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
-	inline bool _Is_sorted_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	inline bool _Is_sorted_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
@@ -28,7 +28,7 @@ namespace details {
 		{
 			cancellation_token _Token;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Diff - 1, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Diff - 1, _Pred,
 				[&_Token](_FwdIt& _Begin, size_t _Count, _Pr& _UserPred){
 				_ASSERTE(_Count > 0); // Must process at least 1 element
 
@@ -68,7 +68,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
-	inline _FwdIt _Is_sorted_until_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	inline _FwdIt _Is_sorted_until_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_FwdIt>::difference_type difference_type;
@@ -78,13 +78,14 @@ namespace details {
 		{
 			cancellation_token_with_position<difference_type> _Token(_Diff);
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Diff - 1, _Pred,
+			_Partitioned_for_each(_Policy, _First, _Diff - 1, _Pred,
 				[&_First, &_Token](_FwdIt& _Begin, size_t _Count, _Pr _UserPred){
 				_ASSERTE(_Count > 0); // Must process at least 1 element
 
 				auto _Dist = std::distance(_First, _Begin);
 				auto _Curr = _Begin;
 				auto _Begin_pos = size_t{ 1 };
+				_Cancellation_poll<_FwdIt> _Poll;
 
 				// Start loop form the next element
 				++_Begin;
@@ -96,7 +97,7 @@ namespace details {
 						return;
 					}
 
-					if (_Token.is_cancelled(_Dist))
+					if (_Poll.due() && _Token.is_cancelled(_Dist + _Begin_pos))
 						return;
 
 					_Curr = _Begin;
@@ -123,6 +124,7 @@ namespace details {
 template <class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type is_sorted(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("is_sorted");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Is_sorted_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -131,6 +133,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type is_sorted(_ExP
 template <class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type is_sorted(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("is_sorted");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Is_sorted_impl(_Policy, _First, _Last, std::less<>(), std::_Iter_cat(_First));
@@ -139,6 +142,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type is_sorted(_ExP
 template <class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type is_sorted_until(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("is_sorted_until");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Is_sorted_until_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -147,6 +151,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type is_sorted_un
 template <class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type is_sorted_until(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("is_sorted_until");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return is_sorted_until(_Policy, _First, _Last, std::less<>());
@@ -19,6 +19,29 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	// std::less orders the integers and pointers totally, the elements neither is less than are the
+	// equal ones and the ranges are compared with equal_to, through memcmp
+	template<typename _InIt, typename _InIt2, typename _Pr, typename _El = typename std::iterator_traits<_InIt>::value_type>
+	struct _Is_memcmp_less : std::integral_constant<bool, _Is_memcmp_equal<_InIt, _InIt2, std::equal_to<>>::value
+		&& (std::is_same<_Pr, std::less<>>::value || std::is_same<_Pr, std::less<_El>>::value)>
+	{
+	};
+
+	template<class _ExPolicy, class _InIt, class _InIt2, class _Pr, class _IterCat>
+	inline std::pair<_InIt, _InIt2> _Lexicographical_mismatch(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr, _IterCat _Cat, std::true_type)
+	{
+		return _Mismatch_impl(_Policy, _First, _Last, _First2, _Last2, std::equal_to<>(), _Cat);
+	}
+
+	template<class _ExPolicy, class _InIt, class _InIt2, class _Pr, class _IterCat>
+	inline std::pair<_InIt, _InIt2> _Lexicographical_mismatch(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred, _IterCat _Cat, std::false_type)
+	{
+		return _Mismatch_impl(_Policy, _First, _Last, _First2, _Last2,
+			[_Pred](std::iterator_traits<_InIt>::reference _Val, std::iterator_traits<_InIt2>::reference _Val2) {
+			return !(_Pred(_Val, _Val2) || _Pred(_Val2, _Val));
+		}, _Cat);
+	}
+
 	template<class _ExPolicy, class _InIt, class _InIt2, class _Pr, class _IterCat>
 	inline bool _Lexicographical_compare_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred, _IterCat _Cat)
 	{
@@ -27,10 +50,7 @@ namespace details {
 
 		if (_First != _Last && _First2 != _Last2) {
 
-			auto _Pair = _Mismatch_impl(_Policy, _First, _Last, _First2, _Last2,
-				[_Pred](std::iterator_traits<_InIt>::reference _Val, std::iterator_traits<_InIt2>::reference _Val2) {
-				return !(_Pred(_Val, _Val2) || _Pred(_Val2, _Val));
-			}, _Cat);
+			auto _Pair = _Lexicographical_mismatch(_Policy, _First, _Last, _First2, _Last2, _Pred, _Cat, _Is_memcmp_less<_InIt, _InIt2, _Pr>());
 
 			if (_Pair.first != _Last && _Pair.second != _Last2)
 				return _Pred(*_Pair.first, *_Pair.second);
@@ -56,6 +76,7 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type lexicographical_compare(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("lexicographical_compare");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -66,6 +87,7 @@ inline typename details::_enable_if_policy<_ExPolicy, bool>::type lexicographica
 template<class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, bool>::type lexicographical_compare(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("lexicographical_compare");
 	return lexicographical_compare(_Policy, _First, _Last, _First2, _Last2, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
@@ -0,0 +1,232 @@
+#pragma once
+
+#ifndef _IMPL_MAPPED_VIEW_H_
+#define _IMPL_MAPPED_VIEW_H_ 1
+
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     How the algorithms are going to walk a mapped file, the system reads ahead of the pages touched
+///     when the access is sequential.
+/// </summary>
+enum class mapped_access
+{
+	normal,
+	sequential,
+	random
+};
+
+namespace details {
+
+	// A file mapped to the address space of the process, _Data is null for an empty file
+	struct _Mapped_file
+	{
+		void *_File;
+		void *_Mapping;
+		void *_Data;
+		unsigned long long _Size;
+	};
+
+	// Same layout as WIN32_MEMORY_RANGE_ENTRY
+	struct _Mapped_range
+	{
+		const void *_Address;
+		size_t _Bytes;
+	};
+
+	// Maps the whole file for reading, the pages of a copy on write mapping written to stay private to
+	// the process. Throws std::system_error when the file can't be opened or mapped.
+	_EXP_IMPL void __cdecl _Map_file(const wchar_t *_Path, bool _Copy_on_write, mapped_access _Access, _Mapped_file& _File);
+
+	_EXP_IMPL void __cdecl _Unmap_file(_Mapped_file& _File);
+
+	// Asks the system to read the ranges in the background, in this order. Returns at once, does nothing
+	// before Windows 8.
+	_EXP_IMPL void __cdecl _Prefetch_mapped(const _Mapped_range *_Ranges, size_t _Count);
+
+	// Unmaps the file when the last view of it goes away
+	class _Mapped_file_owner
+	{
+		_Mapped_file _File;
+
+		_Mapped_file_owner(const _Mapped_file_owner&);
+		_Mapped_file_owner& operator=(const _Mapped_file_owner&);
+	public:
+		_Mapped_file_owner(const wchar_t *_Path, bool _Copy_on_write, mapped_access _Access)
+		{
+			_Map_file(_Path, _Copy_on_write, _Access, _File);
+		}
+
+		~_Mapped_file_owner()
+		{
+			_Unmap_file(_File);
+		}
+
+		char *_Data() const
+		{
+			return static_cast<char *>(_File._Data);
+		}
+
+		unsigned long long _Size() const
+		{
+			return _File._Size;
+		}
+	};
+
+	// Bytes read ahead at the front of a chunk, enough for the system to keep the disk busy until the
+	// chore reaches the pages its sequential read ahead brings in
+	const size_t _Prefetch_window = 4 * 1024 * 1024;
+
+	//
+	// Prefetch of the front of the chunks in the order the partitioner hands them out
+	//
+	inline void _Prefetch_chunks_impl(const sequential_execution_policy&, const char *_Data, size_t _Bytes, size_t _Window)
+	{
+		const _Mapped_range _Range = { _Data, (std::min)(_Bytes, _Window) };
+		_Prefetch_mapped(&_Range, 1);
+	}
+
+	// The static partitioners give every thread a chunk of its own, the fronts of the chunks are read first.
+	// The others claim their chunks from the front of the range, so the range is read ahead from there.
+	template<class _ExPolicy>
+	inline void _Prefetch_chunks_impl(const _ExPolicy& _Policy, const char *_Data, size_t _Bytes, size_t _Window)
+	{
+		const unsigned int _Threads = _Policy_thread_count(_Policy);
+		const partitioner_kind _Kind = _Policy.parameters().partitioner_choice();
+		if (_Kind != partitioner_kind::static_ && !std::is_same<_ExPolicy, parallel_affinity_execution_policy>::value)
+		{
+			const _Mapped_range _Range = { _Data, (std::min)(_Bytes, _Window * _Threads) };
+			_Prefetch_mapped(&_Range, 1);
+			return;
+		}
+
+		std::vector<_Mapped_range> _Ranges;
+		_Ranges.reserve(_Threads);
+		const size_t _Chunk = (_Bytes + _Threads - 1) / _Threads;
+		for (size_t _Offset = 0; _Offset < _Bytes; _Offset += _Chunk)
+		{
+			const _Mapped_range _Range = { _Data + _Offset, (std::min)((std::min)(_Chunk, _Bytes - _Offset), _Window) };
+			_Ranges.push_back(_Range);
+		}
+		_Prefetch_mapped(_Ranges.data(), _Ranges.size());
+	}
+
+	inline void _Prefetch_chunks_impl(const execution_policy& _Policy, const char *_Data, size_t _Bytes, size_t _Window)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Prefetch_chunks_impl, _Policy, _Data, _Bytes, _Window);
+	}
+} // details
+
+/// <summary>
+///     An array_view of the elements stored in a file, the file is mapped to memory and the algorithms
+///     read it from the page cache without copying it. A view of const elements maps the file read only,
+///     otherwise the pages are copied on write and the changes never reach the file. The copies of the
+///     view share the mapping, the file is unmapped with the last of them.
+/// </summary>
+template<class _Ty, int _Rank = 1>
+class mapped_array_view : public D4087::array_view<_Ty, _Rank>
+{
+	typedef D4087::array_view<_Ty, _Rank> _Base;
+	static_assert(std::is_trivially_copyable<_Ty>::value, "Required trivially copyable elements.");
+
+	std::shared_ptr<details::_Mapped_file_owner> _Owner;
+
+	static _Ty *_Elements(const details::_Mapped_file_owner& _File, const D4087::bounds<_Rank>& _Bnd, unsigned long long _Offset)
+	{
+		_ASSERTE(_Offset % std::alignment_of<_Ty>::value == 0);
+		if (_Offset > _File._Size() || (_File._Size() - _Offset) / sizeof(_Ty) < static_cast<unsigned long long>(_Bnd.size()))
+			throw std::out_of_range("The bounds of the mapped view pass the end of the file.");
+
+		return reinterpret_cast<_Ty *>(_File._Data() + _Offset);
+	}
+
+	mapped_array_view(const std::shared_ptr<details::_Mapped_file_owner>& _File, const D4087::bounds<_Rank>& _Bnd, unsigned long long _Offset)
+		: _Base(_Bnd, _Elements(*_File, _Bnd, _Offset)), _Owner(_File)
+	{
+	}
+
+	mapped_array_view(const std::shared_ptr<details::_Mapped_file_owner>& _File, unsigned long long _Offset)
+		: mapped_array_view(_File, _Whole_file(*_File, _Offset), _Offset)
+	{
+	}
+
+	static std::shared_ptr<details::_Mapped_file_owner> _Map(const wchar_t *_Path, mapped_access _Access)
+	{
+		return std::make_shared<details::_Mapped_file_owner>(_Path, !std::is_const<_Ty>::value, _Access);
+	}
+
+	static D4087::bounds<1> _Whole_file(const details::_Mapped_file_owner& _File, unsigned long long _Offset)
+	{
+		const unsigned long long _Bytes = _Offset < _File._Size() ? _File._Size() - _Offset : 0;
+		return D4087::bounds<1>(static_cast<ptrdiff_t>(_Bytes / sizeof(_Ty)));
+	}
+
+public:
+	mapped_array_view()
+	{
+	}
+
+	/// <summary>
+	///     Maps the elements of _Bnd stored in row major order from the byte _Offset of the file on.
+	/// </summary>
+	mapped_array_view(const wchar_t *_Path, const D4087::bounds<_Rank>& _Bnd, unsigned long long _Offset = 0, mapped_access _Access = mapped_access::sequential)
+		: mapped_array_view(_Map(_Path, _Access), _Bnd, _Offset)
+	{
+	}
+
+	/// <summary>
+	///     Maps the elements from the byte _Offset of the file to its end, a partial element at the end is left out.
+	/// </summary>
+	template<int _Dummy_rank = _Rank, typename = typename std::enable_if<_Dummy_rank == 1>::type>
+	explicit mapped_array_view(const wchar_t *_Path, unsigned long long _Offset = 0, mapped_access _Access = mapped_access::sequential)
+		: mapped_array_view(_Map(_Path, _Access), _Offset)
+	{
+	}
+
+	/// <summary>
+	///     Asks the system to read the elements of the run of _Count elements from _Origin in row major order, while
+	///     the algorithm works on the elements before them.
+	/// </summary>
+	void prefetch(const D4087::index<_Rank>& _Origin, size_t _Count) const
+	{
+		ptrdiff_t _Offset = 0;
+		for (int _I = 0; _I < _Rank; ++_I)
+			_Offset += _Origin[_I] * _Base::stride()[_I];
+		const size_t _Available = static_cast<size_t>(_Base::size() - _Offset);
+
+		const details::_Mapped_range _Range = { _Base::data() + _Offset, (std::min)(_Count, _Available) * sizeof(_Ty) };
+		if (_Range._Bytes != 0)
+			details::_Prefetch_mapped(&_Range, 1);
+	}
+
+	/// <summary>
+	///     Asks the system to read the front of the chunks _Policy splits the view into, in the order the threads
+	///     reach them. A call before the algorithm lets the first pages of every chunk arrive together, the
+	///     sequential read ahead of the system streams the rest of them.
+	/// </summary>
+	template<class _ExPolicy>
+	typename details::_enable_if_policy<_ExPolicy, void>::type prefetch(_ExPolicy&& _Policy, size_t _Window = details::_Prefetch_window) const
+	{
+		const size_t _Bytes = _Base::size() * sizeof(_Ty);
+		if (_Bytes != 0)
+			details::_Prefetch_chunks_impl(_Policy, reinterpret_cast<const char *>(_Base::data()), _Bytes, _Window);
+	}
+};
+
+namespace details {
+
+	// The view algorithms take the mapped views as the array_views they are
+	template<typename _Ty, int _Rank, typename _Ret>
+	struct _enable_if_view<mapped_array_view<_Ty, _Rank>, _Ret>
+	{
+		typedef _Ret type;
+	};
+} // details
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_MAPPED_VIEW_H_
@@ -0,0 +1,309 @@
+#pragma once
+
+#ifndef _IMPL_MEMORY_RESOURCE_H_
+#define _IMPL_MEMORY_RESOURCE_H_
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include "defines.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     The memory_resource is the source of the scratch storage of the parallel algorithms, the buffers, masks and
+///     partial results they allocate for the time of a call. It is attached to a policy with the scratch_resource
+///     execution parameter. The chores of a call allocate from it concurrently, a resource must be thread safe.
+/// </summary>
+class memory_resource
+{
+public:
+	static const size_t _Max_align = std::alignment_of<std::max_align_t>::value;
+
+	virtual ~memory_resource()
+	{
+	}
+
+	/// <summary>
+	///     Allocates _Bytes bytes aligned to _Alignment, throws std::bad_alloc if it can't.
+	/// </summary>
+	void *allocate(size_t _Bytes, size_t _Alignment = _Max_align)
+	{
+		return do_allocate(_Bytes, _Alignment);
+	}
+
+	/// <summary>
+	///     Releases the storage returned by an allocate call of the same size and alignment.
+	/// </summary>
+	void deallocate(void *_Ptr, size_t _Bytes, size_t _Alignment = _Max_align)
+	{
+		do_deallocate(_Ptr, _Bytes, _Alignment);
+	}
+
+	/// <summary>
+	///     Returns true if the storage allocated from either resource can be released to the other.
+	/// </summary>
+	bool is_equal(const memory_resource& _Other) const _NOEXCEPT
+	{
+		return do_is_equal(_Other);
+	}
+
+protected:
+	virtual void *do_allocate(size_t _Bytes, size_t _Alignment) = 0;
+	virtual void do_deallocate(void *_Ptr, size_t _Bytes, size_t _Alignment) = 0;
+
+	virtual bool do_is_equal(const memory_resource& _Other) const _NOEXCEPT
+	{
+		return this == &_Other;
+	}
+};
+
+/// <summary>
+///     Returns a resource that calls the global operator new and operator delete, the upstream resource of the
+///     resources here by default.
+/// </summary>
+_EXP_IMPL memory_resource * __cdecl new_delete_resource() _NOEXCEPT;
+
+/// <summary>
+///     Sets the most bytes of scratch storage a thread keeps for the next calls of the algorithms whose policy has
+///     no scratch_resource, 0 turns the cache off. Returns the previous limit. The cache of the calling thread is
+///     trimmed to the new limit at once, the ones of the other threads the next time they release a block.
+/// </summary>
+/// <remarks>
+///     The blocks of 64KB and more are kept, each thread keeps no more than the limit and no more than it had in use
+///     at once over its last calls. The default limit is 256MB.
+/// </remarks>
+_EXP_IMPL size_t __cdecl set_scratch_cache_limit(size_t _Bytes) _NOEXCEPT;
+
+/// <summary>
+///     Returns the most bytes of scratch storage a thread keeps.
+/// </summary>
+_EXP_IMPL size_t __cdecl scratch_cache_limit() _NOEXCEPT;
+
+/// <summary>
+///     Returns the bytes of scratch storage the calling thread keeps.
+/// </summary>
+_EXP_IMPL size_t __cdecl scratch_cache_retained_bytes() _NOEXCEPT;
+
+/// <summary>
+///     Releases the scratch storage the calling thread keeps.
+/// </summary>
+_EXP_IMPL void __cdecl trim_scratch_cache() _NOEXCEPT;
+
+/// <summary>
+///     A resource that hands out its storage from blocks of its upstream resource and releases it all at once, when
+///     it is destroyed or release is called. A deallocate call does nothing, a monotonic_buffer_resource suits the
+///     scratch storage of a request: it is reset once the request is served.
+/// </summary>
+class monotonic_buffer_resource : public memory_resource
+{
+	struct _Block
+	{
+		_Block *_Next;
+		size_t _Size;
+		size_t _Alignment;
+	};
+
+	memory_resource *_Upstream;
+	_Block *_Blocks;
+	char *_Current;
+	size_t _Left;
+	size_t _Next_size;
+	std::mutex _Lock;
+
+	monotonic_buffer_resource(const monotonic_buffer_resource&);
+	monotonic_buffer_resource& operator=(const monotonic_buffer_resource&);
+
+	static const size_t _Default_block_size = 64 * 1024;
+
+public:
+	explicit monotonic_buffer_resource(memory_resource *_Up = new_delete_resource())
+		: _Upstream(_Up), _Blocks(nullptr), _Current(nullptr), _Left(0), _Next_size(_Default_block_size)
+	{
+	}
+
+	/// <summary>
+	///     Constructs a resource whose first block from the upstream resource holds _Initial_size bytes.
+	/// </summary>
+	monotonic_buffer_resource(size_t _Initial_size, memory_resource *_Up = new_delete_resource())
+		: _Upstream(_Up), _Blocks(nullptr), _Current(nullptr), _Left(0), _Next_size(_Initial_size != 0 ? _Initial_size : 1)
+	{
+	}
+
+	~monotonic_buffer_resource()
+	{
+		release();
+	}
+
+	/// <summary>
+	///     Returns the blocks to the upstream resource, the storage handed out is released all at once.
+	/// </summary>
+	void release()
+	{
+		std::lock_guard<std::mutex> _Guard(_Lock);
+		while (_Blocks != nullptr)
+		{
+			_Block *_Next = _Blocks->_Next;
+			_Upstream->deallocate(_Blocks, _Blocks->_Size, _Blocks->_Alignment);
+			_Blocks = _Next;
+		}
+
+		_Current = nullptr;
+		_Left = 0;
+	}
+
+	/// <summary>
+	///     Returns the resource the blocks are allocated from.
+	/// </summary>
+	memory_resource *upstream_resource() const _NOEXCEPT
+	{
+		return _Upstream;
+	}
+
+protected:
+	virtual void *do_allocate(size_t _Bytes, size_t _Alignment) override
+	{
+		std::lock_guard<std::mutex> _Guard(_Lock);
+
+		size_t _Pad = (_Alignment - reinterpret_cast<size_t>(_Current) % _Alignment) % _Alignment;
+		if (_Current == nullptr || _Left < _Pad || _Left - _Pad < _Bytes)
+		{
+			// The blocks grow geometrically, a request larger than the next block gets a block of its own size
+			const size_t _Header = (sizeof(_Block) + _Alignment - 1) / _Alignment * _Alignment;
+			const size_t _Size = (std::max)(_Next_size, _Header + _Bytes);
+			const size_t _Block_alignment = _Alignment > _Max_align ? _Alignment : _Max_align;
+			_Block *_New = static_cast<_Block *>(_Upstream->allocate(_Size, _Block_alignment));
+			_New->_Next = _Blocks;
+			_New->_Size = _Size;
+			_New->_Alignment = _Block_alignment;
+			_Blocks = _New;
+
+			_Current = reinterpret_cast<char *>(_New) + _Header;
+			_Left = _Size - _Header;
+			_Next_size = _Size * 2;
+			_Pad = 0;
+		}
+
+		void *_Ptr = _Current + _Pad;
+		_Current += _Pad + _Bytes;
+		_Left -= _Pad + _Bytes;
+		return _Ptr;
+	}
+
+	virtual void do_deallocate(void *, size_t, size_t) override
+	{
+	}
+};
+
+/// <summary>
+///     A resource that counts the bytes allocated from its upstream resource and not yet released. Its peak is the
+///     scratch storage a call needed at most: attach the tracker to the policy, reset it before the call and read the
+///     peak after.
+/// </summary>
+class scratch_tracker : public memory_resource
+{
+	memory_resource *_Upstream;
+	std::atomic<size_t> _In_use;
+	std::atomic<size_t> _Peak;
+
+	scratch_tracker(const scratch_tracker&);
+	scratch_tracker& operator=(const scratch_tracker&);
+
+public:
+	explicit scratch_tracker(memory_resource *_Up = new_delete_resource()) : _Upstream(_Up), _In_use(0), _Peak(0)
+	{
+	}
+
+	/// <summary>
+	///     Returns the bytes allocated and not released.
+	/// </summary>
+	size_t bytes_in_use() const _NOEXCEPT
+	{
+		return _In_use.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///     Returns the most bytes that were in use at once since the construction or the last reset.
+	/// </summary>
+	size_t peak() const _NOEXCEPT
+	{
+		return _Peak.load(std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///     Starts the peak over from the bytes in use.
+	/// </summary>
+	void reset() _NOEXCEPT
+	{
+		_Peak.store(_In_use.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+
+	/// <summary>
+	///     Returns the resource the storage is allocated from.
+	/// </summary>
+	memory_resource *upstream_resource() const _NOEXCEPT
+	{
+		return _Upstream;
+	}
+
+protected:
+	virtual void *do_allocate(size_t _Bytes, size_t _Alignment) override
+	{
+		void *_Ptr = _Upstream->allocate(_Bytes, _Alignment);
+
+		const size_t _Now = _In_use.fetch_add(_Bytes, std::memory_order_relaxed) + _Bytes;
+		size_t _Max = _Peak.load(std::memory_order_relaxed);
+		while (_Now > _Max && !_Peak.compare_exchange_weak(_Max, _Now, std::memory_order_relaxed))
+		{
+		}
+		return _Ptr;
+	}
+
+	virtual void do_deallocate(void *_Ptr, size_t _Bytes, size_t _Alignment) override
+	{
+		_Upstream->deallocate(_Ptr, _Bytes, _Alignment);
+		_In_use.fetch_sub(_Bytes, std::memory_order_relaxed);
+	}
+};
+
+namespace details {
+	// The scratch resource of the calling thread, null for the default. The chores a thread schedules run
+	// with the resource it had when they were scheduled.
+	_EXP_IMPL memory_resource * __cdecl _Thread_scratch_resource() _NOEXCEPT;
+
+	// Sets the scratch resource of the calling thread and returns the previous one
+	_EXP_IMPL memory_resource * __cdecl _Exchange_thread_scratch_resource(memory_resource *_Resource) _NOEXCEPT;
+
+	// The resource of the scratch storage of the policies without one: the large blocks are kept in a cache
+	// of the thread that releases them, for the next calls
+	_EXP_IMPL memory_resource * __cdecl _Default_scratch_resource() _NOEXCEPT;
+
+	// The resource the scratch storage is allocated from on the calling thread
+	inline memory_resource *_Scratch_resource() _NOEXCEPT
+	{
+		memory_resource *_Resource = _Thread_scratch_resource();
+		return _Resource != nullptr ? _Resource : _Default_scratch_resource();
+	}
+
+	// Storage for _Count values of _Ty from a resource, the resource is kept to release it
+	template<typename _Ty>
+	inline _Ty *_Allocate_scratch(memory_resource *_Resource, size_t _Count)
+	{
+		if (_Count > static_cast<size_t>(-1) / sizeof(_Ty))
+			throw std::bad_alloc();
+		return static_cast<_Ty *>(_Resource->allocate(_Count * sizeof(_Ty), std::alignment_of<_Ty>::value));
+	}
+
+	template<typename _Ty>
+	inline void _Deallocate_scratch(memory_resource *_Resource, _Ty *_Ptr, size_t _Count)
+	{
+		_Resource->deallocate(_Ptr, _Count * sizeof(_Ty), std::alignment_of<_Ty>::value);
+	}
+}
+
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_MEMORY_RESOURCE_H_
@@ -3,6 +3,11 @@
 #ifndef _IMPL_MERGE_H_
 #define _IMPL_MERGE_H_ 1
 
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include "algorithm_impl.h"
 #include "taskgroup.h"
 
@@ -55,33 +60,70 @@ namespace details {
 		return _Len;
 	}
 
-	// _Div_num of threads(tasks) merge two chunks in parallel, _Div_num should be power of 2, if not, the largest power of 2 that is
-	// smaller than _Div_num will be used
+	// Output values a merge task writes at least, smaller merges are left to fewer tasks
+	const size_t _Merge_min_part = 512;
+
+	// Co-rank on the merge path: how many of the first _Diag values of the merge come from the first range. Values of
+	// the first range go before equal values of the second, as in std::merge.
+	template<typename _Random_iterator, typename _Random_buffer_iterator, typename _Function>
+	size_t _Merge_path_split(const _Random_iterator &_Begin1, size_t _Len1, const _Random_buffer_iterator &_Begin2, size_t _Len2, size_t _Diag, _Function &_Func)
+	{
+		size_t _Lower = _Diag > _Len2 ? _Diag - _Len2 : 0, _Upper = (std::min)(_Diag, _Len1);
+		while (_Lower < _Upper)
+		{
+			const size_t _Mid = (_Lower + _Upper) / 2;
+			if (_Func(_Begin2[_Diag - _Mid - 1], _Begin1[_Mid]))
+				_Upper = _Mid;
+			else
+				_Lower = _Mid + 1;
+		}
+
+		return _Lower;
+	}
+
+	// Merge tasks for _Size output values
+	inline size_t _Merge_parts(size_t _Size, size_t _Div_num)
+	{
+		return (std::max)((std::min)(_Div_num, _Size / _Merge_min_part), size_t{ 1 });
+	}
+
+	// _Div_num of threads(tasks) merge two chunks in parallel. Every task merges the exact slice of the output it writes
+	// on the merge path sequentially, so the slices are of the same size and nothing is split twice. The splits are all
+	// found before the tasks start, a merge that moves the values would leave the searches of a task reading values
+	// another one moved out.
 	template<typename _Random_iterator, typename _Random_buffer_iterator, typename _Random_output_iterator, typename _Function>
 	void _Parallel_merge(_Random_iterator _Begin1, size_t _Len1, _Random_buffer_iterator _Begin2, size_t _Len2, _Random_output_iterator _Output,
 		_Function &_Func, size_t _Div_num)
 	{
-		// Turn to serial merge or continue splitting chunks base on "_Div_num"
-		if (_Div_num <= 1 || (_Len1 <= 1 && _Len2 <= 1))
+		const size_t _Size = _Len1 + _Len2;
+		const size_t _Parts = _Merge_parts(_Size, _Div_num);
+
+		if (_Parts == 1)
 		{
 			std::merge(_Begin1, _Begin1 + _Len1, _Begin2, _Begin2 + _Len2, _Output, _Func);
+			return;
 		}
-		else
-		{
-			size_t _Mid_len1 = _Len1, _Mid_len2 = _Len2;
-			size_t _Mid = _Search_mid_point(_Begin1, _Mid_len1, _Begin2, _Mid_len2, _Func);
 
-			TaskGroup _Tg;
-			auto _Handle = make_task([&]
-			{
-				_Parallel_merge(_Begin1, _Mid_len1, _Begin2, _Mid_len2, _Output, _Func, _Div_num / 2);
-			});
-			_Tg.run(_Handle);
+		std::vector<size_t> _Splits(_Parts + 1, _Len1); // values of the first range before the slice of each task
+		for (size_t _Part = 0; _Part < _Parts; ++_Part)
+			_Splits[_Part] = _Merge_path_split(_Begin1, _Len1, _Begin2, _Len2, _Size * _Part / _Parts, _Func);
 
-			_Parallel_merge(_Begin1 + _Mid_len1, _Len1 - _Mid_len1, _Begin2 + _Mid_len2, _Len2 - _Mid_len2, _Output + _Mid, _Func, _Div_num / 2);
+		_Run_blocks(_Parts, [&](size_t _Part) {
+			const size_t _Diag_begin = _Size * _Part / _Parts, _Diag_end = _Size * (_Part + 1) / _Parts;
+			const size_t _First1 = _Splits[_Part], _Last1 = _Splits[_Part + 1];
 
-			_Tg.wait();
-		}
+			std::merge(_Begin1 + _First1, _Begin1 + _Last1, _Begin2 + (_Diag_begin - _First1), _Begin2 + (_Diag_end - _Last1),
+				_Output + _Diag_begin, _Func);
+		});
+	}
+
+	// _Parallel_merge that moves the values to _Output, for the merges of a sort between its range and its buffer. A
+	// string or a vector moves its storage over in place of copying it.
+	template<typename _Random_iterator, typename _Random_buffer_iterator, typename _Random_output_iterator, typename _Function>
+	void _Parallel_move_merge(_Random_iterator _Begin1, size_t _Len1, _Random_buffer_iterator _Begin2, size_t _Len2, _Random_output_iterator _Output,
+		_Function &_Func, size_t _Div_num)
+	{
+		_Parallel_merge(std::make_move_iterator(_Begin1), _Len1, std::make_move_iterator(_Begin2), _Len2, _Output, _Func, _Div_num);
 	}
 
 	// _Div_num of threads(tasks) merge two chunks in parallel, _Div_num should be power of 2, if not, the largest power of 2 that is
@@ -119,6 +161,141 @@ namespace details {
 		}
 	}
 
+	// Where the slice of the merge path a task of _Parallel_buffered_inplace_merge moves to the buffer starts in
+	// either range, and how many values of either range it has moved so far
+	struct _Merge_slice
+	{
+		size_t _First1;
+		size_t _First2;
+		size_t _Taken1;
+		size_t _Taken2;
+	};
+
+	// std::merge that moves the values and constructs them at _Output, in raw storage. The slice counts the values
+	// taken from either range as they are constructed, so a comparison that throws leaves it telling what to undo.
+	template<typename _Random_iterator, typename _Ty, typename _Function>
+	void _Merge_construct(_Random_iterator _First1, _Random_iterator _Last1, _Random_iterator _First2, _Random_iterator _Last2, _Ty *_Output,
+		_Function &_Func, _Merge_slice& _Slice)
+	{
+		for (; _First1 != _Last1 && _First2 != _Last2; ++_Output)
+		{
+			if (_Func(*_First2, *_First1))
+			{
+				::new (static_cast<void*>(_Output)) _Ty(std::move(*_First2++));
+				++_Slice._Taken2;
+			}
+			else
+			{
+				::new (static_cast<void*>(_Output)) _Ty(std::move(*_First1++));
+				++_Slice._Taken1;
+			}
+		}
+
+		for (; _First1 != _Last1; ++_First1, ++_Output, ++_Slice._Taken1)
+			::new (static_cast<void*>(_Output)) _Ty(std::move(*_First1));
+
+		for (; _First2 != _Last2; ++_First2, ++_Output, ++_Slice._Taken2)
+			::new (static_cast<void*>(_Output)) _Ty(std::move(*_First2));
+	}
+
+	// Moves the values a slice constructed in the buffer back to the places they were taken from and destroys them.
+	// The values keep their range but not their order in it, none is lost.
+	template<typename _Random_iterator, typename _Ty>
+	void _Undo_merge_slice(_Random_iterator _Begin1, _Random_iterator _Begin2, _Ty *_Buf, const _Merge_slice& _Slice)
+	{
+		for (size_t _I = 0; _I < _Slice._Taken1 + _Slice._Taken2; ++_I)
+		{
+			if (_I < _Slice._Taken1)
+				_Begin1[_Slice._First1 + _I] = std::move(_Buf[_I]);
+			else
+				_Begin2[_Slice._First2 + (_I - _Slice._Taken1)] = std::move(_Buf[_I]);
+			_Buf[_I].~_Ty();
+		}
+	}
+
+	// Merges the two chunks on the merge path into a temporary buffer and moves the result back, both in parallel,
+	// two moves per value in place of the rotations. Falls back to _Parallel_inplace_merge without the buffer.
+	// A comparison that throws leaves the tasks to finish their slices, then every slice is moved back to the
+	// range before the exceptions are thrown, so the range holds all of its values, out of order.
+	template<typename _Random_iterator, typename _Function>
+	void _Parallel_buffered_inplace_merge(_Random_iterator _Begin1, size_t _Len1, size_t _Len2, _Function &_Func, size_t _Div_num, std::true_type)
+	{
+		typedef typename std::iterator_traits<_Random_iterator>::value_type _Ty;
+
+		const size_t _Size = _Len1 + _Len2;
+		const size_t _Parts = _Merge_parts(_Size, _Div_num);
+		if (_Parts == 1)
+			return std::inplace_merge(_Begin1, _Begin1 + _Len1, _Begin1 + _Size, _Func);
+
+		std::unique_ptr<_Uninitialized_buffer<_Ty>> _Buffer;
+		std::vector<_Merge_slice> _Slices;
+		try
+		{
+			_Buffer.reset(new _Uninitialized_buffer<_Ty>(_Size));
+			_Slices.resize(_Parts);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return _Parallel_inplace_merge(_Begin1, _Len1, _Len2, _Func, _Div_num);
+		}
+
+		// The splits are all found before any value is moved out, the searches of a task read the values of the others
+		std::vector<size_t> _Splits(_Parts + 1, _Len1); // values of the first range before the slice of each task
+		_EXP_TRY
+			for (size_t _Part = 0; _Part < _Parts; ++_Part)
+				_Splits[_Part] = _Merge_path_split(_Begin1, _Len1, _Begin1 + _Len1, _Len2, _Size * _Part / _Parts, _Func);
+		_EXP_RETHROW
+
+		_Ty *_Buf = _Buffer->get();
+		const _Random_iterator _Begin2 = _Begin1 + _Len1;
+		std::mutex _Lock;
+		std::list<std::exception_ptr> _Exceptions; // lock protected
+		_Run_blocks(_Parts, [&](size_t _Part) {
+			const size_t _Diag_begin = _Size * _Part / _Parts, _Diag_end = _Size * (_Part + 1) / _Parts;
+			const size_t _First1 = _Splits[_Part], _Last1 = _Splits[_Part + 1];
+			_Merge_slice& _Slice = _Slices[_Part];
+			_Slice._First1 = _First1;
+			_Slice._First2 = _Diag_begin - _First1;
+			try {
+				_Merge_construct(_Begin1 + _First1, _Begin1 + _Last1, _Begin2 + (_Diag_begin - _First1), _Begin2 + (_Diag_end - _Last1),
+					_Buf + _Diag_begin, _Func, _Slice);
+			}
+			catch (...) {
+				std::lock_guard<std::mutex> _Guard(_Lock);
+				_Exceptions.push_back(std::current_exception());
+			}
+		});
+
+		if (!_Exceptions.empty())
+		{
+			_Run_blocks(_Parts, [&](size_t _Part) {
+				_Undo_merge_slice(_Begin1, _Begin2, _Buf + _Size * _Part / _Parts, _Slices[_Part]);
+			});
+			throw exception_list(std::move(_Exceptions));
+		}
+
+		_Run_blocks(_Parts, [&](size_t _Part) {
+			for (size_t _I = _Size * _Part / _Parts, _End = _Size * (_Part + 1) / _Parts; _I < _End; ++_I)
+			{
+				_Begin1[_I] = std::move(_Buf[_I]);
+				_Buf[_I].~_Ty();
+			}
+		});
+	}
+
+	template<typename _Random_iterator, typename _Function>
+	void _Parallel_buffered_inplace_merge(_Random_iterator _Begin1, size_t _Len1, size_t _Len2, _Function &_Func, size_t _Div_num, std::false_type)
+	{
+		_Parallel_inplace_merge(_Begin1, _Len1, _Len2, _Func, _Div_num);
+	}
+
+	template<typename _Random_iterator, typename _Function>
+	void _Parallel_buffered_inplace_merge(_Random_iterator _Begin1, size_t _Len1, size_t _Len2, _Function &_Func, size_t _Div_num)
+	{
+		_Parallel_buffered_inplace_merge(_Begin1, _Len1, _Len2, _Func, _Div_num,
+			_Is_nothrow_movable<typename std::iterator_traits<_Random_iterator>::value_type>());
+	}
+
 	//
 	// merge
 	//
@@ -131,11 +308,11 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _InIt2, class OutIt, class _Pr>
-	inline typename _enable_if_parallel<_ExPolicy, OutIt>::type _Merge_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, OutIt _Dest, _Pr _Pred, std::random_access_iterator_tag)
+	inline typename _enable_if_parallel<_ExPolicy, OutIt>::type _Merge_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, OutIt _Dest, _Pr _Pred, std::random_access_iterator_tag)
 	{
 		size_t _Size1 = std::distance(_First, _Last);
 		size_t _Size2 = std::distance(_First2, _Last2);
-		_Parallel_merge(_First, _Size1, _First2, _Size2, _Dest, _Pred, get_hardware_concurrency() * 2);
+		_Parallel_merge(_First, _Size1, _First2, _Size2, _Dest, _Pred, _Policy_thread_count(_Policy) * 2);
 		std::advance(_Dest, _Size1 + _Size2);
 		return _Dest;
 	}
@@ -164,9 +341,13 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _BidIt, class _Pr>
-	inline typename _enable_if_parallel<_ExPolicy, void>::type _Inplace_merge_impl(const _ExPolicy&, _BidIt _First, _BidIt _Mid, _BidIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Inplace_merge_impl(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Mid, _BidIt _Last, _Pr _Pred, std::random_access_iterator_tag)
 	{
-		_Parallel_inplace_merge(_First, _Mid - _First, _Last - _Mid, _Pred, get_hardware_concurrency() * 2);
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		_Parallel_buffered_inplace_merge(_First, _Mid - _First, _Last - _Mid, _Pred, _Policy_thread_count(_Policy) * 2);
 	}
 
 	template<class _ExPolicy, class _BidIt, class _Pr, class _IterCat>
@@ -180,11 +361,189 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_Inplace_merge_impl, _Policy, _First, _Mid, _Last, _Pred, _Cat);
 	}
+
+	//
+	// multiway_merge
+	//
+	// Merges sorted runs with a tree of losers, one comparison per level of the tree for every value written.
+	// Values of an earlier run go before equal values of a later one.
+	template<typename _RanIt, typename _Pr>
+	class _Loser_tree
+	{
+		std::vector<std::pair<_RanIt, _RanIt>> _Runs;
+		std::vector<size_t> _Tree; // the loser of every match, the winner at the root
+		_Pr& _Pred;
+
+		bool _Beats(size_t _Left, size_t _Right) const
+		{
+			if (_Runs[_Left].first == _Runs[_Left].second)
+				return false;
+			if (_Runs[_Right].first == _Runs[_Right].second)
+				return true;
+			if (_Pred(*_Runs[_Left].first, *_Runs[_Right].first))
+				return true;
+			return !_Pred(*_Runs[_Right].first, *_Runs[_Left].first) && _Left < _Right;
+		}
+
+		size_t _Play(size_t _Node)
+		{
+			const size_t _Count = _Runs.size();
+			if (_Node >= _Count)
+				return _Node - _Count;
+
+			const size_t _Left = _Play(2 * _Node), _Right = _Play(2 * _Node + 1);
+			if (_Beats(_Left, _Right))
+			{
+				_Tree[_Node] = _Right;
+				return _Left;
+			}
+
+			_Tree[_Node] = _Left;
+			return _Right;
+		}
+	public:
+		_Loser_tree(std::vector<std::pair<_RanIt, _RanIt>>&& _Sources, _Pr& _Func) : _Runs(std::move(_Sources)), _Tree(_Runs.size()), _Pred(_Func)
+		{
+			_Tree[0] = _Runs.size() > 1 ? _Play(1) : 0;
+		}
+
+		template<typename _OutIt>
+		_OutIt _Merge(_OutIt _Dest, size_t _Count)
+		{
+			const size_t _Leaves = _Runs.size();
+			for (; _Count > 0; --_Count, ++_Dest)
+			{
+				size_t _Winner = _Tree[0];
+				*_Dest = *_Runs[_Winner].first++;
+
+				for (size_t _Node = (_Winner + _Leaves) / 2; _Node > 0; _Node /= 2)
+				{
+					if (_Beats(_Tree[_Node], _Winner))
+						std::swap(_Tree[_Node], _Winner);
+				}
+
+				_Tree[0] = _Winner;
+			}
+
+			return _Dest;
+		}
+	};
+
+	// Multi-sequence selection: the offsets in the runs where the first _Rank values of their merge end. The
+	// runs are searched around a value of the run with the widest window left, which halves that window.
+	template<typename _RanIt, typename _Pr>
+	std::vector<size_t> _Multiway_split(const std::vector<std::pair<_RanIt, _RanIt>>& _Runs, size_t _Rank, _Pr& _Pred)
+	{
+		const size_t _Count = _Runs.size();
+		std::vector<size_t> _Lower(_Count, 0), _Upper(_Count), _Below(_Count);
+		for (size_t _Run = 0; _Run < _Count; ++_Run)
+			_Upper[_Run] = _Runs[_Run].second - _Runs[_Run].first;
+
+		for (;;)
+		{
+			size_t _Widest = 0;
+			for (size_t _Run = 1; _Run < _Count; ++_Run)
+			{
+				if (_Upper[_Run] - _Lower[_Run] > _Upper[_Widest] - _Lower[_Widest])
+					_Widest = _Run;
+			}
+
+			if (_Upper[_Widest] == _Lower[_Widest])
+				return _Lower;
+
+			// Values of the merge before the one in the middle of the widest window
+			const size_t _Mid = (_Lower[_Widest] + _Upper[_Widest]) / 2;
+			const auto& _Pivot = _Runs[_Widest].first[_Mid];
+			size_t _Pivot_rank = 0;
+			for (size_t _Run = 0; _Run < _Count; ++_Run)
+			{
+				const _RanIt _Begin = _Runs[_Run].first;
+				if (_Run == _Widest)
+					_Below[_Run] = _Mid;
+				else if (_Run < _Widest)
+					_Below[_Run] = std::upper_bound(_Begin + _Lower[_Run], _Begin + _Upper[_Run], _Pivot, _Pred) - _Begin;
+				else
+					_Below[_Run] = std::lower_bound(_Begin + _Lower[_Run], _Begin + _Upper[_Run], _Pivot, _Pred) - _Begin;
+
+				_Pivot_rank += _Below[_Run];
+			}
+
+			if (_Pivot_rank < _Rank)
+			{
+				_Below[_Widest] = _Mid + 1;
+				_Lower.swap(_Below);
+			}
+			else
+				_Upper.swap(_Below);
+		}
+	}
+
+	template<class _RanIt, class _OutIt, class _Pr, class _IterCat>
+	inline _OutIt _Multiway_merge_impl(const sequential_execution_policy&, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs, _OutIt _Dest, _Pr _Pred, _IterCat)
+	{
+		_EXP_TRY
+			size_t _Size = 0;
+			for (const auto& _Run : _Runs)
+				_Size += _Run.second - _Run.first;
+
+			if (_Size == 0)
+				return _Dest;
+
+			auto _Sources = _Runs;
+			return _Loser_tree<_RanIt, _Pr>(std::move(_Sources), _Pred)._Merge(_Dest, _Size);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _RanIt, class _OutIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Multiway_merge_impl(const _ExPolicy& _Policy, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs,
+		_OutIt _Dest, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		size_t _Size = 0;
+		for (const auto& _Run : _Runs)
+			_Size += _Run.second - _Run.first;
+
+		if (_Size == 0)
+			return _Dest;
+
+		const size_t _Parts = _Merge_parts(_Size, _Policy_thread_count(_Policy));
+
+		// Every task selects where its slice of the output starts and ends in all the runs, then merges it
+		_Run_blocks(_Parts, [&](size_t _Part) {
+			const size_t _Begin = _Size * _Part / _Parts, _End = _Size * (_Part + 1) / _Parts;
+			const std::vector<size_t> _From = _Multiway_split(_Runs, _Begin, _Pred), _To = _Multiway_split(_Runs, _End, _Pred);
+
+			std::vector<std::pair<_RanIt, _RanIt>> _Slice;
+			_Slice.reserve(_Runs.size());
+			for (size_t _Run = 0; _Run < _Runs.size(); ++_Run)
+				_Slice.push_back(std::make_pair(_Runs[_Run].first + _From[_Run], _Runs[_Run].first + _To[_Run]));
+
+			_Loser_tree<_RanIt, _Pr>(std::move(_Slice), _Pred)._Merge(_Dest + _Begin, _End - _Begin);
+		});
+
+		return _Dest + _Size;
+	}
+
+	template<class _ExPolicy, class _RanIt, class _OutIt, class _Pr, class _IterCat>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Multiway_merge_impl(const _ExPolicy&, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs,
+		_OutIt _Dest, _Pr _Pred, _IterCat _Cat)
+	{
+		return _Multiway_merge_impl(seq, _Runs, _Dest, _Pred, _Cat);
+	}
+
+	template<class _RanIt, class _OutIt, class _Pr, class _IterCat>
+	inline _OutIt _Multiway_merge_impl(const execution_policy& _Policy, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs, _OutIt _Dest, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Multiway_merge_impl, _Policy, _Runs, _Dest, _Pred, _Cat);
+	}
 } // details
 
 template<class _ExPolicy, class _InIt, class _InIt2, class _OutIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type merge(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("merge");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
@@ -196,12 +555,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type merge(_ExPol
 template<class _ExPolicy, class _InIt, class _InIt2, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type merge(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("merge");
 	return merge(std::forward<_ExPolicy>(_Policy), _First, _Last, _First2, _Last2, _Dest, std::less<>());
 }
 
 template<class _ExPolicy, class _BidIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type inplace_merge(_ExPolicy&& _Policy, _BidIt _First, _BidIt _Mid, _BidIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("inplace_merge");
 	static_assert(std::is_base_of<std::bidirectional_iterator_tag, typename std::iterator_traits<_BidIt>::iterator_category>::value, "Required bidirectional iterator or stronger.");
 
 	details::_Inplace_merge_impl(_Policy, _First, _Mid, _Last, _Pred, std::_Iter_cat(_First));
@@ -210,8 +571,30 @@ inline typename details::_enable_if_policy<_ExPolicy, void>::type inplace_merge(
 template<class _ExPolicy, class _BidIt>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type inplace_merge(_ExPolicy&& _Policy, _BidIt _First, _BidIt _Mid, _BidIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("inplace_merge");
 	inplace_merge(std::forward<_ExPolicy>(_Policy), _First, _Mid, _Last, std::less<>());
 }
+
+/// <summary>
+///     Merges the sorted runs [first, second) into one sorted range at _Dest, in a single pass. Values of an earlier
+///     run go before equal values of a later one. Returns the end of the range written.
+/// </summary>
+template<class _ExPolicy, class _RanIt, class _OutIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type multiway_merge(_ExPolicy&& _Policy, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs, _OutIt _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("multiway_merge");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	return details::_Multiway_merge_impl(_Policy, _Runs, _Dest, _Pred, std::_Iter_cat(_Dest));
+}
+
+template<class _ExPolicy, class _RanIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type multiway_merge(_ExPolicy&& _Policy, const std::vector<std::pair<_RanIt, _RanIt>>& _Runs, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("multiway_merge");
+	return multiway_merge(std::forward<_ExPolicy>(_Policy), _Runs, _Dest, std::less<>());
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_MERGE_H_
@@ -4,9 +4,294 @@
 #define _IMPL_MINMAX_ELEMENT_H_ 1
 
 #include "algorithm_impl.h"
+#include "find.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
+
+	// Contiguous ranges of integers, float or double ordered by std::less. Their smallest and largest values are
+	// reduced a vector at a time, then searched for: the elements found are the ones the comparisons would find.
+	template<typename _RanIt, typename _Pr, typename _El = typename std::iterator_traits<_RanIt>::value_type>
+	struct _Is_vector_minmax : std::integral_constant<bool, _Contiguous_container_iterator_traits<_RanIt>::value
+		&& ((std::is_integral<_El>::value && !std::is_same<_El, bool>::value) || std::is_same<_El, float>::value || std::is_same<_El, double>::value)
+		&& (std::is_same<_Pr, std::less<>>::value || std::is_same<_Pr, std::less<_El>>::value)>
+	{
+	};
+
+	// SSE2 orders the integers of up to 4 bytes, float and double
+	template<typename _El>
+	struct _Has_vector_minmax : std::integral_constant<bool, _EXP_SSE2 != 0 && (std::is_floating_point<_El>::value || sizeof(_El) <= 4)>
+	{
+	};
+
+	// Smallest and largest of the _Count > 0 elements from _First. False if one of them is a NaN, the
+	// elements are then not ordered and the comparisons decide.
+	template<typename _El>
+	inline bool _Minmax_values(const _El *_First, size_t _Count, _El& _Low, _El& _High, std::false_type)
+	{
+		_Low = _First[0];
+		_High = _First[0];
+
+		for (size_t _I = 0; _I < _Count; ++_I)
+		{
+			const _El _Val = _First[_I];
+			if (!(_Val == _Val))
+				return false;
+
+			_Low = _Val < _Low ? _Val : _Low;
+			_High = _High < _Val ? _Val : _High;
+		}
+
+		return true;
+	}
+
+#if _EXP_SSE2
+	template<size_t _Size, bool _Signed>
+	struct _Int_minmax_lane {};
+	struct _Float_minmax_lane {};
+	struct _Double_minmax_lane {};
+
+	template<typename _El>
+	struct _Minmax_lane
+	{
+		typedef typename std::conditional<std::is_same<_El, float>::value, _Float_minmax_lane,
+			typename std::conditional<std::is_same<_El, double>::value, _Double_minmax_lane,
+			_Int_minmax_lane<sizeof(_El), std::is_signed<_El>::value>>::type>::type type;
+	};
+
+	inline __m128i _Vec_select(__m128i _Mask, __m128i _If, __m128i _Else)
+	{
+		return _mm_or_si128(_mm_and_si128(_Mask, _If), _mm_andnot_si128(_Mask, _Else));
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<1, true>)
+	{
+		return _Vec_select(_mm_cmpgt_epi8(_Left, _Right), _Right, _Left);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<1, true>)
+	{
+		return _Vec_select(_mm_cmpgt_epi8(_Left, _Right), _Left, _Right);
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<1, false>)
+	{
+		return _mm_min_epu8(_Left, _Right);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<1, false>)
+	{
+		return _mm_max_epu8(_Left, _Right);
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<2, true>)
+	{
+		return _mm_min_epi16(_Left, _Right);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<2, true>)
+	{
+		return _mm_max_epi16(_Left, _Right);
+	}
+
+	// The unsigned lanes without an unsigned compare are moved to the signed range and back
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<2, false>)
+	{
+		const __m128i _Bias = _mm_set1_epi16(static_cast<short>(0x8000));
+		return _mm_xor_si128(_mm_min_epi16(_mm_xor_si128(_Left, _Bias), _mm_xor_si128(_Right, _Bias)), _Bias);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<2, false>)
+	{
+		const __m128i _Bias = _mm_set1_epi16(static_cast<short>(0x8000));
+		return _mm_xor_si128(_mm_max_epi16(_mm_xor_si128(_Left, _Bias), _mm_xor_si128(_Right, _Bias)), _Bias);
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<4, true>)
+	{
+		return _Vec_select(_mm_cmpgt_epi32(_Left, _Right), _Right, _Left);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<4, true>)
+	{
+		return _Vec_select(_mm_cmpgt_epi32(_Left, _Right), _Left, _Right);
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Int_minmax_lane<4, false>)
+	{
+		const __m128i _Bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+		return _Vec_select(_mm_cmpgt_epi32(_mm_xor_si128(_Left, _Bias), _mm_xor_si128(_Right, _Bias)), _Right, _Left);
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Int_minmax_lane<4, false>)
+	{
+		const __m128i _Bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+		return _Vec_select(_mm_cmpgt_epi32(_mm_xor_si128(_Left, _Bias), _mm_xor_si128(_Right, _Bias)), _Left, _Right);
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Float_minmax_lane)
+	{
+		return _mm_castps_si128(_mm_min_ps(_mm_castsi128_ps(_Left), _mm_castsi128_ps(_Right)));
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Float_minmax_lane)
+	{
+		return _mm_castps_si128(_mm_max_ps(_mm_castsi128_ps(_Left), _mm_castsi128_ps(_Right)));
+	}
+
+	inline __m128i _Vec_min(__m128i _Left, __m128i _Right, _Double_minmax_lane)
+	{
+		return _mm_castpd_si128(_mm_min_pd(_mm_castsi128_pd(_Left), _mm_castsi128_pd(_Right)));
+	}
+
+	inline __m128i _Vec_max(__m128i _Left, __m128i _Right, _Double_minmax_lane)
+	{
+		return _mm_castpd_si128(_mm_max_pd(_mm_castsi128_pd(_Left), _mm_castsi128_pd(_Right)));
+	}
+
+	// The lanes holding a NaN
+	template<size_t _Size, bool _Signed>
+	inline __m128i _Vec_unordered(__m128i, _Int_minmax_lane<_Size, _Signed>)
+	{
+		return _mm_setzero_si128();
+	}
+
+	inline __m128i _Vec_unordered(__m128i _Val, _Float_minmax_lane)
+	{
+		return _mm_castps_si128(_mm_cmpunord_ps(_mm_castsi128_ps(_Val), _mm_castsi128_ps(_Val)));
+	}
+
+	inline __m128i _Vec_unordered(__m128i _Val, _Double_minmax_lane)
+	{
+		return _mm_castpd_si128(_mm_cmpunord_pd(_mm_castsi128_pd(_Val), _mm_castsi128_pd(_Val)));
+	}
+
+	template<typename _El>
+	inline bool _Minmax_values(const _El *_First, size_t _Count, _El& _Low, _El& _High, std::true_type)
+	{
+		const size_t _Lanes = sizeof(__m128i) / sizeof(_El);
+		if (_Count < _Lanes)
+			return _Minmax_values(_First, _Count, _Low, _High, std::false_type());
+
+		const typename _Minmax_lane<_El>::type _Lane;
+		__m128i _Vec_low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_First));
+		__m128i _Vec_high = _Vec_low;
+		__m128i _Nan = _Vec_unordered(_Vec_low, _Lane);
+
+		size_t _I = _Lanes;
+		for (; _I + _Lanes <= _Count; _I += _Lanes)
+		{
+			const __m128i _Val = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_First + _I));
+			_Vec_low = _Vec_min(_Vec_low, _Val, _Lane);
+			_Vec_high = _Vec_max(_Vec_high, _Val, _Lane);
+			_Nan = _mm_or_si128(_Nan, _Vec_unordered(_Val, _Lane));
+		}
+
+		if (_mm_movemask_epi8(_Nan) != 0)
+			return false;
+
+		_El _Lows[sizeof(__m128i) / sizeof(_El)];
+		_El _Highs[sizeof(__m128i) / sizeof(_El)];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(_Lows), _Vec_low);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(_Highs), _Vec_high);
+
+		_El _Tail_low, _Tail_high;
+		if (!_Minmax_values(_First + _I - _Lanes, _Count - _I + _Lanes, _Tail_low, _Tail_high, std::false_type()))
+			return false;
+
+		_Low = _Tail_low;
+		_High = _Tail_high;
+		for (size_t _L = 0; _L < _Lanes; ++_L)
+		{
+			_Low = _Lows[_L] < _Low ? _Lows[_L] : _Low;
+			_High = _High < _Highs[_L] ? _Highs[_L] : _High;
+		}
+
+		return true;
+	}
+#endif
+
+	// Position of the last of the _Count elements from _First equal to _Val, which is one of them
+	template<typename _El>
+	inline size_t _Find_last_value_vec(const _El *_First, size_t _Count, _El _Val)
+	{
+		size_t _I = _Count;
+#if _EXP_SSE2
+		const size_t _Lanes = sizeof(__m128i) / sizeof(_El);
+		_El _Fill[_Lanes];
+		std::fill(_Fill, _Fill + _Lanes, _Val);
+		const __m128i _Key = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Fill));
+		const _Vec_find_lane<_El> _Lane;
+
+		for (; _I >= _Lanes; _I -= _Lanes) {
+			const unsigned int _Mask = static_cast<unsigned int>(_mm_movemask_epi8(_Vec_equal(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_First + _I - _Lanes)), _Key, _Lane)));
+			if (_Mask != 0)
+				return _I - _Lanes + _Highest_set_bit(_Mask) / sizeof(_El);
+		}
+#endif
+		while (_I > 0) {
+			--_I;
+			if (_First[_I] == _Val)
+				break;
+		}
+
+		return _I;
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline _RanIt _Min_element_block(_RanIt _First, size_t _Count, _Pr& _Pred, std::false_type)
+	{
+		return std::min_element(_First, _First + _Count, _Pred);
+	}
+
+	// The first element equal to the smallest value
+	template<typename _RanIt, typename _Pr>
+	inline _RanIt _Min_element_block(_RanIt _First, size_t _Count, _Pr& _Pred, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _El;
+
+		const _El * const _Ptr = _Unwrap_contiguous(_First);
+		_El _Low, _High;
+		if (_Count == 0 || !_Minmax_values(_Ptr, _Count, _Low, _High, _Has_vector_minmax<_El>()))
+			return std::min_element(_First, _First + _Count, _Pred);
+
+		return _First + _Find_value_vec(_Ptr, _Count, _Low);
+	}
+
+	// The first element equal to the largest value
+	template<typename _RanIt, typename _Pr>
+	inline _RanIt _Max_element_block(_RanIt _First, size_t _Count, _Pr& _Pred)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _El;
+
+		const _El * const _Ptr = _Unwrap_contiguous(_First);
+		_El _Low, _High;
+		if (_Count == 0 || !_Minmax_values(_Ptr, _Count, _Low, _High, _Has_vector_minmax<_El>()))
+			return std::max_element(_First, _First + _Count, _Pred);
+
+		return _First + _Find_value_vec(_Ptr, _Count, _High);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline std::pair<_RanIt, _RanIt> _Minmax_element_block(_RanIt _First, size_t _Count, _Pr& _Pred, std::false_type)
+	{
+		return std::minmax_element(_First, _First + _Count, _Pred);
+	}
+
+	// The first element equal to the smallest value and the last equal to the largest
+	template<typename _RanIt, typename _Pr>
+	inline std::pair<_RanIt, _RanIt> _Minmax_element_block(_RanIt _First, size_t _Count, _Pr& _Pred, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _El;
+
+		const _El * const _Ptr = _Unwrap_contiguous(_First);
+		_El _Low, _High;
+		if (_Count == 0 || !_Minmax_values(_Ptr, _Count, _Low, _High, _Has_vector_minmax<_El>()))
+			return std::minmax_element(_First, _First + _Count, _Pred);
+
+		return std::make_pair(_First + _Find_value_vec(_Ptr, _Count, _Low), _First + _Find_last_value_vec(_Ptr, _Count, _High));
+	}
+
 	//
 	// min_element
 	//
@@ -19,15 +304,19 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
-	_FwdIt _Min_element_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	_FwdIt _Min_element_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First != _Last)
 		{
 			combinable<_FwdIt> _Combine;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, std::distance(_First, _Last), _Pred,
+			_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Pred,
 				[&_Combine, &_First](_FwdIt _Begin, size_t _Count, _Pr& _UserPred) {
 				auto _End = _Begin;
 				std::advance(_End, _Count);
@@ -53,6 +342,23 @@ namespace details {
 		return _First;
 	}
 
+	// Random access ranges keep one slot per chunk. The chunks combine in order, so of equivalent
+	// elements the left one is the first found and no distances are measured.
+	template <class _ExPolicy, class _RanIt, class _Pr>
+	typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Min_element_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		if (_First == _Last)
+			return _First;
+
+		return _Chunked_reduce<_RanIt>(_Policy, _First, _Last - _First, _Pred,
+			[](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			return _Min_element_block(_Begin, _Count, _UserPred, _Is_vector_minmax<_RanIt, _Pr>());
+		},
+			[](_RanIt _Left, _RanIt _Right, _Pr& _UserPred) {
+			return _UserPred(*_Right, *_Left) ? _Right : _Left;
+		});
+	}
+
 	template <class _FwdIt, class _Pr, class _IterCat>
 	inline _FwdIt _Min_element_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
 	{
@@ -71,13 +377,41 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
-	_FwdIt _Max_element_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
+	_FwdIt _Max_element_helper(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat, std::false_type)
 	{
-		return _Min_element_impl(_Policy, _First, _Last, [_Pred](std::iterator_traits<_FwdIt>::reference _Val, std::iterator_traits<_FwdIt>::reference _Val2) mutable {
+		return _Min_element_impl(_Policy, _First, _Last, [_Pred](typename std::iterator_traits<_FwdIt>::reference _Val, typename std::iterator_traits<_FwdIt>::reference _Val2) mutable {
 			return _Pred(_Val2, _Val);
 		}, _Cat);
 	}
 
+	// Of equivalent largest elements the left one is the first found
+	template <class _ExPolicy, class _RanIt, class _Pr>
+	_RanIt _Max_element_helper(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag, std::true_type)
+	{
+		if (_First == _Last)
+			return _First;
+
+		return _Chunked_reduce<_RanIt>(_Policy, _First, _Last - _First, _Pred,
+			[](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			return _Max_element_block(_Begin, _Count, _UserPred);
+		},
+			[](_RanIt _Left, _RanIt _Right, _Pr& _UserPred) {
+			return _UserPred(*_Left, *_Right) ? _Right : _Left;
+		});
+	}
+
+	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
+	_FwdIt _Max_element_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
+	{
+		return _Max_element_helper(_Policy, _First, _Last, _Pred, _Cat, std::false_type());
+	}
+
+	template <class _ExPolicy, class _RanIt, class _Pr>
+	typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Max_element_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag _Cat)
+	{
+		return _Max_element_helper(_Policy, _First, _Last, _Pred, _Cat, _Is_vector_minmax<_RanIt, _Pr>());
+	}
+
 	template <class _FwdIt, class _Pr, class _IterCat>
 	inline _FwdIt _Max_element_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
 	{
@@ -112,15 +446,19 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
-	std::pair<_FwdIt, _FwdIt> _Minmax_element_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	std::pair<_FwdIt, _FwdIt> _Minmax_element_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First != _Last)
 		{
 			combinable<std::pair<_FwdIt, _FwdIt> > _Combine;
 
-			_Partitioner<_ExecutionPolicy>::_For_Each(_First, std::distance(_First, _Last), _Pred,
+			_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Pred,
 				[&_Combine, &_First](_FwdIt _Begin, size_t _Count, _Pr& _UserPred) {
 				auto _End = _Begin;
 				std::advance(_End, _Count);
@@ -142,6 +480,23 @@ namespace details {
 		return std::make_pair(_First, _First);
 	}
 
+	// The first of the smallest elements is the left one, the last of the largest the right one
+	template <class _ExPolicy, class _RanIt, class _Pr>
+	typename _enable_if_parallel<_ExPolicy, std::pair<_RanIt, _RanIt>>::type _Minmax_element_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		if (_First == _Last)
+			return std::make_pair(_First, _First);
+
+		return _Chunked_reduce<std::pair<_RanIt, _RanIt>>(_Policy, _First, _Last - _First, _Pred,
+			[](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			return _Minmax_element_block(_Begin, _Count, _UserPred, _Is_vector_minmax<_RanIt, _Pr>());
+		},
+			[](const std::pair<_RanIt, _RanIt>& _Left, const std::pair<_RanIt, _RanIt>& _Right, _Pr& _UserPred) {
+			return std::make_pair(_UserPred(*_Right.first, *_Left.first) ? _Right.first : _Left.first,
+				_UserPred(*_Right.second, *_Left.second) ? _Left.second : _Right.second);
+		});
+	}
+
 	template <class _FwdIt, class _Pr, class _IterCat>
 	inline std::pair<_FwdIt, _FwdIt> _Minmax_element_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
 	{
@@ -152,6 +507,7 @@ namespace details {
 template <class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type min_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("min_element");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Min_element_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -160,12 +516,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type min_element(
 template <class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type min_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("min_element");
 	return min_element(_Policy, _First, _Last, std::less<>());
 }
 
 template <class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type max_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("max_element");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Max_element_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -174,12 +532,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type max_element(
 template <class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type max_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("max_element");
 	return max_element(_Policy, _First, _Last, std::less<>());
 }
 
 template <class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_FwdIt, _FwdIt> >::type minmax_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("minmax_element");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Minmax_element_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -188,6 +548,7 @@ inline typename details::_enable_if_policy<_ExPolicy, std::pair<_FwdIt, _FwdIt>
 template <class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_FwdIt, _FwdIt> >::type minmax_element(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("minmax_element");
 	return minmax_element(_Policy, _First, _Last, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
@@ -3,22 +3,87 @@
 #ifndef _IMPL_MISMATCH_H_
 #define _IMPL_MISMATCH_H_ 1
 
+#include <cstring>
 #include "algorithm_impl.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
 
+	// Bytes compared by one memcmp call, the chunks poll their token between the calls
+	const size_t _Memcmp_block_bytes = 4096;
+
+	// Contiguous ranges of one integral or pointer type compared with std::equal_to, whose elements
+	// are equal exactly when their bytes are
+	template<typename _InIt, typename _InIt2, typename _Pr, typename _El = typename std::iterator_traits<_InIt>::value_type>
+	struct _Is_memcmp_equal : std::integral_constant<bool, _Contiguous_container_iterator_traits<_InIt>::value && _Contiguous_container_iterator_traits<_InIt2>::value
+		&& std::is_same<_El, typename std::iterator_traits<_InIt2>::value_type>::value
+		&& ((std::is_integral<_El>::value && !std::is_same<_El, bool>::value) || std::is_pointer<_El>::value)
+		&& (std::is_same<_Pr, std::equal_to<>>::value || std::is_same<_Pr, std::equal_to<_El>>::value)>
+	{
+	};
+
+	// Position of the first of the _Count elements that differ, _Count if none does or _Stop was
+	// true between two blocks. The block memcmp finds different is walked to the element.
+	template<typename _Ty, typename _Stop>
+	size_t _Memcmp_mismatch(const _Ty *_First, const _Ty *_First2, size_t _Count, const _Stop& _Stop_at)
+	{
+		const size_t _Block = sizeof(_Ty) < _Memcmp_block_bytes ? _Memcmp_block_bytes / sizeof(_Ty) : 1;
+
+		for (size_t _Pos = 0; _Pos < _Count; _Pos += _Block) {
+			const size_t _Len = (std::min)(_Block, _Count - _Pos);
+
+			if (std::memcmp(_First + _Pos, _First2 + _Pos, _Len * sizeof(_Ty)) != 0) {
+				while (_First[_Pos] == _First2[_Pos])
+					++_Pos;
+				return _Pos;
+			}
+
+			if (_Stop_at(_Pos + _Len))
+				break;
+		}
+
+		return _Count;
+	}
+
+	// The chunks of the first range are compared with memcmp to the same elements of the second
 	template<class _ExPolicy, class _InIt, class _Diff, class _InIt2, class _Pr>
-	inline typename std::iterator_traits<_InIt>::difference_type _Mismatch_impl_helper(const _ExPolicy&, _InIt _First, _Diff _Size, _InIt2 _First2, _Pr _Pred)
+	inline typename std::iterator_traits<_InIt>::difference_type _Mismatch_impl_helper(const _ExPolicy& _Policy, _InIt _First, _Diff _Size, _InIt2 _First2, _Pr, std::true_type)
+	{
+		typedef std::iterator_traits<_InIt>::difference_type difference_type;
+		typedef typename std::iterator_traits<_InIt>::pointer _Ptr;
+
+		const _Ptr _Base = _Unwrap_contiguous(_First);
+		const typename std::iterator_traits<_InIt2>::pointer _Base2 = _Unwrap_contiguous(_First2);
+		cancellation_token_with_position<difference_type> _Token(_Size);
+
+		_Partitioned_for_each(_Policy, _Base, _Size, 0, [&_Token, _Base, _Base2](_Ptr _Begin, size_t _Partition_count, int&) {
+			const difference_type _Dist = _Begin - _Base;
+			if (_Token.is_cancelled(_Dist))
+				return;
+
+			const size_t _Pos = _Memcmp_mismatch(_Begin, _Base2 + _Dist, _Partition_count, [&_Token, _Dist](size_t _Reached) {
+				return _Token.is_cancelled(_Dist + static_cast<difference_type>(_Reached));
+			});
+
+			if (_Pos != _Partition_count)
+				_Token.cancel(_Dist + static_cast<difference_type>(_Pos));
+		});
+
+		return _Token.get_position();
+	}
+
+	template<class _ExPolicy, class _InIt, class _Diff, class _InIt2, class _Pr>
+	inline typename std::iterator_traits<_InIt>::difference_type _Mismatch_impl_helper(const _ExPolicy& _Policy, _InIt _First, _Diff _Size, _InIt2 _First2, _Pr _Pred, std::false_type)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
 		cancellation_token_with_position<difference_type> _Token(_Size);
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(make_composable_iterator(_First, _First2), _Size, _Pred,
+		_Partitioned_for_each(_Policy, make_composable_iterator(_First, _First2), _Size, _Pred,
 			[&_Token, &_First](composable_iterator<_InIt, _InIt2> _Begin, size_t _Partition_count, _Pr& _UserPred) {
 			auto _Dist = std::distance(_First, std::get<0>(*_Begin));
+			_Cancellation_poll<_InIt> _Poll;
 
 			for (size_t _Curr_pos = 0; _Curr_pos < _Partition_count; ++_Curr_pos, ++_Begin) {
 				if (!_UserPred(*std::get<0>(*_Begin), *std::get<1>(*_Begin))) {
@@ -26,7 +91,7 @@ namespace details {
 					return;
 				}
 
-				if (_Token.is_cancelled(_Dist + _Curr_pos))
+				if (_Poll.due() && _Token.is_cancelled(_Dist + _Curr_pos))
 					break;
 			}
 		});
@@ -34,6 +99,12 @@ namespace details {
 		return _Token.get_position();
 	}
 
+	template<class _ExPolicy, class _InIt, class _Diff, class _InIt2, class _Pr>
+	inline typename std::iterator_traits<_InIt>::difference_type _Mismatch_impl_helper(const _ExPolicy& _Policy, _InIt _First, _Diff _Size, _InIt2 _First2, _Pr _Pred)
+	{
+		return _Mismatch_impl_helper(_Policy, _First, _Size, _First2, _Pred, _Is_memcmp_equal<_InIt, _InIt2, _Pr>());
+	}
+
 	//
 	// mismatch
 	//
@@ -133,6 +204,7 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>::type mismatch(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("mismatch");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -143,12 +215,14 @@ inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>:
 template<class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>::type mismatch(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2)
 {
+	_EXP_TELEMETRY_ALGORITHM("mismatch");
 	return mismatch(_Policy, _First, _Last, _First2, std::equal_to<>());
 }
 
 template<class _ExPolicy, class _InIt, class _InIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>::type mismatch(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("mismatch");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 
@@ -159,6 +233,7 @@ inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>:
 template<class _ExPolicy, class _InIt, class _InIt2>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _InIt2>>::type mismatch(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _InIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("mismatch");
 	return mismatch(_Policy, _First, _Last, _First2, _Last2, std::equal_to<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
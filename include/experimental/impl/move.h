@@ -4,6 +4,7 @@
 #define _IMPL_MOVE_H_ 1
 
 #include "algorithm_impl.h"
+#include "bulk_memory.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -19,7 +20,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _InIt, class _OutIt, class _IterCat>
-	_OutIt _Move_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _IterCat _Cat)
+	_OutIt _Move_helper(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _IterCat _Cat, std::false_type)
 	{
 		return std::get<1>(*_For_each_n_impl(_Policy, make_composable_iterator(_First, _Dest), std::distance(_First, _Last),
 			[](typename composable_iterator<_InIt, _OutIt>::reference _It){
@@ -27,6 +28,24 @@ namespace details {
 		}, _Cat));
 	}
 
+	// Moving a trivially copyable element copies its bytes
+	template <class _ExPolicy, class _InIt, class _OutIt, class _IterCat>
+	_OutIt _Move_helper(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _IterCat, std::true_type)
+	{
+		if (_First == _Last)
+			return _Dest;
+
+		const auto _Count = _Last - _First;
+		_Bulk_copy(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Count), _Unwrap_contiguous(_Dest));
+		return _Dest + _Count;
+	}
+
+	template <class _ExPolicy, class _InIt, class _OutIt, class _IterCat>
+	_OutIt _Move_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _IterCat _Cat)
+	{
+		return _Move_helper(_Policy, _First, _Last, _Dest, _Cat, _Is_memcpy_range<_InIt, _OutIt>());
+	}
+
 	template <class _ExPolicy, class _InIt, class _OutIt>
 	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Move_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, std::input_iterator_tag _Cat)
 	{
@@ -43,6 +62,7 @@ namespace details {
 template <class _ExPolicy, class _InIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type move(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("move");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
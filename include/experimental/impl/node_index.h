@@ -0,0 +1,256 @@
+#pragma once
+
+#ifndef _IMPL_NODE_INDEX_H_
+#define _IMPL_NODE_INDEX_H_ 1
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	//
+	// node_index
+	//
+	// The algorithms split a range without random access by walking it, one node after the other on the
+	// calling thread, and a std::map of millions of nodes is walked at the speed of a miss per node. The index
+	// holds an iterator to every element, the algorithms split it in constant time as they split a vector.
+
+	// Ranges this long that can be walked backwards are indexed from both ends at once
+	const size_t _Node_index_split_size = 64 * 1024;
+
+	// Random access to the elements the iterators of an index point to
+	template<class _It>
+	class _Node_index_iterator
+	{
+		const _It *_Node;
+
+	public:
+		typedef std::random_access_iterator_tag iterator_category;
+		typedef typename std::iterator_traits<_It>::value_type value_type;
+		typedef typename std::iterator_traits<_It>::reference reference;
+		typedef typename std::iterator_traits<_It>::pointer pointer;
+		typedef ptrdiff_t difference_type;
+
+		_Node_index_iterator() : _Node(nullptr)
+		{
+		}
+
+		explicit _Node_index_iterator(const _It *_At) : _Node(_At)
+		{
+		}
+
+		reference operator*() const
+		{
+			return **_Node;
+		}
+
+		pointer operator->() const
+		{
+			return std::addressof(**_Node);
+		}
+
+		reference operator[](difference_type _Off) const
+		{
+			return *_Node[_Off];
+		}
+
+		_Node_index_iterator& operator++()
+		{
+			++_Node;
+			return *this;
+		}
+
+		_Node_index_iterator operator++(int)
+		{
+			_Node_index_iterator _Tmp = *this;
+			++_Node;
+			return _Tmp;
+		}
+
+		_Node_index_iterator& operator--()
+		{
+			--_Node;
+			return *this;
+		}
+
+		_Node_index_iterator operator--(int)
+		{
+			_Node_index_iterator _Tmp = *this;
+			--_Node;
+			return _Tmp;
+		}
+
+		_Node_index_iterator& operator+=(difference_type _Off)
+		{
+			_Node += _Off;
+			return *this;
+		}
+
+		_Node_index_iterator& operator-=(difference_type _Off)
+		{
+			_Node -= _Off;
+			return *this;
+		}
+
+		_Node_index_iterator operator+(difference_type _Off) const
+		{
+			return _Node_index_iterator(_Node + _Off);
+		}
+
+		friend _Node_index_iterator operator+(difference_type _Off, const _Node_index_iterator& _Iter)
+		{
+			return _Iter + _Off;
+		}
+
+		_Node_index_iterator operator-(difference_type _Off) const
+		{
+			return _Node_index_iterator(_Node - _Off);
+		}
+
+		difference_type operator-(const _Node_index_iterator& _Other) const
+		{
+			return _Node - _Other._Node;
+		}
+
+		bool operator==(const _Node_index_iterator& _Other) const
+		{
+			return _Node == _Other._Node;
+		}
+
+		bool operator!=(const _Node_index_iterator& _Other) const
+		{
+			return _Node != _Other._Node;
+		}
+
+		bool operator<(const _Node_index_iterator& _Other) const
+		{
+			return _Node < _Other._Node;
+		}
+
+		bool operator>(const _Node_index_iterator& _Other) const
+		{
+			return _Node > _Other._Node;
+		}
+
+		bool operator<=(const _Node_index_iterator& _Other) const
+		{
+			return _Node <= _Other._Node;
+		}
+
+		bool operator>=(const _Node_index_iterator& _Other) const
+		{
+			return _Node >= _Other._Node;
+		}
+	};
+
+	template<class _FwdIt>
+	inline void _Index_nodes(_FwdIt _First, _FwdIt *_Nodes, size_t _Count)
+	{
+		for (size_t _I = 0; _I < _Count; ++_I, ++_First)
+			_Nodes[_I] = _First;
+	}
+
+	template<class _FwdIt>
+	inline void _Index_nodes(_FwdIt _First, _FwdIt, _FwdIt *_Nodes, size_t _Count, std::forward_iterator_tag)
+	{
+		_Index_nodes(_First, _Nodes, _Count);
+	}
+
+	// The front half is walked forwards from _First and the back half backwards from _Last, at once
+	template<class _BidIt>
+	inline void _Index_nodes(_BidIt _First, _BidIt _Last, _BidIt *_Nodes, size_t _Count, std::bidirectional_iterator_tag)
+	{
+		if (_Count < _Node_index_split_size)
+			return _Index_nodes(_First, _Nodes, _Count);
+
+		const size_t _Half = _Count / 2;
+		_Run_blocks(2, [&](size_t _Block) {
+			if (_Block == 0)
+				return _Index_nodes(_First, _Nodes, _Half);
+
+			for (size_t _I = _Count; _I > _Half;)
+				_Nodes[--_I] = --_Last;
+		});
+	}
+} // details
+
+/// <summary>
+///     An iterator to every element of a range without random access, a std::map, a std::set or a std::list for
+///     instance. The algorithms split the range of begin() and end() of the index in constant time and run on the
+///     elements in parallel, where they walk the range of the container itself from one node to the next.
+/// </summary>
+/// <remarks>
+///     The index is built by one walk of the range, which is as slow as the walk of a serial algorithm, and pays off
+///     over the calls that reuse it. It holds the elements of the range as it was built and is left valid as long
+///     as the iterators it holds are: erasing an element invalidates it, inserting one leaves it out.
+/// </remarks>
+template<class _FwdIt>
+class node_index
+{
+	std::vector<_FwdIt> _Nodes;
+
+public:
+	typedef details::_Node_index_iterator<_FwdIt> iterator;
+
+	node_index()
+	{
+	}
+
+	node_index(_FwdIt _First, _FwdIt _Last)
+	{
+		static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+		for (; _First != _Last; ++_First)
+			_Nodes.push_back(_First);
+	}
+
+	/// <summary>
+	///     Indexes the _Count elements of [_First, _Last). A range of bidirectional iterators is walked from both
+	///     ends at once, by the calling thread and a worker.
+	/// </summary>
+	node_index(_FwdIt _First, _FwdIt _Last, size_t _Count) : _Nodes(_Count)
+	{
+		static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+		if (_Count != 0)
+			details::_Index_nodes(_First, _Last, _Nodes.data(), _Count, std::_Iter_cat(_First));
+	}
+
+	size_t size() const _NOEXCEPT
+	{
+		return _Nodes.size();
+	}
+
+	bool empty() const _NOEXCEPT
+	{
+		return _Nodes.empty();
+	}
+
+	iterator begin() const _NOEXCEPT
+	{
+		return iterator(_Nodes.data());
+	}
+
+	iterator end() const _NOEXCEPT
+	{
+		return iterator(_Nodes.data() + _Nodes.size());
+	}
+};
+
+/// <summary>
+///     The index of the elements of a container, see node_index.
+/// </summary>
+template<class _Container>
+inline node_index<decltype(std::declval<_Container&>().begin())> make_node_index(_Container& _Cont)
+{
+	return node_index<decltype(std::declval<_Container&>().begin())>(_Cont.begin(), _Cont.end(), _Cont.size());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_NODE_INDEX_H_
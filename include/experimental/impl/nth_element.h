@@ -3,6 +3,8 @@
 #ifndef _IMPL_NTH_ELEMENT_H_
 #define _IMPL_NTH_ELEMENT_H_ 1
 
+#include <random>
+
 #include "algorithm_impl.h"
 #include "partition.h"
 #include "sort.h"
@@ -20,35 +22,103 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	// Ranges this small are left to std::nth_element
+	const size_t _Select_min_size = 1 << 16;
+
+	// Values sampled per round of the parallel selection, and how far from the rank sought the two pivots are
+	// taken in the sorted sample. The values between the pivots are a few percent of the range.
+	const size_t _Select_sample_size = 1024;
+	const size_t _Select_sample_margin = 16;
+
+	// Every round samples the range for two pivots bracketing the rank sought and counts the values below and
+	// above them in parallel. The range is then partitioned in parallel just enough to bring the part holding
+	// the nth element together, the rounds go on in that part only.
 	template<class _ExPolicy, class _RanIt, class _Pred>
 	inline void _Nth_element_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Nth, _RanIt _Last, _Pred _Pr)
 	{
-		const size_t _Chunk_size = 2048;
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
 
-		if (_First == _Last)
-			return;
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
 
-		--_Last;
+		const size_t _Min_size = (std::max)(_Grain_size(_Policy, 2048), _Select_min_size);
+		const size_t _Blocks = _Policy_thread_count(_Policy);
 
-#pragma warning(suppress: 6295)
-		for (; _Chunk_size > _Last - _First;) {
-			_RanIt _Pivot = _First + (_Last - _First) / 2;
-			std::swap(*_Pivot, *_Last);
+		if (_Nth == _Last)
+			return;
 
-			_Pivot = partition(_Policy, _First, _Last, [_Last, _Pr](std::iterator_traits<_RanIt>::reference _Val) mutable {
-				return _Pr(_Val, *_Last);
+		while (static_cast<size_t>(_Last - _First) > _Min_size && _Blocks > 1)
+		{
+			const size_t _Size = _Last - _First, _Rank = _Nth - _First;
+
+			// A fixed seed, the selection does the same work from one run to the next
+			std::minstd_rand _Gen(static_cast<std::minstd_rand::result_type>(_Size));
+			std::uniform_int_distribution<size_t> _Pos(0, _Size - 1);
+
+			std::vector<_Value_type> _Sample;
+			_Sample.reserve(_Select_sample_size);
+			for (size_t _I = 0; _I < _Select_sample_size; ++_I)
+				_Sample.push_back(_First[_Pos(_Gen)]);
+
+			std::sort(_Sample.begin(), _Sample.end(), _Pr);
+
+			const size_t _At = static_cast<size_t>(static_cast<double>(_Rank) / _Size * _Select_sample_size);
+			const _Value_type _Low = _Sample[_At > _Select_sample_margin ? _At - _Select_sample_margin : 0];
+			const _Value_type _High = _Sample[(std::min)(_At + _Select_sample_margin, _Select_sample_size - 1)];
+
+			std::vector<size_t> _Counts(2 * _Blocks);
+			_Run_blocks(_Blocks, [&](size_t _Block) {
+				size_t _Below = 0, _Above = 0;
+				for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+				{
+					if (_Pr(_First[_I], _Low))
+						++_Below;
+					else if (_Pr(_High, _First[_I]))
+						++_Above;
+				}
+
+				_Counts[2 * _Block] = _Below;
+				_Counts[2 * _Block + 1] = _Above;
 			});
 
-			std::swap(*_Last, *_Pivot);
-
-			if (_Pivot == _Nth)
-				return;
-			else if (_Nth < _Pivot)
-				_Last = _Pivot - 1;
-			else _First = _Pivot + 1;
+			size_t _Below = 0, _Above = 0;
+			for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+			{
+				_Below += _Counts[2 * _Block];
+				_Above += _Counts[2 * _Block + 1];
+			}
+
+			auto _Is_below = [&_Pr, &_Low](const _Value_type& _Val) { return _Pr(_Val, _Low); };
+			auto _Is_not_above = [&_Pr, &_High](const _Value_type& _Val) { return !_Pr(_High, _Val); };
+
+			if (_Rank < _Below)
+			{
+				partition(_Policy, _First, _Last, _Is_below);
+				_Last = _First + _Below;
+			}
+			else if (_Rank >= _Size - _Above)
+			{
+				partition(_Policy, _First, _Last, _Is_not_above);
+				_First += _Size - _Above;
+			}
+			else
+			{
+				partition(_Policy, _First, _Last, _Is_below);
+				partition(_Policy, _First + _Below, _Last, _Is_not_above);
+				_First += _Below;
+				_Last -= _Above;
+
+				// Equivalent pivots, every value left is equivalent to the nth
+				if (!_Pr(_Low, _High))
+					return;
+			}
+
+			// A sample far off the range, its part is left to std::nth_element
+			if (static_cast<size_t>(_Last - _First) > _Size / 4 * 3)
+				break;
 		}
 
-		std::nth_element(_First, _Nth, _Last + 1, _Pr);
+		std::nth_element(_First, _Nth, _Last, _Pr);
 	}
 
 	template<class _RanIt, class _Pred>
@@ -61,6 +131,7 @@ namespace details {
 template<class _ExPolicy, class _RanIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type nth_element(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Nth, _RanIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("nth_element");
 	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
 
 	details::_Nth_element_impl(_Policy, _First, _Nth, _Last, _Pred);
@@ -69,6 +140,7 @@ inline typename details::_enable_if_policy<_ExPolicy, void>::type nth_element(_E
 template<class _ExPolicy, class _RanIt>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type nth_element(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Nth, _RanIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("nth_element");
 	nth_element(_Policy, _First, _Nth, _Last, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
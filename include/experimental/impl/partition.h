@@ -259,6 +259,90 @@ namespace details
 		return _First;
 	}
 
+	// Stable partition through raw storage. Every block moves its values into its own part of the buffer, the ones
+	// that satisfy the predicate from the front and the others from the back, then moves them to their places in the
+	// range at the offsets of a scan of the counts. The predicate is called once per value.
+	template<class _RanIt, class _Pr>
+	inline _RanIt _Buffered_stable_partition(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Blocks, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Ty;
+
+		std::unique_ptr<_Uninitialized_buffer<_Ty>> _Buffer;
+		try
+		{
+			_Buffer.reset(new _Uninitialized_buffer<_Ty>(_Size));
+		}
+		catch (const std::bad_alloc&)
+		{
+			return _Stable_partition_impl_helper(_First, _First + _Size, _Size, _Pred, _Blocks);
+		}
+
+		_Ty *_Buf = _Buffer->get();
+		std::vector<size_t> _Selected(_Blocks + 1, 0);
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			const size_t _Begin = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks;
+			size_t _Front = _Begin, _Back = _End;
+			for (size_t _I = _Begin; _I < _End; ++_I)
+			{
+				if (_Pred(_First[_I]))
+					::new (static_cast<void*>(_Buf + _Front++)) _Ty(std::move(_First[_I]));
+				else
+					::new (static_cast<void*>(_Buf + --_Back)) _Ty(std::move(_First[_I]));
+			}
+
+			_Selected[_Block + 1] = _Front - _Begin;
+		});
+
+		for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+			_Selected[_Block + 1] += _Selected[_Block];
+
+		const size_t _Total = _Selected[_Blocks];
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			const size_t _Begin = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks;
+			const size_t _Split = _Begin + _Selected[_Block + 1] - _Selected[_Block];
+
+			_RanIt _Dest = _First + _Selected[_Block];
+			for (size_t _I = _Begin; _I < _Split; ++_I, ++_Dest)
+			{
+				*_Dest = std::move(_Buf[_I]);
+				_Buf[_I].~_Ty();
+			}
+
+			// The others of the blocks before this one go first, they were stored back to front
+			_Dest = _First + _Total + (_Begin - _Selected[_Block]);
+			for (size_t _I = _End; _I > _Split; ++_Dest)
+			{
+				*_Dest = std::move(_Buf[--_I]);
+				_Buf[_I].~_Ty();
+			}
+		});
+
+		return _First + _Total;
+	}
+
+	// Values whose moves may throw are partitioned in place
+	template<class _RanIt, class _Pr>
+	inline _RanIt _Buffered_stable_partition(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Blocks, std::false_type)
+	{
+		return _Stable_partition_impl_helper(_First, _First + _Size, _Size, _Pred, _Blocks);
+	}
+
+	template<class _ExPolicy, class _RanIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Stable_partition_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Last - _First;
+		const size_t _Blocks = (std::min)(static_cast<size_t>(_Policy_thread_count(_Policy)), _Size / _Grain_size(_Policy, 2048));
+
+		if (_Blocks < 2)
+			return std::stable_partition(_First, _Last, _Pred);
+
+		return _Buffered_stable_partition(_First, _Size, _Pred, _Blocks, _Is_nothrow_movable<typename std::iterator_traits<_RanIt>::value_type>());
+	}
+
 	template<class _ExPolicy, class _BidIt, class _OutIt, class _Pr>
 	inline typename _enable_if_parallel<_ExPolicy, _BidIt>::type _Stable_partition_impl(const _ExPolicy&, _BidIt _First, _BidIt _Last, _Pr _Pred, std::input_iterator_tag _Cat)
 	{
@@ -282,20 +366,51 @@ namespace details
 		_EXP_RETHROW
 	}
 
+	// The copy stage of partition_copy, the marked elements to the first output and the others to the second
+	template<class _ExPolicy, class _Iter_type, class _OutIt, class _OutIt2>
+	inline void _Partition_marked(_Iter_type _Begin, size_t _Count, std::pair<_OutIt, _OutIt2> _Out, std::false_type)
+	{
+		LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Count,
+			[&_Out](typename _Iter_type::reference _It){
+
+			if (*std::get<1>(_It)) {
+				*_Out.first = *std::get<0>(_It);
+				++_Out.first;
+			}
+			else {
+				*_Out.second = *std::get<0>(_It);
+				++_Out.second;
+			}
+		});
+	}
+
+	template<class _ExPolicy, class _Iter_type, class _OutIt, class _OutIt2>
+	inline void _Partition_marked(_Iter_type _Begin, size_t _Count, std::pair<_OutIt, _OutIt2> _Out, std::true_type)
+	{
+		_Compress_chunk(_Begin, _Count, _Out.first, true);
+		_Compress_chunk(_Begin, _Count, _Out.second, false);
+	}
+
 	template<class _ExPolicy, class _InIt, class _OutIt, class _OutIt2, class _Pr, class _IterCat>
-	inline std::pair<_OutIt, _OutIt2> _Partition_copy_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _OutIt2 _Dest2, _Pr _Pred, _IterCat)
+	inline std::pair<_OutIt, _OutIt2> _Partition_copy_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _OutIt2 _Dest2, _Pr _Pred, _IterCat)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
-		typedef composable_iterator<_InIt, std::vector< std::pair<difference_type, difference_type> >::iterator > _Iter_type;
+		typedef composable_iterator<_InIt, _Filter_mask_iterator> _Iter_type;
 		typedef _Output_token_double<_OutIt, _OutIt2> _Output_token;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First != _Last) {
 			auto _Size = std::distance(_First, _Last);
-			std::vector<std::pair<difference_type, difference_type>> _FilterList(_Size);
+
+			// A set bit sends the element to _Dest, a clear one to _Dest2
+			_Filter_mask _Filter(_Size);
 
 			return _Partitioner<copy_partitioner_tag>::_For_Each(
-				make_composable_iterator(_First, std::begin(_FilterList)), _Size, _Output_token(_Dest, _Dest2),
+				make_composable_iterator(_First, _Filter.begin()), _Size, _Output_token(_Dest, _Dest2),
 				[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) { // Filtering stage
 
 				difference_type _Sum_true = 0;
@@ -304,40 +419,20 @@ namespace details
 				LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
 					[_Pred, &_Sum_true, &_Sum_false](_Iter_type::reference _It){
 
-					auto _Filter = std::get<1>(_It);
-
-					if (_Pred(*std::get<0>(_It))) {
-						_Filter->first = _Sum_true;
-						_Filter->second = _Output_token::EMPTY_POSITION;
+					const bool _Is_true = _Pred(*std::get<0>(_It)) ? true : false;
+					*std::get<1>(_It) = _Is_true;
+					if (_Is_true)
 						++_Sum_true;
-					}
-					else {
-						_Filter->first = _Output_token::EMPTY_POSITION;
-						_Filter->second = _Sum_false;
+					else
 						++_Sum_false;
-					}
 				});
 
 				_Output.set_position(_Sum_true, _Sum_false);
 			},
 				[](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage
-				auto _Out = _Dest.get();
-
-				LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
-					[&_Out](_Iter_type::reference _It){
-
-					auto _Filter = std::get<1>(_It);
-
-					if (_Filter->first != _Output_token::EMPTY_POSITION) {
-						*_Out.first = *std::get<0>(_It);
-						++_Out.first;
-					}
-					else if (_Filter->second != _Output_token::EMPTY_POSITION) {
-						*_Out.second = *std::get<0>(_It);
-						++_Out.second;
-					}
-				});
-			}).get_result();
+				_Partition_marked<_ExPolicy>(_Begin, _Partition_count, _Dest.get(),
+					std::integral_constant<bool, _Is_compress_copy<_InIt, _OutIt>::value && _Is_compress_copy<_InIt, _OutIt2>::value>());
+			}, _Filter_mask::chunk_size(_Size)).get_result();
 		}
 
 		return std::pair<_OutIt, _OutIt2>(_Dest, _Dest2);
@@ -359,6 +454,7 @@ namespace details
 template <class _ExPolicy, typename _FwdIt, typename _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type partition(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("partition");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Partition_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -367,6 +463,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type partition(_E
 template<class _ExPolicy, class _BidIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _BidIt>::type stable_partition(_ExPolicy&& _Policy, _BidIt _First, _BidIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("stable_partition");
 	static_assert(std::is_base_of<std::bidirectional_iterator_tag, typename std::iterator_traits<_BidIt>::iterator_category>::value, "Required bidirectional iterator or stronger.");
 
 	return details::_Stable_partition_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -375,6 +472,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _BidIt>::type stable_parti
 template<class _ExPolicy, class _InIt, class _OutIt, class _OutIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _OutIt2> >::type partition_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _OutIt2 _Dest2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("partition_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt2>::iterator_category>::value, "Required output iterator or stronger.");
@@ -0,0 +1,352 @@
+#pragma once
+
+#ifndef _IMPL_PERMUTE_H_
+#define _IMPL_PERMUTE_H_ 1
+
+#include <climits>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algorithm_impl.h"
+#include "bulk_search.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	//
+	// gather, scatter, apply_permutation
+	//
+	// Every element moved through an index is a miss to memory once the range outgrows the caches. The loops
+	// prefetch the element they will move a few iterations ahead, so the misses of consecutive elements overlap
+	// instead of stalling the loop one after the other.
+	const size_t _Permute_prefetch_distance = 16;
+
+	inline size_t _Gather_blocks(const sequential_execution_policy&, size_t)
+	{
+		return 1;
+	}
+
+	template<class _ExPolicy>
+	inline size_t _Gather_blocks(const _ExPolicy& _Policy, size_t _Size)
+	{
+		return (std::max)((std::min)(static_cast<size_t>(_Policy_thread_count(_Policy)), _Size / _Grain_size(_Policy, 2048)), size_t{ 1 });
+	}
+
+	// Runs _Func(_I) for [_Begin, _End) and prefetches the element _Base + _Index(_I) of a later iteration
+	template<typename _RanIt, typename _Index_fn, typename _Fn>
+	inline void _Prefetched_loop(_RanIt _Base, size_t _Begin, size_t _End, const _Index_fn& _Index, const _Fn& _Func)
+	{
+		typedef _Contiguous_container_iterator_traits<_RanIt> _Contiguous;
+
+		for (size_t _I = _Begin; _I < (std::min)(_End, _Begin + _Permute_prefetch_distance); ++_I)
+			_Prefetch_element(_Base + _Index(_I), _Contiguous());
+
+		for (size_t _I = _Begin; _I < _End; ++_I)
+		{
+			if (_I + _Permute_prefetch_distance < _End)
+				_Prefetch_element(_Base + _Index(_I + _Permute_prefetch_distance), _Contiguous());
+			_Func(_I);
+		}
+	}
+
+	template<class _ExPolicy, class _IdxIt, class _RanIt, class _OutIt>
+	inline _OutIt _Gather_impl(const _ExPolicy& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt _Src, _OutIt _Dest)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Indices_last - _Indices_first;
+		const size_t _Blocks = _Gather_blocks(_Policy, _Size);
+		const auto _Index = [_Indices_first](size_t _I) { return static_cast<size_t>(_Indices_first[_I]); };
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			_Prefetched_loop(_Src, _Size * _Block / _Blocks, _Size * (_Block + 1) / _Blocks, _Index, [&](size_t _I) {
+				_Dest[_I] = _Src[_Index(_I)];
+			});
+		});
+
+		return _Dest + _Size;
+	}
+
+	template<class _IdxIt, class _RanIt, class _OutIt>
+	inline _OutIt _Gather_impl(const execution_policy& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt _Src, _OutIt _Dest)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Gather_impl, _Policy, _Indices_first, _Indices_last, _Src, _Dest);
+	}
+
+	// A large scatter into a span the caches can't hold is partitioned first
+	const size_t _Scatter_cache_bytes = 4 * 1024 * 1024;
+	const size_t _Scatter_partition_min_size = 1 << 18;
+	const size_t _Scatter_bucket_bits = 8;
+	const size_t _Scatter_buckets = size_t{ 1 } << _Scatter_bucket_bits;
+
+	// The two level scatter: the (index, value) pairs are partitioned by the top bits of their index into buckets
+	// in parallel blocks, the way a pass of the radix sort is, then every task writes the values of its buckets.
+	// The writes of a bucket land in a slice of _Dest a cache holds instead of all over it. Returns false if the
+	// buffers can't be allocated, nothing was written then.
+	template<typename _IdxIt, typename _RanIt1, typename _RanIt2>
+	bool _Partition_and_scatter(size_t _Blocks, _IdxIt _Indices, size_t _Size, _RanIt1 _Src, _RanIt2 _Dest, size_t _Shift)
+	{
+		typedef typename std::iterator_traits<_RanIt1>::value_type _Value_type;
+
+		std::unique_ptr<_Uninitialized_buffer<_Value_type>> _Values;
+		std::unique_ptr<_Uninitialized_buffer<size_t>> _Places;
+		try
+		{
+			_Values.reset(new _Uninitialized_buffer<_Value_type>(_Size));
+			_Places.reset(new _Uninitialized_buffer<size_t>(_Size));
+		}
+		catch (const std::bad_alloc&)
+		{
+			return false;
+		}
+
+		std::vector<size_t> _Counts(_Blocks * _Scatter_buckets); // per block, then the place of each run
+		std::vector<size_t> _Bucket_begin(_Scatter_buckets + 1);
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			size_t *_Count = _Counts.data() + _Block * _Scatter_buckets;
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+				++_Count[static_cast<size_t>(_Indices[_I]) >> _Shift];
+		});
+
+		size_t _Place = 0;
+		for (size_t _Bucket = 0; _Bucket < _Scatter_buckets; ++_Bucket)
+		{
+			_Bucket_begin[_Bucket] = _Place;
+			for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+			{
+				size_t& _Count = _Counts[_Block * _Scatter_buckets + _Bucket];
+				const size_t _Run = _Count;
+				_Count = _Place;
+				_Place += _Run;
+			}
+		}
+		_Bucket_begin[_Scatter_buckets] = _Place;
+
+		_Value_type *_Vals = _Values->get();
+		size_t *_Where = _Places->get();
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			size_t _Next[_Scatter_buckets];
+			std::copy(_Counts.data() + _Block * _Scatter_buckets, _Counts.data() + (_Block + 1) * _Scatter_buckets, _Next);
+
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+			{
+				const size_t _Index = static_cast<size_t>(_Indices[_I]);
+				const size_t _At = _Next[_Index >> _Shift]++;
+				_Where[_At] = _Index;
+				::new (static_cast<void*>(_Vals + _At)) _Value_type(_Src[_I]);
+			}
+		});
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			const size_t _From = _Bucket_begin[_Scatter_buckets * _Block / _Blocks], _To = _Bucket_begin[_Scatter_buckets * (_Block + 1) / _Blocks];
+			for (size_t _At = _From; _At < _To; ++_At)
+				_Dest[_Where[_At]] = _Vals[_At];
+		});
+
+		return true;
+	}
+
+	template<typename _IdxIt, typename _RanIt1, typename _RanIt2>
+	bool _Partitioned_scatter(size_t _Blocks, _IdxIt _Indices, size_t _Size, _RanIt1 _Src, _RanIt2 _Dest, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt1>::value_type _Value_type;
+		if (_Blocks < 2 || _Size < _Scatter_partition_min_size)
+			return false;
+
+		std::vector<size_t> _Max(_Blocks);
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			size_t _Largest = 0;
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+				_Largest = (std::max)(_Largest, static_cast<size_t>(_Indices[_I]));
+			_Max[_Block] = _Largest;
+		});
+
+		const size_t _Largest = *std::max_element(_Max.begin(), _Max.end());
+		if (_Largest < _Scatter_cache_bytes / sizeof(_Value_type))
+			return false;
+
+		size_t _Bits = 0;
+		while (_Bits < sizeof(size_t) * CHAR_BIT && (_Largest >> _Bits) != 0)
+			++_Bits;
+
+		return _Partition_and_scatter(_Blocks, _Indices, _Size, _Src, _Dest, _Bits > _Scatter_bucket_bits ? _Bits - _Scatter_bucket_bits : 0);
+	}
+
+	// Values that must be constructed or destroyed aren't copied through a buffer
+	template<typename _IdxIt, typename _RanIt1, typename _RanIt2>
+	bool _Partitioned_scatter(size_t, _IdxIt, size_t, _RanIt1, _RanIt2, std::false_type)
+	{
+		return false;
+	}
+
+	template<class _ExPolicy, class _IdxIt, class _RanIt1, class _RanIt2>
+	inline void _Scatter_impl(const _ExPolicy& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt1 _Src, _RanIt2 _Dest)
+	{
+		typedef typename std::iterator_traits<_RanIt1>::value_type _Value_type;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Indices_last - _Indices_first;
+		const size_t _Blocks = _Gather_blocks(_Policy, _Size);
+		if (_Partitioned_scatter(_Blocks, _Indices_first, _Size, _Src, _Dest, std::integral_constant<bool,
+			std::is_trivially_copyable<_Value_type>::value && std::is_same<_Value_type, typename std::iterator_traits<_RanIt2>::value_type>::value>()))
+			return;
+
+		const auto _Index = [_Indices_first](size_t _I) { return static_cast<size_t>(_Indices_first[_I]); };
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			_Prefetched_loop(_Dest, _Size * _Block / _Blocks, _Size * (_Block + 1) / _Blocks, _Index, [&](size_t _I) {
+				_Dest[_Index(_I)] = _Src[_I];
+			});
+		});
+	}
+
+	template<class _IdxIt, class _RanIt1, class _RanIt2>
+	inline void _Scatter_impl(const execution_policy& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt1 _Src, _RanIt2 _Dest)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Scatter_impl, _Policy, _Indices_first, _Indices_last, _Src, _Dest);
+	}
+
+	// Follows the cycles of the permutation and moves every value once, without storage but on one thread. For
+	// values whose moves may throw and for storage that can't be allocated.
+	template<typename _RanIt, typename _IdxIt>
+	inline void _Apply_permutation(_RanIt _First, size_t _Size, _IdxIt _Indices, size_t, std::false_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		std::vector<bool> _Placed(_Size);
+		for (size_t _I = 0; _I < _Size; ++_I)
+		{
+			if (_Placed[_I])
+				continue;
+
+			_Value_type _Value(std::move(_First[_I]));
+			size_t _Hole = _I;
+			for (size_t _From = static_cast<size_t>(_Indices[_Hole]); _From != _I; _From = static_cast<size_t>(_Indices[_Hole]))
+			{
+				_First[_Hole] = std::move(_First[_From]);
+				_Placed[_Hole] = true;
+				_Hole = _From;
+			}
+
+			_First[_Hole] = std::move(_Value);
+			_Placed[_Hole] = true;
+		}
+	}
+
+	// Gathers the values into raw storage and moves them back, both in parallel blocks
+	template<typename _RanIt, typename _IdxIt>
+	inline void _Apply_permutation(_RanIt _First, size_t _Size, _IdxIt _Indices, size_t _Blocks, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		std::unique_ptr<_Uninitialized_buffer<_Value_type>> _Buffer;
+		try
+		{
+			_Buffer.reset(new _Uninitialized_buffer<_Value_type>(_Size));
+		}
+		catch (const std::bad_alloc&)
+		{
+			return _Apply_permutation(_First, _Size, _Indices, _Blocks, std::false_type());
+		}
+
+		_Value_type *_Buf = _Buffer->get();
+		const auto _Index = [_Indices](size_t _I) { return static_cast<size_t>(_Indices[_I]); };
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			_Prefetched_loop(_First, _Size * _Block / _Blocks, _Size * (_Block + 1) / _Blocks, _Index, [&](size_t _I) {
+				::new (static_cast<void*>(_Buf + _I)) _Value_type(std::move(_First[_Index(_I)]));
+			});
+		});
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+			{
+				_First[_I] = std::move(_Buf[_I]);
+				_Buf[_I].~_Value_type();
+			}
+		});
+	}
+
+	template<class _ExPolicy, class _RanIt, class _IdxIt>
+	inline void _Apply_permutation_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _IdxIt _Indices_first)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Last - _First;
+		_Apply_permutation(_First, _Size, _Indices_first, _Gather_blocks(_Policy, _Size),
+			_Is_nothrow_movable<typename std::iterator_traits<_RanIt>::value_type>());
+	}
+
+	template<class _RanIt, class _IdxIt>
+	inline void _Apply_permutation_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _IdxIt _Indices_first)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Apply_permutation_impl, _Policy, _First, _Last, _Indices_first);
+	}
+} // details
+
+/// <summary>
+///     Copies _Src[*_It] to the place of every index _It of [_Indices_first, _Indices_last) in the range at _Dest.
+///     Returns the end of the range written.
+/// </summary>
+/// <remarks>
+///     The loads through the indices are prefetched a few elements ahead, contiguous sources only.
+/// </remarks>
+template<class _ExPolicy, class _IdxIt, class _RanIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type gather(_ExPolicy&& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt _Src, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("gather");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_IdxIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required random access iterator.");
+
+	return details::_Gather_impl(_Policy, _Indices_first, _Indices_last, _Src, _Dest);
+}
+
+/// <summary>
+///     Copies every element of the range at _Src to _Dest[*_It], _It the index of its place in
+///     [_Indices_first, _Indices_last). The indices must be distinct.
+/// </summary>
+/// <remarks>
+///     A large scatter of trivially copyable values into a span the caches can't hold is partitioned by index first,
+///     then every thread writes the values of a slice of _Dest. Otherwise the stores are prefetched a few elements
+///     ahead, contiguous destinations only.
+/// </remarks>
+template<class _ExPolicy, class _IdxIt, class _RanIt1, class _RanIt2>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type scatter(_ExPolicy&& _Policy, _IdxIt _Indices_first, _IdxIt _Indices_last, _RanIt1 _Src, _RanIt2 _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("scatter");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_IdxIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt1>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt2>::iterator_category>::value, "Required random access iterator.");
+
+	details::_Scatter_impl(_Policy, _Indices_first, _Indices_last, _Src, _Dest);
+}
+
+/// <summary>
+///     Reorders the range in place so that its element _I is the one that was at the index _Indices_first[_I], the
+///     order sort_indices returns for instance. The indices must be a permutation of [0, _Last - _First).
+/// </summary>
+/// <remarks>
+///     The values are gathered into a buffer and moved back in parallel. Values whose moves may throw, and ranges
+///     no buffer can be allocated for, are moved along the cycles of the permutation on one thread.
+/// </remarks>
+template<class _ExPolicy, class _RanIt, class _IdxIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type apply_permutation(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, _IdxIt _Indices_first)
+{
+	_EXP_TELEMETRY_ALGORITHM("apply_permutation");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_IdxIt>::iterator_category>::value, "Required random access iterator.");
+
+	details::_Apply_permutation_impl(_Policy, _First, _Last, _Indices_first);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_PERMUTE_H_
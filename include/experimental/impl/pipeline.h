@@ -0,0 +1,478 @@
+#pragma once
+
+#ifndef _IMPL_PIPELINE_H_
+#define _IMPL_PIPELINE_H_ 1
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include <experimental/exception>
+#include "defines.h"
+#include "algorithm_scheduler.h"
+#include "taskgroup.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     How a filter of a parallel_pipeline processes the items.
+/// </summary>
+enum class filter_mode
+{
+	/// <summary>
+	///     Several items at once.
+	/// </summary>
+	parallel,
+	/// <summary>
+	///     One item at a time, in the order the input filter produced them.
+	/// </summary>
+	serial_in_order,
+	/// <summary>
+	///     One item at a time, in any order.
+	/// </summary>
+	serial_out_of_order
+};
+
+/// <summary>
+///     Passed to the input filter of a parallel_pipeline, which calls <c>stop</c> when there are no more items. The
+///     value it returns then is dropped.
+/// </summary>
+class flow_control
+{
+	bool _Stopped;
+public:
+	flow_control() : _Stopped(false)
+	{
+	}
+
+	void stop() _NOEXCEPT
+	{
+		_Stopped = true;
+	}
+
+	bool _Is_stopped() const _NOEXCEPT
+	{
+		return _Stopped;
+	}
+};
+
+namespace details {
+
+	class _Pipeline;
+	struct _Pipeline_token;
+
+	class _Pipeline_stage
+	{
+	public:
+		filter_mode _Mode;
+		std::mutex _Lock;
+		size_t _Next_item; // serial_in_order: the item to go through next
+		std::vector<_Pipeline_token *> _Parked; // serial_in_order: the tokens waiting for their turn, by item modulo the tokens
+
+		_Pipeline_stage(filter_mode _Md, size_t _Tokens) : _Mode(_Md), _Next_item(0)
+		{
+			if (_Mode == filter_mode::serial_in_order)
+				_Parked.resize(_Tokens, nullptr);
+		}
+
+		virtual ~_Pipeline_stage()
+		{
+		}
+
+		// Runs the filter for the item in the slot of its token, false if the input filter stopped
+		virtual bool _Run(size_t _Slot, flow_control& _Flow) = 0;
+
+		// Destroys the input of a dropped item
+		virtual void _Discard(size_t _Slot) = 0;
+	};
+
+	// The outputs of a filter, one slot per token
+	template<typename _Out>
+	class _Pipeline_output : public _Pipeline_stage
+	{
+		typedef typename std::aligned_storage<sizeof(_Out), std::alignment_of<_Out>::value>::type _Storage;
+		std::unique_ptr<_Storage[]> _Values;
+
+	public:
+		_Pipeline_output(filter_mode _Md, size_t _Tokens) : _Pipeline_stage(_Md, _Tokens), _Values(new _Storage[_Tokens])
+		{
+		}
+
+		_Out *_Value(size_t _Slot)
+		{
+			return reinterpret_cast<_Out *>(&_Values[_Slot]);
+		}
+
+		_Out _Take(size_t _Slot)
+		{
+			_Out *_Val = _Value(_Slot);
+			_Out _Result(std::move(*_Val));
+			_Val->~_Out();
+			return _Result;
+		}
+	};
+
+	template<>
+	class _Pipeline_output<void> : public _Pipeline_stage
+	{
+	public:
+		_Pipeline_output(filter_mode _Md, size_t _Tokens) : _Pipeline_stage(_Md, _Tokens)
+		{
+		}
+	};
+
+	template<typename _In, typename _Out, typename _Fn>
+	class _Filter_stage : public _Pipeline_output<_Out>
+	{
+		_Fn _Func;
+		_Pipeline_output<_In> *_Input;
+
+		// input filter
+		bool _Call(size_t _Slot, flow_control& _Flow, std::true_type, std::false_type)
+		{
+			_Out _Result = _Func(_Flow);
+			if (_Flow._Is_stopped())
+				return false;
+			::new (static_cast<void *>(this->_Value(_Slot))) _Out(std::move(_Result));
+			return true;
+		}
+
+		// input filter of a pipeline of one filter
+		bool _Call(size_t, flow_control& _Flow, std::true_type, std::true_type)
+		{
+			_Func(_Flow);
+			return !_Flow._Is_stopped();
+		}
+
+		bool _Call(size_t _Slot, flow_control&, std::false_type, std::false_type)
+		{
+			::new (static_cast<void *>(this->_Value(_Slot))) _Out(_Func(_Input->_Take(_Slot)));
+			return true;
+		}
+
+		// output filter
+		bool _Call(size_t _Slot, flow_control&, std::false_type, std::true_type)
+		{
+			_Func(_Input->_Take(_Slot));
+			return true;
+		}
+
+		void _Drop(size_t _Slot, std::false_type)
+		{
+			_Input->_Value(_Slot)->~_In();
+		}
+
+		void _Drop(size_t, std::true_type)
+		{
+		}
+
+	public:
+		_Filter_stage(filter_mode _Md, const _Fn& _Fn_arg, _Pipeline_stage *_Prev, size_t _Tokens)
+			: _Pipeline_output<_Out>(_Md, _Tokens), _Func(_Fn_arg), _Input(static_cast<_Pipeline_output<_In> *>(_Prev))
+		{
+		}
+
+		virtual bool _Run(size_t _Slot, flow_control& _Flow) override
+		{
+			return _Call(_Slot, _Flow, std::is_void<_In>(), std::is_void<_Out>());
+		}
+
+		virtual void _Discard(size_t _Slot) override
+		{
+			_Drop(_Slot, std::is_void<_In>());
+		}
+	};
+
+	// Resumes a token parked at a serial_in_order filter once its turn comes
+	class _Pipeline_chore : public WorkChoreBase
+	{
+		_Pipeline_token *_Token;
+
+	protected:
+		inline virtual void __cdecl userFunc() override;
+
+	public:
+		explicit _Pipeline_chore(_Pipeline_token *_Tk) : _Token(_Tk)
+		{
+		}
+
+		void _Reset()
+		{
+			resetTaskGroup();
+		}
+	};
+
+	// Carries an item through the filters, the outputs of the filters for the item sit in the slot of the token
+	struct _Pipeline_token
+	{
+		_Pipeline *_Owner;
+		size_t _Slot;
+		size_t _Item;
+		size_t _Stage; // the filter to run next, 0 when the token is free for a new item
+		bool _Has_value; // the previous filter left a value in the slot
+		_Pipeline_chore _Chore;
+
+		_Pipeline_token() : _Owner(nullptr), _Slot(0), _Item(0), _Stage(0), _Has_value(false), _Chore(this)
+		{
+		}
+	};
+
+	class _Pipeline
+	{
+		std::vector<std::unique_ptr<_Pipeline_stage>> _Stages;
+		std::unique_ptr<_Pipeline_token[]> _Tokens;
+		std::vector<_Pipeline_token *> _Free;
+		std::mutex _Input_lock;
+		size_t _Next_item;
+		bool _Stopped;
+		std::atomic<bool> _Cancelled;
+		std::mutex _Error_lock;
+		std::list<std::exception_ptr> _Exceptions;
+
+		void _Fail()
+		{
+			_Cancelled.store(true, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> _Guard(_Error_lock);
+			_Exceptions.push_back(std::current_exception());
+		}
+
+		// Runs the input filter into the token, or into a free one for nullptr. Returns the token of
+		// the new item, nullptr when there is no item or no free token.
+		_Pipeline_token *_Input(_Pipeline_token *_Token)
+		{
+			std::lock_guard<std::mutex> _Guard(_Input_lock);
+			if (_Stopped || _Cancelled.load(std::memory_order_relaxed))
+				_Stopped = true;
+			else if (_Token == nullptr && !_Free.empty()) {
+				_Token = _Free.back();
+				_Free.pop_back();
+			}
+			if (_Stopped || _Token == nullptr)
+				return nullptr;
+
+			flow_control _Flow;
+			bool _Produced = false;
+			try {
+				_Produced = _Stages[0]->_Run(_Token->_Slot, _Flow);
+			}
+			catch (...) {
+				_Fail();
+			}
+			if (!_Produced) {
+				_Stopped = true;
+				return nullptr;
+			}
+
+			_Token->_Item = _Next_item++;
+			_Token->_Stage = 1;
+			_Token->_Has_value = true;
+			return _Token;
+		}
+
+		void _Run_filter(_Pipeline_stage& _Stage, _Pipeline_token& _Token)
+		{
+			if (!_Token._Has_value)
+				return;
+			if (_Cancelled.load(std::memory_order_relaxed)) {
+				_Stage._Discard(_Token._Slot);
+				_Token._Has_value = false;
+				return;
+			}
+
+			_Token._Has_value = false;
+			try {
+				flow_control _Unused; // only the input filter takes it
+				_Stage._Run(_Token._Slot, _Unused);
+				_Token._Has_value = true;
+			}
+			catch (...) {
+				_Fail();
+			}
+		}
+
+	public:
+		_Pipeline(size_t _Max_tokens) : _Tokens(new _Pipeline_token[_Max_tokens]), _Next_item(0), _Stopped(false), _Cancelled(false)
+		{
+			for (size_t _Slot = 0; _Slot < _Max_tokens; ++_Slot) {
+				_Tokens[_Slot]._Owner = this;
+				_Tokens[_Slot]._Slot = _Slot;
+			}
+		}
+
+		void _Add_stage(_Pipeline_stage *_Stage)
+		{
+			_Stages.emplace_back(_Stage);
+		}
+
+		// Takes items through the filters until the input stops: a token that completes the last filter takes the
+		// next item, a token parked at a serial_in_order filter is left for the thread that runs its predecessor there
+		void _Process(_Pipeline_token *_Token)
+		{
+			TaskGroup _Tg;
+			for (;;)
+			{
+				if (_Token == nullptr || _Token->_Stage == 0) {
+					_Token = _Input(_Token);
+					if (_Token == nullptr)
+						break;
+				}
+
+				bool _Parked = false;
+				for (; _Token->_Stage < _Stages.size(); ++_Token->_Stage)
+				{
+					_Pipeline_stage& _Stage = *_Stages[_Token->_Stage];
+					if (_Stage._Mode == filter_mode::parallel)
+						_Run_filter(_Stage, *_Token);
+					else if (_Stage._Mode == filter_mode::serial_out_of_order) {
+						std::lock_guard<std::mutex> _Guard(_Stage._Lock);
+						_Run_filter(_Stage, *_Token);
+					}
+					else {
+						{
+							std::lock_guard<std::mutex> _Guard(_Stage._Lock);
+							if (_Stage._Next_item != _Token->_Item) {
+								// from here on another thread may resume the token
+								_Stage._Parked[_Token->_Item % _Stage._Parked.size()] = _Token;
+								_Parked = true;
+								break;
+							}
+						}
+						_Run_filter(_Stage, *_Token);
+
+						_Pipeline_token *_Resumed;
+						{
+							std::lock_guard<std::mutex> _Guard(_Stage._Lock);
+							const size_t _Next = ++_Stage._Next_item;
+							_Pipeline_token *& _Waiting = _Stage._Parked[_Next % _Stage._Parked.size()];
+							_Resumed = _Waiting != nullptr && _Waiting->_Item == _Next ? _Waiting : nullptr;
+							if (_Resumed != nullptr)
+								_Waiting = nullptr;
+						}
+						if (_Resumed != nullptr) {
+							_Resumed->_Chore._Reset();
+							_Tg.run(_Resumed->_Chore);
+						}
+					}
+				}
+
+				if (_Parked)
+					_Token = nullptr;
+				else
+					_Token->_Stage = 0;
+			}
+			_Tg.wait();
+		}
+
+		void _Run(size_t _Max_tokens)
+		{
+			const size_t _Workers = (std::min)(_Max_tokens, static_cast<size_t>(get_hardware_concurrency()));
+			for (size_t _Slot = _Max_tokens; _Slot > _Workers; --_Slot)
+				_Free.push_back(&_Tokens[_Slot - 1]);
+
+			{
+				TaskGroup _Tg;
+				for (size_t _Slot = 1; _Slot < _Workers; ++_Slot)
+					_Tg.run(_Tokens[_Slot]._Chore);
+				_Process(&_Tokens[0]);
+				_Tg.wait();
+			}
+
+			if (!_Exceptions.empty())
+				throw exception_list(std::move(_Exceptions));
+		}
+	};
+
+	inline void __cdecl _Pipeline_chore::userFunc()
+	{
+		_Token->_Owner->_Process(_Token);
+	}
+}
+
+/// <summary>
+///     A chain of filters for parallel_pipeline, from items of type <c>_In</c> to items of type <c>_Out</c>. The
+///     first filter of a pipeline takes a flow_control, the last one returns void. Filters are chained with
+///     <c>operator&amp;</c>.
+/// </summary>
+template<typename _In, typename _Out>
+class filter
+{
+	typedef std::function<details::_Pipeline_stage *(details::_Pipeline_stage *, size_t)> _Stage_maker;
+
+	template<typename, typename> friend class filter;
+
+	std::vector<_Stage_maker> _Makers;
+
+	filter()
+	{
+	}
+
+public:
+	/// <summary>
+	///     A filter that calls <c>_Func</c> for the items, <c>_Func(flow_control&amp;)</c> for the first filter.
+	/// </summary>
+	template<typename _Fn>
+	filter(filter_mode _Mode, _Fn _Func)
+	{
+		_Makers.push_back([_Mode, _Func](details::_Pipeline_stage *_Prev, size_t _Tokens) -> details::_Pipeline_stage * {
+			return new details::_Filter_stage<_In, _Out, _Fn>(_Mode, _Func, _Prev, _Tokens);
+		});
+	}
+
+	/// <summary>
+	///     The chain of this filter followed by the filter on the right.
+	/// </summary>
+	template<typename _Next>
+	filter<_In, _Next> operator&(const filter<_Out, _Next>& _Right) const
+	{
+		static_assert(!std::is_void<_Out>::value, "Only the last filter returns void.");
+
+		filter<_In, _Next> _Chain;
+		_Chain._Makers = _Makers;
+		_Chain._Makers.insert(_Chain._Makers.end(), _Right._Makers.begin(), _Right._Makers.end());
+		return _Chain;
+	}
+
+	const std::vector<_Stage_maker>& _Stage_makers() const
+	{
+		return _Makers;
+	}
+};
+
+/// <summary>
+///     Returns a filter that calls <c>_Func</c> for the items, see filter.
+/// </summary>
+template<typename _In, typename _Out, typename _Fn>
+inline filter<_In, _Out> make_filter(filter_mode _Mode, _Fn _Func)
+{
+	return filter<_In, _Out>(_Mode, _Func);
+}
+
+/// <summary>
+///     Runs the items produced by the first filter through the others. At most <c>_Max_tokens</c> items are in flight,
+///     each one carried through the filters by one thread while the threads of the library carry the others, so the
+///     filters overlap across items. The first filter runs one item at a time whatever its mode. After a filter threw,
+///     the input stops, the items in flight are dropped and an exception_list of the exceptions is thrown.
+/// </summary>
+inline void parallel_pipeline(size_t _Max_tokens, const filter<void, void>& _Filters)
+{
+	if (_Max_tokens == 0)
+		throw std::invalid_argument("A pipeline needs at least one token.");
+
+	details::_Pipeline _Line(_Max_tokens);
+	details::_Pipeline_stage *_Prev = nullptr;
+	for (auto& _Maker : _Filters._Stage_makers()) {
+		_Prev = _Maker(_Prev, _Max_tokens);
+		_Line._Add_stage(_Prev);
+	}
+	_Line._Run(_Max_tokens);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_PIPELINE_H_
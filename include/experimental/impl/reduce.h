@@ -23,6 +23,34 @@ namespace details {
 
 			return _Val;
 		}
+
+		// transform_reduce, every element goes through _Transform on its way to the sum
+		template<typename _Ty, typename _InIt, typename _Fn, typename _UnOp>
+		static _Ty Loop(_InIt _First, size_t _Count, _Fn& _UserFunc, _UnOp& _Transform)
+		{
+			_Ty _Val = _Transform(*_First);
+			++_First;
+			--_Count;
+
+			for (size_t _I = 0; _I < _Count; ++_First, ++_I)
+				_Val = _UserFunc(_Val, _Transform(*_First));
+
+			return _Val;
+		}
+
+		template<typename _Ty, typename _InIt, typename _InIt2, typename _Fn, typename _BinOp>
+		static _Ty Loop(_InIt _First, _InIt2 _First2, size_t _Count, _Fn& _UserFunc, _BinOp& _Transform)
+		{
+			_Ty _Val = _Transform(*_First, *_First2);
+			++_First;
+			++_First2;
+			--_Count;
+
+			for (size_t _I = 0; _I < _Count; ++_First, ++_First2, ++_I)
+				_Val = _UserFunc(_Val, _Transform(*_First, *_First2));
+
+			return _Val;
+		}
 	};
 
 	// pragma par
@@ -42,6 +70,30 @@ namespace details {
 
 			return _Val;
 		}
+
+		template<typename _Ty, typename _InIt, typename _Fn, typename _UnOp>
+		static _Ty Loop(_InIt _First, size_t _Count, _Fn& _UserFunc, _UnOp& _Transform)
+		{
+			_Ty _Val = _Transform(*_First);
+
+			_EXP_PRAGMA_PAR
+				for (size_t _I = 1; _I < _Count; ++_I)
+					_Val = _UserFunc(_Val, _Transform(_First[_I]));
+
+			return _Val;
+		}
+
+		template<typename _Ty, typename _InIt, typename _InIt2, typename _Fn, typename _BinOp>
+		static _Ty Loop(_InIt _First, _InIt2 _First2, size_t _Count, _Fn& _UserFunc, _BinOp& _Transform)
+		{
+			_Ty _Val = _Transform(*_First, *_First2);
+
+			_EXP_PRAGMA_PAR
+				for (size_t _I = 1; _I < _Count; ++_I)
+					_Val = _UserFunc(_Val, _Transform(_First[_I], _First2[_I]));
+
+			return _Val;
+		}
 	};
 
 	// pragma par_vec
@@ -50,17 +102,142 @@ namespace details {
 	{
 		template<typename _Ty, typename _InIt, typename _Fn>
 		static _Ty Loop(_InIt _First, size_t _Count, _Fn& _UserFunc)
+		{
+			return VecLoopHelper<_Ty>(_First, _Count, _UserFunc, std::integral_constant<bool,
+				std::is_arithmetic<_Ty>::value && _Contiguous_container_iterator_traits<_InIt>::value>());
+		}
+
+		// A single accumulator chains every element on the latency of the operation. reduce may
+		// regroup the elements, so arithmetic types run four independent lanes the vectorizer
+		// can pack into one register and that combine at the end.
+		template<typename _Ty, typename _InIt, typename _Fn>
+		static _Ty VecLoopHelper(_InIt _First, size_t _Count, _Fn& _UserFunc, std::true_type)
+		{
+			if (_Count < 8)
+				return VecLoopHelper<_Ty>(_First, _Count, _UserFunc, std::false_type());
+
+			const typename std::iterator_traits<_InIt>::value_type * _EXP_RESTRICT _FirstP = _Unwrap_contiguous(_First);
+			_Ty _Lane0 = _FirstP[0], _Lane1 = _FirstP[1], _Lane2 = _FirstP[2], _Lane3 = _FirstP[3];
+
+			size_t _I = 4;
+			for (; _I + 4 <= _Count; _I += 4)
+			{
+				_Lane0 = _UserFunc(_Lane0, _FirstP[_I]);
+				_Lane1 = _UserFunc(_Lane1, _FirstP[_I + 1]);
+				_Lane2 = _UserFunc(_Lane2, _FirstP[_I + 2]);
+				_Lane3 = _UserFunc(_Lane3, _FirstP[_I + 3]);
+			}
+
+			for (; _I < _Count; ++_I)
+				_Lane0 = _UserFunc(_Lane0, _FirstP[_I]);
+
+			return _UserFunc(_UserFunc(_Lane0, _Lane1), _UserFunc(_Lane2, _Lane3));
+		}
+
+		template<typename _Ty, typename _InIt, typename _Fn>
+		static _Ty VecLoopHelper(_InIt _First, size_t _Count, _Fn& _UserFunc, std::false_type)
 		{
 			_Ty _Val = *_First;
 			++_First;
 			--_Count;
 
-#pragma loop(ivdep)
+			_EXP_LOOP_IVDEP
 			for (size_t _I = 0; _I < _Count; ++_I)
 				_Val = _UserFunc(_Val, _First[_I]);
 
 			return _Val;
 		}
+
+		// The transformed elements are summed in the same four lanes, the transform is inlined
+		// into the loop and the range is streamed once.
+		template<typename _Ty, typename _InIt, typename _Fn, typename _UnOp>
+		static _Ty Loop(_InIt _First, size_t _Count, _Fn& _UserFunc, _UnOp& _Transform)
+		{
+			return VecLoopHelper<_Ty>(_First, _Count, _UserFunc, _Transform, std::integral_constant<bool,
+				std::is_arithmetic<_Ty>::value && _Contiguous_container_iterator_traits<_InIt>::value>());
+		}
+
+		template<typename _Ty, typename _InIt, typename _Fn, typename _UnOp>
+		static _Ty VecLoopHelper(_InIt _First, size_t _Count, _Fn& _UserFunc, _UnOp& _Transform, std::true_type)
+		{
+			if (_Count < 8)
+				return VecLoopHelper<_Ty>(_First, _Count, _UserFunc, _Transform, std::false_type());
+
+			const typename std::iterator_traits<_InIt>::value_type * _EXP_RESTRICT _FirstP = _Unwrap_contiguous(_First);
+			_Ty _Lane0 = _Transform(_FirstP[0]), _Lane1 = _Transform(_FirstP[1]), _Lane2 = _Transform(_FirstP[2]), _Lane3 = _Transform(_FirstP[3]);
+
+			size_t _I = 4;
+			for (; _I + 4 <= _Count; _I += 4)
+			{
+				_Lane0 = _UserFunc(_Lane0, _Transform(_FirstP[_I]));
+				_Lane1 = _UserFunc(_Lane1, _Transform(_FirstP[_I + 1]));
+				_Lane2 = _UserFunc(_Lane2, _Transform(_FirstP[_I + 2]));
+				_Lane3 = _UserFunc(_Lane3, _Transform(_FirstP[_I + 3]));
+			}
+
+			for (; _I < _Count; ++_I)
+				_Lane0 = _UserFunc(_Lane0, _Transform(_FirstP[_I]));
+
+			return _UserFunc(_UserFunc(_Lane0, _Lane1), _UserFunc(_Lane2, _Lane3));
+		}
+
+		template<typename _Ty, typename _InIt, typename _Fn, typename _UnOp>
+		static _Ty VecLoopHelper(_InIt _First, size_t _Count, _Fn& _UserFunc, _UnOp& _Transform, std::false_type)
+		{
+			_Ty _Val = _Transform(*_First);
+
+			_EXP_LOOP_IVDEP
+			for (size_t _I = 1; _I < _Count; ++_I)
+				_Val = _UserFunc(_Val, _Transform(_First[_I]));
+
+			return _Val;
+		}
+
+		template<typename _Ty, typename _InIt, typename _InIt2, typename _Fn, typename _BinOp>
+		static _Ty Loop(_InIt _First, _InIt2 _First2, size_t _Count, _Fn& _UserFunc, _BinOp& _Transform)
+		{
+			return VecLoopHelper2<_Ty>(_First, _First2, _Count, _UserFunc, _Transform, std::integral_constant<bool,
+				std::is_arithmetic<_Ty>::value && _Contiguous_container_iterator_traits<_InIt>::value && _Contiguous_container_iterator_traits<_InIt2>::value>());
+		}
+
+		template<typename _Ty, typename _InIt, typename _InIt2, typename _Fn, typename _BinOp>
+		static _Ty VecLoopHelper2(_InIt _First, _InIt2 _First2, size_t _Count, _Fn& _UserFunc, _BinOp& _Transform, std::true_type)
+		{
+			if (_Count < 8)
+				return VecLoopHelper2<_Ty>(_First, _First2, _Count, _UserFunc, _Transform, std::false_type());
+
+			// Both ranges are only read, they may overlap
+			const typename std::iterator_traits<_InIt>::value_type * _FirstP = _Unwrap_contiguous(_First);
+			const typename std::iterator_traits<_InIt2>::value_type * _First2P = _Unwrap_contiguous(_First2);
+			_Ty _Lane0 = _Transform(_FirstP[0], _First2P[0]), _Lane1 = _Transform(_FirstP[1], _First2P[1]);
+			_Ty _Lane2 = _Transform(_FirstP[2], _First2P[2]), _Lane3 = _Transform(_FirstP[3], _First2P[3]);
+
+			size_t _I = 4;
+			for (; _I + 4 <= _Count; _I += 4)
+			{
+				_Lane0 = _UserFunc(_Lane0, _Transform(_FirstP[_I], _First2P[_I]));
+				_Lane1 = _UserFunc(_Lane1, _Transform(_FirstP[_I + 1], _First2P[_I + 1]));
+				_Lane2 = _UserFunc(_Lane2, _Transform(_FirstP[_I + 2], _First2P[_I + 2]));
+				_Lane3 = _UserFunc(_Lane3, _Transform(_FirstP[_I + 3], _First2P[_I + 3]));
+			}
+
+			for (; _I < _Count; ++_I)
+				_Lane0 = _UserFunc(_Lane0, _Transform(_FirstP[_I], _First2P[_I]));
+
+			return _UserFunc(_UserFunc(_Lane0, _Lane1), _UserFunc(_Lane2, _Lane3));
+		}
+
+		template<typename _Ty, typename _InIt, typename _InIt2, typename _Fn, typename _BinOp>
+		static _Ty VecLoopHelper2(_InIt _First, _InIt2 _First2, size_t _Count, _Fn& _UserFunc, _BinOp& _Transform, std::false_type)
+		{
+			_Ty _Val = _Transform(*_First, *_First2);
+
+			_EXP_LOOP_IVDEP
+			for (size_t _I = 1; _I < _Count; ++_I)
+				_Val = _UserFunc(_Val, _Transform(_First[_I], _First2[_I]));
+
+			return _Val;
+		}
 	};
 
 	//
@@ -75,17 +252,21 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _InIt, class _Ty, class _BinPr, class _IterCat>
-	_Ty _Reduce_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Ty _Init, _BinPr _BinOp, _IterCat)
+	_Ty _Reduce_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinPr _BinOp, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First == _Last)
 			return _Init;
 
 		// There is not requirement for _Ty to be default constructible thus combinable needs to be initialized with _Init value
 		combinable<_Ty> _Combine([_Init]{ return _Init; });
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(_First, std::distance(_First, _Last), _BinOp,
+		_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _BinOp,
 			[&_Combine](_InIt _Begin, size_t _Count, _BinPr& _UserBinOp) {
 			_Ty _Val = _Reduce_helper<_ExecutionPolicy, _IterCat>::Loop<_Ty>(_Begin, _Count, _UserBinOp);
 
@@ -99,6 +280,24 @@ namespace details {
 		return _BinOp(_Init, _Combine.combine(_BinOp));
 	}
 
+	// Random access ranges reduce into one slot per chunk, combined in a fixed order
+	template <class _ExPolicy, class _RanIt, class _Ty, class _BinPr>
+	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Reduce_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Ty _Init, _BinPr _BinOp, std::random_access_iterator_tag)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+		if (_First == _Last)
+			return _Init;
+
+		return _BinOp(_Init, _Chunked_reduce<_Ty>(_Policy, _First, _Last - _First, _BinOp,
+			[](_RanIt _Begin, size_t _Count, _BinPr& _UserBinOp) {
+			return _Reduce_helper<_ExecutionPolicy, std::random_access_iterator_tag>::Loop<_Ty>(_Begin, _Count, _UserBinOp);
+		},
+			[](const _Ty& _Left, const _Ty& _Right, _BinPr& _UserBinOp) {
+			return _UserBinOp(_Left, _Right);
+		}));
+	}
+
 	template <class _ExPolicy, class _InIt, class _Ty, class _BinPr, class _IterCat>
 	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Reduce_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Ty _Init, _BinPr _Pred, std::input_iterator_tag _Cat)
 	{
@@ -115,6 +314,7 @@ namespace details {
 template <class _ExPolicy, class _InIt, class _Ty = std::iterator_traits<_InIt>::value_type, class _BinPr>
 inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinPr _BinOp)
 {
+	_EXP_TELEMETRY_ALGORITHM("reduce");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 
 	return details::_Reduce_impl(_Policy, _First, _Last, _Init, _BinOp, std::_Iter_cat(_First));
@@ -123,12 +323,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type reduce(_ExPolic
 template <class _ExPolicy, class _InIt, class _Ty = std::iterator_traits<_InIt>::value_type>
 inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("reduce");
 	return reduce(_Policy, _First, _Last, _Ty{}, std::plus<>());
 }
 
 template <class _ExPolicy, class _InIt, class _Ty = std::iterator_traits<_InIt>::value_type>
 inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init)
 {
+	_EXP_TELEMETRY_ALGORITHM("reduce");
 	return reduce(_Policy, _First, _Last, _Init, std::plus<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
@@ -19,48 +19,62 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	// The copy stage of remove_if, the elements the filtering stage kept are moved down to the ones before
+	template<class _ExPolicy, class _Iter_type, class _FwdIt>
+	inline void _Move_marked(_Iter_type _Begin, size_t _Count, _FwdIt _Out, std::false_type)
+	{
+		LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Count,
+			[&_Out](typename _Iter_type::reference _It){
+
+			if (*std::get<1>(_It)) {
+				*_Out = std::move(*std::get<0>(_It));
+				++_Out;
+			}
+		});
+	}
+
+	template<class _ExPolicy, class _Iter_type, class _FwdIt>
+	inline void _Move_marked(_Iter_type _Begin, size_t _Count, _FwdIt _Out, std::true_type)
+	{
+		_Compress_chunk(_Begin, _Count, _Out, true);
+	}
+
 	template<class _ExPolicy, class _InIt, class _Pr, class _IterCat>
-	inline _InIt _Remove_if_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
+	inline _InIt _Remove_if_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Pr _Pred, _IterCat)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
-		typedef composable_iterator<_InIt, std::vector<difference_type>::iterator > _Iter_type;
+		typedef composable_iterator<_InIt, _Filter_mask_iterator> _Iter_type;
 		typedef _Output_token<_InIt> _Output_token;
 
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First == _Last)
 			return _First;
 
 		auto _Size = std::distance(_First, _Last);
-		std::vector<difference_type> _Filter(_Size);
+		_Filter_mask _Filter(_Size);
 
-		return _Partitioner<remove_partitioner_tag>::_For_Each(make_composable_iterator(_First, std::begin(_Filter)), _Size, _Output_token(_First),
+		return _Partitioner<remove_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Filter.begin()), _Size, _Output_token(_First),
 			[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
 
 			difference_type _Sum = 0;
 			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
 				[&_Pred, &_Sum](_Iter_type::reference _It){
 
-				if (!_Pred(*std::get<0>(_It))) {
-					*std::get<1>(_It) = _Sum;
+				const bool _Keep = _Pred(*std::get<0>(_It)) ? false : true;
+				*std::get<1>(_It) = _Keep;
+				if (_Keep)
 					++_Sum;
-				}
-				else *std::get<1>(_It) = _Output_token::EMPTY_POSITION;
 			});
 
 			_Output.set_position(_Sum);
 		},
 			[](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage
-			auto _Out = _Dest.get();
-
-			LoopHelper<_ExPolicy, _Iter_type>::Loop(_Begin, _Partition_count,
-				[&_Out](_Iter_type::reference _It){
-
-				if (*std::get<1>(_It) != _Output_token::EMPTY_POSITION) {
-					*_Out = std::move(*std::get<0>(_It));
-					++_Out;
-				}
-			});
-		}).get_result();
+			_Move_marked<_ExPolicy>(_Begin, _Partition_count, _Dest.get(), _Is_compress_copy<_InIt, _InIt>());
+		}, _Filter_mask::chunk_size(_Size)).get_result();
 	}
 
 	template<class _ExPolicy, class _InIt, class _Pr>
@@ -110,6 +124,7 @@ namespace details {
 template<class _ExPolicy, class _FwdIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type remove(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("remove");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Remove_if_impl(_Policy, _First, _Last, [&_Val](typename std::iterator_traits<_FwdIt>::reference _El){
@@ -120,6 +135,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type remove(_ExPo
 template<class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type remove_if(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("remove_if");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Remove_if_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -128,6 +144,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type remove_if(_E
 template<class _ExPolicy, class _InIt, class _OutIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type remove_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("remove_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -140,6 +157,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type remove_copy(
 template<class _ExPolicy, class _InIt, class _OutIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type remove_copy_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("remove_copy_if");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -122,6 +122,7 @@ namespace details {
 template <class _ExPolicy, class _FwdIt, class _Pr, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type replace_if(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, const _Ty& _New)
 {
+	_EXP_TELEMETRY_ALGORITHM("replace_if");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	details::_Replace_if_impl(_Policy, _First, _Last, _Pred, _New);
@@ -130,6 +131,7 @@ inline typename details::_enable_if_policy<_ExPolicy, void>::type replace_if(_Ex
 template <class _ExPolicy, class _FwdIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type replace(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, const _Ty& _Old, const _Ty& _New)
 {
+	_EXP_TELEMETRY_ALGORITHM("replace");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	details::_Replace_impl(_Policy, _First, _Last, _Old, _New);
@@ -138,6 +140,7 @@ inline typename details::_enable_if_policy<_ExPolicy, void>::type replace(_ExPol
 template <class _ExPolicy, class _InIt, class _OutIt, class _Pr, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type replace_copy_if(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred, const _Ty& _New)
 {
+	_EXP_TELEMETRY_ALGORITHM("replace_copy_if");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -148,6 +151,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type replace_copy
 template <class _ExPolicy, class _InIt, class _OutIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type replace_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, const _Ty& _Old, const _Ty& _New)
 {
+	_EXP_TELEMETRY_ALGORITHM("replace_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
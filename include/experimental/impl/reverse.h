@@ -4,9 +4,124 @@
 #define _IMPL_REVERSE_H_ 1
 
 #include "algorithm_impl.h"
+#include "bulk_memory.h"
+
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
 
 _PSTL_NS1_BEGIN
 namespace details {
+
+	// Elements of the sizes a vector register reverses with shuffles
+	template<typename _Ty>
+	struct _Is_vector_reverse : std::integral_constant<bool, _EXP_SSE2 != 0 && (sizeof(_Ty) == 1 || sizeof(_Ty) == 2 || sizeof(_Ty) == 4 || sizeof(_Ty) == 8)>
+	{
+	};
+
+	// Swaps _Left[_I] with the element _I before _Right_end for the _Count first ones
+	template<typename _Ty>
+	inline void _Reverse_swap_block(_Ty * _EXP_RESTRICT _Left, _Ty * _EXP_RESTRICT _Right_end, size_t _Count, std::false_type)
+	{
+		for (size_t _I = 0; _I < _Count; ++_I)
+		{
+			const _Ty _Tmp = _Left[_I];
+			_Left[_I] = *(_Right_end - (_I + 1));
+			*(_Right_end - (_I + 1)) = _Tmp;
+		}
+	}
+
+	// Writes the _Count elements before _Src_end to _Dest in reverse order
+	template<typename _Ty>
+	inline void _Reverse_copy_block(const _Ty * _EXP_RESTRICT _Src_end, size_t _Count, _Ty * _EXP_RESTRICT _Dest, std::false_type)
+	{
+		for (size_t _I = 0; _I < _Count; ++_I)
+			_Dest[_I] = *(_Src_end - (_I + 1));
+	}
+
+#if _EXP_SSE2
+	inline __m128i _Vec_reverse(__m128i _Val, std::integral_constant<size_t, 8>)
+	{
+		return _mm_shuffle_epi32(_Val, _MM_SHUFFLE(1, 0, 3, 2));
+	}
+
+	inline __m128i _Vec_reverse(__m128i _Val, std::integral_constant<size_t, 4>)
+	{
+		return _mm_shuffle_epi32(_Val, _MM_SHUFFLE(0, 1, 2, 3));
+	}
+
+	// swaps the halves, then reverses the words of each
+	inline __m128i _Vec_reverse(__m128i _Val, std::integral_constant<size_t, 2>)
+	{
+		const __m128i _Halves = _mm_shuffle_epi32(_Val, _MM_SHUFFLE(1, 0, 3, 2));
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(_Halves, _MM_SHUFFLE(0, 1, 2, 3)), _MM_SHUFFLE(0, 1, 2, 3));
+	}
+
+	// SSE2 has no byte shuffle: reverses the words, then the bytes of each
+	inline __m128i _Vec_reverse(__m128i _Val, std::integral_constant<size_t, 1>)
+	{
+		const __m128i _Words = _Vec_reverse(_Val, std::integral_constant<size_t, 2>());
+		return _mm_or_si128(_mm_slli_epi16(_Words, 8), _mm_srli_epi16(_Words, 8));
+	}
+
+	// A vector from each end is loaded, reversed in its register and stored at the other end
+	template<typename _Ty>
+	inline void _Reverse_swap_block(_Ty *_Left, _Ty *_Right_end, size_t _Count, std::true_type)
+	{
+		const size_t _Per_vector = 16 / sizeof(_Ty);
+		const std::integral_constant<size_t, sizeof(_Ty)> _Lane;
+
+		size_t _I = 0;
+		for (; _I + _Per_vector <= _Count; _I += _Per_vector)
+		{
+			__m128i * const _Low = reinterpret_cast<__m128i *>(_Left + _I);
+			__m128i * const _High = reinterpret_cast<__m128i *>(_Right_end - (_I + _Per_vector));
+			const __m128i _From_low = _mm_loadu_si128(_Low);
+			const __m128i _From_high = _mm_loadu_si128(_High);
+			_mm_storeu_si128(_Low, _Vec_reverse(_From_high, _Lane));
+			_mm_storeu_si128(_High, _Vec_reverse(_From_low, _Lane));
+		}
+
+		_Reverse_swap_block(_Left + _I, _Right_end - _I, _Count - _I, std::false_type());
+	}
+
+	template<typename _Ty>
+	inline void _Reverse_copy_block(const _Ty *_Src_end, size_t _Count, _Ty *_Dest, std::true_type)
+	{
+		const size_t _Per_vector = 16 / sizeof(_Ty);
+		const std::integral_constant<size_t, sizeof(_Ty)> _Lane;
+
+		size_t _I = 0;
+		for (; _I + _Per_vector <= _Count; _I += _Per_vector)
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(_Dest + _I),
+				_Vec_reverse(_mm_loadu_si128(reinterpret_cast<const __m128i *>(_Src_end - (_I + _Per_vector))), _Lane));
+
+		_Reverse_copy_block(_Src_end - _I, _Count - _I, _Dest + _I, std::false_type());
+	}
+#endif
+
+	// The front half is split in page aligned chunks, a chunk swaps with the block that mirrors it at the
+	// back. Both blocks stream through the cache once.
+	template<typename _ExPolicy, typename _Ty>
+	void _Block_reverse(const _ExPolicy& _Policy, _Ty *_First, size_t _Count)
+	{
+		_Ty * const _Last = _First + _Count;
+
+		_Bulk_for_each_chunk(_Policy, _First, _Count / 2, [_First, _Last](size_t _Offset, size_t _Chunk_count, bool) {
+			_Reverse_swap_block(_First + _Offset, _Last - _Offset, _Chunk_count, _Is_vector_reverse<_Ty>());
+		});
+	}
+
+	template<typename _ExPolicy, typename _Ty>
+	void _Block_reverse_copy(const _ExPolicy& _Policy, const _Ty *_First, size_t _Count, _Ty *_Dest)
+	{
+		const _Ty * const _Last = _First + _Count;
+
+		_Bulk_for_each_chunk(_Policy, _Dest, _Count, [_Last, _Dest](size_t _Offset, size_t _Chunk_count, bool) {
+			_Reverse_copy_block(_Last - _Offset, _Chunk_count, _Dest + _Offset, _Is_vector_reverse<_Ty>());
+		});
+	}
+
 	//
 	// reverse_copy
 	//
@@ -19,7 +134,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _BidIt, class _OutIt, class _IterCat>
-	_OutIt _Reverse_copy_impl(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, _OutIt _Dest, _IterCat _Cat)
+	_OutIt _Reverse_copy_helper(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, _OutIt _Dest, _IterCat _Cat, std::false_type)
 	{
 		auto _Count = std::distance(_First, _Last);
 		auto _Rev_first = std::reverse_iterator<_BidIt>(_Last);
@@ -30,6 +145,24 @@ namespace details {
 		}, _Cat));
 	}
 
+	// Trivially copyable contiguous ranges are reversed a vector at a time into page aligned chunks of the destination
+	template <class _ExPolicy, class _BidIt, class _OutIt, class _IterCat>
+	_OutIt _Reverse_copy_helper(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, _OutIt _Dest, _IterCat, std::true_type)
+	{
+		const auto _Count = _Last - _First;
+		if (_Count <= 0)
+			return _Dest;
+
+		_Block_reverse_copy(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Count), _Unwrap_contiguous(_Dest));
+		return _Dest + _Count;
+	}
+
+	template <class _ExPolicy, class _BidIt, class _OutIt, class _IterCat>
+	_OutIt _Reverse_copy_impl(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, _OutIt _Dest, _IterCat _Cat)
+	{
+		return _Reverse_copy_helper(_Policy, _First, _Last, _Dest, _Cat, _Is_memcpy_range<_BidIt, _OutIt>());
+	}
+
 	template <class _ExPolicy, class _BidIt, class _OutIt>
 	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Reverse_copy_impl(const _ExPolicy&, _BidIt _First, _BidIt _Last, _OutIt _Dest, std::input_iterator_tag _Cat)
 	{
@@ -54,7 +187,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _BidIt>
-	void _Reverse_impl(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last)
+	void _Reverse_helper(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, std::false_type)
 	{
 		auto _Count = std::distance(_First, _Last);
 		auto _Rev_last = std::reverse_iterator<_BidIt>(_Last);
@@ -65,16 +198,30 @@ namespace details {
 		}, std::_Iter_cat(_First)));
 	}
 
-	template <class _BidIt, class _IterTag>
+	template <class _ExPolicy, class _BidIt>
+	void _Reverse_helper(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last, std::true_type)
+	{
+		if (_Last - _First > 1)
+			_Block_reverse(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Last - _First));
+	}
+
+	template <class _ExPolicy, class _BidIt>
+	void _Reverse_impl(const _ExPolicy& _Policy, _BidIt _First, _BidIt _Last)
+	{
+		_Reverse_helper(_Policy, _First, _Last, _Is_memcpy_range<_BidIt, _BidIt>());
+	}
+
+	template <class _BidIt>
 	void _Reverse_impl(const execution_policy& _Policy, _BidIt _First, _BidIt _Last)
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Lexicographical_compare_impl, _Policy, _First, _Last, _Cat);
+		_EXP_GENERIC_EXECUTION_POLICY(_Reverse_impl, _Policy, _First, _Last);
 	}
 } // details
 
 template <class _ExPolicy, class _BidIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type reverse_copy(_ExPolicy&& _Policy, _BidIt _First, _BidIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("reverse_copy");
 	static_assert(std::is_base_of<std::bidirectional_iterator_tag, typename std::iterator_traits<_BidIt>::iterator_category>::value, "Required bidirectional iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -84,6 +231,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type reverse_copy
 template <class _ExPolicy, class _BidIt>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type reverse(_ExPolicy&& _Policy, _BidIt _First, _BidIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("reverse");
 	static_assert(std::is_base_of<std::bidirectional_iterator_tag, typename std::iterator_traits<_BidIt>::iterator_category>::value, "Required bidirectional iterator or stronger.");
 
 	details::_Reverse_impl(_Policy, _First, _Last);
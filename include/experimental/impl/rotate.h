@@ -9,8 +9,12 @@
 
 _PSTL_NS1_BEGIN
 namespace details {
+
+	// Largest short side of a small rotate that is set aside on the stack
+	const size_t _Rotate_buffer_bytes = 1024;
+
 	//
-	// rotate_copy
+	// rotate
 	//
 	template <class _FwdIt, class _IterCat>
 	_FwdIt _Rotate_impl(const sequential_execution_policy&, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, _IterCat)
@@ -20,9 +24,12 @@ namespace details {
 		_EXP_RETHROW
 	}
 
-	template <class _ExPolicy, class _FwdIt, class _IterCat>
-	_FwdIt _Rotate_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, _IterCat)
+	template <class _ExPolicy, class _FwdIt>
+	_FwdIt _Rotate_helper(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, std::false_type)
 	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		if (_First != _Mid && _Mid != _Last) {
 			auto _Handle = make_task([&_Policy, &_First, &_Mid] {
 				_Reverse_impl(_Policy, _First, _Mid);
@@ -41,6 +48,52 @@ namespace details {
 		return _First;
 	}
 
+	// Contiguous ranges of trivially copyable types. When the range is too small to be split and its
+	// short side fits the stack buffer, that side is set aside and one memmove shifts the long side.
+	// Other ranges take three blocked reverses, each streams through its part once on all the threads.
+	template <class _ExPolicy, class _RanIt>
+	_RanIt _Rotate_helper(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Ty;
+
+		const size_t _Left = static_cast<size_t>(_Mid - _First);
+		const size_t _Right = static_cast<size_t>(_Last - _Mid);
+		const _RanIt _Result = _First + _Right;
+
+		if (_Left == 0 || _Right == 0)
+			return _Result;
+
+		_Ty * const _Begin = _Unwrap_contiguous(_First);
+
+		if ((_Left + _Right) * sizeof(_Ty) < _Bulk_parallel_bytes && (std::min)(_Left, _Right) * sizeof(_Ty) <= _Rotate_buffer_bytes) {
+			unsigned char _Buffer[_Rotate_buffer_bytes];
+
+			if (_Left <= _Right) {
+				std::memcpy(_Buffer, _Begin, _Left * sizeof(_Ty));
+				std::memmove(_Begin, _Begin + _Left, _Right * sizeof(_Ty));
+				std::memcpy(_Begin + _Right, _Buffer, _Left * sizeof(_Ty));
+			}
+			else {
+				std::memcpy(_Buffer, _Begin + _Left, _Right * sizeof(_Ty));
+				std::memmove(_Begin + _Right, _Begin, _Left * sizeof(_Ty));
+				std::memcpy(_Begin, _Buffer, _Right * sizeof(_Ty));
+			}
+
+			return _Result;
+		}
+
+		_Block_reverse(_Policy, _Begin, _Left);
+		_Block_reverse(_Policy, _Begin + _Left, _Right);
+		_Block_reverse(_Policy, _Begin, _Left + _Right);
+		return _Result;
+	}
+
+	template <class _ExPolicy, class _FwdIt, class _IterCat>
+	_FwdIt _Rotate_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, _IterCat)
+	{
+		return _Rotate_helper(_Policy, _First, _Mid, _Last, _Is_memcpy_range<_FwdIt, _FwdIt>());
+	}
+
 	template <class _ExPolicy, class _FwdIt>
 	inline typename _enable_if_parallel<_ExPolicy, _FwdIt>::type _Rotate_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, std::forward_iterator_tag _Cat)
 	{
@@ -87,6 +140,7 @@ namespace details {
 template<class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type rotate(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("rotate");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Rotate_impl(_Policy, _First, _Mid, _Last, std::_Iter_cat(_First));
@@ -95,6 +149,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type rotate(_ExPo
 template <class _ExPolicy, class _FwdIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type rotate_copy(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Mid, _FwdIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("rotate_copy");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -8,7 +8,17 @@
 _PSTL_NS1_BEGIN
 namespace details {
 
-	template<typename _OutIt, typename _InitType, typename _BinOp>
+	// The transform of the plain scans, passes the elements through as they are
+	struct _Identity_transform
+	{
+		template<typename _Ty>
+		_Ty&& operator()(_Ty&& _Val) const
+		{
+			return std::forward<_Ty>(_Val);
+		}
+	};
+
+	template<typename _OutIt, typename _InitType, typename _BinOp, typename _UnOp = _Identity_transform>
 	class _Output_scan_token
 	{
 		typedef typename std::iterator_traits<_OutIt>::difference_type _DiffType;
@@ -18,8 +28,9 @@ namespace details {
 		_InitType _Local_sum;
 		_InitType _Partial_sum;
 		_BinOp _BinOperation;
+		_UnOp _Transform;
 	public:
-		_Output_scan_token(_OutIt _It, _InitType _Sum, _BinOp _Op) : _Begin(_It), _Iter_pos(0), _Partial_sum(_Sum), _BinOperation(_Op)
+		_Output_scan_token(_OutIt _It, _InitType _Sum, _BinOp _Op, _UnOp _Tr = _UnOp()) : _Begin(_It), _Iter_pos(0), _Partial_sum(_Sum), _BinOperation(_Op), _Transform(_Tr)
 		{
 		}
 
@@ -45,6 +56,11 @@ namespace details {
 			return _BinOperation;
 		}
 
+		_UnOp get_transform() const
+		{
+			return _Transform;
+		}
+
 		_OutIt get_result() const
 		{
 			_OutIt _Out = _Begin;
@@ -56,11 +72,12 @@ namespace details {
 		void filter(_InIt _Begin, size_t _Partition_count)
 		{
 			auto _Opration = get_operation();
-			_InitType _Val = *_Begin;
+			auto _Tr = get_transform();
+			_InitType _Val = _Tr(*_Begin);
 
 			LoopHelper<_ExPolicy, _InIt>::Loop(++_Begin, _Partition_count - 1,
-				[&_Opration, &_Val](std::iterator_traits<_InIt>::reference _It) {
-				_Val = _Opration(_Val, _It);
+				[&_Opration, &_Tr, &_Val](std::iterator_traits<_InIt>::reference _It) {
+				_Val = _Opration(_Val, _Tr(_It));
 			});
 
 			set(_Partition_count, _Val);
@@ -81,92 +98,323 @@ namespace details {
 		}
 	};
 
+	// Bytes of input a scan tile covers when the policy sets no grain, the tile is read a second
+	// time to write its outputs while it is still in the second level cache
+	const size_t _Scan_tile_bytes = 64 * 1024;
+
+	// Single pass scan of a random access range with decoupled look-back. The threads claim the
+	// tiles in order. A tile sums its elements and publishes the aggregate, then walks back over
+	// its predecessors adding their aggregates until it meets one that published its inclusive
+	// prefix. It publishes its own prefix and writes its outputs from the elements still in the
+	// cache, so the range is read from memory once. A tile whose predecessor is complete when it
+	// starts scans right away. The transform scans apply _UnOp to the elements in both passes
+	// over a tile, so the transformed sequence is never stored.
+	template<typename _ExPolicy, typename _InIt, typename _OutIt, typename _Ty, typename _BinOp, typename _UnOp, bool _Exclusive>
+	class _Lookback_scan
+	{
+		enum _Tile_flag { _Blank, _Aggregate_ready, _Prefix_ready };
+
+		struct _Tile_status
+		{
+			std::atomic<int> _Flag;
+			_Ty _Aggregate; // of the tile, written before _Aggregate_ready
+			_Ty _Inclusive; // of the tiles up to this one, written before _Prefix_ready
+
+			_Tile_status() : _Flag(_Blank) {}
+		};
+
+		_InIt _First;
+		_OutIt _Dest;
+		const size_t _Count;
+		const size_t _Tile_size;
+		const size_t _Tile_count;
+		const _Ty _Init;
+		const _BinOp _Op;
+		const _UnOp _Tr;
+		std::unique_ptr<_Tile_status[]> _Status;
+		std::atomic<size_t> _Next_tile;
+		std::atomic<bool> _Cancelled; // a tile threw, the ones after it would wait forever
+		std::mutex _Lock;
+		std::list<std::exception_ptr> _Exceptions; // lock protected
+
+		_Lookback_scan(const _Lookback_scan&);
+		_Lookback_scan& operator=(const _Lookback_scan&);
+
+		_Ty _Reduce(_InIt _Begin, size_t _Size, _BinOp& _Operation, _UnOp& _Transform) const
+		{
+			_Ty _Val = _Transform(*_Begin);
+			LoopHelper<_ExPolicy, _InIt>::Loop(++_Begin, _Size - 1,
+				[&_Operation, &_Transform, &_Val](typename std::iterator_traits<_InIt>::reference _It) {
+				_Val = _Operation(_Val, _Transform(_It));
+			});
+			return _Val;
+		}
+
+		_Ty _Scan(_InIt _Begin, size_t _Size, _OutIt _Out, _Ty _Val, _BinOp& _Operation, _UnOp& _Transform, std::true_type) const
+		{
+			LoopHelper<_ExPolicy, _InIt>::Loop(_Begin, _Size,
+				[&_Out, &_Val, &_Operation, &_Transform](typename std::iterator_traits<_InIt>::reference _It) {
+				*_Out = _Val;
+				++_Out;
+
+				_Val = _Operation(_Val, _Transform(_It));
+			});
+			return _Val;
+		}
+
+		_Ty _Scan(_InIt _Begin, size_t _Size, _OutIt _Out, _Ty _Val, _BinOp& _Operation, _UnOp& _Transform, std::false_type) const
+		{
+			LoopHelper<_ExPolicy, _InIt>::Loop(_Begin, _Size,
+				[&_Out, &_Val, &_Operation, &_Transform](typename std::iterator_traits<_InIt>::reference _It) {
+				_Val = _Operation(_Val, _Transform(_It));
+
+				*_Out = _Val;
+				++_Out;
+			});
+			return _Val;
+		}
+
+		// Waits until the tile published something, returns _Blank if the scan was cancelled
+		int _Wait_for(size_t _Tile) const
+		{
+			int _Flag;
+			while ((_Flag = _Status[_Tile]._Flag.load(std::memory_order_acquire)) == _Blank)
+			{
+				if (_Cancelled.load(std::memory_order_relaxed))
+					return _Blank;
+				std::this_thread::yield();
+			}
+			return _Flag;
+		}
+
+		const _Ty& _Published(size_t _Tile, int _Flag) const
+		{
+			return _Flag == _Prefix_ready ? _Status[_Tile]._Inclusive : _Status[_Tile]._Aggregate;
+		}
+
+		// Combines the aggregates of the tiles before _Tile, right to left, up to the nearest
+		// inclusive prefix. The first tile always publishes its prefix, so the walk stops there.
+		bool _Look_back(size_t _Tile, _Ty& _Carry, _BinOp& _Operation) const
+		{
+			size_t _Pred = _Tile - 1;
+			int _Flag = _Wait_for(_Pred);
+			if (_Flag == _Blank)
+				return false;
+
+			_Ty _Acc = _Published(_Pred, _Flag);
+			while (_Flag != _Prefix_ready)
+			{
+				_Flag = _Wait_for(--_Pred);
+				if (_Flag == _Blank)
+					return false;
+				_Acc = _Operation(_Published(_Pred, _Flag), _Acc);
+			}
+
+			_Carry = _Acc;
+			return true;
+		}
+
+		bool _Process(size_t _Tile, _BinOp& _Operation, _UnOp& _Transform)
+		{
+			const size_t _Offset = _Tile * _Tile_size;
+			const size_t _Size = (std::min)(_Tile_size, _Count - _Offset);
+			const _InIt _Begin = _First + _Offset;
+			const _OutIt _Out = _Dest + _Offset;
+			const std::integral_constant<bool, _Exclusive> _Kind = {};
+			_Tile_status& _Own = _Status[_Tile];
+
+			if (_Tile == 0 || _Status[_Tile - 1]._Flag.load(std::memory_order_acquire) == _Prefix_ready)
+			{
+				_Ty _Carry = _Tile == 0 ? _Init : _Status[_Tile - 1]._Inclusive;
+				_Own._Inclusive = _Scan(_Begin, _Size, _Out, std::move(_Carry), _Operation, _Transform, _Kind);
+				_Own._Flag.store(_Prefix_ready, std::memory_order_release);
+				return true;
+			}
+
+			_Own._Aggregate = _Reduce(_Begin, _Size, _Operation, _Transform);
+			_Own._Flag.store(_Aggregate_ready, std::memory_order_release);
+
+			_Ty _Carry = _Init;
+			if (!_Look_back(_Tile, _Carry, _Operation))
+				return false;
+
+			// the successors don't have to wait for the outputs
+			_Own._Inclusive = _Operation(_Carry, _Own._Aggregate);
+			_Own._Flag.store(_Prefix_ready, std::memory_order_release);
+
+			_Scan(_Begin, _Size, _Out, std::move(_Carry), _Operation, _Transform, _Kind);
+			return true;
+		}
+
+	public:
+		_Lookback_scan(_InIt _Fst, _OutIt _Out, size_t _Cnt, size_t _Tile_sz, const _Ty& _Initial, const _BinOp& _Operation, const _UnOp& _Transform) :
+			_First(_Fst), _Dest(_Out), _Count(_Cnt), _Tile_size(_Tile_sz), _Tile_count((_Cnt + _Tile_sz - 1) / _Tile_sz),
+			_Init(_Initial), _Op(_Operation), _Tr(_Transform), _Status(new _Tile_status[_Tile_count]), _Next_tile(0), _Cancelled(false)
+		{
+		}
+
+		size_t _Tiles() const
+		{
+			return _Tile_count;
+		}
+
+		// Run by every thread of the scan, claims tiles until there are none left
+		void _Run()
+		{
+			try {
+				_BinOp _Operation(_Op);
+				_UnOp _Transform(_Tr);
+				while (!_Cancelled.load(std::memory_order_relaxed))
+				{
+					const size_t _Tile = _Next_tile.fetch_add(1, std::memory_order_relaxed);
+					if (_Tile >= _Tile_count || !_Process(_Tile, _Operation, _Transform))
+						return;
+				}
+			}
+			catch (...) {
+				_Cancelled.store(true, std::memory_order_relaxed);
+				std::lock_guard<std::mutex> _Guard(_Lock);
+				_Exceptions.push_back(std::current_exception());
+			}
+		}
+
+		void _Rethrow()
+		{
+			if (!_Exceptions.empty())
+				throw exception_list(std::move(_Exceptions));
+		}
+	};
+
+	template<bool _Exclusive, class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+	inline _OutIt _Lookback_scan_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, const _Ty& _Init, const _BinOp& _Op, const _UnOp& _Transform)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		typedef typename std::iterator_traits<_InIt>::value_type _Value_type;
+		typedef _Lookback_scan<_ExPolicy, _InIt, _OutIt, _Ty, _BinOp, _UnOp, _Exclusive> _Scan_type;
+
+		const size_t _Count = static_cast<size_t>(_Last - _First);
+		if (_Count == 0)
+			return _Dest;
+
+		const size_t _Tile_size = _Grain_size(_Policy, (std::max)(_Scan_tile_bytes / sizeof(_Value_type), static_cast<size_t>(1)));
+		_Scan_type _Scan(_First, _Dest, _Count, _Tile_size, _Init, _Op, _Transform);
+
+		const size_t _Threads = (std::min)(static_cast<size_t>(_Policy_thread_count(_Policy)), _Scan._Tiles());
+		auto _Worker = [&_Scan] { _Scan._Run(); };
+
+		_Chore_vector<UserWorkChore<decltype(_Worker)>> _Tasks;
+		_Tasks.reserve(_Threads - 1);
+		TaskGroup _Tg;
+		for (size_t _I = 1; _I < _Threads; ++_I)
+		{
+			_Tasks.emplace_back(_Worker);
+			_Tg.run(_Tasks.back());
+		}
+
+		_Scan._Run();
+		_Tg.wait();
+		_Scan._Rethrow();
+
+		return _Dest + _Count;
+	}
+
 	//
 	// exclusive_scan
 	//
-	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Exclusive_scan_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat)
+	// The plain scans run with _Identity_transform, transform_exclusive_scan with the user's
+	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat)
 	{
 		_EXP_TRY
-			return exclusive_scan(_First, _Last, _Dest, _Init, _Op);
+			return transform_exclusive_scan(_First, _Last, _Dest, _Init, _Op, _Transform);
 		_EXP_RETHROW
 	}
 
-	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Exclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat)
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
-		typedef _Output_scan_token<_OutIt, _Ty, _BinOp> _Output_token;
+		typedef _Output_scan_token<_OutIt, _Ty, _BinOp, _UnOp> _Output_token;
 
 		if (_First == _Last)
 			return _Dest;
 
-		return _Partitioner<copy_partitioner_tag>::_For_Each(_First, std::distance(_First, _Last), _Output_token(_Dest, _Init, _Op),
+		return _Partitioner<copy_partitioner_tag>::_For_Each(_First, std::distance(_First, _Last), _Output_token(_Dest, _Init, _Op, _Transform),
 			[](_InIt _Begin, size_t _Partition_count, _Output_token& _Output){
 			_Output.filter<_ExPolicy>(_Begin, _Partition_count);
 		},
 			[](_InIt _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage						
 			auto _Opration = _Dest.get_operation();
+			auto _Tr = _Dest.get_transform();
 			auto _Out = _Dest.get();
 			_Ty _Val = _Dest.get_sum();
 
 			LoopHelper<_ExPolicy, _InIt>::Loop(_Begin, _Partition_count,
-				[&_Out, &_Val, &_Opration](std::iterator_traits<_InIt>::reference _It) {
+				[&_Out, &_Val, &_Opration, &_Tr](std::iterator_traits<_InIt>::reference _It) {
 				*_Out = _Val;
 				++_Out;
 
-				_Val = _Opration(_Val, _It);
+				_Val = _Opration(_Val, _Tr(_It));
 			});
 		}).get_result();
 	}
 
-	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp>
-	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Exclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, std::input_iterator_tag _Cat)
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Exclusive_scan_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, std::random_access_iterator_tag)
+	{
+		return _Lookback_scan_impl<true>(_Policy, _First, _Last, _Dest, _Init, _Op, _Transform);
+	}
+
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Exclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, std::input_iterator_tag _Cat)
 	{
-		return _Exclusive_scan_impl(seq, _First, _Last, _Dest, _Init, _Op, _Cat);
+		return _Exclusive_scan_impl(seq, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
 	}
 
-	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Exclusive_scan_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat _Cat)
+	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat _Cat)
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Exclusive_scan_impl, _Policy, _First, _Last, _Dest, _Init, _Op, _Cat);
+		_EXP_GENERIC_EXECUTION_POLICY(_Exclusive_scan_impl, _Policy, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
 	}
 
 	//
 	// inclusive_scan
 	//
-	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Inclusive_scan_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat)
+	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat)
 	{
 		_EXP_TRY
-			return inclusive_scan(_First, _Last, _Dest, _Op, _Init);
+			return transform_inclusive_scan(_First, _Last, _Dest, _Op, _Transform, _Init);
 		_EXP_RETHROW
 	}
 
-	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Inclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat)
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef composable_iterator<_InIt, std::vector<difference_type>::iterator > _Iter_type;
-		typedef _Output_scan_token<_OutIt, _Ty, _BinOp> _Output_token;
+		typedef _Output_scan_token<_OutIt, _Ty, _BinOp, _UnOp> _Output_token;
 
 		if (_First == _Last)
 			return _Dest;
 
-		return _Partitioner<copy_partitioner_tag>::_For_Each(_First, std::distance(_First, _Last), _Output_token(_Dest, _Init, _Op),
+		return _Partitioner<copy_partitioner_tag>::_For_Each(_First, std::distance(_First, _Last), _Output_token(_Dest, _Init, _Op, _Transform),
 			[](_InIt _Begin, size_t _Partition_count, _Output_token& _Output) { // Filtering stage						
 			_Output.filter<_ExPolicy>(_Begin, _Partition_count);
 		},
 			[](_InIt _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage						
 			auto _Opration = _Dest.get_operation();
+			auto _Tr = _Dest.get_transform();
 			auto _Out = _Dest.get();
 			_Ty _Val = _Dest.get_sum();
 
 			LoopHelper<_ExPolicy, _InIt>::Loop(_Begin, _Partition_count,
-				[&_Out, &_Val, &_Opration](std::iterator_traits<_InIt>::reference _It){
-				_Val = _Opration(_Val, _It);
+				[&_Out, &_Val, &_Opration, &_Tr](std::iterator_traits<_InIt>::reference _It){
+				_Val = _Opration(_Val, _Tr(_It));
 
 				*_Out = _Val;
 				++_Out;
@@ -174,56 +422,116 @@ namespace details {
 		}).get_result();
 	}
 
-	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp>
-	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Inclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, std::input_iterator_tag _Cat)
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Inclusive_scan_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, std::random_access_iterator_tag)
 	{
-		return _Inclusive_scan_impl(seq, _First, _Last, _Dest, _Init, _Op, _Cat);
+		return _Lookback_scan_impl<false>(_Policy, _First, _Last, _Dest, _Init, _Op, _Transform);
 	}
 
-	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _IterCat>
-	inline _OutIt _Inclusive_scan_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _IterCat _Cat)
+	template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Inclusive_scan_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, std::input_iterator_tag _Cat)
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Inclusive_scan_impl, _Policy, _First, _Last, _Dest, _Init, _Op, _Cat);
+		return _Inclusive_scan_impl(seq, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
+	}
+
+	template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Inclusive_scan_impl, _Policy, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
+	}
+
+	// Without an initial value the first output is the transformed first element, the rest is
+	// scanned from it
+	template<class _ExPolicy, class _InIt, class _OutIt, class _BinOp, class _UnOp>
+	inline _OutIt _Transform_inclusive_scan_first(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _UnOp _Transform)
+	{
+		typedef typename std::decay<decltype(_Transform(*_First))>::type _Ty;
+
+		if (_First == _Last)
+			return _Dest;
+
+		_Ty _Init = _Transform(*_First);
+		*_Dest = _Init;
+
+		details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
+		return _Inclusive_scan_impl(_Policy, ++_First, _Last, ++_Dest, _Init, _Op, _Transform, _Cat);
 	}
 } // details
 
 template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type exclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op)
 {
+	_EXP_TELEMETRY_ALGORITHM("exclusive_scan");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
 	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
-	return details::_Exclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, _Cat);
+	return details::_Exclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, details::_Identity_transform(), _Cat);
 }
 
 template<class _ExPolicy, class _InIt, class _OutIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type exclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init)
 {
+	_EXP_TELEMETRY_ALGORITHM("exclusive_scan");
 	return exclusive_scan(_Policy, _First, _Last, _Dest, _Init, std::plus<>());
 }
 
 template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _Ty _Init)
 {
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
 	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
-	return details::_Inclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, _Cat);
+	return details::_Inclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, details::_Identity_transform(), _Cat);
 }
 
 template<class _ExPolicy, class _InIt, class _OutIt, class _BinOp>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op)
 {
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan");
 	return inclusive_scan(_Policy, _First, _Last, _Dest, _Op, std::iterator_traits<_InIt>::value_type{});
 }
 
 template<class _ExPolicy, class _InIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan");
 	return inclusive_scan(_Policy, _First, _Last, _Dest, std::plus<>(), std::iterator_traits<_InIt>::value_type{});
 }
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform_exclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_exclusive_scan");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
+	return details::_Exclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _BinOp, class _UnOp, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform_inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _UnOp _Transform, _Ty _Init)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_inclusive_scan");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
+	return details::_Inclusive_scan_impl(_Policy, _First, _Last, _Dest, _Init, _Op, _Transform, _Cat);
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _BinOp, class _UnOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform_inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _UnOp _Transform)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_inclusive_scan");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	return details::_Transform_inclusive_scan_first(_Policy, _First, _Last, _Dest, _Op, _Transform);
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_SCAN_H_
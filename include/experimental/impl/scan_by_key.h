@@ -0,0 +1,512 @@
+#pragma once
+
+#ifndef _IMPL_SCAN_BY_KEY_H_
+#define _IMPL_SCAN_BY_KEY_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// A segment is a run of consecutive equal keys. The filter stage of a chunk finds whether a
+	// segment starts in it and sums the values of its last segment. The carry into the next chunk
+	// is that sum if a segment started, otherwise the incoming carry combined with it. A chunk
+	// covers the elements after its begin, the one at its begin is the key it compares against.
+	template<typename _OutIt, typename _Ty, typename _BinOp>
+	class _Segmented_scan_token
+	{
+		typedef typename std::iterator_traits<_OutIt>::difference_type _DiffType;
+
+		_OutIt _Begin;
+		_DiffType _Iter_pos;
+		_Ty _Carry; // of the segment open before the chunk
+		_Ty _Local_sum; // of the last segment of the chunk
+		bool _Local_head;
+		_BinOp _BinOperation;
+	public:
+		_Segmented_scan_token(_OutIt _It, _Ty _Sum, _BinOp _Op) : _Begin(_It), _Iter_pos(0), _Carry(_Sum), _Local_sum(_Sum), _Local_head(false), _BinOperation(_Op)
+		{
+		}
+
+		// Can be called only on one thread and set once
+		void set(_DiffType _Pos, bool _Head, _Ty _Sum)
+		{
+			_Iter_pos = _Pos;
+			_Local_head = _Head;
+			_Local_sum = std::move(_Sum);
+		}
+
+		_OutIt get() const
+		{
+			return _Begin;
+		}
+
+		_Ty get_carry() const
+		{
+			return _Carry;
+		}
+
+		_BinOp get_operation() const
+		{
+			return _BinOperation;
+		}
+
+		_OutIt get_result() const
+		{
+			_OutIt _Out = _Begin;
+			std::advance(_Out, _Iter_pos);
+			return _Out;
+		}
+
+		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
+	public:
+		void move(_Segmented_scan_token& _Token)
+		{
+			_Begin = _Token._Begin;
+			std::advance(_Begin, _Token._Iter_pos);
+			_Carry = _Token._Local_head ? _Token._Local_sum : _BinOperation(_Token._Carry, _Token._Local_sum);
+		}
+
+		bool empty() const
+		{
+			return false;
+		}
+	};
+
+	// reduce_by_key writes a key and a sum where a segment ends, the filter stage counts the
+	// segments that start in a chunk. The first key of the open segment travels with its sum.
+	template<typename _OutIt, typename _OutIt2, typename _KeyIt, typename _Ty, typename _BinOp>
+	class _Segmented_reduce_token
+	{
+		typedef typename std::iterator_traits<_OutIt>::difference_type _DiffType;
+
+		_OutIt _Keys_begin;
+		_OutIt2 _Values_begin;
+		_DiffType _Heads;
+		_KeyIt _Carry_key;
+		_Ty _Carry;
+		_KeyIt _Local_key;
+		_Ty _Local_sum;
+		_BinOp _BinOperation;
+	public:
+		_Segmented_reduce_token(_OutIt _Keys, _OutIt2 _Values, _KeyIt _Key, _Ty _Sum, _BinOp _Op) :
+			_Keys_begin(_Keys), _Values_begin(_Values), _Heads(0), _Carry_key(_Key), _Carry(_Sum), _Local_key(_Key), _Local_sum(_Sum), _BinOperation(_Op)
+		{
+		}
+
+		// Can be called only on one thread and set once
+		void set(_DiffType _Head_count, _KeyIt _Key, _Ty _Sum)
+		{
+			_Heads = _Head_count;
+			_Local_key = _Key;
+			_Local_sum = std::move(_Sum);
+		}
+
+		std::pair<_OutIt, _OutIt2> get() const
+		{
+			return std::pair<_OutIt, _OutIt2>(_Keys_begin, _Values_begin);
+		}
+
+		_KeyIt get_carry_key() const
+		{
+			return _Carry_key;
+		}
+
+		_Ty get_carry() const
+		{
+			return _Carry;
+		}
+
+		_BinOp get_operation() const
+		{
+			return _BinOperation;
+		}
+
+		// The segment still open after the chunk
+		_KeyIt get_final_key() const
+		{
+			return _Heads != 0 ? _Local_key : _Carry_key;
+		}
+
+		_Ty get_final_sum() const
+		{
+			return _Heads != 0 ? _Local_sum : _BinOperation(_Carry, _Local_sum);
+		}
+
+		std::pair<_OutIt, _OutIt2> get_result() const
+		{
+			_OutIt _Out = _Keys_begin;
+			std::advance(_Out, _Heads);
+
+			_OutIt2 _Out2 = _Values_begin;
+			std::advance(_Out2, _Heads);
+
+			return std::pair<_OutIt, _OutIt2>(_Out, _Out2);
+		}
+
+		template <typename _It, typename _OutIt, typename _First_stage, typename _Second_stage> friend class _Copy_chore;
+	public:
+		void move(_Segmented_reduce_token& _Token)
+		{
+			auto _Pos = _Token.get_result();
+			_Keys_begin = _Pos.first;
+			_Values_begin = _Pos.second;
+			_Carry_key = _Token.get_final_key();
+			_Carry = _Token.get_final_sum();
+		}
+
+		bool empty() const
+		{
+			return _Heads == 0;
+		}
+	};
+
+	// Sums the last segment of the _Count elements after _Begin. _Heads counts the segments that
+	// start among them, _Head_key is left at the first key of the last one if there are any.
+	template<typename _ExPolicy, typename _Ty, typename _Iter_type, typename _KeyIt, typename _Pr, typename _BinOp, typename _Seed>
+	inline _Ty _Segment_tail(_Iter_type _Begin, size_t _Count, _Pr& _Pred, _BinOp& _Op, const _Seed& _Start, size_t& _Heads, _KeyIt& _Head_key)
+	{
+		_KeyIt _Prev = std::get<0>(*_Begin);
+		++_Begin;
+
+		_Heads = 0;
+		const bool _First_head = !_Pred(*_Prev, *std::get<0>(*_Begin));
+		_Ty _Sum = _First_head ? _Start(*std::get<1>(*_Begin)) : _Ty(*std::get<1>(*_Begin));
+		if (_First_head) {
+			_Head_key = std::get<0>(*_Begin);
+			++_Heads;
+		}
+
+		_Prev = std::get<0>(*_Begin);
+		LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Count - 1,
+			[&_Pred, &_Op, &_Start, &_Prev, &_Sum, &_Heads, &_Head_key](const typename _Iter_type::value_type& _It) {
+			if (_Pred(*_Prev, *std::get<0>(_It)))
+				_Sum = _Op(_Sum, *std::get<1>(_It));
+			else {
+				_Sum = _Start(*std::get<1>(_It));
+				_Head_key = std::get<0>(_It);
+				++_Heads;
+			}
+			_Prev = std::get<0>(_It);
+		});
+
+		return _Sum;
+	}
+
+	// inclusive_scan_by_key starts a segment with its first value, exclusive_scan_by_key with
+	// the initial value combined with it
+	template<typename _Ty>
+	struct _Segment_seed
+	{
+		template<typename _Val>
+		_Ty operator()(_Val&& _Value) const
+		{
+			return std::forward<_Val>(_Value);
+		}
+	};
+
+	template<typename _Ty, typename _BinOp>
+	struct _Segment_seed_init
+	{
+		_Ty _Init;
+		_BinOp& _Op;
+
+		template<typename _Val>
+		_Ty operator()(_Val&& _Value) const
+		{
+			return _Op(_Init, std::forward<_Val>(_Value));
+		}
+	};
+
+	template<bool _Exclusive, class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp>
+	inline _OutIt _Segmented_scan_impl(const _ExPolicy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op)
+	{
+		typedef composable_iterator<_KeyIt, _ValIt, _OutIt> _Iter_type;
+		typedef _Segmented_scan_token<_OutIt, _Ty, _BinOp> _Output_token;
+
+		if (_First == _Last)
+			return _Dest;
+
+		const size_t _Size = static_cast<size_t>(std::distance(_First, _Last));
+
+		// The first element opens the first segment
+		_Ty _Carry = _Exclusive ? _Op(_Init, *_Values) : _Ty(*_Values);
+		*_Dest = _Exclusive ? _Init : _Carry;
+
+		_OutIt _Next = _Dest;
+		++_Next;
+		if (_Size == 1)
+			return _Next;
+
+		return _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Values, _Dest), _Size - 1, _Output_token(_Next, _Carry, _Op),
+			[_Pred, _Op, _Init](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
+			size_t _Heads;
+			_KeyIt _Head_key;
+			_Ty _Sum = _Exclusive
+				? _Segment_tail<_ExPolicy, _Ty>(_Begin, _Partition_count, _Pred, _Op, _Segment_seed_init<_Ty, _BinOp>{ _Init, _Op }, _Heads, _Head_key)
+				: _Segment_tail<_ExPolicy, _Ty>(_Begin, _Partition_count, _Pred, _Op, _Segment_seed<_Ty>(), _Heads, _Head_key);
+
+			_Output.set(_Partition_count, _Heads != 0, std::move(_Sum));
+		},
+			[_Pred, _Init](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Copy stage
+			auto _Operation = _Output.get_operation();
+			_Ty _Val = _Output.get_carry();
+			auto _Prev = std::get<0>(*_Begin);
+
+			// The element at the begin belongs to the previous chunk
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
+				[&_Pred, &_Operation, &_Init, &_Prev, &_Val](const typename _Iter_type::value_type& _It) {
+				const bool _Head = !_Pred(*_Prev, *std::get<0>(_It));
+				if (_Exclusive) {
+					if (_Head)
+						_Val = _Init;
+					*std::get<2>(_It) = _Val;
+					_Val = _Operation(_Val, *std::get<1>(_It));
+				}
+				else {
+					_Val = _Head ? _Ty(*std::get<1>(_It)) : _Operation(_Val, *std::get<1>(_It));
+					*std::get<2>(_It) = _Val;
+				}
+				_Prev = std::get<0>(_It);
+			});
+		}).get_result();
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp>
+	inline std::pair<_OutIt, _OutIt2> _Segmented_reduce_impl(const _ExPolicy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op)
+	{
+		typedef typename std::iterator_traits<_ValIt>::value_type _Ty;
+		typedef composable_iterator<_KeyIt, _ValIt> _Iter_type;
+		typedef _Segmented_reduce_token<_OutIt, _OutIt2, _KeyIt, _Ty, _BinOp> _Output_token;
+
+		if (_First == _Last)
+			return std::pair<_OutIt, _OutIt2>(_Keys_out, _Values_out);
+
+		const size_t _Size = static_cast<size_t>(std::distance(_First, _Last));
+		if (_Size == 1) {
+			*_Keys_out = *_First;
+			*_Values_out = *_Values;
+			return std::pair<_OutIt, _OutIt2>(++_Keys_out, ++_Values_out);
+		}
+
+		// The first element opens the first segment, the chunks cover the ones after it
+		const _Output_token _Last_token = _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Values), _Size - 1, _Output_token(_Keys_out, _Values_out, _First, *_Values, _Op),
+			[_Pred, _Op](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
+			size_t _Heads;
+			_KeyIt _Head_key = std::get<0>(*_Begin);
+			_Ty _Sum = _Segment_tail<_ExPolicy, _Ty>(_Begin, _Partition_count, _Pred, _Op, _Segment_seed<_Ty>(), _Heads, _Head_key);
+
+			_Output.set(_Heads, _Head_key, std::move(_Sum));
+		},
+			[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Copy stage
+			auto _Operation = _Output.get_operation();
+			auto _Out = _Output.get();
+			_KeyIt _Key = _Output.get_carry_key();
+			_Ty _Val = _Output.get_carry();
+			auto _Prev = std::get<0>(*_Begin);
+
+			// A segment that starts closes the one before it
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
+				[&_Pred, &_Operation, &_Out, &_Key, &_Prev, &_Val](const typename _Iter_type::value_type& _It) {
+				if (_Pred(*_Prev, *std::get<0>(_It)))
+					_Val = _Operation(_Val, *std::get<1>(_It));
+				else {
+					*_Out.first = *_Key;
+					++_Out.first;
+					*_Out.second = std::move(_Val);
+					++_Out.second;
+
+					_Key = std::get<0>(_It);
+					_Val = *std::get<1>(_It);
+				}
+				_Prev = std::get<0>(_It);
+			});
+		});
+
+		// The last segment is still open
+		auto _Out = _Last_token.get_result();
+		*_Out.first = *_Last_token.get_final_key();
+		++_Out.first;
+		*_Out.second = _Last_token.get_final_sum();
+		++_Out.second;
+		return _Out;
+	}
+
+	//
+	// inclusive_scan_by_key
+	//
+	template<class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_by_key_impl(const sequential_execution_policy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		_EXP_TRY
+			return inclusive_scan_by_key(_First, _Last, _Values, _Dest, _Pred, _Op);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_by_key_impl(const _ExPolicy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		typedef typename std::iterator_traits<_ValIt>::value_type _Ty;
+
+		if (_First == _Last)
+			return _Dest;
+
+		// There is no initial value, the first value stands in for it
+		return _Segmented_scan_impl<false>(_Policy, _First, _Last, _Values, _Dest, _Ty(*_Values), _Pred, _Op);
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Inclusive_scan_by_key_impl(const _ExPolicy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op, std::input_iterator_tag _Cat)
+	{
+		return _Inclusive_scan_by_key_impl(seq, _First, _Last, _Values, _Dest, _Pred, _Op, _Cat);
+	}
+
+	template<class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Inclusive_scan_by_key_impl(const execution_policy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Inclusive_scan_by_key_impl, _Policy, _First, _Last, _Values, _Dest, _Pred, _Op, _Cat);
+	}
+
+	//
+	// exclusive_scan_by_key
+	//
+	template<class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_by_key_impl(const sequential_execution_policy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		_EXP_TRY
+			return exclusive_scan_by_key(_First, _Last, _Values, _Dest, _Init, _Pred, _Op);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_by_key_impl(const _ExPolicy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		return _Segmented_scan_impl<true>(_Policy, _First, _Last, _Values, _Dest, _Init, _Pred, _Op);
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp>
+	inline typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Exclusive_scan_by_key_impl(const _ExPolicy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op, std::input_iterator_tag _Cat)
+	{
+		return _Exclusive_scan_by_key_impl(seq, _First, _Last, _Values, _Dest, _Init, _Pred, _Op, _Cat);
+	}
+
+	template<class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp, class _IterCat>
+	inline _OutIt _Exclusive_scan_by_key_impl(const execution_policy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Exclusive_scan_by_key_impl, _Policy, _First, _Last, _Values, _Dest, _Init, _Pred, _Op, _Cat);
+	}
+
+	//
+	// reduce_by_key
+	//
+	template<class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp, class _IterCat>
+	inline std::pair<_OutIt, _OutIt2> _Reduce_by_key_impl(const sequential_execution_policy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		_EXP_TRY
+			return reduce_by_key(_First, _Last, _Values, _Keys_out, _Values_out, _Pred, _Op);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp, class _IterCat>
+	inline std::pair<_OutIt, _OutIt2> _Reduce_by_key_impl(const _ExPolicy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op, _IterCat)
+	{
+		return _Segmented_reduce_impl(_Policy, _First, _Last, _Values, _Keys_out, _Values_out, _Pred, _Op);
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp>
+	inline typename _enable_if_parallel<_ExPolicy, std::pair<_OutIt, _OutIt2>>::type _Reduce_by_key_impl(const _ExPolicy&, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op, std::input_iterator_tag _Cat)
+	{
+		return _Reduce_by_key_impl(seq, _First, _Last, _Values, _Keys_out, _Values_out, _Pred, _Op, _Cat);
+	}
+
+	template<class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp, class _IterCat>
+	inline std::pair<_OutIt, _OutIt2> _Reduce_by_key_impl(const execution_policy& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Reduce_by_key_impl, _Policy, _First, _Last, _Values, _Keys_out, _Values_out, _Pred, _Op, _Cat);
+	}
+}  //details
+
+// The by key algorithms restart at every key that is not equal under _Pred to the one before it.
+// The parallel versions may regroup the values of a segment, _Op must be associative.
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan_by_key");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_KeyIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_ValIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::common_iterator<_KeyIt, _ValIt, _OutIt>::iterator_category _Cat;
+	return details::_Inclusive_scan_by_key_impl(_Policy, _First, _Last, _Values, _Dest, _Pred, _Op, _Cat);
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan_by_key");
+	return inclusive_scan_by_key(_Policy, _First, _Last, _Values, _Dest, _Pred, std::plus<>());
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type inclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("inclusive_scan_by_key");
+	return inclusive_scan_by_key(_Policy, _First, _Last, _Values, _Dest, std::equal_to<>(), std::plus<>());
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type exclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("exclusive_scan_by_key");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_KeyIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_ValIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::common_iterator<_KeyIt, _ValIt, _OutIt>::iterator_category _Cat;
+	return details::_Exclusive_scan_by_key_impl(_Policy, _First, _Last, _Values, _Dest, _Init, _Pred, _Op, _Cat);
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type exclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("exclusive_scan_by_key");
+	return exclusive_scan_by_key(_Policy, _First, _Last, _Values, _Dest, _Init, _Pred, std::plus<>());
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type exclusive_scan_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init)
+{
+	_EXP_TELEMETRY_ALGORITHM("exclusive_scan_by_key");
+	return exclusive_scan_by_key(_Policy, _First, _Last, _Values, _Dest, _Init, std::equal_to<>(), std::plus<>());
+}
+
+// Writes the first key and the sum of the values of every segment, returns the ends of both outputs
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _OutIt2>>::type reduce_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce_by_key");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_KeyIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_ValIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required forward iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_OutIt2>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::common_iterator<_KeyIt, _ValIt, _OutIt, _OutIt2>::iterator_category _Cat;
+	return details::_Reduce_by_key_impl(_Policy, _First, _Last, _Values, _Keys_out, _Values_out, _Pred, _Op, _Cat);
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _OutIt2>>::type reduce_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce_by_key");
+	return reduce_by_key(_Policy, _First, _Last, _Values, _Keys_out, _Values_out, _Pred, std::plus<>());
+}
+
+template<class _ExPolicy, class _KeyIt, class _ValIt, class _OutIt, class _OutIt2>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _OutIt2>>::type reduce_by_key(_ExPolicy&& _Policy, _KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out)
+{
+	_EXP_TELEMETRY_ALGORITHM("reduce_by_key");
+	return reduce_by_key(_Policy, _First, _Last, _Values, _Keys_out, _Values_out, std::equal_to<>(), std::plus<>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_SCAN_BY_KEY_H_
@@ -3,9 +3,158 @@
 #ifndef _IMPL_SEARCH_H_
 #define _IMPL_SEARCH_H_ 1
 
+#include <unordered_map>
 #include "algorithm_impl.h"
 
 _PSTL_NS1_BEGIN
+namespace details {
+
+	// Needles from this long are searched with skip tables by search(), shorter ones test every position
+	const size_t _Horspool_min_needle = 16;
+
+	// The byte elements compared for equality shift through an array, the others through a hash table
+	template<typename _Key, typename _BinPr>
+	struct _Is_byte_shift_table : std::integral_constant<bool, sizeof(_Key) == 1 && std::is_integral<_Key>::value && !std::is_same<_Key, bool>::value
+		&& (std::is_same<_BinPr, std::equal_to<>>::value || std::is_same<_BinPr, std::equal_to<_Key>>::value)>
+	{
+	};
+
+	// Horspool shifts by the element under the last position of the needle: how far its last occurrence
+	// in the needle, the last position left out, is from the end. Elements not in the needle shift it whole.
+	template<typename _Key, typename _Hash, typename _BinPr, bool _Is_byte = _Is_byte_shift_table<_Key, _BinPr>::value>
+	class _Horspool_table
+	{
+		std::unordered_map<_Key, size_t, _Hash, _BinPr> _Shifts;
+		size_t _Length;
+	public:
+		template<typename _RanIt>
+		_Horspool_table(_RanIt _Needle, size_t _Count, _Hash _Hf, _BinPr _Pred) : _Shifts(_Count, _Hf, _Pred), _Length(_Count)
+		{
+			for (size_t _I = 0; _I + 1 < _Count; ++_I)
+				_Shifts[_Needle[_I]] = _Count - 1 - _I;
+		}
+
+		template<typename _Ty>
+		size_t operator[](const _Ty& _Val) const
+		{
+			auto _Shift = _Shifts.find(_Val);
+			return _Shift == _Shifts.end() ? _Length : _Shift->second;
+		}
+	};
+
+	template<typename _Key, typename _Hash, typename _BinPr>
+	class _Horspool_table<_Key, _Hash, _BinPr, true>
+	{
+		size_t _Shifts[256];
+	public:
+		template<typename _RanIt>
+		_Horspool_table(_RanIt _Needle, size_t _Count, _Hash, _BinPr)
+		{
+			std::fill(_Shifts, _Shifts + 256, _Count);
+			for (size_t _I = 0; _I + 1 < _Count; ++_I)
+				_Shifts[static_cast<unsigned char>(_Needle[_I])] = _Count - 1 - _I;
+		}
+
+		size_t operator[](_Key _Val) const
+		{
+			return _Shifts[static_cast<unsigned char>(_Val)];
+		}
+	};
+
+	// Position of the first match starting in the first _Positions elements from _First, _Positions if
+	// none does. The comparisons read up to _Count - 1 elements past them, the chunks of a parallel
+	// search overlap by that much. _Stop is polled with the position reached.
+	template<typename _RanIt, typename _RanIt2, typename _Table, typename _BinPr, typename _Stop>
+	size_t _Horspool_search(_RanIt _First, size_t _Positions, _RanIt2 _Needle, size_t _Count, const _Table& _Shift, _BinPr& _Pred, const _Stop& _Stop_at)
+	{
+		_Cancellation_poll<_RanIt> _Poll;
+		const size_t _Back = _Count - 1;
+
+		for (size_t _Pos = 0; _Pos < _Positions;) {
+			const auto& _Last_el = _First[_Pos + _Back];
+
+			if (_Pred(_Last_el, _Needle[_Back])) {
+				size_t _I = 0;
+				while (_I < _Back && _Pred(_First[_Pos + _I], _Needle[_I]))
+					++_I;
+
+				if (_I == _Back)
+					return _Pos;
+			}
+
+			_Pos += _Shift[_Last_el];
+			if (_Poll.due() && _Stop_at(_Pos))
+				break;
+		}
+
+		return _Positions;
+	}
+} // details
+
+// Searches for the needle with the skip table of Horspool's variant of the Boyer-Moore algorithm, which
+// is built once with the searcher. The search() with a searcher runs it on the chunks of the range.
+template<class _RanIt2, class _Hash = std::hash<typename std::iterator_traits<_RanIt2>::value_type>, class _BinPr = std::equal_to<>>
+class boyer_moore_horspool_searcher
+{
+	typedef details::_Horspool_table<typename std::iterator_traits<_RanIt2>::value_type, _Hash, _BinPr> _Table;
+
+	_RanIt2 _Needle;
+	size_t _Count;
+	_BinPr _Pred;
+	_Table _Shift;
+public:
+	boyer_moore_horspool_searcher(_RanIt2 _First, _RanIt2 _Last, _Hash _Hf = _Hash(), _BinPr _Pr = _BinPr())
+		: _Needle(_First), _Count(static_cast<size_t>(_Last - _First)), _Pred(_Pr), _Shift(_First, _Count, _Hf, _Pr)
+	{
+		static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt2>::iterator_category>::value, "Required random-access iterator or stronger.");
+	}
+
+	// The first match in [_First, _Last) and its end, or _Last twice if there is none
+	template<class _RanIt1>
+	std::pair<_RanIt1, _RanIt1> operator()(_RanIt1 _First, _RanIt1 _Last) const
+	{
+		static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt1>::iterator_category>::value, "Required random-access iterator or stronger.");
+
+		const size_t _Size = static_cast<size_t>(_Last - _First);
+		if (_Count == 0)
+			return std::make_pair(_First, _First);
+		if (_Count > _Size)
+			return std::make_pair(_Last, _Last);
+
+		const size_t _Positions = _Size - _Count + 1;
+		const size_t _Pos = _Find_in(_First, _Positions, [](size_t) { return false; });
+		if (_Pos == _Positions)
+			return std::make_pair(_Last, _Last);
+
+		return std::make_pair(_First + _Pos, _First + (_Pos + _Count));
+	}
+
+	size_t _Length() const
+	{
+		return _Count;
+	}
+
+	// Position of the first match starting in the first _Positions elements from _First
+	template<class _RanIt1, class _Stop>
+	size_t _Find_in(_RanIt1 _First, size_t _Positions, const _Stop& _Stop_at) const
+	{
+		_BinPr _Pr(_Pred);
+		return details::_Horspool_search(_First, _Positions, _Needle, _Count, _Shift, _Pr, _Stop_at);
+	}
+};
+
+template<class _RanIt2, class _Hash, class _BinPr>
+inline boyer_moore_horspool_searcher<_RanIt2, _Hash, _BinPr> make_boyer_moore_horspool_searcher(_RanIt2 _First, _RanIt2 _Last, _Hash _Hf, _BinPr _Pred)
+{
+	return boyer_moore_horspool_searcher<_RanIt2, _Hash, _BinPr>(_First, _Last, _Hf, _Pred);
+}
+
+template<class _RanIt2>
+inline boyer_moore_horspool_searcher<_RanIt2> make_boyer_moore_horspool_searcher(_RanIt2 _First, _RanIt2 _Last)
+{
+	return boyer_moore_horspool_searcher<_RanIt2>(_First, _Last);
+}
+
 namespace details {
 	//
 	// search_n
@@ -19,7 +168,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _Diff, class _Ty, class _Pr, class _IterCat>
-	_FwdIt _Search_impl_n(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Diff _Count, const _Ty& _Val, _Pr _Pred, _IterCat)
+	_FwdIt _Search_impl_n(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Diff _Count, const _Ty& _Val, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_FwdIt>::difference_type difference_type;
@@ -33,10 +182,11 @@ namespace details {
 
 		cancellation_token_with_position<difference_type> _Token(_Size);
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
+		_Partitioned_for_each(_Policy, _First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
 			[&_Token, &_Val, _Count, &_First](_FwdIt& _Begin, size_t _Partition_count, _Pr _UserPred){
 
 			auto _Dist = std::distance(_First, _Begin);
+			_Cancellation_poll<_FwdIt> _Poll;
 
 			for (size_t _Curr_pos = 0; _Curr_pos < _Partition_count; ++_Curr_pos, ++_Begin) {
 
@@ -51,7 +201,7 @@ namespace details {
 							_Curr_pos += _LocalCount;
 							break;
 						}
-						else if (_Token.is_cancelled(_Dist))
+						else if (_Poll.due() && _Token.is_cancelled(_Dist))
 							return;
 					}
 
@@ -61,7 +211,7 @@ namespace details {
 					}
 				} // _Pred
 
-				if (_Token.is_cancelled(_Dist))
+				if (_Poll.due() && _Token.is_cancelled(_Dist))
 					return;
 			}
 		});
@@ -82,6 +232,62 @@ namespace details {
 		_EXP_GENERIC_EXECUTION_POLICY(_Search_impl_n, _Policy, _First, _Last, _Count, _Val, _Pred, _Cat);
 	}
 
+	//
+	// search with a searcher
+	//
+	template <class _RanIt, class _Searcher, class _IterCat>
+	_RanIt _Search_searcher_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, const _Searcher& _Search, _IterCat)
+	{
+		_EXP_TRY
+			return _Search(_First, _Last).first;
+		_EXP_RETHROW
+	}
+
+	// The chunks split the positions a match can start at, each one searches its own with the table
+	// and reads the elements of the last match it tests past its end
+	template <class _ExPolicy, class _RanIt, class _Searcher>
+	typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Search_searcher_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, const _Searcher& _Search, std::random_access_iterator_tag)
+	{
+		typedef typename std::iterator_traits<_RanIt>::difference_type difference_type;
+
+		const size_t _Count = _Search._Length();
+		if (_Count == 0)
+			return _First;
+
+		const size_t _Size = static_cast<size_t>(_Last - _First);
+		if (_Count > _Size)
+			return _Last;
+
+		cancellation_token_with_position<difference_type> _Token(static_cast<difference_type>(_Size));
+
+		_Partitioned_for_each(_Policy, _First, _Size - _Count + 1, 0,
+			[&_Token, &_Search, &_First](_RanIt _Begin, size_t _Partition_count, int&) {
+			const difference_type _Dist = _Begin - _First;
+			if (_Token.is_cancelled(_Dist))
+				return;
+
+			const size_t _Pos = _Search._Find_in(_Begin, _Partition_count, [&_Token, _Dist](size_t _Reached) {
+				return _Token.is_cancelled(_Dist + static_cast<difference_type>(_Reached));
+			});
+
+			if (_Pos != _Partition_count)
+				_Token.cancel(_Dist + static_cast<difference_type>(_Pos));
+		});
+
+		// Found matching item
+		auto _Pos = _Token.get_position();
+		if (_Pos != static_cast<difference_type>(_Size))
+			return _First + _Pos;
+
+		return _Last;
+	}
+
+	template <class _RanIt, class _Searcher, class _IterCat>
+	_RanIt _Search_searcher_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, const _Searcher& _Search, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Search_searcher_impl, _Policy, _First, _Last, _Search, _Cat);
+	}
+
 	//
 	// search
 	//
@@ -94,7 +300,7 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _FwdIt, class _FwdIt2, class _Pr, class _IterCat>
-	_FwdIt _Search_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _Pr _Pred, _IterCat)
+	_FwdIt _Search_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _Pr _Pred, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef typename std::iterator_traits<_FwdIt>::difference_type difference_type;
@@ -109,10 +315,11 @@ namespace details {
 
 		cancellation_token_with_position<difference_type> _Token(_Size);
 
-		_Partitioner<_ExecutionPolicy>::_For_Each(_First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
+		_Partitioned_for_each(_Policy, _First, _Size - _Count + 1, _Pred, // No sense to run check on the _Size - _Count + 1 because the needle will never match
 			[&_Token, &_First2, _Count, &_First](_FwdIt& _Begin, size_t _Partition_count, _Pr _UserPred) {
 
 			auto _Dist = std::distance(_First, _Begin);
+			_Cancellation_poll<_FwdIt> _Poll;
 
 			for (size_t _Curr_pos = 0; _Curr_pos < _Partition_count; ++_Curr_pos, ++_Begin) {
 
@@ -127,7 +334,7 @@ namespace details {
 
 						if (!_UserPred(*_Mid, *_Needle))
 							break;
-						else if (_Token.is_cancelled(_Dist))
+						else if (_Poll.due() && _Token.is_cancelled(_Dist))
 							return;
 					}
 
@@ -137,7 +344,7 @@ namespace details {
 					}
 				} // _Pred
 
-				if (_Token.is_cancelled(_Dist))
+				if (_Poll.due() && _Token.is_cancelled(_Dist))
 					return;
 			}
 		});
@@ -152,6 +359,31 @@ namespace details {
 		return _Last;
 	}
 
+	template <class _ExPolicy, class _RanIt, class _RanIt2, class _IterCat>
+	_RanIt _Search_long_needle(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _RanIt2 _First2, _RanIt2 _Last2, std::equal_to<> _Pred, _IterCat _Cat, std::false_type)
+	{
+		return _Search_impl(_Policy, _First, _Last, _First2, _Last2, _Pred, std::forward_iterator_tag());
+	}
+
+	template <class _ExPolicy, class _RanIt, class _RanIt2, class _IterCat>
+	_RanIt _Search_long_needle(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _RanIt2 _First2, _RanIt2 _Last2, std::equal_to<> _Pred, _IterCat, std::true_type)
+	{
+		if (static_cast<size_t>(_Last2 - _First2) < _Horspool_min_needle)
+			return _Search_impl(_Policy, _First, _Last, _First2, _Last2, _Pred, std::forward_iterator_tag());
+
+		return _Search_searcher_impl(_Policy, _First, _Last, make_boyer_moore_horspool_searcher(_First2, _Last2), std::random_access_iterator_tag());
+	}
+
+	// Long needles of bytes skip through the random access ranges with the table of a searcher
+	template <class _ExPolicy, class _RanIt, class _RanIt2>
+	typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Search_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _RanIt2 _First2, _RanIt2 _Last2, std::equal_to<> _Pred, std::random_access_iterator_tag _Cat)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Ty;
+
+		return _Search_long_needle(_Policy, _First, _Last, _First2, _Last2, _Pred, _Cat, std::integral_constant<bool,
+			std::is_same<_Ty, typename std::iterator_traits<_RanIt2>::value_type>::value && _Is_byte_shift_table<_Ty, std::equal_to<>>::value>());
+	}
+
 	template <class _FwdIt, class _FwdIt2, class _Pr, class _IterCat>
 	_FwdIt _Search_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _Pr _Pred, _IterCat _Cat)
 	{
@@ -162,6 +394,7 @@ namespace details {
 template<class _ExPolicy, class _FwdIt, class _FwdIt2, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("search");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt2>::iterator_category>::value, "Required forward iterator or stronger.");
 
@@ -172,12 +405,24 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search(_ExPo
 template<class _ExPolicy, class _FwdIt, class _FwdIt2>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _FwdIt2 _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("search");
 	return search(_Policy, _First, _Last, _First2, _Last2, std::equal_to<>());
 }
 
+// The first match of the needle of _Search, whose searcher can be reused by many searches
+template<class _ExPolicy, class _RanIt, class _Searcher>
+inline typename details::_enable_if_policy<_ExPolicy, _RanIt>::type search(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, const _Searcher& _Search)
+{
+	_EXP_TELEMETRY_ALGORITHM("search");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random-access iterator or stronger.");
+
+	return details::_Search_searcher_impl(_Policy, _First, _Last, _Search, std::_Iter_cat(_First));
+}
+
 template<class _ExPolicy, class _FwdIt, class _Diff, class _Ty, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search_n(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Diff _Count, const _Ty& _Val, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("search_n");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Search_impl_n(_Policy, _First, _Last, _Count, _Val, _Pred, std::_Iter_cat(_First));
@@ -186,6 +431,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search_n(_Ex
 template<class _ExPolicy, class _FwdIt, class _Diff, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type search_n(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Diff _Count, const _Ty& _Val)
 {
+	_EXP_TELEMETRY_ALGORITHM("search_n");
 	return search_n(_Policy, _First, _Last, _Count, _Val, std::equal_to<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
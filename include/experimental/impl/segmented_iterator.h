@@ -0,0 +1,108 @@
+#pragma once
+
+#ifndef _IMPL_SEGMENTED_ITERATOR_H_
+#define _IMPL_SEGMENTED_ITERATOR_H_ 1
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include "defines.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     Describes the iterators of containers that store their elements in contiguous segments, such as the
+///     blocks of a std::deque. The chores of the algorithms walk the ranges of segmented iterators segment
+///     by segment, each one through a raw pointer. A chunked container opts its iterators in with a
+///     specialization that sets is_segmented and provides local_iterator, segment_length and local.
+/// </summary>
+template<class _It, class = void>
+struct segmented_iterator_traits
+{
+	static const bool is_segmented = false;
+};
+
+namespace details {
+
+	// The elements of a block of a std::deque, as the deque of the library sizes its blocks
+	template<class _Ty>
+	struct _Deque_block_size : std::integral_constant<size_t,
+		sizeof(_Ty) <= 1 ? 16 : sizeof(_Ty) <= 2 ? 8 : sizeof(_Ty) <= 4 ? 4 : sizeof(_Ty) <= 8 ? 2 : 1>
+	{
+	};
+
+	template<class _It, bool = std::is_same<typename std::iterator_traits<_It>::iterator_category, std::random_access_iterator_tag>::value>
+	struct _Is_deque_iterator : std::false_type
+	{
+	};
+
+	template<class _It>
+	struct _Is_deque_iterator<_It, true> : std::integral_constant<bool,
+		std::is_same<_It, typename std::deque<typename std::iterator_traits<_It>::value_type>::iterator>::value
+		|| std::is_same<_It, typename std::deque<typename std::iterator_traits<_It>::value_type>::const_iterator>::value>
+	{
+	};
+
+	// The number of elements from _Iter on stored one after the other, at most _Max of them and _Max no more than
+	// a block. The elements of a block follow each other and the ones of the next block follow them only when the
+	// two blocks are adjacent, so within a block from _Iter the test is monotone and a binary search finds the end.
+	template<class _It>
+	inline size_t _Contiguous_run(const _It& _Iter, size_t _Max)
+	{
+		const auto _Base = std::addressof(*_Iter);
+
+		size_t _Lo = 1;
+		size_t _Hi = _Max;
+		while (_Lo < _Hi) {
+			const size_t _Mid = _Lo + (_Hi - _Lo) / 2;
+			if (std::addressof(*(_Iter + static_cast<ptrdiff_t>(_Mid))) == _Base + _Mid)
+				_Lo = _Mid + 1;
+			else
+				_Hi = _Mid;
+		}
+
+		return _Lo;
+	}
+
+	// Calls _Func(_Local_first, _Local_count) for the segments of the _Count elements from _First, _Count > 0
+	template<class _It, class _Fn>
+	inline void _For_each_local_segment(_It _First, size_t _Count, _Fn& _Func)
+	{
+		typedef segmented_iterator_traits<_It> _Traits;
+
+		for (;;) {
+			const size_t _Len = _Traits::segment_length(_First, _Count);
+			_ASSERTE(_Len > 0 && _Len <= _Count);
+
+			_Func(_Traits::local(_First), _Len);
+			_Count -= _Len;
+			if (_Count == 0)
+				break;
+			std::advance(_First, static_cast<ptrdiff_t>(_Len));
+		}
+	}
+} // details
+
+template<class _It>
+struct segmented_iterator_traits<_It, typename std::enable_if<details::_Is_deque_iterator<_It>::value>::type>
+{
+	static const bool is_segmented = true;
+
+	typedef typename std::iterator_traits<_It>::pointer local_iterator;
+
+	// The elements from _Iter to the end of its block, at most _Count
+	static size_t segment_length(const _It& _Iter, size_t _Count)
+	{
+		return details::_Contiguous_run(_Iter, (std::min)(_Count, details::_Deque_block_size<typename std::iterator_traits<_It>::value_type>::value));
+	}
+
+	static local_iterator local(const _It& _Iter)
+	{
+		return std::addressof(*_Iter);
+	}
+};
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_SEGMENTED_ITERATOR_H_
@@ -4,6 +4,8 @@
 #define _IMPL_SEQUENTIAL_H_
 
 #include <numeric>
+#include <unordered_set>
+#include <vector>
 
 _PSTL_NS1_BEGIN
 
@@ -34,6 +36,27 @@ inline typename std::iterator_traits<_InIt>::value_type reduce(_InIt _First, _In
 	return std::accumulate(_First, _Last, std::iterator_traits<_InIt>::value_type{}, std::plus<>());
 }
 
+template <class _InIt, class _Ty, class _BinOp, class _UnOp>
+inline _Ty transform_reduce(_InIt _First, _InIt _Last, _Ty _Init, _BinOp _Op, _UnOp _Transform)
+{
+	for (; _First != _Last; ++_First)
+		_Init = _Op(_Init, _Transform(*_First));
+
+	return _Init;
+}
+
+template <class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2>
+inline _Ty transform_reduce(_InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Op, _BinOp2 _Transform)
+{
+	return std::inner_product(_First, _Last, _First2, _Init, _Op, _Transform);
+}
+
+template <class _InIt, class _InIt2, class _Ty>
+inline _Ty transform_reduce(_InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init)
+{
+	return std::inner_product(_First, _Last, _First2, _Init);
+}
+
 template<class _InIt, class _OutIt, class _Ty, class _BinOp>
 inline _OutIt exclusive_scan(_InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op)
 {
@@ -74,6 +97,176 @@ inline _OutIt inclusive_scan(_InIt _First, _InIt _Last, _OutIt _Dest)
 {
 	return inclusive_scan(_First, _Last, _Dest, std::plus<>(), std::iterator_traits<_InIt>::value_type{});
 }
+
+template<class _InIt, class _OutIt, class _Ty, class _BinOp, class _UnOp>
+inline _OutIt transform_exclusive_scan(_InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op, _UnOp _Transform)
+{
+	for (; _First != _Last; ++_First, ++_Dest) {
+		*_Dest = _Init;
+		_Init = _Op(_Init, _Transform(*_First));
+	}
+
+	return _Dest;
+}
+
+template<class _InIt, class _OutIt, class _BinOp, class _UnOp, class _Ty>
+inline _OutIt transform_inclusive_scan(_InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _UnOp _Transform, _Ty _Init)
+{
+	for (; _First != _Last; ++_First, ++_Dest) {
+		_Init = _Op(_Init, _Transform(*_First));
+		*_Dest = _Init;
+	}
+
+	return _Dest;
+}
+
+template<class _InIt, class _OutIt, class _BinOp, class _UnOp>
+inline _OutIt transform_inclusive_scan(_InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op, _UnOp _Transform)
+{
+	if (_First == _Last)
+		return _Dest;
+
+	typename std::decay<decltype(_Transform(*_First))>::type _Init = _Transform(*_First);
+	*_Dest = _Init;
+	return transform_inclusive_scan(++_First, _Last, ++_Dest, _Op, _Transform, _Init);
+}
+
+// Counts the elements by the bin _Key gives for them, the ones whose bin is not below _Bins are not counted
+template<class _InIt, class _OutIt, class _KeyFn>
+inline _OutIt histogram(_InIt _First, _InIt _Last, _OutIt _Dest, size_t _Bins, _KeyFn _Key)
+{
+	std::vector<size_t> _Counts(_Bins);
+	for (; _First != _Last; ++_First) {
+		const size_t _Bin = static_cast<size_t>(_Key(*_First));
+		if (_Bin < _Bins)
+			++_Counts[_Bin];
+	}
+
+	return std::copy(std::begin(_Counts), std::end(_Counts), _Dest);
+}
+
+// Copies the first occurrence of every element, in the order of the range. The elements seen are kept in
+// a hash set, the range is read once.
+template<class _InIt, class _OutIt, class _Hasher, class _Keyeq>
+inline _OutIt distinct(_InIt _First, _InIt _Last, _OutIt _Dest, _Hasher _Hash, _Keyeq _Eq)
+{
+	std::unordered_set<typename std::iterator_traits<_InIt>::value_type, _Hasher, _Keyeq> _Seen(0, _Hash, _Eq);
+	for (; _First != _Last; ++_First) {
+		const auto _Inserted = _Seen.insert(*_First);
+		if (_Inserted.second) {
+			*_Dest = *_Inserted.first;
+			++_Dest;
+		}
+	}
+
+	return _Dest;
+}
+
+// The by key algorithms treat a run of consecutive keys equal under _Pred as a segment
+template<class _KeyIt, class _ValIt, class _OutIt, class _Pr, class _BinOp>
+inline _OutIt inclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred, _BinOp _Op)
+{
+	if (_First == _Last)
+		return _Dest;
+
+	typename std::iterator_traits<_ValIt>::value_type _Val = *_Values;
+	*_Dest = _Val;
+
+	for (_KeyIt _Prev = _First; ++_First != _Last; _Prev = _First) {
+		++_Values;
+		++_Dest;
+		_Val = _Pred(*_Prev, *_First) ? _Op(_Val, *_Values) : *_Values;
+		*_Dest = _Val;
+	}
+
+	return ++_Dest;
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _Pr>
+inline _OutIt inclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Pr _Pred)
+{
+	return inclusive_scan_by_key(_First, _Last, _Values, _Dest, _Pred, std::plus<>());
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt>
+inline _OutIt inclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest)
+{
+	return inclusive_scan_by_key(_First, _Last, _Values, _Dest, std::equal_to<>(), std::plus<>());
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr, class _BinOp>
+inline _OutIt exclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred, _BinOp _Op)
+{
+	if (_First == _Last)
+		return _Dest;
+
+	*_Dest = _Init;
+	_Ty _Val = _Op(_Init, *_Values);
+
+	for (_KeyIt _Prev = _First; ++_First != _Last; _Prev = _First) {
+		++_Values;
+		++_Dest;
+		if (!_Pred(*_Prev, *_First))
+			_Val = _Init;
+		*_Dest = _Val;
+		_Val = _Op(_Val, *_Values);
+	}
+
+	return ++_Dest;
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _Ty, class _Pr>
+inline _OutIt exclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init, _Pr _Pred)
+{
+	return exclusive_scan_by_key(_First, _Last, _Values, _Dest, _Init, _Pred, std::plus<>());
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _Ty>
+inline _OutIt exclusive_scan_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Dest, _Ty _Init)
+{
+	return exclusive_scan_by_key(_First, _Last, _Values, _Dest, _Init, std::equal_to<>(), std::plus<>());
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr, class _BinOp>
+inline std::pair<_OutIt, _OutIt2> reduce_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred, _BinOp _Op)
+{
+	if (_First == _Last)
+		return std::pair<_OutIt, _OutIt2>(_Keys_out, _Values_out);
+
+	_KeyIt _Key = _First;
+	typename std::iterator_traits<_ValIt>::value_type _Val = *_Values;
+
+	for (_KeyIt _Prev = _First; ++_First != _Last; _Prev = _First) {
+		++_Values;
+		if (_Pred(*_Prev, *_First))
+			_Val = _Op(_Val, *_Values);
+		else {
+			*_Keys_out = *_Key;
+			++_Keys_out;
+			*_Values_out = std::move(_Val);
+			++_Values_out;
+
+			_Key = _First;
+			_Val = *_Values;
+		}
+	}
+
+	*_Keys_out = *_Key;
+	*_Values_out = std::move(_Val);
+	return std::pair<_OutIt, _OutIt2>(++_Keys_out, ++_Values_out);
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _OutIt2, class _Pr>
+inline std::pair<_OutIt, _OutIt2> reduce_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out, _Pr _Pred)
+{
+	return reduce_by_key(_First, _Last, _Values, _Keys_out, _Values_out, _Pred, std::plus<>());
+}
+
+template<class _KeyIt, class _ValIt, class _OutIt, class _OutIt2>
+inline std::pair<_OutIt, _OutIt2> reduce_by_key(_KeyIt _First, _KeyIt _Last, _ValIt _Values, _OutIt _Keys_out, _OutIt2 _Values_out)
+{
+	return reduce_by_key(_First, _Last, _Values, _Keys_out, _Values_out, std::equal_to<>(), std::plus<>());
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_SEQUENTIAL_H_
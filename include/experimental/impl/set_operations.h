@@ -16,109 +16,334 @@ namespace details
 {
 	struct _SplitedChunk
 	{
-		size_t _Start, _Len, _Accumulated;
+		size_t _Start1, _End1, _Start2, _End2, _Len, _Accumulated;
 	};
 
-	template <typename _T>
-	class _NullablePointerWrapper
+	// Output iterator that only counts the values assigned through it, sizes the output of a set operation without writing it
+	class _Counting_output_iterator :
+		public std::iterator<std::output_iterator_tag, void, void, void, void>
 	{
-		const _T * _M_Item;
-
+		size_t _Count;
 	public:
-		_NullablePointerWrapper()
+		_Counting_output_iterator() : _Count(0)
+		{
+		}
+
+		template <typename _Ty>
+		_Counting_output_iterator& operator=(const _Ty&)
 		{
-			_M_Item = nullptr;
+			++_Count;
+			return *this;
 		}
 
-		_NullablePointerWrapper(const _T &_Item)
+		_Counting_output_iterator& operator*()
 		{
-			_M_Item = &_Item;
+			return *this;
 		}
 
-		_NullablePointerWrapper & operator =(const _T &_Item)
+		_Counting_output_iterator& operator++()
 		{
-			_M_Item = &_Item;
 			return *this;
 		}
 
-		operator const _T &() const
+		_Counting_output_iterator& operator++(int)
 		{
-			_ASSERT(_M_Item != nullptr);
-			return *_M_Item;
+			return *this;
+		}
+
+		size_t count() const
+		{
+			return _Count;
 		}
 	};
 
-	template <typename OutItr>
-	struct SetOperationBuffer
+	//
+	// Galloping
+	//
+	// A chunk of a set operation on ranges of very different sizes, an index of a million values against one of
+	// a billion, doesn't merge the small range into the large one element by element. The place of every element
+	// of the small range is found by an exponential search from the place of the one before it, and the elements
+	// of the large range in between are skipped, or copied as a block, without a comparison. The comparisons on
+	// the large range are logarithmic in the gaps between the matches instead of linear in the range.
+	const size_t _Gallop_ratio = 16;
+
+	inline bool _Is_skewed(size_t _Len1, size_t _Len2)
+	{
+		return (std::max)(_Len1, _Len2) / _Gallop_ratio > (std::min)(_Len1, _Len2);
+	}
+
+	// The first element of [_First, _Last) not less than _Val, bracketed by steps that double from _First
+	template <typename _RandIt, typename _Ty, typename _Comp>
+	inline _RandIt _Gallop_lower_bound(_RandIt _First, _RandIt _Last, const _Ty& _Val, _Comp& _Cmp)
+	{
+		typedef typename std::iterator_traits<_RandIt>::difference_type _Diff;
+
+		const _Diff _Len = _Last - _First;
+		_Diff _Low = 0, _Step = 1;
+		while (_Step <= _Len && _Cmp(_First[_Step - 1], _Val))
+		{
+			_Low = _Step;
+			_Step *= 2;
+		}
+
+		return std::lower_bound(_First + _Low, _First + (std::min)(_Step - 1, _Len), _Val, _Cmp);
+	}
+
+	// The equal elements of both ranges pair off one to one, as in std::set_intersection, and are taken from the first
+	template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+	_OutIt _Gallop_set_intersection(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp)
+	{
+		if (_Last1 - _First1 <= _Last2 - _First2) {
+			for (; _First1 != _Last1; ++_First1) {
+				_First2 = _Gallop_lower_bound(_First2, _Last2, *_First1, _Cmp);
+				if (_First2 == _Last2)
+					break;
+
+				if (!_Cmp(*_First1, *_First2)) {
+					*_Dest = *_First1;
+					++_Dest;
+					++_First2;
+				}
+			}
+		}
+		else {
+			for (; _First2 != _Last2; ++_First2) {
+				_First1 = _Gallop_lower_bound(_First1, _Last1, *_First2, _Cmp);
+				if (_First1 == _Last1)
+					break;
+
+				if (!_Cmp(*_First2, *_First1)) {
+					*_Dest = *_First1;
+					++_Dest;
+					++_First1;
+				}
+			}
+		}
+
+		return _Dest;
+	}
+
+	// Every element of the second range takes out one equal element of the first
+	template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+	_OutIt _Gallop_set_difference(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp)
+	{
+		if (_Last1 - _First1 <= _Last2 - _First2) {
+			for (; _First1 != _Last1; ++_First1) {
+				_First2 = _Gallop_lower_bound(_First2, _Last2, *_First1, _Cmp);
+				if (_First2 != _Last2 && !_Cmp(*_First1, *_First2))
+					++_First2;
+				else {
+					*_Dest = *_First1;
+					++_Dest;
+				}
+			}
+
+			return _Dest;
+		}
+
+		for (; _First2 != _Last2; ++_First2) {
+			const _It1 _Match = _Gallop_lower_bound(_First1, _Last1, *_First2, _Cmp);
+			_Dest = std::copy(_First1, _Match, _Dest);
+			_First1 = _Match;
+			if (_First1 == _Last1)
+				return _Dest;
+
+			if (!_Cmp(*_First2, *_First1))
+				++_First1;
+		}
+
+		return std::copy(_First1, _Last1, _Dest);
+	}
+
+	// Whether every element of the second range has an equal element of its own in the first
+	template <typename _It1, typename _It2, typename _Comp>
+	bool _Gallop_includes(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _Comp& _Cmp)
 	{
-		typedef typename std::iterator_traits<OutItr>::value_type ValueType;
+		if (_Last1 - _First1 < _Last2 - _First2)
+			return false;
+
+		for (; _First2 != _Last2; ++_First2, ++_First1) {
+			_First1 = _Gallop_lower_bound(_First1, _Last1, *_First2, _Cmp);
+			if (_First1 == _Last1 || _Cmp(*_First2, *_First1))
+				return false;
+		}
 
-		static _NullablePointerWrapper<ValueType> notUseWrapper(std::false_type);
-		static typename ValueType notUseWrapper(std::true_type);
-		typedef decltype(notUseWrapper(typename std::is_scalar<ValueType>::type())) ValueType2;
+		return true;
+	}
 
-		typedef std::vector<ValueType2> BufferType;
-		typedef typename BufferType::iterator IteratorType;
+	struct _Set_union_op
+	{
+		template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+		_OutIt operator()(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp) const
+		{
+			return std::set_union(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+		}
 	};
 
-	template <typename _RandItr1, typename _RandItr2, typename _RandItr3, typename SetOp, typename _CancPos, typename _Comp>
-	_RandItr3 _ParallelSetOperation(_RandItr1 _Begin1, size_t _Len1, _RandItr2 _Begin2, size_t _Len2, _RandItr3 _Output, size_t _ConcurrencyLevel, SetOp _SetOp, _CancPos _CalcPos, _Comp _Cmp)
+	struct _Set_intersection_op
 	{
-		if (_ConcurrencyLevel > _Len1)
-			_ConcurrencyLevel = _Len1;
+		template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+		_OutIt operator()(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp) const
+		{
+			if (_Is_skewed(static_cast<size_t>(_Last1 - _First1), static_cast<size_t>(_Last2 - _First2)))
+				return _Gallop_set_intersection(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+
+			return std::set_intersection(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+		}
+	};
+
+	struct _Set_difference_op
+	{
+		template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+		_OutIt operator()(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp) const
+		{
+			if (_Is_skewed(static_cast<size_t>(_Last1 - _First1), static_cast<size_t>(_Last2 - _First2)))
+				return _Gallop_set_difference(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+
+			return std::set_difference(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+		}
+	};
 
+	struct _Set_symmetric_difference_op
+	{
+		template <typename _It1, typename _It2, typename _OutIt, typename _Comp>
+		_OutIt operator()(_It1 _First1, _It1 _Last1, _It2 _First2, _It2 _Last2, _OutIt _Dest, _Comp& _Cmp) const
+		{
+			return std::set_symmetric_difference(_First1, _Last1, _First2, _Last2, _Dest, _Cmp);
+		}
+	};
+
+	// Finds the part of both ranges the chunk _Index handles. The chunks of the first range are moved to
+	// the boundaries of equal ranges, a chunk that lies inside one equal range is left empty.
+	template <typename _RandItr1, typename _RandItr2, typename _Comp>
+	void _Set_operation_chunk(_RandItr1 _Begin1, size_t _Len1, _RandItr2 _Begin2, size_t _Len2, size_t _Index, size_t _Step, _Comp& _UserFunc, _SplitedChunk& _Chunk)
+	{
+		size_t _Start1 = _Index * _Step;
+		if (_Start1 >= _Len1) // the rounded up _Step can leave the last chunks without elements
+			return;
+
+		size_t _End1 = (std::min)(_Start1 + _Step, _Len1); // the last chunk can only be smaller than others, since we round up _Step
+
+		// if it's not last chunk, we need to adjust tail
+		if (_End1 < _Len1)
+		{
+			// all equal range. It will be handled by next chunk.
+			if (!_UserFunc(_Begin1[_Start1], _Begin1[_End1]))
+				return;
+			while (!_UserFunc(_Begin1[_End1 - 1], _Begin1[_End1]))
+				--_End1;
+		}
+
+		// Adjust head, until it reach the beginning
+		while (_Start1 > 0 && !_UserFunc(_Begin1[_Start1 - 1], _Begin1[_Start1]))
+			--_Start1;
+
+		// find a paired range, it ends where the range of the next chunk starts so that the values of the
+		// second range that fall between two chunks are not lost
+		_Chunk._Start1 = _Start1;
+		_Chunk._End1 = _End1;
+		_Chunk._Start2 = _Start1 == 0 ? 0 : std::lower_bound(_Begin2, _Begin2 + _Len2, _Begin1[_Start1], _UserFunc) - _Begin2;
+		_Chunk._End2 = _End1 == _Len1 ? _Len2 : std::lower_bound(_Begin2, _Begin2 + _Len2, _Begin1[_End1], _UserFunc) - _Begin2;
+	}
+
+	inline void _Set_operation_offsets(std::vector<_SplitedChunk>& _ChunkInfo)
+	{
+		_ChunkInfo.front()._Accumulated = 0;
+		for (size_t _I = 1; _I < _ChunkInfo.size(); _I++)
+			_ChunkInfo[_I]._Accumulated = _ChunkInfo[_I - 1]._Accumulated + _ChunkInfo[_I - 1]._Len;
+	}
+
+	// Types that are expensive to copy: every chunk counts its output without writing it, the counts
+	// are scanned to offsets and every chunk runs the set operation again straight into the output
+	template <typename _RandItr1, typename _RandItr2, typename _RandItr3, typename SetOp, typename _CancPos, typename _Comp>
+	_RandItr3 _ParallelSetOperation(_RandItr1 _Begin1, size_t _Len1, _RandItr2 _Begin2, size_t _Len2, _RandItr3 _Output, size_t _ConcurrencyLevel, SetOp _SetOp, _CancPos, _Comp _Cmp, std::false_type)
+	{
 		size_t _Step = (_Len1 + _ConcurrencyLevel - 1) / _ConcurrencyLevel;
 		std::vector<_SplitedChunk> _ChunkInfo(_ConcurrencyLevel);
 
-		// a reference _Buffer as big as the input data
-		typename SetOperationBuffer<_RandItr3>::BufferType _Buffer(_CalcPos(_Len1, _Len2));
+		// _Step 1: count
+		_Partitioner<static_partitioner_tag>::_For_Each(_ChunkInfo.begin(), _ChunkInfo.size(), _Cmp,
+			[&_Step, &_Len1, &_Begin1, &_Begin2, &_Len2, &_SetOp, &_ChunkInfo](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _Comp& _UserFunc) {
+			_Set_operation_chunk(_Begin1, _Len1, _Begin2, _Len2, _CurItr - _ChunkInfo.begin(), _Step, _UserFunc, *_CurItr);
 
-		// _Step 1: filter
+			_CurItr->_Len = _SetOp(_Begin1 + _CurItr->_Start1, _Begin1 + _CurItr->_End1, _Begin2 + _CurItr->_Start2, _Begin2 + _CurItr->_End2,
+				_Counting_output_iterator(), _UserFunc).count();
+		}, 1);
+
+		// _Step 2: accumulation
+		_Set_operation_offsets(_ChunkInfo);
+
+		// _Step 3: write
 		_Partitioner<static_partitioner_tag>::_For_Each(_ChunkInfo.begin(), _ChunkInfo.size(), _Cmp,
-			[&_Step, &_Len1, &_Begin1, &_Begin2, &_Len2, &_CalcPos, &_SetOp, &_ChunkInfo, &_Buffer](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _Comp& _UserFunc) {
-			size_t _Start1 = (_CurItr - _ChunkInfo.begin()) * _Step;
-			size_t _End1 = (std::min)(_Start1 + _Step, _Len1); // the last chunk can only be smaller than others, since we round up _Step
-
-			// if it's not last chunk, we need to adjust tail
-			if (_End1 < _Len1)
-			{
-				// all equal range. It will be handled by next chunk.
-				if (!_UserFunc(_Begin1[_Start1], _Begin1[_End1]))
-					return;
-				while (!_UserFunc(_Begin1[_End1 - 1], _Begin1[_End1]))
-					--_End1;
-			}
+			[&_Begin1, &_Begin2, &_Output, &_SetOp](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _Comp& _UserFunc) {
+			if (_CurItr->_Len != 0)
+				_SetOp(_Begin1 + _CurItr->_Start1, _Begin1 + _CurItr->_End1, _Begin2 + _CurItr->_Start2, _Begin2 + _CurItr->_End2,
+					_Output + _CurItr->_Accumulated, _UserFunc);
+		}, 1);
+
+		return _Output + _ChunkInfo.back()._Accumulated + _ChunkInfo.back()._Len;
+	}
 
-			// Adjust head, until it reach the beginning
-			while (_Start1 > 0 && !_UserFunc(_Begin1[_Start1 - 1], _Begin1[_Start1]))
-				--_Start1;
+	// Trivially copyable types: running the comparisons twice costs more than copying the results,
+	// every chunk writes its output once to raw storage, at the most it can produce, and the results
+	// are copied to their place in the output. Without the storage it falls back to the two passes.
+	template <typename _RandItr1, typename _RandItr2, typename _RandItr3, typename SetOp, typename _CancPos, typename _Comp>
+	_RandItr3 _ParallelSetOperation(_RandItr1 _Begin1, size_t _Len1, _RandItr2 _Begin2, size_t _Len2, _RandItr3 _Output, size_t _ConcurrencyLevel, SetOp _SetOp, _CancPos _CalcPos, _Comp _Cmp, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RandItr3>::value_type _ValueType;
 
-			// find a paired range
-			size_t _Start2 = _Start1 == 0 ? 0 : std::lower_bound(_Begin2, _Begin2 + _Len2, _Begin1[_Start1], _UserFunc) - _Begin2;
-			size_t _End2 = _End1 == _Len1 ? _Len2 : std::upper_bound(_Begin2, _Begin2 + _Len2, _Begin1[_End1 - 1], _UserFunc) - _Begin2;
+		_Uninitialized_buffer<_ValueType> _Buffer;
+		try {
+			_Buffer._Reserve(_CalcPos(_Len1, _Len2));
+		}
+		catch (const std::bad_alloc&) {
+			return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel, _SetOp, _CalcPos, _Cmp, std::false_type());
+		}
 
-			_CurItr->_Start = _CalcPos(_Start1, _Start2);
-			auto _OutItr = _Buffer.begin() + _CurItr->_Start;
-			_CurItr->_Len = _SetOp(_Begin1 + _Start1, _Begin1 + _End1, _Begin2 + _Start2, _Begin2 + _End2, _OutItr, _UserFunc) - _OutItr;
+		size_t _Step = (_Len1 + _ConcurrencyLevel - 1) / _ConcurrencyLevel;
+		std::vector<_SplitedChunk> _ChunkInfo(_ConcurrencyLevel);
+		_ValueType *_Storage = _Buffer.get();
+
+		// _Step 1: filter
+		_Partitioner<static_partitioner_tag>::_For_Each(_ChunkInfo.begin(), _ChunkInfo.size(), _Cmp,
+			[&_Step, &_Len1, &_Begin1, &_Begin2, &_Len2, &_CalcPos, &_SetOp, &_ChunkInfo, _Storage](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _Comp& _UserFunc) {
+			_Set_operation_chunk(_Begin1, _Len1, _Begin2, _Len2, _CurItr - _ChunkInfo.begin(), _Step, _UserFunc, *_CurItr);
+
+			auto _OutPtr = _Storage + _CalcPos(_CurItr->_Start1, _CurItr->_Start2);
+			_CurItr->_Len = _SetOp(_Begin1 + _CurItr->_Start1, _Begin1 + _CurItr->_End1, _Begin2 + _CurItr->_Start2, _Begin2 + _CurItr->_End2,
+				_OutPtr, _UserFunc) - _OutPtr;
 		}, 1);
 
 		// _Step 2: accumulation
-		_ChunkInfo.front()._Accumulated = 0;
-		for (size_t _I = 1; _I < _ChunkInfo.size(); _I++)
-			_ChunkInfo[_I]._Accumulated = _ChunkInfo[_I - 1]._Accumulated + _ChunkInfo[_I - 1]._Len;
+		_Set_operation_offsets(_ChunkInfo);
 
-		// _Step 3: move
+		// _Step 3: copy
 		_Partitioner<static_partitioner_tag>::_For_Each(_ChunkInfo.begin(), _ChunkInfo.size(), _Output,
-			[&_Buffer](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _RandItr3 _OutputIter) {
-			std::copy(_Buffer.begin() + _CurItr->_Start, _Buffer.begin() + _CurItr->_Start + _CurItr->_Len, _OutputIter + _CurItr->_Accumulated);
+			[&_CalcPos, _Storage](std::vector<_SplitedChunk>::iterator _CurItr, size_t, _RandItr3 _OutputIter) {
+			auto _OutPtr = _Storage + _CalcPos(_CurItr->_Start1, _CurItr->_Start2);
+			std::copy(_OutPtr, _OutPtr + _CurItr->_Len, _OutputIter + _CurItr->_Accumulated);
 		}, 1);
 
 		return _Output + _ChunkInfo.back()._Accumulated + _ChunkInfo.back()._Len;
 	}
 
+	template <typename _RandItr1, typename _RandItr2, typename _RandItr3, typename SetOp, typename _CancPos, typename _Comp>
+	_RandItr3 _ParallelSetOperation(_RandItr1 _Begin1, size_t _Len1, _RandItr2 _Begin2, size_t _Len2, _RandItr3 _Output, size_t _ConcurrencyLevel, SetOp _SetOp, _CancPos _CalcPos, _Comp _Cmp)
+	{
+		if (_ConcurrencyLevel > _Len1)
+			_ConcurrencyLevel = _Len1;
+
+		return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel, _SetOp, _CalcPos, _Cmp,
+			typename std::is_trivial<typename std::iterator_traits<_RandItr3>::value_type>::type());
+	}
+
 	template <typename _ExPolicy, typename _RandItr1, typename _RandItr2, typename _RandItr3, typename _Comp>
 	typename _enable_if_parallel<_ExPolicy, _RandItr3>::type set_union_impl(const _ExPolicy &_Policy, _RandItr1 _Begin1, _RandItr1 _End1, _RandItr2 _Begin2, _RandItr2 _End2, _RandItr3 _Output, _Comp _Cmp, std::random_access_iterator_tag)
 	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		size_t _Len1 = _End1 - _Begin1, _Len2 = _End2 - _Begin2;
 
 		if (_Len1 == 0)
@@ -129,7 +354,7 @@ namespace details
 		{
 			size_t _ConcurrencyLevel = get_hardware_concurrency() * 2;
 			return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel,
-				static_cast<typename SetOperationBuffer<_RandItr3>::IteratorType(*)(_RandItr1, _RandItr1, _RandItr2, _RandItr2, typename SetOperationBuffer<_RandItr3>::IteratorType, _Comp)>(std::set_union),
+				_Set_union_op(),
 				[](size_t _Left, size_t _Right) { return _Left + _Right; }, _Cmp);
 		}
 	}
@@ -155,8 +380,12 @@ namespace details
 	}
 
 	template <typename _ExPolicy, typename _RandItr1, typename _RandItr2, typename _RandItr3, typename _Comp>
-	typename _enable_if_parallel<_ExPolicy, _RandItr3>::type set_intersection_impl(_ExPolicy &&, _RandItr1 _Begin1, _RandItr1 _End1, _RandItr2 _Begin2, _RandItr2 _End2, _RandItr3 _Output, _Comp _Cmp, std::random_access_iterator_tag)
+	typename _enable_if_parallel<_ExPolicy, _RandItr3>::type set_intersection_impl(_ExPolicy &&_Policy, _RandItr1 _Begin1, _RandItr1 _End1, _RandItr2 _Begin2, _RandItr2 _End2, _RandItr3 _Output, _Comp _Cmp, std::random_access_iterator_tag)
 	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		size_t _Len1 = _End1 - _Begin1, _Len2 = _End2 - _Begin2;
 
 		if (_Len1 == 0 || _Len2 == 0)
@@ -165,7 +394,7 @@ namespace details
 		{
 			size_t _ConcurrencyLevel = get_hardware_concurrency() * 2;
 			return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel,
-				static_cast<typename SetOperationBuffer<_RandItr3>::IteratorType(*)(_RandItr1, _RandItr1, _RandItr2, _RandItr2, typename SetOperationBuffer<_RandItr3>::IteratorType, _Comp)>(std::set_intersection),
+				_Set_intersection_op(),
 				[](size_t _Left, size_t _Right) { return (std::min)(_Left, _Right); }, _Cmp);
 		}
 	}
@@ -193,6 +422,10 @@ namespace details
 	template <typename _ExPolicy, typename _RandItr1, typename _RandItr2, typename _RandItr3, typename _Comp>
 	typename _enable_if_parallel<_ExPolicy, _RandItr3>::type set_difference_impl(_ExPolicy &&_Policy, _RandItr1 _Begin1, _RandItr1 _End1, _RandItr2 _Begin2, _RandItr2 _End2, _RandItr3 _Output, _Comp _Cmp, std::random_access_iterator_tag)
 	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		size_t _Len1 = _End1 - _Begin1, _Len2 = _End2 - _Begin2;
 
 		if (_Len1 == 0)
@@ -203,7 +436,7 @@ namespace details
 		{
 			size_t _ConcurrencyLevel = get_hardware_concurrency() * 2;
 			return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel,
-				static_cast<typename SetOperationBuffer<_RandItr3>::IteratorType(*)(_RandItr1, _RandItr1, _RandItr2, _RandItr2, typename SetOperationBuffer<_RandItr3>::IteratorType, _Comp)>(std::set_difference),
+				_Set_difference_op(),
 				[](size_t _Left, size_t) { return _Left; }, _Cmp);
 		}
 	}
@@ -231,6 +464,10 @@ namespace details
 	template <typename _ExPolicy, typename _RandItr1, typename _RandItr2, typename _RandItr3, typename _Comp>
 	typename _enable_if_parallel<_ExPolicy, _RandItr3>::type set_symmetric_difference_impl(_ExPolicy &&_Policy, _RandItr1 _Begin1, _RandItr1 _End1, _RandItr2 _Begin2, _RandItr2 _End2, _RandItr3 _Output, _Comp _Cmp, std::random_access_iterator_tag)
 	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
 		size_t _Len1 = _End1 - _Begin1, _Len2 = _End2 - _Begin2;
 		if (_Len1 == 0)
 			return details::_Copy_impl(std::forward<_ExPolicy>(_Policy), _Begin2, _End2, _Output, std::random_access_iterator_tag());
@@ -240,7 +477,7 @@ namespace details
 		{
 			size_t _ConcurrencyLevel = get_hardware_concurrency() * 2;
 			return _ParallelSetOperation(_Begin1, _Len1, _Begin2, _Len2, _Output, _ConcurrencyLevel,
-				static_cast<typename SetOperationBuffer<_RandItr3>::IteratorType(*)(_RandItr1, _RandItr1, _RandItr2, _RandItr2, typename SetOperationBuffer<_RandItr3>::IteratorType, _Comp)>(std::set_symmetric_difference),
+				_Set_symmetric_difference_op(),
 				[](size_t _Left, size_t _Right) { return _Left + _Right; }, _Cmp);
 		}
 	}
@@ -269,6 +506,7 @@ namespace details
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt, typename _Comp>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_union(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest, _Comp _Cmp)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_union");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt1>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required _Output iterator or stronger.");
@@ -279,12 +517,14 @@ inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_union(
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_union(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_union");
 	return set_union(std::forward<_ExecPolicy>(_Policy), _First1, _Last1, _First2, _Last2, _Dest, std::less<typename std::iterator_traits<_InIt1>::value_type>());
 }
 
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt, typename _Comp>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_intersection(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest, _Comp _Cmp)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_intersection");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt1>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required _Output iterator or stronger.");
@@ -295,12 +535,14 @@ inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_inters
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_intersection(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_intersection");
 	return set_intersection(std::forward<_ExecPolicy>(_Policy), _First1, _Last1, _First2, _Last2, _Dest, std::less<>());
 }
 
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt, typename _Comp>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_difference(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest, _Comp _Cmp)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_difference");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt1>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required _Output iterator or stronger.");
@@ -311,12 +553,14 @@ inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_differ
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_difference(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_difference");
 	return set_difference(std::forward<_ExecPolicy>(_Policy), _First1, _Last1, _First2, _Last2, _Dest, std::less<>());
 }
 
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt, typename _Comp>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_symmetric_difference(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest, _Comp _Cmp)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_symmetric_difference");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt1>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required _Output iterator or stronger.");
@@ -327,6 +571,7 @@ inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_symmet
 template <typename _ExecPolicy, typename _InIt1, typename _InIt2, typename _OutIt>
 inline typename details::_enable_if_policy<_ExecPolicy, _OutIt>::type set_symmetric_difference(_ExecPolicy &&_Policy, _InIt1 _First1, _InIt1 _Last1, _InIt2 _First2, _InIt2 _Last2, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("set_symmetric_difference");
 	return set_symmetric_difference(_Policy, _First1, _Last1, _First2, _Last2, _Dest, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
@@ -8,8 +8,24 @@
 #include <functional>
 #include <type_traits>
 #include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <memory>
+#include <new>
+#include <random>
+#include <string>
+#if _HAS_CXX17
+#include <string_view>
+#endif
+#include <vector>
 
 #include "taskgroup.h"
+#include "minmax_element.h"
+#include "permute.h"
 #include "reduce.h"
 
 _PSTL_NS1_BEGIN
@@ -103,12 +119,265 @@ namespace details
 		}
 	}
 
+	// Swaps a few values of the range with values at pseudo random places. The places depend on the size
+	// only, so an input crafted against the pivot selection can't predict where they land.
+	template<typename _Random_iterator>
+	inline void _Break_patterns(const _Random_iterator &_Begin, size_t _Size)
+	{
+		if (_Size < 8)
+			return;
+
+		size_t _Seed = _Size;
+		for (size_t _Quarter = 1; _Quarter < 4; ++_Quarter)
+		{
+			// xorshift
+			_Seed ^= _Seed << 13;
+			_Seed ^= _Seed >> 7;
+			_Seed ^= _Seed << 17;
+			std::iter_swap(_Begin + _Size / 4 * _Quarter, _Begin + _Seed % _Size);
+		}
+	}
+
+	//
+	// Vector leaf sort
+	//
+	// The leaves of the parallel sorts of contiguous 4 byte integers ordered by std::less or std::greater. Every 16
+	// values are loaded in 4 vectors, sorted across them by a sorting network and transposed to 4 sorted runs of 4.
+	// The runs are then merged pairwise, a vector at a time, by a bitonic merge network, in passes between the range
+	// and a buffer. Equal integers can't be told apart, so the leaves of stable_sort are sorted the same way.
+	template<typename _Pr, typename _Ty>
+	struct _Radix_order;
+
+	template<typename _RanIt, typename _Pr, typename _El = typename std::iterator_traits<_RanIt>::value_type>
+	struct _Is_vector_sortable : std::integral_constant<bool, _EXP_SSE2 != 0 && _Contiguous_container_iterator_traits<_RanIt>::value
+		&& std::is_integral<_El>::value && sizeof(_El) == 4 && _Radix_order<_Pr, _El>::value>
+	{
+	};
+
+	// Leaves up to this size are merged through a buffer on the stack, larger ones through the scratch. Larger
+	// than the most, the passes over them cost more than the comparisons they save.
+	const size_t _Vector_sort_stack = 2048;
+	const size_t _Vector_sort_max = 16 * 1024;
+
+	template<typename _RanIt, typename _Pr>
+	inline bool _Vector_leaf_sort(_RanIt, size_t, _Pr&, std::false_type)
+	{
+		return false;
+	}
+
+#if _EXP_SSE2
+	// The order of the network: the _Low of two values goes first, the largest in descending order
+	template<typename _El, bool _Descending>
+	struct _Sort_lanes
+	{
+		typedef _Int_minmax_lane<4, std::is_signed<_El>::value> _Lane;
+
+		static __m128i _Low(__m128i _Left, __m128i _Right)
+		{
+			return _Descending ? _Vec_max(_Left, _Right, _Lane()) : _Vec_min(_Left, _Right, _Lane());
+		}
+
+		static __m128i _High(__m128i _Left, __m128i _Right)
+		{
+			return _Descending ? _Vec_min(_Left, _Right, _Lane()) : _Vec_max(_Left, _Right, _Lane());
+		}
+
+		static bool _Before(_El _Left, _El _Right)
+		{
+			return _Descending ? _Right < _Left : _Left < _Right;
+		}
+	};
+
+	template<typename _Lanes>
+	inline void _Vec_exchange(__m128i& _Left, __m128i& _Right)
+	{
+		const __m128i _Low = _Lanes::_Low(_Left, _Right);
+		_Right = _Lanes::_High(_Left, _Right);
+		_Left = _Low;
+	}
+
+	// Sorts the 16 values at _First to 4 sorted runs of 4
+	template<typename _Lanes, typename _El>
+	inline void _Vec_sort_runs(_El *_First)
+	{
+		__m128i *_Vec = reinterpret_cast<__m128i *>(_First);
+		__m128i _Row0 = _mm_loadu_si128(_Vec), _Row1 = _mm_loadu_si128(_Vec + 1), _Row2 = _mm_loadu_si128(_Vec + 2), _Row3 = _mm_loadu_si128(_Vec + 3);
+
+		_Vec_exchange<_Lanes>(_Row0, _Row1);
+		_Vec_exchange<_Lanes>(_Row2, _Row3);
+		_Vec_exchange<_Lanes>(_Row0, _Row2);
+		_Vec_exchange<_Lanes>(_Row1, _Row3);
+		_Vec_exchange<_Lanes>(_Row1, _Row2);
+
+		// The columns are sorted, transposed they are the runs
+		const __m128i _Low01 = _mm_unpacklo_epi32(_Row0, _Row1), _Low23 = _mm_unpacklo_epi32(_Row2, _Row3);
+		const __m128i _High01 = _mm_unpackhi_epi32(_Row0, _Row1), _High23 = _mm_unpackhi_epi32(_Row2, _Row3);
+		_mm_storeu_si128(_Vec, _mm_unpacklo_epi64(_Low01, _Low23));
+		_mm_storeu_si128(_Vec + 1, _mm_unpackhi_epi64(_Low01, _Low23));
+		_mm_storeu_si128(_Vec + 2, _mm_unpacklo_epi64(_High01, _High23));
+		_mm_storeu_si128(_Vec + 3, _mm_unpackhi_epi64(_High01, _High23));
+	}
+
+	// Sorts a bitonic vector: the lanes 2 apart are exchanged, then the lanes 1 apart
+	template<typename _Lanes>
+	inline __m128i _Vec_bitonic_sort(__m128i _Val)
+	{
+		__m128i _Other = _mm_shuffle_epi32(_Val, _MM_SHUFFLE(1, 0, 3, 2));
+		__m128i _Low = _Lanes::_Low(_Val, _Other), _High = _Lanes::_High(_Val, _Other);
+		_Val = _mm_unpacklo_epi64(_Low, _High);
+
+		_Other = _mm_shuffle_epi32(_Val, _MM_SHUFFLE(2, 3, 0, 1));
+		_Low = _Lanes::_Low(_Val, _Other);
+		_High = _Lanes::_High(_Val, _Other);
+		return _mm_unpacklo_epi64(_mm_unpacklo_epi32(_Low, _High), _mm_unpackhi_epi32(_Low, _High));
+	}
+
+	// Merges two sorted vectors, the first 4 values of the merge go to _Left and the last 4 to _Right
+	template<typename _Lanes>
+	inline void _Vec_bitonic_merge(__m128i& _Left, __m128i& _Right)
+	{
+		_Right = _mm_shuffle_epi32(_Right, _MM_SHUFFLE(0, 1, 2, 3));
+		_Vec_exchange<_Lanes>(_Left, _Right);
+		_Left = _Vec_bitonic_sort<_Lanes>(_Left);
+		_Right = _Vec_bitonic_sort<_Lanes>(_Right);
+	}
+
+	// Merges the sorted runs [_Heads[_Run], _Ends[_Run]) to _Dest one value at a time
+	template<typename _Lanes, typename _El, size_t _Runs>
+	inline _El *_Scalar_merge(const _El *(&_Heads)[_Runs], const _El *const (&_Ends)[_Runs], _El *_Dest)
+	{
+		for (;; ++_Dest)
+		{
+			size_t _First = _Runs;
+			for (size_t _Run = 0; _Run < _Runs; ++_Run)
+			{
+				if (_Heads[_Run] != _Ends[_Run] && (_First == _Runs || _Lanes::_Before(*_Heads[_Run], *_Heads[_First])))
+					_First = _Run;
+			}
+
+			if (_First == _Runs)
+				return _Dest;
+			*_Dest = *_Heads[_First]++;
+		}
+	}
+
+	// Merges two sorted runs of 4 values at least to _Dest. The next vector of the run with the first head is
+	// merged with the last 4 values of the merge before, until a run has less than a vector left.
+	template<typename _Lanes, typename _El>
+	inline void _Vec_merge(const _El *_First1, const _El *_Last1, const _El *_First2, const _El *_Last2, _El *_Dest)
+	{
+		__m128i _Low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_First1));
+		__m128i _High = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_First2));
+		_First1 += 4;
+		_First2 += 4;
+
+		for (;;)
+		{
+			_Vec_bitonic_merge<_Lanes>(_Low, _High);
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(_Dest), _Low);
+			_Dest += 4;
+
+			if (_Last1 - _First1 < 4 || _Last2 - _First2 < 4)
+				break;
+
+			const _El *&_Next = _Lanes::_Before(*_First2, *_First1) ? _First2 : _First1;
+			_Low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(_Next));
+			_Next += 4;
+		}
+
+		_El _Left_over[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(_Left_over), _High);
+
+		const _El *_Heads[3] = { _Left_over, _First1, _First2 };
+		const _El *const _Ends[3] = { _Left_over + 4, _Last1, _Last2 };
+		_Scalar_merge<_Lanes>(_Heads, _Ends, _Dest);
+	}
+
+	// Sorts the _Size values at _First, _Buf holds as many
+	template<typename _Lanes, typename _El>
+	inline void _Vec_leaf_sort(_El *_First, size_t _Size, _El *_Buf)
+	{
+		// The values past the last 16 are one sorted run, and so are all of its parts
+		const size_t _Blocks_end = _Size / 16 * 16;
+		for (size_t _I = 0; _I < _Blocks_end; _I += 16)
+			_Vec_sort_runs<_Lanes>(_First + _I);
+		std::sort(_First + _Blocks_end, _First + _Size, &_Lanes::_Before);
+
+		_El *_From = _First, *_To = _Buf;
+		for (size_t _Width = 4; _Width < _Size; _Width *= 2)
+		{
+			for (size_t _Begin = 0; _Begin < _Size; _Begin += 2 * _Width)
+			{
+				const size_t _Mid = (std::min)(_Begin + _Width, _Size), _End = (std::min)(_Begin + 2 * _Width, _Size);
+				if (_End - _Mid < 4)
+				{
+					const _El *_Heads[2] = { _From + _Begin, _From + _Mid };
+					const _El *const _Ends[2] = { _From + _Mid, _From + _End };
+					_Scalar_merge<_Lanes>(_Heads, _Ends, _To + _Begin);
+				}
+				else
+					_Vec_merge<_Lanes>(_From + _Begin, _From + _Mid, _From + _Mid, _From + _End, _To + _Begin);
+			}
+
+			std::swap(_From, _To);
+		}
+
+		if (_From != _First)
+			std::memcpy(_First, _From, _Size * sizeof(_El));
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline bool _Vector_leaf_sort(_RanIt _First, size_t _Size, _Pr&, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _El;
+		typedef _Sort_lanes<_El, _Radix_order<_Pr, _El>::_Descending> _Lanes;
+
+		if (_Size < 16 || _Size > _Vector_sort_max)
+			return false;
+
+		if (_Size <= _Vector_sort_stack)
+		{
+			_El _Buf[_Vector_sort_stack];
+			_Vec_leaf_sort<_Lanes>(_Unwrap_contiguous(_First), _Size, _Buf);
+			return true;
+		}
+
+		_Uninitialized_buffer<_El> _Buffer;
+		try
+		{
+			_Buffer._Reserve(_Size);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return false;
+		}
+
+		_Vec_leaf_sort<_Lanes>(_Unwrap_contiguous(_First), _Size, _Buffer.get());
+		return true;
+	}
+#endif // _EXP_SSE2
+
+	// The sequential sorts of the leaves of the parallel sorts
+	template<typename _RanIt, typename _Pr>
+	inline void _Leaf_sort(_RanIt _First, _RanIt _Last, _Pr& _Pred)
+	{
+		if (!_Vector_leaf_sort(_First, _Last - _First, _Pred, _Is_vector_sortable<_RanIt, _Pr>()))
+			std::sort(_First, _Last, _Pred);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Leaf_stable_sort(_RanIt _First, _RanIt _Last, _Pr& _Pred)
+	{
+		if (!_Vector_leaf_sort(_First, _Last - _First, _Pred, _Is_vector_sortable<_RanIt, _Pr>()))
+			std::stable_sort(_First, _Last, _Pred);
+	}
+
 	template<typename _Random_iterator, typename _Function>
 	void _Parallel_quicksort_impl(const _Random_iterator &_Begin, size_t _Size, _Function &_Func, size_t _Div_num, const size_t _Chunk_size, int _Depth)
 	{
 		if (_Depth >= _SortMaxRecursionDepth || _Size <= _Chunk_size || _Size <= static_cast<size_t>(3) || _Chunk_size >= _SortChunkSize && _Div_num <= 1)
 		{
-			return std::sort(_Begin, _Begin + _Size, _Func);
+			return _Leaf_sort(_Begin, _Begin + _Size, _Func);
 		}
 
 		// Determine whether we need to do a three-way quick sort
@@ -191,6 +460,14 @@ namespace details
 
 		std::swap(*_Begin, _Begin[--_I]);
 
+		// A split this uneven means the pivot selection met a pattern it keeps falling for, scramble
+		// both sides so the next pivots come from elsewhere
+		if ((std::min)(_I, _Size - _J) < _Size / 8)
+		{
+			_Break_patterns(_Begin, _I);
+			_Break_patterns(_Begin + _J, _Size - _J);
+		}
+
 		TaskGroup _Tg;
 		volatile size_t _Next_div = _Div_num / 2;
 		auto _Handle = make_task([&]
@@ -220,14 +497,14 @@ namespace details
 			return std::partial_sort(begin, begin + sortSize, begin + size, func);
 
 		if (sortSize == size)
-			_Parallel_quicksort_impl(begin, size, func, _Div_num, chunkSize, depth);
+			return _Parallel_quicksort_impl(begin, size, func, _Div_num, chunkSize, depth);
 		else if (size - sortSize == 1)
 		{
 			std::iter_swap(max_element(par, begin, begin + size, func), begin + (size - 1));
-			_Parallel_quicksort_impl(begin, size - 1, func, _Div_num, chunkSize, depth);
+			return _Parallel_quicksort_impl(begin, size - 1, func, _Div_num, chunkSize, depth);
 		}
 		else if (sortSize == 1)
-			std::iter_swap(min_element(par, begin, begin + size, func), begin);
+			return std::iter_swap(min_element(par, begin, begin + size, func), begin);
 
 		// Go for general case
 		bool isThreeWay = false;
@@ -259,13 +536,11 @@ namespace details
 		size_t firstRangeSize = midItr - begin;
 		if (firstRangeSize <= sortSize)
 		{
-#pragma warning(push)
-			// nonstandard extension used : 'argument' : conversion from 
-#pragma warning(disable: 4239)
-			tg.run(make_task([&] {
+			// The chore has to outlive the wait
+			auto handle = make_task([&] {
 				_Parallel_quicksort_impl(begin, firstRangeSize, func, _Div_num, chunkSize, depth + 1);
-			}));
-#pragma warning(pop)
+			});
+			tg.run(handle);
 
 			if (firstRangeSize < sortSize)
 				parallel_partialsort_impl(midItr, sortSize - firstRangeSize, size - firstRangeSize, func, _Div_num / 2, chunkSize, depth + 1);
@@ -290,7 +565,7 @@ namespace details
 
 		if (_Div_num <= 1 || _Size <= _Chunk_size)
 		{
-			std::stable_sort(_Begin, _Begin + _Size, _Func);
+			_Leaf_stable_sort(_Begin, _Begin + _Size, _Func);
 
 			// In case _Size <= _Chunk_size happened BEFORE the planned stop time (when _Div_num == 1) we need to calculate how many turns of 
 			// binary divisions are left. If there are an odd number of turns left, then the buffer move is necessary to make sure the final 
@@ -328,11 +603,11 @@ namespace details
 
 			if (_Is_buffer_swap)
 			{
-				_Parallel_merge(_Output, _Mid, _Output + _Mid, _Size - _Mid, _Begin, _Func, _Div_num);
+				_Parallel_move_merge(_Output, _Mid, _Output + _Mid, _Size - _Mid, _Begin, _Func, _Div_num);
 			}
 			else
 			{
-				_Parallel_merge(_Begin, _Mid, _Begin + _Mid, _Size - _Mid, _Output, _Func, _Div_num);
+				_Parallel_move_merge(_Begin, _Mid, _Begin + _Mid, _Size - _Mid, _Output, _Func, _Div_num);
 			}
 
 			return !_Is_buffer_swap;
@@ -340,230 +615,1676 @@ namespace details
 	}
 
 	//
-	// Sort
+	// Radix sort
 	//
-	template<typename _RanIt, typename _Pr, class _IterCat>
-	inline void _Sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat)
+	// Arithmetic values ordered by std::less or std::greater are sorted without comparisons, one pass per
+	// byte of their key, the least significant first. A pass counts the digits of each block in parallel,
+	// prefix sums the counts into the place of each block's run of every digit, then scatters the blocks
+	// in parallel. The passes are stable, so each one keeps the order of the ones before.
+	const size_t _Radix_digit_bits = 8;
+	const size_t _Radix_buckets = size_t{ 1 } << _Radix_digit_bits;
+
+	// Ranges smaller than this are sorted faster by the quicksort, which needs no buffer
+	const size_t _Radix_sort_min_size = 1 << 16;
+
+	template<size_t _Size> struct _Radix_unsigned;
+	template<> struct _Radix_unsigned<1> { typedef uint8_t type; };
+	template<> struct _Radix_unsigned<2> { typedef uint16_t type; };
+	template<> struct _Radix_unsigned<4> { typedef uint32_t type; };
+	template<> struct _Radix_unsigned<8> { typedef uint64_t type; };
+
+	// Maps a value to an unsigned key whose order is the order of std::less on the values
+	template<typename _Ty, bool _IsFloat = std::is_floating_point<_Ty>::value>
+	struct _Radix_key
 	{
-		_EXP_TRY
-			std::sort(_First, _Last, _Pred);
-		_EXP_RETHROW
-	}
+		typedef typename std::make_unsigned<_Ty>::type _Key_type;
+
+		static _Key_type _Get(_Ty _Val)
+		{
+			// Signed values sort after their sign bit is flipped
+			const _Key_type _Sign = std::is_signed<_Ty>::value ? static_cast<_Key_type>(_Key_type{ 1 } << (sizeof(_Key_type) * CHAR_BIT - 1)) : 0;
+			return static_cast<_Key_type>(static_cast<_Key_type>(_Val) ^ _Sign);
+		}
+	};
 
-	template<class _ExPolicy, typename _FwdIt, typename _Pr, class _IterCat>
-	inline typename _enable_if_parallel<_ExPolicy, void>::type _Sort_impl(const _ExPolicy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	template<typename _Ty>
+	struct _Radix_key<_Ty, true>
 	{
-		// Check for cancellation before the algorithm starts.
-		size_t _Size = _Last - _First;
-		size_t _Core_num = get_hardware_concurrency();
-		const size_t _ChunkSize = 2048; // Default chunk size
+		typedef typename _Radix_unsigned<sizeof(_Ty)>::type _Key_type;
 
-		if (_Size <= _ChunkSize || _Core_num < 2)
+		static _Key_type _Get(_Ty _Val)
 		{
-			return std::sort(_First, _Last, _Pred);
+			// IEEE 754: negative values sort reversed, below the positive ones
+			const _Key_type _Sign = static_cast<_Key_type>(_Key_type{ 1 } << (sizeof(_Key_type) * CHAR_BIT - 1));
+			_Key_type _Bits;
+			std::memcpy(&_Bits, &_Val, sizeof(_Bits));
+			return (_Bits & _Sign) != 0 ? static_cast<_Key_type>(~_Bits) : static_cast<_Key_type>(_Bits | _Sign);
 		}
+	};
 
-		_Parallel_quicksort_impl(_First, _Size, _Pred, _Core_num * _SortMaxTasksPerCore, _ChunkSize, 0);
-	}
-
-	template<typename _RanIt, typename _Pr, class _IterCat>
-	inline void _Sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
+	// The comparators the radix sort stands in for and the direction they sort in
+	template<typename _Pr, typename _Ty>
+	struct _Radix_order : std::false_type
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Sort_impl, _Policy, _First, _Last, _Pred, _Cat);
-	}
+		static const bool _Descending = false;
+	};
 
-	//
-	// partial_sort
-	//
-	template<typename _RanIt, typename _Pr, class _IterCat>
-	inline void _Partial_sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat)
+	template<typename _Ty>
+	struct _Radix_order<std::less<_Ty>, _Ty> : std::true_type
 	{
-		_EXP_TRY
-			std::partial_sort(_First, _Mid, _Last, _Pred);
-		_EXP_RETHROW
-	}
+		static const bool _Descending = false;
+	};
 
-	template<class _ExPolicy, typename _RanIt, typename _Pr, class _IterCat>
-	inline typename _enable_if_parallel<_ExPolicy, void>::type _Partial_sort_impl(const _ExPolicy&, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat)
+	template<typename _Ty>
+	struct _Radix_order<std::less<>, _Ty> : std::true_type
 	{
-		// Check for cancellation before the algorithm starts.
-		const size_t _ChunkSize = 2048; // Default chunk size
-		size_t _Core_num = get_hardware_concurrency();
-		size_t _Size = _Last - _First;
-
-		// Don't need to do anything if the sort range is empty
-		if (_Mid == _First)
-			return;
-
-		if (_Size <= _ChunkSize || _Core_num < 2)
-		{
-			return std::partial_sort(_First, _Mid, _Last, _Pred);
-		}
+		static const bool _Descending = false;
+	};
 
-		parallel_partialsort_impl(_First, _Mid - _First, _Size, _Pred, _Core_num * _SortMaxTasksPerCore, _ChunkSize, 0);
-	}
+	template<typename _Ty>
+	struct _Radix_order<std::greater<_Ty>, _Ty> : std::true_type
+	{
+		static const bool _Descending = true;
+	};
 
-	template<typename _RanIt, typename _Pr, class _IterCat>
-	inline void _Partial_sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
+	template<typename _Ty>
+	struct _Radix_order<std::greater<>, _Ty> : std::true_type
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Partial_sort_impl, _Policy, _First, _Mid, _Last, _Pred, _Cat)
-	}
+		static const bool _Descending = true;
+	};
 
-	//
-	// stable_sort
-	//
-	template<class _RanIt, class _Pr, class _IterCat>
-	inline void _Stable_sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat)
+	template<typename _Ty, typename _Pr>
+	struct _Is_radix_sortable : std::integral_constant<bool,
+		std::is_arithmetic<_Ty>::value && !std::is_same<_Ty, bool>::value && _Radix_order<_Pr, _Ty>::value
+		&& (!std::is_floating_point<_Ty>::value || sizeof(_Ty) == 4 || sizeof(_Ty) == 8)>
 	{
-		_EXP_TRY
-			std::stable_sort(_First, _Last, _Pred);
-		_EXP_RETHROW
-	}
+	};
 
-	template<class _ExPolicy, class _RanIt, class _Pr, class _IterCat>
-	inline void _Stable_sort_impl(const _ExPolicy&, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat)
+	template<typename _RanIt>
+	class _Parallel_radix_sort
 	{
-		// Check cancellation before the algorithm starts.
-		size_t _Size = _Last - _First;
-		size_t _Core_num = get_hardware_concurrency();
-		const size_t _Chunk_size = 2048;
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+		typedef typename _Radix_key<_Value_type>::_Key_type _Key_type;
 
-		if (_Size <= _Chunk_size || _Core_num < 2)
+		_RanIt _First;
+		size_t _Size;
+		size_t _Blocks;
+		_Key_type _Flip; // all ones to sort descending
+		std::unique_ptr<_Value_type[]> _Buffer;
+		std::vector<size_t> _Counts; // _Radix_buckets per block, then the place of each run
+
+		_Parallel_radix_sort(const _Parallel_radix_sort&);
+		_Parallel_radix_sort& operator=(const _Parallel_radix_sort&);
+
+		size_t _Block_begin(size_t _Block) const
 		{
-			return std::stable_sort(_First, _Last, _Pred);
+			return _Size / _Blocks * _Block + (std::min)(_Block, _Size % _Blocks);
 		}
-		const static size_t CORE_NUM_MASK = 0x55555555;
 
-		// 4 times overload on each core
-		_Core_num *= 4;
+		size_t _Digit(const _Value_type& _Val, size_t _Shift) const
+		{
+			return static_cast<size_t>(static_cast<_Key_type>(_Radix_key<_Value_type>::_Get(_Val) ^ _Flip) >> _Shift) & (_Radix_buckets - 1);
+		}
 
-		auto _Holder = std::make_unique<typename std::iterator_traits<_RanIt>::value_type []>(_Size);
+		// Returns false if all the values share the digit, the pass would not move them
+		template<typename _SrcIt, typename _DestIt>
+		bool _Pass(_SrcIt _Src, _DestIt _Dest, size_t _Shift)
+		{
+			_Run_blocks(_Blocks, [this, _Src, _Shift](size_t _Block) {
+				size_t *_Count = _Counts.data() + _Block * _Radix_buckets;
+				std::fill(_Count, _Count + _Radix_buckets, size_t{ 0 });
 
-		// This buffered sort algorithm will divide chunks and apply parallel quicksort on each chunk. In the end, it will 
-		// apply parallel merge to these sorted chunks.
-		// 
-		// We need to decide on the number of chunks to divide the input buffer into. If we divide it into n chunks, log(n) 
-		// merges will be needed to get the final sorted result. In this algorithm, we have two buffers for each merge 
-		// operation, let's say buffer A and B. Buffer A is the original input array, buffer B is the additional allocated 
-		// buffer. Each turn's merge will put the merge result into the other buffer; for example, if we decided to split 
-		// into 8 chunks in buffer A at very beginning, after one pass of merging, there will be 4 chunks in buffer B.
-		// If we apply one more pass of merging, there will be 2 chunks in buffer A again.
-		// 
-		// The problem is we want to the final merge pass to put the result back in buffer A, so that we don't need 
-		// one extra copy to put the sorted data back to buffer A.
-		// To make sure the final result is in buffer A (original input array), we need an even number of merge passes,
-		// which means log(n) must be an even number. Thus n must be a number power(2, even number). For example, when the
-		// even number is 2, n is power(2, 2) = 4, when even number is 4, n is power(2, 4) = 16. When we divide chunks 
-		// into these numbers, the final merge result will be in the original input array. Now we need to decide the chunk(split) 
-		// number based on this property and the number of cores.
-		// 
-		// We want to get a chunk (split) number close to the core number (or a little more than the number of cores), 
-		// and it also needs to satisfy above property. For a 8 core machine, the best chunk number should be 16, because it's 
-		// the smallest number that satisfies the above property and is bigger than the core number (so that we can utilize all 
-		// cores, a little more than core number is OK, we need to split more tasks anyway). 
-		// 
-		// In this algorithm, we will make this alignment by bit operations (it's easy and clear). For a binary representation, 
-		// all the numbers that satisfy power(2, even number) will be 1, 100, 10000, 1000000, 100000000 ...
-		// After OR-ing these numbers together, we will get a mask (... 0101 0101 0101) which is all possible combinations of 
-		// power(2, even number). We use _Core_num & CORE_NUM_MASK | _Core_num << 1 & CORE_NUM_MASK, a bit-wise operation to align 
-		// _Core_num's highest bit into a power(2, even number).
-		// 
-		// It means if _Core_num = 8, the highest bit in binary is bin(1000) which is not power(2, even number). After this 
-		// bit-wise operation, it will align to bin(10000) = 16 which is power(2, even number). If the _Core_num = 16, after 
-		// alignment it still returns 16. The trick is to make sure the highest bit of _Core_num will align to the "1" bit of the 
-		// mask bin(... 0101 0101 0101) We don't care about the other bits on the aligned result except the highest bit, because they 
-		// will be ignored in the function.
-		_Parallel_buffered_sort_impl(_First, _Size, stdext::make_unchecked_array_iterator(_Holder.get()),
-			_Pred, _Core_num & CORE_NUM_MASK | _Core_num << 1 & CORE_NUM_MASK, _Chunk_size);
-	}
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+					++_Count[_Digit(_Src[_I], _Shift)];
+			});
 
-	template<class _ExPolicy, class _RanIt, class _Pr>
-	inline void _Stable_sort_impl(const _ExPolicy&, _RanIt _First, _RanIt _Last, _Pr _Pred, std::input_iterator_tag _Cat)
-	{
-		_Stable_sort_impl(seq, _First, _Last, _Pred, _Cat);
-	}
+			size_t _Place = 0;
+			for (size_t _Bucket = 0; _Bucket < _Radix_buckets; ++_Bucket)
+			{
+				const size_t _Bucket_place = _Place;
+				for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+				{
+					size_t& _Count = _Counts[_Block * _Radix_buckets + _Bucket];
+					const size_t _Run = _Count;
+					_Count = _Place;
+					_Place += _Run;
+				}
 
-	template<class _RanIt, class _Pr, class _IterCat>
-	inline void _Stable_sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
-	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Stable_sort_impl, _Policy, _First, _Last, _Pred, _Cat);
-	}
+				if (_Place - _Bucket_place == _Size)
+					return false;
+			}
+
+			_Run_blocks(_Blocks, [this, _Src, _Dest, _Shift](size_t _Block) {
+				size_t _Place[_Radix_buckets];
+				std::copy(_Counts.data() + _Block * _Radix_buckets, _Counts.data() + (_Block + 1) * _Radix_buckets, _Place);
+
+				for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+					_Dest[_Place[_Digit(_Src[_I], _Shift)]++] = std::move(_Src[_I]);
+			});
+
+			return true;
+		}
+
+	public:
+		_Parallel_radix_sort(_RanIt _Begin, size_t _Count, size_t _Block_count, bool _Descending) :
+			_First(_Begin), _Size(_Count), _Blocks(_Block_count), _Flip(_Descending ? static_cast<_Key_type>(~_Key_type{ 0 }) : _Key_type{ 0 }),
+			_Buffer(new _Value_type[_Count]), _Counts(_Block_count * _Radix_buckets)
+		{
+		}
+
+		void _Sort()
+		{
+			_Value_type *_Buf = _Buffer.get();
+			bool _In_buffer = false;
+
+			for (size_t _Shift = 0; _Shift < sizeof(_Key_type) * CHAR_BIT; _Shift += _Radix_digit_bits)
+			{
+				if (_In_buffer ? _Pass(_Buf, _First, _Shift) : _Pass(_First, _Buf, _Shift))
+					_In_buffer = !_In_buffer;
+			}
+
+			if (_In_buffer)
+			{
+				_Run_blocks(_Blocks, [this, _Buf](size_t _Block) {
+					std::move(_Buf + _Block_begin(_Block), _Buf + _Block_begin(_Block + 1), _First + _Block_begin(_Block));
+				});
+			}
+		}
+	};
 
 	//
-	// partial_sort_copy
+	// Sample sort
 	//
-	// partial_sort_copy always fallback to sequential since heap_sort is not able to be parallelized
-	template<class _ExPolicy, class _InIt, class _RanIt, class _Pr>
-	inline _RanIt _Partial_sort_copy_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2, _Pr _Pred)
+	// The quicksort partitions the whole range on one thread before it splits, which caps its speedup on
+	// machines with many cores. The sample sort picks the splitters of one bucket per task from a sorted
+	// sample, then classifies the blocks, scatters them into their buckets and sorts the buckets, each step
+	// in parallel.
+	const size_t _Sample_sort_min_threads = 16;
+	const size_t _Sample_sort_min_size = 1 << 20;
+
+	// Buckets per thread, a thread stuck with a larger bucket is balanced by the others
+	const size_t _Sample_sort_buckets_per_thread = 2;
+
+	// Sample values per bucket, the more the closer the buckets are to the same size
+	const size_t _Sample_sort_oversampling = 32;
+
+	// The scatter constructs the values in raw storage and moves them back, moves that can't throw keep
+	// the range whole if the comparator throws
+	template<typename _Ty>
+	struct _Is_sample_sortable : std::integral_constant<bool,
+		std::is_copy_constructible<_Ty>::value && std::is_nothrow_move_constructible<_Ty>::value && std::is_nothrow_move_assignable<_Ty>::value>
 	{
-		_EXP_TRY
-			return std::partial_sort_copy(_First, _Last, _First2, _Last2, _Pred);
-		_EXP_RETHROW
-	}
+	};
 
-	template<class _InIt, class _RanIt, class _Pr>
-	inline _RanIt _Partial_sort_copy_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2, _Pr _Pred)
+	template<typename _RanIt, typename _Pr>
+	class _Parallel_sample_sort
 	{
-		_EXP_GENERIC_EXECUTION_POLICY(_Partial_sort_copy_impl, _Policy, _First, _Last, _First2, _Last2, _Pred);
-	}
-}  //details
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+		typedef uint16_t _Bucket_type;
+
+		_RanIt _First;
+		size_t _Size;
+		_Pr& _Pred;
+		size_t _Core_num;
+		size_t _Blocks;
+		size_t _Buckets;
+		std::vector<_Value_type> _Splitters;
+		_Uninitialized_buffer<_Bucket_type> _Bucket_of;
+		std::vector<size_t> _Counts; // _Buckets per block, then the place of each run
+		std::vector<size_t> _Bucket_begin;
+
+		_Parallel_sample_sort(const _Parallel_sample_sort&);
+		_Parallel_sample_sort& operator=(const _Parallel_sample_sort&);
+
+		size_t _Block_begin(size_t _Block) const
+		{
+			return _Size / _Blocks * _Block + (std::min)(_Block, _Size % _Blocks);
+		}
 
-template<class _ExPolicy, class _RanIt, class _Pr>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred)
-{
-	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+		void _Select_splitters()
+		{
+			// Spread the sample with a fixed seed, an input with a period can't defeat it and runs repeat
+			std::minstd_rand _Gen(static_cast<std::minstd_rand::result_type>(_Size));
+			std::uniform_int_distribution<size_t> _Pos(0, _Size - 1);
 
-	details::_Sort_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
-}
+			std::vector<_Value_type> _Sample;
+			_Sample.reserve(_Buckets * _Sample_sort_oversampling);
+			for (size_t _I = 0; _I < _Buckets * _Sample_sort_oversampling; ++_I)
+				_Sample.push_back(_First[_Pos(_Gen)]);
 
-template<class _ExPolicy, class _RanIt>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last)
-{
-	sort(std::forward<_ExPolicy>(_Policy), _First, _Last, std::less<>());
-}
+			std::sort(_Sample.begin(), _Sample.end(), _Pred);
 
-template<class _ExPolicy, class _RanIt, class _Pr>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type partial_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred)
-{
-	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+			_Splitters.reserve(_Buckets - 1);
+			for (size_t _Bucket = 1; _Bucket < _Buckets; ++_Bucket)
+				_Splitters.push_back(_Sample[_Bucket * _Sample_sort_oversampling]);
+		}
 
-	details::_Partial_sort_impl(_Policy, _First, _Mid, _Last, _Pred, std::_Iter_cat(_First));
-}
+		void _Classify(size_t _Block)
+		{
+			size_t *_Count = _Counts.data() + _Block * _Buckets;
+			std::fill(_Count, _Count + _Buckets, size_t{ 0 });
 
-template<class _ExPolicy, class _RanIt>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type partial_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last)
+			for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+			{
+				// Values equal to a splitter go to the bucket after it, all the copies of a value to the same bucket
+				const size_t _Bucket = std::upper_bound(_Splitters.begin(), _Splitters.end(), _First[_I], _Pred) - _Splitters.begin();
+				_Bucket_of.get()[_I] = static_cast<_Bucket_type>(_Bucket);
+				++_Count[_Bucket];
+			}
+		}
+
+		void _Place_runs()
+		{
+			size_t _Place = 0;
+			for (size_t _Bucket = 0; _Bucket < _Buckets; ++_Bucket)
+			{
+				_Bucket_begin[_Bucket] = _Place;
+				for (size_t _Block = 0; _Block < _Blocks; ++_Block)
+				{
+					size_t& _Count = _Counts[_Block * _Buckets + _Bucket];
+					const size_t _Run = _Count;
+					_Count = _Place;
+					_Place += _Run;
+				}
+			}
+
+			_Bucket_begin[_Buckets] = _Place;
+		}
+
+		void _Scatter(size_t _Block, _Value_type *_Buf)
+		{
+			size_t *_Place = _Counts.data() + _Block * _Buckets;
+			for (size_t _I = _Block_begin(_Block), _End = _Block_begin(_Block + 1); _I < _End; ++_I)
+				::new (static_cast<void *>(_Buf + _Place[_Bucket_of.get()[_I]]++)) _Value_type(std::move(_First[_I]));
+		}
+
+		void _Sort_bucket(size_t _Bucket, _Value_type *_Buf)
+		{
+			const size_t _Begin = _Bucket_begin[_Bucket], _End = _Bucket_begin[_Bucket + 1];
+			for (size_t _I = _Begin; _I < _End; ++_I)
+			{
+				_First[_I] = std::move(_Buf[_I]);
+				_Buf[_I].~_Value_type();
+			}
+
+			// Many copies of a splitter can fill a bucket way past its share, it is split again
+			const size_t _Len = _End - _Begin;
+			if (_Len > 4 * (_Size / _Buckets))
+				_Parallel_quicksort_impl(_First + _Begin, _Len, _Pred, _Core_num * _SortMaxTasksPerCore, _SortChunkSize * 4, 0);
+			else
+				_Leaf_sort(_First + _Begin, _First + _End, _Pred);
+		}
+
+	public:
+		_Parallel_sample_sort(_RanIt _Begin, size_t _Count, _Pr& _Func, size_t _Threads) :
+			_First(_Begin), _Size(_Count), _Pred(_Func), _Core_num(_Threads), _Blocks(_Threads),
+			_Buckets((std::min)(_Threads * _Sample_sort_buckets_per_thread, static_cast<size_t>((std::numeric_limits<_Bucket_type>::max)()))),
+			_Bucket_of(_Count), _Counts(_Blocks * _Buckets), _Bucket_begin(_Buckets + 1)
+		{
+		}
+
+		void _Sort()
+		{
+			_Uninitialized_buffer<_Value_type> _Buffer(_Size);
+			_Value_type *_Buf = _Buffer.get();
+
+			_Select_splitters();
+			_Run_blocks(_Blocks, [this](size_t _Block) { _Classify(_Block); });
+			_Place_runs();
+			_Run_blocks(_Blocks, [this, _Buf](size_t _Block) { _Scatter(_Block, _Buf); });
+			_Run_blocks(_Buckets, [this, _Buf](size_t _Bucket) { _Sort_bucket(_Bucket, _Buf); });
+		}
+	};
+
+	// Sorts with the sample sort when the machine and the range are large enough, with the quicksort otherwise
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_comparison_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t _ChunkSize)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		if (_Is_sample_sortable<_Value_type>::value && _Core_num >= _Sample_sort_min_threads && _Size >= _Sample_sort_min_size)
+		{
+			std::unique_ptr<_Parallel_sample_sort<_RanIt, _Pr>> _Sample;
+			try {
+				_Sample.reset(new _Parallel_sample_sort<_RanIt, _Pr>(_First, _Size, _Pred, _Core_num));
+			}
+			catch (const std::bad_alloc&) {
+				// No room for the bucket of each value, the quicksort sorts in place
+			}
+
+			if (_Sample)
+			{
+				try {
+					return _Sample->_Sort();
+				}
+				catch (const std::bad_alloc&) {
+					// No room for the scatter buffer, nothing was moved yet
+				}
+			}
+		}
+
+		_Parallel_quicksort_impl(_First, _Size, _Pred, _Core_num * _SortMaxTasksPerCore, _ChunkSize, 0);
+	}
+
+	//
+	// String sort
+	//
+	// Strings ordered by std::less are sorted by an MSD radix sort on 8 bytes of their characters at a time. The
+	// sort works on compact entries of the next 8 bytes of a string, big endian so they compare as integers, its
+	// length past them and its index, no string is moved or compared from its start while sorting. The entries
+	// are sorted by their cached bytes, then every run of equal entries longer than them is loaded with the next
+	// 8 bytes and sorted again, the runs in parallel. At the end the strings are moved once to their place.
+	template<typename _Ch>
+	struct _Is_string_sort_char : std::integral_constant<bool,
+		std::is_same<_Ch, char>::value || std::is_same<_Ch, wchar_t>::value || std::is_same<_Ch, char16_t>::value || std::is_same<_Ch, char32_t>::value>
+	{
+	};
+
+	template<typename _Ty, typename _Pr>
+	struct _Is_string_sortable : std::false_type
+	{
+	};
+
+	template<typename _Ch, typename _Alloc>
+	struct _Is_string_sortable<std::basic_string<_Ch, std::char_traits<_Ch>, _Alloc>, std::less<>> : _Is_string_sort_char<_Ch>
+	{
+	};
+
+	template<typename _Ch, typename _Alloc>
+	struct _Is_string_sortable<std::basic_string<_Ch, std::char_traits<_Ch>, _Alloc>, std::less<std::basic_string<_Ch, std::char_traits<_Ch>, _Alloc>>> : _Is_string_sort_char<_Ch>
+	{
+	};
+
+#if _HAS_CXX17
+	template<typename _Ch>
+	struct _Is_string_sortable<std::basic_string_view<_Ch>, std::less<>> : _Is_string_sort_char<_Ch>
+	{
+	};
+
+	template<typename _Ch>
+	struct _Is_string_sortable<std::basic_string_view<_Ch>, std::less<std::basic_string_view<_Ch>>> : _Is_string_sort_char<_Ch>
+	{
+	};
+#endif
+
+	struct _String_sort_tag
+	{
+	};
+
+	// Runs shorter than this are sorted by comparing the strings past the bytes they share
+	const size_t _String_sort_direct_size = 16;
+
+	// Runs that split this many times are sorted by comparing the strings too, the recursion stays shallow
+	const size_t _String_sort_max_levels = 32;
+
+	template<typename _RanIt>
+	class _Parallel_string_sort
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _String;
+		typedef typename _String::value_type _Char;
+		typedef typename std::make_unsigned<_Char>::type _Unit_type;
+
+		static const size_t _Units = sizeof(uint64_t) / sizeof(_Char);
+		static const size_t _Unit_bits = sizeof(_Char) * CHAR_BIT;
+
+		struct _Entry
+		{
+			uint64_t _Key; // the _Units characters from the depth of the run, zeros past the end
+			size_t _Length; // the characters from the depth, _Units + 1 for all the longer ones
+			size_t _Index;
+		};
+
+		struct _Entry_less
+		{
+			bool operator()(const _Entry& _Left, const _Entry& _Right) const
+			{
+				return _Left._Key < _Right._Key || (_Left._Key == _Right._Key && _Left._Length < _Right._Length);
+			}
+		};
+
+		// The permutation the entries make, for _Apply_permutation
+		struct _Entry_indices
+		{
+			const _Entry *_Entries;
+
+			size_t operator[](size_t _I) const
+			{
+				return _Entries[_I]._Index;
+			}
+		};
+
+		struct _Run
+		{
+			size_t _Begin;
+			size_t _End;
+		};
+
+		// Orders the entries by their strings past the characters they share
+		struct _Entry_string_less
+		{
+			_RanIt _Strings;
+			size_t _Depth;
+
+			bool operator()(const _Entry& _Left, const _Entry& _Right) const
+			{
+				return _Compare_from(_Strings[_Left._Index], _Strings[_Right._Index], _Depth) < 0;
+			}
+		};
+
+		_RanIt _First;
+		size_t _Size;
+		size_t _Core_num;
+		size_t _Chunk_size;
+		_Uninitialized_buffer<_Entry> _Buffer;
+
+		_Parallel_string_sort(const _Parallel_string_sort&);
+		_Parallel_string_sort& operator=(const _Parallel_string_sort&);
+
+		// The signed wide characters order by their value, the bit flip keeps it for the unsigned keys
+		static uint64_t _Unit(_Char _Ch)
+		{
+			const _Unit_type _Sign = std::is_signed<_Char>::value && !std::is_same<_Char, char>::value ? static_cast<_Unit_type>(_Unit_type{ 1 } << (_Unit_bits - 1)) : 0;
+			return static_cast<uint64_t>(static_cast<_Unit_type>(static_cast<_Unit_type>(_Ch) ^ _Sign));
+		}
+
+		static void _Load_entry(_Entry& _Item, const _String& _Str, size_t _Depth)
+		{
+			const size_t _Left = _Str.size() - _Depth;
+			const _Char *_Chars = _Str.data() + _Depth;
+
+			uint64_t _Key = 0;
+			if (sizeof(_Char) == 1 && _Left >= _Units)
+			{
+				std::memcpy(&_Key, _Chars, sizeof(_Key));
+				_Key = _byteswap_uint64(_Key);
+			}
+			else
+			{
+				for (size_t _K = 0; _K < _Units; ++_K)
+					_Key = (_Key << _Unit_bits) | (_K < _Left ? _Unit(_Chars[_K]) : 0);
+			}
+
+			_Item._Key = _Key;
+			_Item._Length = (std::min)(_Left, _Units + 1);
+		}
+
+		static int _Compare_from(const _String& _Left, const _String& _Right, size_t _Depth)
+		{
+			const size_t _Left_size = _Left.size() - _Depth, _Right_size = _Right.size() - _Depth;
+			const int _Res = std::char_traits<_Char>::compare(_Left.data() + _Depth, _Right.data() + _Depth, (std::min)(_Left_size, _Right_size));
+			if (_Res != 0)
+				return _Res;
+			return _Left_size < _Right_size ? -1 : (_Left_size == _Right_size ? 0 : 1);
+		}
+
+		// Sorts the entries of [_Begin, _End), whose strings share their first _Depth characters. A level that leaves
+		// a single run goes on with it in the loop, a long common prefix doesn't deepen the recursion, neither do
+		// strings that drop out of the run one after the other. Past _String_sort_max_levels of runs that split the
+		// rest is sorted by comparing the strings.
+		void _Sort_run(size_t _Begin, size_t _End, size_t _Depth, size_t _Level)
+		{
+			if (_Level >= _String_sort_max_levels)
+				return _Sort_compared(_Begin, _End, _Depth);
+
+			std::vector<_Run> _Runs;
+			for (;; _Depth += _Units)
+			{
+				_Runs.clear();
+				if (_Sort_level(_Begin, _End, _Depth, _Runs) || _Runs.size() != 1)
+					break;
+
+				_Begin = _Runs[0]._Begin;
+				_End = _Runs[0]._End;
+			}
+
+			if (_Runs.empty())
+				return;
+
+			// The runs are dealt out round robin, the large ones sort in parallel themselves
+			const size_t _Tasks = _End - _Begin >= 4 * _Chunk_size ? (std::min)(_Core_num, _Runs.size()) : 1;
+			_Run_blocks(_Tasks, [&](size_t _Task) {
+				for (size_t _R = _Task; _R < _Runs.size(); _R += _Tasks)
+					_Sort_run(_Runs[_R]._Begin, _Runs[_R]._End, _Depth + _Units, _Level + 1);
+			});
+		}
+
+		void _Sort_compared(size_t _Begin, size_t _End, size_t _Depth)
+		{
+			_Entry *_Entries = _Buffer.get();
+			const size_t _Len = _End - _Begin;
+			_Entry_string_less _Pred = { _First, _Depth };
+			if (_Len >= 4 * _Chunk_size)
+				_Parallel_comparison_sort(_Entries + _Begin, _Len, _Pred, _Core_num, _Chunk_size);
+			else
+				std::sort(_Entries + _Begin, _Entries + _End, _Pred);
+		}
+
+		// Sorts the entries by the _Units characters from _Depth and appends the runs of them that need the next
+		// characters. Returns true if the run was sorted to the end by comparing its strings.
+		bool _Sort_level(size_t _Begin, size_t _End, size_t _Depth, std::vector<_Run>& _Runs)
+		{
+			_Entry *_Entries = _Buffer.get();
+			const size_t _Len = _End - _Begin;
+
+			if (_Len < _String_sort_direct_size)
+			{
+				std::sort(_Entries + _Begin, _Entries + _End, [this, _Depth](const _Entry& _Left, const _Entry& _Right) {
+					return _Compare_from(_First[_Left._Index], _First[_Right._Index], _Depth) < 0;
+				});
+				return true;
+			}
+
+			const bool _Parallel = _Len >= 4 * _Chunk_size;
+			const size_t _Blocks = _Parallel ? (std::min)(_Core_num, _Len / _Chunk_size) : 1;
+			_Run_blocks(_Blocks, [&](size_t _Block) {
+				for (size_t _I = _Begin + _Len * _Block / _Blocks, _Last = _Begin + _Len * (_Block + 1) / _Blocks; _I < _Last; ++_I)
+					_Load_entry(_Entries[_I], _First[_Entries[_I]._Index], _Depth);
+			});
+
+			_Entry_less _Pred;
+			if (_Parallel)
+				_Parallel_comparison_sort(_Entries + _Begin, _Len, _Pred, _Core_num, _Chunk_size);
+			else
+				std::sort(_Entries + _Begin, _Entries + _End, _Pred);
+
+			// The runs of equal entries past the end of none of their strings go on with the next characters
+			for (size_t _I = _Begin; _I < _End;)
+			{
+				size_t _Next = _I + 1;
+				while (_Next < _End && _Entries[_Next]._Key == _Entries[_I]._Key && _Entries[_Next]._Length == _Entries[_I]._Length)
+					++_Next;
+
+				if (_Next - _I > 1 && _Entries[_I]._Length > _Units)
+				{
+					const _Run _Equal = { _I, _Next };
+					_Runs.push_back(_Equal);
+				}
+				_I = _Next;
+			}
+
+			return false;
+		}
+
+	public:
+		_Parallel_string_sort(_RanIt _Begin, size_t _Count, size_t _Threads, size_t _Chunk) :
+			_First(_Begin), _Size(_Count), _Core_num(_Threads), _Chunk_size(_Chunk), _Buffer(_Count)
+		{
+		}
+
+		void _Sort()
+		{
+			_Entry *_Entries = _Buffer.get();
+			const size_t _Blocks = (std::max)((std::min)(_Core_num, _Size / _Chunk_size), size_t{ 1 });
+			_Run_blocks(_Blocks, [&](size_t _Block) {
+				for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+					_Entries[_I]._Index = _I;
+			});
+
+			_Sort_run(0, _Size, 0, 0);
+
+			const _Entry_indices _Indices = { _Entries };
+			_Apply_permutation(_First, _Size, _Indices, _Blocks, std::true_type());
+		}
+	};
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t _ChunkSize, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		if (_Size >= _Radix_sort_min_size)
+		{
+			// A block is at least a grain, and large enough next to the table of counts it fills and scans
+			const size_t _Blocks = (std::max)((std::min)(_Core_num, _Size / (std::max)(_ChunkSize, _Radix_buckets * 8)), size_t{ 1 });
+
+			std::unique_ptr<_Parallel_radix_sort<_RanIt>> _Radix;
+			try {
+				_Radix.reset(new _Parallel_radix_sort<_RanIt>(_First, _Size, _Blocks, _Radix_order<_Pr, _Value_type>::_Descending));
+			}
+			catch (const std::bad_alloc&) {
+				// No room for the buffer, the quicksort sorts in place
+			}
+
+			if (_Radix)
+				return _Radix->_Sort();
+		}
+
+		_Parallel_comparison_sort(_First, _Size, _Pred, _Core_num, _ChunkSize);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t _ChunkSize, std::false_type)
+	{
+		_Parallel_comparison_sort(_First, _Size, _Pred, _Core_num, _ChunkSize);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t _ChunkSize, _String_sort_tag)
+	{
+		std::unique_ptr<_Parallel_string_sort<_RanIt>> _Strings;
+		try {
+			_Strings.reset(new _Parallel_string_sort<_RanIt>(_First, _Size, _Core_num, _ChunkSize));
+		}
+		catch (const std::bad_alloc&) {
+			// No room for the entries, the comparison sort sorts in place
+		}
+
+		if (_Strings)
+			return _Strings->_Sort();
+
+		_Parallel_comparison_sort(_First, _Size, _Pred, _Core_num, _ChunkSize);
+	}
+
+	//
+	// Presorted ranges
+	//
+	// Ranges made of this many ascending runs or fewer are merged instead of sorted
+	const size_t _Sort_max_runs = 16;
+
+	// Adjacent pairs compared on the calling thread before a range is scanned for runs, a range with
+	// more descents than runs allowed among them is sorted right away
+	const size_t _Sort_probe_pairs = 64;
+
+	// Merges the sorted runs of the range in place, _Run_begin holds the offset of each run and the size
+	// of the range. The runs are merged pairwise, the pairs of a round of merges in parallel.
+	template<typename _RanIt, typename _Pr>
+	inline void _Merge_runs(_RanIt _First, std::vector<size_t>& _Run_begin, _Pr& _Pred, size_t _Core_num)
+	{
+		const size_t _Size = _Run_begin.back();
+		while (_Run_begin.size() > 2)
+		{
+			const size_t _Pairs = (_Run_begin.size() - 1) / 2;
+			const size_t _Div_num = (std::max)(_Core_num * 2 / _Pairs, size_t{ 1 });
+
+			_Run_blocks(_Pairs, [&](size_t _Pair) {
+				const size_t _Begin = _Run_begin[2 * _Pair], _Mid = _Run_begin[2 * _Pair + 1], _End = _Run_begin[2 * _Pair + 2];
+				_Parallel_buffered_inplace_merge(_First + _Begin, _Mid - _Begin, _End - _Mid, _Pred, _Div_num);
+			});
+
+			std::vector<size_t> _Merged;
+			for (size_t _I = 0; _I < _Run_begin.size(); _I += 2)
+				_Merged.push_back(_Run_begin[_I]);
+
+			if (_Merged.back() != _Size)
+				_Merged.push_back(_Size);
+
+			_Run_begin.swap(_Merged);
+		}
+	}
+
+	// Sorts the range if it is ascending, descending or a few ascending runs, returns false otherwise.
+	// The runs are found with the parallel is_sorted_until, then merged in place.
+	template<class _ExPolicy, typename _RanIt, typename _Pr>
+	inline bool _Sort_presorted(const _ExPolicy& _Policy, _RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		size_t _Descents = 0, _Ascents = 0;
+		for (size_t _I = 1, _Probe = (std::min)(_Size, _Sort_probe_pairs + 1); _I < _Probe; ++_I)
+		{
+			if (_Pred(_First[_I], _First[_I - 1]))
+				++_Descents;
+			else if (_Pred(_First[_I - 1], _First[_I]))
+				++_Ascents;
+		}
+
+		const _RanIt _Last = _First + _Size;
+		if (_Ascents == 0 && _Descents != 0)
+		{
+			// Equal values may come out in any order, reversing a descending range sorts it
+			auto _Greater = [&_Pred](const _Value_type& _Left, const _Value_type& _Right) { return _Pred(_Right, _Left); };
+			if (is_sorted_until(_Policy, _First, _Last, _Greater) == _Last)
+			{
+				reverse(_Policy, _First, _Last);
+				return true;
+			}
+		}
+
+		if (_Descents >= _Sort_max_runs)
+			return false;
+
+		std::vector<size_t> _Run_begin(1, 0);
+		for (_RanIt _Run = _First; ; )
+		{
+			_Run = is_sorted_until(_Policy, _Run, _Last, _Pred);
+			if (_Run == _Last)
+				break;
+
+			if (_Run_begin.size() == _Sort_max_runs)
+				return false;
+
+			_Run_begin.push_back(_Run - _First);
+		}
+
+		_Run_begin.push_back(_Size);
+		_Merge_runs(_First, _Run_begin, _Pred, _Core_num);
+		return true;
+	}
+
+	// Orders pointers or iterators by the elements they point to
+	template<typename _Pr>
+	struct _Pointee_less
+	{
+		_Pr& _Pred;
+
+		explicit _Pointee_less(_Pr& _Less) : _Pred(_Less)
+		{
+		}
+
+		template<typename _Ptr>
+		bool operator()(const _Ptr& _Left, const _Ptr& _Right) const
+		{
+			return _Pred(*_Left, *_Right);
+		}
+	};
+
+	// The elements of a range without random access are sorted through pointers to them. The pointers are
+	// gathered in a contiguous buffer and sorted by the elements they point to with _Sort_pointers, then the
+	// elements out of place are moved to a buffer in their sorted order and from there to their new places.
+	template<class _ExPolicy, class _FwdIt, class _Pr, class _Sort_fn>
+	void _Gather_sort_scatter(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, const _Sort_fn& _Sort_pointers)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type _Ty;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		std::vector<_Ty *> _Slots;
+		for (; _First != _Last; ++_First)
+			_Slots.push_back(std::addressof(*_First));
+
+		const size_t _Size = _Slots.size();
+		if (_Size < 2)
+			return;
+
+		std::vector<_Ty *> _Order(_Slots);
+		_Sort_pointers(_Order.begin(), _Order.end(), _Pointee_less<_Pr>(_Pred));
+
+		_Uninitialized_buffer<_Ty> _Values(_Size);
+		_Ty * const _Base = _Values.get();
+		const auto _Moved = [&_Slots, &_Order](size_t _I) { return _Order[_I] != _Slots[_I]; };
+		const auto _Destroy_moved = [_Base, &_Moved](_Ty *_Begin, size_t _Count) {
+			for (size_t _I = _Begin - _Base, _End = _I + _Count; _I < _End; ++_I)
+				if (_Moved(_I))
+					_Base[_I].~_Ty();
+		};
+
+		_Uninitialized_for_each(_Policy, _Base, _Size, [_Base, &_Order, &_Moved](_Ty *_Begin, size_t _Count) {
+			size_t _I = _Begin - _Base;
+			try {
+				for (const size_t _End = _I + _Count; _I < _End; ++_I)
+					if (_Moved(_I))
+						::new (static_cast<void *>(_Base + _I)) _Ty(std::move(*_Order[_I]));
+			}
+			catch (...) {
+				for (size_t _J = _Begin - _Base; _J < _I; ++_J)
+					if (_Moved(_J))
+						_Base[_J].~_Ty();
+				throw;
+			}
+		}, _Destroy_moved);
+
+		try {
+			_Partitioned_for_each(_Policy, _Base, _Size, 0, [_Base, &_Slots, &_Moved](_Ty *_Begin, size_t _Count, int&) {
+				for (size_t _I = _Begin - _Base, _End = _I + _Count; _I < _End; ++_I)
+					if (_Moved(_I))
+						*_Slots[_I] = std::move(_Base[_I]);
+			});
+		}
+		catch (...) {
+			_Destroy_moved(_Base, _Size);
+			throw;
+		}
+
+		_Destroy_moved(_Base, _Size);
+	}
+
+	// A sequential sort of a range without random access sorts a copy of it
+	template<typename _FwdIt, typename _Sort_fn>
+	void _Sort_copy_back(_FwdIt _First, _FwdIt _Last, const _Sort_fn& _Sort_values)
+	{
+		std::vector<typename std::iterator_traits<_FwdIt>::value_type> _Values(std::make_move_iterator(_First), std::make_move_iterator(_Last));
+		_Sort_values(_Values.begin(), _Values.end());
+		std::move(_Values.begin(), _Values.end(), _First);
+	}
+
+	//
+	// Sort
+	//
+	template<typename _RanIt, typename _Pr>
+	inline void _Sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		_EXP_TRY
+			std::sort(_First, _Last, _Pred);
+		_EXP_RETHROW
+	}
+
+	template<typename _FwdIt, typename _Pr>
+	inline void _Sort_impl(const sequential_execution_policy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, std::forward_iterator_tag)
+	{
+		typedef typename std::vector<typename std::iterator_traits<_FwdIt>::value_type>::iterator _Value_it;
+
+		_EXP_TRY
+			_Sort_copy_back(_First, _Last, [&_Pred](_Value_it _Begin, _Value_it _End) {
+				std::sort(_Begin, _End, _Pred);
+			});
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, typename _FwdIt, typename _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Sort_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		// Check for cancellation before the algorithm starts.
+		size_t _Size = _Last - _First;
+		size_t _Core_num = _Policy_thread_count(_Policy);
+		const size_t _ChunkSize = _Grain_size(_Policy, 2048); // Default chunk size
+
+		if (_Size <= _ChunkSize || _Core_num < 2)
+		{
+			return std::sort(_First, _Last, _Pred);
+		}
+
+		if (_Sort_presorted(_Policy, _First, _Size, _Pred, _Core_num))
+			return;
+
+		typedef typename std::iterator_traits<_FwdIt>::value_type _Value_type;
+		_Parallel_sort(_First, _Size, _Pred, _Core_num, _ChunkSize, typename std::conditional<_Is_string_sortable<_Value_type, _Pr>::value,
+			_String_sort_tag, _Is_radix_sortable<_Value_type, _Pr>>::type());
+	}
+
+	template<class _ExPolicy, typename _FwdIt, typename _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Sort_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, std::forward_iterator_tag)
+	{
+		typedef typename std::vector<typename std::iterator_traits<_FwdIt>::value_type *>::iterator _Pointer_it;
+
+		_Gather_sort_scatter(_Policy, _First, _Last, _Pred, [&_Policy](_Pointer_it _Begin, _Pointer_it _End, const _Pointee_less<_Pr>& _Ptr_pred) {
+			_Sort_impl(_Policy, _Begin, _End, _Ptr_pred, std::random_access_iterator_tag());
+		});
+	}
+
+	template<typename _RanIt, typename _Pr, class _IterCat>
+	inline void _Sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Sort_impl, _Policy, _First, _Last, _Pred, _Cat);
+	}
+
+	//
+	// partial_sort
+	//
+	template<typename _RanIt, typename _Pr, class _IterCat>
+	inline void _Partial_sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat)
+	{
+		_EXP_TRY
+			std::partial_sort(_First, _Mid, _Last, _Pred);
+		_EXP_RETHROW
+	}
+
+	// Ranges this many times larger than the values kept or more take the top-k selection
+	const size_t _Top_k_max_ratio = 1024;
+
+	// Orders the offsets of a range by the values at them, ties by the offsets
+	template<typename _RanIt, typename _Pr>
+	class _Top_k_order
+	{
+		_RanIt _First;
+		_Pr *_Pred;
+	public:
+		_Top_k_order(_RanIt _Begin, _Pr& _Func) : _First(_Begin), _Pred(&_Func)
+		{
+		}
+
+		bool operator()(size_t _Left, size_t _Right) const
+		{
+			if ((*_Pred)(_First[_Left], _First[_Right]))
+				return true;
+			return !(*_Pred)(_First[_Right], _First[_Left]) && _Left < _Right;
+		}
+	};
+
+	// Offers an offset to a max-heap of the _K first offsets in _Order. Most offsets of a large range are turned
+	// down with the one comparison against the top of the heap.
+	template<typename _Order>
+	inline void _Top_k_offer(std::vector<size_t>& _Heap, size_t _K, size_t _Pos, const _Order& _Ord)
+	{
+		if (_Heap.size() < _K)
+		{
+			_Heap.push_back(_Pos);
+			std::push_heap(_Heap.begin(), _Heap.end(), _Ord);
+		}
+		else if (_Ord(_Pos, _Heap.front()))
+		{
+			std::pop_heap(_Heap.begin(), _Heap.end(), _Ord);
+			_Heap.back() = _Pos;
+			std::push_heap(_Heap.begin(), _Heap.end(), _Ord);
+		}
+	}
+
+	// Offsets of the _K smallest values of the range, unordered. Every worker keeps the best of the chunks it runs
+	// in a heap of its own, the heaps are merged at the end.
+	template<class _ExPolicy, typename _RanIt, typename _Pr>
+	inline std::vector<size_t> _Top_k_offsets(const _ExPolicy& _Policy, _RanIt _First, size_t _Size, size_t _K, _Pr& _Pred)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		combinable<std::vector<size_t>> _Heaps;
+
+		_Partitioned_for_each(_Policy, _First, _Size, _Pred, [&_Heaps, _First, _K](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			const _Top_k_order<_RanIt, _Pr> _Order(_First, _UserPred);
+			auto &_Heap = _Heaps.local();
+			_Heap.reserve(_K);
+
+			for (size_t _Pos = _Begin - _First, _End = _Pos + _Count; _Pos < _End; ++_Pos)
+				_Top_k_offer(_Heap, _K, _Pos, _Order);
+		});
+
+		const _Top_k_order<_RanIt, _Pr> _Order(_First, _Pred);
+		return _Heaps.combine([&_Order, _K](std::vector<size_t> _Left, const std::vector<size_t>& _Right) {
+			for (auto _Pos : _Right)
+				_Top_k_offer(_Left, _K, _Pos, _Order);
+			return _Left;
+		});
+	}
+
+	// partial_sort of a few values out of a large range: the _K smallest values are selected, swapped to the front
+	// in place of the values there that were not selected, then sorted
+	template<class _ExPolicy, typename _RanIt, typename _Pr>
+	inline void _Partial_sort_top_k(const _ExPolicy& _Policy, _RanIt _First, size_t _K, size_t _Size, _Pr& _Pred)
+	{
+		std::vector<size_t> _Best = _Top_k_offsets(_Policy, _First, _Size, _K, _Pred);
+		std::sort(_Best.begin(), _Best.end());
+
+		auto _In_front = _Best.begin();
+		auto _Behind = std::lower_bound(_Best.begin(), _Best.end(), _K);
+		for (size_t _Pos = 0; _Pos < _K; ++_Pos)
+		{
+			if (_In_front != _Best.end() && *_In_front == _Pos)
+				++_In_front;
+			else
+				std::iter_swap(_First + _Pos, _First + *_Behind++);
+		}
+
+		std::sort(_First, _First + _K, _Pred);
+	}
+
+	template<class _ExPolicy, typename _RanIt, typename _Pr, class _IterCat>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Partial_sort_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		// Check for cancellation before the algorithm starts.
+		const size_t _ChunkSize = _Grain_size(_Policy, 2048); // Default chunk size
+		size_t _Core_num = _Policy_thread_count(_Policy);
+		size_t _Size = _Last - _First;
+
+		// Don't need to do anything if the sort range is empty
+		if (_Mid == _First)
+			return;
+
+		if (_Size <= _ChunkSize || _Core_num < 2)
+		{
+			return std::partial_sort(_First, _Mid, _Last, _Pred);
+		}
+
+		if (static_cast<size_t>(_Mid - _First) <= _Size / _Top_k_max_ratio)
+			return _Partial_sort_top_k(_Policy, _First, _Mid - _First, _Size, _Pred);
+
+		parallel_partialsort_impl(_First, _Mid - _First, _Size, _Pred, _Core_num * _SortMaxTasksPerCore, _ChunkSize, 0);
+	}
+
+	template<typename _RanIt, typename _Pr, class _IterCat>
+	inline void _Partial_sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Partial_sort_impl, _Policy, _First, _Mid, _Last, _Pred, _Cat)
+	}
+
+	//
+	// stable_sort
+	//
+	// The scratch of a parallel stable_sort is raw storage. Values with nothing to construct or destroy are
+	// written there by the sort before they are read, the others are given a live value in every slot first.
+	template<typename _Ty>
+	struct _Is_trivial_scratch : std::integral_constant<bool,
+		std::is_trivially_copyable<_Ty>::value && std::is_trivially_destructible<_Ty>::value>
+	{
+	};
+
+	// The slots are filled in parallel chores, which must not throw
+	template<typename _Ty>
+	struct _Is_scratch_sortable : std::integral_constant<bool, _Is_trivial_scratch<_Ty>::value ||
+		std::is_nothrow_move_constructible<_Ty>::value && std::is_nothrow_move_assignable<_Ty>::value>
+	{
+	};
+
+	// Keeps a live value in the first _Size slots of the scratch for its lifetime. Every block of the range
+	// moves its first value along its slots and back, so the slots hold moved-from values and the value type
+	// needs no default constructor.
+	template<typename _RanIt, bool _Trivial = _Is_trivial_scratch<typename std::iterator_traits<_RanIt>::value_type>::value>
+	class _Stable_sort_scratch
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		_Value_type *_Buffer;
+		size_t _Size;
+		size_t _Blocks;
+
+		_Stable_sort_scratch(const _Stable_sort_scratch&);
+		_Stable_sort_scratch& operator=(const _Stable_sort_scratch&);
+	public:
+		_Stable_sort_scratch(_RanIt _First, _Value_type *_Buf, size_t _Count, size_t _Core_num)
+			: _Buffer(_Buf), _Size(_Count), _Blocks((std::min)(_Core_num, _Count))
+		{
+			_Run_blocks(_Blocks, [this, _First](size_t _Block) {
+				const size_t _Begin = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks;
+
+				::new (static_cast<void*>(_Buffer + _Begin)) _Value_type(std::move(_First[_Begin]));
+				for (size_t _I = _Begin + 1; _I < _End; ++_I)
+					::new (static_cast<void*>(_Buffer + _I)) _Value_type(std::move(_Buffer[_I - 1]));
+
+				_First[_Begin] = std::move(_Buffer[_End - 1]);
+			});
+		}
+
+		~_Stable_sort_scratch()
+		{
+			_Run_blocks(_Blocks, [this](size_t _Block) {
+				for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+					_Buffer[_I].~_Value_type();
+			});
+		}
+	};
+
+	template<typename _RanIt>
+	class _Stable_sort_scratch<_RanIt, true>
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+	public:
+		_Stable_sort_scratch(_RanIt, _Value_type *, size_t, size_t)
+		{
+		}
+	};
+
+	// Sorts a block per core with std::stable_sort, which falls back by itself on smaller buffers, then
+	// merges the blocks, in place if need be. For a scratch that can't be allocated or filled.
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_inplace_stable_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num)
+	{
+		const size_t _Blocks = (std::min)(_Core_num, _Size);
+
+		std::vector<size_t> _Run_begin;
+		for (size_t _Block = 0; _Block <= _Blocks; ++_Block)
+			_Run_begin.push_back(_Size * _Block / _Blocks);
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			_Leaf_stable_sort(_First + _Run_begin[_Block], _First + _Run_begin[_Block + 1], _Pred);
+		});
+
+		_Merge_runs(_First, _Run_begin, _Pred, _Core_num);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_stable_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t _Chunk_size,
+		_Uninitialized_buffer<typename std::iterator_traits<_RanIt>::value_type>& _Scratch, std::true_type)
+	{
+		const static size_t CORE_NUM_MASK = 0x55555555;
+
+		try
+		{
+			_Scratch._Reserve(_Size);
+		}
+		catch (const std::bad_alloc&)
+		{
+			return _Parallel_inplace_stable_sort(_First, _Size, _Pred, _Core_num);
+		}
+
+		_Stable_sort_scratch<_RanIt> _Live(_First, _Scratch.get(), _Size, _Core_num);
+
+		// 4 times overload on each core
+		_Core_num *= 4;
+
+		// This buffered sort algorithm will divide chunks and apply parallel quicksort on each chunk. In the end, it will 
+		// apply parallel merge to these sorted chunks.
+		// 
+		// We need to decide on the number of chunks to divide the input buffer into. If we divide it into n chunks, log(n) 
+		// merges will be needed to get the final sorted result. In this algorithm, we have two buffers for each merge 
+		// operation, let's say buffer A and B. Buffer A is the original input array, buffer B is the additional allocated 
+		// buffer. Each turn's merge will put the merge result into the other buffer; for example, if we decided to split 
+		// into 8 chunks in buffer A at very beginning, after one pass of merging, there will be 4 chunks in buffer B.
+		// If we apply one more pass of merging, there will be 2 chunks in buffer A again.
+		// 
+		// The problem is we want to the final merge pass to put the result back in buffer A, so that we don't need 
+		// one extra copy to put the sorted data back to buffer A.
+		// To make sure the final result is in buffer A (original input array), we need an even number of merge passes,
+		// which means log(n) must be an even number. Thus n must be a number power(2, even number). For example, when the
+		// even number is 2, n is power(2, 2) = 4, when even number is 4, n is power(2, 4) = 16. When we divide chunks 
+		// into these numbers, the final merge result will be in the original input array. Now we need to decide the chunk(split) 
+		// number based on this property and the number of cores.
+		// 
+		// We want to get a chunk (split) number close to the core number (or a little more than the number of cores), 
+		// and it also needs to satisfy above property. For a 8 core machine, the best chunk number should be 16, because it's 
+		// the smallest number that satisfies the above property and is bigger than the core number (so that we can utilize all 
+		// cores, a little more than core number is OK, we need to split more tasks anyway). 
+		// 
+		// In this algorithm, we will make this alignment by bit operations (it's easy and clear). For a binary representation, 
+		// all the numbers that satisfy power(2, even number) will be 1, 100, 10000, 1000000, 100000000 ...
+		// After OR-ing these numbers together, we will get a mask (... 0101 0101 0101) which is all possible combinations of 
+		// power(2, even number). We use _Core_num & CORE_NUM_MASK | _Core_num << 1 & CORE_NUM_MASK, a bit-wise operation to align 
+		// _Core_num's highest bit into a power(2, even number).
+		// 
+		// It means if _Core_num = 8, the highest bit in binary is bin(1000) which is not power(2, even number). After this 
+		// bit-wise operation, it will align to bin(10000) = 16 which is power(2, even number). If the _Core_num = 16, after 
+		// alignment it still returns 16. The trick is to make sure the highest bit of _Core_num will align to the "1" bit of the 
+		// mask bin(... 0101 0101 0101) We don't care about the other bits on the aligned result except the highest bit, because they 
+		// will be ignored in the function.
+		_Parallel_buffered_sort_impl(_First, _Size, stdext::make_unchecked_array_iterator(_Scratch.get()),
+			_Pred, _Core_num & CORE_NUM_MASK | _Core_num << 1 & CORE_NUM_MASK, _Chunk_size);
+	}
+
+	template<typename _RanIt, typename _Pr>
+	inline void _Parallel_stable_sort(_RanIt _First, size_t _Size, _Pr& _Pred, size_t _Core_num, size_t,
+		_Uninitialized_buffer<typename std::iterator_traits<_RanIt>::value_type>&, std::false_type)
+	{
+		_Parallel_inplace_stable_sort(_First, _Size, _Pred, _Core_num);
+	}
+
+	template<class _RanIt, class _Pr, class _Ty, class _IterCat>
+	inline void _Stable_sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, _Pr _Pred, _Uninitialized_buffer<_Ty>&, _IterCat)
+	{
+		_EXP_TRY
+			std::stable_sort(_First, _Last, _Pred);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _RanIt, class _Pr, class _Ty, class _IterCat>
+	inline void _Stable_sort_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _Uninitialized_buffer<_Ty>& _Scratch, _IterCat)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		// Check cancellation before the algorithm starts.
+		size_t _Size = _Last - _First;
+		size_t _Core_num = _Policy_thread_count(_Policy);
+		const size_t _Chunk_size = _Grain_size(_Policy, 2048);
+
+		if (_Size <= _Chunk_size || _Core_num < 2)
+		{
+			return std::stable_sort(_First, _Last, _Pred);
+		}
+
+		_Parallel_stable_sort(_First, _Size, _Pred, _Core_num, _Chunk_size, _Scratch, _Is_scratch_sortable<_Ty>());
+	}
+
+	template<class _RanIt, class _Pr, class _Ty, class _IterCat>
+	inline void _Stable_sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _Uninitialized_buffer<_Ty>& _Scratch, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Stable_sort_impl, _Policy, _First, _Last, _Pred, _Scratch, _Cat);
+	}
+
+	template<class _RanIt, class _Pr>
+	inline void _Stable_sort_impl(const sequential_execution_policy&, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		_EXP_TRY
+			std::stable_sort(_First, _Last, _Pred);
+		_EXP_RETHROW
+	}
+
+	template<class _FwdIt, class _Pr>
+	inline void _Stable_sort_impl(const sequential_execution_policy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, std::forward_iterator_tag)
+	{
+		typedef typename std::vector<typename std::iterator_traits<_FwdIt>::value_type>::iterator _Value_it;
+
+		_EXP_TRY
+			_Sort_copy_back(_First, _Last, [&_Pred](_Value_it _Begin, _Value_it _End) {
+				std::stable_sort(_Begin, _End, _Pred);
+			});
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _RanIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Stable_sort_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag _Cat)
+	{
+		_Uninitialized_buffer<typename std::iterator_traits<_RanIt>::value_type> _Scratch;
+		_Stable_sort_impl(_Policy, _First, _Last, _Pred, _Scratch, _Cat);
+	}
+
+	// The pointers keep the order of the range, a stable sort of them leaves the equal elements in their order
+	template<class _ExPolicy, class _FwdIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _Stable_sort_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, std::forward_iterator_tag)
+	{
+		typedef typename std::vector<typename std::iterator_traits<_FwdIt>::value_type *>::iterator _Pointer_it;
+
+		_Gather_sort_scatter(_Policy, _First, _Last, _Pred, [&_Policy](_Pointer_it _Begin, _Pointer_it _End, const _Pointee_less<_Pr>& _Ptr_pred) {
+			_Stable_sort_impl(_Policy, _Begin, _End, _Ptr_pred, std::random_access_iterator_tag());
+		});
+	}
+
+	template<class _RanIt, class _Pr, class _IterCat>
+	inline void _Stable_sort_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Stable_sort_impl, _Policy, _First, _Last, _Pred, _Cat);
+	}
+
+	//
+	// Sort of a list
+	//
+	template<class _RanIt, class _Pr, class _ExPolicy>
+	inline void _Sort_nodes(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::false_type)
+	{
+		_Sort_impl(_Policy, _First, _Last, _Pred, std::random_access_iterator_tag());
+	}
+
+	template<class _RanIt, class _Pr, class _ExPolicy>
+	inline void _Sort_nodes(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::true_type) // stable
+	{
+		_Stable_sort_impl(_Policy, _First, _Last, _Pred, std::random_access_iterator_tag());
+	}
+
+	template<class _Ty, class _Alloc, class _Pr, class _Stable>
+	inline void _List_sort_impl(const sequential_execution_policy&, std::list<_Ty, _Alloc>& _List, _Pr _Pred, _Stable)
+	{
+		_EXP_TRY
+			_List.sort(_Pred);
+		_EXP_RETHROW
+	}
+
+	// Iterators to the nodes are sorted by their elements, then the nodes are spliced to the end of the
+	// list in that order. The elements are not moved, the list is left as it was when the sort throws.
+	template<class _ExPolicy, class _Ty, class _Alloc, class _Pr, class _Stable>
+	inline typename _enable_if_parallel<_ExPolicy, void>::type _List_sort_impl(const _ExPolicy& _Policy, std::list<_Ty, _Alloc>& _List, _Pr _Pred, _Stable _Is_stable)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		typedef typename std::list<_Ty, _Alloc>::iterator _Node;
+
+		if (_List.size() <= _Grain_size(_Policy, 2048) || _Policy_thread_count(_Policy) < 2)
+			return _List.sort(_Pred);
+
+		std::vector<_Node> _Nodes;
+		_Nodes.reserve(_List.size());
+		for (_Node _It = _List.begin(); _It != _List.end(); ++_It)
+			_Nodes.push_back(_It);
+
+		_Sort_nodes(_Policy, _Nodes.begin(), _Nodes.end(), _Pointee_less<_Pr>(_Pred), _Is_stable);
+
+		for (auto _It = _Nodes.begin(); _It != _Nodes.end(); ++_It)
+			_List.splice(_List.end(), _List, *_It);
+	}
+
+	template<class _Ty, class _Alloc, class _Pr, class _Stable>
+	inline void _List_sort_impl(const execution_policy& _Policy, std::list<_Ty, _Alloc>& _List, _Pr _Pred, _Stable _Is_stable)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_List_sort_impl, _Policy, _List, _Pred, _Is_stable);
+	}
+
+	//
+	// sort_by_key, sort_indices
+	//
+	// Heavy values are not moved while sorting. Compact (key, index) pairs are sorted instead, ties broken
+	// by the index so equal keys keep their input order, then every value is gathered once from the place
+	// its pair came from, the way apply_permutation does.
+	// Applies the permutation of the sorted pairs in place cycle by cycle, without storage. For values whose moves may
+	// throw and for storage that can't be allocated.
+	template<typename _KeyIt, typename _RanIt, typename _Key>
+	inline void _Gather_by_index(_KeyIt _Keys, _RanIt _First, std::vector<std::pair<_Key, size_t>>& _Order, size_t, std::false_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+
+		for (size_t _I = 0; _I < _Order.size(); ++_I)
+		{
+			_Keys[_I] = std::move(_Order[_I].first);
+			if (_Order[_I].second == _I)
+				continue;
+
+			_Value_type _Value(std::move(_First[_I]));
+			size_t _Hole = _I;
+			for (size_t _From = _Order[_Hole].second; _From != _I; _From = _Order[_Hole].second)
+			{
+				_First[_Hole] = std::move(_First[_From]);
+				_Order[_Hole].second = _Hole;
+				_Hole = _From;
+			}
+
+			_First[_Hole] = std::move(_Value);
+			_Order[_Hole].second = _Hole;
+		}
+	}
+
+	// Moves the values of the range to the order of the sorted pairs and the keys of the pairs to _Keys. The values
+	// are gathered into raw storage and moved back, both in parallel blocks.
+	template<typename _KeyIt, typename _RanIt, typename _Key>
+	inline void _Gather_by_index(_KeyIt _Keys, _RanIt _First, std::vector<std::pair<_Key, size_t>>& _Order, size_t _Blocks, std::true_type)
+	{
+		typedef typename std::iterator_traits<_RanIt>::value_type _Value_type;
+		const size_t _Size = _Order.size();
+
+		std::unique_ptr<_Uninitialized_buffer<_Value_type>> _Buffer;
+		try
+		{
+			_Buffer.reset(new _Uninitialized_buffer<_Value_type>(_Size));
+		}
+		catch (const std::bad_alloc&)
+		{
+			return _Gather_by_index(_Keys, _First, _Order, _Blocks, std::false_type());
+		}
+
+		_Value_type *_Buf = _Buffer->get();
+		const auto _Index = [&_Order](size_t _I) { return _Order[_I].second; };
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			_Prefetched_loop(_First, _Size * _Block / _Blocks, _Size * (_Block + 1) / _Blocks, _Index, [&](size_t _I) {
+				::new (static_cast<void*>(_Buf + _I)) _Value_type(std::move(_First[_Order[_I].second]));
+			});
+		});
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+			{
+				_Keys[_I] = std::move(_Order[_I].first);
+				_First[_I] = std::move(_Buf[_I]);
+				_Buf[_I].~_Value_type();
+			}
+		});
+	}
+
+	template<class _ExPolicy, class _KeyIt, class _RanIt, class _Pr>
+	inline void _Sort_by_key_impl(const _ExPolicy& _Policy, _KeyIt _Keys_first, _KeyIt _Keys_last, _RanIt _Values_first, _Pr _Pred)
+	{
+		typedef typename std::iterator_traits<_KeyIt>::value_type _Key_type;
+		typedef std::pair<_Key_type, size_t> _Key_index;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Keys_last - _Keys_first;
+		const size_t _Blocks = _Gather_blocks(_Policy, _Size);
+
+		std::vector<_Key_index> _Order(_Size);
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+			{
+				_Order[_I].first = _Keys_first[_I];
+				_Order[_I].second = _I;
+			}
+		});
+
+		_Sort_impl(_Policy, _Order.begin(), _Order.end(), [&_Pred](const _Key_index& _Left, const _Key_index& _Right) {
+			if (_Pred(_Left.first, _Right.first))
+				return true;
+			return !_Pred(_Right.first, _Left.first) && _Left.second < _Right.second;
+		}, std::random_access_iterator_tag());
+
+		_Gather_by_index(_Keys_first, _Values_first, _Order, _Blocks, _Is_scratch_sortable<typename std::iterator_traits<_RanIt>::value_type>());
+	}
+
+	template<class _KeyIt, class _RanIt, class _Pr>
+	inline void _Sort_by_key_impl(const execution_policy& _Policy, _KeyIt _Keys_first, _KeyIt _Keys_last, _RanIt _Values_first, _Pr _Pred)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Sort_by_key_impl, _Policy, _Keys_first, _Keys_last, _Values_first, _Pred);
+	}
+
+	template<class _ExPolicy, class _RanIt, class _IdxIt, class _Pr>
+	inline _IdxIt _Sort_indices_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _IdxIt _Indices_first, _Pr _Pred)
+	{
+		typedef typename std::iterator_traits<_IdxIt>::value_type _Index_type;
+
+		const size_t _Size = _Last - _First;
+		const size_t _Blocks = _Gather_blocks(_Policy, _Size);
+
+		_Run_blocks(_Blocks, [&](size_t _Block) {
+			for (size_t _I = _Size * _Block / _Blocks, _End = _Size * (_Block + 1) / _Blocks; _I < _End; ++_I)
+				_Indices_first[_I] = static_cast<_Index_type>(_I);
+		});
+
+		_Sort_impl(_Policy, _Indices_first, _Indices_first + _Size, [&_Pred, _First](const _Index_type& _Left, const _Index_type& _Right) {
+			if (_Pred(_First[_Left], _First[_Right]))
+				return true;
+			return !_Pred(_First[_Right], _First[_Left]) && _Left < _Right;
+		}, std::random_access_iterator_tag());
+
+		return _Indices_first + _Size;
+	}
+
+	template<class _RanIt, class _IdxIt, class _Pr>
+	inline _IdxIt _Sort_indices_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _IdxIt _Indices_first, _Pr _Pred)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Sort_indices_impl, _Policy, _First, _Last, _Indices_first, _Pred);
+	}
+
+	//
+	// partial_sort_copy
+	//
+	// partial_sort_copy falls back to sequential, but for a few values out of a large random access range
+	template<class _ExPolicy, class _InIt, class _RanIt, class _Pr, class _IterCat>
+	inline _RanIt _Partial_sort_copy_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2, _Pr _Pred, _IterCat)
+	{
+		_EXP_TRY
+			return std::partial_sort_copy(_First, _Last, _First2, _Last2, _Pred);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _InIt, class _RanIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, _RanIt>::type _Partial_sort_copy_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last,
+		_RanIt _First2, _RanIt _Last2, _Pr _Pred, std::random_access_iterator_tag _Cat)
+	{
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Last - _First;
+		const size_t _K = (std::min)(_Size, static_cast<size_t>(_Last2 - _First2));
+
+		if (_K == 0 || _K > _Size / _Top_k_max_ratio || _Size <= _Grain_size(_Policy, 2048) || _Policy_thread_count(_Policy) < 2)
+			return _Partial_sort_copy_impl(seq, _First, _Last, _First2, _Last2, _Pred, _Cat);
+
+		std::vector<size_t> _Best = _Top_k_offsets(_Policy, _First, _Size, _K, _Pred);
+		std::sort(_Best.begin(), _Best.end(), _Top_k_order<_InIt, _Pr>(_First, _Pred));
+
+		return std::transform(_Best.begin(), _Best.end(), _First2, [_First](size_t _Pos) { return _First[_Pos]; });
+	}
+
+	template<class _InIt, class _RanIt, class _Pr, class _IterCat>
+	inline _RanIt _Partial_sort_copy_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Partial_sort_copy_impl, _Policy, _First, _Last, _First2, _Last2, _Pred, _Cat);
+	}
+}  //details
+
+/// <summary>
+///     The ranges without random access are sorted through pointers to their elements, every element out of place
+///     is moved twice.
+/// </summary>
+template<class _ExPolicy, class _FwdIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
-	partial_sort(std::forward<_ExPolicy>(_Policy), _First, _Mid, _Last, std::less<>());
+	_EXP_TELEMETRY_ALGORITHM("sort");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Sort_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort");
+	sort(std::forward<_ExPolicy>(_Policy), _First, _Last, std::less<>());
+}
+
+/// <summary>
+///     Sorts the list by relinking its nodes, the elements are neither copied nor moved.
+/// </summary>
+template<class _ExPolicy, class _Ty, class _Alloc, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, std::list<_Ty, _Alloc>& _List, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort");
+	details::_List_sort_impl(_Policy, _List, _Pred, std::false_type());
+}
+
+template<class _ExPolicy, class _Ty, class _Alloc>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort(_ExPolicy&& _Policy, std::list<_Ty, _Alloc>& _List)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort");
+	sort(std::forward<_ExPolicy>(_Policy), _List, std::less<>());
 }
 
 template<class _ExPolicy, class _RanIt, class _Pr>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred)
+inline typename details::_enable_if_policy<_ExPolicy, void>::type partial_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("partial_sort");
 	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
 
-	details::_Stable_sort_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
+	details::_Partial_sort_impl(_Policy, _First, _Mid, _Last, _Pred, std::_Iter_cat(_First));
 }
 
 template<class _ExPolicy, class _RanIt>
-inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last)
+inline typename details::_enable_if_policy<_ExPolicy, void>::type partial_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Mid, _RanIt _Last)
+{
+	_EXP_TELEMETRY_ALGORITHM("partial_sort");
+	partial_sort(std::forward<_ExPolicy>(_Policy), _First, _Mid, _Last, std::less<>());
+}
+
+template<class _ExPolicy, class _FwdIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("stable_sort");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Stable_sort_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
+}
+
+/// <summary>
+///     Sorts the list by relinking its nodes, equal elements keep their order.
+/// </summary>
+template<class _ExPolicy, class _Ty, class _Alloc, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, std::list<_Ty, _Alloc>& _List, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("stable_sort");
+	details::_List_sort_impl(_Policy, _List, _Pred, std::true_type());
+}
+
+template<class _ExPolicy, class _Ty, class _Alloc>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, std::list<_Ty, _Alloc>& _List)
+{
+	_EXP_TELEMETRY_ALGORITHM("stable_sort");
+	stable_sort(std::forward<_ExPolicy>(_Policy), _List, std::less<>());
+}
+
+/// <summary>
+///     Scratch storage for the parallel stable_sort, reused by the sorts it is passed to instead of allocating their own.
+///     It grows to the largest range sorted with it and keeps its storage, the values in it live only while a sort runs.
+/// </summary>
+template<class _Ty>
+class sort_buffer
+{
+	details::_Uninitialized_buffer<_Ty> _Storage;
+
+	sort_buffer(const sort_buffer&);
+	sort_buffer& operator=(const sort_buffer&);
+public:
+	sort_buffer()
+	{
+	}
+
+	explicit sort_buffer(size_t _Count)
+	{
+		_Storage._Reserve(_Count);
+	}
+
+	size_t capacity() const _NOEXCEPT
+	{
+		return _Storage.size();
+	}
+
+	details::_Uninitialized_buffer<_Ty>& _Get() _NOEXCEPT
+	{
+		return _Storage;
+	}
+};
+
+template<class _ExPolicy, class _RanIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred,
+	sort_buffer<typename std::iterator_traits<_RanIt>::value_type>& _Buffer)
 {
+	_EXP_TELEMETRY_ALGORITHM("stable_sort");
 	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
 
+	details::_Stable_sort_impl(_Policy, _First, _Last, _Pred, _Buffer._Get(), std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type stable_sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	_EXP_TELEMETRY_ALGORITHM("stable_sort");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
 	stable_sort(std::forward<_ExPolicy>(_Policy), _First, _Last, std::less<>());
 }
 
+/// <summary>
+///     Sorts the keys and moves the values along with them, the value at an offset of _Values_first belongs to the key
+///     at the same offset. The values are moved once, after (key, index) pairs have been sorted, which suits values much
+///     larger than their keys. Equal keys keep their order.
+/// </summary>
+template<class _ExPolicy, class _RanIt1, class _RanIt2, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort_by_key(_ExPolicy&& _Policy, _RanIt1 _Keys_first, _RanIt1 _Keys_last, _RanIt2 _Values_first, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort_by_key");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt1>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt2>::iterator_category>::value, "Required random access iterator.");
+
+	details::_Sort_by_key_impl(_Policy, _Keys_first, _Keys_last, _Values_first, _Pred);
+}
+
+template<class _ExPolicy, class _RanIt1, class _RanIt2>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type sort_by_key(_ExPolicy&& _Policy, _RanIt1 _Keys_first, _RanIt1 _Keys_last, _RanIt2 _Values_first)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort_by_key");
+	sort_by_key(std::forward<_ExPolicy>(_Policy), _Keys_first, _Keys_last, _Values_first, std::less<>());
+}
+
+/// <summary>
+///     Writes the offsets of the elements of [_First, _Last) in the order of a stable sort of the elements, the range
+///     itself is left as is. Returns the end of the indices written.
+/// </summary>
+template<class _ExPolicy, class _RanIt1, class _RanIt2, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, _RanIt2>::type sort_indices(_ExPolicy&& _Policy, _RanIt1 _First, _RanIt1 _Last, _RanIt2 _Indices_first, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort_indices");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt1>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt2>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_integral<typename std::iterator_traits<_RanIt2>::value_type>::value, "Required integral indices.");
+
+	return details::_Sort_indices_impl(_Policy, _First, _Last, _Indices_first, _Pred);
+}
+
+template<class _ExPolicy, class _RanIt1, class _RanIt2>
+inline typename details::_enable_if_policy<_ExPolicy, _RanIt2>::type sort_indices(_ExPolicy&& _Policy, _RanIt1 _First, _RanIt1 _Last, _RanIt2 _Indices_first)
+{
+	_EXP_TELEMETRY_ALGORITHM("sort_indices");
+	return sort_indices(std::forward<_ExPolicy>(_Policy), _First, _Last, _Indices_first, std::less<>());
+}
+
 template<class _ExPolicy, class _InIt, class _RanIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _RanIt>::type partial_sort_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("partial_sort_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
 
-	return details::_Partial_sort_copy_impl(_Policy, _First, _Last, _First2, _Last2, _Pred);
+	return details::_Partial_sort_copy_impl(_Policy, _First, _Last, _First2, _Last2, _Pred, std::_Iter_cat(_First));
 }
 
 template<class _ExPolicy, class _InIt, class _RanIt>
 inline typename details::_enable_if_policy<_ExPolicy, _RanIt>::type partial_sort_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _RanIt _First2, _RanIt _Last2)
 {
+	_EXP_TELEMETRY_ALGORITHM("partial_sort_copy");
 	return partial_sort_copy(std::forward<_ExPolicy>(_Policy), _First, _Last, _First2, _Last2, std::less<>());
 }
 _PSTL_NS1_END // std::experimental::parallel
@@ -0,0 +1,201 @@
+#pragma once
+
+#ifndef _IMPL_SPLIT_H_
+#define _IMPL_SPLIT_H_ 1
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include "algorithm_impl.h"
+#include "count.h"
+#include "find.h"
+#include "scan.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	//
+	// split
+	//
+	// The range is cut in chunks. A first pass counts the delimiters of every chunk with the vector count, a scan
+	// of the counts gives the place of the offsets of every chunk, and a second pass finds the delimiters again
+	// with the vector find and writes their offsets. Both passes stream the range once, in parallel chunks.
+	//
+	// A quote switches the delimiters after it off until the next one. A chunk doesn't know whether it starts in
+	// a quoted field, so the first pass counts the delimiters of both cases along with the parity of its quotes,
+	// and the scan picks the count of every chunk by the parity of the quotes before it.
+	const size_t _Split_min_chunk = 64 * 1024;
+	const size_t _Split_chunks_per_thread = 4;
+
+	inline size_t _Split_chunks(const sequential_execution_policy&, size_t)
+	{
+		return 1;
+	}
+
+	template<class _ExPolicy>
+	inline size_t _Split_chunks(const _ExPolicy& _Policy, size_t _Size)
+	{
+		const size_t _Max_chunks = static_cast<size_t>(_Policy_thread_count(_Policy)) * _Split_chunks_per_thread;
+		return (std::max)(size_t{ 1 }, (std::min)(_Size / _Grain_size(_Policy, _Split_min_chunk), _Max_chunks));
+	}
+
+	// The searches of the elements of [_Begin, _End) from _First, with the vector kernels of find and count on
+	// contiguous ranges of integral elements
+	template<typename _RanIt, typename _El, bool _Vec = _Is_vector_find<_RanIt, _El>::value>
+	struct _Split_search
+	{
+		_RanIt _First;
+
+		size_t _Find(size_t _Begin, size_t _End, _El _Val) const
+		{
+			return std::find(_First + _Begin, _First + _End, _Val) - _First;
+		}
+
+		size_t _Count(size_t _Begin, size_t _End, _El _Val) const
+		{
+			return static_cast<size_t>(std::count(_First + _Begin, _First + _End, _Val));
+		}
+	};
+
+	template<typename _RanIt, typename _El>
+	struct _Split_search<_RanIt, _El, true>
+	{
+		_RanIt _First;
+
+		size_t _Find(size_t _Begin, size_t _End, _El _Val) const
+		{
+			return _Begin == _End ? _End : _Begin + _Find_value_vec(_Unwrap_contiguous(_First + _Begin), _End - _Begin, _Val);
+		}
+
+		size_t _Count(size_t _Begin, size_t _End, _El _Val) const
+		{
+			return _Begin == _End ? 0 : _Count_value_vec(_Unwrap_contiguous(_First + _Begin), _End - _Begin, _Val);
+		}
+	};
+
+	// Calls _Func(_Begin, _End, _Odd) for the runs of [_Begin, _End) between the quotes, _Odd for the runs after an
+	// odd number of them. Returns whether the number of quotes is odd.
+	template<typename _Search, typename _El, typename _Fn>
+	inline bool _Quoted_runs(const _Search& _Searcher, size_t _Begin, size_t _End, _El _Quote, const _Fn& _Func, std::true_type)
+	{
+		for (bool _Odd = false;; _Odd = !_Odd)
+		{
+			const size_t _At = _Searcher._Find(_Begin, _End, _Quote);
+			_Func(_Begin, _At, _Odd);
+			if (_At == _End)
+				return _Odd;
+			_Begin = _At + 1;
+		}
+	}
+
+	template<typename _Search, typename _El, typename _Fn>
+	inline bool _Quoted_runs(const _Search&, size_t _Begin, size_t _End, _El, const _Fn& _Func, std::false_type)
+	{
+		_Func(_Begin, _End, false);
+		return false;
+	}
+
+	template<class _ExPolicy, class _RanIt, class _El, class _OutIt, class _Quoted>
+	inline _OutIt _Split_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _El _Delim, _El _Quote, _OutIt _Dest, _Quoted _Is_quoted)
+	{
+		typedef typename std::iterator_traits<_OutIt>::value_type _Offset_type;
+
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = _Last - _First;
+		const size_t _Chunks = _Split_chunks(_Policy, _Size);
+		const _Split_search<_RanIt, _El> _Searcher = { _First };
+
+		// The delimiters of every chunk out of quotes if it starts out of them [0] or in them [1]
+		std::vector<size_t> _Counts(2 * _Chunks);
+		std::vector<char> _Odd_quotes(_Chunks);
+		_Run_blocks(_Chunks, [&](size_t _Chunk) {
+			size_t _Found[2] = { 0, 0 };
+			_Odd_quotes[_Chunk] = _Quoted_runs(_Searcher, _Size * _Chunk / _Chunks, _Size * (_Chunk + 1) / _Chunks, _Quote, [&](size_t _Begin, size_t _End, bool _Odd) {
+				_Found[_Odd ? 1 : 0] += _Searcher._Count(_Begin, _End, _Delim);
+			}, _Is_quoted);
+			_Counts[2 * _Chunk] = _Found[0];
+			_Counts[2 * _Chunk + 1] = _Found[1];
+		});
+
+		std::vector<char> _In_quotes(_Chunks);
+		std::vector<size_t> _Chunk_counts(_Chunks), _Places(_Chunks);
+		bool _Quoted_before = false;
+		for (size_t _Chunk = 0; _Chunk < _Chunks; ++_Chunk)
+		{
+			_In_quotes[_Chunk] = _Quoted_before;
+			_Chunk_counts[_Chunk] = _Counts[2 * _Chunk + (_Quoted_before ? 1 : 0)];
+			_Quoted_before = _Quoted_before != (_Odd_quotes[_Chunk] != 0);
+		}
+
+		_Exclusive_scan_impl(seq, _Chunk_counts.begin(), _Chunk_counts.end(), _Places.begin(), size_t{ 0 }, std::plus<size_t>(),
+			_Identity_transform(), std::random_access_iterator_tag());
+
+		// The runs out of quotes are the even ones of a chunk that starts out of them, and the odd ones otherwise
+		_Run_blocks(_Chunks, [&](size_t _Chunk) {
+			const bool _Starts_quoted = _In_quotes[_Chunk] != 0;
+			_OutIt _Out = _Dest + _Places[_Chunk];
+			_Quoted_runs(_Searcher, _Size * _Chunk / _Chunks, _Size * (_Chunk + 1) / _Chunks, _Quote, [&](size_t _Begin, size_t _End, bool _Odd) {
+				if (_Odd != _Starts_quoted)
+					return;
+
+				for (size_t _At = _Searcher._Find(_Begin, _End, _Delim); _At != _End; _At = _Searcher._Find(_At + 1, _End, _Delim))
+				{
+					*_Out = static_cast<_Offset_type>(_At);
+					++_Out;
+				}
+			}, _Is_quoted);
+		});
+
+		return _Dest + (_Places.back() + _Chunk_counts.back());
+	}
+
+	template<class _RanIt, class _El, class _OutIt, class _Quoted>
+	inline _OutIt _Split_impl(const execution_policy& _Policy, _RanIt _First, _RanIt _Last, _El _Delim, _El _Quote, _OutIt _Dest, _Quoted _Is_quoted)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Split_impl, _Policy, _First, _Last, _Delim, _Quote, _Dest, _Is_quoted);
+	}
+} // details
+
+/// <summary>
+///     Writes the offset from _First of every element of the range equal to _Delim to the range at _Dest, in order,
+///     and returns the end of the offsets written. The records of the range are the runs between the delimiters,
+///     the last one runs to the end of the range.
+/// </summary>
+/// <remarks>
+///     The delimiters are counted and found with the vector kernels of count and find on contiguous ranges of
+///     integral elements, lines of a text buffer for instance. The range at _Dest must hold as many offsets as the
+///     range has delimiters, see count.
+/// </remarks>
+template<class _ExPolicy, class _RanIt, class _Ty, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type split(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, const _Ty& _Delim, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("split");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required random access iterator.");
+
+	typedef typename std::iterator_traits<_RanIt>::value_type _El;
+	return details::_Split_impl(_Policy, _First, _Last, static_cast<_El>(_Delim), _El(), _Dest, std::false_type());
+}
+
+/// <summary>
+///     Writes the offsets of the delimiters out of quotes, see above. A _Quote starts a quoted field the delimiters
+///     of which are part of the field, the next _Quote ends it. A doubled quote in a quoted field ends it and starts
+///     another one at once, so the escaped quotes of CSV keep the delimiters after them quoted.
+/// </summary>
+template<class _ExPolicy, class _RanIt, class _Ty, class _OutIt>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type split(_ExPolicy&& _Policy, _RanIt _First, _RanIt _Last, const _Ty& _Delim, const _Ty& _Quote, _OutIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("split");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_RanIt>::iterator_category>::value, "Required random access iterator.");
+	static_assert(std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required random access iterator.");
+
+	typedef typename std::iterator_traits<_RanIt>::value_type _El;
+	return details::_Split_impl(_Policy, _First, _Last, static_cast<_El>(_Delim), static_cast<_El>(_Quote), _Dest, std::true_type());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_SPLIT_H_
@@ -0,0 +1,337 @@
+#pragma once
+
+#ifndef _IMPL_STENCIL_H_
+#define _IMPL_STENCIL_H_ 1
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "algorithm_impl.h"
+#include "copy.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     The elements around the one a stencil kernel computes. The offsets are taken from the center and
+///     must not be further than the radius of the stencil on any dimension. The elements past the edges
+///     of the view read as the closest element inside of it.
+/// </summary>
+template<class _Ty, int _Rank>
+class stencil_neighborhood
+{
+	const _Ty *_Center;
+	D4087::index<_Rank> _Stride;
+	D4087::index<_Rank> _Position;
+
+public:
+	stencil_neighborhood(const _Ty *_Center_element, const D4087::index<_Rank>& _Strides, const D4087::index<_Rank>& _Pos) : _Center(_Center_element), _Stride(_Strides), _Position(_Pos)
+	{
+	}
+
+	// Index of the center in the view
+	const D4087::index<_Rank>& position() const
+	{
+		return _Position;
+	}
+
+	const _Ty& center() const
+	{
+		return *_Center;
+	}
+
+	const _Ty& operator[](const D4087::index<_Rank>& _Offset) const
+	{
+		ptrdiff_t _Off = 0;
+		for (int _I = 0; _I < _Rank; ++_I)
+			_Off += _Offset[_I] * _Stride[_I];
+		return _Center[_Off];
+	}
+
+	// The element _Row rows and _Col columns away from the center of a two dimensional stencil
+	const _Ty& operator()(ptrdiff_t _Row, ptrdiff_t _Col) const
+	{
+		static_assert(_Rank == 2, "Required a two dimensional stencil.");
+		return _Center[_Row * _Stride[0] + _Col * _Stride[1]];
+	}
+};
+
+namespace details {
+
+	// The indexes from _Low included to _High excluded
+	template<int _Rank>
+	struct _Stencil_box
+	{
+		D4087::index<_Rank> _Low;
+		D4087::index<_Rank> _High;
+
+		// The box grown by _Margin on every side, cut to the bounds
+		_Stencil_box _Grow(ptrdiff_t _Margin, const D4087::bounds<_Rank>& _Bnd) const
+		{
+			_Stencil_box _Grown;
+			for (int _I = 0; _I < _Rank; ++_I)
+			{
+				_Grown._Low[_I] = (std::max)(_Low[_I] - _Margin, ptrdiff_t(0));
+				_Grown._High[_I] = (std::min)(_High[_I] + _Margin, _Bnd[_I]);
+			}
+			return _Grown;
+		}
+
+		size_t _Size() const
+		{
+			size_t _Count = 1;
+			for (int _I = 0; _I < _Rank; ++_I)
+				_Count *= static_cast<size_t>(_High[_I] - _Low[_I]);
+			return _Count;
+		}
+	};
+
+	// Elements laid out from _Data, which holds the one at _Origin
+	template<typename _Ty, int _Rank>
+	struct _Stencil_grid
+	{
+		_Ty *_Data;
+		D4087::index<_Rank> _Origin;
+		D4087::index<_Rank> _Stride;
+
+		_Ty *_At(const D4087::index<_Rank>& _Idx) const
+		{
+			ptrdiff_t _Offset = 0;
+			for (int _I = 0; _I < _Rank; ++_I)
+				_Offset += (_Idx[_I] - _Origin[_I]) * _Stride[_I];
+			return _Data + _Offset;
+		}
+	};
+
+	// Row major strides of the elements of a box
+	template<int _Rank>
+	inline D4087::index<_Rank> _Stencil_dense_stride(const _Stencil_box<_Rank>& _Box)
+	{
+		D4087::index<_Rank> _Stride;
+		_Stride[_Rank - 1] = 1;
+		for (int _I = _Rank - 1; _I-- > 0;)
+			_Stride[_I] = _Stride[_I + 1] * (_Box._High[_I + 1] - _Box._Low[_I + 1]);
+		return _Stride;
+	}
+
+	// The buffers a chore reuses from one tile to the next
+	template<typename _Ty>
+	struct _Stencil_scratch
+	{
+		std::vector<_Ty> _Window;
+		std::vector<_Ty> _Front;
+		std::vector<_Ty> _Back;
+	};
+
+	// Stores the kernel of the elements of _Box of _Src to _Dest. The runs of a row further than the radius from the
+	// edges read _Src in place, the elements near an edge read a copy of their window with the indexes clamped to the bounds.
+	template<typename _SrcTy, typename _DestTy, int _Rank, typename _Fn>
+	inline void _Stencil_box_step(const _Stencil_grid<_SrcTy, _Rank>& _Src, const _Stencil_box<_Rank>& _Box, const D4087::bounds<_Rank>& _Bnd, ptrdiff_t _Radius,
+		_Fn& _Kernel, const _Stencil_grid<_DestTy, _Rank>& _Dest, std::vector<typename std::remove_cv<_SrcTy>::type>& _Window)
+	{
+		typedef typename std::remove_cv<_SrcTy>::type _Ty;
+
+		const int _Last = _Rank - 1;
+		if (_Box._Size() == 0)
+			return;
+
+		D4087::bounds<_Rank> _Window_bnd;
+		for (int _I = 0; _I < _Rank; ++_I)
+			_Window_bnd[_I] = 2 * _Radius + 1;
+		const D4087::index<_Rank> _Window_stride = D4087::details::make_stride(_Window_bnd);
+
+		ptrdiff_t _Window_center = 0;
+		for (int _I = 0; _I < _Rank; ++_I)
+			_Window_center += _Radius * _Window_stride[_I];
+		const ptrdiff_t _Src_step = _Src._Stride[_Last];
+		const ptrdiff_t _Dest_step = _Dest._Stride[_Last];
+
+		D4087::index<_Rank> _Idx = _Box._Low;
+		for (;;)
+		{
+			bool _Inner_rows = true;
+			for (int _I = 0; _I < _Last; ++_I)
+				_Inner_rows = _Inner_rows && _Idx[_I] >= _Radius && _Idx[_I] < _Bnd[_I] - _Radius;
+
+			const ptrdiff_t _Begin = _Box._Low[_Last];
+			const ptrdiff_t _End = _Box._High[_Last];
+			const ptrdiff_t _Inner_begin = _Inner_rows ? (std::min)((std::max)(_Begin, _Radius), _End) : _End;
+			const ptrdiff_t _Inner_end = _Inner_rows ? (std::max)((std::min)(_End, _Bnd[_Last] - _Radius), _Inner_begin) : _End;
+
+			for (_Idx[_Last] = _Begin; _Idx[_Last] < _End; ++_Idx[_Last])
+			{
+				if (_Idx[_Last] == _Inner_begin && _Inner_begin < _Inner_end)
+				{
+					const _Ty *_Center = _Src._At(_Idx);
+					_DestTy *_Out = _Dest._At(_Idx);
+					for (; _Idx[_Last] < _Inner_end; ++_Idx[_Last], _Center += _Src_step, _Out += _Dest_step)
+						*_Out = _Kernel(stencil_neighborhood<_Ty, _Rank>(_Center, _Src._Stride, _Idx));
+
+					if (_Idx[_Last] == _End)
+						break;
+				}
+
+				_Window.clear();
+				for (auto _Offset : _Window_bnd)
+				{
+					D4087::index<_Rank> _Near;
+					for (int _I = 0; _I < _Rank; ++_I)
+						_Near[_I] = (std::min)((std::max)(_Idx[_I] + _Offset[_I] - _Radius, ptrdiff_t(0)), _Bnd[_I] - 1);
+					_Window.push_back(*_Src._At(_Near));
+				}
+
+				const _Ty *_Center = _Window.data() + _Window_center;
+				*_Dest._At(_Idx) = _Kernel(stencil_neighborhood<_Ty, _Rank>(_Center, _Window_stride, _Idx));
+			}
+
+			int _Dim = _Last;
+			while (_Dim-- > 0)
+			{
+				if (++_Idx[_Dim] < _Box._High[_Dim])
+					break;
+				_Idx[_Dim] = _Box._Low[_Dim];
+			}
+			if (_Dim < 0)
+				return;
+		}
+	}
+
+	// Runs the steps of a stencil for the elements of a tile. The steps before the last one compute the tile and the halo
+	// the following steps read around it in the buffers of the chore, the last one stores the tile to the output.
+	template<typename _Ty, typename _OutTy, int _Rank, typename _Fn>
+	struct _Stencil_tile
+	{
+		const _Stencil_grid<const _Ty, _Rank>& _In;
+		const _Stencil_grid<_OutTy, _Rank>& _Out;
+		const D4087::bounds<_Rank>& _Bnd;
+		ptrdiff_t _Radius;
+		size_t _Steps;
+		_Fn& _Kernel;
+		_Stencil_scratch<_Ty>& _Scratch;
+
+		void operator()(const D4087::index<_Rank>& _Origin, const D4087::bounds<_Rank>& _Tile_bnd) const
+		{
+			_Stencil_box<_Rank> _Tile;
+			for (int _I = 0; _I < _Rank; ++_I)
+			{
+				_Tile._Low[_I] = _Origin[_I];
+				_Tile._High[_I] = _Origin[_I] + _Tile_bnd[_I];
+			}
+
+			if (_Steps == 1)
+			{
+				_Stencil_box_step(_In, _Tile, _Bnd, _Radius, _Kernel, _Out, _Scratch._Window);
+				return;
+			}
+
+			const _Stencil_box<_Rank> _Halo = _Tile._Grow(_Radius * static_cast<ptrdiff_t>(_Steps - 1), _Bnd);
+			const D4087::index<_Rank> _Stride = _Stencil_dense_stride(_Halo);
+			_Scratch._Front.assign(_Halo._Size(), *_In._At(_Origin));
+			_Scratch._Back.assign(_Halo._Size(), *_In._At(_Origin));
+
+			_Stencil_grid<_Ty, _Rank> _Front = { _Scratch._Front.data(), _Halo._Low, _Stride };
+			_Stencil_box_step(_In, _Halo, _Bnd, _Radius, _Kernel, _Front, _Scratch._Window);
+
+			for (size_t _Step = 2; _Step < _Steps; ++_Step)
+			{
+				const _Stencil_grid<_Ty, _Rank> _Back = { _Scratch._Back.data(), _Halo._Low, _Stride };
+				_Stencil_box_step(_Front, _Tile._Grow(_Radius * static_cast<ptrdiff_t>(_Steps - _Step), _Bnd), _Bnd, _Radius, _Kernel, _Back, _Scratch._Window);
+				_Scratch._Front.swap(_Scratch._Back);
+				_Front._Data = _Scratch._Front.data();
+			}
+
+			_Stencil_box_step(_Front, _Tile, _Bnd, _Radius, _Kernel, _Out, _Scratch._Window);
+		}
+	};
+
+	// The input and the output of a stencil from index 0 of their views
+	template<typename _Ty, int _Rank, typename _ViewTy>
+	inline _Stencil_grid<_Ty, _Rank> _Make_stencil_grid(const D4087::strided_array_view<_ViewTy, _Rank>& _View)
+	{
+		const _Stencil_grid<_Ty, _Rank> _Grid = { _View_data(_View), D4087::index<_Rank>(), _View.stride() };
+		return _Grid;
+	}
+
+	template<class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Stencil_impl(const sequential_execution_policy&, const D4087::strided_array_view<_InTy, _Rank>& _In_view, const D4087::strided_array_view<_OutTy, _Rank>& _Out_view, ptrdiff_t _Radius, size_t _Steps, _Fn _Kernel)
+	{
+		typedef typename std::remove_cv<_InTy>::type _Ty;
+
+		const D4087::bounds<_Rank> _Bnd = _In_view.bounds();
+		const _Tiling<_Rank> _Tiles(_Bnd, _Default_tile_shape(_Bnd));
+		const _Stencil_grid<const _Ty, _Rank> _In = _Make_stencil_grid<const _Ty>(_In_view);
+		const _Stencil_grid<_OutTy, _Rank> _Out = _Make_stencil_grid<_OutTy>(_Out_view);
+
+		_EXP_TRY
+			_Stencil_scratch<_Ty> _Scratch;
+			_Stencil_tile<_Ty, _OutTy, _Rank, _Fn> _Tile = { _In, _Out, _Bnd, _Radius, _Steps, _Kernel, _Scratch };
+			for (auto _Tile_idx : _Tiles._Tiles())
+				_Tiles._Apply(_Tile_idx, _Tile);
+		_EXP_RETHROW
+	}
+
+	// The chores take runs of neighbouring tiles, the buffers of the halo are allocated once per chore
+	template<class _ExPolicy, class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Stencil_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _In_view, const D4087::strided_array_view<_OutTy, _Rank>& _Out_view, ptrdiff_t _Radius, size_t _Steps, _Fn _Kernel)
+	{
+		typedef typename std::remove_cv<_InTy>::type _Ty;
+
+		const D4087::bounds<_Rank> _Bnd = _In_view.bounds();
+		const _Tiling<_Rank> _Tiles(_Bnd, _Default_tile_shape(_Bnd));
+		const _Stencil_grid<const _Ty, _Rank> _In = _Make_stencil_grid<const _Ty>(_In_view);
+		const _Stencil_grid<_OutTy, _Rank> _Out = _Make_stencil_grid<_OutTy>(_Out_view);
+
+		_Partitioned_for_each(_Policy, std::begin(_Tiles._Tiles()), _Tiles._Tiles().size(), _Kernel,
+			[&_Tiles, &_In, &_Out, &_Bnd, _Radius, _Steps](D4087::bounds_iterator<_Rank> _Begin, size_t _Count, _Fn& _UserKernel) {
+			_Stencil_scratch<_Ty> _Scratch;
+			_Stencil_tile<_Ty, _OutTy, _Rank, _Fn> _Tile = { _In, _Out, _Bnd, _Radius, _Steps, _UserKernel, _Scratch };
+			for (size_t _I = 0; _I < _Count; ++_Begin, ++_I)
+				_Tiles._Apply(*_Begin, _Tile);
+		});
+	}
+
+	template<class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Stencil_impl(const execution_policy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _In_view, const D4087::strided_array_view<_OutTy, _Rank>& _Out_view, ptrdiff_t _Radius, size_t _Steps, _Fn _Kernel)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Stencil_impl, _Policy, _In_view, _Out_view, _Radius, _Steps, _Kernel);
+	}
+} // details
+
+/// <summary>
+///     Applies _Kernel _Steps times to _In_view and stores the result to _Out_view. A step stores _Kernel(neighborhood)
+///     for every index, where neighborhood is the stencil_neighborhood of the elements within _Radius of the index in the
+///     result of the step before. The views have the same bounds and don't overlap, _In_view isn't written.
+///     The elements are computed tile by tile. A tile runs all the steps by itself on a halo of _Radius * (_Steps - 1)
+///     elements around it kept in the buffers of its chore, the steps in between aren't stored to memory shared with
+///     the other threads. The elements of a halo are computed by every tile that reads them.
+/// </summary>
+template<class _ExPolicy, class _InView, class _OutView, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type stencil(_ExPolicy&& _Policy, const _InView& _In_view, const _OutView& _Out_view, ptrdiff_t _Radius, _Fn _Kernel, size_t _Steps)
+{
+	_EXP_TELEMETRY_ALGORITHM("stencil");
+	static_assert(_InView::rank == _OutView::rank, "Required views of the same rank.");
+	_ASSERTE(_In_view.bounds() == _Out_view.bounds());
+	_ASSERTE(_Radius >= 0);
+
+	if (_In_view.size() == 0)
+		return;
+
+	if (_Steps == 0)
+		copy(_Policy, _In_view, _Out_view);
+	else
+		details::_Stencil_impl(_Policy, details::_Strided_view(_In_view), details::_Strided_view(_Out_view), _Radius, _Steps, _Kernel);
+}
+
+/// <summary>
+///     Stores _Kernel(neighborhood) to every element of _Out_view, where neighborhood is the stencil_neighborhood of the
+///     elements of _In_view within _Radius of the same index. The elements of the interior of the view are read in place,
+///     the ones within the radius of an edge read a copy of their neighborhood.
+/// </summary>
+template<class _ExPolicy, class _InView, class _OutView, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type stencil(_ExPolicy&& _Policy, const _InView& _In_view, const _OutView& _Out_view, ptrdiff_t _Radius, _Fn _Kernel)
+{
+	_EXP_TELEMETRY_ALGORITHM("stencil");
+	stencil(_Policy, _In_view, _Out_view, _Radius, _Kernel, 1);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_STENCIL_H_
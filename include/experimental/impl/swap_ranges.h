@@ -4,6 +4,7 @@
 #define _IMPL_SWAP_RANGES_H_ 1
 
 #include "algorithm_impl.h"
+#include "bulk_memory.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -18,13 +19,46 @@ namespace details {
 		_EXP_RETHROW
 	}
 
+	template <class _FwdIt, class _FwdIt2>
+	inline void _Swap_ranges_chore(_FwdIt _First, size_t _Count, _FwdIt2 _First2)
+	{
+		for (size_t _I = 0; _I < _Count; ++_First, ++_First2, ++_I)
+			swap(*_First, *_First2);
+	}
+
+	// A chore of contiguous ranges swaps through raw pointers at one shared offset
+	template <class _ExPolicy, class _FwdIt, class _FwdIt2, class _IterCat>
+	_FwdIt2 _Swap_ranges_helper(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _IterCat, std::false_type)
+	{
+		typedef composable_iterator<_FwdIt, _FwdIt2> _Iter_type;
+
+		if (_First == _Last)
+			return _First2;
+
+		return std::get<1>(*_Partitioned_for_each(_Policy, make_composable_iterator(_First, _First2), std::distance(_First, _Last), 0,
+			[](_Iter_type _Begin, size_t _Count, int&) {
+			const typename _Iter_type::value_type _Pos = *_Begin;
+			_Swap_ranges_chore(_Unwrap_zip_member(std::get<0>(_Pos)), _Count, _Unwrap_zip_member(std::get<1>(_Pos)));
+		}));
+	}
+
+	// The chunks of trivially copyable contiguous ranges swap through raw pointers, on page boundaries
+	template <class _ExPolicy, class _FwdIt, class _FwdIt2, class _IterCat>
+	_FwdIt2 _Swap_ranges_helper(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _IterCat, std::true_type)
+	{
+		if (_First == _Last)
+			return _First2;
+
+		const auto _Count = _Last - _First;
+		_Bulk_swap(_Policy, _Unwrap_contiguous(_First), static_cast<size_t>(_Count), _Unwrap_contiguous(_First2));
+		return _First2 + _Count;
+	}
+
 	template <class _ExPolicy, class _FwdIt, class _FwdIt2, class _IterCat>
 	_FwdIt2 _Swap_ranges_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2, _IterCat _Cat)
 	{
-		return std::get<1>(*_For_each_n_impl(_Policy, make_composable_iterator(_First, _First2), std::distance(_First, _Last),
-			[](typename composable_iterator<_FwdIt, _FwdIt2>::reference _It){
-			swap(*std::get<0>(_It), *std::get<1>(_It));
-		}, _Cat));
+		return _Swap_ranges_helper(_Policy, _First, _Last, _First2, _Cat, std::integral_constant<bool, _Is_memcpy_range<_FwdIt, _FwdIt2>::value
+			&& !std::is_const<typename std::remove_pointer<typename std::iterator_traits<_FwdIt>::pointer>::type>::value>());
 	}
 
 	template <class _FwdIt, class _FwdIt2, class _IterCat>
@@ -37,6 +71,7 @@ namespace details {
 template <class _ExPolicy, class _FwdIt, class _FwdIt2>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt2>::type swap_ranges(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _FwdIt2 _First2)
 {
+	_EXP_TELEMETRY_ALGORITHM("swap_ranges");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt2>::iterator_category>::value, "Required forward iterator or stronger.");
 
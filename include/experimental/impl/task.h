@@ -0,0 +1,431 @@
+#pragma once
+
+#ifndef _IMPL_TASK_H_
+#define _IMPL_TASK_H_ 1
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "defines.h"
+#include "event.h"
+#include "algorithm_scheduler.h"
+#include "taskgroup.h"
+
+_PSTL_NS1_BEGIN
+
+template<class _Ty> class task_future;
+
+namespace details {
+
+	template<class _Ty> class _Task_state;
+
+	// Creates the futures of the states and reaches the state of a future
+	struct _Task_access
+	{
+		template<class _Ty>
+		static task_future<_Ty> _Make(std::shared_ptr<_Task_state<_Ty>> _State)
+		{
+			return task_future<_Ty>(std::move(_State));
+		}
+
+		template<class _Ty>
+		static const std::shared_ptr<_Task_state<_Ty>>& _State_of(const task_future<_Ty>& _Future)
+		{
+			if (!_Future.valid())
+				throw std::future_error(std::make_error_code(std::future_errc::no_state));
+			return _Future._State;
+		}
+	};
+
+	// The shared state of a task_future: the completion, the exception and the callbacks to run on completion
+	class _Task_state_base
+	{
+		std::mutex _Lock;
+		std::vector<std::function<void()>> _Callbacks;
+		std::atomic<bool> _Ready;
+		Event _Done;
+
+	protected:
+		std::exception_ptr _Exception;
+
+		// Publishes the result, wakes the waiters and runs the callbacks registered so far on the calling thread
+		void _Complete()
+		{
+			std::vector<std::function<void()>> _Pending;
+			{
+				std::lock_guard<std::mutex> _Guard(_Lock);
+				_Ready.store(true, std::memory_order_release);
+				_Pending.swap(_Callbacks);
+			}
+			_Done.set();
+
+			for (auto& _Callback : _Pending)
+				_Callback();
+		}
+
+	public:
+		_Task_state_base() : _Ready(false)
+		{
+		}
+
+		_Task_state_base(const _Task_state_base&) = delete;
+		_Task_state_base& operator=(const _Task_state_base&) = delete;
+
+		bool _Is_ready() const
+		{
+			return _Ready.load(std::memory_order_acquire);
+		}
+
+		void _Wait()
+		{
+			if (_Is_ready())
+				return;
+
+			// Run queued chores, possibly the ones of the awaited algorithm, before blocking
+			while (!_Is_ready() && help_with_stolen_chore())
+			{
+			}
+			_Done.wait();
+		}
+
+		// Runs _Callback once the state is ready, right away if it already is
+		void _On_ready(std::function<void()> _Callback)
+		{
+			{
+				std::lock_guard<std::mutex> _Guard(_Lock);
+				if (!_Ready.load(std::memory_order_relaxed)) {
+					_Callbacks.push_back(std::move(_Callback));
+					return;
+				}
+			}
+			_Callback();
+		}
+
+		void _Rethrow()
+		{
+			if (_Exception)
+				std::rethrow_exception(_Exception);
+		}
+	};
+
+	template<class _Ty>
+	class _Task_state : public _Task_state_base
+	{
+		typename std::aligned_storage<sizeof(_Ty), std::alignment_of<_Ty>::value>::type _Storage;
+		bool _Has_value;
+
+	public:
+		_Task_state() : _Has_value(false)
+		{
+		}
+
+		~_Task_state()
+		{
+			if (_Has_value)
+				reinterpret_cast<_Ty *>(&_Storage)->~_Ty();
+		}
+
+		template<class _Fn>
+		void _Run(_Fn& _Func)
+		{
+			try {
+				::new (static_cast<void *>(&_Storage)) _Ty(_Func());
+				_Has_value = true;
+			}
+			catch (...) {
+				_Exception = std::current_exception();
+			}
+			_Complete();
+		}
+
+		void _Set_value(_Ty&& _Val)
+		{
+			::new (static_cast<void *>(&_Storage)) _Ty(std::move(_Val));
+			_Has_value = true;
+			_Complete();
+		}
+
+		_Ty _Take()
+		{
+			_Rethrow();
+			return std::move(*reinterpret_cast<_Ty *>(&_Storage));
+		}
+	};
+
+	template<>
+	class _Task_state<void> : public _Task_state_base
+	{
+	public:
+		template<class _Fn>
+		void _Run(_Fn& _Func)
+		{
+			try {
+				_Func();
+			}
+			catch (...) {
+				_Exception = std::current_exception();
+			}
+			_Complete();
+		}
+
+		void _Take()
+		{
+			_Rethrow();
+		}
+	};
+
+	// Runs _Func on a thread of the library into the state, then deletes itself
+	template<class _Ty, class _Fn>
+	class _Task_chore : public _Threadpool_chore
+	{
+		std::shared_ptr<_Task_state<_Ty>> _State;
+		_Fn _Func;
+
+	public:
+		_Task_chore(std::shared_ptr<_Task_state<_Ty>> _St, _Fn&& _Fn_arg) : _State(std::move(_St)), _Func(std::move(_Fn_arg))
+		{
+		}
+
+		virtual void __cdecl invoke() override
+		{
+			_State->_Run(_Func);
+			delete this;
+		}
+	};
+
+	template<class _Ty, class _Fn>
+	inline void _Schedule_task(const std::shared_ptr<_Task_state<_Ty>>& _State, _Fn&& _Func)
+	{
+		std::unique_ptr<_Task_chore<_Ty, std::decay_t<_Fn>>> _Chore(new _Task_chore<_Ty, std::decay_t<_Fn>>(_State, std::forward<_Fn>(_Func)));
+		schedule_chore(_Chore.get());
+		_Chore.release();
+	}
+
+	// Starts _Func asynchronously and returns the future of its result
+	template<class _Fn>
+	inline task_future<typename std::result_of<_Fn()>::type> _Run_task(_Fn&& _Func)
+	{
+		typedef typename std::result_of<_Fn()>::type _Ty;
+
+		auto _State = std::make_shared<_Task_state<_Ty>>();
+		_Schedule_task(_State, std::forward<_Fn>(_Func));
+		return _Task_access::_Make(std::move(_State));
+	}
+
+	// Gathers the futures passed to when_all, the last one to complete hands them to the result
+	template<class _Futures>
+	struct _When_all_state
+	{
+		_Futures _Inputs;
+		std::atomic<size_t> _Pending;
+		std::shared_ptr<_Task_state<_Futures>> _Result;
+
+		_When_all_state(_Futures&& _In, size_t _Count)
+			: _Inputs(std::move(_In)), _Pending(_Count + 1), _Result(std::make_shared<_Task_state<_Futures>>())
+		{
+		}
+
+		void _Complete_one()
+		{
+			if (--_Pending == 0)
+				_Result->_Set_value(std::move(_Inputs));
+		}
+
+		template<class _Ty>
+		static void _Watch(const std::shared_ptr<_When_all_state>& _Self, const task_future<_Ty>& _Future)
+		{
+			_Task_access::_State_of(_Future)->_On_ready([_Self] { _Self->_Complete_one(); });
+		}
+	};
+
+	// Watches the first _Count futures of the tuple
+	template<size_t _Count, class _Tuple>
+	struct _Watch_tuple
+	{
+		static void _Apply(const std::shared_ptr<_When_all_state<_Tuple>>& _Self)
+		{
+			_When_all_state<_Tuple>::_Watch(_Self, std::get<_Count - 1>(_Self->_Inputs));
+			_Watch_tuple<_Count - 1, _Tuple>::_Apply(_Self);
+		}
+	};
+
+	template<class _Tuple>
+	struct _Watch_tuple<0, _Tuple>
+	{
+		static void _Apply(const std::shared_ptr<_When_all_state<_Tuple>>&)
+		{
+		}
+	};
+
+	template<class _Ty>
+	struct _Is_task_future : std::false_type
+	{
+	};
+
+	template<class _Ty>
+	struct _Is_task_future<task_future<_Ty>> : std::true_type
+	{
+	};
+
+	// The future when_all returns for a range, none for two futures
+	template<class _InIt, bool = _Is_task_future<_InIt>::value>
+	struct _When_all_range
+	{
+	};
+
+	template<class _InIt>
+	struct _When_all_range<_InIt, false>
+	{
+		typedef std::vector<typename std::iterator_traits<_InIt>::value_type> _Vector;
+		typedef task_future<_Vector> type;
+	};
+}
+
+/// <summary>
+///     The future of an algorithm run under a parallel_task_execution_policy, or of a continuation. The result is
+///     taken once with <c>get</c>, which rethrows the exception of the algorithm if it threw one.
+/// </summary>
+template<class _Ty>
+class task_future
+{
+	std::shared_ptr<details::_Task_state<_Ty>> _State;
+
+	friend struct details::_Task_access;
+
+	explicit task_future(std::shared_ptr<details::_Task_state<_Ty>> _St) : _State(std::move(_St))
+	{
+	}
+
+	const details::_Task_state<_Ty>& _Checked_state() const
+	{
+		if (!_State)
+			throw std::future_error(std::make_error_code(std::future_errc::no_state));
+		return *_State;
+	}
+
+public:
+	task_future() _NOEXCEPT
+	{
+	}
+
+	task_future(task_future&& _Other) _NOEXCEPT : _State(std::move(_Other._State))
+	{
+	}
+
+	task_future& operator=(task_future&& _Other) _NOEXCEPT
+	{
+		_State = std::move(_Other._State);
+		return *this;
+	}
+
+	task_future(const task_future&) = delete;
+	task_future& operator=(const task_future&) = delete;
+
+	/// <summary>
+	///     Returns true if the future refers to a result that was not taken yet.
+	/// </summary>
+	bool valid() const _NOEXCEPT
+	{
+		return _State != nullptr;
+	}
+
+	/// <summary>
+	///     Returns true if the result is there, get won't block.
+	/// </summary>
+	bool is_ready() const
+	{
+		return _Checked_state()._Is_ready();
+	}
+
+	/// <summary>
+	///     Blocks until the result is there. The thread runs queued chores of the library meanwhile.
+	/// </summary>
+	void wait() const
+	{
+		_Checked_state();
+		_State->_Wait();
+	}
+
+	/// <summary>
+	///     Waits for the result and takes it, the future is no longer valid afterwards.
+	/// </summary>
+	_Ty get()
+	{
+		wait();
+		auto _St = std::move(_State);
+		return _St->_Take();
+	}
+
+	/// <summary>
+	///     Runs <c>_Func(std::move(*this))</c> on a thread of the library once the result is there, and returns
+	///     the future of its result. The future is no longer valid afterwards.
+	/// </summary>
+	template<class _Fn>
+	task_future<typename std::result_of<_Fn(task_future)>::type> then(_Fn _Func)
+	{
+		typedef typename std::result_of<_Fn(task_future)>::type _Result;
+
+		_Checked_state();
+		auto _Antecedent = std::move(_State);
+		auto _Next = std::make_shared<details::_Task_state<_Result>>();
+		_Antecedent->_On_ready([_Antecedent, _Next, _Func]() mutable {
+			auto _Prev = _Antecedent;
+			details::_Schedule_task(_Next, [_Prev, _Func]() mutable {
+				return _Func(details::_Task_access::_Make(std::move(_Prev)));
+			});
+		});
+		return details::_Task_access::_Make(std::move(_Next));
+	}
+};
+
+/// <summary>
+///     Returns the future of a tuple that holds the futures passed in, ready once all of them are.
+/// </summary>
+template<class... _Types>
+inline task_future<std::tuple<task_future<_Types>...>> when_all(task_future<_Types>&&... _Futures)
+{
+	typedef std::tuple<task_future<_Types>...> _Tuple;
+
+	auto _Gather = std::make_shared<details::_When_all_state<_Tuple>>(_Tuple(std::move(_Futures)...), sizeof...(_Types));
+	details::_Watch_tuple<sizeof...(_Types), _Tuple>::_Apply(_Gather);
+	_Gather->_Complete_one();
+	return details::_Task_access::_Make(_Gather->_Result);
+}
+
+/// <summary>
+///     Moves the futures of the range into a vector and returns the future of it, ready once all of them are.
+/// </summary>
+template<class _InIt>
+inline typename details::_When_all_range<_InIt>::type when_all(_InIt _First, _InIt _Last)
+{
+	typedef typename details::_When_all_range<_InIt>::_Vector _Vector;
+
+	_Vector _Inputs(std::make_move_iterator(_First), std::make_move_iterator(_Last));
+	const size_t _Count = _Inputs.size();
+	auto _Gather = std::make_shared<details::_When_all_state<_Vector>>(std::move(_Inputs), _Count);
+	for (auto& _Future : _Gather->_Inputs)
+		details::_When_all_state<_Vector>::_Watch(_Gather, _Future);
+	_Gather->_Complete_one();
+	return details::_Task_access::_Make(_Gather->_Result);
+}
+
+namespace details {
+
+	template<class _ExPolicy, class _Ty = void>
+	struct _enable_if_task_policy : std::enable_if<std::is_same<typename std::decay<_ExPolicy>::type, parallel_task_execution_policy>::value, _Ty>
+	{
+	};
+}
+
+_PSTL_NS1_END
+
+#endif // _IMPL_TASK_H_
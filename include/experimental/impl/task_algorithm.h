@@ -0,0 +1,92 @@
+#pragma once
+
+#ifndef _IMPL_TASK_ALGORITHM_H_
+#define _IMPL_TASK_ALGORITHM_H_ 1
+
+#include "algorithm_impl.h"
+#include "copy.h"
+#include "fill.h"
+#include "foreach.h"
+#include "sort.h"
+#include "task.h"
+#include "transform.h"
+
+// The algorithms under parallel_task_execution_policy start the algorithm under the inner
+// parallel_execution_policy on a thread of the library and return the future of its result
+
+_PSTL_NS1_BEGIN
+
+template<class _ExPolicy, class _InIt, class _Fn>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type for_each(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Fn _Func)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { for_each(_Inner, _First, _Last, _Func); });
+}
+
+template<class _ExPolicy, class _InIt, class _Diff, class _Fn>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_InIt>>::type for_each_n(_ExPolicy&& _Policy, _InIt _First, _Diff _Count, _Fn _Func)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return for_each_n(_Inner, _First, _Count, _Func); });
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _Fn>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type transform(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return transform(_Inner, _First, _Last, _Dest, _Func); });
+}
+
+template<class _ExPolicy, class _InIt, class _InIt2, class _OutIt, class _Fn>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type transform(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _OutIt _Dest, _Fn _Func)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return transform(_Inner, _First, _Last, _First2, _Dest, _Func); });
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return copy(_Inner, _First, _Last, _Dest); });
+}
+
+/// <summary>
+///     The value is copied into the task.
+/// </summary>
+template<class _ExPolicy, class _FwdIt, class _Ty>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type fill(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, const _Ty& _Val)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	const _Ty _Value = _Val;
+	return details::_Run_task([=] { fill(_Inner, _First, _Last, _Value); });
+}
+
+template<class _ExPolicy, class _FwdIt, class _Pr>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { sort(_Inner, _First, _Last, _Pred); });
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	return sort(std::forward<_ExPolicy>(_Policy), _First, _Last, std::less<>());
+}
+
+template<class _ExPolicy, class _FwdIt, class _Pr>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type stable_sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { stable_sort(_Inner, _First, _Last, _Pred); });
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<void>>::type stable_sort(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	return stable_sort(std::forward<_ExPolicy>(_Policy), _First, _Last, std::less<>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TASK_ALGORITHM_H_
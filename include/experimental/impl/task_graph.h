@@ -0,0 +1,235 @@
+#pragma once
+
+#ifndef _IMPL_TASK_GRAPH_H_
+#define _IMPL_TASK_GRAPH_H_ 1
+
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include <experimental/exception>
+#include "defines.h"
+#include "taskgroup.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     A graph of functions and the order they run in. <c>run</c> starts the nodes without predecessors, and a node
+///     whose last predecessor completes goes to the work-stealing queue of the thread that completed it, where its
+///     data likely sits in the cache. One of the nodes a completion makes ready runs right away on that thread.
+///     A node may call the parallel algorithms, they run inline as from any other thread. The graph is built once and
+///     run any number of times, a run allocates nothing.
+/// </summary>
+class task_graph
+{
+	class _Node;
+
+	// The chore that runs a node and what it makes ready, scheduled again at every run
+	class _Node_chore : public details::WorkChoreBase
+	{
+		_Node *_Owner;
+
+	protected:
+		virtual void __cdecl userFunc() override
+		{
+			_Owner->_Graph->_Execute(_Owner);
+		}
+
+	public:
+		explicit _Node_chore(_Node *_Nd) : _Owner(_Nd)
+		{
+		}
+
+		void _Reset()
+		{
+			resetTaskGroup();
+		}
+	};
+
+	class _Node
+	{
+	public:
+		task_graph *_Graph;
+		size_t _Id;
+		std::function<void()> _Body;
+		std::vector<_Node *> _Successors;
+		size_t _Predecessors;
+		std::atomic<size_t> _Pending; // predecessors that did not complete yet in the current run
+		_Node_chore _Chore;
+
+		_Node(task_graph *_Gr, size_t _Index, std::function<void()>&& _Fn)
+			: _Graph(_Gr), _Id(_Index), _Body(std::move(_Fn)), _Predecessors(0), _Pending(0), _Chore(this)
+		{
+		}
+	};
+
+	std::vector<std::unique_ptr<_Node>> _Nodes;
+	std::vector<_Node *> _Roots;
+	bool _Checked;
+	std::atomic<bool> _Cancelled;
+	std::mutex _Lock;
+	std::list<std::exception_ptr> _Exceptions;
+
+	void _Invoke(_Node *_Nd)
+	{
+		if (_Cancelled.load(std::memory_order_relaxed))
+			return;
+
+		try {
+			_Nd->_Body();
+		}
+		catch (...) {
+			_Cancelled.store(true, std::memory_order_relaxed);
+			std::lock_guard<std::mutex> _Guard(_Lock);
+			_Exceptions.push_back(std::current_exception());
+		}
+	}
+
+	// Runs the node, then the nodes it makes ready: the first one on this thread, the others through
+	// the queue of this thread
+	void _Execute(_Node *_First)
+	{
+		details::TaskGroup _Tg;
+		_Node *_Next = _First;
+		while (_Next != nullptr)
+		{
+			_Node *_Current = _Next;
+			_Next = nullptr;
+			_Invoke(_Current);
+
+			for (auto _Succ : _Current->_Successors)
+			{
+				if (--_Succ->_Pending != 0)
+					continue;
+
+				if (_Next == nullptr)
+					_Next = _Succ;
+				else {
+					_Succ->_Chore._Reset();
+					_Tg.run(_Succ->_Chore);
+				}
+			}
+		}
+		_Tg.wait();
+	}
+
+	// Finds the roots, and rejects a graph with a cycle since its nodes would never run
+	void _Check()
+	{
+		if (_Checked)
+			return;
+
+		std::vector<size_t> _Count(_Nodes.size());
+		std::vector<_Node *> _Ready;
+		for (size_t _Idx = 0; _Idx < _Nodes.size(); ++_Idx)
+		{
+			_Count[_Idx] = _Nodes[_Idx]->_Predecessors;
+			if (_Count[_Idx] == 0)
+				_Ready.push_back(_Nodes[_Idx].get());
+		}
+		_Roots = _Ready;
+
+		size_t _Visited = 0;
+		while (!_Ready.empty())
+		{
+			_Node *_Nd = _Ready.back();
+			_Ready.pop_back();
+			++_Visited;
+			for (auto _Succ : _Nd->_Successors)
+			{
+				if (--_Count[_Succ->_Id] == 0)
+					_Ready.push_back(_Succ);
+			}
+		}
+
+		if (_Visited != _Nodes.size())
+			throw std::invalid_argument("The task graph has a cycle.");
+		_Checked = true;
+	}
+
+public:
+	/// <summary>
+	///     Identifies a node of the graph.
+	/// </summary>
+	typedef size_t node;
+
+	task_graph() : _Checked(true), _Cancelled(false)
+	{
+	}
+
+	task_graph(const task_graph&) = delete;
+	task_graph& operator=(const task_graph&) = delete;
+
+	/// <summary>
+	///     Adds a node that calls <c>_Func()</c>.
+	/// </summary>
+	template<typename _Fn>
+	node add_node(_Fn _Func)
+	{
+		_Nodes.emplace_back(new _Node(this, _Nodes.size(), std::function<void()>(std::move(_Func))));
+		_Checked = false;
+		return _Nodes.size() - 1;
+	}
+
+	/// <summary>
+	///     Makes the node <c>_To</c> run after the node <c>_From</c>.
+	/// </summary>
+	void add_edge(node _From, node _To)
+	{
+		if (_From >= _Nodes.size() || _To >= _Nodes.size() || _From == _To)
+			throw std::invalid_argument("Invalid edge of the task graph.");
+
+		_Nodes[_From]->_Successors.push_back(_Nodes[_To].get());
+		++_Nodes[_To]->_Predecessors;
+		_Checked = false;
+	}
+
+	/// <summary>
+	///     Returns the number of nodes.
+	/// </summary>
+	size_t size() const _NOEXCEPT
+	{
+		return _Nodes.size();
+	}
+
+	/// <summary>
+	///     Runs every node once, each after its predecessors, and returns when all of them completed. After a node
+	///     threw, the nodes that did not start yet are skipped, and run throws an exception_list of the exceptions.
+	///     Throws std::invalid_argument if the edges form a cycle.
+	/// </summary>
+	void run()
+	{
+		_Check();
+		if (_Roots.empty())
+			return;
+
+		for (auto& _Nd : _Nodes)
+			_Nd->_Pending.store(_Nd->_Predecessors, std::memory_order_relaxed);
+		_Cancelled.store(false, std::memory_order_relaxed);
+
+		{
+			details::TaskGroup _Tg;
+			for (size_t _Idx = 1; _Idx < _Roots.size(); ++_Idx)
+			{
+				_Roots[_Idx]->_Chore._Reset();
+				_Tg.run(_Roots[_Idx]->_Chore);
+			}
+			_Execute(_Roots[0]);
+			_Tg.wait();
+		}
+
+		if (!_Exceptions.empty())
+		{
+			std::list<std::exception_ptr> _List;
+			_List.swap(_Exceptions);
+			throw exception_list(std::move(_List));
+		}
+	}
+};
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TASK_GRAPH_H_
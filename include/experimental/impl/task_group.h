@@ -0,0 +1,310 @@
+#pragma once
+
+#ifndef _IMPL_TASK_GROUP_H_
+#define _IMPL_TASK_GROUP_H_ 1
+
+#include <exception>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <experimental/exception>
+#include "defines.h"
+#include "taskgroup.h"
+
+_PSTL_NS1_BEGIN
+
+class task_group;
+
+namespace details {
+
+	// The exceptions thrown by the functions of a task_group, thrown as one exception_list by its wait
+	class _Task_group_errors
+	{
+		std::mutex _Lock;
+		std::list<std::exception_ptr> _Exceptions;
+
+	public:
+		void _Capture()
+		{
+			std::lock_guard<std::mutex> _Guard(_Lock);
+			_Exceptions.push_back(std::current_exception());
+		}
+
+		void _Rethrow()
+		{
+			std::list<std::exception_ptr> _List;
+			_List.swap(_Exceptions);
+			if (!_List.empty())
+				throw exception_list(std::move(_List));
+		}
+	};
+
+	// The chores don't throw, an exception of the function goes to the errors of its group
+	template<typename _Fn>
+	struct _Task_group_call
+	{
+		_Fn _Func;
+		_Task_group_errors *_Errors;
+
+		void operator()()
+		{
+			try {
+				_Func();
+			}
+			catch (...) {
+				_Errors->_Capture();
+			}
+		}
+	};
+
+	// A chore the task_group owns, in its inline buffer or on the heap
+	struct _Owned_chore_base
+	{
+		_Owned_chore_base *_Next;
+		void (*_Destroy)(_Owned_chore_base *);
+	};
+}
+
+/// <summary>
+///     A function to run in a task_group, stored in the handle itself. A handle declared on the stack of the caller
+///     makes the run of the function allocate nothing. It is run once, and must outlive the wait of its group.
+/// </summary>
+template<typename _Fn>
+class task_handle : public details::UserWorkChore<details::_Task_group_call<_Fn>>
+{
+	typedef details::UserWorkChore<details::_Task_group_call<_Fn>> _Base;
+
+	friend class task_group;
+
+public:
+	explicit task_handle(const _Fn& _Func) : _Base(details::_Task_group_call<_Fn>{ _Func, nullptr })
+	{
+	}
+
+	explicit task_handle(_Fn&& _Func) : _Base(details::_Task_group_call<_Fn>{ std::move(_Func), nullptr })
+	{
+	}
+
+	task_handle(task_handle&& _Other) : _Base(std::move(_Other))
+	{
+	}
+};
+
+/// <summary>
+///     Returns a task_handle of the function.
+/// </summary>
+template<typename _Fn>
+inline task_handle<typename std::decay<_Fn>::type> make_task_handle(_Fn&& _Func)
+{
+	return task_handle<typename std::decay<_Fn>::type>(std::forward<_Fn>(_Func));
+}
+
+/// <summary>
+///     Runs functions in parallel on the work-stealing queues of the library, the way the parallel algorithms fork
+///     their own work. <c>wait</c> runs the functions nobody has stolen on the calling thread, waits for the others
+///     and throws an exception_list of the exceptions they threw. A task_group is used on the thread that created it,
+///     and can run new functions after a wait.
+/// </summary>
+/// <remarks>
+///     <c>cancel</c> drops the functions that haven't started, from any thread. The task_groups created in the functions
+///     of a canceled group drop theirs too, so a search can stop its losing branches at once. The running functions
+///     poll is_current_task_group_canceling to return early. A task_group may outlive the function it was created in,
+///     and the group of that function, it still sees the cancellation of the groups it was created under.
+/// </remarks>
+class task_group
+{
+	static const size_t _Buffer_size = 256;
+
+	details::_Task_group_errors _Errors;
+	typename std::aligned_storage<_Buffer_size, std::alignment_of<double>::value>::type _Buffer;
+	size_t _Buffer_used;
+	details::_Owned_chore_base *_Owned;
+	details::TaskGroup _Group; // last, its destructor waits before the chores above go
+
+	template<typename _Fn>
+	struct _Owned_chore : details::_Owned_chore_base
+	{
+		task_handle<_Fn> _Handle;
+
+		template<typename _Arg>
+		explicit _Owned_chore(_Arg&& _Func) : _Handle(std::forward<_Arg>(_Func))
+		{
+		}
+
+		static void _Destroy_inline(details::_Owned_chore_base *_Chore)
+		{
+			static_cast<_Owned_chore *>(_Chore)->~_Owned_chore();
+		}
+
+		static void _Destroy_heap(details::_Owned_chore_base *_Chore)
+		{
+			delete static_cast<_Owned_chore *>(_Chore);
+		}
+	};
+
+	// Places the chore in the inline buffer while it fits, on the heap after that
+	template<typename _Fn, typename _Arg>
+	task_handle<_Fn>& _Make_chore(_Arg&& _Func)
+	{
+		typedef _Owned_chore<_Fn> _Chore_type;
+
+		const size_t _Align = std::alignment_of<_Chore_type>::value;
+		const size_t _Offset = (_Buffer_used + _Align - 1) / _Align * _Align;
+		_Chore_type *_Chore;
+		if (_Align <= std::alignment_of<decltype(_Buffer)>::value && _Offset + sizeof(_Chore_type) <= _Buffer_size) {
+			_Chore = ::new (static_cast<void *>(reinterpret_cast<char *>(&_Buffer) + _Offset)) _Chore_type(std::forward<_Arg>(_Func));
+			_Chore->_Destroy = &_Chore_type::_Destroy_inline;
+			_Buffer_used = _Offset + sizeof(_Chore_type);
+		}
+		else {
+			_Chore = new _Chore_type(std::forward<_Arg>(_Func));
+			_Chore->_Destroy = &_Chore_type::_Destroy_heap;
+		}
+
+		_Chore->_Next = _Owned;
+		_Owned = _Chore;
+		return _Chore->_Handle;
+	}
+
+	void _Release_chores()
+	{
+		while (_Owned != nullptr) {
+			auto _Chore = _Owned;
+			_Owned = _Chore->_Next;
+			_Chore->_Destroy(_Chore);
+		}
+		_Buffer_used = 0;
+	}
+
+	// A TaskGroup is waited for once, the next functions go to a fresh one
+	void _Wait_and_reset()
+	{
+		_Group.wait();
+		_Release_chores();
+		_Group.~TaskGroup();
+		::new (static_cast<void *>(&_Group)) details::TaskGroup(true);
+	}
+
+public:
+	task_group() : _Buffer_used(0), _Owned(nullptr), _Group(true)
+	{
+	}
+
+	task_group(const task_group&) = delete;
+	task_group& operator=(const task_group&) = delete;
+
+	/// <summary>
+	///     Waits for the functions still running, their exceptions are lost.
+	/// </summary>
+	~task_group()
+	{
+		_Group.wait();
+		_Release_chores();
+	}
+
+	/// <summary>
+	///     Schedules the function of the handle, the handle must stay alive until the wait.
+	/// </summary>
+	template<typename _Fn>
+	void run(task_handle<_Fn>& _Handle)
+	{
+		_Handle.m_userFunc._Errors = &_Errors;
+		_Group.run(_Handle);
+	}
+
+	/// <summary>
+	///     Schedules a copy of the function. The first copies are kept inside the group, so a few small functions
+	///     allocate nothing.
+	/// </summary>
+	template<typename _Fn>
+	void run(_Fn&& _Func)
+	{
+		run(_Make_chore<typename std::decay<_Fn>::type>(std::forward<_Fn>(_Func)));
+	}
+
+	/// <summary>
+	///     Waits for the functions run so far. Throws an exception_list of the exceptions they threw, if any.
+	/// </summary>
+	void wait()
+	{
+		_Wait_and_reset();
+		_Errors._Rethrow();
+	}
+
+	/// <summary>
+	///     Makes the functions of the group that haven't started complete without being called, and the ones running
+	///     and the task_groups created in them see is_canceling. Any thread may cancel the group, the next wait
+	///     still waits for the running functions and clears the cancellation.
+	/// </summary>
+	void cancel() _NOEXCEPT
+	{
+		_Group.cancel();
+	}
+
+	/// <summary>
+	///     Returns true once the group, or a task_group whose function created it, is canceled.
+	/// </summary>
+	bool is_canceling() const _NOEXCEPT
+	{
+		return _Group.is_canceling();
+	}
+
+	/// <summary>
+	///     Calls the function on the calling thread, then waits as <c>wait</c> does.
+	/// </summary>
+	template<typename _Fn>
+	void run_and_wait(const _Fn& _Func)
+	{
+		try {
+			_Func();
+		}
+		catch (...) {
+			_Errors._Capture();
+		}
+		wait();
+	}
+};
+
+/// <summary>
+///     Returns true if the function the calling thread runs for a task_group, or for a parallel algorithm called in such
+///     a function, belongs to a group that is canceling. A long function polls it to stop early.
+/// </summary>
+inline bool is_current_task_group_canceling() _NOEXCEPT
+{
+	return details::_Current_task_group_canceling();
+}
+
+namespace details {
+
+	template<typename _Fn>
+	inline void _Invoke_all(task_group& _Group, const _Fn& _Last)
+	{
+		_Group.run_and_wait(_Last);
+	}
+
+	// Each function but the last is run through a handle in its own frame, which stays alive until the wait
+	template<typename _Fn, typename... _Fns>
+	inline void _Invoke_all(task_group& _Group, const _Fn& _Func, const _Fns&... _Funcs)
+	{
+		task_handle<std::reference_wrapper<const _Fn>> _Handle(std::cref(_Func));
+		_Group.run(_Handle);
+		_Invoke_all(_Group, _Funcs...);
+	}
+}
+
+/// <summary>
+///     Calls the functions in parallel and returns when all of them returned. The last one runs on the calling
+///     thread, the others are scheduled without allocating. Throws an exception_list of the exceptions they threw.
+/// </summary>
+template<typename _Fn1, typename _Fn2, typename... _Fns>
+inline void parallel_invoke(const _Fn1& _Func1, const _Fn2& _Func2, const _Fns&... _Funcs)
+{
+	task_group _Group;
+	details::_Invoke_all(_Group, _Func1, _Func2, _Funcs...);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TASK_GROUP_H_
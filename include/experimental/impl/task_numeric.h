@@ -0,0 +1,69 @@
+#pragma once
+
+#ifndef _IMPL_TASK_NUMERIC_H_
+#define _IMPL_TASK_NUMERIC_H_ 1
+
+#include "algorithm_impl.h"
+#include "reduce.h"
+#include "scan.h"
+#include "task.h"
+#include "transform_reduce.h"
+
+// The numeric algorithms under parallel_task_execution_policy, see task_algorithm.h
+
+_PSTL_NS1_BEGIN
+
+template <class _ExPolicy, class _InIt, class _Ty, class _BinPr>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_Ty>>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinPr _BinOp)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return reduce(_Inner, _First, _Last, _Init, _BinOp); });
+}
+
+template <class _ExPolicy, class _InIt, class _Ty = typename std::iterator_traits<_InIt>::value_type>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_Ty>>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last)
+{
+	return reduce(std::forward<_ExPolicy>(_Policy), _First, _Last, _Ty{}, std::plus<>());
+}
+
+template <class _ExPolicy, class _InIt, class _Ty>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_Ty>>::type reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init)
+{
+	return reduce(std::forward<_ExPolicy>(_Policy), _First, _Last, _Init, std::plus<>());
+}
+
+template <class _ExPolicy, class _InIt, class _Ty, class _BinOp, class _UnOp>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_Ty>>::type transform_reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return transform_reduce(_Inner, _First, _Last, _Init, _Reduce, _Transform); });
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _Ty, class _BinOp>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type exclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init, _BinOp _Op)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return exclusive_scan(_Inner, _First, _Last, _Dest, _Init, _Op); });
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _Ty>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type exclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Ty _Init)
+{
+	return exclusive_scan(std::forward<_ExPolicy>(_Policy), _First, _Last, _Dest, _Init, std::plus<>());
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _BinOp>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _BinOp _Op)
+{
+	const parallel_execution_policy _Inner = _Policy.policy();
+	return details::_Run_task([=] { return inclusive_scan(_Inner, _First, _Last, _Dest, _Op); });
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt>
+inline typename details::_enable_if_task_policy<_ExPolicy, task_future<_OutIt>>::type inclusive_scan(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
+{
+	return inclusive_scan(std::forward<_ExPolicy>(_Policy), _First, _Last, _Dest, std::plus<>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TASK_NUMERIC_H_
@@ -7,10 +7,12 @@
 #include <mutex>
 #include <random>
 #include <limits>
+#include <climits>
 #include <list>
 #include <type_traits>
 #include "event.h"
-#include "algorithm_impl.h"
+#include "algorithm_scheduler.h"
+#include "memory_resource.h"
 
 _PSTL_NS1_BEGIN
 namespace details
@@ -21,32 +23,34 @@ namespace details
 	class WorkChoreBase
 	{
 		TaskGroup *m_taskGroup;
-		WorkChoreBase *m_prev;
-		std::atomic<WorkChoreBase*> m_next;
+		memory_resource *m_scratchResource; // of the thread that scheduled the chore
+		const char *m_algorithm; // the algorithm that scheduled the chore, for the statistics and the trace
+		unsigned long long m_scheduledPs; // when it was queued, for the statistics
+		unsigned int m_lane; // the lane of the queue it waits in, see _High_lane
 		friend class TaskGroup;
 		friend class WorkStealingQueue;
 
 		inline void run(bool isAsync);
 
-		inline WorkChoreBase * tryStealNextChore();
-
-		inline bool tryClaimThisChore();
-
-		inline WorkStealingQueue * getWorkStealingQueue();
-
 	protected:
 		virtual void __cdecl userFunc() = 0;
-		WorkChoreBase() : m_prev(nullptr), m_taskGroup(nullptr)
+		WorkChoreBase() : m_taskGroup(nullptr), m_scratchResource(nullptr), m_algorithm(nullptr), m_scheduledPs(0), m_lane(_Normal_lane)
 		{
-			_ASSERT(m_next.load() == nullptr);
+		}
+
+		// Lets a chore that has run be scheduled again
+		void resetTaskGroup()
+		{
+			m_taskGroup = nullptr;
 		}
 	};
 
 	template <typename Func>
 	class UserWorkChore : public WorkChoreBase
 	{
-		Func m_userFunc;
 	protected:
+		Func m_userFunc;
+
 		virtual void __cdecl userFunc() override
 		{
 			m_userFunc();
@@ -62,14 +66,28 @@ namespace details
 		return UserWorkChore<std::decay_t<Func>>(std::forward<Func>(func));
 	}
 
+	// The cancellation of a group as the groups created in its chores see it. A group created in a chore may outlive
+	// the group of the chore, a task_group a heap object owns for instance, so the chain is held by reference counts
+	// in place of pointers to the groups.
+	struct CancellationNode
+	{
+		std::atomic<bool> canceled;
+		std::atomic<unsigned int> references;
+		CancellationNode *parent; // a reference held, null at the top of the chain
+	};
+
 	class TaskGroup
 	{
 		static const int MaximalChoreNum = INT_MAX - 1; // preventing overflow
 
-		WorkChoreBase *m_head, *m_tail;
 		WorkStealingQueue *m_queue;
+		CancellationNode *m_parent; // of the group of the chore the creating thread ran, a reference held
+		unsigned int m_lane; // the lane of the thread that created the group, its chores are queued in
 		int m_choreCounter;
 		bool m_needReleaseWSQ;
+		bool m_inheritCancellation; // the chores are dropped when a group of the parent chain is canceling too
+		std::atomic<bool> m_canceling;
+		std::atomic<CancellationNode *> m_node; // made when a group is first created in one of the chores
 		std::atomic<int> m_pendingChore;
 		Event m_event;
 
@@ -83,8 +101,36 @@ namespace details
 			}
 		}
 
+		// the chores that haven't started complete without calling their function
+		bool dropsChores() const
+		{
+			if (m_canceling.load(std::memory_order_relaxed))
+				return true;
+			return m_inheritCancellation && parentCanceling();
+		}
+
+		bool parentCanceling() const
+		{
+			for (auto node = m_parent; node != nullptr; node = node->parent)
+			{
+				if (node->canceled.load(std::memory_order_relaxed))
+					return true;
+			}
+			return false;
+		}
+
+		// A reference to the cancellation of the group, for a group created in one of its chores
+		CancellationNode *acquireNode();
+
 	public:
-		_EXP_IMPL TaskGroup();
+		TaskGroup() : TaskGroup(false)
+		{
+		}
+
+		// A group that inherits cancellation drops its chores once a group of its parent chain, the groups
+		// whose chores it was created in, is canceled. The groups of the algorithms don't, their chunks
+		// always run, but their functions see is_canceling of the chain.
+		_EXP_IMPL explicit TaskGroup(bool inheritCancellation);
 
 		TaskGroup(const TaskGroup &) = delete;
 		TaskGroup &operator =(const TaskGroup &) = delete;
@@ -92,7 +138,46 @@ namespace details
 		_EXP_IMPL ~TaskGroup();
 		_EXP_IMPL void __cdecl run(WorkChoreBase &work);
 		_EXP_IMPL void __cdecl wait();
+
+		// Any thread. The chores that haven't started complete as no-ops, the running ones see is_canceling.
+		// wait still waits for them.
+		void cancel()
+		{
+			// against acquireNode: either it sees the flag or the node is seen here
+			m_canceling.store(true, std::memory_order_seq_cst);
+			auto node = m_node.load(std::memory_order_seq_cst);
+			if (node != nullptr)
+				node->canceled.store(true, std::memory_order_relaxed);
+		}
+
+		// True once the group or a group of its parent chain is canceled
+		bool is_canceling() const
+		{
+			return m_canceling.load(std::memory_order_relaxed) || parentCanceling();
+		}
 	};
+
+	// True if the chore the calling thread runs belongs to a group that is canceling, see TaskGroup::is_canceling
+	_EXP_IMPL bool __cdecl _Current_task_group_canceling() _NOEXCEPT;
+
+	// Runs one chore stolen from the work-stealing queues on the calling thread, for a thread
+	// that would otherwise block in a join. Returns false if there was nothing to run.
+	_EXP_IMPL bool __cdecl help_with_stolen_chore();
+
+	// Workers of the work-stealing queues that could take more chores right now: the ones
+	// looking for a victim plus the threads that may still be injected
+	_EXP_IMPL size_t __cdecl idleWorkerCount();
+
+	// Identifies the calling thread among the threads that run chores, 1 based. A thread keeps
+	// its slot for its lifetime, so the workers of the pool are recognized from one loop to the next.
+	_EXP_IMPL unsigned int __cdecl current_worker_slot();
+
+	// Number of NUMA nodes the work-stealing queues are grouped by
+	_EXP_IMPL unsigned int __cdecl get_numa_node_count();
+
+	// Chores stolen by the threads of a NUMA node, from queues of the same node (_Local_steals)
+	// and of the other nodes (_Remote_steals). Returns false for a node out of range.
+	_EXP_IMPL bool __cdecl get_steal_counters(unsigned int _Node, size_t &_Local_steals, size_t &_Remote_steals);
 }
 _PSTL_NS1_END // std::experimental::parallel
 
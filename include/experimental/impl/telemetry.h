@@ -0,0 +1,271 @@
+#pragma once
+
+#ifndef _IMPL_TELEMETRY_H_
+#define _IMPL_TELEMETRY_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include "defines.h"
+#include <experimental/execution_policy>
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     Counters of the threads that run chores, summed over all of them or for one worker slot.
+/// </summary>
+struct worker_statistics
+{
+	unsigned int slot; // see details::current_worker_slot, 0 in the sums
+	size_t chores_executed;
+	size_t steal_attempts; // victims tried by the thread
+	size_t steals; // searches that found a chore
+	unsigned long long idle_ns; // searching for a chore to steal or blocked in a join
+};
+
+/// <summary>
+///     The time the chores of a priority class waited in the queues, from TaskGroup::run until they started.
+/// </summary>
+struct priority_statistics
+{
+	size_t chores_started;
+	unsigned long long queue_delay_ns; // summed over the chores, the mean is queue_delay_ns / chores_started
+	unsigned long long max_queue_delay_ns;
+};
+
+/// <summary>
+///     Scheduler counters that don't belong to a worker.
+/// </summary>
+struct scheduler_statistics
+{
+	worker_statistics workers; // the sums over the workers
+	size_t threads_injected; // worker threads woken for the queued chores
+	size_t inline_fallbacks; // loops that ran inline since there were enough partitions already
+	size_t worker_parks; // workers that ran out of chores and their spin budget, see set_worker_spin_budget
+	priority_statistics normal_priority; // the chores of task_priority::normal
+	priority_statistics high_priority; // the chores of task_priority::high
+};
+
+/// <summary>
+///     Calls of a parallel algorithm and their time, a call nested in another one of the same name, e.g. an
+///     overload forwarding to another, is part of the outer call.
+/// </summary>
+struct algorithm_statistics
+{
+	const char *name;
+	size_t calls;
+	unsigned long long total_ns;
+};
+
+/// <summary>
+///     All the statistics at one point, see take_statistics_snapshot.
+/// </summary>
+struct statistics_snapshot
+{
+	scheduler_statistics scheduler;
+	std::vector<worker_statistics> workers; // the slots with some activity
+	std::vector<algorithm_statistics> algorithms; // the algorithms called at least once
+};
+
+/// <summary>
+///     Returns true if the library was built with _EXP_TELEMETRY set, otherwise the statistics stay zero.
+/// </summary>
+_EXP_IMPL bool __cdecl telemetry_enabled() _NOEXCEPT;
+
+/// <summary>
+///     Fills the scheduler counters.
+/// </summary>
+_EXP_IMPL void __cdecl get_scheduler_statistics(scheduler_statistics& _Stats) _NOEXCEPT;
+
+/// <summary>
+///     Fills up to _Capacity entries with the counters of the worker slots with some activity, returns the number
+///     of such slots. The slots past the last one tracked are counted in it.
+/// </summary>
+_EXP_IMPL size_t __cdecl get_worker_statistics(worker_statistics *_Workers, size_t _Capacity) _NOEXCEPT;
+
+/// <summary>
+///     Fills up to _Capacity entries with the statistics of the algorithms called so far, returns the number of
+///     algorithms.
+/// </summary>
+_EXP_IMPL size_t __cdecl get_algorithm_statistics(algorithm_statistics *_Algorithms, size_t _Capacity) _NOEXCEPT;
+
+/// <summary>
+///     Sets every counter back to zero. The counters updated meanwhile may keep part of their update.
+/// </summary>
+_EXP_IMPL void __cdecl reset_statistics() _NOEXCEPT;
+
+/// <summary>
+///     Returns the scheduler, worker and algorithm statistics.
+/// </summary>
+inline statistics_snapshot take_statistics_snapshot()
+{
+	statistics_snapshot _Snapshot;
+	get_scheduler_statistics(_Snapshot.scheduler);
+
+	// the slots and algorithms may grow between the two calls
+	_Snapshot.workers.resize(get_worker_statistics(nullptr, 0) + 16);
+	_Snapshot.workers.resize((std::min)(get_worker_statistics(_Snapshot.workers.data(), _Snapshot.workers.size()), _Snapshot.workers.size()));
+
+	_Snapshot.algorithms.resize(get_algorithm_statistics(nullptr, 0) + 16);
+	_Snapshot.algorithms.resize((std::min)(get_algorithm_statistics(_Snapshot.algorithms.data(), _Snapshot.algorithms.size()), _Snapshot.algorithms.size()));
+	return _Snapshot;
+}
+
+/// <summary>
+///     What the imbalance profiler does with the loops of the parallel algorithms, see set_imbalance_profiling.
+/// </summary>
+enum class imbalance_profiling
+{
+	/// <summary>
+	///     The chunks aren't timed.
+	/// </summary>
+	off,
+	/// <summary>
+	///     Times the chunks of every loop and gives an advice per call site, see get_imbalance_profiles.
+	/// </summary>
+	record,
+	/// <summary>
+	///     Records, and the adaptive partitioner follows the advice of a call site once there is one.
+	/// </summary>
+	tune
+};
+
+/// <summary>
+///     What the imbalance profiler learned about a call site, a loop body of an algorithm instantiation.
+/// </summary>
+struct imbalance_profile_info
+{
+	const char *name; // type of the loop body
+	unsigned int calls; // calls that were profiled
+	double chunks_per_call;
+	double mean_chunk_ns;
+	double tail_ratio; // the slowest chunk of a call over its mean chunk, averaged over the calls
+	double cost_spread; // the largest per element cost among the chunks of a call over the smallest, averaged
+	double ns_per_element;
+	partitioner_kind partitioner; // the partitioner advised, default_ until enough calls were profiled
+	size_t grain; // the grain advised
+	bool replay_affinity; // the calls repeat over ranges of the same size, balanced enough for an affinity_partitioner
+};
+
+/// <summary>
+///     Sets what the imbalance profiler does, returns the previous setting. The profiler is built with _EXP_TELEMETRY,
+///     without it the setting stays off.
+/// </summary>
+/// <remarks>
+///     The advice follows the spread of the per element cost among the chunks of a call: the static partitioner for
+///     a uniform cost, the self guided one for a moderate spread and the dynamic one when some chunks cost several
+///     times more per element than others. The grain gives a chunk about 10us of work.
+/// </remarks>
+_EXP_IMPL imbalance_profiling __cdecl set_imbalance_profiling(imbalance_profiling _Mode) _NOEXCEPT;
+
+/// <summary>
+///     Returns what the imbalance profiler does.
+/// </summary>
+_EXP_IMPL imbalance_profiling __cdecl imbalance_profiling_mode() _NOEXCEPT;
+
+/// <summary>
+///     Fills up to _Capacity entries with the call sites profiled so far, returns the number of such sites.
+/// </summary>
+_EXP_IMPL size_t __cdecl get_imbalance_profiles(imbalance_profile_info *_Sites, size_t _Capacity) _NOEXCEPT;
+
+/// <summary>
+///     Drops the timings and the advice of every call site.
+/// </summary>
+_EXP_IMPL void __cdecl reset_imbalance_profiles() _NOEXCEPT;
+
+namespace details {
+	// The counters of an algorithm instantiation. A site is a zero initialized static, registered when it is
+	// first called. The statistics sum the sites of the same name.
+	struct _Algorithm_site
+	{
+		std::atomic<size_t> _Calls;
+		std::atomic<unsigned long long> _Ps;
+		std::atomic<bool> _Registered;
+		const char *_Name;
+		_Algorithm_site *_Next;
+	};
+
+	_EXP_IMPL void __cdecl _Register_algorithm_site(_Algorithm_site *_Site, const char *_Name);
+
+	// The algorithm the calling thread is in, null outside of the algorithms. Returns the previous one.
+	_EXP_IMPL const char * __cdecl _Exchange_current_algorithm(const char *_Name) _NOEXCEPT;
+
+	// The scheduler's counters, called by the library
+	_EXP_IMPL void __cdecl _Telemetry_chore_executed() _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_steal(size_t _Attempts, bool _Found) _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_idle(unsigned long long _Elapsed_ps) _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_thread_injected() _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_inline_fallback() _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_park() _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Telemetry_queue_delay(unsigned int _Lane, unsigned long long _Elapsed_ps) _NOEXCEPT;
+
+	_EXP_IMPL unsigned long long __cdecl _Cutoff_clock_ps();
+
+	// Counts a call of an algorithm and its time, unless the thread is already in an algorithm of that name
+	class _Algorithm_timer
+	{
+		_Algorithm_site& _Site;
+		const char *_Name;
+		const char *_Outer;
+		bool _Counted;
+		unsigned long long _Start;
+
+		_Algorithm_timer(const _Algorithm_timer&);
+		_Algorithm_timer& operator=(const _Algorithm_timer&);
+	public:
+		_Algorithm_timer(_Algorithm_site& _S, const char *_N) : _Site(_S), _Name(_N), _Outer(_Exchange_current_algorithm(_N)),
+			_Counted(_Outer == nullptr || std::strcmp(_Outer, _N) != 0), _Start(0)
+		{
+			if (!_Counted)
+				return;
+
+			if (!_Site._Registered.exchange(true))
+				_Register_algorithm_site(&_Site, _Name);
+			_Start = _Cutoff_clock_ps();
+		}
+
+		~_Algorithm_timer()
+		{
+			if (_Counted)
+			{
+				_Site._Calls.fetch_add(1, std::memory_order_relaxed);
+				_Site._Ps.fetch_add(_Cutoff_clock_ps() - _Start, std::memory_order_relaxed);
+			}
+			_Exchange_current_algorithm(_Outer);
+		}
+	};
+
+	// Names the algorithm the thread is in, for the trace events when the calls aren't counted
+	class _Algorithm_name_scope
+	{
+		const char *_Outer;
+
+		_Algorithm_name_scope(const _Algorithm_name_scope&);
+		_Algorithm_name_scope& operator=(const _Algorithm_name_scope&);
+	public:
+		explicit _Algorithm_name_scope(const char *_Name) : _Outer(_Exchange_current_algorithm(_Name))
+		{
+		}
+
+		~_Algorithm_name_scope()
+		{
+			_Exchange_current_algorithm(_Outer);
+		}
+	};
+}
+
+// The first statement of the parallel algorithms, counts the call under _Name and names the trace events
+#if _EXP_TELEMETRY
+#define _EXP_TELEMETRY_ALGORITHM(_Name) \
+	static details::_Algorithm_site _Exp_algorithm_site; \
+	details::_Algorithm_timer _Exp_algorithm_timer(_Exp_algorithm_site, _Name)
+#elif _EXP_TRACE
+#define _EXP_TELEMETRY_ALGORITHM(_Name) details::_Algorithm_name_scope _Exp_algorithm_scope(_Name)
+#else
+#define _EXP_TELEMETRY_ALGORITHM(_Name)
+#endif
+
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TELEMETRY_H_
@@ -0,0 +1,244 @@
+#pragma once
+
+#ifndef _IMPL_TILED_VIEW_H_
+#define _IMPL_TILED_VIEW_H_ 1
+
+#include <type_traits>
+#include "algorithm_impl.h"
+#include "foreach.h"
+#include "transpose.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     A two dimensional view of elements stored tile by tile. The square tiles of _Tile_side elements follow
+///     each other in row major order and the elements of a tile are stored in row major order, so the
+///     neighbours of an element along the rows and the columns are both near in memory. The tiles at the
+///     right and bottom edges take the space of whole tiles, see required_size.
+/// </summary>
+template<class _Ty, ptrdiff_t _Tile_side = 32>
+class tiled_array_view
+{
+	static_assert(_Tile_side > 0, "Required tiles of at least one element.");
+
+	template<class _Other_ty, ptrdiff_t _Other_side> friend class tiled_array_view;
+
+	static const ptrdiff_t _Tile_size = _Tile_side * _Tile_side;
+
+	D4087::bounds<2> _Bnd;
+	ptrdiff_t _Tiles_per_row;
+	_Ty *_Data;
+
+	static ptrdiff_t _Tile_count(ptrdiff_t _Extent)
+	{
+		return (_Extent + _Tile_side - 1) / _Tile_side;
+	}
+
+public:
+	typedef _Ty value_type;
+	typedef _Ty *pointer;
+	typedef _Ty& reference;
+
+	static const int rank = 2;
+
+	/// <summary>
+	///     The number of elements the storage of a tiled view of _Bnd holds.
+	/// </summary>
+	static size_t required_size(const D4087::bounds<2>& _Bnd)
+	{
+		return static_cast<size_t>(_Tile_count(_Bnd[0]) * _Tile_count(_Bnd[1]) * _Tile_size);
+	}
+
+	static D4087::index<2> tile_shape()
+	{
+		return D4087::index<2>{ _Tile_side, _Tile_side };
+	}
+
+	tiled_array_view() : _Bnd(), _Tiles_per_row(0), _Data(nullptr)
+	{
+	}
+
+	tiled_array_view(const D4087::bounds<2>& _Bounds, pointer _Storage) : _Bnd(_Bounds), _Tiles_per_row(_Tile_count(_Bounds[1])), _Data(_Storage)
+	{
+	}
+
+	// Preconditions: required_size(_Bounds) <= _Storage.size()
+	template<class _Container, class = typename std::enable_if<std::is_convertible<decltype(std::declval<_Container&>().data()), pointer>::value>::type>
+	tiled_array_view(const D4087::bounds<2>& _Bounds, _Container& _Storage) : _Bnd(_Bounds), _Tiles_per_row(_Tile_count(_Bounds[1])), _Data(_Storage.data())
+	{
+		_ASSERTE(required_size(_Bounds) <= static_cast<size_t>(_Storage.size()));
+	}
+
+	template<class _Other_ty, class = typename std::enable_if<std::is_convertible<_Other_ty *, pointer>::value>::type>
+	tiled_array_view(const tiled_array_view<_Other_ty, _Tile_side>& _Other) : _Bnd(_Other._Bnd), _Tiles_per_row(_Other._Tiles_per_row), _Data(_Other._Data)
+	{
+	}
+
+	const D4087::bounds<2>& bounds() const
+	{
+		return _Bnd;
+	}
+
+	ptrdiff_t size() const
+	{
+		return _Bnd.size();
+	}
+
+	/// <summary>
+	///     The bounds of the grid of tiles.
+	/// </summary>
+	D4087::bounds<2> tiles() const
+	{
+		return D4087::bounds<2>{ _Tile_count(_Bnd[0]), _Tiles_per_row };
+	}
+
+	pointer data() const
+	{
+		return _Data;
+	}
+
+	reference operator[](const D4087::index<2>& _Idx) const
+	{
+		const ptrdiff_t _Row = _Idx[0];
+		const ptrdiff_t _Col = _Idx[1];
+		_ASSERTE(_Row < _Bnd[0] && _Col < _Bnd[1]);
+		return _Data[((_Row / _Tile_side) * _Tiles_per_row + _Col / _Tile_side) * _Tile_size + (_Row % _Tile_side) * _Tile_side + _Col % _Tile_side];
+	}
+
+	/// <summary>
+	///     The elements of the tile at _Tile_idx of the grid, cut to the bounds at the edges.
+	/// </summary>
+	D4087::strided_array_view<_Ty, 2> tile(const D4087::index<2>& _Tile_idx) const
+	{
+		const ptrdiff_t _Rows = (std::min)(_Tile_side, _Bnd[0] - _Tile_idx[0] * _Tile_side);
+		const ptrdiff_t _Cols = (std::min)(_Tile_side, _Bnd[1] - _Tile_idx[1] * _Tile_side);
+		return D4087::strided_array_view<_Ty, 2>({ _Rows, _Cols }, { _Tile_side, 1 }, _Data + (_Tile_idx[0] * _Tiles_per_row + _Tile_idx[1]) * _Tile_size);
+	}
+};
+
+namespace details {
+
+	//
+	// Algorithms over the tiles of a tiled view, a chore takes a run of whole tiles stored next to each other
+	//
+	template<class _Ty, ptrdiff_t _Tile_side, class _Fn>
+	inline void _For_each_tiled_impl(const sequential_execution_policy&, const tiled_array_view<_Ty, _Tile_side>& _View, _Fn _Func)
+	{
+		_EXP_TRY
+			for (auto _Tile_idx : _View.tiles())
+				_Func(_Tile_idx * _Tile_side, _View.tile(_Tile_idx));
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _Ty, ptrdiff_t _Tile_side, class _Fn>
+	inline void _For_each_tiled_impl(const _ExPolicy& _Policy, const tiled_array_view<_Ty, _Tile_side>& _View, _Fn _Func)
+	{
+		const D4087::bounds<2> _Tiles = _View.tiles();
+		_Partitioned_for_each(_Policy, std::begin(_Tiles), _Tiles.size(), _Func, [&_View](D4087::bounds_iterator<2> _Begin, size_t _Count, _Fn& _UserFunc) {
+			for (size_t _I = 0; _I < _Count; ++_Begin, ++_I)
+				_UserFunc(*_Begin * _Tile_side, _View.tile(*_Begin));
+		});
+	}
+
+	template<class _Ty, ptrdiff_t _Tile_side, class _Fn>
+	inline void _For_each_tiled_impl(const execution_policy& _Policy, const tiled_array_view<_Ty, _Tile_side>& _View, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_For_each_tiled_impl, _Policy, _View, _Func);
+	}
+
+	// Calls the user function on the elements of a tile, the rows of a tile are contiguous
+	template<typename _ExPolicy, typename _Ty, typename _Fn>
+	struct _Tiled_elements
+	{
+		_Fn _Func;
+
+		void operator()(const D4087::index<2>&, const D4087::strided_array_view<_Ty, 2>& _Tile)
+		{
+			_Ty *_First = _View_data(_Tile);
+			for (ptrdiff_t _Row = 0; _Row < _Tile.bounds()[0]; ++_Row, _First += _Tile.stride()[0])
+				_For_each_helper<_ExPolicy, std::random_access_iterator_tag>::template Loop<_Ty *, _Fn&>(_First, static_cast<size_t>(_Tile.bounds()[1]), _Func);
+		}
+	};
+
+	// Copies the elements of a view to the tile of a tiled view at the same index, or the reverse
+	template<typename _ViewTy, typename _TileTy, bool _To_tiles>
+	struct _Tiled_copy
+	{
+		D4087::strided_array_view<_ViewTy, 2> _View;
+
+		void operator()(const D4087::index<2>& _Origin, const D4087::strided_array_view<_TileTy, 2>& _Tile) const
+		{
+			const _Block_2d<_ViewTy> _Rows = { &_View[_Origin], _View.stride()[0], _View.stride()[1] };
+			const _Block_2d<_TileTy> _Tile_rows = { _View_data(_Tile), _Tile.stride()[0], 1 };
+			_Copy(_Rows, _Tile_rows, _Tile.bounds(), std::integral_constant<bool, _To_tiles>());
+		}
+
+		static void _Copy(const _Block_2d<_ViewTy>& _Rows, const _Block_2d<_TileTy>& _Tile_rows, const D4087::bounds<2>& _Bnd, std::true_type)
+		{
+			_Copy_block_2d(_Rows, _Tile_rows, _Bnd[0], _Bnd[1]);
+		}
+
+		static void _Copy(const _Block_2d<_ViewTy>& _Rows, const _Block_2d<_TileTy>& _Tile_rows, const D4087::bounds<2>& _Bnd, std::false_type)
+		{
+			_Copy_block_2d(_Tile_rows, _Rows, _Bnd[0], _Bnd[1]);
+		}
+	};
+} // details
+
+/// <summary>
+///     Calls _Func(origin, tile) once per tile of a tiled view, where origin is the index of the first element of the
+///     tile and tile a strided_array_view of its elements. A chore takes a run of tiles stored next to each other.
+/// </summary>
+template<class _ExPolicy, class _Ty, ptrdiff_t _Tile_side, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each_tile(_ExPolicy&& _Policy, const tiled_array_view<_Ty, _Tile_side>& _View, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each_tile");
+	if (_View.size() != 0)
+		details::_For_each_tiled_impl(_Policy, _View, _Func);
+}
+
+/// <summary>
+///     Calls _Func on every element of a tiled view, tile by tile.
+/// </summary>
+template<class _ExPolicy, class _Ty, ptrdiff_t _Tile_side, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type for_each(_ExPolicy&& _Policy, const tiled_array_view<_Ty, _Tile_side>& _View, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("for_each");
+	typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+	details::_Tiled_elements<_ExecutionPolicy, _Ty, _Fn> _Elements = { _Func };
+	for_each_tile(_Policy, _View, _Elements);
+}
+
+/// <summary>
+///     Stores the elements of a row major view to the tiled view of the same bounds.
+/// </summary>
+template<class _ExPolicy, class _InView, class _OutTy, ptrdiff_t _Tile_side>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView>::type>::type copy(_ExPolicy&& _Policy, const _InView& _View, const tiled_array_view<_OutTy, _Tile_side>& _Dest_view)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy");
+	typedef typename _InView::value_type _InTy;
+	static_assert(_InView::rank == 2, "Required a two dimensional view.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	const details::_Tiled_copy<_InTy, _OutTy, true> _Copy = { details::_Strided_view(_View) };
+	for_each_tile(_Policy, _Dest_view, _Copy);
+}
+
+/// <summary>
+///     Stores the elements of a tiled view to the row major view of the same bounds.
+/// </summary>
+template<class _ExPolicy, class _InTy, ptrdiff_t _Tile_side, class _OutView>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_OutView>::type>::type copy(_ExPolicy&& _Policy, const tiled_array_view<_InTy, _Tile_side>& _View, const _OutView& _Dest_view)
+{
+	_EXP_TELEMETRY_ALGORITHM("copy");
+	typedef typename _OutView::value_type _OutTy;
+	static_assert(_OutView::rank == 2, "Required a two dimensional view.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	const details::_Tiled_copy<_OutTy, _InTy, false> _Copy = { details::_Strided_view(_Dest_view) };
+	for_each_tile(_Policy, _View, _Copy);
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TILED_VIEW_H_
@@ -0,0 +1,104 @@
+#pragma once
+
+#ifndef _IMPL_TRACE_H_
+#define _IMPL_TRACE_H_
+
+#include <algorithm>
+#include <ostream>
+#include <vector>
+#include "defines.h"
+
+_PSTL_NS1_BEGIN
+
+/// <summary>
+///     A span of the timeline of a thread that runs chores.
+/// </summary>
+struct trace_event
+{
+	const char *name; // the algorithm the span belongs to, null outside of the algorithms
+	const char *category; // "chunk", "task", "wait", "steal" or "worker", see start_tracing
+	unsigned int worker; // see details::current_worker_slot
+	size_t count; // the elements of a chunk, 0 for the other spans
+	unsigned long long begin_ns;
+	unsigned long long duration_ns;
+};
+
+/// <summary>
+///     Starts a trace in the per thread ring buffers, the events of the previous trace are dropped. Each thread keeps
+///     its last _Events_per_thread events, the size is taken by the buffers allocated from then on: a thread keeps its
+///     buffer from one trace to the next. Returns false if the library was built without _EXP_TRACE.
+/// </summary>
+/// <remarks>
+///     The spans are a chunk of a loop (chunk), a chore of a task group (task), the part of a join that waits for the
+///     stolen chores (wait), the search of a worker for a chore to steal (steal) and a pool thread serving the queues
+///     (worker). Whether the ring buffers record or not, the spans are written as ETW events of the ParallelSTL
+///     provider while a session enables it.
+/// </remarks>
+_EXP_IMPL bool __cdecl start_tracing(size_t _Events_per_thread = 65536) _NOEXCEPT;
+
+/// <summary>
+///     Stops recording in the ring buffers, their events are kept until the next start_tracing.
+/// </summary>
+_EXP_IMPL void __cdecl stop_tracing() _NOEXCEPT;
+
+/// <summary>
+///     Returns true between start_tracing and stop_tracing.
+/// </summary>
+_EXP_IMPL bool __cdecl tracing_active() _NOEXCEPT;
+
+/// <summary>
+///     Fills up to _Capacity entries with the events of the ring buffers, the events of a thread oldest first, returns
+///     the number of events. Read after stop_tracing: the events of a trace in progress may be overwritten meanwhile.
+/// </summary>
+_EXP_IMPL size_t __cdecl get_trace_events(trace_event *_Events, size_t _Capacity) _NOEXCEPT;
+
+/// <summary>
+///     Returns the events of the ring buffers.
+/// </summary>
+inline std::vector<trace_event> take_trace()
+{
+	std::vector<trace_event> _Events(get_trace_events(nullptr, 0));
+	_Events.resize((std::min)(get_trace_events(_Events.data(), _Events.size()), _Events.size()));
+	return _Events;
+}
+
+namespace details {
+	// Microseconds with three decimals, the unit of the Chrome trace format
+	inline void _Write_trace_us(std::ostream& _Out, unsigned long long _Ns)
+	{
+		const unsigned long long _Fraction = _Ns % 1000;
+		_Out << _Ns / 1000 << '.' << static_cast<char>('0' + _Fraction / 100) << static_cast<char>('0' + _Fraction / 10 % 10) << static_cast<char>('0' + _Fraction % 10);
+	}
+
+	// The trace hooks of the scheduler. _Trace_begin returns 0 if the span isn't recorded, the time it
+	// starts otherwise, which is then passed to _Trace_end.
+	_EXP_IMPL unsigned long long __cdecl _Trace_begin() _NOEXCEPT;
+	_EXP_IMPL void __cdecl _Trace_end(unsigned long long _Begin, const char *_Category, size_t _Count) _NOEXCEPT;
+}
+
+/// <summary>
+///     Writes the events of the ring buffers in the Chrome trace event format, to be loaded in chrome://tracing or
+///     Perfetto. A worker is a thread of the timeline.
+/// </summary>
+inline void write_chrome_trace(std::ostream& _Out)
+{
+	const std::vector<trace_event> _Events = take_trace();
+
+	_Out << "{\"traceEvents\":[";
+	for (size_t _I = 0; _I < _Events.size(); ++_I)
+	{
+		const trace_event& _Event = _Events[_I];
+		_Out << (_I == 0 ? "\n" : ",\n");
+		_Out << "{\"name\":\"" << (_Event.name != nullptr ? _Event.name : _Event.category) << "\",\"cat\":\"" << _Event.category;
+		_Out << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << _Event.worker << ",\"ts\":";
+		details::_Write_trace_us(_Out, _Event.begin_ns);
+		_Out << ",\"dur\":";
+		details::_Write_trace_us(_Out, _Event.duration_ns);
+		_Out << ",\"args\":{\"count\":" << _Event.count << "}}";
+	}
+	_Out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+}
+
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TRACE_H_
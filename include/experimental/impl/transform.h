@@ -4,6 +4,7 @@
 #define _IMPL_TRANSFORM_H_ 1
 
 #include "algorithm_impl.h"
+#include "foreach.h"
 
 _PSTL_NS1_BEGIN
 namespace details {
@@ -62,10 +63,12 @@ namespace details {
 		{
 			if (_Count == 0)
 				return;
-			typename std::iterator_traits<_InIt>::pointer _FirstP = std::addressof(*_First);
-			typename std::iterator_traits<_InIt>::pointer _First2P = std::addressof(*_First2);
-			typename std::iterator_traits<_OutIt>::pointer _DestP = std::addressof(*_Dest);
+			// The output may be one of the inputs, the pointers can't be restrict qualified
+			typename std::iterator_traits<_InIt>::pointer _FirstP = _Unwrap_contiguous(_First);
+			typename std::iterator_traits<_InIt2>::pointer _First2P = _Unwrap_contiguous(_First2);
+			typename std::iterator_traits<_OutIt>::pointer _DestP = _Unwrap_contiguous(_Dest);
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_DestP[_I] = _UserFunc(_FirstP[_I], _First2P[_I]);
 		}
@@ -74,6 +77,7 @@ namespace details {
 		static void VecLoopHelper2(_InIt _First, size_t _Count, _InIt2 _First2, _OutIt _Dest, _Fn& _UserFunc, std::false_type)
 		{
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_Dest[_I] = _UserFunc(_First[_I], _First2[_I]);
 		}
@@ -91,9 +95,11 @@ namespace details {
 			if (_Count == 0)
 				return;
 			// We are doing this for helping compiler vectorize loops. Vectorizer likes raw pointer more.
-			typename std::iterator_traits<_InIt>::pointer _FirstP = std::addressof(*_First);
-			typename std::iterator_traits<_OutIt>::pointer _DestP = std::addressof(*_Dest);
+			// The output may be the input, the pointers can't be restrict qualified.
+			typename std::iterator_traits<_InIt>::pointer _FirstP = _Unwrap_contiguous(_First);
+			typename std::iterator_traits<_OutIt>::pointer _DestP = _Unwrap_contiguous(_Dest);
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_DestP[_I] = _UserFunc(_FirstP[_I]);
 		}
@@ -102,6 +108,7 @@ namespace details {
 		static void VecLoopHelper1(_InIt _First, size_t _Count, _OutIt _Dest, _Fn& _UserFunc, std::false_type)
 		{
 			_EXP_PRAGMA_VEC
+			_EXP_LOOP_IVDEP
 				for (size_t _I = 0; _I < _Count; ++_I)
 					_Dest[_I] = _UserFunc(_First[_I]);
 		}
@@ -120,13 +127,13 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _InIt, class _OutIt, class _Fn, class _IterCat>
-	_OutIt _Transform_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _IterCat)
+	_OutIt _Transform_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
 		if (_First != _Last) {
-			return std::get<1>(*_Partitioner<_ExPolicy>::_For_Each(make_composable_iterator(_First, _Dest), std::distance(_First, _Last), _Func,
-				[](composable_iterator<_InIt, _OutIt> _Begin, size_t _Count, _Fn& _UserFunc) {
+			return std::get<1>(*_Partitioned_for_each(_Policy, make_composable_iterator(_First, _Dest), std::distance(_First, _Last), _Func,
+				[](composable_iterator<_InIt, _OutIt> _Begin, size_t _Count, _Fn& _UserFunc) _EXP_NOEXCEPT_IF((_Is_nothrow_element_store<_Fn, _OutIt, _InIt>::value)) {
 				_Transform_helper<_ExPolicy, _IterCat>::Loop(std::get<0>(*_Begin), _Count, std::get<1>(*_Begin), _UserFunc);
 			}));
 		}
@@ -146,6 +153,76 @@ namespace details {
 		_EXP_GENERIC_EXECUTION_POLICY(_Transform_impl, _Policy, _First, _Last, _Dest, _Func, _Cat);
 	}
 
+	//
+	// transform with a prefetch hint, see for_each
+	//
+
+	// Stores the function of the element an iterator of the prefetched loop points to
+	template<typename _OutIt, typename _Fn>
+	struct _Store_transformed
+	{
+		_OutIt& _Dest;
+		_Fn& _Func;
+
+		template<typename _It>
+		void operator()(const _It& _Iter) const
+		{
+			*_Dest = _Func(*_Iter);
+			++_Dest;
+		}
+	};
+
+	template <class _InIt, class _OutIt, class _Fn, class _Pf, class _IterCat>
+	_OutIt _Transform_prefetch_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterCat)
+	{
+		_Prefetch_site *_Site = _Distance == 0 ? &_Prefetch_site_of<_InIt, _Fn, _Pf>() : nullptr;
+		if (_Site != nullptr)
+			_Distance = _Prefetch_distance(*_Site);
+
+		_Store_transformed<_OutIt, _Fn> _Store = { _Dest, _Func };
+		_EXP_TRY
+			_Prefetched_chunk(_First, static_cast<size_t>(std::distance(_First, _Last)), _Store, _Prefetch, _Distance, _Site);
+		_EXP_RETHROW
+
+		return _Dest;
+	}
+
+	template <class _ExPolicy, class _InIt, class _OutIt, class _Fn, class _Pf, class _IterCat>
+	_OutIt _Transform_prefetch_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterCat)
+	{
+		if (_First == _Last)
+			return _Dest;
+
+		_Prefetch_site *_Site = _Distance == 0 ? &_Prefetch_site_of<_InIt, _Fn, _Pf>() : nullptr;
+		if (_Site != nullptr)
+			_Distance = _Prefetch_distance(*_Site);
+
+		return std::get<1>(*_Partitioned_for_each(_Policy, make_composable_iterator(_First, _Dest), std::distance(_First, _Last), _Func,
+			[&_Prefetch, _Distance, _Site](composable_iterator<_InIt, _OutIt> _Begin, size_t _Count, _Fn& _UserFunc) {
+			_OutIt _Out = std::get<1>(*_Begin);
+			_Store_transformed<_OutIt, _Fn> _Store = { _Out, _UserFunc };
+			_Prefetched_chunk(std::get<0>(*_Begin), _Count, _Store, _Prefetch, _Distance, _Site);
+		}));
+	}
+
+	template <class _InIt, class _OutIt, class _Fn, class _Pf>
+	_OutIt _Transform_prefetch_impl(const sequential_execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _Pf, size_t, std::input_iterator_tag _Cat)
+	{
+		return _Transform_impl(_Policy, _First, _Last, _Dest, _Func, _Cat);
+	}
+
+	template <class _ExPolicy, class _InIt, class _OutIt, class _Fn, class _Pf>
+	typename _enable_if_parallel<_ExPolicy, _OutIt>::type _Transform_prefetch_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _Pf _Prefetch, size_t _Distance, std::input_iterator_tag _Cat)
+	{
+		return _Transform_prefetch_impl(seq, _First, _Last, _Dest, _Func, _Prefetch, _Distance, _Cat);
+	}
+
+	template <class _InIt, class _OutIt, class _Fn, class _Pf, class _IterCat>
+	_OutIt _Transform_prefetch_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, _Pf _Prefetch, size_t _Distance, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Transform_prefetch_impl, _Policy, _First, _Last, _Dest, _Func, _Prefetch, _Distance, _Cat);
+	}
+
 	//
 	// transform binary predicate
 	// 
@@ -158,13 +235,13 @@ namespace details {
 	}
 
 	template <class _ExPolicy, class _InIt, class _InIt2, class _OutIt, class _Fn, class _IterCat>
-	_OutIt _Transform_impl_binary(const _ExPolicy&, _InIt _First, _InIt _Last, _InIt2 _First2, _OutIt _Dest, _Fn _Func, _IterCat)
+	_OutIt _Transform_impl_binary(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _OutIt _Dest, _Fn _Func, _IterCat)
 	{
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 
 		if (_First != _Last) {
-			return std::get<2>(*_Partitioner<_ExecutionPolicy>::_For_Each(make_composable_iterator(_First, _First2, _Dest), std::distance(_First, _Last), _Func,
-				[](composable_iterator<_InIt, _InIt2, _OutIt> _Begin, size_t _Count, _Fn _UserFunc) {
+			return std::get<2>(*_Partitioned_for_each(_Policy, make_composable_iterator(_First, _First2, _Dest), std::distance(_First, _Last), _Func,
+				[](composable_iterator<_InIt, _InIt2, _OutIt> _Begin, size_t _Count, _Fn& _UserFunc) _EXP_NOEXCEPT_IF((_Is_nothrow_element_store<_Fn, _OutIt, _InIt, _InIt2>::value)) {
 				_Transform_helper<_ExecutionPolicy, _IterCat>::Loop(std::get<0>(*_Begin), _Count, std::get<1>(*_Begin), std::get<2>(*_Begin), _UserFunc);
 			}));
 		}
@@ -183,11 +260,72 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_Transform_impl_binary, _Policy, _First, _Last, _First2, _Dest, _Func, _Cat);
 	}
+
+	//
+	// transform over array views
+	//
+
+	// Stores the function of the elements of the segments of a view to another one of the same bounds, through
+	// the vectorizable loops of the pointers when the rows of both are contiguous
+	template<typename _ExPolicy, typename _InTy, typename _OutTy, int _Rank, typename _Fn>
+	struct _Transform_view_segment
+	{
+		const _View_cursor<_InTy, _Rank>& _Source;
+		const _View_cursor<_OutTy, _Rank>& _Dest;
+		_Fn& _Func;
+
+		void operator()(const D4087::index<_Rank>& _Origin, size_t _Count) const
+		{
+			_InTy *_First = _Source._At(_Origin);
+			_OutTy *_Out = _Dest._At(_Origin);
+			const ptrdiff_t _Step = _Source._Step();
+			const ptrdiff_t _Out_step = _Dest._Step();
+			if (_Step == 1 && _Out_step == 1)
+				_Transform_helper<_ExPolicy, std::random_access_iterator_tag>::Loop(_First, _Count, _Out, _Func);
+			else
+				for (size_t _I = 0; _I < _Count; ++_I, _First += _Step, _Out += _Out_step)
+					*_Out = _Func(*_First);
+		}
+	};
+
+	template<class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Transform_view_impl(const sequential_execution_policy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view, _Fn _Func)
+	{
+		const _View_cursor<_InTy, _Rank> _Source(_View);
+		const _View_cursor<_OutTy, _Rank> _Dest(_Dest_view);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Transform_view_segment<sequential_execution_policy, _InTy, _OutTy, _Rank, _Fn> _Segment = { _Source, _Dest, _Func };
+
+		_EXP_TRY
+			_Segments._Apply(0, _Segments._Count(), _Segment);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Transform_view_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view, _Fn _Func)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+
+		const _View_cursor<_InTy, _Rank> _Source(_View);
+		const _View_cursor<_OutTy, _Rank> _Dest(_Dest_view);
+		const _View_segments<_Rank> _Segments = _Make_view_segments(_Policy, _View.bounds());
+		_Partitioned_for_each_segment(_Policy, _Segments._Count(), _Func, [&_Source, &_Dest, &_Segments](size_t _First, size_t _Count, _Fn& _UserFunc) {
+			_Transform_view_segment<_ExecutionPolicy, _InTy, _OutTy, _Rank, _Fn> _Segment = { _Source, _Dest, _UserFunc };
+			_Segments._Apply(_First, _Count, _Segment);
+		});
+	}
+
+	template<class _InTy, class _OutTy, int _Rank, class _Fn>
+	inline void _Transform_view_impl(const execution_policy& _Policy, const D4087::strided_array_view<_InTy, _Rank>& _View, const D4087::strided_array_view<_OutTy, _Rank>& _Dest_view, _Fn _Func)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Transform_view_impl, _Policy, _View, _Dest_view, _Func);
+	}
 } // details
 
 template <class _ExPolicy, class _InIt, class _OutIt, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("transform");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -195,9 +333,25 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform(_E
 	return details::_Transform_impl(_Policy, _First, _Last, _Dest, _Func, _Cat);
 }
 
+/// <summary>
+///     Stores _Func of every element of the range to the range at _Dest and prefetches ahead of it what the hint
+///     points to, see prefetch_hint.
+/// </summary>
+template <class _ExPolicy, class _InIt, class _OutIt, class _Fn, class _Pf>
+inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Fn _Func, const prefetch_hint<_Pf>& _Hint)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	details::common_iterator<_InIt, _OutIt>::iterator_category _Cat;
+	return details::_Transform_prefetch_impl(_Policy, _First, _Last, _Dest, _Func, _Hint.prefetcher(), _Hint.distance(), _Cat);
+}
+
 template <class _ExPolicy, class _InIt, class _InIt2, class _OutIt, class _Fn>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _OutIt _Dest, _Fn _Func)
 {
+	_EXP_TELEMETRY_ALGORITHM("transform");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
@@ -205,6 +359,30 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type transform(_E
 	details::common_iterator<_InIt, _InIt2, _OutIt>::iterator_category _Cat;
 	return details::_Transform_impl_binary(_Policy, _First, _Last, _First2, _Dest, _Func, _Cat);
 }
+
+/// <summary>
+///     Stores _Func of every element of an array view to the element at the same index of another
+///     view of the same bounds. Two views without gaps are run as contiguous ranges.
+/// </summary>
+template <class _ExPolicy, class _InView, class _OutView, class _Fn>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type transform(_ExPolicy&& _Policy, const _InView& _View, const _OutView& _Dest_view, _Fn _Func)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform");
+	static_assert(_InView::rank == _OutView::rank, "Required views of the same rank.");
+	_ASSERTE(_View.bounds() == _Dest_view.bounds());
+
+	if (_View.size() == 0)
+		return;
+
+	const auto& _Source = details::_Strided_view(_View);
+	const auto& _Dest = details::_Strided_view(_Dest_view);
+	if (details::_Is_dense_view(_Source) && details::_Is_dense_view(_Dest)) {
+		auto _First = details::_View_data(_Source);
+		details::_Transform_impl(_Policy, _First, _First + _Source.size(), details::_View_data(_Dest), _Func, std::random_access_iterator_tag());
+	}
+	else
+		details::_Transform_view_impl(_Policy, _Source, _Dest, _Func);
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_TRANSFORM_H_
@@ -0,0 +1,210 @@
+#pragma once
+
+#ifndef _IMPL_TRANSFORM_REDUCE_H_
+#define _IMPL_TRANSFORM_REDUCE_H_ 1
+
+#include "algorithm_impl.h"
+#include "reduce.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// The reduction and the transform travel together as the user data of the chores
+	template<typename _BinOp, typename _Transform>
+	struct _Transform_reduce_ops
+	{
+		_BinOp _Reduce;
+		_Transform _Transform_op;
+
+		_Transform_reduce_ops(_BinOp _R, _Transform _T) : _Reduce(_R), _Transform_op(_T)
+		{
+		}
+	};
+
+	//
+	// transform_reduce
+	//
+	template <class _InIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	_Ty _Transform_reduce_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform, _IterCat)
+	{
+		_EXP_TRY
+			return transform_reduce(_First, _Last, _Init, _Reduce, _Transform);
+		_EXP_RETHROW
+	}
+
+	template <class _ExPolicy, class _InIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	_Ty _Transform_reduce_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform, _IterCat)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef _Transform_reduce_ops<_BinOp, _UnOp> _Ops;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		if (_First == _Last)
+			return _Init;
+
+		combinable<_Ty> _Combine([_Init]{ return _Init; });
+
+		_Partitioned_for_each(_Policy, _First, std::distance(_First, _Last), _Ops(_Reduce, _Transform),
+			[&_Combine](_InIt _Begin, size_t _Count, _Ops& _UserOps) {
+			_Ty _Val = _Reduce_helper<_ExecutionPolicy, _IterCat>::Loop<_Ty>(_Begin, _Count, _UserOps._Reduce, _UserOps._Transform_op);
+
+			bool _Exists;
+			auto &_Sum = _Combine.local(_Exists);
+			if (_Exists)
+				_Sum = _UserOps._Reduce(_Sum, _Val);
+			else _Sum = _Val;
+		});
+
+		return _Reduce(_Init, _Combine.combine(_Reduce));
+	}
+
+	// Random access ranges reduce into one slot per chunk, like reduce
+	template <class _ExPolicy, class _RanIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Transform_reduce_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform, std::random_access_iterator_tag)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef _Transform_reduce_ops<_BinOp, _UnOp> _Ops;
+
+		if (_First == _Last)
+			return _Init;
+
+		return _Reduce(_Init, _Chunked_reduce<_Ty>(_Policy, _First, _Last - _First, _Ops(_Reduce, _Transform),
+			[](_RanIt _Begin, size_t _Count, _Ops& _UserOps) {
+			return _Reduce_helper<_ExecutionPolicy, std::random_access_iterator_tag>::Loop<_Ty>(_Begin, _Count, _UserOps._Reduce, _UserOps._Transform_op);
+		},
+			[](const _Ty& _Left, const _Ty& _Right, _Ops& _UserOps) {
+			return _UserOps._Reduce(_Left, _Right);
+		}));
+	}
+
+	template <class _ExPolicy, class _InIt, class _Ty, class _BinOp, class _UnOp>
+	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Transform_reduce_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform, std::input_iterator_tag _Cat)
+	{
+		return _Transform_reduce_impl(seq, _First, _Last, _Init, _Reduce, _Transform, _Cat);
+	}
+
+	template <class _InIt, class _Ty, class _BinOp, class _UnOp, class _IterCat>
+	inline _Ty _Transform_reduce_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Transform_reduce_impl, _Policy, _First, _Last, _Init, _Reduce, _Transform, _Cat);
+	}
+
+	//
+	// transform_reduce of two ranges
+	//
+	template <class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2, class _IterCat>
+	_Ty _Transform_reduce_impl_binary(const sequential_execution_policy&, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform, _IterCat)
+	{
+		_EXP_TRY
+			return transform_reduce(_First, _Last, _First2, _Init, _Reduce, _Transform);
+		_EXP_RETHROW
+	}
+
+	template <class _ExPolicy, class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2, class _IterCat>
+	_Ty _Transform_reduce_impl_binary(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform, _IterCat)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef _Transform_reduce_ops<_BinOp, _BinOp2> _Ops;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		if (_First == _Last)
+			return _Init;
+
+		combinable<_Ty> _Combine([_Init]{ return _Init; });
+
+		_Partitioned_for_each(_Policy, make_composable_iterator(_First, _First2), std::distance(_First, _Last), _Ops(_Reduce, _Transform),
+			[&_Combine](composable_iterator<_InIt, _InIt2> _Begin, size_t _Count, _Ops& _UserOps) {
+			_Ty _Val = _Reduce_helper<_ExecutionPolicy, _IterCat>::Loop<_Ty>(std::get<0>(*_Begin), std::get<1>(*_Begin), _Count, _UserOps._Reduce, _UserOps._Transform_op);
+
+			bool _Exists;
+			auto &_Sum = _Combine.local(_Exists);
+			if (_Exists)
+				_Sum = _UserOps._Reduce(_Sum, _Val);
+			else _Sum = _Val;
+		});
+
+		return _Reduce(_Init, _Combine.combine(_Reduce));
+	}
+
+	template <class _ExPolicy, class _RanIt, class _RanIt2, class _Ty, class _BinOp, class _BinOp2>
+	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Transform_reduce_impl_binary(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _RanIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform, std::random_access_iterator_tag)
+	{
+		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
+		typedef _Transform_reduce_ops<_BinOp, _BinOp2> _Ops;
+
+		if (_First == _Last)
+			return _Init;
+
+		// The chunks index both ranges from the same offset
+		return _Reduce(_Init, _Chunked_reduce<_Ty>(_Policy, _First, _Last - _First, _Ops(_Reduce, _Transform),
+			[_First, _First2](_RanIt _Begin, size_t _Count, _Ops& _UserOps) {
+			return _Reduce_helper<_ExecutionPolicy, std::random_access_iterator_tag>::Loop<_Ty>(_Begin, _First2 + (_Begin - _First), _Count, _UserOps._Reduce, _UserOps._Transform_op);
+		},
+			[](const _Ty& _Left, const _Ty& _Right, _Ops& _UserOps) {
+			return _UserOps._Reduce(_Left, _Right);
+		}));
+	}
+
+	template <class _ExPolicy, class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2>
+	inline typename _enable_if_parallel<_ExPolicy, _Ty>::type _Transform_reduce_impl_binary(const _ExPolicy&, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform, std::input_iterator_tag _Cat)
+	{
+		return _Transform_reduce_impl_binary(seq, _First, _Last, _First2, _Init, _Reduce, _Transform, _Cat);
+	}
+
+	template <class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2, class _IterCat>
+	inline _Ty _Transform_reduce_impl_binary(const execution_policy& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Transform_reduce_impl_binary, _Policy, _First, _Last, _First2, _Init, _Reduce, _Transform, _Cat);
+	}
+}  //details
+
+template <class _ExPolicy, class _InIt, class _Ty, class _BinOp, class _UnOp>
+inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type transform_reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _Ty _Init, _BinOp _Reduce, _UnOp _Transform)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_reduce");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+
+	return details::_Transform_reduce_impl(_Policy, _First, _Last, _Init, _Reduce, _Transform, std::_Iter_cat(_First));
+}
+
+template <class _ExPolicy, class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2>
+inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type transform_reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Reduce, _BinOp2 _Transform)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_reduce");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt2>::iterator_category>::value, "Required input iterator or stronger.");
+
+	details::common_iterator<_InIt, _InIt2>::iterator_category _Cat;
+	return details::_Transform_reduce_impl_binary(_Policy, _First, _Last, _First2, _Init, _Reduce, _Transform, _Cat);
+}
+
+template <class _ExPolicy, class _InIt, class _InIt2, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type transform_reduce(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init)
+{
+	_EXP_TELEMETRY_ALGORITHM("transform_reduce");
+	return transform_reduce(_Policy, _First, _Last, _First2, _Init, std::plus<>(), std::multiplies<>());
+}
+
+// The parallel inner_product may regroup the sums, _Op must be associative and commutative as for reduce
+template <class _ExPolicy, class _InIt, class _InIt2, class _Ty, class _BinOp, class _BinOp2>
+inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type inner_product(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init, _BinOp _Op, _BinOp2 _Op2)
+{
+	_EXP_TELEMETRY_ALGORITHM("inner_product");
+	return transform_reduce(_Policy, _First, _Last, _First2, _Init, _Op, _Op2);
+}
+
+template <class _ExPolicy, class _InIt, class _InIt2, class _Ty>
+inline typename details::_enable_if_policy<_ExPolicy, _Ty>::type inner_product(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _InIt2 _First2, _Ty _Init)
+{
+	_EXP_TELEMETRY_ALGORITHM("inner_product");
+	return transform_reduce(_Policy, _First, _Last, _First2, _Init, std::plus<>(), std::multiplies<>());
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TRANSFORM_REDUCE_H_
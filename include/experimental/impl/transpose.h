@@ -0,0 +1,246 @@
+#pragma once
+
+#ifndef _IMPL_TRANSPOSE_H_
+#define _IMPL_TRANSPOSE_H_ 1
+
+#include <cstring>
+#include <type_traits>
+#include "algorithm_impl.h"
+
+#if _EXP_SSE2
+#include <emmintrin.h>
+#endif
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Blocks of a 2D copy no longer than this on both sides fit in the first level cache, their
+	// rows and columns are copied by a direct loop
+	const ptrdiff_t _Copy_2d_leaf = 16;
+
+	// The elements of a 2D block, the element at (_Row, _Col) is at _Data + _Row * _Row_stride + _Col * _Col_stride
+	template<typename _Ty>
+	struct _Block_2d
+	{
+		_Ty *_Data;
+		ptrdiff_t _Row_stride;
+		ptrdiff_t _Col_stride;
+
+		_Ty *_At(ptrdiff_t _Row, ptrdiff_t _Col) const
+		{
+			return _Data + _Row * _Row_stride + _Col * _Col_stride;
+		}
+
+		// The same elements with the rows and the columns swapped
+		_Block_2d _Flip() const
+		{
+			const _Block_2d _Flipped = { _Data, _Col_stride, _Row_stride };
+			return _Flipped;
+		}
+	};
+
+	// Elements of 4 or 8 bytes copied as bytes are transposed in registers
+	template<typename _InTy, typename _OutTy>
+	struct _Is_register_transpose : std::integral_constant<bool, _EXP_SSE2 != 0
+		&& std::is_same<typename std::remove_cv<_InTy>::type, _OutTy>::value
+		&& std::is_trivially_copyable<_OutTy>::value
+		&& (sizeof(_OutTy) == 4 || sizeof(_OutTy) == 8)>
+	{
+	};
+
+	template<typename _InTy, typename _OutTy>
+	inline void _Copy_leaf_2d(const _Block_2d<_InTy>& _Src, const _Block_2d<_OutTy>& _Dest, ptrdiff_t _Rows, ptrdiff_t _Cols)
+	{
+		for (ptrdiff_t _Row = 0; _Row < _Rows; ++_Row)
+		{
+			_InTy *_From = _Src._At(_Row, 0);
+			_OutTy *_To = _Dest._At(_Row, 0);
+			for (ptrdiff_t _Col = 0; _Col < _Cols; ++_Col, _From += _Src._Col_stride, _To += _Dest._Col_stride)
+				*_To = *_From;
+		}
+	}
+
+#if _EXP_SSE2
+	// 4 rows of 4 elements of the source stored to 4 columns of the destination
+	template<typename _InTy, typename _OutTy>
+	inline void _Transpose_registers(const _InTy *_Src, ptrdiff_t _Src_row, _OutTy *_Dest, ptrdiff_t _Dest_col, std::integral_constant<size_t, 4>)
+	{
+		__m128 _Row0 = _mm_loadu_ps(reinterpret_cast<const float *>(_Src));
+		__m128 _Row1 = _mm_loadu_ps(reinterpret_cast<const float *>(_Src + _Src_row));
+		__m128 _Row2 = _mm_loadu_ps(reinterpret_cast<const float *>(_Src + 2 * _Src_row));
+		__m128 _Row3 = _mm_loadu_ps(reinterpret_cast<const float *>(_Src + 3 * _Src_row));
+		_MM_TRANSPOSE4_PS(_Row0, _Row1, _Row2, _Row3);
+		_mm_storeu_ps(reinterpret_cast<float *>(_Dest), _Row0);
+		_mm_storeu_ps(reinterpret_cast<float *>(_Dest + _Dest_col), _Row1);
+		_mm_storeu_ps(reinterpret_cast<float *>(_Dest + 2 * _Dest_col), _Row2);
+		_mm_storeu_ps(reinterpret_cast<float *>(_Dest + 3 * _Dest_col), _Row3);
+	}
+
+	// 2 rows of 2 elements of the source stored to 2 columns of the destination
+	template<typename _InTy, typename _OutTy>
+	inline void _Transpose_registers(const _InTy *_Src, ptrdiff_t _Src_row, _OutTy *_Dest, ptrdiff_t _Dest_col, std::integral_constant<size_t, 8>)
+	{
+		const __m128d _Row0 = _mm_loadu_pd(reinterpret_cast<const double *>(_Src));
+		const __m128d _Row1 = _mm_loadu_pd(reinterpret_cast<const double *>(_Src + _Src_row));
+		_mm_storeu_pd(reinterpret_cast<double *>(_Dest), _mm_unpacklo_pd(_Row0, _Row1));
+		_mm_storeu_pd(reinterpret_cast<double *>(_Dest + _Dest_col), _mm_unpackhi_pd(_Row0, _Row1));
+	}
+
+	// The rows of the source are contiguous and so are the columns of the destination, the block is cut
+	// in squares transposed in registers and the edges left over are copied one element at a time
+	template<typename _InTy, typename _OutTy>
+	inline void _Transpose_leaf_2d(const _Block_2d<_InTy>& _Src, const _Block_2d<_OutTy>& _Dest, ptrdiff_t _Rows, ptrdiff_t _Cols)
+	{
+		const ptrdiff_t _Side = 16 / sizeof(_OutTy);
+		const ptrdiff_t _Square_rows = _Rows - _Rows % _Side;
+		const ptrdiff_t _Square_cols = _Cols - _Cols % _Side;
+
+		for (ptrdiff_t _Row = 0; _Row < _Square_rows; _Row += _Side)
+			for (ptrdiff_t _Col = 0; _Col < _Square_cols; _Col += _Side)
+				_Transpose_registers(_Src._At(_Row, _Col), _Src._Row_stride, _Dest._At(_Row, _Col), _Dest._Col_stride, std::integral_constant<size_t, sizeof(_OutTy)>());
+
+		const _Block_2d<_InTy> _Right_src = { _Src._At(0, _Square_cols), _Src._Row_stride, _Src._Col_stride };
+		const _Block_2d<_OutTy> _Right_dest = { _Dest._At(0, _Square_cols), _Dest._Row_stride, _Dest._Col_stride };
+		_Copy_leaf_2d(_Right_src, _Right_dest, _Rows, _Cols - _Square_cols);
+
+		const _Block_2d<_InTy> _Bottom_src = { _Src._At(_Square_rows, 0), _Src._Row_stride, _Src._Col_stride };
+		const _Block_2d<_OutTy> _Bottom_dest = { _Dest._At(_Square_rows, 0), _Dest._Row_stride, _Dest._Col_stride };
+		_Copy_leaf_2d(_Bottom_src, _Bottom_dest, _Rows - _Square_rows, _Square_cols);
+	}
+#endif
+
+	template<typename _InTy, typename _OutTy>
+	inline void _Copy_leaf_2d(const _Block_2d<_InTy>& _Src, const _Block_2d<_OutTy>& _Dest, ptrdiff_t _Rows, ptrdiff_t _Cols, std::false_type)
+	{
+		// the inner loop walks the dimension the destination is contiguous on, else the one of the source
+		if (_Dest._Row_stride == 1 || (_Dest._Col_stride != 1 && _Src._Row_stride == 1))
+			_Copy_leaf_2d(_Src._Flip(), _Dest._Flip(), _Cols, _Rows);
+		else
+			_Copy_leaf_2d(_Src, _Dest, _Rows, _Cols);
+	}
+
+	template<typename _InTy, typename _OutTy>
+	inline void _Copy_leaf_2d(const _Block_2d<_InTy>& _Src, const _Block_2d<_OutTy>& _Dest, ptrdiff_t _Rows, ptrdiff_t _Cols, std::true_type)
+	{
+#if _EXP_SSE2
+		if (_Src._Col_stride == 1 && _Dest._Row_stride == 1)
+			_Transpose_leaf_2d(_Src, _Dest, _Rows, _Cols);
+		else if (_Src._Row_stride == 1 && _Dest._Col_stride == 1)
+			_Transpose_leaf_2d(_Src._Flip(), _Dest._Flip(), _Cols, _Rows);
+		else
+#endif
+			_Copy_leaf_2d(_Src, _Dest, _Rows, _Cols, std::false_type());
+	}
+
+	// Copies the elements (_Row, _Col) of _Src to the same ones of _Dest, halving the longer side of the block
+	// until it fits the cache whatever its size, so the strides of both are walked a cache line at a time
+	template<typename _InTy, typename _OutTy>
+	inline void _Copy_block_2d(const _Block_2d<_InTy>& _Src, const _Block_2d<_OutTy>& _Dest, ptrdiff_t _Rows, ptrdiff_t _Cols)
+	{
+		if (_Rows <= _Copy_2d_leaf && _Cols <= _Copy_2d_leaf)
+		{
+			_Copy_leaf_2d(_Src, _Dest, _Rows, _Cols, _Is_register_transpose<_InTy, _OutTy>());
+		}
+		else if (_Rows >= _Cols)
+		{
+			const ptrdiff_t _Half = _Rows / 2;
+			const _Block_2d<_InTy> _Src_low = { _Src._At(_Half, 0), _Src._Row_stride, _Src._Col_stride };
+			const _Block_2d<_OutTy> _Dest_low = { _Dest._At(_Half, 0), _Dest._Row_stride, _Dest._Col_stride };
+			_Copy_block_2d(_Src, _Dest, _Half, _Cols);
+			_Copy_block_2d(_Src_low, _Dest_low, _Rows - _Half, _Cols);
+		}
+		else
+		{
+			const ptrdiff_t _Half = _Cols / 2;
+			const _Block_2d<_InTy> _Src_right = { _Src._At(0, _Half), _Src._Row_stride, _Src._Col_stride };
+			const _Block_2d<_OutTy> _Dest_right = { _Dest._At(0, _Half), _Dest._Row_stride, _Dest._Col_stride };
+			_Copy_block_2d(_Src, _Dest, _Rows, _Half);
+			_Copy_block_2d(_Src_right, _Dest_right, _Rows, _Cols - _Half);
+		}
+	}
+
+	template<typename _Ty>
+	inline _Block_2d<_Ty> _Make_block_2d(const D4087::strided_array_view<_Ty, 2>& _View)
+	{
+		const _Block_2d<_Ty> _Block = { _View_data(_View), _View.stride()[0], _View.stride()[1] };
+		return _Block;
+	}
+
+	// Copies the elements of a tile of the bounds
+	template<typename _InTy, typename _OutTy>
+	struct _Copy_2d_tile
+	{
+		_Block_2d<_InTy> _Src;
+		_Block_2d<_OutTy> _Dest;
+
+		void operator()(const D4087::index<2>& _Origin, const D4087::bounds<2>& _Tile) const
+		{
+			const _Block_2d<_InTy> _Tile_src = { _Src._At(_Origin[0], _Origin[1]), _Src._Row_stride, _Src._Col_stride };
+			const _Block_2d<_OutTy> _Tile_dest = { _Dest._At(_Origin[0], _Origin[1]), _Dest._Row_stride, _Dest._Col_stride };
+			_Copy_block_2d(_Tile_src, _Tile_dest, _Tile[0], _Tile[1]);
+		}
+	};
+
+	//
+	// 2D copy between views of the same bounds walked along different dimensions
+	//
+	template<class _InTy, class _OutTy>
+	inline void _Copy_2d_impl(const sequential_execution_policy&, const D4087::strided_array_view<_InTy, 2>& _View, const D4087::strided_array_view<_OutTy, 2>& _Dest_view)
+	{
+		_EXP_TRY
+			_Copy_block_2d(_Make_block_2d(_View), _Make_block_2d(_Dest_view), _View.bounds()[0], _View.bounds()[1]);
+		_EXP_RETHROW
+	}
+
+	// The chores take runs of neighbouring tiles and cut each of them down recursively
+	template<class _ExPolicy, class _InTy, class _OutTy>
+	inline void _Copy_2d_impl(const _ExPolicy& _Policy, const D4087::strided_array_view<_InTy, 2>& _View, const D4087::strided_array_view<_OutTy, 2>& _Dest_view)
+	{
+		const D4087::bounds<2> _Bnd = _View.bounds();
+		const _Tiling<2> _Tiles(_Bnd, _Default_tile_shape(_Bnd));
+		const _Copy_2d_tile<_InTy, _OutTy> _Copy_tile = { _Make_block_2d(_View), _Make_block_2d(_Dest_view) };
+
+		_Partitioned_for_each(_Policy, std::begin(_Tiles._Tiles()), _Tiles._Tiles().size(), _Copy_tile, [&_Tiles](D4087::bounds_iterator<2> _Begin, size_t _Count, _Copy_2d_tile<_InTy, _OutTy>& _Tile) {
+			for (size_t _I = 0; _I < _Count; ++_Begin, ++_I)
+				_Tiles._Apply(*_Begin, _Tile);
+		});
+	}
+
+	template<class _InTy, class _OutTy>
+	inline void _Copy_2d_impl(const execution_policy& _Policy, const D4087::strided_array_view<_InTy, 2>& _View, const D4087::strided_array_view<_OutTy, 2>& _Dest_view)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Copy_2d_impl, _Policy, _View, _Dest_view);
+	}
+
+	// The view of the destination of a transpose with its dimensions swapped, index (_Row, _Col) of the
+	// source is stored to it at (_Row, _Col)
+	template<typename _Ty>
+	inline D4087::strided_array_view<_Ty, 2> _Transposed_view(const D4087::strided_array_view<_Ty, 2>& _View)
+	{
+		const D4087::bounds<2> _Bnd = _View.bounds();
+		const D4087::index<2> _Stride = _View.stride();
+		return D4087::strided_array_view<_Ty, 2>({ _Bnd[1], _Bnd[0] }, { _Stride[1], _Stride[0] }, _View_data(_View));
+	}
+} // details
+
+/// <summary>
+///     Stores the element (_Row, _Col) of _View to (_Col, _Row) of _Dest_view, the bounds of the destination are the ones
+///     of the source swapped. The views are cut in tiles for the threads, then in halves down to blocks that fit the first
+///     level cache. When the rows of one view and the columns of the other are contiguous, the elements of 4 and 8
+///     bytes are transposed in registers. The views don't overlap.
+/// </summary>
+template<class _ExPolicy, class _InView, class _OutView>
+inline typename details::_enable_if_policy<_ExPolicy, typename details::_enable_if_view<_InView, typename details::_enable_if_view<_OutView>::type>::type>::type transpose(_ExPolicy&& _Policy, const _InView& _View, const _OutView& _Dest_view)
+{
+	_EXP_TELEMETRY_ALGORITHM("transpose");
+	static_assert(_InView::rank == 2 && _OutView::rank == 2, "Required two dimensional views.");
+	_ASSERTE(_View.bounds()[0] == _Dest_view.bounds()[1] && _View.bounds()[1] == _Dest_view.bounds()[0]);
+
+	if (_View.size() == 0)
+		return;
+
+	details::_Copy_2d_impl(_Policy, details::_Strided_view(_View), details::_Transposed_view(details::_Strided_view(_Dest_view)));
+}
+_PSTL_NS1_END // std::experimental::parallel
+
+#endif // _IMPL_TRANSPOSE_H_
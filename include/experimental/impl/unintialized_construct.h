@@ -0,0 +1,126 @@
+#pragma once
+
+#ifndef _IMPL_UNINITIALIZED_CONSTRUCT_H_
+#define _IMPL_UNINITIALIZED_CONSTRUCT_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Default initialization leaves the trivial types indeterminate, value initialization zeroes them
+	struct _Default_construct_tag {};
+	struct _Value_construct_tag {};
+
+	template<class _Ty>
+	inline void _Construct_at(_Ty *_Ptr, _Default_construct_tag)
+	{
+		::new (static_cast<void *>(_Ptr)) _Ty;
+	}
+
+	template<class _Ty>
+	inline void _Construct_at(_Ty *_Ptr, _Value_construct_tag)
+	{
+		::new (static_cast<void *>(_Ptr)) _Ty();
+	}
+
+	// Constructs _Count objects from _First, the ones already constructed are destroyed if one throws
+	template<class _FwdIt, class _Diff, class _Tag>
+	_FwdIt _Uninitialized_construct_n_seq(_FwdIt _First, _Diff _Count, _Tag _Kind)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		_FwdIt _Next = _First;
+		try {
+			for (; _Count > 0; --_Count, ++_Next)
+				_Construct_at(std::addressof(*_Next), _Kind);
+		}
+		catch (...) {
+			for (; _First != _Next; ++_First)
+				std::addressof(*_First)->~value_type();
+
+			throw;
+		}
+
+		return _Next;
+	}
+
+	//
+	// uninitialized_default_construct_n, uninitialized_value_construct_n
+	//
+	template<class _FwdIt, class _Diff, class _Tag, class _IterCat>
+	inline _FwdIt _Uninitialized_construct_n_impl(const sequential_execution_policy&, _FwdIt _First, _Diff _Count, _Tag _Kind, _IterCat)
+	{
+		_EXP_TRY
+			return _Uninitialized_construct_n_seq(_First, _Count, _Kind);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _FwdIt, class _Diff, class _Tag, class _IterCat>
+	inline _FwdIt _Uninitialized_construct_n_impl(const _ExPolicy& _Policy, _FwdIt _First, _Diff _Count, _Tag, _IterCat)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		if (_Count <= 0)
+			return _First;
+
+		// Default initialization of the trivial types writes nothing, the range is left as it is. When it is
+		// first touched the pages are written by value initialization, an indeterminate value may be anything.
+		typedef std::integral_constant<bool, std::is_same<_Tag, _Default_construct_tag>::value && std::is_trivially_default_constructible<value_type>::value> _Writes_nothing;
+		typedef typename std::conditional<_Writes_nothing::value, _Value_construct_tag, _Tag>::type _Touch_tag;
+
+		if (_Writes_nothing::value && !std::is_same<_ExPolicy, parallel_affinity_execution_policy>::value) {
+			std::advance(_First, _Count);
+			return _First;
+		}
+
+		return _Uninitialized_for_each(_Policy, _First, static_cast<size_t>(_Count),
+			[](_FwdIt _Begin, size_t _Partition_size) {
+			_Uninitialized_construct_n_seq(_Begin, _Partition_size, _Touch_tag());
+		},
+			[](_FwdIt _Begin, size_t _Partition_size) {
+			_Destroy_range(_Begin, _Partition_size);
+		});
+	}
+
+	template<class _FwdIt, class _Diff, class _Tag, class _IterCat>
+	inline _FwdIt _Uninitialized_construct_n_impl(const execution_policy& _Policy, _FwdIt _First, _Diff _Count, _Tag _Kind, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Uninitialized_construct_n_impl, _Policy, _First, _Count, _Kind, _Cat);
+	}
+} // details
+
+template<class _ExPolicy, class _FwdIt, class _Diff>
+inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_default_construct_n(_ExPolicy&& _Policy, _FwdIt _First, _Diff _Count)
+{
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	return details::_Uninitialized_construct_n_impl(_Policy, _First, _Count, details::_Default_construct_tag(), std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type uninitialized_default_construct(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Uninitialized_construct_n_impl(_Policy, _First, std::distance(_First, _Last), details::_Default_construct_tag(), std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt, class _Diff>
+inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_value_construct_n(_ExPolicy&& _Policy, _FwdIt _First, _Diff _Count)
+{
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	return details::_Uninitialized_construct_n_impl(_Policy, _First, _Count, details::_Value_construct_tag(), std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, void>::type uninitialized_value_construct(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	details::_Uninitialized_construct_n_impl(_Policy, _First, std::distance(_First, _Last), details::_Value_construct_tag(), std::_Iter_cat(_First));
+}
+_PSTL_NS1_END// std::experimental::parallel
+
+#endif // _IMPL_UNINITIALIZED_CONSTRUCT_H_
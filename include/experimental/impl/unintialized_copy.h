@@ -19,21 +19,14 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _InIt, class _Diff, class _FwdIt, class _IterCat>
-	inline _FwdIt _Uninitialized_copy_n_impl(const _ExPolicy&, _InIt _First, _Diff _Count, _FwdIt _Dest, _IterCat)
+	inline _FwdIt _Uninitialized_copy_n_impl(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _FwdIt _Dest, _IterCat)
 	{
-		typedef std::iterator_traits<_FwdIt>::value_type value_type;
-
-		return std::get<1>(*_Partitioner<static_partitioner_tag>::_For_each_with_cleanup(make_composable_iterator(_First, _Dest), _Count, std::tuple<>(),
-			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size, std::tuple<>) {
+		return std::get<1>(*_Uninitialized_for_each(_Policy, make_composable_iterator(_First, _Dest), _Count,
+			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size) {
 			std::uninitialized_copy_n(std::get<0>(*_Begin), _Partition_size, std::get<1>(*_Begin));
 		},
-			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size, std::exception_ptr& _Ex) { // cleanup callback - assuming each chunk has either fully completed or has rolled back due to an exception.
-			if (_Ex == nullptr) { // destroy the objects that were already initialized on other threads
-				_FwdIt _It = std::get<1>(*_Begin);
-
-				for (; _Partition_size > 0; --_Partition_size, ++_It)
-					(&*_It)->~value_type();
-			}
+			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size) {
+			_Destroy_range(std::get<1>(*_Begin), _Partition_size);
 		}));
 	}
 
@@ -82,6 +75,7 @@ namespace details {
 template<class _ExPolicy, class _InIt, class _Diff, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_copy_n(_ExPolicy&& _Policy, _InIt _First, _Diff _Count, _FwdIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_copy_n");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
@@ -92,6 +86,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialize
 template<class _ExPolicy, class _InIt, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _FwdIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
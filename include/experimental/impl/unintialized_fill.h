@@ -19,19 +19,14 @@ namespace details {
 	}
 
 	template<class _ExPolicy, class _FwdIt, class _Diff, class _Ty, class _IterCat>
-	inline _FwdIt _Uninitialized_fill_n_impl(const _ExPolicy&, _FwdIt _First, _Diff _Count, const _Ty& _Init, _IterCat)
+	inline _FwdIt _Uninitialized_fill_n_impl(const _ExPolicy& _Policy, _FwdIt _First, _Diff _Count, const _Ty& _Init, _IterCat)
 	{
-		typedef std::iterator_traits<_FwdIt>::value_type value_type;
-
-		return _Partitioner<static_partitioner_tag>::_For_each_with_cleanup(_First, _Count, std::tuple<>(),
-			[&_Init](_FwdIt _Begin, size_t _Partition_size, std::tuple<>) {
+		return _Uninitialized_for_each(_Policy, _First, _Count,
+			[&_Init](_FwdIt _Begin, size_t _Partition_size) {
 			std::uninitialized_fill_n(_Begin, _Partition_size, _Init);
 		},
-			[](_FwdIt _Begin, size_t _Partition_size, std::exception_ptr& _Ex) { // cleanup callback - assuming each chunk has either fully completed or has rolled back due to an exception.
-			if (_Ex == nullptr) { // destroy the objects that were already initialized on other threads
-				for (; _Partition_size > 0; --_Partition_size, ++_Begin)
-					(&*_Begin)->~value_type();
-			}
+			[](_FwdIt _Begin, size_t _Partition_size) {
+			_Destroy_range(_Begin, _Partition_size);
 		});
 	}
 
@@ -68,6 +63,7 @@ namespace details {
 template<class _ExPolicy, class _FwdIt, class _Diff, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_fill_n(_ExPolicy&& _Policy, _FwdIt _First, _Diff _Count, const _Ty& _Init)
 {
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_fill_n");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Uninitialized_fill_n_impl(_Policy, _First, _Count, _Init, std::_Iter_cat(_First));
@@ -76,6 +72,7 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialize
 template<class _ExPolicy, class _FwdIt, class _Ty>
 inline typename details::_enable_if_policy<_ExPolicy, void>::type uninitialized_fill(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, const _Ty& _Init)
 {
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_fill");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	details::_Uninitialized_fill_impl(_Policy, _First, _Last, _Init, std::_Iter_cat(_First));
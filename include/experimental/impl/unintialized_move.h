@@ -0,0 +1,147 @@
+#pragma once
+
+#ifndef _IMPL_UNINITIALIZED_MOVE_H_
+#define _IMPL_UNINITIALIZED_MOVE_H_ 1
+
+#include "algorithm_impl.h"
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	// Move constructs _Count objects at _Dest, the ones already constructed are destroyed if one throws
+	template<class _InIt, class _Diff, class _FwdIt>
+	std::pair<_InIt, _FwdIt> _Uninitialized_move_n_seq(_InIt _First, _Diff _Count, _FwdIt _Dest)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		_FwdIt _Next = _Dest;
+		try {
+			for (; _Count > 0; --_Count, ++_First, ++_Next)
+				::new (static_cast<void *>(std::addressof(*_Next))) value_type(std::move(*_First));
+		}
+		catch (...) {
+			for (; _Dest != _Next; ++_Dest)
+				std::addressof(*_Dest)->~value_type();
+
+			throw;
+		}
+
+		return std::make_pair(_First, _Next);
+	}
+
+	template<class _InIt, class _FwdIt>
+	_FwdIt _Uninitialized_move_seq(_InIt _First, _InIt _Last, _FwdIt _Dest)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::value_type value_type;
+
+		_FwdIt _Next = _Dest;
+		try {
+			for (; _First != _Last; ++_First, ++_Next)
+				::new (static_cast<void *>(std::addressof(*_Next))) value_type(std::move(*_First));
+		}
+		catch (...) {
+			for (; _Dest != _Next; ++_Dest)
+				std::addressof(*_Dest)->~value_type();
+
+			throw;
+		}
+
+		return _Next;
+	}
+
+	//
+	// uninitialized_move_n
+	//
+	template<class _InIt, class _Diff, class _FwdIt, class _IterCat>
+	inline std::pair<_InIt, _FwdIt> _Uninitialized_move_n_impl(const sequential_execution_policy&, _InIt _First, _Diff _Count, _FwdIt _Dest, _IterCat)
+	{
+		_EXP_TRY
+			return _Uninitialized_move_n_seq(_First, _Count, _Dest);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _InIt, class _Diff, class _FwdIt, class _IterCat>
+	inline std::pair<_InIt, _FwdIt> _Uninitialized_move_n_impl(const _ExPolicy& _Policy, _InIt _First, _Diff _Count, _FwdIt _Dest, _IterCat)
+	{
+		if (_Count <= 0)
+			return std::make_pair(_First, _Dest);
+
+		auto _End = *_Uninitialized_for_each(_Policy, make_composable_iterator(_First, _Dest), static_cast<size_t>(_Count),
+			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size) {
+			_Uninitialized_move_n_seq(std::get<0>(*_Begin), _Partition_size, std::get<1>(*_Begin));
+		},
+			[](composable_iterator<_InIt, _FwdIt> _Begin, size_t _Partition_size) {
+			_Destroy_range(std::get<1>(*_Begin), _Partition_size);
+		});
+
+		return std::make_pair(std::get<0>(_End), std::get<1>(_End));
+	}
+
+	template<class _ExPolicy, class _InIt, class _Diff, class _FwdIt>
+	inline typename _enable_if_parallel<_ExPolicy, std::pair<_InIt, _FwdIt>>::type _Uninitialized_move_n_impl(const _ExPolicy&, _InIt _First, _Diff _Count, _FwdIt _Dest, std::input_iterator_tag _Cat)
+	{
+		return _Uninitialized_move_n_impl(seq, _First, _Count, _Dest, _Cat);
+	}
+
+	template<class _InIt, class _Diff, class _FwdIt, class _IterCat>
+	inline std::pair<_InIt, _FwdIt> _Uninitialized_move_n_impl(const execution_policy& _Policy, _InIt _First, _Diff _Count, _FwdIt _Dest, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Uninitialized_move_n_impl, _Policy, _First, _Count, _Dest, _Cat);
+	}
+
+	//
+	// uninitialized_move
+	//
+	template<class _InIt, class _FwdIt, class _IterCat>
+	inline _FwdIt _Uninitialized_move_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _FwdIt _Dest, _IterCat)
+	{
+		_EXP_TRY
+			return _Uninitialized_move_seq(_First, _Last, _Dest);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _InIt, class _FwdIt, class _IterCat>
+	inline _FwdIt _Uninitialized_move_impl(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _FwdIt _Dest, _IterCat _Cat)
+	{
+		return _Uninitialized_move_n_impl(_Policy, _First, std::distance(_First, _Last), _Dest, _Cat).second;
+	}
+
+	template<class _ExPolicy, class _InIt, class _FwdIt>
+	inline typename _enable_if_parallel<_ExPolicy, _FwdIt>::type _Uninitialized_move_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _FwdIt _Dest, std::input_iterator_tag _Cat)
+	{
+		return _Uninitialized_move_impl(seq, _First, _Last, _Dest, _Cat);
+	}
+
+	template<class _InIt, class _FwdIt, class _IterCat>
+	inline _FwdIt _Uninitialized_move_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _FwdIt _Dest, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Uninitialized_move_impl, _Policy, _First, _Last, _Dest, _Cat);
+	}
+} // details
+
+// Moves the elements to uninitialized memory. The source elements are left moved from, when a move
+// constructor throws the objects constructed at _Dest are destroyed.
+template<class _ExPolicy, class _InIt, class _Diff, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_InIt, _FwdIt>>::type uninitialized_move_n(_ExPolicy&& _Policy, _InIt _First, _Diff _Count, _FwdIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_move_n");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	typename details::common_iterator<_InIt, _FwdIt>::iterator_category _Cat;
+	return details::_Uninitialized_move_n_impl(_Policy, _First, _Count, _Dest, _Cat);
+}
+
+template<class _ExPolicy, class _InIt, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type uninitialized_move(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _FwdIt _Dest)
+{
+	_EXP_TELEMETRY_ALGORITHM("uninitialized_move");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	typename details::common_iterator<_InIt, _FwdIt>::iterator_category _Cat;
+	return details::_Uninitialized_move_impl(_Policy, _First, _Last, _Dest, _Cat);
+}
+_PSTL_NS1_END// std::experimental::parallel
+
+#endif // _IMPL_UNINITIALIZED_MOVE_H_
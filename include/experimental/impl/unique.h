@@ -9,38 +9,42 @@ _PSTL_NS1_BEGIN
 namespace details {
 
 	template<class _PartitionerTag, class _ExPolicy, class _InIt, class _OutIt, class _Pr, class _Op>
-	inline _OutIt _Unique_copy_impl_helper(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred, _Op _Operation)
+	inline _OutIt _Unique_copy_impl_helper(const _ExPolicy& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred, _Op _Operation)
 	{
 		typedef std::iterator_traits<_InIt>::difference_type difference_type;
 		typedef typename std::decay<_ExPolicy>::type _ExecutionPolicy;
 		typedef _Output_token<_OutIt> _Output_token;
-		//typedef composable_iterator<_InIt, std::vector<difference_type>::iterator > _Iter_type;
-		typedef composable_iterator_base < typename common_iterator<_InIt, std::vector<difference_type>::iterator >::iterator_category,
-			_InIt, std::vector<difference_type>::iterator > _Iter_type;
+		typedef composable_iterator<_InIt, _Filter_mask_iterator> _Iter_type;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
 
 		if (_First == _Last)
 			return _Dest;
 
 		auto _Size = std::distance(_First, _Last);
-		std::vector<difference_type> _Filter(_Size);
+
+		// The chores filter from the second element of their range on, bit 0 stands for the second element
+		_Filter_mask _Filter(_Size - 1);
 
 		// First element is always unique
 		*_Dest = *_First;
 		++_Dest;
 
-		return _Partitioner<_PartitionerTag>::_For_Each(make_composable_iterator(_First, std::begin(_Filter)), _Size - 1, _Output_token(_Dest),
+		return _Partitioner<_PartitionerTag>::_For_Each(make_composable_iterator(_First, _Filter.begin(-1)), _Size - 1, _Output_token(_Dest),
 			[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
 			difference_type _Sum = 0;
 			_InIt _Unique = std::get<0>(*_Begin);
 
 			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
 				[&_Pred, &_Unique, &_Sum](_Iter_type::reference _It){
-				if (!_Pred(*_Unique, *std::get<0>(_It))) {
+				const bool _Keep = _Pred(*_Unique, *std::get<0>(_It)) ? false : true;
+				*std::get<1>(_It) = _Keep;
+				if (_Keep) {
 					_Unique = std::get<0>(_It);
-					*std::get<1>(_It) = _Sum;
 					++_Sum;
 				}
-				else *std::get<1>(_It) = _Output_token::EMPTY_POSITION;
 			});
 
 			_Output.set_position(_Sum);
@@ -52,12 +56,12 @@ namespace details {
 			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
 				[&_Out, &_Operation](_Iter_type::reference _It){
 
-				if (*std::get<1>(_It) != _Output_token::EMPTY_POSITION) {
+				if (*std::get<1>(_It)) {
 					*_Out = _Operation(std::get<0>(_It));
 					++_Out;
 				}
 			});
-		}).get_result();
+		}, _Filter_mask::chunk_size(_Size - 1)).get_result();
 	}
 
 	//
@@ -118,11 +122,276 @@ namespace details {
 	{
 		_EXP_GENERIC_EXECUTION_POLICY(_Unique_impl, _Policy, _First, _Last, _Pred, _Cat);
 	}
+
+	//
+	// run_length_encode
+	//
+	// The runs are the ones of unique_copy: the filtering stage marks the first element of every run in the chunk,
+	// the copy stage writes the value of each of them and the length of the run before it. The length of a run
+	// that starts in a chunk and ends in a later one isn't known to the chunk, so the token handed down the chain
+	// carries where the last run of the chunks before started and the copy stage of the next chunk with a run
+	// start writes its length. The runs and their lengths are written in the one pass of the pipeline, the length
+	// of the last run is written once the chain is done.
+	template<typename _OutIt, typename _CountIt, typename _DiffType>
+	class _Run_length_token
+	{
+		_OutIt _Values;
+		_CountIt _Counts;		// the length of the run open before the chunk
+		_DiffType _Runs;		// the runs that start in the chunk
+		size_t _Offset;			// of the first element of the chunk in the range
+		size_t _Size;
+		size_t _Run_start;		// of the run open before the chunk
+		size_t _Last_start;		// of the last run that starts in the chunk, from the chunk
+	public:
+		_Run_length_token(_OutIt _Val_it, _CountIt _Count_it) :
+			_Values(_Val_it), _Counts(_Count_it), _Runs(0), _Offset(1), _Size(0), _Run_start(0), _Last_start(0)
+		{
+		}
+
+		// Can be called only on one thread and set once
+		void set_position(_DiffType _Pos, size_t _Count, size_t _Last)
+		{
+			_Runs = _Pos;
+			_Size = _Count;
+			_Last_start = _Last;
+		}
+
+		_OutIt values() const
+		{
+			return _Values;
+		}
+
+		_CountIt counts() const
+		{
+			return _Counts;
+		}
+
+		size_t offset() const
+		{
+			return _Offset;
+		}
+
+		size_t run_start() const
+		{
+			return _Run_start;
+		}
+
+		// The end of the values and the length of the last run, which is still open at _Size
+		std::pair<_OutIt, _CountIt> get_result(size_t _Size_all) const
+		{
+			std::pair<_OutIt, _CountIt> _Result(_Values, _Counts);
+			std::advance(_Result.first, _Runs);
+			std::advance(_Result.second, _Runs);
+
+			*_Result.second = static_cast<typename std::iterator_traits<_CountIt>::value_type>(_Size_all - (_Runs != 0 ? _Offset + _Last_start : _Run_start));
+			++_Result.second;
+			return _Result;
+		}
+
+		void move(_Run_length_token& _Token)
+		{
+			_Values = _Token._Values;
+			std::advance(_Values, _Token._Runs);
+			_Counts = _Token._Counts;
+			std::advance(_Counts, _Token._Runs);
+
+			_Offset = _Token._Offset + _Token._Size;
+			_Run_start = _Token._Runs != 0 ? _Token._Offset + _Token._Last_start : _Token._Run_start;
+		}
+
+		bool empty() const
+		{
+			return _Runs == 0;
+		}
+	};
+
+	template<class _InIt, class _OutIt, class _CountIt, class _Pr, class _IterCat>
+	inline std::pair<_OutIt, _CountIt> _Run_length_encode_impl(const sequential_execution_policy&, _InIt _First, _InIt _Last, _OutIt _Values, _CountIt _Counts, _Pr _Pred, _IterCat)
+	{
+		typedef typename std::iterator_traits<_InIt>::value_type _Value_type;
+
+		_EXP_TRY
+			if (_First == _Last)
+				return std::pair<_OutIt, _CountIt>(_Values, _Counts);
+
+			// The input may be walked once only, the value of the open run is kept
+			_Value_type _Run_value = *_First;
+			typename std::iterator_traits<_InIt>::difference_type _Run = 1;
+			for (++_First; _First != _Last; ++_First)
+			{
+				if (_Pred(_Run_value, *_First)) {
+					++_Run;
+					continue;
+				}
+
+				*_Values = std::move(_Run_value);
+				++_Values;
+				*_Counts = _Run;
+				++_Counts;
+
+				_Run_value = *_First;
+				_Run = 1;
+			}
+
+			*_Values = std::move(_Run_value);
+			++_Values;
+			*_Counts = _Run;
+			++_Counts;
+			return std::pair<_OutIt, _CountIt>(_Values, _Counts);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _FwdIt, class _OutIt, class _CountIt, class _Pr, class _IterCat>
+	inline std::pair<_OutIt, _CountIt> _Run_length_encode_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _OutIt _Values, _CountIt _Counts, _Pr _Pred, _IterCat)
+	{
+		typedef typename std::iterator_traits<_FwdIt>::difference_type difference_type;
+		typedef typename std::iterator_traits<_CountIt>::value_type _Count_type;
+		typedef _Run_length_token<_OutIt, _CountIt, difference_type> _Output_token;
+		typedef composable_iterator<_FwdIt, _Filter_mask_iterator> _Iter_type;
+
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		if (_First == _Last)
+			return std::pair<_OutIt, _CountIt>(_Values, _Counts);
+
+		const size_t _Size = static_cast<size_t>(std::distance(_First, _Last));
+
+		// The chores filter from the second element of their range on, bit 0 stands for the second element
+		_Filter_mask _Filter(_Size - 1);
+
+		// First element always starts a run, its length is written by the first chunk with a run start
+		*_Values = *_First;
+		++_Values;
+
+		return _Partitioner<copy_partitioner_tag>::_For_Each(make_composable_iterator(_First, _Filter.begin(-1)), _Size - 1, _Output_token(_Values, _Counts),
+			[_Pred](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Output) mutable { // Filtering stage
+			difference_type _Sum = 0;
+			size_t _At = 0, _Last_start = 0;
+			_FwdIt _Prev = std::get<0>(*_Begin);
+
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
+				[&_Pred, &_Prev, &_Sum, &_At, &_Last_start](_Iter_type::reference _It){
+				const bool _Starts = _Pred(*_Prev, *std::get<0>(_It)) ? false : true;
+				*std::get<1>(_It) = _Starts;
+				if (_Starts) {
+					_Last_start = _At;
+					++_Sum;
+				}
+				_Prev = std::get<0>(_It);
+				++_At;
+			});
+
+			_Output.set_position(_Sum, _Partition_count, _Last_start);
+		},
+			[](_Iter_type _Begin, size_t _Partition_count, _Output_token& _Dest) { // Copy stage
+			auto _Out = _Dest.values();
+			auto _Out_count = _Dest.counts();
+			size_t _At = _Dest.offset(), _Run_start = _Dest.run_start();
+
+			// Every run start closes the run before it, which may have started in an earlier chunk
+			LoopHelper<_ExPolicy, _Iter_type>::Loop(++_Begin, _Partition_count,
+				[&_Out, &_Out_count, &_At, &_Run_start](_Iter_type::reference _It){
+
+				if (*std::get<1>(_It)) {
+					*_Out = *std::get<0>(_It);
+					++_Out;
+					*_Out_count = static_cast<_Count_type>(_At - _Run_start);
+					++_Out_count;
+					_Run_start = _At;
+				}
+				++_At;
+			});
+		}, _Filter_mask::chunk_size(_Size - 1)).get_result(_Size);
+	}
+
+	template<class _ExPolicy, class _InIt, class _OutIt, class _CountIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, std::pair<_OutIt, _CountIt>>::type _Run_length_encode_impl(const _ExPolicy&, _InIt _First, _InIt _Last, _OutIt _Values, _CountIt _Counts, _Pr _Pred, std::input_iterator_tag _Cat)
+	{
+		return _Run_length_encode_impl(seq, _First, _Last, _Values, _Counts, _Pred, _Cat);
+	}
+
+	template<class _InIt, class _OutIt, class _CountIt, class _Pr, class _IterCat>
+	inline std::pair<_OutIt, _CountIt> _Run_length_encode_impl(const execution_policy& _Policy, _InIt _First, _InIt _Last, _OutIt _Values, _CountIt _Counts, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Run_length_encode_impl, _Policy, _First, _Last, _Values, _Counts, _Pred, _Cat);
+	}
+
+	//
+	// unique_count
+	//
+	// The elements that end a run, every element that isn't equal to the one after it, counted in chunks.
+	template<class _FwdIt, class _Pr>
+	inline size_t _Count_run_ends(_FwdIt _Begin, size_t _Count, _Pr& _Pred)
+	{
+		size_t _Ends = 0;
+		for (_FwdIt _Next = _Begin; _Count != 0; --_Count, _Begin = _Next)
+		{
+			if (!_Pred(*_Begin, *++_Next))
+				++_Ends;
+		}
+		return _Ends;
+	}
+
+	template<class _FwdIt, class _Pr, class _IterCat>
+	inline size_t _Unique_count_impl(const sequential_execution_policy&, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	{
+		_EXP_TRY
+			if (_First == _Last)
+				return 0;
+			return 1 + _Count_run_ends(_First, static_cast<size_t>(std::distance(_First, _Last)) - 1, _Pred);
+		_EXP_RETHROW
+	}
+
+	template<class _ExPolicy, class _FwdIt, class _Pr, class _IterCat>
+	inline size_t _Unique_count_impl(const _ExPolicy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat)
+	{
+		_Scratch_scope _Scope(_Policy);
+		_Arena_scope _In_arena(_Policy_arena(_Policy));
+		_Priority_scope _At_priority(_Policy);
+
+		const size_t _Size = static_cast<size_t>(std::distance(_First, _Last));
+		if (_Size <= 1)
+			return _Size;
+
+		combinable<size_t> _Combine;
+		_Partitioned_for_each(_Policy, _First, _Size - 1, _Pred,
+			[&_Combine](_FwdIt _Begin, size_t _Count, _Pr& _UserPred) {
+			_Combine.local() += _Count_run_ends(_Begin, _Count, _UserPred);
+		});
+
+		return 1 + _Combine.combine(std::plus<size_t>());
+	}
+
+	// Random access ranges count into one slot per chunk
+	template<class _ExPolicy, class _RanIt, class _Pr>
+	inline typename _enable_if_parallel<_ExPolicy, size_t>::type _Unique_count_impl(const _ExPolicy& _Policy, _RanIt _First, _RanIt _Last, _Pr _Pred, std::random_access_iterator_tag)
+	{
+		const size_t _Size = static_cast<size_t>(_Last - _First);
+		if (_Size <= 1)
+			return _Size;
+
+		return 1 + _Chunked_reduce<size_t>(_Policy, _First, _Size - 1, _Pred,
+			[](_RanIt _Begin, size_t _Count, _Pr& _UserPred) {
+			return _Count_run_ends(_Begin, _Count, _UserPred);
+		},
+			[](size_t _Left, size_t _Right, _Pr&) {
+			return _Left + _Right;
+		});
+	}
+
+	template<class _FwdIt, class _Pr, class _IterCat>
+	inline size_t _Unique_count_impl(const execution_policy& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred, _IterCat _Cat)
+	{
+		_EXP_GENERIC_EXECUTION_POLICY(_Unique_count_impl, _Policy, _First, _Last, _Pred, _Cat);
+	}
 } // details
 
 template<class _ExPolicy, class _FwdIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type unique(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("unique");
 	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
 
 	return details::_Unique_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
@@ -131,12 +400,14 @@ inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type unique(_ExPo
 template<class _ExPolicy, class _FwdIt>
 inline typename details::_enable_if_policy<_ExPolicy, _FwdIt>::type unique(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
 {
+	_EXP_TELEMETRY_ALGORITHM("unique");
 	return unique(_Policy, _First, _Last, std::equal_to<>());
 }
 
 template<class _ExPolicy, class _InIt, class _OutIt, class _Pr>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type unique_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest, _Pr _Pred)
 {
+	_EXP_TELEMETRY_ALGORITHM("unique_copy");
 	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
 	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
 
@@ -147,8 +418,56 @@ inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type unique_copy(
 template<class _ExPolicy, class _InIt, class _OutIt>
 inline typename details::_enable_if_policy<_ExPolicy, _OutIt>::type unique_copy(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Dest)
 {
+	_EXP_TELEMETRY_ALGORITHM("unique_copy");
 	return unique_copy(_Policy, _First, _Last, _Dest, std::equal_to<>());
 }
+/// <summary>
+///     Writes the value of the first element of every run of equal consecutive elements of the range to the range
+///     at _Values and the length of the run to the range at _Counts, and returns the ends of both. The values are
+///     the ones unique_copy writes.
+/// </summary>
+/// <remarks>
+///     Both ranges are written in the one pass of the parallel unique_copy, a run that spans chunks is closed by
+///     the chunk its next run starts in. _Pred compares neighbouring elements and must be an equivalence.
+/// </remarks>
+template<class _ExPolicy, class _InIt, class _OutIt, class _CountIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _CountIt>>::type run_length_encode(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Values, _CountIt _Counts, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("run_length_encode");
+	static_assert(std::is_base_of<std::input_iterator_tag, typename std::iterator_traits<_InIt>::iterator_category>::value, "Required input iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_OutIt>::iterator_category>::value, "Required output iterator or stronger.");
+	static_assert(std::is_base_of<std::_Mutable_iterator_tag, typename std::iterator_traits<_CountIt>::iterator_category>::value, "Required output iterator or stronger.");
+
+	details::common_iterator<_InIt, _OutIt, _CountIt>::iterator_category _Cat;
+	return details::_Run_length_encode_impl(_Policy, _First, _Last, _Values, _Counts, _Pred, _Cat);
+}
+
+template<class _ExPolicy, class _InIt, class _OutIt, class _CountIt>
+inline typename details::_enable_if_policy<_ExPolicy, std::pair<_OutIt, _CountIt>>::type run_length_encode(_ExPolicy&& _Policy, _InIt _First, _InIt _Last, _OutIt _Values, _CountIt _Counts)
+{
+	_EXP_TELEMETRY_ALGORITHM("run_length_encode");
+	return run_length_encode(_Policy, _First, _Last, _Values, _Counts, std::equal_to<>());
+}
+
+/// <summary>
+///     Returns the number of runs of equal consecutive elements of the range, the number of elements unique_copy
+///     writes. The output of run_length_encode can be sized by it.
+/// </summary>
+template<class _ExPolicy, class _FwdIt, class _Pr>
+inline typename details::_enable_if_policy<_ExPolicy, size_t>::type unique_count(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last, _Pr _Pred)
+{
+	_EXP_TELEMETRY_ALGORITHM("unique_count");
+	static_assert(std::is_base_of<std::forward_iterator_tag, typename std::iterator_traits<_FwdIt>::iterator_category>::value, "Required forward iterator or stronger.");
+
+	return details::_Unique_count_impl(_Policy, _First, _Last, _Pred, std::_Iter_cat(_First));
+}
+
+template<class _ExPolicy, class _FwdIt>
+inline typename details::_enable_if_policy<_ExPolicy, size_t>::type unique_count(_ExPolicy&& _Policy, _FwdIt _First, _FwdIt _Last)
+{
+	_EXP_TELEMETRY_ALGORITHM("unique_count");
+	return unique_count(_Policy, _First, _Last, std::equal_to<>());
+}
 _PSTL_NS1_END // std::experimental::parallel
 
 #endif // _IMPL_UNIQUE_H_
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <atomic>
+#include <cstring>
+#include <malloc.h>
+#include <Windows.h>
 #include <experimental/impl/algorithm_impl.h>
 
 _PSTL_NS1_BEGIN
@@ -10,14 +13,526 @@ namespace details {
 	{
 		__declspec(thread) _Contextaware_waitable_chore * _Thread_chore_context;
 
-		// We need to limit the global over-subscription to linear size.
-		// Please note that *5 is just an arbitrary choice that fits in
-		// a reasonable range. As long as total number don't go exponential
-		// a little bit more linear over-subscription won't hurt.
-		size_t _Max_global_chore_num = get_hardware_concurrency() * 5;
-		atomic<size_t> _Global_chore_num;
+		// Keys start at 1, a zeroed cache entry matches no combinable
+		atomic<size_t> _Combinable_key_counter;
+		__declspec(thread) _Combinable_cache_entry _Thread_combinable_cache_entries[_Combinable_cache_ways];
+
+		// The partition count is sharded, threads issuing algorithms concurrently update
+		// different cache lines. Only nested loops read the total.
+		const unsigned int _Chore_num_shard_count = 64;
+
+		struct _Chore_num_shard
+		{
+			atomic<size_t> _Count;
+			char _Padding[64 - sizeof(atomic<size_t>)];
+		};
+
+		_Chore_num_shard _Global_chore_num[_Chore_num_shard_count];
+		atomic<unsigned int> _Next_chore_num_shard;
+		__declspec(thread) unsigned int _Thread_chore_num_shard; // 1 based, 0 is unassigned
+
+		atomic<size_t> &_Current_chore_num_shard()
+		{
+			if (_Thread_chore_num_shard == 0)
+				_Thread_chore_num_shard = _Next_chore_num_shard.fetch_add(1, std::memory_order_relaxed) % _Chore_num_shard_count + 1;
+			return _Global_chore_num[_Thread_chore_num_shard - 1]._Count;
+		}
+
+		// Per thread storage of the partitions' chores. Algorithm calls nest on a thread, so the
+		// blocks are handed out like a stack and the arena is rewound once the last one returns.
+		// Requests that don't fit go to the heap and size the arena for the next round.
+		struct _Chore_arena
+		{
+			char *_Base;
+			size_t _Size;
+			size_t _Top;
+			size_t _Live;
+			size_t _Wanted;
+		};
+
+		const size_t _Chore_alignment = 64;
+		const size_t _Chore_arena_initial_size = 16 * 1024;
+		const size_t _Chore_arena_maximal_size = 1024 * 1024;
+
+		__declspec(thread) _Chore_arena * _Thread_chore_arena;
+
+		void WINAPI _Release_chore_arena(PVOID _Data)
+		{
+			auto _Arena = static_cast<_Chore_arena *>(_Data);
+			if (_Arena != nullptr)
+			{
+				_aligned_free(_Arena->_Base);
+				delete _Arena;
+			}
+		}
+
+		// frees the arena of a thread when it exits
+		const DWORD _Chore_arena_slot = ::FlsAlloc(_Release_chore_arena);
+
+		_Chore_arena *_Current_chore_arena()
+		{
+			auto _Arena = _Thread_chore_arena;
+			if (_Arena != nullptr || _Chore_arena_slot == FLS_OUT_OF_INDEXES)
+				return _Arena;
+
+			_Arena = new (std::nothrow) _Chore_arena();
+			if (_Arena == nullptr)
+				return nullptr;
+
+			_Arena->_Base = static_cast<char *>(_aligned_malloc(_Chore_arena_initial_size, _Chore_alignment));
+			_Arena->_Size = _Arena->_Base != nullptr ? _Chore_arena_initial_size : 0;
+			_Arena->_Top = _Arena->_Live = _Arena->_Wanted = 0;
+
+			::FlsSetValue(_Chore_arena_slot, _Arena);
+			_Thread_chore_arena = _Arena;
+			return _Arena;
+		}
+
+		size_t _Align_chore_size(size_t _Size)
+		{
+			return (_Size + _Chore_alignment - 1) & ~(_Chore_alignment - 1);
+		}
+
+		// Call sites sampled by the adaptive partitioner, pushed on the front and never removed
+		atomic<_Cutoff_site *> _Cutoff_sites;
+
+		atomic<int> _Imbalance_mode;
+		const unsigned int _Imbalance_advice_calls = 2; // calls profiled before a site gets an advice
+		const unsigned long long _Uniform_spread_permille = 1250; // per element costs within 25% of each other
+		const unsigned long long _Irregular_spread_permille = 2000;
+
+		// The partitioner for the per element costs the profile of a site spreads over, with a grain of
+		// 10us of work per chunk. A call of a uniform cost is best cut in equal chunks once, a moderate
+		// spread is absorbed by the chunks of decreasing size, and the chunks that cost several times
+		// more than the others are split while they run.
+		partitioner_kind _Imbalance_advice(const _Cutoff_site &_Site, unsigned int _Calls, size_t &_Grain)
+		{
+			const unsigned long long _Elements = _Site._Elements.load(std::memory_order_relaxed);
+			_Grain = _Cutoff_grain(_Site._Chunk_ps.load(std::memory_order_relaxed) / (std::max)(_Elements, 1ull));
+
+			const unsigned long long _Spread = _Site._Spread_permille.load(std::memory_order_relaxed) / _Calls;
+			if (_Spread <= _Uniform_spread_permille)
+				return partitioner_kind::static_;
+			return _Spread <= _Irregular_spread_permille ? partitioner_kind::auto_ : partitioner_kind::dynamic_;
+		}
+
+		double _Query_ps_per_tick()
+		{
+			LARGE_INTEGER _Frequency;
+			::QueryPerformanceFrequency(&_Frequency);
+			return 1e12 / static_cast<double>(_Frequency.QuadPart);
+		}
+
+		const double _Ps_per_tick = _Query_ps_per_tick();
+
+		// Over-aligned requests go to the aligned heap, operator new only guarantees the fundamental alignment
+		class _New_delete_resource : public memory_resource
+		{
+		protected:
+			virtual void *do_allocate(size_t _Bytes, size_t _Alignment) override
+			{
+				if (_Alignment <= _Max_align)
+					return ::operator new(_Bytes);
+
+				void *_Ptr = _aligned_malloc(_Bytes, _Alignment);
+				if (_Ptr == nullptr)
+					throw std::bad_alloc();
+				return _Ptr;
+			}
+
+			virtual void do_deallocate(void *_Ptr, size_t, size_t _Alignment) override
+			{
+				if (_Alignment <= _Max_align)
+					::operator delete(_Ptr);
+				else
+					_aligned_free(_Ptr);
+			}
+
+			virtual bool do_is_equal(const memory_resource& _Other) const _NOEXCEPT override
+			{
+				return dynamic_cast<const _New_delete_resource *>(&_Other) != nullptr;
+			}
+		};
+
+		_New_delete_resource _New_delete;
+		__declspec(thread) memory_resource * _Thread_scratch;
+
+		// Per thread cache of the large blocks of the default scratch resource. Batches of calls on similar
+		// sizes take their buffers and masks from it, and the pages of the blocks are already mapped. A block
+		// released on a thread goes to the cache of that thread. The retained bytes are trimmed to the most
+		// the thread had in use over the last _Scratch_cache_trim_period calls, a spike is not kept for long.
+		const size_t _Scratch_cache_min_block = 64 * 1024;
+		const size_t _Scratch_cache_alignment = 64;
+		const size_t _Scratch_cache_header = 64; // the size of the block is kept ahead of its storage
+		const size_t _Scratch_cache_ways = 16;
+		const unsigned int _Scratch_cache_trim_period = 16;
+
+		struct _Scratch_cache
+		{
+			char *_Blocks[_Scratch_cache_ways]; // oldest first
+			size_t _Count;
+			size_t _Retained;
+			size_t _In_use;
+			size_t _High_water;
+			unsigned int _Idle_points; // times the bytes in use went back to 0
+		};
+
+		atomic<size_t> _Scratch_cache_limit(256 * 1024 * 1024);
+		__declspec(thread) _Scratch_cache * _Thread_scratch_cache;
+
+		size_t &_Scratch_block_size(char *_Block)
+		{
+			return *reinterpret_cast<size_t *>(_Block);
+		}
+
+		void _Release_oldest_scratch_block(_Scratch_cache *_Cache)
+		{
+			char *_Block = _Cache->_Blocks[0];
+			_Cache->_Retained -= _Scratch_block_size(_Block);
+			std::copy(_Cache->_Blocks + 1, _Cache->_Blocks + _Cache->_Count, _Cache->_Blocks);
+			--_Cache->_Count;
+			_aligned_free(_Block);
+		}
+
+		void _Trim_scratch_cache(_Scratch_cache *_Cache, size_t _Keep)
+		{
+			while (_Cache->_Count != 0 && _Cache->_Retained > _Keep)
+				_Release_oldest_scratch_block(_Cache);
+		}
+
+		void WINAPI _Release_scratch_cache(PVOID _Data)
+		{
+			auto _Cache = static_cast<_Scratch_cache *>(_Data);
+			if (_Cache != nullptr)
+			{
+				_Trim_scratch_cache(_Cache, 0);
+				delete _Cache;
+			}
+		}
+
+		// frees the cache of a thread when it exits
+		const DWORD _Scratch_cache_slot = ::FlsAlloc(_Release_scratch_cache);
+
+		_Scratch_cache *_Current_scratch_cache()
+		{
+			auto _Cache = _Thread_scratch_cache;
+			if (_Cache != nullptr || _Scratch_cache_slot == FLS_OUT_OF_INDEXES)
+				return _Cache;
+
+			_Cache = new (std::nothrow) _Scratch_cache();
+			if (_Cache == nullptr)
+				return nullptr;
+
+			::FlsSetValue(_Scratch_cache_slot, _Cache);
+			_Thread_scratch_cache = _Cache;
+			return _Cache;
+		}
+
+		void *_Allocate_cached_scratch(size_t _Bytes)
+		{
+			auto _Cache = _Current_scratch_cache();
+			if (_Cache != nullptr)
+			{
+				// The smallest block that fits, and wastes less than half of it
+				size_t _Best = _Cache->_Count;
+				for (size_t _I = 0; _I < _Cache->_Count; ++_I)
+				{
+					const size_t _Size = _Scratch_block_size(_Cache->_Blocks[_I]);
+					if (_Size >= _Bytes && _Size / 2 <= _Bytes && (_Best == _Cache->_Count || _Size < _Scratch_block_size(_Cache->_Blocks[_Best])))
+						_Best = _I;
+				}
+
+				char *_Block = nullptr;
+				if (_Best != _Cache->_Count)
+				{
+					_Block = _Cache->_Blocks[_Best];
+					_Cache->_Retained -= _Scratch_block_size(_Block);
+					std::copy(_Cache->_Blocks + _Best + 1, _Cache->_Blocks + _Cache->_Count, _Cache->_Blocks + _Best);
+					--_Cache->_Count;
+				}
+				else
+				{
+					_Block = static_cast<char *>(_aligned_malloc(_Scratch_cache_header + _Bytes, _Scratch_cache_alignment));
+					if (_Block == nullptr)
+					{
+						// the blocks kept may be what is missing
+						_Trim_scratch_cache(_Cache, 0);
+						_Block = static_cast<char *>(_aligned_malloc(_Scratch_cache_header + _Bytes, _Scratch_cache_alignment));
+						if (_Block == nullptr)
+							throw std::bad_alloc();
+					}
+					_Scratch_block_size(_Block) = _Bytes;
+				}
+
+				_Cache->_In_use += _Scratch_block_size(_Block);
+				_Cache->_High_water = (std::max)(_Cache->_High_water, _Cache->_In_use);
+				return _Block + _Scratch_cache_header;
+			}
+
+			char *_Block = static_cast<char *>(_aligned_malloc(_Scratch_cache_header + _Bytes, _Scratch_cache_alignment));
+			if (_Block == nullptr)
+				throw std::bad_alloc();
+			_Scratch_block_size(_Block) = _Bytes;
+			return _Block + _Scratch_cache_header;
+		}
+
+		void _Deallocate_cached_scratch(void *_Ptr)
+		{
+			char *_Block = static_cast<char *>(_Ptr) - _Scratch_cache_header;
+			const size_t _Size = _Scratch_block_size(_Block);
+
+			auto _Cache = _Current_scratch_cache();
+			if (_Cache == nullptr)
+			{
+				_aligned_free(_Block);
+				return;
+			}
+
+			// the block may have been allocated on another thread
+			_Cache->_In_use -= (std::min)(_Cache->_In_use, _Size);
+
+			const size_t _Limit = _Scratch_cache_limit.load(std::memory_order_relaxed);
+
+			if (_Size > _Limit)
+			{
+				_aligned_free(_Block);
+			}
+			else
+			{
+				// the oldest blocks make room
+				while (_Cache->_Count == _Scratch_cache_ways || _Cache->_Retained + _Size > _Limit)
+					_Release_oldest_scratch_block(_Cache);
+
+				_Cache->_Blocks[_Cache->_Count++] = _Block;
+				_Cache->_Retained += _Size;
+			}
+
+			if (_Cache->_In_use == 0 && ++_Cache->_Idle_points == _Scratch_cache_trim_period)
+			{
+				_Trim_scratch_cache(_Cache, _Cache->_High_water);
+				_Cache->_High_water = 0;
+				_Cache->_Idle_points = 0;
+			}
+		}
+
+		// The default scratch resource: the large blocks that don't ask for more than the cache alignment
+		// go through the cache of the thread, the others to operator new
+		class _Scratch_cache_resource : public memory_resource
+		{
+			static bool _Is_cached(size_t _Bytes, size_t _Alignment)
+			{
+				return _Bytes >= _Scratch_cache_min_block && _Alignment <= _Scratch_cache_alignment;
+			}
+
+		protected:
+			virtual void *do_allocate(size_t _Bytes, size_t _Alignment) override
+			{
+				if (_Is_cached(_Bytes, _Alignment))
+					return _Allocate_cached_scratch(_Bytes);
+				return _New_delete.allocate(_Bytes, _Alignment);
+			}
+
+			virtual void do_deallocate(void *_Ptr, size_t _Bytes, size_t _Alignment) override
+			{
+				if (_Is_cached(_Bytes, _Alignment))
+					_Deallocate_cached_scratch(_Ptr);
+				else
+					_New_delete.deallocate(_Ptr, _Bytes, _Alignment);
+			}
+
+			virtual bool do_is_equal(const memory_resource& _Other) const _NOEXCEPT override
+			{
+				return dynamic_cast<const _Scratch_cache_resource *>(&_Other) != nullptr;
+			}
+		};
+
+		_Scratch_cache_resource _Scratch_cache_default;
+	}
+
+	_EXP_IMPL memory_resource * __cdecl _Default_scratch_resource() _NOEXCEPT
+	{
+		return &_Scratch_cache_default;
+	}
+
+	_EXP_IMPL memory_resource * __cdecl _Thread_scratch_resource() _NOEXCEPT
+	{
+		return _Thread_scratch;
+	}
+
+	_EXP_IMPL memory_resource * __cdecl _Exchange_thread_scratch_resource(memory_resource *_Resource) _NOEXCEPT
+	{
+		memory_resource *_Previous = _Thread_scratch;
+		_Thread_scratch = _Resource;
+		return _Previous;
+	}
+
+	// Only differences are used, a double keeps them within tens of picoseconds for days of uptime
+	_EXP_IMPL unsigned long long __cdecl _Cutoff_clock_ps()
+	{
+		LARGE_INTEGER _Counter;
+		::QueryPerformanceCounter(&_Counter);
+		return static_cast<unsigned long long>(static_cast<double>(_Counter.QuadPart) * _Ps_per_tick);
+	}
+
+	_EXP_IMPL void __cdecl _Register_cutoff_site(_Cutoff_site *_Site, const char *_Name)
+	{
+		_Site->_Name = _Name;
+		_Site->_Next = _Cutoff_sites.load(std::memory_order_relaxed);
+		while (!_Cutoff_sites.compare_exchange_weak(_Site->_Next, _Site, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	_EXP_IMPL size_t __cdecl get_cutoff_sites(cutoff_site_info *_Sites, size_t _Capacity)
+	{
+		size_t _Num = 0;
+		for (auto _Site = _Cutoff_sites.load(std::memory_order_acquire); _Site != nullptr; _Site = _Site->_Next, ++_Num)
+		{
+			if (_Num >= _Capacity)
+				continue;
+
+			const unsigned long long _Ps = _Site->_Ps_per_element.load(std::memory_order_relaxed);
+			cutoff_site_info &_Info = _Sites[_Num];
+			_Info.name = _Site->_Name;
+			_Info.samples = (std::min)(_Site->_Samples.load(std::memory_order_relaxed), _Cutoff_sample_runs);
+			_Info.ns_per_element = _Ps / 1000.0;
+			_Info.sequential_cutoff = _Cutoff_sequential_limit(_Ps);
+			_Info.grain = _Cutoff_grain(_Ps);
+		}
+		return _Num;
+	}
+
+	_EXP_IMPL void __cdecl _Record_imbalance(_Cutoff_site& _Site, const char *_Name, const _Chunk_timings& _Timings, size_t _Count)
+	{
+		const size_t _Chunks = _Timings._Chunks.load(std::memory_order_relaxed);
+		if (_Chunks == 0)
+			return;
+
+		if (!_Site._Registered.exchange(true))
+			_Register_cutoff_site(&_Site, _Name);
+
+		// a call with a single chunk long enough to time, or none, has no spread
+		const unsigned long long _Ps = _Timings._Ps.load(std::memory_order_relaxed);
+		const unsigned long long _Min_per_element = _Timings._Min_ps_per_element.load(std::memory_order_relaxed);
+		const unsigned long long _Max_per_element = _Timings._Max_ps_per_element.load(std::memory_order_relaxed);
+		const unsigned long long _Tail = _Timings._Max_ps.load(std::memory_order_relaxed) * 1000 / (std::max)(_Ps / _Chunks, 1ull);
+		const unsigned long long _Spread = _Max_per_element > _Min_per_element ? _Max_per_element * 1000 / (std::max)(_Min_per_element, 1ull) : 1000;
+
+		// concurrent calls of a site may mix their sums for a moment, the advice stays close enough
+		if (_Site._Last_count.exchange(_Count, std::memory_order_relaxed) == _Count)
+			_Site._Same_size_calls.fetch_add(1, std::memory_order_relaxed);
+		_Site._Chunks.fetch_add(_Chunks, std::memory_order_relaxed);
+		_Site._Elements.fetch_add(_Timings._Elements.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		_Site._Chunk_ps.fetch_add(_Ps, std::memory_order_relaxed);
+		_Site._Tail_permille.fetch_add(_Tail, std::memory_order_relaxed);
+		_Site._Spread_permille.fetch_add(_Spread, std::memory_order_relaxed);
+		const unsigned int _Calls = _Site._Profiled_calls.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		if (_Calls >= _Imbalance_advice_calls)
+		{
+			size_t _Grain;
+			const partitioner_kind _Kind = _Imbalance_advice(_Site, _Calls, _Grain);
+			_Site._Advice_grain.store(_Grain, std::memory_order_relaxed);
+			_Site._Advice.store(static_cast<unsigned int>(_Kind) + 1, std::memory_order_relaxed);
+		}
+	}
+
+	_EXP_IMPL size_t __cdecl _Next_combinable_key()
+	{
+		return _Combinable_key_counter.fetch_add(1, std::memory_order_relaxed) + 1;
+	}
+
+	_EXP_IMPL _Combinable_cache_entry * __cdecl _Thread_combinable_cache()
+	{
+		return _Thread_combinable_cache_entries;
+	}
+
+	_EXP_IMPL void * __cdecl _Allocate_chore_storage(size_t _Size)
+	{
+		_Size = _Align_chore_size(_Size);
+
+		auto _Arena = _Current_chore_arena();
+		if (_Arena != nullptr)
+		{
+			if (_Arena->_Size - _Arena->_Top >= _Size)
+			{
+				void *_Ptr = _Arena->_Base + _Arena->_Top;
+				_Arena->_Top += _Size;
+				++_Arena->_Live;
+				return _Ptr;
+			}
+
+			_Arena->_Wanted = (std::max)(_Arena->_Wanted, _Arena->_Top + _Size);
+		}
+
+		void *_Ptr = _aligned_malloc(_Size, _Chore_alignment);
+		if (_Ptr == nullptr)
+			throw std::bad_alloc();
+		return _Ptr;
+	}
+
+	_EXP_IMPL void __cdecl _Free_chore_storage(void *_Ptr, size_t _Size)
+	{
+		auto _Arena = _Thread_chore_arena;
+		auto _Block = static_cast<char *>(_Ptr);
+		if (_Arena == nullptr || _Block < _Arena->_Base || _Block >= _Arena->_Base + _Arena->_Size)
+		{
+			_aligned_free(_Ptr);
+			return;
+		}
+
+		_Size = _Align_chore_size(_Size);
+		if (_Block + _Size == _Arena->_Base + _Arena->_Top)
+			_Arena->_Top -= _Size;
+
+		if (--_Arena->_Live != 0)
+			return;
+
+		_Arena->_Top = 0;
+		if (_Arena->_Wanted > _Arena->_Size && _Arena->_Size < _Chore_arena_maximal_size)
+		{
+			size_t _New_size = (std::max)(_Arena->_Size, _Chore_arena_initial_size);
+			while (_New_size < _Arena->_Wanted && _New_size < _Chore_arena_maximal_size)
+				_New_size *= 2;
+
+			if (auto _New_base = static_cast<char *>(_aligned_malloc(_New_size, _Chore_alignment)))
+			{
+				_aligned_free(_Arena->_Base);
+				_Arena->_Base = _New_base;
+				_Arena->_Size = _New_size;
+			}
+		}
+		_Arena->_Wanted = 0;
+	}
+
+
+	void __cdecl _Prewarm_thread_storage()
+	{
+		// the pages of an unused chore arena are mapped ahead of the first partitions
+		auto _Arena = _Current_chore_arena();
+		if (_Arena != nullptr && _Arena->_Live == 0 && _Arena->_Size != 0)
+			std::memset(_Arena->_Base, 0, _Arena->_Size);
+		_Current_scratch_cache();
 	}
 
+	void __cdecl _Release_thread_storage()
+	{
+		auto _Arena = _Thread_chore_arena;
+		if (_Arena != nullptr && _Arena->_Live == 0)
+		{
+			_Thread_chore_arena = nullptr;
+			::FlsSetValue(_Chore_arena_slot, nullptr);
+			_Release_chore_arena(_Arena);
+		}
+
+		auto _Cache = _Thread_scratch_cache;
+		if (_Cache != nullptr && _Cache->_In_use == 0)
+		{
+			_Thread_scratch_cache = nullptr;
+			::FlsSetValue(_Scratch_cache_slot, nullptr);
+			_Release_scratch_cache(_Cache);
+		}
+	}
 
 	_EXP_IMPL void _Contextaware_waitable_chore::_Set_current_chore(_Contextaware_waitable_chore * _Context)
 	{
@@ -32,20 +547,131 @@ namespace details {
 
 	_EXP_IMPL bool _Partition_status_tracker::_IsPartitionNumUnderLimit()
 	{
-		return _Global_chore_num.load(std::memory_order_relaxed) < _Max_global_chore_num;
+		size_t _Total = 0;
+		for (auto &_Shard : _Global_chore_num)
+			_Total += _Shard._Count.load(std::memory_order_relaxed);
+
+		// We need to limit the global over-subscription to linear size.
+		// Nested loops always split while there are fewer partitions than twice the
+		// hardware concurrency, past that only as long as there are idle workers to run
+		// the new partitions. The hard cap keeps the total linear in any case. The
+		// concurrency is read each time, it follows set_concurrency_limit.
+		const size_t _Concurrency = get_hardware_concurrency();
+		if (_Total < _Concurrency * 2)
+			return true;
+		if (_Total < _Concurrency * 32 && idleWorkerCount() != 0)
+			return true;
 
+		_EXP_TELEMETRY_ONLY(_Telemetry_inline_fallback());
+		return false;
 	}
 
 	_EXP_IMPL void _Partition_status_tracker::_AddPartitions(size_t _Num)
 	{
 		_PartitionNum += _Num;
-		_Global_chore_num.fetch_add(_Num, std::memory_order_relaxed);
+		_Current_chore_num_shard().fetch_add(_Num, std::memory_order_relaxed);
 	}
 
+	// The shards only add up correctly: a tracker is released on the thread that created it
 	_EXP_IMPL _Partition_status_tracker::~_Partition_status_tracker()
 	{
 		if (_PartitionNum)
-			_Global_chore_num.fetch_sub(_PartitionNum, std::memory_order_relaxed);
+			_Current_chore_num_shard().fetch_sub(_PartitionNum, std::memory_order_relaxed);
+	}
+}
+
+_EXP_IMPL memory_resource * __cdecl new_delete_resource() _NOEXCEPT
+{
+	return &details::_New_delete;
+}
+
+_EXP_IMPL size_t __cdecl set_scratch_cache_limit(size_t _Bytes) _NOEXCEPT
+{
+	const size_t _Previous = details::_Scratch_cache_limit.exchange(_Bytes, std::memory_order_relaxed);
+	if (details::_Thread_scratch_cache != nullptr)
+		details::_Trim_scratch_cache(details::_Thread_scratch_cache, _Bytes);
+	return _Previous;
+}
+
+_EXP_IMPL size_t __cdecl scratch_cache_limit() _NOEXCEPT
+{
+	return details::_Scratch_cache_limit.load(std::memory_order_relaxed);
+}
+
+_EXP_IMPL size_t __cdecl scratch_cache_retained_bytes() _NOEXCEPT
+{
+	return details::_Thread_scratch_cache != nullptr ? details::_Thread_scratch_cache->_Retained : 0;
+}
+
+_EXP_IMPL void __cdecl trim_scratch_cache() _NOEXCEPT
+{
+	if (details::_Thread_scratch_cache != nullptr)
+		details::_Trim_scratch_cache(details::_Thread_scratch_cache, 0);
+}
+
+_EXP_IMPL imbalance_profiling __cdecl set_imbalance_profiling(imbalance_profiling _Mode) _NOEXCEPT
+{
+#if _EXP_TELEMETRY
+	return static_cast<imbalance_profiling>(details::_Imbalance_mode.exchange(static_cast<int>(_Mode)));
+#else
+	(void)_Mode;
+	return imbalance_profiling::off;
+#endif
+}
+
+_EXP_IMPL imbalance_profiling __cdecl imbalance_profiling_mode() _NOEXCEPT
+{
+	return static_cast<imbalance_profiling>(details::_Imbalance_mode.load(std::memory_order_relaxed));
+}
+
+_EXP_IMPL size_t __cdecl get_imbalance_profiles(imbalance_profile_info *_Sites, size_t _Capacity) _NOEXCEPT
+{
+	size_t _Num = 0;
+	for (auto _Site = details::_Cutoff_sites.load(std::memory_order_acquire); _Site != nullptr; _Site = _Site->_Next)
+	{
+		const unsigned int _Calls = _Site->_Profiled_calls.load(std::memory_order_relaxed);
+		if (_Calls == 0)
+			continue;
+
+		if (_Num < _Capacity)
+		{
+			const double _Chunks = static_cast<double>((std::max)(_Site->_Chunks.load(std::memory_order_relaxed), 1ull));
+			const double _Ns = _Site->_Chunk_ps.load(std::memory_order_relaxed) / 1000.0;
+
+			imbalance_profile_info &_Info = _Sites[_Num];
+			_Info.name = _Site->_Name;
+			_Info.calls = _Calls;
+			_Info.chunks_per_call = _Chunks / _Calls;
+			_Info.mean_chunk_ns = _Ns / _Chunks;
+			_Info.tail_ratio = _Site->_Tail_permille.load(std::memory_order_relaxed) / 1000.0 / _Calls;
+			_Info.cost_spread = _Site->_Spread_permille.load(std::memory_order_relaxed) / 1000.0 / _Calls;
+			_Info.ns_per_element = _Ns / static_cast<double>((std::max)(_Site->_Elements.load(std::memory_order_relaxed), 1ull));
+			_Info.partitioner = partitioner_kind::default_;
+			_Info.grain = 0;
+			if (_Calls >= details::_Imbalance_advice_calls)
+				_Info.partitioner = details::_Imbalance_advice(*_Site, _Calls, _Info.grain);
+
+			// replaying the workers of the last call pays when the calls repeat and little is left to balance
+			_Info.replay_affinity = _Info.partitioner == partitioner_kind::static_ && _Site->_Same_size_calls.load(std::memory_order_relaxed) * 2 >= _Calls;
+		}
+		++_Num;
+	}
+	return _Num;
+}
+
+_EXP_IMPL void __cdecl reset_imbalance_profiles() _NOEXCEPT
+{
+	for (auto _Site = details::_Cutoff_sites.load(std::memory_order_acquire); _Site != nullptr; _Site = _Site->_Next)
+	{
+		_Site->_Advice.store(0, std::memory_order_relaxed);
+		_Site->_Profiled_calls.store(0, std::memory_order_relaxed);
+		_Site->_Same_size_calls.store(0, std::memory_order_relaxed);
+		_Site->_Last_count.store(0, std::memory_order_relaxed);
+		_Site->_Chunks.store(0, std::memory_order_relaxed);
+		_Site->_Elements.store(0, std::memory_order_relaxed);
+		_Site->_Chunk_ps.store(0, std::memory_order_relaxed);
+		_Site->_Tail_permille.store(0, std::memory_order_relaxed);
+		_Site->_Spread_permille.store(0, std::memory_order_relaxed);
 	}
 }
 _PSTL_NS1_END
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <experimental\impl\event.h>
+#include <experimental\impl\algorithm_scheduler.h>
 #include <Windows.h>
 
 _PSTL_NS1_BEGIN
@@ -6,7 +7,53 @@ namespace details {
 	static_assert(sizeof(SRWLOCK) == sizeof(intptr_t), "Space for SRWLOCK is not enough");
 	static_assert(sizeof(CONDITION_VARIABLE) == sizeof(intptr_t), "Space for CONDITION_VARIABLE is not enough");
 
-	_EXP_IMPL Event::Event() : m_isSet(false)
+	namespace
+	{
+		typedef BOOL (WINAPI *_Wait_on_address_fn)(volatile VOID *, PVOID, SIZE_T, DWORD);
+		typedef VOID (WINAPI *_Wake_by_address_fn)(PVOID);
+
+		// WaitOnAddress comes with Windows 8, older systems block on the condition variable
+		struct _Address_wait_api
+		{
+			_Wait_on_address_fn _Wait;
+			_Wake_by_address_fn _Wake_all;
+
+			_Address_wait_api() : _Wait(nullptr), _Wake_all(nullptr)
+			{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+				HMODULE _Module = ::LoadLibraryExW(L"api-ms-win-core-synch-l1-2-0.dll", NULL, LOAD_LIBRARY_SEARCH_SYSTEM32);
+				if (_Module != NULL)
+				{
+					_Wait = reinterpret_cast<_Wait_on_address_fn>(::GetProcAddress(_Module, "WaitOnAddress"));
+					_Wake_all = reinterpret_cast<_Wake_by_address_fn>(::GetProcAddress(_Module, "WakeByAddressAll"));
+					if (_Wait == nullptr || _Wake_all == nullptr)
+						_Wait = nullptr, _Wake_all = nullptr;
+				}
+#endif
+			}
+		} _Address_wait;
+
+		enum { _Unset, _Set, _Sleeping };
+
+		const unsigned int _Spin_count = 4096;
+
+		// Spinning only pays when the thread setting the event can run meanwhile
+		const unsigned int _Spin_limit = get_hardware_concurrency() > 1 ? _Spin_count : 0;
+
+		template <typename _Pred>
+		bool _Spin_until(_Pred _Done)
+		{
+			for (unsigned int _Spin = 0; _Spin < _Spin_limit; ++_Spin)
+			{
+				if (_Done())
+					return true;
+				YieldProcessor();
+			}
+			return _Done();
+		}
+	}
+
+	_EXP_IMPL Event::Event() : m_state(_Unset)
 	{
 		InitializeSRWLock(reinterpret_cast<PSRWLOCK>(&m_lock));
 		InitializeConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&m_cond));
@@ -14,22 +61,87 @@ namespace details {
 
 	_EXP_IMPL void __cdecl Event::wait()
 	{
-		AcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
-		while (!m_isSet)
+		if (_Spin_until([this] { return m_state.load(std::memory_order_acquire) == _Set; }))
 		{
-			SleepConditionVariableSRW(reinterpret_cast<PCONDITION_VARIABLE>(&m_cond), reinterpret_cast<PSRWLOCK>(&m_lock),
-				INFINITE, 0);
+			// Without address waits set() updates the state under the lock, don't return
+			// (and let the caller free the event) before it released it.
+			if (_Address_wait._Wait == nullptr)
+			{
+				AcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
+				ReleaseSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
+			}
+			return;
 		}
-		ReleaseSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
 
+		_Scheduler_block_begin();
+		int _State = _Unset;
+		if (_Address_wait._Wait != nullptr)
+		{
+			m_state.compare_exchange_strong(_State, _Sleeping);
+			while ((_State = m_state.load(std::memory_order_acquire)) != _Set)
+				_Address_wait._Wait(&m_state, &_State, sizeof(_State), INFINITE);
+		}
+		else
+		{
+			AcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
+			m_state.compare_exchange_strong(_State, _Sleeping);
+			while (m_state.load(std::memory_order_relaxed) != _Set)
+			{
+				SleepConditionVariableSRW(reinterpret_cast<PCONDITION_VARIABLE>(&m_cond), reinterpret_cast<PSRWLOCK>(&m_lock),
+					INFINITE, 0);
+			}
+			ReleaseSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
+		}
+		_Scheduler_block_end();
 	}
 
 	_EXP_IMPL void __cdecl Event::set()
 	{
+		if (_Address_wait._Wake_all != nullptr)
+		{
+			// Waking an address that is gone already is harmless
+			if (m_state.exchange(_Set, std::memory_order_release) == _Sleeping)
+				_Address_wait._Wake_all(&m_state);
+			return;
+		}
+
 		AcquireSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
-		m_isSet = true;
-		WakeAllConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&m_cond));
+		if (m_state.exchange(_Set, std::memory_order_release) == _Sleeping)
+			WakeAllConditionVariable(reinterpret_cast<PCONDITION_VARIABLE>(&m_cond));
 		ReleaseSRWLockExclusive(reinterpret_cast<PSRWLOCK>(&m_lock));
 	}
+
+	_EXP_IMPL void __cdecl CompletionEvent::wait()
+	{
+		if (_Spin_until([this] { return m_counter.load(std::memory_order_acquire) == 0; }))
+			return;
+
+		// Announce the sleep. If the count dropped to zero meanwhile nobody is going to wake us.
+		size_t _Count = m_counter.load(std::memory_order_relaxed);
+		while (_Count != 0 && !m_counter.compare_exchange_weak(_Count, _Count | _Sleeping))
+		{
+		}
+
+		if (_Count == 0)
+			return;
+
+		if (_Address_wait._Wait != nullptr)
+		{
+			_Scheduler_block_begin();
+			while ((_Count = m_counter.load(std::memory_order_acquire)) != _Sleeping)
+				_Address_wait._Wait(&m_counter, &_Count, sizeof(_Count), INFINITE);
+			_Scheduler_block_end();
+		}
+		else
+			m_event.wait();
+	}
+
+	_EXP_IMPL void __cdecl CompletionEvent::wake()
+	{
+		if (_Address_wait._Wake_all != nullptr)
+			_Address_wait._Wake_all(&m_counter);
+		else
+			m_event.set();
+	}
 } // std::experimental::parallel::details
 _PSTL_NS1_END
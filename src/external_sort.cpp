@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#include <Windows.h>
+#include <experimental/algorithm>
+
+_PSTL_NS1_BEGIN
+namespace details {
+	namespace
+	{
+		// A write is queued in pieces WriteFile takes, several of them in flight at once
+		const size_t _Write_piece = 256 * 1024 * 1024;
+
+		// The memory of the runs when the options leave it out, and the least of it
+		const unsigned int _Default_memory_percent = 50;
+		const size_t _Minimal_sort_memory = 64 * 1024 * 1024;
+
+		std::atomic<unsigned int> _Temp_file_counter;
+
+		void _Throw_error(DWORD _Error, const char *_Message)
+		{
+			throw std::system_error(static_cast<int>(_Error), std::system_category(), _Message);
+		}
+
+		struct _Pending_write
+		{
+			OVERLAPPED _Overlapped;
+
+			_Pending_write()
+			{
+				ZeroMemory(&_Overlapped, sizeof(_Overlapped));
+			}
+
+			~_Pending_write()
+			{
+				if (_Overlapped.hEvent != NULL)
+					::CloseHandle(_Overlapped.hEvent);
+			}
+		};
+
+		std::wstring _Temp_file_path(const wchar_t *_Directory)
+		{
+			std::wstring _Path;
+			if (_Directory != nullptr)
+				_Path = _Directory;
+			else
+			{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+				wchar_t _Temp[MAX_PATH + 1];
+				const DWORD _Length = ::GetTempPathW(MAX_PATH + 1, _Temp);
+				if (_Length == 0 || _Length > MAX_PATH)
+					_Throw_error(::GetLastError(), "Can't find the temp directory for the runs");
+				_Path = _Temp;
+#else
+				throw std::invalid_argument("The runs of an external sort need a temp directory.");
+#endif
+			}
+
+			if (!_Path.empty() && _Path.back() != L'\\' && _Path.back() != L'/')
+				_Path += L'\\';
+			_Path += L"pstl_sort_" + std::to_wstring(::GetCurrentProcessId()) + L"_" + std::to_wstring(_Temp_file_counter.fetch_add(1)) + L".tmp";
+			return _Path;
+		}
+
+		HANDLE _Create_file(const wchar_t *_Path)
+		{
+			const DWORD _Flags = FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN;
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			return ::CreateFileW(_Path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | _Flags, NULL);
+#else
+			CREATEFILE2_EXTENDED_PARAMETERS _Params = { sizeof(CREATEFILE2_EXTENDED_PARAMETERS) };
+			_Params.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+			_Params.dwFileFlags = _Flags;
+			return ::CreateFile2(_Path, GENERIC_WRITE, 0, CREATE_ALWAYS, &_Params);
+#endif
+		}
+	}
+
+	struct _Sort_file
+	{
+		HANDLE _Handle;
+		std::wstring _Path;
+		unsigned long long _Offset; // of the next write
+		std::vector<std::unique_ptr<_Pending_write>> _Slots[_Sort_file_slots];
+
+		_Sort_file() : _Handle(INVALID_HANDLE_VALUE), _Offset(0)
+		{
+		}
+
+		// returns the error of the first write that failed, 0 if none
+		DWORD _Wait(unsigned int _Slot)
+		{
+			DWORD _Error = 0;
+			for (auto& _Write : _Slots[_Slot])
+			{
+				DWORD _Bytes;
+				if (!::GetOverlappedResult(_Handle, &_Write->_Overlapped, &_Bytes, TRUE) && _Error == 0)
+					_Error = ::GetLastError();
+			}
+			_Slots[_Slot].clear();
+			return _Error;
+		}
+
+		DWORD _Wait_all()
+		{
+			DWORD _Error = 0;
+			for (unsigned int _Slot = 0; _Slot < _Sort_file_slots; ++_Slot)
+			{
+				const DWORD _Slot_error = _Wait(_Slot);
+				if (_Error == 0)
+					_Error = _Slot_error;
+			}
+			return _Error;
+		}
+	};
+
+	_EXP_IMPL _Sort_file * __cdecl _Create_sort_file(const wchar_t *_Path, const wchar_t *_Directory, unsigned long long _Bytes)
+	{
+		std::unique_ptr<_Sort_file> _File(new _Sort_file());
+		_File->_Path = _Path != nullptr ? std::wstring(_Path) : _Temp_file_path(_Directory);
+
+		_File->_Handle = _Create_file(_File->_Path.c_str());
+		if (_File->_Handle == INVALID_HANDLE_VALUE)
+			_Throw_error(::GetLastError(), "Can't create the file to sort to");
+
+		// The whole file is allocated up front, the sequential writes don't grow it piece by piece
+		LARGE_INTEGER _Size;
+		_Size.QuadPart = static_cast<LONGLONG>(_Bytes);
+		if (!::SetFilePointerEx(_File->_Handle, _Size, NULL, FILE_BEGIN) || !::SetEndOfFile(_File->_Handle))
+		{
+			const DWORD _Error = ::GetLastError();
+			::CloseHandle(_File->_Handle);
+			::DeleteFileW(_File->_Path.c_str());
+			_Throw_error(_Error, "Can't allocate the file to sort to");
+		}
+		return _File.release();
+	}
+
+	_EXP_IMPL void __cdecl _Write_sort_file(_Sort_file *_File, unsigned int _Slot, const void *_Data, size_t _Bytes)
+	{
+		auto& _Writes = _File->_Slots[_Slot];
+		for (size_t _Done = 0; _Done < _Bytes;)
+		{
+			const DWORD _Piece = static_cast<DWORD>((std::min)(_Bytes - _Done, _Write_piece));
+
+			std::unique_ptr<_Pending_write> _Write(new _Pending_write());
+			_Write->_Overlapped.Offset = static_cast<DWORD>(_File->_Offset);
+			_Write->_Overlapped.OffsetHigh = static_cast<DWORD>(_File->_Offset >> 32);
+			_Write->_Overlapped.hEvent = ::CreateEventW(NULL, TRUE, FALSE, NULL);
+			if (_Write->_Overlapped.hEvent == NULL)
+				_Throw_error(::GetLastError(), "Can't write the sorted records");
+
+			_Writes.reserve(_Writes.size() + 1);
+			if (!::WriteFile(_File->_Handle, static_cast<const char *>(_Data) + _Done, _Piece, NULL, &_Write->_Overlapped) && ::GetLastError() != ERROR_IO_PENDING)
+				_Throw_error(::GetLastError(), "Can't write the sorted records");
+
+			_Writes.push_back(std::move(_Write));
+			_File->_Offset += _Piece;
+			_Done += _Piece;
+		}
+	}
+
+	_EXP_IMPL void __cdecl _Wait_sort_file(_Sort_file *_File, unsigned int _Slot)
+	{
+		const DWORD _Error = _File->_Wait(_Slot);
+		if (_Error != 0)
+			_Throw_error(_Error, "Can't write the sorted records");
+	}
+
+	_EXP_IMPL const wchar_t * __cdecl _Close_sort_file(_Sort_file *_File)
+	{
+		const DWORD _Error = _File->_Wait_all();
+		::CloseHandle(_File->_Handle);
+		_File->_Handle = INVALID_HANDLE_VALUE;
+		if (_Error != 0)
+			_Throw_error(_Error, "Can't write the sorted records");
+		return _File->_Path.c_str();
+	}
+
+	_EXP_IMPL void __cdecl _Release_sort_file(_Sort_file *_File, bool _Remove) _NOEXCEPT
+	{
+		if (_File->_Handle != INVALID_HANDLE_VALUE)
+		{
+			_File->_Wait_all();
+			::CloseHandle(_File->_Handle);
+		}
+		if (_Remove)
+			::DeleteFileW(_File->_Path.c_str());
+		delete _File;
+	}
+
+	_EXP_IMPL size_t __cdecl _Default_sort_memory() _NOEXCEPT
+	{
+		MEMORYSTATUSEX _Status = { sizeof(MEMORYSTATUSEX) };
+		if (!::GlobalMemoryStatusEx(&_Status))
+			return _Minimal_sort_memory;
+
+		const unsigned long long _Bytes = _Status.ullAvailPhys / 100 * _Default_memory_percent;
+		return static_cast<size_t>((std::min)((std::max)(_Bytes, static_cast<unsigned long long>(_Minimal_sort_memory)),
+			static_cast<unsigned long long>(SIZE_MAX)));
+	}
+} // details
+_PSTL_NS1_END
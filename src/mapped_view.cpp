@@ -0,0 +1,123 @@
+#include <system_error>
+#include <Windows.h>
+#include <experimental/algorithm>
+
+_PSTL_NS1_BEGIN
+namespace details {
+	static_assert(sizeof(_Mapped_range) == sizeof(void *) + sizeof(SIZE_T), "_Mapped_range doesn't match WIN32_MEMORY_RANGE_ENTRY");
+
+	namespace
+	{
+		typedef BOOL (WINAPI *_Prefetch_virtual_memory_fn)(HANDLE, ULONG_PTR, PVOID, ULONG);
+
+		// PrefetchVirtualMemory comes with Windows 8, older systems read the pages when they are touched
+		struct _Prefetch_api
+		{
+			_Prefetch_virtual_memory_fn _Prefetch;
+
+			_Prefetch_api() : _Prefetch(nullptr)
+			{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+				HMODULE _Module = ::GetModuleHandleW(L"kernel32.dll");
+				if (_Module != NULL)
+					_Prefetch = reinterpret_cast<_Prefetch_virtual_memory_fn>(::GetProcAddress(_Module, "PrefetchVirtualMemory"));
+#endif
+			}
+		} _Prefetch_memory;
+
+		void _Throw_error(DWORD _Error, const char *_Message)
+		{
+			throw std::system_error(static_cast<int>(_Error), std::system_category(), _Message);
+		}
+
+		HANDLE _Open_file(const wchar_t *_Path, DWORD _Flags)
+		{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			return ::CreateFileW(_Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | _Flags, NULL);
+#else
+			CREATEFILE2_EXTENDED_PARAMETERS _Params = { sizeof(CREATEFILE2_EXTENDED_PARAMETERS) };
+			_Params.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+			_Params.dwFileFlags = _Flags;
+			return ::CreateFile2(_Path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &_Params);
+#endif
+		}
+
+		// PAGE_WRITECOPY maps the file opened for reading only, the pages written to are copied from the page cache
+		HANDLE _Create_mapping(HANDLE _File, bool _Copy_on_write)
+		{
+			const DWORD _Protect = _Copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY;
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			return ::CreateFileMappingW(_File, NULL, _Protect, 0, 0, NULL);
+#else
+			return ::CreateFileMappingFromApp(_File, NULL, _Protect, 0, NULL);
+#endif
+		}
+
+		void *_Map_view(HANDLE _Mapping, bool _Copy_on_write)
+		{
+			const DWORD _Access = _Copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ;
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+			return ::MapViewOfFile(_Mapping, _Access, 0, 0, 0);
+#else
+			return ::MapViewOfFileFromApp(_Mapping, _Access, 0, 0);
+#endif
+		}
+	}
+
+	_EXP_IMPL void __cdecl _Map_file(const wchar_t *_Path, bool _Copy_on_write, mapped_access _Access, _Mapped_file& _File)
+	{
+		const DWORD _Flags = _Access == mapped_access::sequential ? FILE_FLAG_SEQUENTIAL_SCAN
+			: _Access == mapped_access::random ? FILE_FLAG_RANDOM_ACCESS : 0;
+
+		HANDLE _Handle = _Open_file(_Path, _Flags);
+		if (_Handle == INVALID_HANDLE_VALUE)
+			_Throw_error(::GetLastError(), "Can't open the file to map");
+
+		LARGE_INTEGER _Size;
+		if (!::GetFileSizeEx(_Handle, &_Size))
+		{
+			const DWORD _Error = ::GetLastError();
+			::CloseHandle(_Handle);
+			_Throw_error(_Error, "Can't get the size of the file to map");
+		}
+
+		_File._File = _Handle;
+		_File._Mapping = nullptr;
+		_File._Data = nullptr;
+		_File._Size = static_cast<unsigned long long>(_Size.QuadPart);
+
+		// an empty file can't be mapped, its view has no elements
+		if (_File._Size == 0)
+			return;
+
+		HANDLE _Mapping = _Create_mapping(_Handle, _Copy_on_write);
+		void *_Data = _Mapping != NULL ? _Map_view(_Mapping, _Copy_on_write) : nullptr;
+		if (_Data == nullptr)
+		{
+			const DWORD _Error = ::GetLastError();
+			if (_Mapping != NULL)
+				::CloseHandle(_Mapping);
+			::CloseHandle(_Handle);
+			_Throw_error(_Error, "Can't map the file");
+		}
+
+		_File._Mapping = _Mapping;
+		_File._Data = _Data;
+	}
+
+	_EXP_IMPL void __cdecl _Unmap_file(_Mapped_file& _File)
+	{
+		if (_File._Data != nullptr)
+			::UnmapViewOfFile(_File._Data);
+		if (_File._Mapping != nullptr)
+			::CloseHandle(_File._Mapping);
+		::CloseHandle(_File._File);
+	}
+
+	_EXP_IMPL void __cdecl _Prefetch_mapped(const _Mapped_range *_Ranges, size_t _Count)
+	{
+		if (_Prefetch_memory._Prefetch != nullptr && _Count != 0)
+			_Prefetch_memory._Prefetch(::GetCurrentProcess(), static_cast<ULONG_PTR>(_Count), const_cast<_Mapped_range *>(_Ranges), 0);
+	}
+} // details
+_PSTL_NS1_END
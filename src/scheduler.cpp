@@ -1,3 +1,5 @@
+#if !defined(_PSTL_WORKER_POOL)
+
 #include <thread>
 #include <Windows.h>
 #include <experimental/impl/algorithm_scheduler.h>
@@ -16,6 +18,24 @@ namespace details {
 		::SwitchToThread();
 	}
 
+	// The Win32 threadpool injects threads on its own when callbacks block
+	void __cdecl _Scheduler_block_begin()
+	{
+	}
+
+	void __cdecl _Scheduler_block_end()
+	{
+	}
+
+	// The system threadpool starts and retires its threads on its own
+	void __cdecl _Scheduler_prewarm(unsigned int)
+	{
+	}
+
+	void __cdecl _Scheduler_shutdown()
+	{
+	}
+
 	_EXP_IMPL _Threadpool_chore::~_Threadpool_chore()
 	{
 		if (_Work != nullptr) {
@@ -43,3 +63,4 @@ namespace details {
 } // std::experimental::parallel::details
 _PSTL_NS1_END
 
+#endif // !_PSTL_WORKER_POOL
@@ -81,6 +81,23 @@ namespace details {
 		return std::this_thread::yield();
 	}
 
+	void __cdecl _Scheduler_block_begin()
+	{
+	}
+
+	void __cdecl _Scheduler_block_end()
+	{
+	}
+
+	// The system threadpool starts and retires its threads on its own
+	void __cdecl _Scheduler_prewarm(unsigned int)
+	{
+	}
+
+	void __cdecl _Scheduler_shutdown()
+	{
+	}
+
 	_EXP_IMPL unsigned int __cdecl get_current_thread_id()
 	{
 		return GetCurrentThreadId();
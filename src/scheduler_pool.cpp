@@ -0,0 +1,309 @@
+#if defined(_PSTL_WORKER_POOL)
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <Windows.h>
+#include <experimental/impl/algorithm_scheduler.h>
+
+_PSTL_NS1_BEGIN
+namespace details {
+
+	__declspec(thread) bool _Is_pool_worker;
+
+	// Library owned worker pool. The threads are created once, on the first schedule_chore call or
+	// by prewarm, and live until the process exits or shutdown lets the idle ones go. Dispatching a chore is a queue push under a slim lock
+	// plus (at most) one condition variable wake, instead of the create/submit/close cycle
+	// of the Win32 threadpool backend in scheduler.cpp.
+	//
+	// Idle workers spin for a short while before they park, so back to back calls of short
+	// algorithms (10-100us) find a worker already awake.
+	//
+	// A worker only gets an ideal processor by default, not a hard affinity, so it can still move
+	// off a processor another process keeps busy. set_worker_pinning pins each worker to a processor
+	// when it starts, and the running ones before their next chore.
+	//
+	// The pool grows past the hardware concurrency only to compensate for workers blocked in
+	// Event::wait (nested algorithms and TaskGroup::wait), otherwise the queued chores of an
+	// outer algorithm could never run once every worker waits for them.
+	class _Worker_pool
+	{
+		static const unsigned int _Spin_count = 4096;
+
+		INIT_ONCE _M_Init;
+		SRWLOCK _M_Lock;
+		CONDITION_VARIABLE _M_Wake;
+		CONDITION_VARIABLE _M_Exited;
+		// Ring buffer of the queued chores, it only grows so dispatch doesn't allocate once warm
+		std::vector<_Threadpool_chore *> _M_Queue; // lock protected
+		size_t _M_Head;                           // lock protected
+		size_t _M_Count;                          // lock protected
+		unsigned int _M_Threads;                  // lock protected
+		unsigned int _M_Parked;                   // lock protected
+		bool _M_Exiting;                          // lock protected, set by _Shutdown
+
+		// _M_Spinning is only decremented under the lock, so a producer that reads it
+		// under the lock knows whether a spinning worker is going to see its chore.
+		std::atomic<unsigned int> _M_Spinning;
+		std::atomic<unsigned int> _M_Blocked;
+		std::atomic<size_t> _M_Pending;           // mirrors _M_Count for the spin loop
+		std::atomic<unsigned int> _M_Ranks;       // the next worker's rank, see set_worker_pinning
+
+		const unsigned int _M_Concurrency;
+		const unsigned int _M_Max_threads;
+
+		static DWORD WINAPI _Worker_proc(LPVOID _Param)
+		{
+			static_cast<_Worker_pool *>(_Param)->_Worker_loop();
+			return 0;
+		}
+
+		// lock must be held
+		void _Push(_Threadpool_chore *_Chore)
+		{
+			if (_M_Count == _M_Queue.size())
+			{
+				std::vector<_Threadpool_chore *> _Larger((std::max)(_M_Queue.size() * 2, static_cast<size_t>(64)));
+				for (size_t _Idx = 0; _Idx < _M_Count; ++_Idx)
+					_Larger[_Idx] = _M_Queue[(_M_Head + _Idx) % _M_Queue.size()];
+				_M_Queue.swap(_Larger);
+				_M_Head = 0;
+			}
+
+			_M_Queue[(_M_Head + _M_Count) % _M_Queue.size()] = _Chore;
+			++_M_Count;
+		}
+
+		// lock must be held
+		_Threadpool_chore *_Pop()
+		{
+			_Threadpool_chore *_Chore = _M_Queue[_M_Head];
+			_M_Head = (_M_Head + 1) % _M_Queue.size();
+			--_M_Count;
+			return _Chore;
+		}
+
+		// lock must be held
+		void _Start_worker()
+		{
+			DWORD _Id;
+			++_M_Threads;
+			_M_Spinning.fetch_add(1);
+
+			HANDLE _Thread = ::CreateThread(NULL, 0, _Worker_proc, this, 0, &_Id);
+			if (_Thread == NULL)
+			{
+				// Not fatal as long as there is at least one worker left
+				--_M_Threads;
+				_M_Spinning.fetch_sub(1);
+				return;
+			}
+
+			if (_M_Threads <= _M_Concurrency)
+				::SetThreadIdealProcessor(_Thread, _M_Threads - 1);
+			::CloseHandle(_Thread);
+		}
+
+		// lock must be held
+		void _Ensure_progress()
+		{
+			if (_M_Count == 0 || _M_Spinning.load() != 0)
+				return;
+
+			if (_M_Parked != 0)
+				::WakeConditionVariable(&_M_Wake);
+			else if (_M_Threads - _M_Blocked.load() < _M_Concurrency && _M_Threads < _M_Max_threads)
+				_Start_worker();
+		}
+
+		void _Worker_loop()
+		{
+			_Is_pool_worker = true;
+
+			// the workers take the processors fastest first if they are pinned
+			const unsigned int _Rank = _M_Ranks.fetch_add(1, std::memory_order_relaxed);
+			unsigned int _Pinning = _Apply_worker_pinning(_Rank);
+
+			for (;;)
+			{
+				for (unsigned int _Spin = 0; _M_Pending.load(std::memory_order_acquire) == 0 && _Spin < _Spin_count; ++_Spin)
+					YieldProcessor();
+
+				AcquireSRWLockExclusive(&_M_Lock);
+				if (_M_Count == 0)
+				{
+					_M_Spinning.fetch_sub(1);
+					++_M_Parked;
+					while (_M_Count == 0 && !_M_Exiting)
+						SleepConditionVariableSRW(&_M_Wake, &_M_Lock, INFINITE, 0);
+					--_M_Parked;
+
+					if (_M_Count == 0)
+					{
+						--_M_Threads;
+						WakeAllConditionVariable(&_M_Exited);
+						ReleaseSRWLockExclusive(&_M_Lock);
+						return;
+					}
+					_M_Spinning.fetch_add(1);
+				}
+
+				_Threadpool_chore *_Chore = _Pop();
+				_M_Pending.fetch_sub(1, std::memory_order_relaxed);
+				_M_Spinning.fetch_sub(1);
+
+				// chain the wake up if more work is queued and nobody would pick it
+				_Ensure_progress();
+				ReleaseSRWLockExclusive(&_M_Lock);
+
+				if (_Pinning != _Worker_pinning_generation())
+					_Pinning = _Apply_worker_pinning(_Rank);
+				_Chore->invoke();
+
+				_M_Spinning.fetch_add(1);
+			}
+		}
+
+		static BOOL CALLBACK _Init_once(PINIT_ONCE, PVOID _Param, PVOID *)
+		{
+			auto _Pool = static_cast<_Worker_pool *>(_Param);
+
+			// The workers are never joined, so pin the module to keep their code mapped
+			// until the process exits.
+			HMODULE _Module;
+			::GetModuleHandleExW(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_PIN,
+				reinterpret_cast<LPCWSTR>(&_Worker_proc), &_Module);
+
+			AcquireSRWLockExclusive(&_Pool->_M_Lock);
+			while (_Pool->_M_Threads < _Pool->_M_Concurrency)
+			{
+				auto _Started = _Pool->_M_Threads;
+				_Pool->_Start_worker();
+				if (_Started == _Pool->_M_Threads)
+					break;
+			}
+			ReleaseSRWLockExclusive(&_Pool->_M_Lock);
+			return TRUE;
+		}
+
+	public:
+		_Worker_pool() : _M_Head(0), _M_Count(0), _M_Threads(0), _M_Parked(0), _M_Exiting(false), _M_Spinning(0), _M_Blocked(0), _M_Pending(0), _M_Ranks(0),
+			_M_Concurrency(get_hardware_concurrency()), _M_Max_threads(get_hardware_concurrency() * 8)
+		{
+			InitializeSRWLock(&_M_Lock);
+			InitializeConditionVariable(&_M_Wake);
+			InitializeConditionVariable(&_M_Exited);
+			InitOnceInitialize(&_M_Init);
+		}
+
+		void _Submit(_Threadpool_chore *_Chore)
+		{
+			::InitOnceExecuteOnce(&_M_Init, _Init_once, this, NULL);
+
+			AcquireSRWLockExclusive(&_M_Lock);
+			_Push(_Chore);
+			_M_Pending.fetch_add(1, std::memory_order_release);
+			_Ensure_progress();
+			ReleaseSRWLockExclusive(&_M_Lock);
+		}
+
+		void _Prewarm(unsigned int _Threads)
+		{
+			::InitOnceExecuteOnce(&_M_Init, _Init_once, this, NULL);
+
+			AcquireSRWLockExclusive(&_M_Lock);
+			while (_M_Threads < (std::min)(_Threads, _M_Max_threads))
+			{
+				auto _Started = _M_Threads;
+				_Start_worker();
+				if (_Started == _M_Threads)
+					break;
+			}
+			ReleaseSRWLockExclusive(&_M_Lock);
+		}
+
+		// The busy workers exit once the queue is empty. The pool starts over on the next chore,
+		// a worker at a time as _Ensure_progress finds none.
+		void _Shutdown()
+		{
+			AcquireSRWLockExclusive(&_M_Lock);
+			_M_Exiting = true;
+			WakeAllConditionVariable(&_M_Wake);
+			while (_M_Threads != 0)
+				SleepConditionVariableSRW(&_M_Exited, &_M_Lock, INFINITE, 0);
+			_M_Exiting = false;
+			_M_Ranks.store(0, std::memory_order_relaxed);
+			ReleaseSRWLockExclusive(&_M_Lock);
+		}
+
+		void _Block_begin()
+		{
+			_M_Blocked.fetch_add(1);
+
+			AcquireSRWLockExclusive(&_M_Lock);
+			_Ensure_progress();
+			ReleaseSRWLockExclusive(&_M_Lock);
+		}
+
+		void _Block_end()
+		{
+			_M_Blocked.fetch_sub(1);
+		}
+	} _Pool;
+
+	void __cdecl _Scheduler_block_begin()
+	{
+		if (_Is_pool_worker)
+			_Pool._Block_begin();
+	}
+
+	void __cdecl _Scheduler_block_end()
+	{
+		if (_Is_pool_worker)
+			_Pool._Block_end();
+	}
+
+	void __cdecl _Scheduler_prewarm(unsigned int _Threads)
+	{
+		_Pool._Prewarm(_Threads);
+	}
+
+	void __cdecl _Scheduler_shutdown()
+	{
+		// a worker would wait for itself
+		if (!_Is_pool_worker)
+			_Pool._Shutdown();
+	}
+
+	void __cdecl yield()
+	{
+		::SwitchToThread();
+	}
+
+	_EXP_IMPL _Threadpool_chore::~_Threadpool_chore()
+	{
+		// The pool keeps no per chore state
+		_Work = nullptr;
+	}
+
+	_EXP_IMPL void __cdecl _Threadpool_chore::reschedule()
+	{
+		_Pool._Submit(this);
+	}
+
+	_EXP_IMPL void __cdecl schedule_chore(_Threadpool_chore* _Chore)
+	{
+		_ASSERT(_Chore->_Work == nullptr);
+		_Chore->_Work = &_Pool; // marks the chore as scheduled
+		_Pool._Submit(_Chore);
+	}
+
+	_EXP_IMPL unsigned int __cdecl get_current_thread_id()
+	{
+		return GetCurrentThreadId();
+	}
+} // std::experimental::parallel::details
+_PSTL_NS1_END
+
+#endif // _PSTL_WORKER_POOL
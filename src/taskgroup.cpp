@@ -1,6 +1,9 @@
+#include <algorithm>
 #include <thread>
 #include <numeric>
 #include <cstdint>
+#include <memory>
+#include <vector>
 #include <Windows.h>
 #include <experimental\impl\taskgroup.h>
 #include <experimental\impl\algorithm_impl.h>
@@ -8,12 +11,11 @@
 _PSTL_NS1_BEGIN
 namespace details
 {
-	const unsigned int TotalWorkStealingQueueNumber = 1024u; // It must be 2^n and greater than number of CPUs
-
 	void freeWorkStealingQueueOnCurrentThread();
 
 	class WorkStealingQueueFactory;
 	class WorkStealingQueueSet;
+	class WorkArena;
 
 	bool IsWindows7()
 	{
@@ -52,62 +54,183 @@ namespace details
 #endif					
 	}
 
+	// xorshift32, a single word of state is plenty for picking steal victims
+	class StealRandom
+	{
+		uint32_t m_state;
+	public:
+		explicit StealRandom(uint32_t seed) : m_state(seed != 0 ? seed : 0x9E3779B9u) {}
+
+		uint32_t operator()()
+		{
+			uint32_t x = m_state;
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			return m_state = x;
+		}
+	};
+
+	// Chase-Lev work-stealing deque. The owner thread pushes and pops at the bottom
+	// without read-modify-write atomics, thieves take the oldest chore from the top
+	// with a single CAS. Only the last chore in the queue is raced for by the owner.
+	class ChoreDeque
+	{
+		// Circular buffer of the deque. A full buffer is replaced by one twice as large;
+		// the retired ones are kept alive with the queue since a thief may still read from them.
+		struct ChoreArray
+		{
+			const size_t capacity; // 2^n
+			std::unique_ptr<std::atomic<WorkChoreBase *>[]> slots;
+			std::unique_ptr<ChoreArray> retired;
+
+			explicit ChoreArray(size_t cap) : capacity(cap), slots(new std::atomic<WorkChoreBase *>[cap]) {}
+
+			WorkChoreBase *get(size_t i) const
+			{
+				return slots[i & (capacity - 1)].load(std::memory_order_relaxed);
+			}
+
+			void put(size_t i, WorkChoreBase *chore)
+			{
+				slots[i & (capacity - 1)].store(chore, std::memory_order_relaxed);
+			}
+		};
+
+		static const size_t InitialCapacity = 64;
+
+		// The indices only grow, they are compared by difference so wrapping around is harmless.
+		// Keep the thieves' index away from the owner's one.
+		std::atomic<size_t> m_top;
+		char m_padding[64 - sizeof(std::atomic<size_t>)];
+		std::atomic<size_t> m_bottom;
+		std::atomic<ChoreArray *> m_array;
+		std::unique_ptr<ChoreArray> m_arrayOwner; // owner thread only
+
+		ChoreArray *grow(ChoreArray *current, size_t bottom, size_t top)
+		{
+			std::unique_ptr<ChoreArray> larger(new ChoreArray(current->capacity * 2));
+			for (size_t i = top; i != bottom; ++i)
+				larger->put(i, current->get(i));
+
+			larger->retired = std::move(m_arrayOwner);
+			m_arrayOwner = std::move(larger);
+			m_array.store(m_arrayOwner.get(), std::memory_order_release);
+			return m_arrayOwner.get();
+		}
+
+	public:
+		ChoreDeque() : m_top(0), m_bottom(0), m_arrayOwner(new ChoreArray(InitialCapacity))
+		{
+			m_array.store(m_arrayOwner.get(), std::memory_order_relaxed);
+		}
+
+		// any thread, a snapshot that may be off by the chores being pushed or stolen
+		ptrdiff_t size() const
+		{
+			return static_cast<ptrdiff_t>(m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed));
+		}
+
+		// owner thread only
+		void push(WorkChoreBase *chore)
+		{
+			size_t bottom = m_bottom.load(std::memory_order_relaxed);
+			size_t top = m_top.load(std::memory_order_acquire);
+			ChoreArray *chores = m_array.load(std::memory_order_relaxed);
+
+			if (bottom - top >= chores->capacity)
+				chores = grow(chores, bottom, top);
+
+			chores->put(bottom, chore);
+			std::atomic_thread_fence(std::memory_order_release);
+			m_bottom.store(bottom + 1, std::memory_order_relaxed);
+		}
+
+		// owner thread only, returns the most recently pushed chore
+		WorkChoreBase *pop()
+		{
+			size_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+			ChoreArray *chores = m_array.load(std::memory_order_relaxed);
+			m_bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t top = m_top.load(std::memory_order_relaxed);
+
+			if (static_cast<ptrdiff_t>(bottom - top) < 0)
+			{
+				// empty queue
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			WorkChoreBase *chore = chores->get(bottom);
+			if (bottom == top)
+			{
+				// the last chore, thieves may be racing for it
+				if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					chore = nullptr;
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return chore;
+		}
+
+		// any thread, returns the oldest chore or nullptr if the queue is empty or the race was lost
+		WorkChoreBase *steal()
+		{
+			size_t top = m_top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t bottom = m_bottom.load(std::memory_order_acquire);
+
+			if (static_cast<ptrdiff_t>(bottom - top) <= 0)
+				return nullptr;
+
+			WorkChoreBase *chore = m_array.load(std::memory_order_acquire)->get(top);
+			if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return chore;
+		}
+	};
+
+	// The queue of a thread, a deque per priority lane. The owner pops and the thieves steal the high
+	// lane first, a normal chore waits for the high ones queued before and after it.
+	//
 	// The Workstealing queue is built on following 2 assumptions:
 	// 1. Workload of each chore is relatively light
 	// 2. Schedule method is invoked under relatively high volume
-	// We try to reduce the amount of atomics and dependencies on relaxed memory model
 	class WorkStealingQueue : public _Threadpool_chore
 	{
 		friend class WorkStealingQueueFactory;
 		friend class WorkStealingQueueSet;
+		friend class WorkArena;
 		friend void freeWorkStealingQueueOnCurrentThread();
 
-		std::atomic<int> m_workstealingPosition;
+		static const size_t MaximalStealBatch = 32;
+		static const size_t RampUpBacklog = 8; // queued chores per injected thread
+
+		std::atomic<int> m_workstealingPosition; // index in the queues of m_node
+		unsigned int m_node;
+		WorkArena *m_arena; // the arena whose set holds the queue
 
 		// QueueReset, QueueScheduled are 2 status indicate that the chore is ready to be rescheduled
 		enum { QueueCreated, QueueReset, QueueScheduled } m_wsqStatus;
 
-		// workstealing queue
-		WorkChoreBase * m_topChore;
-		std::atomic<WorkChoreBase *> m_rootChore;
-		std::atomic<WorkChoreBase *> m_lastChore;
+		ChoreDeque m_lanes[_Lane_count];
 
-		// Scheduler
-		static std::atomic<size_t> s_threadPoolRunning;
-		static size_t s_concurrencyLevel;
+		inline void injectThread();
 
-		void updateStealingPoint()
-		{
-			// Update stealing point
-			if (auto p = m_lastChore.load(std::memory_order_relaxed))
-			{
-				m_lastChore.store(nullptr, std::memory_order_relaxed);
-				m_rootChore = p->m_next.load();
-				// no other thread will ever touch this node
-				p->m_next.store(nullptr, std::memory_order_relaxed);
-			}
-		}
+		// the count of the high priority chores of the arena follows the high lanes
+		inline void queuedHigh(int delta);
 
-		void injectThread()
+		WorkChoreBase *takenFrom(unsigned int lane, WorkChoreBase *chore)
 		{
-			if (m_wsqStatus != QueueScheduled)
-			{
-				m_topChore->m_next = nullptr;
-				if (m_wsqStatus == QueueCreated)
-					schedule_chore(this);
-				else
-					reschedule();
-				m_wsqStatus = QueueScheduled;
-			}
-			else
-				reschedule();
-
-			++s_threadPoolRunning;
+			if (chore != nullptr && lane == _High_lane)
+				queuedHigh(-1);
+			return chore;
 		}
 	public:
-		std::mt19937 randomGen;
+		StealRandom randomGen;
 
-		WorkStealingQueue() : m_workstealingPosition(-1)
+		explicit WorkStealingQueue(uint32_t seed) : m_workstealingPosition(-1), m_node(0), m_arena(nullptr), randomGen(seed)
 		{
 			m_wsqStatus = QueueCreated;
 			reset();
@@ -122,8 +245,7 @@ namespace details
 
 		void reset()
 		{
-			m_rootChore = m_topChore = nullptr;
-			m_lastChore.store(nullptr, std::memory_order_relaxed);
+			_ASSERT(m_lanes[_Normal_lane].size() <= 0 && m_lanes[_High_lane].size() <= 0);
 			if (m_wsqStatus != QueueCreated)
 				m_wsqStatus = QueueReset;
 		}
@@ -131,73 +253,91 @@ namespace details
 		// threadpool callback
 		virtual void __cdecl invoke() override;
 
-		WorkChoreBase *tryStealChore(bool waitForPending = false)
-		{
-			WorkChoreBase * const PendingState = reinterpret_cast<WorkChoreBase *>(static_cast<intptr_t>(-1));
+		// runs a chore stolen from any queue on the owner thread while it waits
+		bool helpWithStolenChore();
 
-			WorkChoreBase *chore = m_rootChore.exchange(PendingState);
+		// runs the high priority chores of the arena on the owner thread between two chunks of a normal one
+		bool runHighLane();
 
-			// Busy waiting
-			while (waitForPending && chore == PendingState)
-			{
-				details::yield();
-				chore = m_rootChore;
-				if (chore != PendingState)
-					m_rootChore.compare_exchange_strong(chore, PendingState);
-			}
+		size_t backlog() const
+		{
+			ptrdiff_t queued = m_lanes[_Normal_lane].size() + m_lanes[_High_lane].size();
+			return queued > 0 ? static_cast<size_t>(queued) : 0;
+		}
 
-			if (chore && chore != PendingState) // got an available chore
-			{
-				auto nextChore = chore->tryStealNextChore();
+		// owner thread only, in the lane of the chore
+		void push(WorkChoreBase *chore)
+		{
+			// counted before a thief can take it, the count never drops below the chores queued
+			if (chore->m_lane == _High_lane)
+				queuedHigh(1);
+			m_lanes[chore->m_lane].push(chore);
+		}
 
-				// if nextChore == nullptr, m_rootChore will be kept as nullptr until someone reset it
-				// from m_lastChore
-				m_rootChore = nextChore;
-				if (!nextChore)
-					m_lastChore.store(chore, std::memory_order_relaxed); // The workstealing queue is empty, notify the queue owner
-				return chore;
-			}
-			else
-			{
-				if (chore == nullptr)
-				{
-					chore = PendingState;
-					m_rootChore.compare_exchange_strong(chore, nullptr);
-				}
-				return nullptr;
-			}
+		// owner thread only, returns the most recently pushed chore of a lane
+		WorkChoreBase *pop(unsigned int lane)
+		{
+			return takenFrom(lane, m_lanes[lane].pop());
 		}
 
+		// owner thread only, returns the most recently pushed chore of the high lane, else of the normal one
+		WorkChoreBase *pop()
+		{
+			auto chore = pop(_High_lane);
+			return chore != nullptr ? chore : pop(_Normal_lane);
+		}
 
-		void schedule(WorkChoreBase *chore)
+		// any thread, returns the oldest chore of a lane or nullptr if it is empty or the race was lost
+		WorkChoreBase *tryStealChore(unsigned int lane)
 		{
-			// step 1 push chore
-			chore->m_prev = m_topChore;
-			if (m_topChore)
-			{
-				m_topChore = m_topChore->m_next = chore;
+			return takenFrom(lane, m_lanes[lane].steal());
+		}
 
-				updateStealingPoint();
+		// any thread, steals one chore to run and moves up to half of the remaining ones of its lane
+		// into the thief's queue, where the thief pops them without going through the victim search.
+		// Each chore is still claimed with its own CAS: the owner pops without one, so a thief
+		// can't safely claim a range of the deque. The high lane is tried first, the normal one
+		// unless highOnly.
+		WorkChoreBase *tryStealBatch(WorkStealingQueue *thief, bool highOnly)
+		{
+			unsigned int lane = _High_lane;
+			WorkChoreBase *chore = tryStealChore(lane);
+			if (chore == nullptr && !highOnly)
+			{
+				lane = _Normal_lane;
+				chore = tryStealChore(lane);
 			}
-			else
+			if (chore == nullptr || thief == this)
+				return chore;
+
+			ptrdiff_t size = m_lanes[lane].size();
+			size_t batch = size > 0 ? (std::min)(static_cast<size_t>(size) / 2, MaximalStealBatch) : 0;
+			size_t moved = 0;
+			for (; moved != batch; ++moved)
 			{
-				m_rootChore = m_topChore = chore;
-				_ASSERT(m_lastChore.load(std::memory_order_relaxed) == nullptr);
+				auto next = tryStealChore(lane);
+				if (next == nullptr)
+					break;
+				thief->push(next);
 			}
 
-			// step 2 spawn new thread if needed
-			if (s_threadPoolRunning < s_concurrencyLevel)
-				injectThread();
+			// the moved chores can be stolen from the thief in turn
+			if (moved != 0)
+				thief->wakeWorkers();
+			return chore;
 		}
 
-		void setTopChoreBack(WorkChoreBase *chore)
+		// Injects up to one thread per RampUpBacklog queued chores at once, instead of one per
+		// schedule call, so a large fan-out reaches the concurrency level without waiting for it.
+		inline void wakeWorkers();
+
+		void schedule(WorkChoreBase *chore)
 		{
-			// m_lastChore is always set by workstealingqueue owner
-			// except during "tryStealChore", which can be set by other threads
-			// with spin wait protection
-			if (m_lastChore.load(std::memory_order_relaxed) == m_topChore)
-				m_lastChore.store(chore, std::memory_order_relaxed);
-			m_topChore = chore;
+			// step 1 push chore
+			push(chore);
+
+			// step 2 spawn new threads if needed
+			wakeWorkers();
 		}
 	};
 
@@ -223,32 +363,242 @@ namespace details
 		}
 	};
 
+	// Eventcount the idle workers of an arena park on. A worker announces itself with prepareWait,
+	// checks the queues once more and sleeps in commitWait unless it found something. A notify after
+	// a push either comes before the announcement, and the check sees the chore, or after it, and
+	// moves the epoch the sleeper waits on. The pushes pay a fence and a load while no one is parked.
+	class EventCount
+	{
+		std::atomic<unsigned int> m_epoch;
+		std::atomic<size_t> m_waiters;
+		SRWLOCK m_lock;
+		CONDITION_VARIABLE m_wake;
+
+	public:
+		EventCount() : m_epoch(0), m_waiters(0)
+		{
+			InitializeSRWLock(&m_lock);
+			InitializeConditionVariable(&m_wake);
+		}
+
+		size_t waiters() const
+		{
+			return m_waiters.load(std::memory_order_relaxed);
+		}
+
+		unsigned int prepareWait()
+		{
+			m_waiters.fetch_add(1, std::memory_order_seq_cst);
+			return m_epoch.load(std::memory_order_seq_cst);
+		}
+
+		void cancelWait()
+		{
+			m_waiters.fetch_sub(1, std::memory_order_relaxed);
+		}
+
+		// returns false if the timeout expired without a notify
+		bool commitWait(unsigned int key, DWORD timeoutMs)
+		{
+			bool notified = true;
+			AcquireSRWLockExclusive(&m_lock);
+			while (m_epoch.load(std::memory_order_relaxed) == key)
+			{
+				if (!SleepConditionVariableSRW(&m_wake, &m_lock, timeoutMs, 0))
+				{
+					notified = m_epoch.load(std::memory_order_relaxed) != key;
+					break;
+				}
+			}
+			m_waiters.fetch_sub(1, std::memory_order_relaxed);
+			ReleaseSRWLockExclusive(&m_lock);
+			return notified;
+		}
+
+		// wakes up to count waiters, returns how many there were to wake
+		size_t notify(size_t count)
+		{
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			size_t waiting = m_waiters.load(std::memory_order_relaxed);
+			if (waiting == 0)
+				return 0;
+
+			AcquireSRWLockExclusive(&m_lock);
+			m_epoch.fetch_add(1, std::memory_order_relaxed);
+			waiting = (std::min)(count, m_waiters.load(std::memory_order_relaxed));
+			if (waiting >= m_waiters.load(std::memory_order_relaxed))
+				WakeAllConditionVariable(&m_wake);
+			else
+			{
+				for (size_t i = 0; i != waiting; ++i)
+					WakeConditionVariable(&m_wake);
+			}
+			ReleaseSRWLockExclusive(&m_lock);
+			return waiting;
+		}
+	};
+
+	// Victim table of a NUMA node. A full table is replaced by one twice as large; the retired
+	// ones are kept alive with the set since a thief may still read from them.
+	struct QueueArray
+	{
+		const int capacity;
+		std::unique_ptr<std::atomic<WorkStealingQueue *>[]> slots;
+		std::unique_ptr<QueueArray> retired;
+
+		explicit QueueArray(int cap) : capacity(cap), slots(new std::atomic<WorkStealingQueue *>[cap]) {}
+	};
+
+	// Queues of the threads running on one NUMA node, with the steal counters of those threads
+	struct WorkStealingNode
+	{
+		std::atomic<QueueArray *> m_queue;
+		std::unique_ptr<QueueArray> m_queueOwner; // set lock protected
+		std::atomic<int> m_top; // set lock protected
+		std::atomic<size_t> m_localSteals;
+		std::atomic<size_t> m_remoteSteals;
+		char m_padding[64];
+
+		WorkStealingNode() : m_queue(nullptr), m_top(0), m_localSteals(0), m_remoteSteals(0) {}
+	};
+
+	inline unsigned int getNumaNodeCount()
+	{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+		ULONG highestNode;
+		if (::GetNumaHighestNodeNumber(&highestNode))
+			return highestNode + 1;
+#endif
+		return 1;
+	}
+
+	inline unsigned int getCurrentNumaNode()
+	{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+		PROCESSOR_NUMBER processor;
+		USHORT node;
+		::GetCurrentProcessorNumberEx(&processor);
+		if (::GetNumaProcessorNodeEx(&processor, &node) && node != 0xFFFF)
+			return node;
+#endif
+		return 0;
+	}
+
+	// The queues are grouped by the NUMA node of the thread that owns them. Thieves look for
+	// work on their own node first and only cross the interconnect once the local queues
+	// turned out to be empty, so the partitions of an algorithm stay with the memory they touch.
+	//
+	// Queues are created on demand, the first time a thread needs one, and recycled after
+	// the thread releases it. A process that never runs a parallel algorithm pays for none.
 	class WorkStealingQueueSet
 	{
-		WorkStealingQueue m_queuePool[TotalWorkStealingQueueNumber];
+		static const int LocalStealAttempts = 10;
+		static const int RemoteStealAttempts = 4;
+
 		// NOTE: when perf stability become an issue, we need to rewrite this 
 		// WorkStealingQueue allocation from LIFO to FIFO.
-		std::atomic<WorkStealingQueue *> m_queue[TotalWorkStealingQueueNumber];
+		std::vector<std::unique_ptr<WorkStealingQueue>> m_queuePool; // lock protected
+		std::vector<WorkStealingQueue *> m_freeQueue; // lock protected
 		SRWLock m_mutex;
-		std::atomic<int> m_top; // lock protected
+
+		const unsigned int m_nodeCount;
+		std::unique_ptr<WorkStealingNode[]> m_nodes;
+		std::atomic<int> m_highQueued;
+
+		// lock must be held
+		WorkStealingQueue *newQueue()
+		{
+			if (!m_freeQueue.empty())
+			{
+				auto wd = m_freeQueue.back();
+				m_freeQueue.pop_back();
+				return wd;
+			}
+
+			// Reserve first, so a failing push_back can't leak the queue
+			m_queuePool.reserve(m_queuePool.size() + 1);
+			m_freeQueue.reserve(m_queuePool.size() + 1);
+			m_queuePool.emplace_back(new WorkStealingQueue(static_cast<uint32_t>(m_queuePool.size() + 1) * 0x9E3779B9u));
+			return m_queuePool.back().get();
+		}
+
+		// lock must be held
+		QueueArray *reserveSlot(WorkStealingNode &group, int top)
+		{
+			QueueArray *current = group.m_queueOwner.get();
+			if (current != nullptr && top < current->capacity)
+				return current;
+
+			int capacity = current == nullptr ? static_cast<int>(get_hardware_concurrency()) : current->capacity * 2;
+			std::unique_ptr<QueueArray> larger(new QueueArray(capacity));
+			for (int i = 0; i < top; i++)
+				larger->slots[i].store(current->slots[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+			larger->retired = std::move(group.m_queueOwner);
+			group.m_queueOwner = std::move(larger);
+			group.m_queue.store(group.m_queueOwner.get(), std::memory_order_release);
+			return group.m_queueOwner.get();
+		}
+
+		WorkStealingQueue *pickVictim(unsigned int node, StealRandom &randGen)
+		{
+			auto &group = m_nodes[node];
+			// Without lock protection, this may access removed queue.
+			// However, steal from a removed queue is fail safe.
+			// The table is published before m_top grows, so it always covers top entries.
+			int top = group.m_top.load(std::memory_order_acquire);
+			if (top == 0)
+				return nullptr;
+			auto queues = group.m_queue.load(std::memory_order_acquire);
+			return queues->slots[(randGen() & 0xFFFFFF) % top].load(std::memory_order_relaxed);
+		}
 
 	public:
-		WorkStealingQueueSet() : m_top(0)
+		WorkStealingQueueSet() : m_nodeCount(getNumaNodeCount()), m_nodes(new WorkStealingNode[m_nodeCount]), m_highQueued(0)
 		{
-			for (unsigned int i = 0; i < TotalWorkStealingQueueNumber; i++)
-				m_queue[i] = m_queuePool + i;
 		}
 
+		unsigned int nodeCount() const
+		{
+			return m_nodeCount;
+		}
+
+		bool stealCounters(unsigned int node, size_t &localSteals, size_t &remoteSteals) const
+		{
+			if (node >= m_nodeCount)
+				return false;
+			localSteals = m_nodes[node].m_localSteals.load(std::memory_order_relaxed);
+			remoteSteals = m_nodes[node].m_remoteSteals.load(std::memory_order_relaxed);
+			return true;
+		}
+
+		// returns nullptr when out of memory
 		WorkStealingQueue *alloc()
 		{
+			unsigned int node = getCurrentNumaNode();
+			if (node >= m_nodeCount)
+				node = 0;
+
 			std::lock_guard<SRWLock> guard(m_mutex);
-			int top = m_top.load(std::memory_order_relaxed);
-			if (top >= TotalWorkStealingQueueNumber)
+			auto &group = m_nodes[node];
+			int top = group.m_top.load(std::memory_order_relaxed);
+
+			WorkStealingQueue *wd;
+			QueueArray *queues;
+			try
+			{
+				queues = reserveSlot(group, top);
+				wd = newQueue();
+			}
+			catch (const std::bad_alloc &)
+			{
 				return nullptr;
-			auto wd = m_queue[top].load(std::memory_order_relaxed);
+			}
+
+			wd->m_node = node;
 			wd->m_workstealingPosition.store(top, std::memory_order_relaxed);
-			m_queue[top].store(wd, std::memory_order_relaxed);
-			m_top.store(top + 1, std::memory_order_relaxed);
+			queues->slots[top].store(wd, std::memory_order_relaxed);
+			group.m_top.store(top + 1, std::memory_order_release);
 			return wd;
 		}
 
@@ -256,63 +606,249 @@ namespace details
 		{
 			wd->reset();
 			std::lock_guard<SRWLock> guard(m_mutex);
+			auto &group = m_nodes[wd->m_node];
+			auto queues = group.m_queueOwner.get();
 			int pos = wd->m_workstealingPosition.load(std::memory_order_relaxed);
-			auto top = m_top.load(std::memory_order_relaxed);
+			auto top = group.m_top.load(std::memory_order_relaxed);
 			if (--top != pos)
 			{
-				auto next = m_queue[top].load(std::memory_order_relaxed);
-				m_queue[pos].store(next, std::memory_order_relaxed);
-				m_queue[top].store(wd, std::memory_order_relaxed);
+				auto next = queues->slots[top].load(std::memory_order_relaxed);
+				queues->slots[pos].store(next, std::memory_order_relaxed);
+				queues->slots[top].store(wd, std::memory_order_relaxed);
 				next->m_workstealingPosition.store(pos, std::memory_order_relaxed);
 			}
-			m_top.store(top, std::memory_order_relaxed);
+			group.m_top.store(top, std::memory_order_relaxed);
+			m_freeQueue.push_back(wd); // capacity reserved in newQueue
 		}
 
-		WorkChoreBase * tryRandomSteal(WorkStealingQueue *&lastTarget, std::mt19937 &randGen, int retry = 10)
+		// Deletes the queues of the pool no thread holds, no worker may run in the set. The victim
+		// tables stay, a thief of another thread may be about to read one.
+		void trim()
 		{
-			WorkChoreBase * p = lastTarget->tryStealChore();
+			std::lock_guard<SRWLock> guard(m_mutex);
+			for (auto wd : m_freeQueue)
+			{
+				m_queuePool.erase(std::find_if(m_queuePool.begin(), m_queuePool.end(),
+					[wd](const std::unique_ptr<WorkStealingQueue> &queue) { return queue.get() == wd; }));
+			}
+			m_freeQueue.clear();
+		}
+
+		// any thread, true if a queue of the set holds a chore. Unlike the random victim search it
+		// looks at every queue, for a worker about to park.
+		bool anyQueued() const
+		{
+			for (unsigned int node = 0; node < m_nodeCount; ++node)
+			{
+				auto &group = m_nodes[node];
+				int top = group.m_top.load(std::memory_order_acquire);
+				if (top == 0)
+					continue;
 
-			while (p == nullptr && retry--) {
-				// Without lock protection, this may access removed queue.
-				// However, steal from a removed queue is fail safe.
-				if (auto curTarget = m_queue[(lastTarget->m_workstealingPosition.load(std::memory_order_relaxed) + (randGen() & 0xFFFFFF)) % m_top.load(std::memory_order_relaxed)].load(std::memory_order_relaxed))
+				auto queues = group.m_queue.load(std::memory_order_acquire);
+				for (int i = 0; i < top; ++i)
 				{
-					p = curTarget->tryStealChore();
+					auto queue = queues->slots[i].load(std::memory_order_relaxed);
+					if (queue != nullptr && queue->backlog() != 0)
+						return true;
+				}
+			}
+			return false;
+		}
+
+		// High priority chores queued in the set, the thieves search the high lanes first while there are some
+		int highQueued() const
+		{
+			return m_highQueued.load(std::memory_order_relaxed);
+		}
+
+		void queuedHigh(int delta)
+		{
+			m_highQueued.fetch_add(delta, std::memory_order_relaxed);
+		}
+
+		// Steals on behalf of thief, chores moved along with the returned one land in its queue. The
+		// high lanes of the victims are searched on their own first while any of them holds a chore.
+		WorkChoreBase * tryRandomSteal(WorkStealingQueue *&lastTarget, WorkStealingQueue *thief, bool highOnly = false)
+		{
+			WorkChoreBase *p = nullptr;
+			if (highOnly || highQueued() > 0)
+				p = search(lastTarget, thief, true);
+			if (p == nullptr && !highOnly)
+				p = search(lastTarget, thief, false);
+			return p;
+		}
+
+	private:
+		WorkChoreBase * search(WorkStealingQueue *&lastTarget, WorkStealingQueue *thief, bool highOnly)
+		{
+			unsigned int homeNode = thief->m_node;
+			StealRandom &randGen = thief->randomGen;
+			WorkChoreBase * p = lastTarget->tryStealBatch(thief, highOnly);
+			_EXP_TELEMETRY_ONLY(size_t attempts = 1);
+
+			int retry = LocalStealAttempts + (m_nodeCount > 1 ? RemoteStealAttempts : 0);
+			for (int attempt = 0; p == nullptr && attempt < retry; ++attempt)
+			{
+				unsigned int node = homeNode;
+				if (attempt >= LocalStealAttempts)
+					node = (homeNode + 1 + randGen() % (m_nodeCount - 1)) % m_nodeCount;
+
+				if (auto curTarget = pickVictim(node, randGen))
+				{
+					p = curTarget->tryStealBatch(thief, highOnly);
 					lastTarget = curTarget;
+					_EXP_TELEMETRY_ONLY(++attempts);
 				}
 			}
+			_EXP_TELEMETRY_ONLY(_Telemetry_steal(attempts, p != nullptr));
+
+			if (p != nullptr)
+			{
+				auto &home = m_nodes[homeNode];
+				if (lastTarget->m_node == homeNode)
+					home.m_localSteals.fetch_add(1, std::memory_order_relaxed);
+				else
+					home.m_remoteSteals.fetch_add(1, std::memory_order_relaxed);
+			}
 
 			return p;
 		}
 	};
 
-	WorkStealingQueueSet g_wsqSet;
-	std::atomic<size_t> WorkStealingQueue::s_threadPoolRunning = 0;
-	size_t WorkStealingQueue::s_concurrencyLevel = get_hardware_concurrency() * 2;
-	__declspec(thread) WorkStealingQueue * tls_threadLocalQueue = 0;
+	std::atomic<unsigned int> g_concurrencyLimit(0);
 
+	// The queues of the threads running in an arena and the pool threads injected for them. The workers
+	// of an arena steal from its queues only, so the chores of one arena neither wait behind nor take the
+	// threads of another. The threads outside of any task_arena run in the default arena.
+	class WorkArena
+	{
+		static size_t s_defaultConcurrencyLevel;
+	public:
+		WorkStealingQueueSet queues;
+		std::atomic<size_t> threadPoolRunning; // the parked workers included
+		std::atomic<size_t> threadPoolSearching; // workers looking for a victim
+		EventCount idle; // the parked workers
+		std::atomic<bool> retiring; // set by destroy_arena and shutdown
+		std::atomic<size_t> keepWarm; // workers kept parked past IdleRetireMs, see prewarm
+		std::atomic<size_t> warmWorkers; // the workers that claimed one of them
+		const unsigned int maxConcurrency; // 0 for the default arena
+
+		explicit WorkArena(unsigned int concurrency) : threadPoolRunning(0), threadPoolSearching(0), retiring(false), keepWarm(0), warmWorkers(0),
+			maxConcurrency(concurrency)
+		{
+		}
+
+		// a worker about to retire idle, true if it stays parked instead
+		bool claimWarm()
+		{
+			size_t warm = warmWorkers.load(std::memory_order_relaxed);
+			while (warm < keepWarm.load(std::memory_order_relaxed))
+			{
+				if (warmWorkers.compare_exchange_weak(warm, warm + 1, std::memory_order_relaxed))
+					return true;
+			}
+			return false;
+		}
+
+		// injects workers from a queue of the calling thread until the arena has the count, see prewarm
+		void injectWorkers(WorkStealingQueue *queue, size_t workers)
+		{
+			for (size_t running = threadPoolRunning.load(); running < workers; ++running)
+				queue->injectThread();
+		}
+
+		// wakes the parked workers and waits for every worker to retire
+		void retireWorkers()
+		{
+			retiring.store(true);
+			idle.notify(static_cast<size_t>(-1));
+			while (threadPoolRunning.load() != 0)
+				yield();
+		}
 
-	inline WorkChoreBase *WorkChoreBase::tryStealNextChore()
+		// Pool threads at most: the concurrency of the arena, lowered to the limit of set_concurrency_limit,
+		// twice the hardware concurrency in the default arena without a limit
+		size_t concurrencyLevel() const
+		{
+			const unsigned int limit = g_concurrencyLimit.load(std::memory_order_relaxed);
+			if (maxConcurrency != 0 && (limit == 0 || maxConcurrency < limit))
+				return maxConcurrency;
+			return limit != 0 ? limit : s_defaultConcurrencyLevel;
+		}
+
+		// returns nullptr when out of memory
+		WorkStealingQueue *alloc()
+		{
+			auto queue = queues.alloc();
+			if (queue != nullptr)
+				queue->m_arena = this;
+			return queue;
+		}
+	};
+
+	size_t WorkArena::s_defaultConcurrencyLevel = get_hardware_concurrency() * 2;
+	WorkArena g_defaultArena(0);
+	__declspec(thread) WorkArena * tls_currentArena = nullptr; // nullptr in the default arena
+	__declspec(thread) WorkStealingQueue * tls_threadLocalQueue = 0;
+	__declspec(thread) unsigned int tls_lane = _Normal_lane;
+
+	inline WorkArena &currentArena()
 	{
-		return m_next.exchange(nullptr);
+		auto arena = tls_currentArena;
+		return arena != nullptr ? *arena : g_defaultArena;
 	}
 
-	inline bool WorkChoreBase::tryClaimThisChore()
+	inline void WorkStealingQueue::injectThread()
 	{
-		if (m_prev && m_prev->tryStealNextChore())
-			return true;
-		else
+		if (m_wsqStatus != QueueScheduled)
 		{
-			// Last chore on the workstealing queue cannot be claimed.
-			// We have to steal it
-			return getWorkStealingQueue()->tryStealChore(true) != nullptr;
+			if (m_wsqStatus == QueueCreated)
+				schedule_chore(this);
+			else
+				reschedule();
+			m_wsqStatus = QueueScheduled;
 		}
+		else
+			reschedule();
+
+		++m_arena->threadPoolRunning;
+		_EXP_TELEMETRY_ONLY(_Telemetry_thread_injected());
 	}
 
+	inline void WorkStealingQueue::queuedHigh(int delta)
+	{
+		m_arena->queues.queuedHigh(delta);
+	}
+
+	inline void WorkStealingQueue::wakeWorkers()
+	{
+		size_t queued = backlog();
+		if (queued == 0)
+			return;
+
+		// A parked worker costs a wake where an injected one costs a threadpool submission. The
+		// searching workers find the chores on their own. The parked workers count as running.
+		// The fence orders the push before the counts, see EventCount.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		size_t wanted = 1 + queued / RampUpBacklog;
+		const size_t searching = m_arena->threadPoolSearching.load(std::memory_order_relaxed);
+		if (wanted > searching)
+			wanted -= m_arena->idle.notify(wanted - searching);
+
+		const size_t level = m_arena->concurrencyLevel();
+		size_t running = m_arena->threadPoolRunning.load();
+		if (running >= level)
+			return;
+
+		wanted = (std::min)(wanted, level - running);
+		while (wanted-- != 0)
+			injectThread();
+	}
 
 	inline WorkStealingQueue *createWorkStealingQueueOnCurrentThread()
 	{
-		auto queue = g_wsqSet.alloc();
+		auto queue = currentArena().alloc();
 		tls_threadLocalQueue = queue;
 		return queue;
 	}
@@ -323,27 +859,379 @@ namespace details
 		if (p != nullptr)
 		{
 			tls_threadLocalQueue = nullptr;
-			g_wsqSet.free(p);
+			p->m_arena->queues.free(p);
+		}
+	}
+
+	// Waiting threads run stolen chores instead of going idle. A helped chore may wait and
+	// help again, the depth cap keeps the stack of such a thread bounded.
+	const int MaximalHelpDepth = 8;
+	__declspec(thread) int tls_helpDepth = 0;
+
+	inline bool WorkStealingQueue::helpWithStolenChore()
+	{
+		if (tls_helpDepth >= MaximalHelpDepth)
+			return false;
+
+		// chores moved here by an earlier batch steal come first
+		auto chore = pop();
+		if (chore == nullptr)
+		{
+			auto target = this;
+			chore = m_arena->queues.tryRandomSteal(target, this);
+		}
+		if (chore == nullptr)
+			return false;
+
+		++tls_helpDepth;
+		chore->run(true);
+		--tls_helpDepth;
+		return true;
+	}
+
+	inline bool WorkStealingQueue::runHighLane()
+	{
+		bool ran = false;
+		while (tls_helpDepth < MaximalHelpDepth && m_arena->queues.highQueued() > 0)
+		{
+			auto chore = pop(_High_lane);
+			if (chore == nullptr)
+			{
+				auto target = this;
+				chore = m_arena->queues.tryRandomSteal(target, this, true);
+			}
+			if (chore == nullptr)
+				break;
+
+			++tls_helpDepth;
+			chore->run(true);
+			--tls_helpDepth;
+			ran = true;
+		}
+		return ran;
+	}
+
+	_EXP_IMPL unsigned int __cdecl _Exchange_thread_lane(unsigned int _Lane) _NOEXCEPT
+	{
+		auto previous = tls_lane;
+		tls_lane = _Lane;
+		return previous;
+	}
+
+	_EXP_IMPL bool __cdecl _Yield_to_high_lane()
+	{
+		// a high chore doesn't yield to the others, and a thread without a queue runs no chore
+		auto queue = tls_threadLocalQueue;
+		return tls_lane == _Normal_lane && queue != nullptr && queue->runHighLane();
+	}
+
+	_EXP_IMPL bool __cdecl help_with_stolen_chore()
+	{
+		auto queue = tls_threadLocalQueue;
+		return queue != nullptr && queue->helpWithStolenChore();
+	}
+
+	// On a hybrid machine a worker of an efficiency core searching along with other workers lets them
+	// steal first, the chunks split off by the auto and dynamic partitioners go to the faster cores
+	const int EfficiencyStealBackoff = 1024;
+
+	inline void stealBackoff(const WorkArena &arena)
+	{
+		if (arena.threadPoolSearching.load(std::memory_order_relaxed) > 1 && _On_efficiency_core())
+		{
+			for (int spin = 0; spin < EfficiencyStealBackoff; ++spin)
+				YieldProcessor();
 		}
 	}
 
+	// A worker out of chores keeps searching for the spin budget, then parks on the eventcount of its
+	// arena until chores are pushed. It retires when the arena goes away, when the arena has more
+	// workers than its concurrency level, or after IdleRetireMs parked without a wake unless it is
+	// one of the workers prewarm keeps.
+	std::atomic<unsigned int> g_spinBudgetUs(50);
+	const DWORD IdleRetireMs = 2000;
+
+	inline long long ticksNow()
+	{
+		LARGE_INTEGER now;
+		::QueryPerformanceCounter(&now);
+		return now.QuadPart;
+	}
+
+	inline long long ticksPerSecond()
+	{
+		static const long long frequency = []
+		{
+			LARGE_INTEGER value;
+			::QueryPerformanceFrequency(&value);
+			return value.QuadPart;
+		}();
+		return frequency;
+	}
+
+	// returns nullptr when the worker retires
+	inline WorkChoreBase *findChore(WorkArena &arena, WorkStealingQueue *curQueue, WorkStealingQueue *&lastTarget, bool &warm)
+	{
+		long long deadline = 0;
+		for (;;)
+		{
+			++arena.threadPoolSearching;
+			_EXP_TELEMETRY_ONLY(auto searchStart = _Cutoff_clock_ps());
+			_EXP_TRACE_ONLY(auto searchTrace = _Trace_begin());
+			stealBackoff(arena);
+			auto chore = arena.queues.tryRandomSteal(lastTarget, curQueue);
+			_EXP_TRACE_ONLY(_Trace_end(searchTrace, "steal", 0));
+			_EXP_TELEMETRY_ONLY(_Telemetry_idle(_Cutoff_clock_ps() - searchStart));
+			--arena.threadPoolSearching;
+
+			if (chore != nullptr)
+				return chore;
+			if (arena.retiring.load() || arena.threadPoolRunning.load(std::memory_order_relaxed) > arena.concurrencyLevel())
+				return nullptr;
+
+			const long long now = ticksNow();
+			if (deadline == 0)
+				deadline = now + ticksPerSecond() * g_spinBudgetUs.load(std::memory_order_relaxed) / 1000000;
+			if (now < deadline)
+			{
+				YieldProcessor();
+				continue;
+			}
+
+			// Announced, one more look at every queue: a chore pushed meanwhile either shows up
+			// here or its push wakes the worker
+			const unsigned int key = arena.idle.prepareWait();
+			if (arena.queues.anyQueued() || arena.retiring.load())
+			{
+				arena.idle.cancelWait();
+				continue;
+			}
+
+			_EXP_TELEMETRY_ONLY(_Telemetry_park());
+			_EXP_TELEMETRY_ONLY(auto parkStart = _Cutoff_clock_ps());
+			_EXP_TRACE_ONLY(auto parkTrace = _Trace_begin());
+			_Scheduler_block_begin();
+			const bool woken = arena.idle.commitWait(key, IdleRetireMs);
+			_Scheduler_block_end();
+			_EXP_TRACE_ONLY(_Trace_end(parkTrace, "park", 0));
+			_EXP_TELEMETRY_ONLY(_Telemetry_idle(_Cutoff_clock_ps() - parkStart));
+			if (!woken && !warm)
+				warm = arena.claimWarm();
+			if (!woken && !warm)
+				return nullptr;
+
+			// a new spin budget after a wake
+			deadline = 0;
+		}
+	}
+
+	// The worker runs in the arena of the queue that injected it, and steals from its queues only
 	inline void WorkStealingQueue::invoke()
 	{
+		auto arena = m_arena;
+		auto previousArena = tls_currentArena;
+		tls_currentArena = arena == &g_defaultArena ? nullptr : arena;
+
 		auto curQueue = createWorkStealingQueueOnCurrentThread();
-		if (curQueue == nullptr)
-			return;
+		if (curQueue != nullptr)
+		{
+			if (arena->keepWarm.load(std::memory_order_relaxed) != 0)
+				_Prewarm_thread_storage();
+
+			_EXP_TRACE_ONLY(auto workerTrace = _Trace_begin());
+			auto myQueue = this;
+			bool warm = false;
+			for (;;)
+			{
+				auto chore = curQueue->pop();
+				if (chore == nullptr)
+					chore = findChore(*arena, curQueue, myQueue, warm);
+				if (chore == nullptr)
+					break;
+				chore->run(true);
+			}
+			_EXP_TRACE_ONLY(_Trace_end(workerTrace, "worker", 0));
+			freeWorkStealingQueueOnCurrentThread();
+
+			if (warm)
+				--arena->warmWorkers;
+			if (arena->retiring.load())
+				_Release_thread_storage();
+		}
+
+		tls_currentArena = previousArena;
+		// the last access to the arena, destroy_arena waits for it
+		--arena->threadPoolRunning;
+	}
+
+	// The limit of set_concurrency_limit, or the concurrency of the arena of the calling thread when lower
+	_EXP_IMPL unsigned int __cdecl _Concurrency_limit() _NOEXCEPT
+	{
+		const unsigned int limit = g_concurrencyLimit.load(std::memory_order_relaxed);
+		const WorkArena *arena = tls_currentArena;
+		if (arena != nullptr && (limit == 0 || arena->maxConcurrency < limit))
+			return arena->maxConcurrency;
+		return limit;
+	}
+
+	_EXP_IMPL size_t __cdecl idleWorkerCount()
+	{
+		const WorkArena &arena = currentArena();
+		size_t running = arena.threadPoolRunning.load(std::memory_order_relaxed);
+		size_t idle = arena.threadPoolSearching.load(std::memory_order_relaxed);
+		const size_t level = arena.concurrencyLevel();
+		if (running < level)
+			idle += level - running;
+		return idle;
+	}
+
+	// The workers of a live task_arena may keep pool threads until it is destroyed
+	std::atomic<size_t> g_taskArenas(0);
 
-		auto myQueue = this;
-		while (auto chore = g_wsqSet.tryRandomSteal(myQueue, curQueue->randomGen))
+	_EXP_IMPL WorkArena * __cdecl create_arena(unsigned int _Max_concurrency)
+	{
+		if (_Max_concurrency == 0)
+			_Max_concurrency = (std::max)(std::thread::hardware_concurrency(), 1u);
+		auto arena = new (std::nothrow) WorkArena(_Max_concurrency);
+		if (arena != nullptr)
+			++g_taskArenas;
+		return arena;
+	}
+
+	_EXP_IMPL void __cdecl destroy_arena(WorkArena *_Arena)
+	{
+		// Workers injected for the arena may still be looking for chores, or parked
+		_Arena->retireWorkers();
+		delete _Arena;
+		--g_taskArenas;
+	}
+
+	// Injects workers into the arena up to the count, and waits a while for them to allocate their
+	// queue and storage and park. Returns the workers of the arena.
+	inline size_t prewarmArena(WorkArena &arena, size_t workers)
+	{
+		workers = (std::min)(workers, arena.concurrencyLevel());
+		_Scheduler_prewarm(static_cast<unsigned int>(workers));
+		_Prewarm_thread_storage();
+
+		size_t keep = arena.keepWarm.load();
+		while (keep < workers && !arena.keepWarm.compare_exchange_weak(keep, workers))
 		{
-			curQueue->reset();
-			chore->run(true);
 		}
-		freeWorkStealingQueueOnCurrentThread();
-		--WorkStealingQueue::s_threadPoolRunning;
+
+		// the workers are injected from a queue of the calling thread, returned to the pool of the
+		// set for its first TaskGroup unless it had one already
+		auto queue = tls_threadLocalQueue;
+		const bool ownQueue = queue == nullptr;
+		if (ownQueue)
+			queue = createWorkStealingQueueOnCurrentThread();
+		if (queue == nullptr)
+			return arena.threadPoolRunning.load();
+
+		arena.injectWorkers(queue, workers);
+
+		const long long deadline = ticksNow() + ticksPerSecond();
+		while (arena.idle.waiters() < workers && ticksNow() < deadline)
+			yield();
+
+		if (ownQueue)
+			freeWorkStealingQueueOnCurrentThread();
+		return arena.threadPoolRunning.load();
+	}
+
+	_EXP_IMPL unsigned int __cdecl arena_concurrency(const WorkArena *_Arena)
+	{
+		return _Arena->maxConcurrency;
+	}
+
+	_EXP_IMPL bool __cdecl enter_arena(WorkArena *_Arena, _Arena_frame &_Frame)
+	{
+		if (tls_currentArena == _Arena)
+			return false;
+
+		// The TaskGroups in the arena take queues of its own
+		_Frame._Arena = tls_currentArena;
+		_Frame._Queue = tls_threadLocalQueue;
+		tls_currentArena = _Arena;
+		tls_threadLocalQueue = nullptr;
+		return true;
+	}
+
+	_EXP_IMPL void __cdecl leave_arena(const _Arena_frame &_Frame)
+	{
+		// the TaskGroups of the arena released their queue with them
+		_ASSERT(tls_threadLocalQueue == nullptr);
+		tls_currentArena = _Frame._Arena;
+		tls_threadLocalQueue = _Frame._Queue;
+	}
+
+	std::atomic<unsigned int> g_nextWorkerSlot(1);
+	__declspec(thread) unsigned int tls_workerSlot = 0;
+
+	_EXP_IMPL unsigned int __cdecl current_worker_slot()
+	{
+		if (tls_workerSlot == 0)
+			tls_workerSlot = g_nextWorkerSlot.fetch_add(1, std::memory_order_relaxed);
+		return tls_workerSlot;
+	}
+
+	_EXP_IMPL unsigned int __cdecl get_numa_node_count()
+	{
+		return g_defaultArena.queues.nodeCount();
+	}
+
+	_EXP_IMPL bool __cdecl get_steal_counters(unsigned int _Node, size_t &_Local_steals, size_t &_Remote_steals)
+	{
+		return g_defaultArena.queues.stealCounters(_Node, _Local_steals, _Remote_steals);
+	}
+
+	// The group of the chore the thread runs, the parent of the groups it creates
+	__declspec(thread) TaskGroup * tls_runningGroup = nullptr;
+
+	// Drops a reference to a node, and to the nodes of its chain that no group reads any more
+	static void releaseCancellationNode(CancellationNode *node)
+	{
+		while (node != nullptr && node->references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			auto parent = node->parent;
+			delete node;
+			node = parent;
+		}
 	}
 
-	_EXP_IMPL TaskGroup::TaskGroup() : m_pendingChore(MaximalChoreNum), m_head(nullptr), m_tail(nullptr), m_choreCounter(0), m_needReleaseWSQ(false)
+	// The creating thread runs a chore of the group, which stays alive meanwhile, but other threads may create
+	// groups in the chores at the same time.
+	CancellationNode *TaskGroup::acquireNode()
+	{
+		auto node = m_node.load(std::memory_order_acquire);
+		if (node == nullptr)
+		{
+			auto made = new CancellationNode;
+			made->canceled.store(false, std::memory_order_relaxed);
+			made->references.store(1, std::memory_order_relaxed); // the group's own
+			made->parent = m_parent;
+			if (m_parent != nullptr)
+				m_parent->references.fetch_add(1, std::memory_order_relaxed);
+
+			if (m_node.compare_exchange_strong(node, made, std::memory_order_seq_cst))
+			{
+				node = made;
+				if (m_canceling.load(std::memory_order_seq_cst))
+					node->canceled.store(true, std::memory_order_relaxed);
+			}
+			else
+			{
+				releaseCancellationNode(made);
+			}
+		}
+
+		node->references.fetch_add(1, std::memory_order_relaxed);
+		return node;
+	}
+
+	_EXP_IMPL TaskGroup::TaskGroup(bool inheritCancellation) : m_parent(tls_runningGroup != nullptr ? tls_runningGroup->acquireNode() : nullptr),
+		m_lane(tls_lane), m_choreCounter(0), m_needReleaseWSQ(false), m_inheritCancellation(inheritCancellation), m_canceling(false), m_node(nullptr),
+		m_pendingChore(MaximalChoreNum)
 	{
 		// This TaskGroup belong to workstealing queue on this thread
 		m_queue = tls_threadLocalQueue;
@@ -352,7 +1240,10 @@ namespace details
 			m_needReleaseWSQ = true;
 			m_queue = createWorkStealingQueueOnCurrentThread();
 			if (!m_queue)
+			{
+				releaseCancellationNode(m_parent);
 				throw std::bad_alloc();
+			}
 		}
 	}
 
@@ -360,53 +1251,65 @@ namespace details
 	{
 		_ASSERT(work.m_taskGroup == nullptr);
 		work.m_taskGroup = this;
+		work.m_scratchResource = _Thread_scratch_resource();
+		work.m_lane = m_lane;
+		_EXP_TELEMETRY_ONLY(work.m_scheduledPs = _Cutoff_clock_ps());
+#if _EXP_TELEMETRY || _EXP_TRACE
+		work.m_algorithm = _Current_algorithm();
+#endif
 
-		if (m_head)
-		{
-			m_tail = &work;
-		}
-		else
-		{
-			m_head = m_tail = &work;
-		}
+		if (++m_choreCounter >= MaximalChoreNum)
+			throw bad_alloc();
 
 		// push work item to current workstealing queue
 		m_queue->schedule(&work);
-
-		if (++m_choreCounter >= MaximalChoreNum)
-			throw bad_alloc();
 	}
 
 	_EXP_IMPL void __cdecl TaskGroup::wait()
 	{
-		if (m_tail == nullptr)
+		if (m_choreCounter == 0)
 			return;
 
-		auto p = m_tail;
+		// Chores of this group sit on top of its lane of the owner's queue, anything older
+		// belongs to an outer TaskGroup and is put back.
 		int inlinedChore = 0;
-		while (p->tryClaimThisChore())
+		while (inlinedChore != m_choreCounter)
 		{
-			++inlinedChore;
+			auto p = m_queue->pop(m_lane);
+			if (p == nullptr)
+				break;
 
-			// correct the header for potential inline in user function
-			m_queue->setTopChoreBack(p->m_prev);
+			if (p->m_taskGroup != this)
+			{
+				m_queue->push(p);
+				break;
+			}
 
+			++inlinedChore;
 			p->run(false);
-
-			if (p == m_head)
-				break;
-			p = p->m_prev;
 		}
 
 		if (inlinedChore != m_choreCounter && (m_pendingChore -= MaximalChoreNum - m_choreCounter + inlinedChore) > 0)
 		{
+			// The rest was stolen, help the other queues until the thieves are done
+			_EXP_TRACE_ONLY(auto waitTrace = _Trace_begin());
+			while (m_pendingChore.load() > 0 && m_queue->helpWithStolenChore())
+			{
+			}
+			_EXP_TELEMETRY_ONLY(auto waitStart = _Cutoff_clock_ps());
 			m_event.wait();
+			_EXP_TELEMETRY_ONLY(_Telemetry_idle(_Cutoff_clock_ps() - waitStart));
+			_EXP_TRACE_ONLY(_Trace_end(waitTrace, "wait", 0));
 		}
 
-		// correct the header for next taskgroup
-		m_queue->setTopChoreBack(m_head->m_prev);
+		// A TaskGroup is waited for once, the destructor won't wait again
+		m_choreCounter = 0;
+	}
 
-		m_head = m_tail = nullptr;
+	_EXP_IMPL bool __cdecl _Current_task_group_canceling() _NOEXCEPT
+	{
+		auto group = tls_runningGroup;
+		return group != nullptr && group->is_canceling();
 	}
 
 	_EXP_IMPL TaskGroup::~TaskGroup()
@@ -414,6 +1317,8 @@ namespace details
 		wait();
 		if (m_needReleaseWSQ)
 			freeWorkStealingQueueOnCurrentThread();
+		releaseCancellationNode(m_node.load(std::memory_order_relaxed));
+		releaseCancellationNode(m_parent);
 	}
 
 	// isAsync indicates whether the chore is called by
@@ -422,16 +1327,78 @@ namespace details
 	{
 		// exception handling is not supported here.
 		// we require functor nothrow
-		userFunc();
+		// The group is read first: the function may schedule the chore again,
+		// in another group, before it returns.
+		auto taskGroup = m_taskGroup;
+		auto previousGroup = tls_runningGroup;
+		tls_runningGroup = taskGroup;
+		auto previousScratch = _Exchange_thread_scratch_resource(m_scratchResource);
+		// the algorithms the chore calls schedule in its lane unless they set their own
+		auto previousLane = _Exchange_thread_lane(m_lane);
+		_EXP_TELEMETRY_ONLY(_Telemetry_chore_executed());
+		_EXP_TELEMETRY_ONLY(_Telemetry_queue_delay(m_lane, _Cutoff_clock_ps() - m_scheduledPs));
+#if _EXP_TELEMETRY || _EXP_TRACE
+		// a nested call of the same algorithm is part of the one that scheduled the chore
+		auto previousAlgorithm = _Exchange_current_algorithm(m_algorithm);
+#endif
+		// the chores of a canceled group complete without running
+		if (!taskGroup->dropsChores())
+		{
+			_EXP_TRACE_ONLY(auto choreTrace = _Trace_begin());
+			userFunc();
+			_EXP_TRACE_ONLY(_Trace_end(choreTrace, "task", 0));
+		}
+#if _EXP_TELEMETRY || _EXP_TRACE
+		_Exchange_current_algorithm(previousAlgorithm);
+#endif
+		_Exchange_thread_lane(previousLane);
+		_Exchange_thread_scratch_resource(previousScratch);
+		tls_runningGroup = previousGroup;
 
 		if (isAsync)
-			m_taskGroup->finishAsync();
+			taskGroup->finishAsync();
 	}
 
-	inline WorkStealingQueue *WorkChoreBase::getWorkStealingQueue()
-	{
-		_ASSERT(m_taskGroup);
-		return m_taskGroup->m_queue;
-	}
 	}
+
+_EXP_IMPL unsigned int __cdecl set_concurrency_limit(unsigned int _Threads) _NOEXCEPT
+{
+	return details::g_concurrencyLimit.exchange(_Threads, std::memory_order_relaxed);
+}
+
+_EXP_IMPL unsigned int __cdecl concurrency_limit() _NOEXCEPT
+{
+	return details::g_concurrencyLimit.load(std::memory_order_relaxed);
+}
+
+_EXP_IMPL unsigned int __cdecl prewarm(unsigned int _Workers) _NOEXCEPT
+{
+	if (_Workers == 0)
+		_Workers = (std::max)(std::thread::hardware_concurrency(), 1u);
+	return static_cast<unsigned int>(details::prewarmArena(details::currentArena(), _Workers));
+}
+
+_EXP_IMPL void __cdecl shutdown() _NOEXCEPT
+{
+	auto &arena = details::g_defaultArena;
+	arena.keepWarm.store(0);
+	arena.retireWorkers();
+	arena.retiring.store(false);
+	arena.queues.trim();
+	details::_Release_thread_storage();
+
+	// the pool threads of the workers of a task_arena may still be in use
+	if (details::g_taskArenas.load() == 0)
+		details::_Scheduler_shutdown();
+}
+
+_EXP_IMPL unsigned int __cdecl set_worker_spin_budget(unsigned int _Microseconds) _NOEXCEPT
+{
+	return details::g_spinBudgetUs.exchange(_Microseconds, std::memory_order_relaxed);
+}
+
+_EXP_IMPL unsigned int __cdecl worker_spin_budget() _NOEXCEPT
+{
+	return details::g_spinBudgetUs.load(std::memory_order_relaxed);
+}
 _PSTL_NS1_END // std::experimental::parallel
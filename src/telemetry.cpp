@@ -0,0 +1,245 @@
+#include <atomic>
+#include <cstring>
+#include <Windows.h>
+#include <experimental/impl/algorithm_impl.h>
+
+_PSTL_NS1_BEGIN
+
+namespace details {
+	namespace
+	{
+		// The counters of the worker slots, one cache line each. A slot is only updated by its
+		// thread, the ones past the last slot tracked share it.
+		const unsigned int _Worker_slot_count = 256;
+
+		struct __declspec(align(64)) _Worker_counters
+		{
+			atomic<size_t> _Chores;
+			atomic<size_t> _Steal_attempts;
+			atomic<size_t> _Steals;
+			atomic<unsigned long long> _Idle_ps;
+			atomic<size_t> _Started[_Lane_count]; // per priority lane
+			atomic<unsigned long long> _Queue_delay_ps[_Lane_count];
+			atomic<unsigned long long> _Max_queue_delay_ps[_Lane_count];
+		};
+
+		_Worker_counters _Workers[_Worker_slot_count];
+		atomic<size_t> _Threads_injected;
+		atomic<size_t> _Inline_fallbacks;
+		atomic<size_t> _Worker_parks;
+
+		// Algorithm sites, pushed on the front and never removed
+		atomic<_Algorithm_site *> _Algorithm_sites;
+		__declspec(thread) const char * _Thread_algorithm;
+
+		_Worker_counters &_Current_worker_counters()
+		{
+			return _Workers[(std::min)(current_worker_slot(), _Worker_slot_count) - 1];
+		}
+
+		void _Fill_worker_statistics(worker_statistics &_Stats, unsigned int _Slot, const _Worker_counters &_Counters)
+		{
+			_Stats.slot = _Slot;
+			_Stats.chores_executed = _Counters._Chores.load(std::memory_order_relaxed);
+			_Stats.steal_attempts = _Counters._Steal_attempts.load(std::memory_order_relaxed);
+			_Stats.steals = _Counters._Steals.load(std::memory_order_relaxed);
+			_Stats.idle_ns = _Counters._Idle_ps.load(std::memory_order_relaxed) / 1000;
+		}
+
+		void _Add_priority_statistics(priority_statistics &_Stats, unsigned int _Lane, const _Worker_counters &_Counters)
+		{
+			_Stats.chores_started += _Counters._Started[_Lane].load(std::memory_order_relaxed);
+			_Stats.queue_delay_ns += _Counters._Queue_delay_ps[_Lane].load(std::memory_order_relaxed) / 1000;
+			_Stats.max_queue_delay_ns = (std::max)(_Stats.max_queue_delay_ns, _Counters._Max_queue_delay_ps[_Lane].load(std::memory_order_relaxed) / 1000);
+		}
+
+		bool _Has_activity(const worker_statistics &_Stats)
+		{
+			return _Stats.chores_executed != 0 || _Stats.steal_attempts != 0 || _Stats.idle_ns != 0;
+		}
+	}
+
+	_EXP_IMPL void __cdecl _Register_algorithm_site(_Algorithm_site *_Site, const char *_Name)
+	{
+		_Site->_Name = _Name;
+		_Site->_Next = _Algorithm_sites.load(std::memory_order_relaxed);
+		while (!_Algorithm_sites.compare_exchange_weak(_Site->_Next, _Site, std::memory_order_release, std::memory_order_relaxed))
+		{
+		}
+	}
+
+	_EXP_IMPL const char * __cdecl _Exchange_current_algorithm(const char *_Name) _NOEXCEPT
+	{
+		const char *_Previous = _Thread_algorithm;
+		_Thread_algorithm = _Name;
+		return _Previous;
+	}
+
+	_EXP_IMPL const char * __cdecl _Current_algorithm() _NOEXCEPT
+	{
+		return _Thread_algorithm;
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_chore_executed() _NOEXCEPT
+	{
+		_Current_worker_counters()._Chores.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_steal(size_t _Attempts, bool _Found) _NOEXCEPT
+	{
+		auto &_Counters = _Current_worker_counters();
+		_Counters._Steal_attempts.fetch_add(_Attempts, std::memory_order_relaxed);
+		if (_Found)
+			_Counters._Steals.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_idle(unsigned long long _Elapsed_ps) _NOEXCEPT
+	{
+		_Current_worker_counters()._Idle_ps.fetch_add(_Elapsed_ps, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_thread_injected() _NOEXCEPT
+	{
+		_Threads_injected.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_inline_fallback() _NOEXCEPT
+	{
+		_Inline_fallbacks.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_park() _NOEXCEPT
+	{
+		_Worker_parks.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	_EXP_IMPL void __cdecl _Telemetry_queue_delay(unsigned int _Lane, unsigned long long _Elapsed_ps) _NOEXCEPT
+	{
+		auto &_Counters = _Current_worker_counters();
+		_Counters._Started[_Lane].fetch_add(1, std::memory_order_relaxed);
+		_Counters._Queue_delay_ps[_Lane].fetch_add(_Elapsed_ps, std::memory_order_relaxed);
+
+		// the slots past the last one tracked share their counters
+		unsigned long long _Max = _Counters._Max_queue_delay_ps[_Lane].load(std::memory_order_relaxed);
+		while (_Elapsed_ps > _Max && !_Counters._Max_queue_delay_ps[_Lane].compare_exchange_weak(_Max, _Elapsed_ps, std::memory_order_relaxed))
+		{
+		}
+	}
+}
+
+_EXP_IMPL bool __cdecl telemetry_enabled() _NOEXCEPT
+{
+	return _EXP_TELEMETRY != 0;
+}
+
+_EXP_IMPL void __cdecl get_scheduler_statistics(scheduler_statistics& _Stats) _NOEXCEPT
+{
+	memset(&_Stats, 0, sizeof(_Stats));
+	for (unsigned int _Slot = 0; _Slot < details::_Worker_slot_count; ++_Slot)
+	{
+		worker_statistics _Worker;
+		details::_Fill_worker_statistics(_Worker, _Slot + 1, details::_Workers[_Slot]);
+		_Stats.workers.chores_executed += _Worker.chores_executed;
+		_Stats.workers.steal_attempts += _Worker.steal_attempts;
+		_Stats.workers.steals += _Worker.steals;
+		_Stats.workers.idle_ns += _Worker.idle_ns;
+
+		details::_Add_priority_statistics(_Stats.normal_priority, details::_Normal_lane, details::_Workers[_Slot]);
+		details::_Add_priority_statistics(_Stats.high_priority, details::_High_lane, details::_Workers[_Slot]);
+	}
+
+	_Stats.threads_injected = details::_Threads_injected.load(std::memory_order_relaxed);
+	_Stats.inline_fallbacks = details::_Inline_fallbacks.load(std::memory_order_relaxed);
+	_Stats.worker_parks = details::_Worker_parks.load(std::memory_order_relaxed);
+}
+
+_EXP_IMPL size_t __cdecl get_worker_statistics(worker_statistics *_Workers, size_t _Capacity) _NOEXCEPT
+{
+	size_t _Num = 0;
+	for (unsigned int _Slot = 0; _Slot < details::_Worker_slot_count; ++_Slot)
+	{
+		worker_statistics _Worker;
+		details::_Fill_worker_statistics(_Worker, _Slot + 1, details::_Workers[_Slot]);
+		if (!details::_Has_activity(_Worker))
+			continue;
+
+		if (_Num < _Capacity)
+			_Workers[_Num] = _Worker;
+		++_Num;
+	}
+	return _Num;
+}
+
+_EXP_IMPL size_t __cdecl get_algorithm_statistics(algorithm_statistics *_Algorithms, size_t _Capacity) _NOEXCEPT
+{
+	// The instantiations of an algorithm have a site each, the entries sum the sites of a name. The
+	// sites are few, a name is looked up among the entries filled so far.
+	size_t _Num = 0;
+	for (auto _Site = details::_Algorithm_sites.load(std::memory_order_acquire); _Site != nullptr; _Site = _Site->_Next)
+	{
+		const size_t _Calls = _Site->_Calls.load(std::memory_order_relaxed);
+		if (_Calls == 0)
+			continue;
+
+		// the names are counted, not only the ones that fit
+		bool _Known = false;
+		for (auto _Other = details::_Algorithm_sites.load(std::memory_order_acquire); _Other != _Site; _Other = _Other->_Next)
+		{
+			if (_Other->_Calls.load(std::memory_order_relaxed) != 0 && strcmp(_Other->_Name, _Site->_Name) == 0)
+			{
+				_Known = true;
+				break;
+			}
+		}
+
+		if (!_Known)
+		{
+			if (_Num < _Capacity)
+			{
+				_Algorithms[_Num].name = _Site->_Name;
+				_Algorithms[_Num].calls = 0;
+				_Algorithms[_Num].total_ns = 0;
+			}
+			++_Num;
+		}
+
+		for (size_t _I = 0; _I < (std::min)(_Num, _Capacity); ++_I)
+		{
+			if (strcmp(_Algorithms[_I].name, _Site->_Name) == 0)
+			{
+				_Algorithms[_I].calls += _Calls;
+				_Algorithms[_I].total_ns += _Site->_Ps.load(std::memory_order_relaxed) / 1000;
+				break;
+			}
+		}
+	}
+	return _Num;
+}
+
+_EXP_IMPL void __cdecl reset_statistics() _NOEXCEPT
+{
+	for (auto &_Counters : details::_Workers)
+	{
+		_Counters._Chores.store(0, std::memory_order_relaxed);
+		_Counters._Steal_attempts.store(0, std::memory_order_relaxed);
+		_Counters._Steals.store(0, std::memory_order_relaxed);
+		_Counters._Idle_ps.store(0, std::memory_order_relaxed);
+		for (unsigned int _Lane = 0; _Lane < details::_Lane_count; ++_Lane)
+		{
+			_Counters._Started[_Lane].store(0, std::memory_order_relaxed);
+			_Counters._Queue_delay_ps[_Lane].store(0, std::memory_order_relaxed);
+			_Counters._Max_queue_delay_ps[_Lane].store(0, std::memory_order_relaxed);
+		}
+	}
+
+	details::_Threads_injected.store(0, std::memory_order_relaxed);
+	details::_Inline_fallbacks.store(0, std::memory_order_relaxed);
+	details::_Worker_parks.store(0, std::memory_order_relaxed);
+
+	for (auto _Site = details::_Algorithm_sites.load(std::memory_order_acquire); _Site != nullptr; _Site = _Site->_Next)
+	{
+		_Site->_Calls.store(0, std::memory_order_relaxed);
+		_Site->_Ps.store(0, std::memory_order_relaxed);
+	}
+}
+_PSTL_NS1_END
@@ -0,0 +1,279 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <Windows.h>
+#include <experimental/impl/algorithm_scheduler.h>
+
+_PSTL_NS1_BEGIN
+namespace details {
+	namespace
+	{
+		// Throughput of a core running two threads against one, the threads of a busy core share it
+		const unsigned int _Smt_throughput_percent = 130;
+
+		// Speed of an efficiency core against a performance core unless set, roughly the gap of the current
+		// hybrid parts at the same clock
+		const unsigned int _Default_efficiency_speed = 60;
+
+		// The logical processors ranked fastest first: the first thread of the cores of the highest efficiency
+		// class, then of the lower classes, then the second threads of the cores and so on. The pool workers are
+		// pinned in that order, and a loop of n threads is weighed as if it ran on the first n.
+		class _Core_topology
+		{
+			struct _Processor
+			{
+				WORD _Group;
+				BYTE _Number;
+				BYTE _Class; // EfficiencyClass, higher is faster
+				unsigned int _Core;
+				unsigned int _Smt_index; // among the threads of its core
+			};
+
+			struct _Core_threads
+			{
+				size_t _First; // in _Mate_ranks
+				size_t _Count;
+			};
+
+			std::vector<_Processor> _Ranked;
+			std::vector<_Core_threads> _Cores;
+			std::vector<unsigned int> _Mate_ranks; // the ranks of the threads of each core
+			std::vector<unsigned char> _Efficient; // by group * 64 + number, 1 for the cores below the highest class
+			BYTE _Top_class;
+			unsigned int _Classes;
+
+			void _Detect()
+			{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+				DWORD _Length = 0;
+				if (::GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &_Length) || ::GetLastError() != ERROR_INSUFFICIENT_BUFFER)
+					return;
+
+				std::unique_ptr<char[]> _Buffer(new char[_Length]);
+				if (!::GetLogicalProcessorInformationEx(RelationProcessorCore, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(_Buffer.get()), &_Length))
+					return;
+
+				std::vector<BYTE> _Seen_classes;
+				unsigned int _Core = 0;
+				for (DWORD _Offset = 0; _Offset < _Length; ++_Core)
+				{
+					auto _Info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX *>(_Buffer.get() + _Offset);
+					_Offset += _Info->Size;
+
+					const PROCESSOR_RELATIONSHIP& _Relation = _Info->Processor;
+#if defined(NTDDI_WIN10)
+					const BYTE _Class = _Relation.EfficiencyClass;
+#else
+					// the byte of EfficiencyClass, reserved in the older SDKs and 0 on the older systems
+					const BYTE _Class = _Relation.Reserved[0];
+#endif
+					if (std::find(_Seen_classes.begin(), _Seen_classes.end(), _Class) == _Seen_classes.end())
+						_Seen_classes.push_back(_Class);
+
+					unsigned int _Smt_index = 0;
+					for (WORD _Group = 0; _Group < _Relation.GroupCount; ++_Group)
+					{
+						const GROUP_AFFINITY& _Affinity = _Relation.GroupMask[_Group];
+						for (BYTE _Number = 0; _Number < sizeof(KAFFINITY) * 8; ++_Number)
+						{
+							if ((_Affinity.Mask & (static_cast<KAFFINITY>(1) << _Number)) == 0)
+								continue;
+
+							_Processor _Proc = { _Affinity.Group, _Number, _Class, _Core, _Smt_index++ };
+							_Ranked.push_back(_Proc);
+						}
+					}
+				}
+
+				_Classes = static_cast<unsigned int>(_Seen_classes.size());
+				if (_Ranked.empty())
+					return;
+				_Top_class = *std::max_element(_Seen_classes.begin(), _Seen_classes.end());
+
+				std::stable_sort(_Ranked.begin(), _Ranked.end(), [](const _Processor& _Left, const _Processor& _Right) {
+					if (_Left._Smt_index != _Right._Smt_index)
+						return _Left._Smt_index < _Right._Smt_index;
+					return _Left._Class > _Right._Class;
+				});
+
+				std::vector<std::vector<unsigned int>> _Ranks_of_core(_Core);
+				for (unsigned int _Rank = 0; _Rank < _Ranked.size(); ++_Rank)
+				{
+					const _Processor& _Proc = _Ranked[_Rank];
+					_Ranks_of_core[_Proc._Core].push_back(_Rank);
+
+					const size_t _Index = _Proc._Group * 64u + _Proc._Number;
+					if (_Efficient.size() <= _Index)
+						_Efficient.resize(_Index + 1);
+					_Efficient[_Index] = _Proc._Class != _Top_class;
+				}
+
+				for (auto& _Ranks : _Ranks_of_core)
+				{
+					_Core_threads _Threads = { _Mate_ranks.size(), _Ranks.size() };
+					_Cores.push_back(_Threads);
+					_Mate_ranks.insert(_Mate_ranks.end(), _Ranks.begin(), _Ranks.end());
+				}
+#endif
+			}
+
+		public:
+			std::atomic<unsigned int> _Efficiency_speed;
+			std::atomic<bool> _Pinned;
+			std::atomic<unsigned int> _Pinning_generation;
+
+			_Core_topology() : _Top_class(0), _Classes(1), _Efficiency_speed(_Default_efficiency_speed), _Pinned(false), _Pinning_generation(0)
+			{
+				try
+				{
+					_Detect();
+				}
+				catch (const std::bad_alloc&)
+				{
+					// taken for a machine of uniform cores
+					_Ranked.clear();
+					_Classes = 1;
+				}
+				if (_Ranked.empty())
+					_Classes = 1;
+			}
+
+			unsigned int _Class_count() const
+			{
+				return _Classes;
+			}
+
+			unsigned int _Processor_count() const
+			{
+				return static_cast<unsigned int>(_Ranked.size());
+			}
+
+			unsigned int _Performance_threads() const
+			{
+				return static_cast<unsigned int>(std::count_if(_Ranked.begin(), _Ranked.end(), [this](const _Processor& _Proc) { return _Proc._Class == _Top_class; }));
+			}
+
+			bool _Hybrid() const
+			{
+				return _Classes > 1 && _Efficiency_speed.load(std::memory_order_relaxed) != 100;
+			}
+
+			unsigned int _Weight(unsigned int _Rank, unsigned int _Threads) const
+			{
+				if (_Rank >= _Ranked.size())
+					return 100;
+
+				const _Processor& _Proc = _Ranked[_Rank];
+				const unsigned int _Speed = _Proc._Class == _Top_class ? 100 : _Efficiency_speed.load(std::memory_order_relaxed);
+
+				// the threads of the core busy with the loop share it
+				const _Core_threads& _Core = _Cores[_Proc._Core];
+				const unsigned int _Busy = static_cast<unsigned int>(std::count_if(_Mate_ranks.begin() + _Core._First, _Mate_ranks.begin() + _Core._First + _Core._Count,
+					[_Threads](unsigned int _Mate) { return _Mate < _Threads; }));
+				if (_Busy <= 1)
+					return _Speed;
+				return (std::max)(_Speed * _Smt_throughput_percent / (100 * _Busy), 1u);
+			}
+
+			bool _Efficient_processor(WORD _Group, BYTE _Number) const
+			{
+				const size_t _Index = _Group * 64u + _Number;
+				return _Index < _Efficient.size() && _Efficient[_Index] != 0;
+			}
+
+			const _Processor *_Processor_of_rank(unsigned int _Rank) const
+			{
+				return _Ranked.empty() ? nullptr : &_Ranked[_Rank % _Ranked.size()];
+			}
+		} _Topology;
+
+		__declspec(thread) bool _Thread_pinned;
+		__declspec(thread) GROUP_AFFINITY _Thread_unpinned_affinity;
+	}
+
+	_EXP_IMPL bool __cdecl _Hybrid_topology(unsigned int _Threads) _NOEXCEPT
+	{
+		return _Threads > 1 && _Threads <= _Topology._Processor_count() && _Topology._Hybrid();
+	}
+
+	_EXP_IMPL unsigned int __cdecl _Thread_weight(unsigned int _Rank, unsigned int _Threads) _NOEXCEPT
+	{
+		return _Topology._Weight(_Rank, _Threads);
+	}
+
+	bool __cdecl _On_efficiency_core()
+	{
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+		if (_Topology._Class_count() <= 1)
+			return false;
+
+		PROCESSOR_NUMBER _Processor;
+		::GetCurrentProcessorNumberEx(&_Processor);
+		return _Topology._Efficient_processor(_Processor.Group, _Processor.Number);
+#else
+		return false;
+#endif
+	}
+
+	unsigned int __cdecl _Worker_pinning_generation()
+	{
+		return _Topology._Pinning_generation.load(std::memory_order_relaxed);
+	}
+
+	unsigned int __cdecl _Apply_worker_pinning(unsigned int _Rank)
+	{
+		const unsigned int _Generation = _Topology._Pinning_generation.load(std::memory_order_acquire);
+#if !defined(WINAPI_FAMILY) || WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
+		auto _Proc = _Topology._Processor_of_rank(_Rank);
+		if (_Topology._Pinned.load(std::memory_order_relaxed) && _Proc != nullptr)
+		{
+			GROUP_AFFINITY _Affinity = {};
+			_Affinity.Group = _Proc->_Group;
+			_Affinity.Mask = static_cast<KAFFINITY>(1) << _Proc->_Number;
+
+			GROUP_AFFINITY _Previous;
+			if (::SetThreadGroupAffinity(::GetCurrentThread(), &_Affinity, &_Previous) && !_Thread_pinned)
+			{
+				_Thread_unpinned_affinity = _Previous;
+				_Thread_pinned = true;
+			}
+		}
+		else if (_Thread_pinned)
+		{
+			::SetThreadGroupAffinity(::GetCurrentThread(), &_Thread_unpinned_affinity, nullptr);
+			_Thread_pinned = false;
+		}
+#else
+		(_Rank);
+#endif
+		return _Generation;
+	}
+}
+
+_EXP_IMPL void __cdecl get_core_topology(core_topology& _Info) _NOEXCEPT
+{
+	const auto& _Topology = details::_Topology;
+	const unsigned int _Processors = _Topology._Processor_count();
+	_Info.efficiency_classes = _Topology._Class_count();
+	_Info.performance_threads = _Processors != 0 ? _Topology._Performance_threads() : (std::max)(std::thread::hardware_concurrency(), 1u);
+	_Info.efficiency_threads = _Processors - (_Processors != 0 ? _Info.performance_threads : 0);
+	_Info.efficiency_speed_percent = _Topology._Efficiency_speed.load(std::memory_order_relaxed);
+	_Info.workers_pinned = _Topology._Pinned.load(std::memory_order_relaxed);
+}
+
+_EXP_IMPL unsigned int __cdecl set_efficiency_core_speed(unsigned int _Percent) _NOEXCEPT
+{
+	if (_Percent == 0)
+		_Percent = details::_Default_efficiency_speed;
+	return details::_Topology._Efficiency_speed.exchange((std::min)(_Percent, 100u), std::memory_order_relaxed);
+}
+
+_EXP_IMPL bool __cdecl set_worker_pinning(bool _Pinned) _NOEXCEPT
+{
+	const bool _Previous = details::_Topology._Pinned.exchange(_Pinned, std::memory_order_relaxed);
+	if (_Previous != _Pinned)
+		details::_Topology._Pinning_generation.fetch_add(1, std::memory_order_release);
+	return _Previous;
+}
+_PSTL_NS1_END // std::experimental::parallel
@@ -0,0 +1,235 @@
+#include <atomic>
+#include <new>
+#include <Windows.h>
+#include <experimental/impl/algorithm_impl.h>
+#include <experimental/impl/trace.h>
+
+#if _EXP_TRACE
+#include <TraceLoggingProvider.h>
+
+// The ETW provider of the spans, ParallelSTL {6cb442c9-842c-45f7-be45-ffe4b63b8d30}
+TRACELOGGING_DEFINE_PROVIDER(_Exp_trace_provider, "ParallelSTL",
+	(0x6cb442c9, 0x842c, 0x45f7, 0xbe, 0x45, 0xff, 0xe4, 0xb6, 0x3b, 0x8d, 0x30));
+#endif
+
+_PSTL_NS1_BEGIN
+
+namespace details {
+#if _EXP_TRACE
+	namespace
+	{
+		// Where the spans go, a span is timed only if one of them takes it
+		const unsigned int _Sink_buffers = 1;
+		const unsigned int _Sink_etw = 2;
+		atomic<unsigned int> _Trace_sinks;
+
+		// The ring buffer of a thread. It is written by its thread only and outlives it: the events
+		// are read once the thread is gone, and a new thread takes the buffer over.
+		struct _Trace_buffer
+		{
+			_Trace_buffer *_Next;
+			atomic<bool> _Owned;
+			atomic<unsigned int> _Generation; // the trace the events belong to
+			atomic<size_t> _Written; // since the trace started, the last _Capacity are kept
+			size_t _Capacity;
+			trace_event *_Events;
+		};
+
+		atomic<_Trace_buffer *> _Trace_buffers;
+		atomic<unsigned int> _Trace_generation;
+		atomic<size_t> _Trace_capacity(65536);
+		__declspec(thread) _Trace_buffer * _Thread_trace_buffer;
+
+		void WINAPI _Release_trace_buffer(PVOID _Data)
+		{
+			auto _Buffer = static_cast<_Trace_buffer *>(_Data);
+			if (_Buffer != nullptr)
+				_Buffer->_Owned.store(false, std::memory_order_release);
+		}
+
+		// gives the buffer of a thread up when it exits
+		const DWORD _Trace_buffer_slot = ::FlsAlloc(_Release_trace_buffer);
+
+		_Trace_buffer *_Current_trace_buffer()
+		{
+			auto _Buffer = _Thread_trace_buffer;
+			if (_Buffer != nullptr || _Trace_buffer_slot == FLS_OUT_OF_INDEXES)
+				return _Buffer;
+
+			for (_Buffer = _Trace_buffers.load(std::memory_order_acquire); _Buffer != nullptr; _Buffer = _Buffer->_Next)
+			{
+				bool _Owned = false;
+				if (!_Buffer->_Owned.load(std::memory_order_relaxed) && _Buffer->_Owned.compare_exchange_strong(_Owned, true, std::memory_order_acquire))
+					break;
+			}
+
+			if (_Buffer == nullptr)
+			{
+				_Buffer = new (std::nothrow) _Trace_buffer();
+				if (_Buffer == nullptr)
+					return nullptr;
+
+				_Buffer->_Capacity = _Trace_capacity.load(std::memory_order_relaxed);
+				_Buffer->_Events = new (std::nothrow) trace_event[_Buffer->_Capacity];
+				if (_Buffer->_Events == nullptr)
+				{
+					delete _Buffer;
+					return nullptr;
+				}
+
+				_Buffer->_Owned.store(true, std::memory_order_relaxed);
+				_Buffer->_Generation.store(_Trace_generation.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				_Buffer->_Written.store(0, std::memory_order_relaxed);
+				_Buffer->_Next = _Trace_buffers.load(std::memory_order_relaxed);
+				while (!_Trace_buffers.compare_exchange_weak(_Buffer->_Next, _Buffer, std::memory_order_release, std::memory_order_relaxed))
+				{
+				}
+			}
+
+			::FlsSetValue(_Trace_buffer_slot, _Buffer);
+			_Thread_trace_buffer = _Buffer;
+			return _Buffer;
+		}
+
+		void _Record_trace_event(const trace_event &_Event)
+		{
+			auto _Buffer = _Current_trace_buffer();
+			if (_Buffer == nullptr)
+				return;
+
+			// the first event of a trace drops the ones of the previous trace
+			const unsigned int _Generation = _Trace_generation.load(std::memory_order_relaxed);
+			if (_Buffer->_Generation.load(std::memory_order_relaxed) != _Generation)
+			{
+				_Buffer->_Written.store(0, std::memory_order_relaxed);
+				_Buffer->_Generation.store(_Generation, std::memory_order_release);
+			}
+
+			const size_t _Written = _Buffer->_Written.load(std::memory_order_relaxed);
+			_Buffer->_Events[_Written % _Buffer->_Capacity] = _Event;
+			_Buffer->_Written.store(_Written + 1, std::memory_order_release);
+		}
+
+		void NTAPI _Etw_enable_callback(LPCGUID, ULONG _Is_enabled, UCHAR, ULONGLONG, ULONGLONG, PEVENT_FILTER_DESCRIPTOR, PVOID)
+		{
+			// 2 asks for a state capture, the provider has none
+			if (_Is_enabled == EVENT_CONTROL_CODE_ENABLE_PROVIDER)
+				_Trace_sinks.fetch_or(_Sink_etw, std::memory_order_relaxed);
+			else if (_Is_enabled == EVENT_CONTROL_CODE_DISABLE_PROVIDER)
+				_Trace_sinks.fetch_and(~_Sink_etw, std::memory_order_relaxed);
+		}
+
+		struct _Etw_registration
+		{
+			_Etw_registration()
+			{
+				TraceLoggingRegisterEx(_Exp_trace_provider, _Etw_enable_callback, nullptr);
+			}
+
+			~_Etw_registration()
+			{
+				TraceLoggingUnregister(_Exp_trace_provider);
+			}
+		} _Etw_provider;
+	}
+#endif
+
+	_EXP_IMPL unsigned long long __cdecl _Trace_begin() _NOEXCEPT
+	{
+#if _EXP_TRACE
+		if (_Trace_sinks.load(std::memory_order_relaxed) != 0)
+			return _Cutoff_clock_ps();
+#endif
+		return 0;
+	}
+
+	_EXP_IMPL void __cdecl _Trace_end(unsigned long long _Begin, const char *_Category, size_t _Count) _NOEXCEPT
+	{
+#if _EXP_TRACE
+		if (_Begin == 0)
+			return;
+
+		trace_event _Event;
+		_Event.name = _Current_algorithm();
+		_Event.category = _Category;
+		_Event.worker = current_worker_slot();
+		_Event.count = _Count;
+		_Event.begin_ns = _Begin / 1000;
+		_Event.duration_ns = (_Cutoff_clock_ps() - _Begin) / 1000;
+
+		const unsigned int _Sinks = _Trace_sinks.load(std::memory_order_relaxed);
+		if ((_Sinks & _Sink_buffers) != 0)
+			_Record_trace_event(_Event);
+
+		if ((_Sinks & _Sink_etw) != 0)
+		{
+			TraceLoggingWrite(_Exp_trace_provider, "Span",
+				TraceLoggingString(_Event.category, "Category"),
+				TraceLoggingString(_Event.name, "Algorithm"),
+				TraceLoggingUInt32(_Event.worker, "Worker"),
+				TraceLoggingUInt64(_Event.count, "Count"),
+				TraceLoggingUInt64(_Event.begin_ns, "BeginNs"),
+				TraceLoggingUInt64(_Event.duration_ns, "DurationNs"));
+		}
+#else
+		(void)_Begin;
+		(void)_Category;
+		(void)_Count;
+#endif
+	}
+}
+
+_EXP_IMPL bool __cdecl start_tracing(size_t _Events_per_thread) _NOEXCEPT
+{
+#if _EXP_TRACE
+	details::_Trace_capacity.store(_Events_per_thread != 0 ? _Events_per_thread : 1, std::memory_order_relaxed);
+	details::_Trace_generation.fetch_add(1, std::memory_order_relaxed);
+	details::_Trace_sinks.fetch_or(details::_Sink_buffers, std::memory_order_relaxed);
+	return true;
+#else
+	(void)_Events_per_thread;
+	return false;
+#endif
+}
+
+_EXP_IMPL void __cdecl stop_tracing() _NOEXCEPT
+{
+#if _EXP_TRACE
+	details::_Trace_sinks.fetch_and(~details::_Sink_buffers, std::memory_order_relaxed);
+#endif
+}
+
+_EXP_IMPL bool __cdecl tracing_active() _NOEXCEPT
+{
+#if _EXP_TRACE
+	return (details::_Trace_sinks.load(std::memory_order_relaxed) & details::_Sink_buffers) != 0;
+#else
+	return false;
+#endif
+}
+
+_EXP_IMPL size_t __cdecl get_trace_events(trace_event *_Events, size_t _Capacity) _NOEXCEPT
+{
+	size_t _Num = 0;
+#if _EXP_TRACE
+	const unsigned int _Generation = details::_Trace_generation.load(std::memory_order_relaxed);
+	for (auto _Buffer = details::_Trace_buffers.load(std::memory_order_acquire); _Buffer != nullptr; _Buffer = _Buffer->_Next)
+	{
+		if (_Buffer->_Generation.load(std::memory_order_acquire) != _Generation)
+			continue;
+
+		const size_t _Written = _Buffer->_Written.load(std::memory_order_acquire);
+		for (size_t _I = _Written > _Buffer->_Capacity ? _Written - _Buffer->_Capacity : 0; _I < _Written; ++_I)
+		{
+			if (_Num < _Capacity)
+				_Events[_Num] = _Buffer->_Events[_I % _Buffer->_Capacity];
+			++_Num;
+		}
+	}
+#else
+	(void)_Events;
+	(void)_Capacity;
+#endif
+	return _Num;
+}
+_PSTL_NS1_END